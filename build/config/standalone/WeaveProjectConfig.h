@@ -44,6 +44,9 @@
 
 #define WEAVE_CONFIG_SECURITY_TEST_MODE 1
 
+// Pre-generate ephemeral ECDH keys for CASE and key export
+#define WEAVE_CONFIG_ECDH_KEY_POOL_SIZE 4
+
 #define WDM_ENFORCE_EXPIRY_TIME 1
 
 #endif /* WEAVEPROJECTCONFIG_H */
@@ -55,16 +55,6 @@
 #define WeaveLogDebugBleEndPoint(MOD, MSG, ...)
 #endif
 
-/**
- *  @def BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD
- *
- *  @brief
- *    If an end point's receive window drops equal to or below this value, it will send an immediate acknowledgement
- *    packet to re-open its window instead of waiting for the send-ack timer to expire.
- *
- */
-#define BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD                   1
-
 /**
  * @def BLE_CONNECT_TIMEOUT_MS
  *
@@ -116,7 +106,7 @@ BLE_ERROR BLEEndPoint::StartConnect()
 
     req.mMtu = mBle->mPlatformDelegate->GetMTU(mConnObj);
 
-    req.mWindowSize = BLE_MAX_RECEIVE_WINDOW_SIZE;
+    req.mWindowSize = GetLocalReceiveWindowMaxSize();
 
     // Populate request with highest supported protocol versions
     numVersions = NL_BLE_TRANSPORT_PROTOCOL_MAX_SUPPORTED_VERSION - NL_BLE_TRANSPORT_PROTOCOL_MIN_SUPPORTED_VERSION + 1;
@@ -850,7 +840,7 @@ BLE_ERROR BLEEndPoint::HandleHandshakeConfirmationReceived()
         {
             // If local receive window size has shrunk to or below immediate ack threshold, AND a message fragment is not
             // pending on which to piggyback an ack, send immediate stand-alone ack.
-            if (mLocalReceiveWindowSize <= BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD && mSendQueue == NULL)
+            if (mLocalReceiveWindowSize <= GetImmediateAckWindowThreshold() && mSendQueue == NULL)
             {
                 err = DriveStandAloneAck(); // Encode stand-alone ack and drive sending.
                 SuccessOrExit(err);
@@ -916,7 +906,7 @@ BLE_ERROR BLEEndPoint::HandleFragmentConfirmationReceived()
     // This check covers the case where the local receive window has shrunk between transmission and confirmation of
     // the stand-alone ack, and also the case where a window size < the immediate ack threshold was detected in
     // Receive(), but the stand-alone ack was deferred due to a pending outbound message fragment.
-    if (mLocalReceiveWindowSize <= BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD &&
+    if (mLocalReceiveWindowSize <= GetImmediateAckWindowThreshold() &&
         (mSendQueue != NULL || mWoBle.TxState() == WoBle::kState_InProgress) == false)
     {
         err = DriveStandAloneAck(); // Encode stand-alone ack and drive sending.
@@ -1142,7 +1132,7 @@ BLE_ERROR BLEEndPoint::HandleCapabilitiesRequestReceived(PacketBuffer *data)
     // Select local and remote max receive window size based on local resources available for both incoming writes AND
     // GATT confirmations.
     mRemoteReceiveWindowSize = mLocalReceiveWindowSize = mReceiveWindowMaxSize =
-            nl::Weave::min(req.mWindowSize, static_cast<uint8_t>(BLE_MAX_RECEIVE_WINDOW_SIZE));
+            nl::Weave::min(req.mWindowSize, GetLocalReceiveWindowMaxSize());
     resp.mWindowSize = mReceiveWindowMaxSize;
 
     WeaveLogProgress(Ble, "local and remote recv window sizes = %u", resp.mWindowSize);
@@ -1273,6 +1263,35 @@ exit:
     return err;
 }
 
+// Returns the size of the receive window to offer the peer on this connection.
+SequenceNumber_t BLEEndPoint::GetLocalReceiveWindowMaxSize() const
+{
+    // Size receive window to the platform's GATT buffering on this connection, if known.
+    uint8_t size = mBle->mPlatformDelegate->GetReceiveWindowSize(mConnObj);
+
+    if (size == 0 || size > BLE_MAX_RECEIVE_WINDOW_SIZE)
+    {
+        size = BLE_MAX_RECEIVE_WINDOW_SIZE;
+    }
+    else if (size < 3)
+    {
+        // See BLE_MAX_RECEIVE_WINDOW_SIZE for why windows smaller than 3 would stall the connection.
+        size = 3;
+    }
+
+    return size;
+}
+
+// Returns the number of open slots in the local receive window at or below which received fragments are acknowledged
+// immediately.
+SequenceNumber_t BLEEndPoint::GetImmediateAckWindowThreshold() const
+{
+    // On larger windows, acknowledge once half the window is consumed, so that a single cumulative ack covers several
+    // fragments and still reopens the sender's window before it stalls.
+    return nl::Weave::max(static_cast<SequenceNumber_t>(BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD),
+            static_cast<SequenceNumber_t>(mReceiveWindowMaxSize / 2));
+}
+
 // Returns number of open slots in remote receive window given the input values.
 SequenceNumber_t BLEEndPoint::AdjustRemoteReceiveWindow(SequenceNumber_t lastReceivedAck,
         SequenceNumber_t maxRemoteWindowSize, SequenceNumber_t newestUnackedSentSeqNum)
@@ -1443,7 +1462,7 @@ BLE_ERROR BLEEndPoint::Receive(PacketBuffer *data)
     // this threshold again when the GATT operation is confirmed.
     if (mWoBle.HasUnackedData())
     {
-        if (mLocalReceiveWindowSize <= BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD &&
+        if (mLocalReceiveWindowSize <= GetImmediateAckWindowThreshold() &&
             GetFlag(mConnStateFlags, kConnState_GattOperationInFlight) == false)
         {
             WeaveLogDebugBleEndPoint(Ble, "sending immediate ack");
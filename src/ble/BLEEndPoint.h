@@ -188,6 +188,8 @@ private:
     BLE_ERROR HandleCapabilitiesResponseReceived(PacketBuffer *data);
     SequenceNumber_t AdjustRemoteReceiveWindow(SequenceNumber_t lastReceivedAck,
             SequenceNumber_t maxRemoteWindowSize, SequenceNumber_t newestUnackedSentSeqNum);
+    SequenceNumber_t GetLocalReceiveWindowMaxSize(void) const;
+    SequenceNumber_t GetImmediateAckWindowThreshold(void) const;
 
     // Timer control functions:
     BLE_ERROR StartConnectTimer(void); // Start connect timer.
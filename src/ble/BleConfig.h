@@ -158,6 +158,50 @@
 #error "BLE_MAX_RECEIVE_WINDOW_SIZE must be greater than 2 for BLE transport protocol stability."
 #endif
 
+#if (BLE_MAX_RECEIVE_WINDOW_SIZE > 127)
+#error "BLE_MAX_RECEIVE_WINDOW_SIZE must be less than half the BTP sequence number space."
+#endif
+
+/**
+ *  @def BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD
+ *
+ *  @brief
+ *    If an end point's receive window drops equal to or below this value, it will send an immediate acknowledgement
+ *    packet to re-open its window instead of waiting for the send-ack timer to expire.
+ *
+ *    On connections whose negotiated receive window is larger than BLE_MAX_RECEIVE_WINDOW_SIZE's minimum of 3, the
+ *    threshold used is raised to one-half of the window, so that a single cumulative acknowledgement covers several
+ *    fragments and reaches the sender before its view of the window is exhausted.
+ *
+ */
+#ifndef BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD
+#define BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD              1
+#endif
+
+#if (BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD < 1) || ((BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD + 1) >= BLE_MAX_RECEIVE_WINDOW_SIZE)
+#error "BLE_CONFIG_IMMEDIATE_ACK_WINDOW_THRESHOLD must be at least 1 and less than (BLE_MAX_RECEIVE_WINDOW_SIZE - 1)."
+#endif
+
+/**
+ *  @def BLE_CONFIG_MAX_FRAGMENT_SIZE
+ *
+ *  @brief
+ *    This is the largest BTP fragment, in bytes, a BLE end point will negotiate, and must not exceed the size of the
+ *    platform's Weave service write and indication characteristics. Fragments are sized to the connection's ATT MTU
+ *    less the 3-byte ATT header, up to this value.
+ *
+ *    The maximum of 509 corresponds to an ATT MTU of 512 bytes, the largest attribute value permitted by the Bluetooth
+ *    specification.
+ *
+ */
+#ifndef BLE_CONFIG_MAX_FRAGMENT_SIZE
+#define BLE_CONFIG_MAX_FRAGMENT_SIZE                           128
+#endif
+
+#if (BLE_CONFIG_MAX_FRAGMENT_SIZE < 20) || (BLE_CONFIG_MAX_FRAGMENT_SIZE > 509)
+#error "BLE_CONFIG_MAX_FRAGMENT_SIZE must be between 20 and 509, inclusive."
+#endif
+
 /**
  *  @def BLE_CONFIG_ERROR_TYPE
  *
@@ -83,6 +83,13 @@ public:
 
     // Send response to remote host's GATT chacteristic read response
     virtual bool SendReadResponse(BLE_CONNECTION_OBJECT connObj, BLE_READ_REQUEST_CONTEXT requestContext, const WeaveBleUUID *svcId, const WeaveBleUUID *charId) = 0;
+
+    // Following APIs may optionally be implemented by platform:
+
+    // Get number of incoming GATT writes or indications the platform can buffer on the specified BLE connection, used
+    // to size the connection's BTP receive window. Return value of 0 means the number could not be determined, in
+    // which case BLE_MAX_RECEIVE_WINDOW_SIZE is used. Larger values are capped at BLE_MAX_RECEIVE_WINDOW_SIZE.
+    virtual uint8_t GetReceiveWindowSize(BLE_CONNECTION_OBJECT connObj) const { return 0; }
 };
 
 } /* namespace Ble */
@@ -93,7 +93,7 @@ static void PrintBufDebug(PacketBuffer *buf)
 }
 
 const uint16_t WoBle::sDefaultFragmentSize  =  20; // 23-byte minimum ATT_MTU - 3 bytes for ATT operation header
-const uint16_t WoBle::sMaxFragmentSize      = 128; // Size of write and indication characteristics
+const uint16_t WoBle::sMaxFragmentSize      = BLE_CONFIG_MAX_FRAGMENT_SIZE; // Size of write and indication characteristics
 
 BLE_ERROR WoBle::Init(void *an_app_state, bool expect_first_ack)
 {
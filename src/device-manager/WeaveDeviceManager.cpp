@@ -110,6 +110,10 @@ WEAVE_ERROR WeaveDeviceManager::Init(WeaveExchangeManager *exchangeMgr, WeaveSec
     mOnStart = NULL;
     mOnConnectionClosedFunc = NULL;
     mOnConnectionClosedAppReq = NULL;
+    mOnSessionStartFunc = NULL;
+    mOnSessionStartAppReq = NULL;
+    mSecMgrBusyTimeout = 0;
+    mSecMgrBusyRetryCount = 0;
     mDeviceAddr = IPAddress::Any;
     mAssistingDeviceAddr = IPAddress::Any;
     mDeviceIntf = INET_NULL_INTERFACEID;
@@ -1303,6 +1307,7 @@ void WeaveDeviceManager::CloseDeviceConnection(bool graceful)
     //
     mConState = kConnectionState_NotConnected;
     mConTryCount = 0;
+    mSecMgrBusyRetryCount = 0;
     mSessionKeyId = WeaveKeyId::kNone;
     mEncType = kWeaveEncryptionType_None;
     mConnectedToRemoteDevice = false;
@@ -1326,6 +1331,26 @@ void WeaveDeviceManager::SetConnectionClosedCallback(ConnectionClosedFunc onConn
     mOnConnectionClosedAppReq = onConnecionClosedAppReq;
 }
 
+/**
+ *  Set a callback invoked when the device manager begins establishing a secure session with a device,
+ *  marking the end of rendezvous.
+ */
+void WeaveDeviceManager::SetSessionStartCallback(StartFunct onSessionStartFunc, void *onSessionStartAppReq)
+{
+    mOnSessionStartFunc = onSessionStartFunc;
+    mOnSessionStartAppReq = onSessionStartAppReq;
+}
+
+/**
+ *  Set how long to wait for the security manager to become free before establishing a secure session, when
+ *  it is shared with other device managers. Once the time is up, the connection fails with
+ *  #WEAVE_ERROR_SECURITY_MANAGER_BUSY. The default, 0, fails the connection straight away.
+ */
+void WeaveDeviceManager::SetSecurityManagerBusyTimeout(uint32_t timeoutMS)
+{
+    mSecMgrBusyTimeout = timeoutMS;
+}
+
 WEAVE_ERROR WeaveDeviceManager::IdentifyDevice(void* appReqState, IdentifyDeviceCompleteFunct onComplete, ErrorFunct onError)
 {
     WEAVE_ERROR             err     = WEAVE_NO_ERROR;
@@ -3665,6 +3690,11 @@ WEAVE_ERROR WeaveDeviceManager::StartSession()
     // Bump the counter every time we attempt to establish a secure session.
     mConTryCount++;
 
+    if (mConState != kConnectionState_StartSession && mAuthType != kAuthType_None && mOnSessionStartFunc != NULL)
+    {
+        mOnSessionStartFunc(this, mOnSessionStartAppReq, mDeviceCon);
+    }
+
     switch (mAuthType)
     {
     case kAuthType_PASEWithPairingCode:
@@ -3700,6 +3730,19 @@ WEAVE_ERROR WeaveDeviceManager::StartSession()
         break;
     }
 
+    // If the security manager is busy establishing a session on behalf of another device manager sharing it, wait
+    // for it to become free, for as long as the application allows. Waiting does not count as an attempt.
+    if (err == WEAVE_ERROR_SECURITY_MANAGER_BUSY && mSecMgrBusyRetryCount * kSecMgrBusyRetryInterval < mSecMgrBusyTimeout)
+    {
+        mConTryCount--;
+        mSecMgrBusyRetryCount++;
+        err = mSystemLayer->StartTimer(kSecMgrBusyRetryInterval, RetrySession, this);
+    }
+    else
+    {
+        mSecMgrBusyRetryCount = 0;
+    }
+
     return err;
 }
 
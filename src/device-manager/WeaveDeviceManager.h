@@ -212,6 +212,8 @@ public:
     void CloseDeviceConnection(bool graceful);
     bool IsConnected() const;
     void SetConnectionClosedCallback(ConnectionClosedFunc onConnecionClosedFunc, void *onConnecionClosedAppReq);
+    void SetSessionStartCallback(StartFunct onSessionStartFunc, void *onSessionStartAppReq);
+    void SetSecurityManagerBusyTimeout(uint32_t timeoutMS);
 
     // ----- Network Provisioning -----
     WEAVE_ERROR ScanNetworks(NetworkType networkType, void* appReqState, NetworkScanCompleteFunct onComplete,
@@ -357,6 +359,7 @@ private:
         kEnumerateDevicesRetryInterval          = 500, // ms
         kSessionRetryInterval                   = 1000, // ms
         kMaxSessionRetryCount                   = 20,
+        kSecMgrBusyRetryInterval                = 50,   // ms
     };
 
     enum
@@ -444,6 +447,10 @@ private:
     StartFunct mOnStart;
     ConnectionClosedFunc mOnConnectionClosedFunc;
     void *mOnConnectionClosedAppReq;
+    StartFunct mOnSessionStartFunc;
+    void *mOnSessionStartAppReq;
+    uint32_t mSecMgrBusyTimeout;
+    uint32_t mSecMgrBusyRetryCount;
     ExchangeContext *mCurReq;
     uint32_t mCurReqProfileId;
     uint16_t mCurReqMsgType;
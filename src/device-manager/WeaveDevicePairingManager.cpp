@@ -0,0 +1,469 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Implementation of Weave Device Pairing Manager, a class that runs
+ *      the pairing of many Weave devices concurrently, each through its
+ *      own Weave Device Manager, over a shared exchange manager and
+ *      security manager.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+#include <stdint.h>
+#include <string.h>
+
+#include "WeaveDevicePairingManager.h"
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/ErrorStr.h>
+#include <Weave/Support/logging/WeaveLogging.h>
+
+namespace nl {
+namespace Weave {
+namespace DeviceManager {
+
+using System::Timer;
+
+static const char *PairingStageName(PairingStage stage)
+{
+    switch (stage)
+    {
+    case kPairingStage_Rendezvous           : return "rendezvous";
+    case kPairingStage_SecureSession        : return "secure session";
+    case kPairingStage_NetworkProvisioning  : return "network provisioning";
+    case kPairingStage_FabricProvisioning   : return "fabric provisioning";
+    case kPairingStage_ServiceProvisioning  : return "service provisioning";
+    default                                 : return "unknown";
+    }
+}
+
+DevicePairingConfig::DevicePairingConfig(void)
+{
+    Network = NULL;
+    FabricConfig = NULL;
+    FabricConfigLen = 0;
+    ServiceId = 0;
+    AccountId = NULL;
+    ServiceConfig = NULL;
+    ServiceConfigLen = 0;
+    PairingToken = NULL;
+    PairingTokenLen = 0;
+    PairingInitData = NULL;
+    PairingInitDataLen = 0;
+    SecureSessionWaitMs = 0;
+}
+
+WeaveDevicePairingManager::WeaveDevicePairingManager(void)
+{
+    State = kState_NotInitialized;
+}
+
+/**
+ *  Initialize the pairing manager.
+ *
+ *  Every device manager the pairing manager creates shares @a exchangeMgr and @a securityMgr. Secure
+ *  sessions are established one at a time through the shared security manager, while the remaining
+ *  stages of each device's pairing proceed concurrently. A device waits for the security manager for
+ *  at most DevicePairingConfig::SecureSessionWaitMs.
+ *
+ *  @param[in] exchangeMgr              The exchange manager over which to pair devices.
+ *  @param[in] securityMgr              The security manager through which to establish sessions.
+ *  @param[in] config                   Provisioning applied to every device.
+ *  @param[in] maxConcurrentSessions    The number of devices to pair at once, between 1 and
+ *                                      #kMaxPairingSessions. Each requires a Weave connection.
+ *
+ *  @retval #WEAVE_NO_ERROR                 On success.
+ *  @retval #WEAVE_ERROR_INCORRECT_STATE    If the pairing manager is already initialized.
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT   If an argument is out of range.
+ */
+WEAVE_ERROR WeaveDevicePairingManager::Init(WeaveExchangeManager *exchangeMgr, WeaveSecurityManager *securityMgr,
+        const DevicePairingConfig &config, uint8_t maxConcurrentSessions)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    int numInitialized = 0;
+    uint32_t secureSessionWait;
+
+    VerifyOrExit(State == kState_NotInitialized, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(exchangeMgr != NULL && securityMgr != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(maxConcurrentSessions > 0 && maxConcurrentSessions <= kMaxPairingSessions, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    AppState = NULL;
+    mExchangeMgr = exchangeMgr;
+    mSecurityMgr = securityMgr;
+    mConfig = config;
+    mMaxConcurrentSessions = maxConcurrentSessions;
+    mNextSeqNum = 0;
+
+    // By default, allow for every other device ahead in the queue for the security manager to use up its session
+    // timeout.
+    secureSessionWait = (config.SecureSessionWaitMs != 0) ? config.SecureSessionWaitMs
+                                                          : static_cast<uint32_t>(maxConcurrentSessions) * kSecureSessionTimeout;
+
+    for (; numInitialized < kMaxPairingSessions; numInitialized++)
+    {
+        PairingSession &session = mSessions[numInitialized];
+
+        err = session.mDeviceMgr.Init(exchangeMgr, securityMgr);
+        SuccessOrExit(err);
+
+        session.mDeviceMgr.SetSessionStartCallback(HandleSessionStart, &session);
+        session.mDeviceMgr.SetSecurityManagerBusyTimeout(secureSessionWait);
+        session.mPairingMgr = this;
+        session.mState = kSessionState_Free;
+    }
+
+    State = kState_Initialized;
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+    {
+        while (numInitialized > 0)
+        {
+            mSessions[--numInitialized].mDeviceMgr.Shutdown();
+        }
+    }
+
+    return err;
+}
+
+/**
+ *  Shut down the pairing manager, abandoning the pairing of queued and in-progress devices
+ *  without calling their completion functions.
+ */
+WEAVE_ERROR WeaveDevicePairingManager::Shutdown(void)
+{
+    VerifyOrExit(State == kState_Initialized, );
+
+    mExchangeMgr->MessageLayer->SystemLayer->CancelTimer(HandleStartQueuedSessions, this);
+
+    for (int i = 0; i < kMaxPairingSessions; i++)
+    {
+        mSessions[i].mDeviceMgr.Shutdown();
+        mSessions[i].mState = kSessionState_Free;
+    }
+
+    mExchangeMgr = NULL;
+    mSecurityMgr = NULL;
+    State = kState_NotInitialized;
+
+exit:
+    return WEAVE_NO_ERROR;
+}
+
+/**
+ *  Queue a device for pairing.
+ *
+ *  The device is paired as soon as a pairing session is free, in the order devices were queued.
+ *  If @a deviceAddr is IPAddress::Any, the device is located by rendezvous on its node id.
+ *
+ *  @param[in] deviceId         The node id of the device.
+ *  @param[in] deviceAddr       The address of the device, or IPAddress::Any.
+ *  @param[in] pairingCode      The pairing code of the device, used to establish a PASE session.
+ *  @param[in] appReqState      A pointer passed back to @a onDevicePaired.
+ *  @param[in] onDevicePaired   A function called when the device is paired or its pairing fails.
+ *
+ *  @retval #WEAVE_NO_ERROR                 On success.
+ *  @retval #WEAVE_ERROR_INCORRECT_STATE    If the pairing manager is not initialized.
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT   If the pairing code is missing or too long, or no
+ *                                          completion function was given.
+ *  @retval #WEAVE_ERROR_NO_MEMORY          If #kMaxPairingSessions devices are already queued or
+ *                                          being paired.
+ */
+WEAVE_ERROR WeaveDevicePairingManager::PairDevice(uint64_t deviceId, const IPAddress &deviceAddr, const char *pairingCode,
+        void *appReqState, DevicePairedFunct onDevicePaired)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PairingSession *session = NULL;
+
+    VerifyOrExit(State == kState_Initialized, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(pairingCode != NULL && strlen(pairingCode) <= kMaxPairingCodeLength, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(onDevicePaired != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    for (int i = 0; i < kMaxPairingSessions && session == NULL; i++)
+    {
+        if (mSessions[i].mState == kSessionState_Free)
+            session = &mSessions[i];
+    }
+    VerifyOrExit(session != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    session->mState = kSessionState_Queued;
+    session->mSeqNum = mNextSeqNum++;
+    session->mDeviceId = deviceId;
+    session->mDeviceAddr = deviceAddr;
+    strcpy(session->mPairingCode, pairingCode);
+    session->mNetworkId = 0;
+    session->mAppReqState = appReqState;
+    session->mOnDevicePaired = onDevicePaired;
+    memset(&session->mResult, 0, sizeof(session->mResult));
+    session->mResult.DeviceId = deviceId;
+    session->mResult.LastStage = kPairingStage_Rendezvous;
+    session->mStageStartTime = Timer::GetCurrentEpoch();
+
+    err = mExchangeMgr->MessageLayer->SystemLayer->StartTimer(0, HandleStartQueuedSessions, this);
+    if (err != WEAVE_NO_ERROR)
+    {
+        session->mState = kSessionState_Free;
+    }
+
+exit:
+    return err;
+}
+
+/**
+ *  Return the number of devices being paired.
+ */
+uint8_t WeaveDevicePairingManager::GetNumActiveSessions(void) const
+{
+    uint8_t count = 0;
+
+    for (int i = 0; i < kMaxPairingSessions; i++)
+    {
+        if (mSessions[i].mState == kSessionState_Active)
+            count++;
+    }
+
+    return count;
+}
+
+/**
+ *  Return the number of devices waiting for a free pairing session.
+ */
+uint8_t WeaveDevicePairingManager::GetNumQueuedDevices(void) const
+{
+    uint8_t count = 0;
+
+    for (int i = 0; i < kMaxPairingSessions; i++)
+    {
+        if (mSessions[i].mState == kSessionState_Queued)
+            count++;
+    }
+
+    return count;
+}
+
+void WeaveDevicePairingManager::HandleStartQueuedSessions(System::Layer *aSystemLayer, void *aAppState, System::Error aError)
+{
+    WeaveDevicePairingManager *pairingMgr = static_cast<WeaveDevicePairingManager *>(aAppState);
+
+    pairingMgr->StartQueuedSessions();
+}
+
+void WeaveDevicePairingManager::StartQueuedSessions(void)
+{
+    while (State == kState_Initialized && GetNumActiveSessions() < mMaxConcurrentSessions)
+    {
+        PairingSession *next = NULL;
+        WEAVE_ERROR err;
+
+        // Start the device queued first. Sequence numbers are compared by difference so they may wrap.
+        for (int i = 0; i < kMaxPairingSessions; i++)
+        {
+            PairingSession &session = mSessions[i];
+
+            if (session.mState == kSessionState_Queued &&
+                (next == NULL || static_cast<int32_t>(session.mSeqNum - next->mSeqNum) < 0))
+            {
+                next = &session;
+            }
+        }
+
+        if (next == NULL)
+            break;
+
+        err = StartSession(*next);
+        if (err != WEAVE_NO_ERROR)
+        {
+            CompleteSession(*next, err, NULL);
+        }
+    }
+}
+
+WEAVE_ERROR WeaveDevicePairingManager::StartSession(PairingSession &session)
+{
+    WEAVE_ERROR err;
+    const Timer::Epoch now = Timer::GetCurrentEpoch();
+
+    session.mState = kSessionState_Active;
+    session.mResult.QueuedTimeMs = static_cast<uint32_t>(now - session.mStageStartTime);
+    session.mResult.LastStage = kPairingStage_Rendezvous;
+    session.mStageStartTime = now;
+
+    WeaveLogProgress(DeviceManager, "Pairing device %016" PRIX64 " (%u active)", session.mDeviceId, GetNumActiveSessions());
+
+    if (session.mDeviceAddr == IPAddress::Any)
+    {
+        IdentifyDeviceCriteria criteria;
+
+        criteria.TargetDeviceId = session.mDeviceId;
+
+        err = session.mDeviceMgr.RendezvousDevice(session.mPairingCode, criteria, &session, HandleConnectComplete, HandleError);
+    }
+    else
+    {
+        err = session.mDeviceMgr.ConnectDevice(session.mDeviceId, session.mDeviceAddr, session.mPairingCode, &session,
+                HandleConnectComplete, HandleError);
+    }
+
+    return err;
+}
+
+void WeaveDevicePairingManager::EnterStage(PairingSession &session, PairingStage stage)
+{
+    const Timer::Epoch now = Timer::GetCurrentEpoch();
+
+    session.mResult.StageTimeMs[session.mResult.LastStage] = static_cast<uint32_t>(now - session.mStageStartTime);
+    session.mResult.LastStage = stage;
+    session.mStageStartTime = now;
+}
+
+/**
+ *  Start the first stage after @a completedStage for which provisioning was configured, or complete
+ *  the pairing if none remains.
+ */
+void WeaveDevicePairingManager::AdvanceSession(PairingSession &session, PairingStage completedStage)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    WeaveDeviceManager &deviceMgr = session.mDeviceMgr;
+
+    if (completedStage < kPairingStage_NetworkProvisioning && mConfig.Network != NULL)
+    {
+        EnterStage(session, kPairingStage_NetworkProvisioning);
+        err = deviceMgr.AddNetwork(mConfig.Network, &session, HandleAddNetworkComplete, HandleError);
+    }
+    else if (completedStage < kPairingStage_FabricProvisioning && mConfig.FabricConfig != NULL)
+    {
+        EnterStage(session, kPairingStage_FabricProvisioning);
+        err = deviceMgr.JoinExistingFabric(mConfig.FabricConfig, mConfig.FabricConfigLen, &session,
+                HandleJoinFabricComplete, HandleError);
+    }
+    else if (completedStage < kPairingStage_ServiceProvisioning && mConfig.ServiceConfig != NULL)
+    {
+        EnterStage(session, kPairingStage_ServiceProvisioning);
+        err = deviceMgr.RegisterServicePairAccount(mConfig.ServiceId, mConfig.AccountId,
+                mConfig.ServiceConfig, mConfig.ServiceConfigLen, mConfig.PairingToken, mConfig.PairingTokenLen,
+                mConfig.PairingInitData, mConfig.PairingInitDataLen, &session, HandleRegisterServiceComplete, HandleError);
+    }
+    else
+    {
+        CompleteSession(session, WEAVE_NO_ERROR, NULL);
+    }
+
+    if (err != WEAVE_NO_ERROR)
+    {
+        CompleteSession(session, err, NULL);
+    }
+}
+
+void WeaveDevicePairingManager::CompleteSession(PairingSession &session, WEAVE_ERROR err, const DeviceStatus *devStatus)
+{
+    DevicePairingResult result;
+    DevicePairedFunct onDevicePaired = session.mOnDevicePaired;
+    void *appReqState = session.mAppReqState;
+    uint32_t totalTimeMs;
+
+    EnterStage(session, session.mResult.LastStage);
+
+    session.mResult.Error = err;
+    session.mResult.DevStatus = devStatus;
+    result = session.mResult;
+
+    totalTimeMs = result.QueuedTimeMs;
+    for (int i = 0; i < kPairingStage_NumStages; i++)
+        totalTimeMs += result.StageTimeMs[i];
+
+    if (err == WEAVE_NO_ERROR)
+    {
+        WeaveLogProgress(DeviceManager, "Paired device %016" PRIX64 " in %" PRIu32 " ms", result.DeviceId, totalTimeMs);
+    }
+    else
+    {
+        WeaveLogProgress(DeviceManager, "Pairing device %016" PRIX64 " failed during %s: %s", result.DeviceId,
+                PairingStageName(result.LastStage), ErrorStr(err));
+    }
+
+    session.mDeviceMgr.Close();
+    session.mState = kSessionState_Free;
+
+    onDevicePaired(this, appReqState, &result);
+
+    // Start the next queued device once the device manager has unwound from the callback that completed this one.
+    mExchangeMgr->MessageLayer->SystemLayer->StartTimer(0, HandleStartQueuedSessions, this);
+}
+
+void WeaveDevicePairingManager::HandleSessionStart(WeaveDeviceManager *deviceMgr, void *appReqState, WeaveConnection *con)
+{
+    PairingSession *session = static_cast<PairingSession *>(appReqState);
+
+    session->mPairingMgr->EnterStage(*session, kPairingStage_SecureSession);
+}
+
+void WeaveDevicePairingManager::HandleConnectComplete(WeaveDeviceManager *deviceMgr, void *appReqState)
+{
+    PairingSession *session = static_cast<PairingSession *>(appReqState);
+
+    session->mPairingMgr->AdvanceSession(*session, kPairingStage_SecureSession);
+}
+
+void WeaveDevicePairingManager::HandleAddNetworkComplete(WeaveDeviceManager *deviceMgr, void *appReqState, uint32_t networkId)
+{
+    PairingSession *session = static_cast<PairingSession *>(appReqState);
+    WEAVE_ERROR err;
+
+    session->mNetworkId = networkId;
+
+    err = deviceMgr->EnableNetwork(networkId, session, HandleEnableNetworkComplete, HandleError);
+    if (err != WEAVE_NO_ERROR)
+    {
+        session->mPairingMgr->CompleteSession(*session, err, NULL);
+    }
+}
+
+void WeaveDevicePairingManager::HandleEnableNetworkComplete(WeaveDeviceManager *deviceMgr, void *appReqState)
+{
+    PairingSession *session = static_cast<PairingSession *>(appReqState);
+
+    session->mPairingMgr->AdvanceSession(*session, kPairingStage_NetworkProvisioning);
+}
+
+void WeaveDevicePairingManager::HandleJoinFabricComplete(WeaveDeviceManager *deviceMgr, void *appReqState)
+{
+    PairingSession *session = static_cast<PairingSession *>(appReqState);
+
+    session->mPairingMgr->AdvanceSession(*session, kPairingStage_FabricProvisioning);
+}
+
+void WeaveDevicePairingManager::HandleRegisterServiceComplete(WeaveDeviceManager *deviceMgr, void *appReqState)
+{
+    PairingSession *session = static_cast<PairingSession *>(appReqState);
+
+    session->mPairingMgr->AdvanceSession(*session, kPairingStage_ServiceProvisioning);
+}
+
+void WeaveDevicePairingManager::HandleError(WeaveDeviceManager *deviceMgr, void *appReqState, WEAVE_ERROR err, DeviceStatus *devStatus)
+{
+    PairingSession *session = static_cast<PairingSession *>(appReqState);
+
+    session->mPairingMgr->CompleteSession(*session, err, devStatus);
+}
+
+} // namespace DeviceManager
+} // namespace Weave
+} // namespace nl
@@ -0,0 +1,181 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Declaration of Weave Device Pairing Manager, a class that runs
+ *      the pairing of many Weave devices concurrently, each through its
+ *      own Weave Device Manager, over a shared exchange manager and
+ *      security manager.
+ *
+ */
+
+#ifndef __WEAVEDEVICEPAIRINGMANAGER_H
+#define __WEAVEDEVICEPAIRINGMANAGER_H
+
+#include "WeaveDeviceManager.h"
+
+namespace nl {
+namespace Weave {
+namespace DeviceManager {
+
+class WeaveDevicePairingManager;
+
+/**
+ *  Pairing stages, in the order a device passes through them.
+ */
+enum PairingStage
+{
+    kPairingStage_Rendezvous            = 0,    ///< Locating and connecting to the device.
+    kPairingStage_SecureSession         = 1,    ///< Establishing a PASE session, including any wait for the shared security manager.
+    kPairingStage_NetworkProvisioning   = 2,    ///< Adding and enabling the network.
+    kPairingStage_FabricProvisioning    = 3,    ///< Joining the existing fabric.
+    kPairingStage_ServiceProvisioning   = 4,    ///< Registering the device with the service account.
+
+    kPairingStage_NumStages             = 5
+};
+
+/**
+ *  Provisioning shared by every device paired by a WeaveDevicePairingManager. Stages whose
+ *  provisioning data is not given are skipped. The data is referenced, not copied, and must
+ *  outlive the pairing manager.
+ */
+struct DevicePairingConfig
+{
+    const NetworkInfo *Network;                 ///< Network to add and enable, or NULL.
+    const uint8_t *FabricConfig;                ///< Fabric to join, or NULL.
+    uint32_t FabricConfigLen;
+    uint64_t ServiceId;
+    const char *AccountId;
+    const uint8_t *ServiceConfig;               ///< Service to register with, or NULL.
+    uint16_t ServiceConfigLen;
+    const uint8_t *PairingToken;
+    uint16_t PairingTokenLen;
+    const uint8_t *PairingInitData;
+    uint16_t PairingInitDataLen;
+    uint32_t SecureSessionWaitMs;               ///< How long a device may wait for the shared security manager
+                                                ///< before its pairing fails, or 0 to allow the security
+                                                ///< manager's session timeout for each concurrent device.
+
+    DevicePairingConfig(void);
+};
+
+/**
+ *  Outcome of pairing one device.
+ */
+struct DevicePairingResult
+{
+    uint64_t DeviceId;
+    WEAVE_ERROR Error;                          ///< WEAVE_NO_ERROR if every stage succeeded.
+    const DeviceStatus *DevStatus;              ///< Status reported by the device on failure, or NULL.
+    PairingStage LastStage;                     ///< Stage completed last, or the stage that failed.
+    uint32_t QueuedTimeMs;                      ///< Time spent waiting for a free pairing session.
+    uint32_t StageTimeMs[kPairingStage_NumStages]; ///< Time spent in each stage; 0 for skipped stages.
+};
+
+extern "C"
+{
+typedef void (*DevicePairedFunct)(WeaveDevicePairingManager *pairingMgr, void *appReqState, const DevicePairingResult *result);
+}
+
+class NL_DLL_EXPORT WeaveDevicePairingManager
+{
+public:
+    enum
+    {
+        kMaxPairingSessions                     = 16,
+    };
+
+    enum
+    {
+        kState_NotInitialized = 0,
+        kState_Initialized = 1
+    } State;                        // [READ-ONLY] Current state
+
+    WeaveDevicePairingManager(void);
+
+    void *AppState;
+
+    WEAVE_ERROR Init(WeaveExchangeManager *exchangeMgr, WeaveSecurityManager *securityMgr,
+            const DevicePairingConfig &config, uint8_t maxConcurrentSessions);
+    WEAVE_ERROR Shutdown(void);
+
+    WEAVE_ERROR PairDevice(uint64_t deviceId, const IPAddress &deviceAddr, const char *pairingCode,
+            void *appReqState, DevicePairedFunct onDevicePaired);
+
+    uint8_t GetNumActiveSessions(void) const;
+    uint8_t GetNumQueuedDevices(void) const;
+
+private:
+    enum SessionState
+    {
+        kSessionState_Free                      = 0,
+        kSessionState_Queued                    = 1,
+        kSessionState_Active                    = 2
+    };
+
+    enum
+    {
+        kMaxPairingCodeLength                   = 16,
+        kSecureSessionTimeout                   = 30000 // ms; the security manager's session timeout
+    };
+
+    struct PairingSession
+    {
+        WeaveDevicePairingManager *mPairingMgr;
+        WeaveDeviceManager mDeviceMgr;
+        SessionState mState;
+        uint32_t mSeqNum;
+        uint64_t mDeviceId;
+        IPAddress mDeviceAddr;
+        char mPairingCode[kMaxPairingCodeLength + 1];
+        uint32_t mNetworkId;
+        void *mAppReqState;
+        DevicePairedFunct mOnDevicePaired;
+        DevicePairingResult mResult;
+        System::Timer::Epoch mStageStartTime;
+    };
+
+    WeaveExchangeManager *mExchangeMgr;
+    WeaveSecurityManager *mSecurityMgr;
+    DevicePairingConfig mConfig;
+    uint8_t mMaxConcurrentSessions;
+    uint32_t mNextSeqNum;
+    PairingSession mSessions[kMaxPairingSessions];
+
+    void StartQueuedSessions(void);
+    WEAVE_ERROR StartSession(PairingSession &session);
+    void EnterStage(PairingSession &session, PairingStage stage);
+    void AdvanceSession(PairingSession &session, PairingStage completedStage);
+    void CompleteSession(PairingSession &session, WEAVE_ERROR err, const DeviceStatus *devStatus);
+
+    static void HandleStartQueuedSessions(System::Layer *aSystemLayer, void *aAppState, System::Error aError);
+    static void HandleSessionStart(WeaveDeviceManager *deviceMgr, void *appReqState, WeaveConnection *con);
+    static void HandleConnectComplete(WeaveDeviceManager *deviceMgr, void *appReqState);
+    static void HandleAddNetworkComplete(WeaveDeviceManager *deviceMgr, void *appReqState, uint32_t networkId);
+    static void HandleEnableNetworkComplete(WeaveDeviceManager *deviceMgr, void *appReqState);
+    static void HandleJoinFabricComplete(WeaveDeviceManager *deviceMgr, void *appReqState);
+    static void HandleRegisterServiceComplete(WeaveDeviceManager *deviceMgr, void *appReqState);
+    static void HandleError(WeaveDeviceManager *deviceMgr, void *appReqState, WEAVE_ERROR err, DeviceStatus *devStatus);
+};
+
+} // namespace DeviceManager
+} // namespace Weave
+} // namespace nl
+
+#endif // __WEAVEDEVICEPAIRINGMANAGER_H
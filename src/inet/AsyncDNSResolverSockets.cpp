@@ -139,16 +139,7 @@ INET_ERROR AsyncDNSResolverSockets::PrepareDNSResolver(DNSResolver &resolver, co
 {
     INET_ERROR err = INET_NO_ERROR;
 
-    memcpy(resolver.asyncHostNameBuf, hostName, hostNameLen);
-    resolver.asyncHostNameBuf[hostNameLen] = 0;
-    resolver.MaxAddrs = maxAddrs;
-    resolver.NumAddrs = 0;
-    resolver.AddrArray = addrArray;
-    resolver.AppState = appState;
-    resolver.OnComplete = onComplete;
-    resolver.asyncDNSResolveResult = INET_NO_ERROR;
-    resolver.mState = DNSResolver::kState_Active;
-    resolver.pNextAsyncDNSResolver = NULL;
+    resolver.InitAsyncResolve(hostName, hostNameLen, maxAddrs, addrArray, onComplete, appState);
 
     return err;
 }
@@ -296,8 +287,6 @@ void AsyncDNSResolverSockets::Resolve(DNSResolver &resolver)
             switch (getaddrinfoRes)
             {
             case EAI_NODATA:
-                err = INET_NO_ERROR;
-                break;
             case EAI_NONAME:
                 err = INET_ERROR_HOST_NOT_FOUND;
                 break;
@@ -0,0 +1,191 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements DNSCache, the object that caches the results
+ *      of Domain Name System (DNS) resolution in InetLayer.
+ *
+ */
+
+#include <InetLayer/DNSCache.h>
+
+#include <Weave/Support/CodeUtils.h>
+
+#include <string.h>
+#include <strings.h>
+
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+
+namespace nl {
+namespace Inet {
+
+using Weave::System::Timer;
+
+/**
+ *  Empty the cache.
+ */
+void DNSCache::Init(void)
+{
+    Flush();
+}
+
+/**
+ *  Remove all entries from the cache.
+ */
+void DNSCache::Flush(void)
+{
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_SIZE; i++)
+    {
+        mEntries[i].mHostName[0] = '\0';
+    }
+}
+
+/**
+ *  Look up a host name in the cache.
+ *
+ *  @param[in]  hostName    A pointer to a non NULL-terminated C string representing the host name.
+ *  @param[in]  hostNameLen The string length of host name.
+ *  @param[in]  maxAddrs    The maximum number of addresses to store in \c addrArray.
+ *  @param[out] addrArray   The addresses of the cached answer.
+ *  @param[out] numAddrs    The number of addresses stored in \c addrArray.
+ *  @param[out] err         The cached result of the resolution.
+ *
+ *  @return \c true if an unexpired entry can satisfy the request, otherwise \c false. An entry
+ *          that was truncated when added only satisfies requests for as many addresses as it holds.
+ */
+bool DNSCache::Lookup(const char *hostName, uint16_t hostNameLen, uint8_t maxAddrs, IPAddress *addrArray,
+                      uint8_t &numAddrs, INET_ERROR &err)
+{
+    Entry *entry = Find(hostName, hostNameLen, Timer::GetCurrentEpoch());
+
+    VerifyOrExit(entry != NULL, );
+    VerifyOrExit(entry->mIsComplete || entry->mNumAddrs >= maxAddrs, entry = NULL);
+
+    numAddrs = (entry->mNumAddrs < maxAddrs) ? entry->mNumAddrs : maxAddrs;
+    for (uint8_t i = 0; i < numAddrs; i++)
+        addrArray[i] = entry->mAddrs[i];
+    err = entry->mError;
+
+exit:
+    return entry != NULL;
+}
+
+/**
+ *  Add the result of a resolution to the cache, replacing any previous entry for the host name.
+ *
+ *  Only successful, host-not-found, and no-data results are cached.
+ *
+ *  @param[in]  hostName    A pointer to a non NULL-terminated C string representing the host name.
+ *  @param[in]  hostNameLen The string length of host name.
+ *  @param[in]  err         The result of the resolution.
+ *  @param[in]  numAddrs    The number of addresses in \c addrArray.
+ *  @param[in]  addrArray   The resolved addresses.
+ *  @param[in]  isComplete  \c true if \c addrArray holds every address of the answer.
+ *  @param[in]  ttlSec      The lifetime of a successful result, in seconds; capped at
+ *                          #INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC.
+ */
+void DNSCache::Add(const char *hostName, uint16_t hostNameLen, INET_ERROR err, uint8_t numAddrs, const IPAddress *addrArray,
+                   bool isComplete, uint32_t ttlSec)
+{
+    const Timer::Epoch now = Timer::GetCurrentEpoch();
+    Entry *entry;
+
+    VerifyOrExit(err == INET_NO_ERROR || err == INET_ERROR_HOST_NOT_FOUND, );
+    VerifyOrExit(hostNameLen > 0 && hostNameLen <= NL_DNS_HOSTNAME_MAX_LEN, );
+
+    if (hostName[hostNameLen - 1] == '.')
+        hostNameLen--;
+
+    entry = Find(hostName, hostNameLen, now);
+
+    if (entry == NULL)
+    {
+        // Prefer an unused or expired entry, otherwise the entry that expires first.
+        entry = &mEntries[0];
+
+        for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_SIZE; i++)
+        {
+            if (mEntries[i].mHostName[0] == '\0' || !Timer::IsEarlierEpoch(now, mEntries[i].mExpiry))
+            {
+                entry = &mEntries[i];
+                break;
+            }
+
+            if (Timer::IsEarlierEpoch(mEntries[i].mExpiry, entry->mExpiry))
+                entry = &mEntries[i];
+        }
+
+        memcpy(entry->mHostName, hostName, hostNameLen);
+        entry->mHostName[hostNameLen] = '\0';
+    }
+
+    if (numAddrs == 0 || err != INET_NO_ERROR)
+    {
+        numAddrs = 0;
+        ttlSec = INET_CONFIG_DNS_CACHE_NEGATIVE_TTL_SEC;
+    }
+    else if (ttlSec > INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC)
+    {
+        ttlSec = INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC;
+    }
+
+    if (numAddrs > INET_CONFIG_DNS_CACHE_MAX_ADDRS)
+    {
+        numAddrs = INET_CONFIG_DNS_CACHE_MAX_ADDRS;
+        isComplete = false;
+    }
+
+    for (uint8_t i = 0; i < numAddrs; i++)
+        entry->mAddrs[i] = addrArray[i];
+    entry->mNumAddrs = numAddrs;
+    entry->mIsComplete = isComplete;
+    entry->mError = err;
+    entry->mExpiry = now + static_cast<Timer::Epoch>(ttlSec) * 1000;
+
+exit:
+    return;
+}
+
+/**
+ *  Find the unexpired entry for a host name. Host names are compared without regard to case
+ *  or to a trailing dot.
+ */
+DNSCache::Entry *DNSCache::Find(const char *hostName, uint16_t hostNameLen, Timer::Epoch now)
+{
+    if (hostNameLen > 0 && hostName[hostNameLen - 1] == '.')
+        hostNameLen--;
+
+    for (size_t i = 0; i < INET_CONFIG_DNS_CACHE_SIZE; i++)
+    {
+        Entry &entry = mEntries[i];
+
+        if (entry.mHostName[0] == '\0' || !Timer::IsEarlierEpoch(now, entry.mExpiry))
+            continue;
+
+        if (strncasecmp(entry.mHostName, hostName, hostNameLen) == 0 && entry.mHostName[hostNameLen] == '\0')
+            return &entry;
+    }
+
+    return NULL;
+}
+
+} // namespace Inet
+} // namespace nl
+
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
@@ -0,0 +1,89 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines DNSCache, the object that caches the results
+ *      of Domain Name System (DNS) resolution in InetLayer.
+ *
+ */
+
+#ifndef DNSCACHE_H
+#define DNSCACHE_H
+
+#include <InetLayer/IPAddress.h>
+#include <InetLayer/InetError.h>
+#include <InetLayer/DNSResolver.h>
+
+#include <SystemLayer/SystemTimer.h>
+
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+
+namespace nl {
+namespace Inet {
+
+/**
+ *  @class DNSCache
+ *
+ *  @brief
+ *    This is an internal class to InetLayer that keeps the results of
+ *    recent host name resolutions, so that repeated requests for the
+ *    same name are answered without a query. There is no public
+ *    interface available for the application layer, other than
+ *    InetLayer::FlushDNSCache().
+ *
+ *    Successful resolutions are kept for up to
+ *    #INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC seconds. Host-not-found
+ *    and no-data results are kept for
+ *    #INET_CONFIG_DNS_CACHE_NEGATIVE_TTL_SEC seconds. When the cache is
+ *    full, the entry closest to expiry is replaced.
+ *
+ */
+class DNSCache
+{
+public:
+    void Init(void);
+    void Flush(void);
+
+    bool Lookup(const char *hostName, uint16_t hostNameLen, uint8_t maxAddrs, IPAddress *addrArray,
+                uint8_t &numAddrs, INET_ERROR &err);
+    void Add(const char *hostName, uint16_t hostNameLen, INET_ERROR err, uint8_t numAddrs, const IPAddress *addrArray,
+             bool isComplete, uint32_t ttlSec);
+
+private:
+    struct Entry
+    {
+        Weave::System::Timer::Epoch mExpiry;            /**< Time at which the entry expires, in milliseconds. */
+        IPAddress mAddrs[INET_CONFIG_DNS_CACHE_MAX_ADDRS];
+        INET_ERROR mError;                              /**< Result of the resolution. */
+        uint8_t mNumAddrs;                              /**< Number of valid addresses in mAddrs. */
+        bool mIsComplete;                               /**< True if mAddrs holds every address of the answer. */
+        char mHostName[NL_DNS_HOSTNAME_MAX_LEN + 1];    /**< Empty if the entry is unused. */
+    };
+
+    Entry mEntries[INET_CONFIG_DNS_CACHE_SIZE];
+
+    Entry *Find(const char *hostName, uint16_t hostNameLen, Weave::System::Timer::Epoch now);
+};
+
+} // namespace Inet
+} // namespace nl
+
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
+#endif // !defined(DNSCACHE_H)
@@ -0,0 +1,565 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements DNSClientUDP, the object that resolves host
+ *      names by querying a name server over UDP from the Weave event
+ *      loop.
+ *
+ */
+
+#include <InetLayer/InetLayer.h>
+
+#include <Weave/Core/WeaveEncoding.h>
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/RandUtils.h>
+#include <Weave/Support/logging/WeaveLogging.h>
+
+#include <string.h>
+#include <strings.h>
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+#include <netinet/in.h>
+
+namespace nl {
+namespace Inet {
+
+using Weave::System::PacketBuffer;
+using namespace nl::Weave::Encoding;
+
+namespace {
+
+enum
+{
+    kDNSHeaderLength                = 12,
+    kDNSRecordFixedLength           = 10,       // type, class, TTL and data length of a resource record
+    kDNSMaxLabelLength              = 63,
+
+    kDNSFlag_Response               = 0x8000,
+    kDNSFlag_RecursionDesired       = 0x0100,
+    kDNSOpcodeMask                  = 0x7800,
+    kDNSRcodeMask                   = 0x000F,
+
+    kDNSRcode_NoError               = 0,
+    kDNSRcode_ServerFailure         = 2,
+    kDNSRcode_NameError             = 3,
+
+    kDNSType_A                      = 1,
+    kDNSType_AAAA                   = 28,
+    kDNSClass_IN                    = 1,
+};
+
+/**
+ *  Encode a standard recursive query for one record type of a host name.
+ *
+ *  @return The length of the query, or 0 if the host name is not a valid domain name or the
+ *          query doesn't fit in the buffer.
+ */
+uint16_t EncodeQuery(uint8_t *buf, uint16_t bufSize, uint16_t queryId, const char *hostName, uint16_t queryType)
+{
+    uint8_t *p = buf;
+    const char *label = hostName;
+    const size_t hostNameLen = strlen(hostName);
+
+    // Header, one length octet per label plus the root label, then type and class.
+    if (hostNameLen == 0 || static_cast<size_t>(kDNSHeaderLength) + hostNameLen + 2 + 4 > bufSize)
+        return 0;
+
+    BigEndian::Write16(p, queryId);
+    BigEndian::Write16(p, kDNSFlag_RecursionDesired);
+    BigEndian::Write16(p, 1);   // QDCOUNT
+    BigEndian::Write16(p, 0);   // ANCOUNT
+    BigEndian::Write16(p, 0);   // NSCOUNT
+    BigEndian::Write16(p, 0);   // ARCOUNT
+
+    while (*label != '\0')
+    {
+        const char *dot = strchr(label, '.');
+        const size_t labelLen = (dot != NULL) ? static_cast<size_t>(dot - label) : strlen(label);
+
+        if (labelLen == 0 || labelLen > kDNSMaxLabelLength)
+            return 0;
+
+        *p++ = static_cast<uint8_t>(labelLen);
+        memcpy(p, label, labelLen);
+        p += labelLen;
+
+        label += labelLen;
+        if (*label == '.')
+            label++;
+    }
+
+    *p++ = 0;
+    BigEndian::Write16(p, queryType);
+    BigEndian::Write16(p, kDNSClass_IN);
+
+    return static_cast<uint16_t>(p - buf);
+}
+
+/**
+ *  Advance past a possibly compressed domain name.
+ */
+bool SkipName(const uint8_t *&p, const uint8_t *end)
+{
+    while (p < end)
+    {
+        const uint8_t len = *p;
+
+        if ((len & 0xC0) == 0xC0)
+        {
+            // A compression pointer ends the name.
+            p += 2;
+            return p <= end;
+        }
+
+        VerifyOrExit((len & 0xC0) == 0, );
+
+        p += 1 + len;
+
+        if (len == 0)
+            return true;
+    }
+
+exit:
+    return false;
+}
+
+/**
+ *  Check that the question of a response is the uncompressed host name and record type that were
+ *  asked for, and advance past it.
+ */
+bool MatchQuestion(const uint8_t *&p, const uint8_t *end, const char *hostName, uint16_t queryType)
+{
+    const char *label = hostName;
+    bool matches = false;
+
+    while (p < end && *p != 0)
+    {
+        const uint8_t len = *p++;
+
+        VerifyOrExit(len <= kDNSMaxLabelLength && p + len <= end, );
+        VerifyOrExit(strncasecmp(label, reinterpret_cast<const char *>(p), len) == 0, );
+
+        p += len;
+        label += len;
+
+        VerifyOrExit(*label == '.' || *label == '\0', );
+        if (*label == '.')
+            label++;
+    }
+
+    VerifyOrExit(p < end && *label == '\0', );
+    p++;
+
+    VerifyOrExit(p + 4 <= end, );
+    VerifyOrExit(BigEndian::Read16(p) == queryType, );
+    VerifyOrExit(BigEndian::Read16(p) == kDNSClass_IN, );
+
+    matches = true;
+
+exit:
+    return matches;
+}
+
+} // unnamed namespace
+
+/**
+ *  The explicit initializer for the DNSClientUDP class. No name server is
+ *  configured until SetServer() is called.
+ *
+ *  @param[in]  inet  A pointer to the InetLayer object.
+ *
+ *  @retval #INET_NO_ERROR unconditionally.
+ */
+INET_ERROR DNSClientUDP::Init(InetLayer *inet)
+{
+    mInet = inet;
+    mEndPoint = NULL;
+    mServerAddr = IPAddress::Any;
+    mServerPort = 0;
+
+    return INET_NO_ERROR;
+}
+
+/**
+ *  The explicit deinitializer of the DNSClientUDP class. Outstanding requests
+ *  must have been canceled beforehand.
+ *
+ *  @retval #INET_NO_ERROR unconditionally.
+ */
+INET_ERROR DNSClientUDP::Shutdown(void)
+{
+    CloseEndPoint();
+
+    return INET_NO_ERROR;
+}
+
+/**
+ *  Configure the name server that the client sends its queries to.
+ *
+ *  Requests that are already outstanding keep being served by the
+ *  previous configuration until they are retransmitted.
+ *
+ *  @param[in]  serverAddr  The address of the name server, or IPAddress::Any
+ *                          to stop using the client.
+ *  @param[in]  serverPort  The UDP port of the name server.
+ *
+ *  @retval #INET_NO_ERROR  on success.
+ *  @retval other           errors returned by the UDPEndPoint.
+ */
+INET_ERROR DNSClientUDP::SetServer(const IPAddress &serverAddr, uint16_t serverPort)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    UDPEndPoint *endPoint = NULL;
+
+    CloseEndPoint();
+
+    mServerAddr = serverAddr;
+    mServerPort = serverPort;
+
+    VerifyOrExit(serverAddr != IPAddress::Any, );
+
+    err = mInet->NewUDPEndPoint(&endPoint);
+    SuccessOrExit(err);
+
+    err = endPoint->Bind(serverAddr.Type(), IPAddress::Any, 0);
+    SuccessOrExit(err);
+
+    endPoint->AppState = this;
+    endPoint->OnMessageReceived = HandleMessageReceived;
+
+    err = endPoint->Listen();
+    SuccessOrExit(err);
+
+    mEndPoint = endPoint;
+    endPoint = NULL;
+
+exit:
+    if (endPoint != NULL)
+    {
+        endPoint->Free();
+    }
+
+    return err;
+}
+
+/**
+ *  Start resolving the host name of a DNSResolver object prepared with
+ *  DNSResolver::InitAsyncResolve().
+ *
+ *  @param[in]  resolver    A reference to the DNSResolver object.
+ *
+ *  @retval #INET_NO_ERROR                  if the queries were sent.
+ *  @retval #INET_ERROR_INCORRECT_STATE     if no name server is configured.
+ *  @retval #INET_ERROR_INVALID_HOST_NAME   if the host name is not a valid domain name.
+ *  @retval other                           errors returned by the UDPEndPoint.
+ */
+INET_ERROR DNSClientUDP::EnqueueRequest(DNSResolver &resolver)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    uint16_t queryId;
+
+    VerifyOrExit(IsConfigured(), err = INET_ERROR_INCORRECT_STATE);
+
+    // Draw every identifier afresh, so that one seen on the wire doesn't give away the next ones to a
+    // spoofer. The AAAA query uses the even identifier and the A query the odd one that follows it.
+    do
+    {
+        queryId = nl::Weave::GetRandU16() & 0xFFFE;
+    } while (FindRequest(queryId) != NULL);
+
+    resolver.mUsesUDPClient = true;
+    resolver.mQueryId = queryId;
+    resolver.mRetransLeft = INET_CONFIG_DNS_UDP_CLIENT_MAX_RETRANS;
+    resolver.mPendingQueries = kQuery_IPv6;
+#if INET_CONFIG_ENABLE_IPV4
+    resolver.mPendingQueries |= kQuery_IPv4;
+#endif // INET_CONFIG_ENABLE_IPV4
+
+    err = SendQueries(resolver);
+
+exit:
+    return err;
+}
+
+/**
+ *  Cancel an outstanding request. The DNSResolver object is handed back
+ *  to DNSResolver::HandleAsyncResolveComplete() right away, since no
+ *  thread holds on to it.
+ *
+ *  @param[in]    resolver   A reference to the DNSResolver object.
+ */
+void DNSClientUDP::Cancel(DNSResolver &resolver)
+{
+    resolver.mState = DNSResolver::kState_Canceled;
+    resolver.mPendingQueries = 0;
+
+    mInet->SystemLayer()->CancelTimer(HandleRetransTimer, &resolver);
+
+    resolver.HandleAsyncResolveComplete();
+}
+
+INET_ERROR DNSClientUDP::SendQueries(DNSResolver &resolver)
+{
+    INET_ERROR err = INET_NO_ERROR;
+
+    if (resolver.mPendingQueries & kQuery_IPv6)
+    {
+        err = SendQuery(resolver, resolver.mQueryId, kDNSType_AAAA);
+        SuccessOrExit(err);
+    }
+
+    if (resolver.mPendingQueries & kQuery_IPv4)
+    {
+        err = SendQuery(resolver, resolver.mQueryId | 1, kDNSType_A);
+        SuccessOrExit(err);
+    }
+
+    err = mInet->SystemLayer()->StartTimer(INET_CONFIG_DNS_UDP_CLIENT_RETRANS_INTERVAL_MS, HandleRetransTimer, &resolver);
+
+exit:
+    return err;
+}
+
+INET_ERROR DNSClientUDP::SendQuery(const DNSResolver &resolver, uint16_t queryId, uint16_t queryType)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    PacketBuffer *msg = PacketBuffer::New();
+    uint16_t msgLen;
+
+    VerifyOrExit(msg != NULL, err = INET_ERROR_NO_MEMORY);
+
+    msgLen = EncodeQuery(msg->Start(), msg->AvailableDataLength(), queryId, resolver.asyncHostNameBuf, queryType);
+    VerifyOrExit(msgLen != 0, err = INET_ERROR_INVALID_HOST_NAME);
+
+    msg->SetDataLength(msgLen);
+
+    err = mEndPoint->SendTo(mServerAddr, mServerPort, msg);
+    msg = NULL;
+
+exit:
+    if (msg != NULL)
+    {
+        PacketBuffer::Free(msg);
+    }
+
+    return err;
+}
+
+void DNSClientUDP::HandleResponse(PacketBuffer *msg)
+{
+    const uint8_t *p = msg->Start();
+    const uint8_t * const end = p + msg->DataLength();
+    DNSResolver *resolver;
+    INET_ERROR err = INET_NO_ERROR;
+    uint16_t queryId;
+    uint16_t flags;
+    uint16_t questionCount;
+    uint16_t answerCount;
+    uint8_t query;
+
+    VerifyOrExit(msg->DataLength() >= kDNSHeaderLength, );
+
+    queryId = BigEndian::Read16(p);
+    flags = BigEndian::Read16(p);
+    questionCount = BigEndian::Read16(p);
+    answerCount = BigEndian::Read16(p);
+    p += 4;
+
+    VerifyOrExit((flags & kDNSFlag_Response) != 0 && (flags & kDNSOpcodeMask) == 0, );
+    VerifyOrExit(questionCount == 1, );
+
+    resolver = FindRequest(queryId & 0xFFFE);
+    VerifyOrExit(resolver != NULL, );
+
+    query = (queryId & 1) ? kQuery_IPv4 : kQuery_IPv6;
+    VerifyOrExit(resolver->mPendingQueries & query, );
+
+    VerifyOrExit(MatchQuestion(p, end, resolver->asyncHostNameBuf, (query == kQuery_IPv6) ? kDNSType_AAAA : kDNSType_A), );
+
+    switch (flags & kDNSRcodeMask)
+    {
+    case kDNSRcode_NoError:
+        break;
+    case kDNSRcode_NameError:
+        err = INET_ERROR_HOST_NOT_FOUND;
+        break;
+    case kDNSRcode_ServerFailure:
+        err = INET_ERROR_DNS_TRY_AGAIN;
+        break;
+    default:
+        err = INET_ERROR_DNS_NO_RECOVERY;
+        break;
+    }
+
+    // Records that can't be parsed end the answer section; the addresses read so far are kept.
+    for (uint16_t i = 0; err == INET_NO_ERROR && i < answerCount; i++)
+    {
+        uint16_t type;
+        uint16_t cls;
+        uint32_t ttl;
+        uint16_t dataLen;
+
+        if (!SkipName(p, end) || p + kDNSRecordFixedLength > end)
+            break;
+
+        type = BigEndian::Read16(p);
+        cls = BigEndian::Read16(p);
+        ttl = BigEndian::Read32(p);
+        dataLen = BigEndian::Read16(p);
+
+        if (p + dataLen > end)
+            break;
+
+        if (cls == kDNSClass_IN && resolver->NumAddrs < resolver->MaxAddrs)
+        {
+            IPAddress *addr = &resolver->AddrArray[resolver->NumAddrs];
+            bool isAddress = false;
+
+            if (query == kQuery_IPv6 && type == kDNSType_AAAA && dataLen == 16)
+            {
+                uint8_t *addrBytes = const_cast<uint8_t *>(p);
+
+                IPAddress::ReadAddress(addrBytes, *addr);
+                isAddress = true;
+            }
+#if INET_CONFIG_ENABLE_IPV4
+            else if (query == kQuery_IPv4 && type == kDNSType_A && dataLen == 4)
+            {
+                struct in_addr ipv4Addr;
+
+                memcpy(&ipv4Addr, p, sizeof(ipv4Addr));
+                *addr = IPAddress::FromIPv4(ipv4Addr);
+                isAddress = true;
+            }
+#endif // INET_CONFIG_ENABLE_IPV4
+
+            if (isAddress)
+            {
+                resolver->NumAddrs++;
+
+                if (ttl < resolver->mTTLSec)
+                    resolver->mTTLSec = ttl;
+            }
+        }
+
+        p += dataLen;
+    }
+
+    resolver->mPendingQueries &= ~query;
+
+    if (resolver->asyncDNSResolveResult == INET_NO_ERROR)
+        resolver->asyncDNSResolveResult = err;
+
+    if (resolver->mPendingQueries == 0)
+        CompleteRequest(*resolver);
+
+exit:
+    return;
+}
+
+DNSResolver *DNSClientUDP::FindRequest(uint16_t queryId)
+{
+    Weave::System::Layer& lSystemLayer = *mInet->SystemLayer();
+
+    for (size_t i = 0; i < DNSResolver::sPool.Size(); i++)
+    {
+        DNSResolver* lResolver = DNSResolver::sPool.Get(lSystemLayer, i);
+
+        if (lResolver != NULL && lResolver->IsCreatedByInetLayer(*mInet) && lResolver->mUsesUDPClient &&
+            lResolver->mState == DNSResolver::kState_Active && lResolver->mQueryId == queryId)
+        {
+            return lResolver;
+        }
+    }
+
+    return NULL;
+}
+
+void DNSClientUDP::CompleteRequest(DNSResolver &resolver)
+{
+    mInet->SystemLayer()->CancelTimer(HandleRetransTimer, &resolver);
+
+    resolver.mPendingQueries = 0;
+
+    // An address from either query makes the request successful, while answers without any address
+    // mean that the host has none, as for the other resolvers.
+    if (resolver.NumAddrs > 0)
+        resolver.asyncDNSResolveResult = INET_NO_ERROR;
+    else if (resolver.asyncDNSResolveResult == INET_NO_ERROR)
+        resolver.asyncDNSResolveResult = INET_ERROR_HOST_NOT_FOUND;
+
+    resolver.HandleAsyncResolveComplete();
+}
+
+void DNSClientUDP::CloseEndPoint(void)
+{
+    if (mEndPoint != NULL)
+    {
+        mEndPoint->Free();
+        mEndPoint = NULL;
+    }
+}
+
+void DNSClientUDP::HandleMessageReceived(UDPEndPoint *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo)
+{
+    DNSClientUDP *client = static_cast<DNSClientUDP *>(endPoint->AppState);
+
+    // Only accept answers from the configured name server.
+    if (pktInfo->SrcAddress == client->mServerAddr && pktInfo->SrcPort == client->mServerPort)
+    {
+        client->HandleResponse(msg);
+    }
+
+    PacketBuffer::Free(msg);
+}
+
+void DNSClientUDP::HandleRetransTimer(Weave::System::Layer *aSystemLayer, void *aAppState, Weave::System::Error aError)
+{
+    DNSResolver &resolver = *static_cast<DNSResolver *>(aAppState);
+    DNSClientUDP &client = resolver.Layer().mDNSClientUDP;
+    INET_ERROR err = INET_NO_ERROR;
+
+    VerifyOrExit(resolver.mState == DNSResolver::kState_Active && resolver.mPendingQueries != 0, );
+
+    if (resolver.mRetransLeft == 0 || !client.IsConfigured())
+    {
+        WeaveLogProgress(Inet, "DNS query for %s timed out", resolver.asyncHostNameBuf);
+        ExitNow(err = INET_ERROR_DNS_TRY_AGAIN);
+    }
+
+    resolver.mRetransLeft--;
+
+    err = client.SendQueries(resolver);
+
+exit:
+    if (err != INET_NO_ERROR)
+    {
+        if (resolver.asyncDNSResolveResult == INET_NO_ERROR)
+            resolver.asyncDNSResolveResult = err;
+
+        client.CompleteRequest(resolver);
+    }
+}
+
+} // namespace Inet
+} // namespace nl
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
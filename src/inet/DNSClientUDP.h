@@ -0,0 +1,113 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines DNSClientUDP, the object that resolves host
+ *      names by querying a name server over UDP from the Weave event
+ *      loop.
+ *
+ */
+
+#ifndef DNSCLIENTUDP_H
+#define DNSCLIENTUDP_H
+
+#include <InetLayer/IPAddress.h>
+#include <InetLayer/InetError.h>
+#include <InetLayer/DNSResolver.h>
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+namespace nl {
+namespace Inet {
+
+class UDPEndPoint;
+class IPPacketInfo;
+
+/**
+ *  @class DNSClientUDP
+ *
+ *  @brief
+ *    This is an internal class to InetLayer that resolves host names
+ *    without blocking and without helper threads. For every request it
+ *    sends an AAAA query (and, with IPv4 enabled, an A query) to the
+ *    name server configured with InetLayer::SetDNSServer(), retransmits
+ *    unanswered queries, and completes the request from the UDPEndPoint
+ *    reception handler. There is no public interface available for the
+ *    application layer.
+ *
+ *    Truncated answers are used as they are; the client does not fall
+ *    back to TCP.
+ *
+ */
+class DNSClientUDP
+{
+    friend class InetLayer;
+    friend class DNSResolver;
+public:
+
+    INET_ERROR Init(InetLayer *inet);
+
+    INET_ERROR Shutdown(void);
+
+    INET_ERROR SetServer(const IPAddress &serverAddr, uint16_t serverPort);
+
+    bool IsConfigured(void) const;
+
+    INET_ERROR EnqueueRequest(DNSResolver &resolver);
+
+    void Cancel(DNSResolver &resolver);
+
+private:
+    enum
+    {
+        kQuery_IPv6                 = 0x01, /**< The AAAA query is outstanding. */
+        kQuery_IPv4                 = 0x02, /**< The A query is outstanding. */
+    };
+
+    InetLayer                       *mInet;             /* The pointer to the InetLayer. */
+    UDPEndPoint                     *mEndPoint;         /* The end point queries are sent from, if a server is configured. */
+    IPAddress                       mServerAddr;
+    uint16_t                        mServerPort;
+
+    INET_ERROR SendQueries(DNSResolver &resolver);
+    INET_ERROR SendQuery(const DNSResolver &resolver, uint16_t queryId, uint16_t queryType);
+    void HandleResponse(Weave::System::PacketBuffer *msg);
+    DNSResolver *FindRequest(uint16_t queryId);
+    void CompleteRequest(DNSResolver &resolver);
+    void CloseEndPoint(void);
+
+    static void HandleMessageReceived(UDPEndPoint *endPoint, Weave::System::PacketBuffer *msg, const IPPacketInfo *pktInfo);
+    static void HandleRetransTimer(Weave::System::Layer *aSystemLayer, void *aAppState, Weave::System::Error aError);
+};
+
+/**
+ *  Returns \c true if a name server has been configured, in which case host names are resolved by
+ *  this client.
+ */
+inline bool DNSClientUDP::IsConfigured(void) const
+{
+    return mEndPoint != NULL;
+}
+
+} // namespace Inet
+} // namespace nl
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+#endif // !defined(DNSCLIENTUDP_H)
@@ -28,7 +28,10 @@
 #include <InetLayer/InetLayer.h>
 #include <InetLayer/InetLayerEvents.h>
 
+#include <Weave/Support/CodeUtils.h>
+
 #include <string.h>
+#include <strings.h>
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #include <lwip/dns.h>
@@ -163,8 +166,6 @@ INET_ERROR DNSResolver::Resolve(const char *hostName, uint16_t hostNameLen, uint
         switch (getaddrinfoRes)
         {
         case EAI_NODATA:
-            err = INET_NO_ERROR;
-            break;
         case EAI_NONAME:
             err = INET_ERROR_HOST_NOT_FOUND;
             break;
@@ -183,6 +184,11 @@ INET_ERROR DNSResolver::Resolve(const char *hostName, uint16_t hostNameLen, uint
     if (lookupRes != NULL)
         freeaddrinfo(lookupRes);
 
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    Layer().mDNSCache.Add(hostName, hostNameLen, err, NumAddrs, addrArray, NumAddrs < maxAddrs,
+                          INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC);
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
     onComplete(appState, err, NumAddrs, addrArray);
 
     Release();
@@ -229,16 +235,38 @@ INET_ERROR DNSResolver::Cancel()
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT
     // NOTE: DNS lookups can be canceled only when using the asynchronous mode.
 
     InetLayer& inet = Layer();
 
     OnComplete = NULL;
     AppState = NULL;
-    inet.mAsyncDNSResolver.Cancel(*this);
 
+    if (mState == kState_Waiting)
+    {
+        // No query is outstanding on behalf of this object.
+        mState = kState_Canceled;
+        Release();
+    }
+#if INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    else if (mUsesUDPClient)
+    {
+        inet.mDNSClientUDP.Cancel(*this);
+    }
+#endif // INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+    else
+    {
+        inet.mAsyncDNSResolver.Cancel(*this);
+
+        // The worker thread may stay blocked in getaddrinfo() for a long time; don't keep the requests
+        // waiting for this one until it returns.
+        ReissueWaitingResolvers();
+    }
 #endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+
+#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     return INET_NO_ERROR;
@@ -320,19 +348,190 @@ void DNSResolver::CopyAddresses(uint8_t numAddrs, const ip_addr_t *addrs)
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+/**
+ *  This method prepares the DNSResolver object for an asynchronous resolution.
+ *
+ *  @param[in]  hostName    A pointer to a non NULL-terminated C string representing
+ *                          the host name to be queried.
+ *  @param[in]  hostNameLen The string length of host name.
+ *  @param[in]  maxAddrs    The maximum number of addresses to store in the DNS
+ *                          table.
+ *  @param[in]  addrArray   A pointer to the DNS table.
+ *  @param[in]  onComplete  A pointer to the callback function when a DNS
+ *                          request is complete.
+ *  @param[in]  appState    A pointer to the application state to be passed to
+ *                          onComplete when a DNS request is complete.
+ *
+ */
+void DNSResolver::InitAsyncResolve(const char *hostName, uint16_t hostNameLen, uint8_t maxAddrs, IPAddress *addrArray,
+    OnResolveCompleteFunct onComplete, void *appState)
+{
+    memcpy(asyncHostNameBuf, hostName, hostNameLen);
+    asyncHostNameBuf[hostNameLen] = 0;
+    MaxAddrs = maxAddrs;
+    NumAddrs = 0;
+    AddrArray = addrArray;
+    AppState = appState;
+    OnComplete = onComplete;
+    asyncDNSResolveResult = INET_NO_ERROR;
+    mState = kState_Active;
+    pNextAsyncDNSResolver = NULL;
+    mLeader = NULL;
+    mTTLSec = INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC;
+
+#if INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    mUsesUDPClient = false;
+    mPendingQueries = 0;
+    mRetransLeft = 0;
+    mQueryId = 0;
+#endif // INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+}
 
+/**
+ *  This method tells whether this DNSResolver object can wait for the result of
+ *  another, active, resolution instead of issuing its own query.
+ *
+ *  @param[in]  other   The active DNSResolver object.
+ *
+ *  @return \c true if \c other resolves the same host name for the same
+ *          InetLayer, and keeps at least as many addresses.
+ *
+ */
+bool DNSResolver::CanShareResultWith(const DNSResolver &other) const
+{
+    return (&other != this &&
+            other.IsCreatedByInetLayer(Layer()) &&
+            other.mState == kState_Active &&
+            other.MaxAddrs >= MaxAddrs &&
+            strcasecmp(other.asyncHostNameBuf, asyncHostNameBuf) == 0);
+}
+
+/**
+ *  This method is called in the Weave thread when an asynchronous resolution
+ *  completes, fails, or, for the UDP DNS client, is canceled.
+ *
+ *  The result is added to the DNS cache and handed to the DNSResolver objects
+ *  waiting for it, and the application's completion handler is called unless
+ *  the request has been canceled.
+ *
+ */
 void DNSResolver::HandleAsyncResolveComplete(void)
 {
-    // Copy the resolved address to the application supplied buffer, but only if the request hasn't been canceled.
-    if (OnComplete && mState != kState_Canceled)
+    if (mState == kState_Canceled)
     {
-        OnComplete(AppState, asyncDNSResolveResult, NumAddrs, AddrArray);
+        // The query may not have completed; let one of the waiting objects issue it again. Requests canceled
+        // while a worker thread resolves them have already handed their waiting objects over.
+        ReissueWaitingResolvers();
+    }
+    else
+    {
+        // Don't let requests made from the completion handlers wait for this object.
+        mState = kState_Complete;
+
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+        Layer().mDNSCache.Add(asyncHostNameBuf, strlen(asyncHostNameBuf), asyncDNSResolveResult, NumAddrs, AddrArray,
+                              NumAddrs < MaxAddrs, mTTLSec);
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
+        CompleteWaitingResolvers();
+
+        // Copy the resolved address to the application supplied buffer, but only if the request hasn't been canceled.
+        if (OnComplete)
+        {
+            OnComplete(AppState, asyncDNSResolveResult, NumAddrs, AddrArray);
+        }
     }
 
     Release();
 }
-#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+
+/**
+ *  This method hands the result of this resolution to the DNSResolver objects
+ *  waiting for it, and releases them.
+ *
+ */
+void DNSResolver::CompleteWaitingResolvers(void)
+{
+    Weave::System::Layer& lSystemLayer = SystemLayer();
+
+    for (size_t i = 0; i < sPool.Size(); i++)
+    {
+        DNSResolver* lResolver = sPool.Get(lSystemLayer, i);
+        OnResolveCompleteFunct lOnComplete;
+        void* lAppState;
+        uint8_t lNumAddrs;
+
+        if (lResolver == NULL || lResolver->mState != kState_Waiting || lResolver->mLeader != this)
+        {
+            continue;
+        }
+
+        lNumAddrs = (NumAddrs < lResolver->MaxAddrs) ? NumAddrs : lResolver->MaxAddrs;
+        for (uint8_t j = 0; j < lNumAddrs; j++)
+            lResolver->AddrArray[j] = AddrArray[j];
+
+        // Clear the callback first, so that the application can't cancel the object from within it.
+        lOnComplete = lResolver->OnComplete;
+        lAppState = lResolver->AppState;
+        lResolver->OnComplete = NULL;
+        lResolver->mState = kState_Complete;
+
+        if (lOnComplete)
+        {
+            lOnComplete(lAppState, asyncDNSResolveResult, lNumAddrs, lResolver->AddrArray);
+        }
+
+        lResolver->Release();
+    }
+}
+
+/**
+ *  This method issues the query of a canceled resolution on behalf of the first
+ *  DNSResolver object waiting for it, which the other waiting objects then wait for.
+ *
+ */
+void DNSResolver::ReissueWaitingResolvers(void)
+{
+    Weave::System::Layer& lSystemLayer = SystemLayer();
+    DNSResolver* lNewLeader = NULL;
+    INET_ERROR err;
+
+    for (size_t i = 0; i < sPool.Size(); i++)
+    {
+        DNSResolver* lResolver = sPool.Get(lSystemLayer, i);
+
+        if (lResolver == NULL || lResolver->mState != kState_Waiting || lResolver->mLeader != this)
+        {
+            continue;
+        }
+
+        if (lNewLeader == NULL)
+        {
+            lNewLeader = lResolver;
+            lNewLeader->mLeader = NULL;
+        }
+        else
+        {
+            lResolver->mLeader = lNewLeader;
+        }
+    }
+
+    VerifyOrExit(lNewLeader != NULL, );
+
+    err = Layer().StartAsyncResolve(*lNewLeader);
+    if (err != INET_NO_ERROR)
+    {
+        lNewLeader->asyncDNSResolveResult = err;
+        lNewLeader->HandleAsyncResolveComplete();
+    }
+
+exit:
+    return;
+}
+
+#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 } // namespace Inet
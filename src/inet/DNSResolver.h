@@ -54,7 +54,12 @@ private:
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
     friend class AsyncDNSResolverSockets;
+#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    friend class DNSClientUDP;
+#endif // INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT
     /// States of the DNSResolver object with respect to hostname resolution.
     typedef enum DNSResolverState
     {
@@ -62,9 +67,10 @@ private:
         kState_Active                        = 2, ///<Used to indicate that a DNS resolution is being performed on the DNSResolver object.
         kState_Complete                      = 3, ///<Used to indicate that the DNS resolution on the DNSResolver object is complete.
         kState_Canceled                      = 4, ///<Used to indicate that the DNS resolution on the DNSResolver has been canceled.
+        kState_Waiting                       = 5, ///<Used to indicate that the DNSResolver object waits for the result of another, identical, resolution.
     } DNSResolverState;
+#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 
     /**
      * @brief   Type of event handling function called when a DNS request completes.
@@ -103,7 +109,7 @@ private:
     uint8_t NumAddrs;
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 
     /* Hostname that requires resolution */
     char asyncHostNameBuf[NL_DNS_HOSTNAME_MAX_LEN + 1]; // DNS limits hostnames to 253 max characters.
@@ -112,11 +118,32 @@ private:
     /* The next DNSResolver object in the asynchronous DNS resolution queue. */
     DNSResolver *pNextAsyncDNSResolver;
 
+    /* The resolution whose result a DNSResolver object in the kState_Waiting state shares. */
+    DNSResolver *mLeader;
+
+    /* Lifetime of the result, in seconds, used when adding it to the DNS cache. */
+    uint32_t mTTLSec;
+
     DNSResolverState mState;
 
+#if INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    /* True if the resolution is performed by the UDP DNS client rather than getaddrinfo(). */
+    bool mUsesUDPClient;
+
+    /* UDP DNS client query state. */
+    uint8_t mPendingQueries;
+    uint8_t mRetransLeft;
+    uint16_t mQueryId;
+#endif // INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+    void InitAsyncResolve(const char *hostName, uint16_t hostNameLen, uint8_t maxAddrs, IPAddress *addrArray,
+        OnResolveCompleteFunct onComplete, void *appState);
+    bool CanShareResultWith(const DNSResolver &other) const;
     void HandleAsyncResolveComplete(void);
+    void CompleteWaitingResolvers(void);
+    void ReissueWaitingResolvers(void);
 
-#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
     INET_ERROR Resolve(const char *hostName, uint16_t hostNameLen, uint8_t maxAddrs, IPAddress *addrArray,
@@ -576,6 +576,43 @@
 #define INET_CONFIG_TUNNEL_DEVICE_NAME                      "/dev/net/tun"
 #endif //INET_CONFIG_TUNNEL_DEVICE_NAME
 
+/**
+ *  @def INET_CONFIG_TUN_MAX_READ_BATCH
+ *
+ *  @brief
+ *    The maximum number of IPv6 packets read from the tunnel device
+ *    each time it becomes readable (sockets only).
+ *
+ *  @details
+ *    Draining several packets per readiness event amortizes the cost of
+ *    select() over bulk traffic. Once the batch has been delivered to
+ *    the \c OnPacketReceived handler, the \c OnReceiveBatchComplete
+ *    handler is invoked, allowing the upper layer to flush any output
+ *    it deferred while the batch was in progress.
+ *
+ *    Set to 1 to read a single packet per readiness event.
+ */
+#ifndef INET_CONFIG_TUN_MAX_READ_BATCH
+#define INET_CONFIG_TUN_MAX_READ_BATCH                      16
+#endif // INET_CONFIG_TUN_MAX_READ_BATCH
+
+/**
+ *  @def INET_CONFIG_TCP_SEND_MAX_IOVECS
+ *
+ *  @brief
+ *    The maximum number of queued buffers that a TCP end point will
+ *    gather into a single send system call (sockets only).
+ *
+ *  @details
+ *    Data queued on a TCP end point via multiple calls to
+ *    TCPEndPoint::Send() is written to the socket with vectored I/O, so
+ *    that messages queued back-to-back leave in one system call rather
+ *    than one per buffer.
+ */
+#ifndef INET_CONFIG_TCP_SEND_MAX_IOVECS
+#define INET_CONFIG_TCP_SEND_MAX_IOVECS                     16
+#endif // INET_CONFIG_TCP_SEND_MAX_IOVECS
+
 /**
  * @def INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
  *
@@ -595,6 +632,170 @@
 #define INET_CONFIG_DNS_ASYNC_MAX_THREAD_COUNT             2
 #endif // INET_CONFIG_DNS_ASYNC_MAX_THREAD_COUNT
 
+/**
+ *  @def INET_CONFIG_DNS_CACHE_SIZE
+ *
+ *  @brief
+ *    The number of host names whose resolution results are cached by
+ *    InetLayer::ResolveHostAddress().
+ *
+ *  @details
+ *    Set to 0 to disable the cache. LwIP keeps its own DNS cache, so
+ *    the InetLayer cache is disabled there by default.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_SIZE
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#define INET_CONFIG_DNS_CACHE_SIZE                          4
+#else // !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#define INET_CONFIG_DNS_CACHE_SIZE                          0
+#endif // !WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#endif // INET_CONFIG_DNS_CACHE_SIZE
+
+/**
+ *  @def INET_CONFIG_DNS_CACHE_MAX_ADDRS
+ *
+ *  @brief
+ *    The maximum number of addresses kept per DNS cache entry.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_MAX_ADDRS
+#define INET_CONFIG_DNS_CACHE_MAX_ADDRS                     4
+#endif // INET_CONFIG_DNS_CACHE_MAX_ADDRS
+
+/**
+ *  @def INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC
+ *
+ *  @brief
+ *    The maximum time, in seconds, that a successful resolution is
+ *    served from the DNS cache.
+ *
+ *  @details
+ *    getaddrinfo() does not report record TTLs, so results obtained
+ *    from it are kept for exactly this long. Results obtained from
+ *    the UDP DNS client are kept for the smallest TTL of the answer
+ *    records, capped at this value.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC
+#define INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC              60
+#endif // INET_CONFIG_DNS_CACHE_POSITIVE_TTL_SEC
+
+/**
+ *  @def INET_CONFIG_DNS_CACHE_NEGATIVE_TTL_SEC
+ *
+ *  @brief
+ *    The time, in seconds, that a host-not-found or no-data result is
+ *    served from the DNS cache.
+ *
+ *  @details
+ *    Transient failures, such as timeouts or server failures, are
+ *    never cached.
+ */
+#ifndef INET_CONFIG_DNS_CACHE_NEGATIVE_TTL_SEC
+#define INET_CONFIG_DNS_CACHE_NEGATIVE_TTL_SEC              10
+#endif // INET_CONFIG_DNS_CACHE_NEGATIVE_TTL_SEC
+
+/**
+ *  @def INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+ *
+ *  @brief
+ *    Build the non-blocking UDP DNS client (sockets only).
+ *
+ *  @details
+ *    The client sends queries over a UDPEndPoint and processes the
+ *    answers on the Weave event loop. It is only used once a name
+ *    server has been configured with InetLayer::SetDNSServer();
+ *    until then, host names are resolved with getaddrinfo().
+ */
+#ifndef INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+#define INET_CONFIG_ENABLE_DNS_UDP_CLIENT                   (WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_UDP_ENDPOINT)
+#endif // INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+/**
+ *  @def INET_CONFIG_DNS_UDP_CLIENT_RETRANS_INTERVAL_MS
+ *
+ *  @brief
+ *    The time, in milliseconds, that the UDP DNS client waits for an
+ *    answer before retransmitting a query.
+ */
+#ifndef INET_CONFIG_DNS_UDP_CLIENT_RETRANS_INTERVAL_MS
+#define INET_CONFIG_DNS_UDP_CLIENT_RETRANS_INTERVAL_MS      1000
+#endif // INET_CONFIG_DNS_UDP_CLIENT_RETRANS_INTERVAL_MS
+
+/**
+ *  @def INET_CONFIG_DNS_UDP_CLIENT_MAX_RETRANS
+ *
+ *  @brief
+ *    The number of times the UDP DNS client retransmits an unanswered
+ *    query before failing the request with #INET_ERROR_DNS_TRY_AGAIN.
+ */
+#ifndef INET_CONFIG_DNS_UDP_CLIENT_MAX_RETRANS
+#define INET_CONFIG_DNS_UDP_CLIENT_MAX_RETRANS              2
+#endif // INET_CONFIG_DNS_UDP_CLIENT_MAX_RETRANS
+
+/**
+ *  @def INET_CONFIG_ENABLE_INTERFACE_CACHE
+ *
+ *  @brief
+ *    Keep an in-process table of the system network interfaces and
+ *    their addresses, maintained from an rtnetlink socket (Linux
+ *    sockets only).
+ *
+ *  @details
+ *    While the table is valid, InterfaceIterator,
+ *    InterfaceAddressIterator, GetInterfaceName(), InterfaceNameToId()
+ *    and InetLayer::GetLinkLocalAddr() answer from it instead of
+ *    calling getifaddrs() and if_nametoindex() on every query, and
+ *    InetLayer::AddInterfaceChangeHandler() reports changes to the
+ *    interfaces and addresses as they happen.
+ */
+#ifndef INET_CONFIG_ENABLE_INTERFACE_CACHE
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && defined(__linux__) && !defined(__ANDROID__)
+#define INET_CONFIG_ENABLE_INTERFACE_CACHE                  1
+#else
+#define INET_CONFIG_ENABLE_INTERFACE_CACHE                  0
+#endif
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+/**
+ *  @def INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES
+ *
+ *  @brief
+ *    The number of network interfaces the interface cache can hold.
+ *
+ *  @details
+ *    If the system has more interfaces or addresses than the cache can
+ *    hold, queries fall back to the system calls until the table fits
+ *    again. Changes are still reported to the handlers registered with
+ *    InetLayer::AddInterfaceChangeHandler() as they happen.
+ */
+#ifndef INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES
+#define INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES          16
+#endif // INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES
+
+/**
+ *  @def INET_CONFIG_INTERFACE_CACHE_MAX_ADDRESSES
+ *
+ *  @brief
+ *    The number of interface IP addresses the interface cache can hold.
+ *
+ *  @details
+ *    See #INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES for what happens
+ *    when the system has more addresses.
+ */
+#ifndef INET_CONFIG_INTERFACE_CACHE_MAX_ADDRESSES
+#define INET_CONFIG_INTERFACE_CACHE_MAX_ADDRESSES           64
+#endif // INET_CONFIG_INTERFACE_CACHE_MAX_ADDRESSES
+
+/**
+ *  @def INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS
+ *
+ *  @brief
+ *    The number of handlers that can be registered with
+ *    InetLayer::AddInterfaceChangeHandler().
+ */
+#ifndef INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS
+#define INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS     4
+#endif // INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS
+
 /**
  *  @def INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
  *
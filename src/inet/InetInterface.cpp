@@ -33,6 +33,7 @@
 
 #include <InetLayer/InetLayer.h>
 #include <InetLayer/InetLayerEvents.h>
+#include <InetLayer/InterfaceCache.h>
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #include <lwip/sys.h>
@@ -72,6 +73,19 @@ NL_DLL_EXPORT INET_ERROR GetInterfaceName(InterfaceId intfId, char *nameBuf, siz
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    const InterfaceCache *cache = InterfaceCache::GetActive();
+    const InterfaceCache::Interface *cachedIntf = (cache != NULL) ? cache->FindInterface(intfId) : NULL;
+
+    if (cachedIntf != NULL)
+    {
+        if (strlen(cachedIntf->mName) >= nameBufSize)
+            return INET_ERROR_NO_MEMORY;
+        strcpy(nameBuf, cachedIntf->mName);
+        return INET_NO_ERROR;
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
     if (intfId != INET_NULL_INTERFACEID)
     {
         char intfName[IF_NAMESIZE];
@@ -111,6 +125,17 @@ NL_DLL_EXPORT INET_ERROR InterfaceNameToId(const char *intfName, InterfaceId& in
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    const InterfaceCache *cache = InterfaceCache::GetActive();
+    const InterfaceCache::Interface *cachedIntf = (cache != NULL) ? cache->FindInterface(intfName) : NULL;
+
+    if (cachedIntf != NULL)
+    {
+        intfId = cachedIntf->mId;
+        return INET_NO_ERROR;
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
     intfId = if_nametoindex(intfName);
     if (intfId == 0)
         return (errno == ENXIO) ? INET_ERROR_UNKNOWN_INTERFACE : Weave::System::MapErrorPOSIX(errno);
@@ -126,6 +151,17 @@ InterfaceIterator::InterfaceIterator()
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     int rv;
+
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    cache = InterfaceCache::GetActive();
+    curCacheIndex = 0;
+    if (cache != NULL)
+    {
+        curAddr = addrsList = NULL;
+        return;
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
     rv = getifaddrs(&addrsList);
     if (rv != -1)
         curAddr = addrsList;
@@ -156,6 +192,15 @@ bool InterfaceIterator::Next()
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    if (cache != NULL)
+    {
+        if (curCacheIndex < cache->NumInterfaces())
+            curCacheIndex++;
+        return HasCurrent();
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
     if (curAddr != NULL)
     {
         const char *lastIntfName = curAddr->ifa_name;
@@ -178,6 +223,10 @@ InterfaceId InterfaceIterator::GetInterface()
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+        if (cache != NULL)
+            return cache->GetInterface(curCacheIndex).mId;
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
         rv = if_nametoindex(curAddr->ifa_name);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     }
@@ -198,6 +247,10 @@ bool InterfaceIterator::SupportsMulticast()
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+        if (cache != NULL)
+            return (cache->GetInterface(curCacheIndex).mFlags & IFF_MULTICAST) != 0;
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
         return (curAddr->ifa_flags & IFF_MULTICAST) != 0;
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     }
@@ -205,6 +258,18 @@ bool InterfaceIterator::SupportsMulticast()
         return false;
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+bool InterfaceIterator::HasCurrent(void) const
+{
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    if (cache != NULL)
+        return curCacheIndex < cache->NumInterfaces();
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+    return (curAddr != NULL);
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 
 
 InterfaceAddressIterator::InterfaceAddressIterator()
@@ -216,6 +281,17 @@ InterfaceAddressIterator::InterfaceAddressIterator()
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     int rv;
+
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    cache = InterfaceCache::GetActive();
+    curCacheIndex = 0;
+    if (cache != NULL)
+    {
+        curAddr = addrsList = NULL;
+        return;
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
     rv = getifaddrs(&addrsList);
     if (rv != -1) {
         curAddr = addrsList;
@@ -272,6 +348,15 @@ bool InterfaceAddressIterator::Next()
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    if (cache != NULL)
+    {
+        if (curCacheIndex < cache->NumAddresses())
+            curCacheIndex++;
+        return HasCurrent();
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
     if (curAddr != NULL)
         while (true)
         {
@@ -301,6 +386,11 @@ IPAddress InterfaceAddressIterator::GetAddress()
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+        if (cache != NULL)
+            return cache->GetAddress(curCacheIndex).mAddr;
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
         if (curAddr->ifa_addr->sa_family == AF_INET6)
         {
             rv = IPAddress::FromIPv6(((struct sockaddr_in6*)curAddr->ifa_addr)->sin6_addr);
@@ -323,6 +413,15 @@ uint8_t InterfaceAddressIterator::GetIPv6PrefixLength()
 {
     uint8_t prefixLen = 0;
 
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    if (cache != NULL)
+    {
+        if (HasCurrent() && cache->GetAddress(curCacheIndex).mAddr.Type() == kIPAddressType_IPv6)
+            prefixLen = cache->GetAddress(curCacheIndex).mPrefixLength;
+        return prefixLen;
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
     if (curAddr->ifa_addr->sa_family == AF_INET6)
     {
         struct sockaddr_in6& netmask = *(struct sockaddr_in6 *)(curAddr->ifa_netmask);
@@ -366,6 +465,10 @@ InterfaceId InterfaceAddressIterator::GetInterface()
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+        if (cache != NULL)
+            return cache->GetAddress(curCacheIndex).mIntfId;
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
         rv = if_nametoindex(curAddr->ifa_name);
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     }
@@ -386,6 +489,13 @@ bool InterfaceAddressIterator::SupportsMulticast()
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+        if (cache != NULL)
+        {
+            const InterfaceCache::Interface *intf = cache->FindInterface(cache->GetAddress(curCacheIndex).mIntfId);
+            return (intf != NULL) && (intf->mFlags & IFF_MULTICAST) != 0;
+        }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
         return (curAddr->ifa_flags & IFF_MULTICAST) != 0;
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     }
@@ -393,5 +503,17 @@ bool InterfaceAddressIterator::SupportsMulticast()
         return false;
 }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+bool InterfaceAddressIterator::HasCurrent(void) const
+{
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    if (cache != NULL)
+        return curCacheIndex < cache->NumAddresses();
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+    return (curAddr != NULL);
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+
 } // namespace Inet
 } // namespace nl
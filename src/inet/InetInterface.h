@@ -38,6 +38,8 @@ struct ifaddrs;
 namespace nl {
 namespace Inet {
 
+class InterfaceCache;
+
 /**
  * @typedef     InterfaceId
  *
@@ -130,6 +132,39 @@ extern INET_ERROR GetInterfaceName(InterfaceId intfId, char *nameBuf, size_t nam
  */
 extern INET_ERROR InterfaceNameToId(const char *intfName, InterfaceId& intfId);
 
+/**
+ * @brief   Kinds of change to the system network interfaces reported to an
+ *      #InterfaceChangeHandler.
+ */
+enum InterfaceChangeType
+{
+    kInterfaceChange_InterfaceAdded     = 1,    /**< A network interface appeared. */
+    kInterfaceChange_InterfaceRemoved   = 2,    /**< A network interface disappeared, along with its addresses. */
+    kInterfaceChange_InterfaceChanged   = 3,    /**< The name or flags of a network interface changed. */
+    kInterfaceChange_AddressAdded       = 4,    /**< An IP address was assigned to a network interface. */
+    kInterfaceChange_AddressRemoved     = 5,    /**< An IP address was removed from a network interface. */
+    kInterfaceChange_Resynchronized     = 6     /**< The whole table was reloaded; any change may have occurred. */
+};
+
+/**
+ * @brief   Type of the handlers registered with
+ *      InetLayer::AddInterfaceChangeHandler().
+ *
+ * @param[in]   appState    the application state given at registration
+ * @param[in]   changeType  the kind of change
+ * @param[in]   intfId      the network interface concerned, or
+ *                          \c INET_NULL_INTERFACEID for
+ *                          \c kInterfaceChange_Resynchronized
+ * @param[in]   addr        the IP address concerned, or \c IPAddress::Any if
+ *                          the change is not about an address
+ *
+ * @details
+ *  Handlers are called on the InetLayer event loop, after the change has been
+ *  applied, so the interface iterators already reflect it.
+ */
+typedef void (*InterfaceChangeHandler)(void *appState, InterfaceChangeType changeType, InterfaceId intfId,
+    const IPAddress &addr);
+
 /**
  * @brief   Iterator for the list of system network interfaces.
  *
@@ -194,16 +229,7 @@ public:
      *  On LwIP, this method must be called with the LwIP stack lock
      *  acquired.
      */
-    bool HasCurrent(void) const
-    {
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
-        return (curIntf != NULL);
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
-
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-        return (curAddr != NULL);
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-    }
+    bool HasCurrent(void) const;
 
     /**
      * @brief   Extract the indicator of the network interface at the cursor.
@@ -237,6 +263,10 @@ private:
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     struct ifaddrs *addrsList;
     struct ifaddrs *curAddr;
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    const InterfaceCache *cache;    // Set when iterating the interface cache instead of addrsList.
+    size_t curCacheIndex;
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 };
 
@@ -300,16 +330,7 @@ public:
      *  On LwIP, this method must be called with the LwIP stack lock
      *  acquired.
      */
-    bool HasCurrent(void) const
-    {
-#if WEAVE_SYSTEM_CONFIG_USE_LWIP
-        return (curIntf != NULL);
-#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
-
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-        return (curAddr != NULL);
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
-    }
+    bool HasCurrent(void) const;
 
     /**
      * @brief   Extract the current interface IP address.
@@ -378,11 +399,25 @@ private:
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
     struct ifaddrs *addrsList;
     struct ifaddrs *curAddr;
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    const InterfaceCache *cache;    // Set when iterating the interface cache instead of addrsList.
+    size_t curCacheIndex;
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 };
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 
+inline bool InterfaceIterator::HasCurrent(void) const
+{
+    return (curIntf != NULL);
+}
+
+inline bool InterfaceAddressIterator::HasCurrent(void) const
+{
+    return (curIntf != NULL);
+}
+
 inline uint8_t InterfaceAddressIterator::GetIPv6PrefixLength(void)
 {
     return 64;
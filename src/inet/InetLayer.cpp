@@ -266,6 +266,15 @@ INET_ERROR InetLayer::Init(Weave::System::Layer& aSystemLayer, void *aContext)
 
     State = kState_Initialized;
 
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    // Without the cache, interface queries fall back to the system calls, so a failure is not fatal.
+    mInterfaceCache.Init();
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_DNS_CACHE_SIZE > 0
+    mDNSCache.Init();
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_DNS_CACHE_SIZE > 0
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 
@@ -273,6 +282,13 @@ INET_ERROR InetLayer::Init(Weave::System::Layer& aSystemLayer, void *aContext)
     SuccessOrExit(err);
 
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+    err = mDNSClientUDP.Init(this);
+    SuccessOrExit(err);
+
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
  exit:
@@ -305,6 +321,19 @@ INET_ERROR InetLayer::Shutdown(void)
     if (State == kState_Initialized)
     {
 #if INET_CONFIG_ENABLE_DNS_RESOLVER
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
+        // Cancel the requests waiting for another request first, so that canceling the
+        // latter doesn't issue their query again.
+        for (size_t i = 0; i < DNSResolver::sPool.Size(); i++)
+        {
+            DNSResolver* lResolver = DNSResolver::sPool.Get(*mSystemLayer, i);
+            if ((lResolver != NULL) && lResolver->IsCreatedByInetLayer(*this) && lResolver->mState == DNSResolver::kState_Waiting)
+            {
+                lResolver->Cancel();
+            }
+        }
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
+
         // Cancel all DNS resolution requests owned by this instance.
         for (size_t i = 0; i < DNSResolver::sPool.Size(); i++)
         {
@@ -315,6 +344,12 @@ INET_ERROR InetLayer::Shutdown(void)
             }
         }
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+        mDNSClientUDP.Shutdown();
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 
         err = mAsyncDNSResolver.Shutdown();
@@ -322,6 +357,10 @@ INET_ERROR InetLayer::Shutdown(void)
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER
 
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+        mInterfaceCache.Shutdown();
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
 #if INET_CONFIG_ENABLE_RAW_ENDPOINT
         // Close all raw endpoints owned by this Inet layer instance.
         for (size_t i = 0; i < RawEndPoint::sPool.Size(); i++)
@@ -474,6 +513,23 @@ INET_ERROR InetLayer::GetLinkLocalAddr(InterfaceId link, IPAddress *llAddr)
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    if (mInterfaceCache.IsValid())
+    {
+        for (size_t i = 0; i < mInterfaceCache.NumAddresses(); i++)
+        {
+            const InterfaceCache::Address &entry = mInterfaceCache.GetAddress(i);
+
+            if (entry.mAddr.IsIPv6LinkLocal() && ((link == INET_NULL_INTERFACEID) || (entry.mIntfId == link)))
+            {
+                (*llAddr) = entry.mAddr;
+                break;
+            }
+        }
+        goto out;
+    }
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
     struct ifaddrs *ifaddr;
     int rv;
     rv = getifaddrs(&ifaddr);
@@ -807,20 +863,60 @@ INET_ERROR InetLayer::ResolveHostAddress(const char *hostName, uint16_t hostName
         ExitNow(err = INET_NO_ERROR);
     }
 
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    {
+        uint8_t numAddrs;
+        INET_ERROR resolveErr;
+
+        if (mDNSCache.Lookup(hostName, hostNameLen, maxAddrs, addrArray, numAddrs, resolveErr))
+        {
+            if (onComplete)
+            {
+                onComplete(appState, resolveErr, numAddrs, addrArray);
+            }
+
+            resolver->Release();
+            resolver = NULL;
+
+            ExitNow(err = INET_NO_ERROR);
+        }
+    }
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+
     // After this point, the resolver will be released by:
     // - mAsyncDNSResolver (in case of ASYNC_DNS_SOCKETS)
+    // - mDNSClientUDP (in case of DNS_UDP_CLIENT)
+    // - the request it waits for (in case an identical request is in progress)
     // - resolver->Resolve() (in case of synchronous resolving)
     // - the event handlers (in case of LwIP)
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
 
-    err = mAsyncDNSResolver.PrepareDNSResolver(*resolver, hostName, hostNameLen, maxAddrs,
-                                               addrArray, onComplete, appState);
-    SuccessOrExit(err);
+    if (IsAsyncResolveAvailable())
+    {
+        DNSResolver *leader;
 
-    mAsyncDNSResolver.EnqueueRequest(*resolver);
+        resolver->InitAsyncResolve(hostName, hostNameLen, maxAddrs, addrArray, onComplete, appState);
 
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+        // Share the result of an identical request in progress rather than issuing another query.
+        leader = FindActiveResolver(*resolver);
+        if (leader != NULL)
+        {
+            resolver->mState = DNSResolver::kState_Waiting;
+            resolver->mLeader = leader;
+            ExitNow(err = INET_NO_ERROR);
+        }
+
+        err = StartAsyncResolve(*resolver);
+        if (err != INET_NO_ERROR)
+        {
+            resolver->Release();
+        }
+
+        ExitNow();
+    }
+
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
 
 #if !INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
     err = resolver->Resolve(hostName, hostNameLen, maxAddrs, addrArray, onComplete, appState);
@@ -830,6 +926,123 @@ exit:
     return err;
 }
 
+/**
+ *  Remove all host names from the DNS cache, so that subsequent calls to
+ *  ResolveHostAddress() issue new queries.
+ *
+ */
+void InetLayer::FlushDNSCache(void)
+{
+#if INET_CONFIG_DNS_CACHE_SIZE > 0
+    mDNSCache.Flush();
+#endif // INET_CONFIG_DNS_CACHE_SIZE > 0
+}
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+/**
+ *  Resolve host names by querying the specified name server over UDP, from
+ *  the Weave event loop, rather than with getaddrinfo().
+ *
+ *  @param[in]  serverAddr  The address of the name server, or IPAddress::Any
+ *                          to go back to getaddrinfo().
+ *
+ *  @param[in]  serverPort  The UDP port of the name server.
+ *
+ *  @retval #INET_NO_ERROR                   on success.
+ *  @retval #INET_ERROR_INCORRECT_STATE      if the InetLayer is not initialized.
+ *  @retval other errors returned by the UDPEndPoint used to send the queries.
+ *
+ */
+INET_ERROR InetLayer::SetDNSServer(const IPAddress &serverAddr, uint16_t serverPort)
+{
+    INET_ERROR err = INET_NO_ERROR;
+
+    VerifyOrExit(State == kState_Initialized, err = INET_ERROR_INCORRECT_STATE);
+
+    err = mDNSClientUDP.SetServer(serverAddr, serverPort);
+
+exit:
+    return err;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
+/**
+ *  Returns \c true if host names are resolved without blocking the Weave thread, either by the
+ *  UDP DNS client or by the asynchronous DNS thread pool.
+ */
+bool InetLayer::IsAsyncResolveAvailable(void) const
+{
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+    return true;
+#else // !INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+    return mDNSClientUDP.IsConfigured();
+#endif // !INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+}
+
+/**
+ *  Start the query of a DNSResolver object prepared with DNSResolver::InitAsyncResolve(), using
+ *  the UDP DNS client if a name server is configured and the asynchronous DNS thread pool otherwise.
+ */
+INET_ERROR InetLayer::StartAsyncResolve(DNSResolver &resolver)
+{
+    INET_ERROR err = INET_NO_ERROR;
+
+    VerifyOrExit(State == kState_Initialized, err = INET_ERROR_INCORRECT_STATE);
+
+    resolver.mState = DNSResolver::kState_Active;
+
+#if INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    if (mDNSClientUDP.IsConfigured())
+    {
+        ExitNow(err = mDNSClientUDP.EnqueueRequest(resolver));
+    }
+#endif // INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+    err = mAsyncDNSResolver.EnqueueRequest(resolver);
+#else // !INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+    err = INET_ERROR_INCORRECT_STATE;
+#endif // !INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+
+exit:
+    return err;
+}
+
+/**
+ *  Find the request in progress whose result the specified, newly prepared, DNSResolver object
+ *  can share.
+ *
+ *  @return The DNSResolver object performing the identical request, or NULL if there is none.
+ */
+DNSResolver *InetLayer::FindActiveResolver(const DNSResolver &resolver)
+{
+    DNSResolver *leader = NULL;
+
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+    // The worker threads update the state of the requests they resolve.
+    mAsyncDNSResolver.AsyncMutexLock();
+#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+
+    for (size_t i = 0; i < DNSResolver::sPool.Size(); i++)
+    {
+        DNSResolver* lResolver = DNSResolver::sPool.Get(*mSystemLayer, i);
+
+        if (lResolver != NULL && resolver.CanShareResultWith(*lResolver))
+        {
+            leader = lResolver;
+            break;
+        }
+    }
+
+#if INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+    mAsyncDNSResolver.AsyncMutexUnlock();
+#endif // INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+
+    return leader;
+}
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
+
 /**
  *  Cancel any outstanding DNS query (for a matching completion callback and
  *  application state) that may still be active.
@@ -875,12 +1088,12 @@ void InetLayer::CancelResolveHostAddress(DNSResolver::OnResolveCompleteFunct onC
             continue;
         }
 
-#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
         if (lResolver->mState == DNSResolver::kState_Canceled)
         {
             continue;
         }
-#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
 
         lResolver->Cancel();
         break;
@@ -1049,6 +1262,57 @@ bool InetLayer::MatchLocalIPv6Subnet(const IPAddress& addr)
     return false;
 }
 
+/**
+ *  Register a handler to be called whenever a network interface or an
+ *  interface address is added, removed or changed.
+ *
+ *  The handler may be told of an addition more than once, and must treat
+ *  #kInterfaceChange_Resynchronized as meaning that anything may have
+ *  changed.
+ *
+ *  @param[in]    handler   The function to call; see #InterfaceChangeHandler.
+ *
+ *  @param[in]    appState  An application state object passed back to the
+ *                          handler.
+ *
+ *  @retval #INET_NO_ERROR              On success, or if the handler was
+ *                                      already registered.
+ *  @retval #INET_ERROR_NO_MEMORY       If
+ *                                      #INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS
+ *                                      handlers are already registered.
+ *  @retval #INET_ERROR_NOT_IMPLEMENTED If interface changes are not tracked
+ *                                      on this platform, or the interface
+ *                                      cache could not be started.
+ *
+ */
+INET_ERROR InetLayer::AddInterfaceChangeHandler(InterfaceChangeHandler handler, void *appState)
+{
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    if (State != kState_Initialized)
+        return INET_ERROR_INCORRECT_STATE;
+
+    return mInterfaceCache.AddChangeHandler(handler, appState);
+#else // !INET_CONFIG_ENABLE_INTERFACE_CACHE
+    return INET_ERROR_NOT_IMPLEMENTED;
+#endif // !INET_CONFIG_ENABLE_INTERFACE_CACHE
+}
+
+/**
+ *  Unregister a handler registered with AddInterfaceChangeHandler().
+ *
+ *  @param[in]    handler   The function given at registration.
+ *
+ *  @param[in]    appState  The application state object given at
+ *                          registration.
+ *
+ */
+void InetLayer::RemoveInterfaceChangeHandler(InterfaceChangeHandler handler, void *appState)
+{
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    mInterfaceCache.RemoveChangeHandler(handler, appState);
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+}
+
 #if INET_CONFIG_ENABLE_TCP_ENDPOINT && INET_TCP_IDLE_CHECK_INTERVAL > 0
 void InetLayer::HandleTCPInactivityTimer(Weave::System::Layer* aSystemLayer, void* aAppState, Weave::System::Error aError)
 {
@@ -1353,6 +1617,10 @@ void InetLayer::PrepareSelect(int& nfds, fd_set *readfds, fd_set *writefds, fd_s
     }
 #endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
 
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    mInterfaceCache.PrepareSelect(nfds, readfds);
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
 #if INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
     if (mSystemLayer == &mImplicitSystemLayer)
     {
@@ -1487,6 +1755,12 @@ void InetLayer::HandleSelectResult(int selectRes, fd_set *readfds, fd_set *write
             }
         }
 #endif // INET_CONFIG_ENABLE_TUN_ENDPOINT
+
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+        // Apply interface changes last, so that the endpoints have consumed any traffic that
+        // predates them.
+        mInterfaceCache.HandleSelectResult(readfds);
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
     }
 
 #if INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
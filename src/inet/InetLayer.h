@@ -93,8 +93,19 @@
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 #include <InetLayer/AsyncDNSResolverSockets.h>
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+#include <InetLayer/DNSClientUDP.h>
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
+#if INET_CONFIG_ENABLE_DNS_RESOLVER
+#include <InetLayer/DNSCache.h>
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER
+
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+#include <InetLayer/InterfaceCache.h>
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
 #if INET_CONFIG_MAX_DROPPABLE_EVENTS
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
 #include <pthread.h>
@@ -186,6 +197,9 @@ class NL_DLL_EXPORT InetLayer
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
     friend class AsyncDNSResolverSockets;
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    friend class DNSClientUDP;
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
   public:
@@ -240,6 +254,11 @@ class NL_DLL_EXPORT InetLayer
     INET_ERROR ResolveHostAddress(const char *hostName, uint8_t maxAddrs, IPAddress *addrArray,
             DNSResolver::OnResolveCompleteFunct onComplete, void *appState);
     void CancelResolveHostAddress(DNSResolver::OnResolveCompleteFunct onComplete, void *appState);
+    void FlushDNSCache(void);
+
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    INET_ERROR SetDNSServer(const IPAddress &serverAddr, uint16_t serverPort = 53);
+#endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
 
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER
 
@@ -248,6 +267,9 @@ class NL_DLL_EXPORT InetLayer
     INET_ERROR GetLinkLocalAddr(InterfaceId link, IPAddress *llAddr);
     bool MatchLocalIPv6Subnet(const IPAddress& addr);
 
+    INET_ERROR AddInterfaceChangeHandler(InterfaceChangeHandler handler, void *appState);
+    void RemoveInterfaceChangeHandler(InterfaceChangeHandler handler, void *appState);
+
 #if INET_CONFIG_PROVIDE_OBSOLESCENT_INTERFACES
     /**
      *  @brief
@@ -355,11 +377,28 @@ private:
     void*                   mPlatformData;
     Weave::System::Layer*   mSystemLayer;
 
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_DNS_CACHE_SIZE > 0
+    DNSCache                mDNSCache;
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_DNS_CACHE_SIZE > 0
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
     AsyncDNSResolverSockets mAsyncDNSResolver;
 #endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS
 
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    DNSClientUDP mDNSClientUDP;
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    InterfaceCache mInterfaceCache;
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
+    bool IsAsyncResolveAvailable(void) const;
+    INET_ERROR StartAsyncResolve(DNSResolver &resolver);
+    DNSResolver *FindActiveResolver(const DNSResolver &resolver);
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && (INET_CONFIG_ENABLE_ASYNC_DNS_SOCKETS || INET_CONFIG_ENABLE_DNS_UDP_CLIENT)
 
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
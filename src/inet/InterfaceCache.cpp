@@ -0,0 +1,701 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements InterfaceCache, the object that keeps the
+ *      table of system network interfaces and addresses used by InetLayer
+ *      current from an rtnetlink socket.
+ *
+ */
+
+#include <InetLayer/InterfaceCache.h>
+#include <InetLayer/InetLayerBasis.h>
+
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/logging/WeaveLogging.h>
+
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+namespace nl {
+namespace Inet {
+
+enum
+{
+    // Large enough for any dump message: the kernel sizes dump messages to the receive buffer
+    // of the reader, starting from a page of at most 8 KiB.
+    kReceiveBufferSize      = 8192,
+
+    kDumpSeq_Links          = 1,
+    kDumpSeq_Addresses      = 2
+};
+
+InterfaceCache *InterfaceCache::sActive = NULL;
+
+/**
+ *  Open the notification socket and load the table.
+ *
+ *  The first cache to initialize successfully is the one consulted by the
+ *  interface iterators, GetInterfaceName() and InterfaceNameToId().
+ *
+ *  @retval #INET_NO_ERROR  The table is loaded and is being kept current.
+ *  @retval other           The rtnetlink socket could not be opened or
+ *                          read; the cache is not used.
+ */
+INET_ERROR InterfaceCache::Init(void)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    struct sockaddr_nl localAddr;
+    int res;
+
+    mSocket = INET_INVALID_SOCKET_FD;
+    mIsValid = false;
+    mResyncNeeded = false;
+    mEntriesRemoved = false;
+    mNumInterfaces = 0;
+    mNumAddresses = 0;
+
+    for (size_t i = 0; i < INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS; i++)
+    {
+        mChangeHandlers[i].mHandler = NULL;
+        mChangeHandlers[i].mAppState = NULL;
+    }
+
+    mSocket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK, NETLINK_ROUTE);
+    VerifyOrExit(mSocket >= 0, err = Weave::System::MapErrorPOSIX(errno));
+
+    // Subscribe before loading the table, so that no change made during the load is missed.
+    memset(&localAddr, 0, sizeof(localAddr));
+    localAddr.nl_family = AF_NETLINK;
+    localAddr.nl_groups = RTMGRP_LINK | RTMGRP_IPV6_IFADDR;
+#if INET_CONFIG_ENABLE_IPV4
+    localAddr.nl_groups |= RTMGRP_IPV4_IFADDR;
+#endif // INET_CONFIG_ENABLE_IPV4
+
+    res = bind(mSocket, reinterpret_cast<struct sockaddr *>(&localAddr), sizeof(localAddr));
+    VerifyOrExit(res == 0, err = Weave::System::MapErrorPOSIX(errno));
+
+    err = Reload(false);
+    SuccessOrExit(err);
+
+    if (sActive == NULL)
+        sActive = this;
+
+exit:
+    if (err != INET_NO_ERROR)
+    {
+        WeaveLogError(Inet, "Interface cache unavailable: %ld", static_cast<long>(err));
+        Shutdown();
+    }
+    return err;
+}
+
+/**
+ *  Close the notification socket and empty the table.
+ */
+void InterfaceCache::Shutdown(void)
+{
+    if (mSocket != INET_INVALID_SOCKET_FD)
+    {
+        close(mSocket);
+        mSocket = INET_INVALID_SOCKET_FD;
+    }
+
+    mIsValid = false;
+    mNumInterfaces = 0;
+    mNumAddresses = 0;
+
+    for (size_t i = 0; i < INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS; i++)
+        mChangeHandlers[i].mHandler = NULL;
+
+    if (sActive == this)
+        sActive = NULL;
+}
+
+/**
+ *  Register a handler to be called for every change applied to the table.
+ *
+ *  @retval #INET_NO_ERROR              The handler is registered, or was
+ *                                      already.
+ *  @retval #INET_ERROR_BAD_ARGS        The handler is NULL.
+ *  @retval #INET_ERROR_NO_MEMORY       All the handler slots are in use.
+ *  @retval #INET_ERROR_NOT_IMPLEMENTED The cache failed to start.
+ */
+INET_ERROR InterfaceCache::AddChangeHandler(InterfaceChangeHandler handler, void *appState)
+{
+    ChangeHandlerEntry *freeEntry = NULL;
+
+    if (handler == NULL)
+        return INET_ERROR_BAD_ARGS;
+
+    if (mSocket == INET_INVALID_SOCKET_FD)
+        return INET_ERROR_NOT_IMPLEMENTED;
+
+    for (size_t i = 0; i < INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS; i++)
+    {
+        ChangeHandlerEntry &entry = mChangeHandlers[i];
+
+        if (entry.mHandler == handler && entry.mAppState == appState)
+            return INET_NO_ERROR;
+        if (entry.mHandler == NULL && freeEntry == NULL)
+            freeEntry = &entry;
+    }
+
+    if (freeEntry == NULL)
+        return INET_ERROR_NO_MEMORY;
+
+    freeEntry->mHandler = handler;
+    freeEntry->mAppState = appState;
+
+    return INET_NO_ERROR;
+}
+
+/**
+ *  Unregister a handler registered with AddChangeHandler().
+ */
+void InterfaceCache::RemoveChangeHandler(InterfaceChangeHandler handler, void *appState)
+{
+    for (size_t i = 0; i < INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS; i++)
+    {
+        ChangeHandlerEntry &entry = mChangeHandlers[i];
+
+        if (entry.mHandler == handler && entry.mAppState == appState)
+            entry.mHandler = NULL;
+    }
+}
+
+/**
+ *  Look up an interface by index.
+ *
+ *  @return The interface, or NULL if it is not in the table.
+ */
+const InterfaceCache::Interface *InterfaceCache::FindInterface(InterfaceId intfId) const
+{
+    for (size_t i = 0; i < mNumInterfaces; i++)
+        if (mInterfaces[i].mId == intfId)
+            return &mInterfaces[i];
+
+    return NULL;
+}
+
+/**
+ *  Look up an interface by name.
+ *
+ *  @return The interface, or NULL if it is not in the table.
+ */
+const InterfaceCache::Interface *InterfaceCache::FindInterface(const char *intfName) const
+{
+    for (size_t i = 0; i < mNumInterfaces; i++)
+        if (strncmp(mInterfaces[i].mName, intfName, sizeof(mInterfaces[i].mName)) == 0)
+            return &mInterfaces[i];
+
+    return NULL;
+}
+
+/**
+ *  Add the notification socket to the set of file descriptors to watch for
+ *  reading.
+ */
+void InterfaceCache::PrepareSelect(int &nfds, fd_set *readfds)
+{
+    if (mSocket != INET_INVALID_SOCKET_FD)
+    {
+        FD_SET(mSocket, readfds);
+        if (mSocket + 1 > nfds)
+            nfds = mSocket + 1;
+    }
+}
+
+/**
+ *  Apply the notifications pending on the notification socket to the table,
+ *  and call the change handlers for each change.
+ *
+ *  Changes are reported even when the table is too small to hold them. If
+ *  notifications were lost, the table is reloaded and the handlers are told
+ *  so with #kInterfaceChange_Resynchronized.
+ */
+void InterfaceCache::HandleSelectResult(fd_set *readfds)
+{
+    uint32_t buf[kReceiveBufferSize / sizeof(uint32_t)];
+    bool lostChanges = false;
+
+    if (mSocket == INET_INVALID_SOCKET_FD || !FD_ISSET(mSocket, readfds))
+        return;
+
+    while (true)
+    {
+        struct sockaddr_nl srcAddr;
+        socklen_t srcAddrLen = sizeof(srcAddr);
+        ssize_t rcvLen;
+
+        rcvLen = recvfrom(mSocket, buf, sizeof(buf), MSG_DONTWAIT, reinterpret_cast<struct sockaddr *>(&srcAddr), &srcAddrLen);
+        if (rcvLen < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            if (errno == ENOBUFS)
+            {
+                lostChanges = true;
+                continue;
+            }
+            break;
+        }
+
+        // Only the kernel may report changes.
+        if (srcAddr.nl_pid != 0)
+            continue;
+
+        // Once changes have been lost, the remaining notifications are superseded by the reload.
+        if (lostChanges)
+            continue;
+
+        size_t remainingLen = static_cast<size_t>(rcvLen);
+        for (const struct nlmsghdr *msg = reinterpret_cast<const struct nlmsghdr *>(buf); NLMSG_OK(msg, remainingLen);
+             msg = NLMSG_NEXT(msg, remainingLen))
+        {
+            ProcessMessage(msg, true);
+        }
+    }
+
+    FinishNotifications(lostChanges);
+}
+
+/**
+ *  Get the cache consulted by the interface iterators, GetInterfaceName()
+ *  and InterfaceNameToId().
+ *
+ *  @return The cache, or NULL if there is no cache or its table is not
+ *          currently valid, in which case the system must be queried.
+ */
+const InterfaceCache *InterfaceCache::GetActive(void)
+{
+    return (sActive != NULL && sActive->mIsValid) ? sActive : NULL;
+}
+
+/**
+ *  Reload the table after a batch of notifications, if they were not all
+ *  applied.
+ *
+ *  If notifications were lost, or the previous reload failed, the handlers
+ *  are told to resynchronize. Otherwise, if the table overflowed and
+ *  something has since been removed, the table is reloaded in case the
+ *  system fits again; the differences are reported as individual changes.
+ */
+void InterfaceCache::FinishNotifications(bool lostChanges)
+{
+    if (lostChanges || mResyncNeeded)
+    {
+        WeaveLogProgress(Inet, "Reloading interface cache");
+
+        Reload(false);
+
+        NotifyChange(kInterfaceChange_Resynchronized, INET_NULL_INTERFACEID, IPAddress::Any);
+    }
+    else if (!mIsValid && mEntriesRemoved)
+    {
+        Reload(true);
+
+        if (mIsValid)
+            WeaveLogProgress(Inet, "Interface cache complete again");
+    }
+}
+
+INET_ERROR InterfaceCache::Reload(bool notify)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    Interface oldIntfs[INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES];
+    Address oldAddrs[INET_CONFIG_INTERFACE_CACHE_MAX_ADDRESSES];
+    size_t numOldIntfs = 0;
+    size_t numOldAddrs = 0;
+    int dumpSocket;
+
+    if (notify)
+    {
+        numOldIntfs = mNumInterfaces;
+        numOldAddrs = mNumAddresses;
+        for (size_t i = 0; i < numOldIntfs; i++)
+            oldIntfs[i] = mInterfaces[i];
+        for (size_t i = 0; i < numOldAddrs; i++)
+            oldAddrs[i] = mAddresses[i];
+    }
+
+    mNumInterfaces = 0;
+    mNumAddresses = 0;
+    mIsValid = true;
+    mResyncNeeded = false;
+    mEntriesRemoved = false;
+
+    // The dumps are requested on a separate socket, so their replies don't interleave with the
+    // notifications.
+    dumpSocket = socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    VerifyOrExit(dumpSocket >= 0, err = Weave::System::MapErrorPOSIX(errno));
+
+    err = Dump(dumpSocket, RTM_GETLINK, kDumpSeq_Links);
+    SuccessOrExit(err);
+
+    err = Dump(dumpSocket, RTM_GETADDR, kDumpSeq_Addresses);
+    SuccessOrExit(err);
+
+exit:
+    if (dumpSocket >= 0)
+        close(dumpSocket);
+    if (err != INET_NO_ERROR)
+    {
+        mIsValid = false;
+        mResyncNeeded = true;
+    }
+    else if (notify)
+        NotifyDifferences(oldIntfs, numOldIntfs, oldAddrs, numOldAddrs);
+    return err;
+}
+
+INET_ERROR InterfaceCache::Dump(int dumpSocket, uint16_t msgType, uint32_t seq)
+{
+    INET_ERROR err = INET_NO_ERROR;
+    uint32_t buf[kReceiveBufferSize / sizeof(uint32_t)];
+    struct
+    {
+        struct nlmsghdr hdr;
+        struct rtgenmsg gen;
+    } req;
+    ssize_t res;
+
+    memset(&req, 0, sizeof(req));
+    req.hdr.nlmsg_len = NLMSG_LENGTH(sizeof(req.gen));
+    req.hdr.nlmsg_type = msgType;
+    req.hdr.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    req.hdr.nlmsg_seq = seq;
+    req.gen.rtgen_family = AF_UNSPEC;
+
+    res = send(dumpSocket, &req, req.hdr.nlmsg_len, 0);
+    VerifyOrExit(res >= 0, err = Weave::System::MapErrorPOSIX(errno));
+
+    while (true)
+    {
+        res = recv(dumpSocket, buf, sizeof(buf), 0);
+        if (res < 0 && errno == EINTR)
+            continue;
+        VerifyOrExit(res >= 0, err = Weave::System::MapErrorPOSIX(errno));
+
+        size_t remainingLen = static_cast<size_t>(res);
+        for (const struct nlmsghdr *msg = reinterpret_cast<const struct nlmsghdr *>(buf); NLMSG_OK(msg, remainingLen);
+             msg = NLMSG_NEXT(msg, remainingLen))
+        {
+            if (msg->nlmsg_seq != seq)
+                continue;
+
+            if (msg->nlmsg_type == NLMSG_DONE)
+                ExitNow();
+
+            if (msg->nlmsg_type == NLMSG_ERROR)
+            {
+                const struct nlmsgerr *nlErr = reinterpret_cast<const struct nlmsgerr *>(NLMSG_DATA(msg));
+                ExitNow(err = (nlErr->error != 0) ? Weave::System::MapErrorPOSIX(-nlErr->error) : INET_ERROR_UNEXPECTED_EVENT);
+            }
+
+            ProcessMessage(msg, false);
+        }
+    }
+
+exit:
+    return err;
+}
+
+void InterfaceCache::ProcessMessage(const struct nlmsghdr *msg, bool notify)
+{
+    switch (msg->nlmsg_type)
+    {
+    case RTM_NEWLINK:
+    case RTM_DELLINK:
+        ProcessLinkMessage(msg, notify);
+        break;
+
+    case RTM_NEWADDR:
+    case RTM_DELADDR:
+        ProcessAddressMessage(msg, notify);
+        break;
+
+    default:
+        break;
+    }
+}
+
+void InterfaceCache::ProcessLinkMessage(const struct nlmsghdr *msg, bool notify)
+{
+    const struct ifinfomsg *ifi = reinterpret_cast<const struct ifinfomsg *>(NLMSG_DATA(msg));
+    const char *name = NULL;
+    size_t nameLen = 0;
+    size_t index;
+
+    if (msg->nlmsg_len < NLMSG_LENGTH(sizeof(*ifi)))
+        return;
+
+    for (index = 0; index < mNumInterfaces; index++)
+        if (mInterfaces[index].mId == static_cast<InterfaceId>(ifi->ifi_index))
+            break;
+
+    if (msg->nlmsg_type == RTM_DELLINK)
+    {
+        InterfaceId intfId = ifi->ifi_index;
+
+        // An interface missing from a complete table was never reported.
+        if (index == mNumInterfaces && mIsValid)
+            return;
+
+        for (size_t i = mNumAddresses; i > 0; i--)
+            if (mAddresses[i - 1].mIntfId == intfId)
+                RemoveAddress(i - 1, notify);
+
+        if (index < mNumInterfaces)
+            for (mNumInterfaces--; index < mNumInterfaces; index++)
+                mInterfaces[index] = mInterfaces[index + 1];
+
+        mEntriesRemoved = true;
+
+        if (notify)
+            NotifyChange(kInterfaceChange_InterfaceRemoved, intfId, IPAddress::Any);
+        return;
+    }
+
+    int attrsLen = static_cast<int>(msg->nlmsg_len - NLMSG_LENGTH(sizeof(*ifi)));
+    for (const struct rtattr *attr = reinterpret_cast<const struct rtattr *>(reinterpret_cast<const uint8_t *>(ifi) + NLMSG_ALIGN(sizeof(*ifi)));
+         RTA_OK(attr, attrsLen); attr = RTA_NEXT(attr, attrsLen))
+    {
+        if (attr->rta_type == IFLA_IFNAME)
+        {
+            name = reinterpret_cast<const char *>(RTA_DATA(attr));
+            nameLen = strnlen(name, RTA_PAYLOAD(attr));
+        }
+    }
+
+    if (name == NULL)
+        return;
+    if (nameLen >= IF_NAMESIZE)
+        nameLen = IF_NAMESIZE - 1;
+
+    if (index == mNumInterfaces)
+    {
+        if (mNumInterfaces == INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES)
+        {
+            // Without the interface in the table, a change can't be told from a new interface once
+            // the table is incomplete; report it as a change, which handlers must take to mean
+            // anything about it may be different.
+            InterfaceChangeType changeType = mIsValid ? kInterfaceChange_InterfaceAdded : kInterfaceChange_InterfaceChanged;
+
+            mIsValid = false;
+
+            if (notify)
+                NotifyChange(changeType, ifi->ifi_index, IPAddress::Any);
+            return;
+        }
+
+        Interface &intf = mInterfaces[mNumInterfaces++];
+        intf.mId = ifi->ifi_index;
+        intf.mFlags = ifi->ifi_flags;
+        memcpy(intf.mName, name, nameLen);
+        intf.mName[nameLen] = '\0';
+
+        if (notify)
+            NotifyChange(kInterfaceChange_InterfaceAdded, intf.mId, IPAddress::Any);
+    }
+    else
+    {
+        Interface &intf = mInterfaces[index];
+
+        // Link notifications are frequent, e.g. for every wireless event; only report the ones that
+        // change what the cache exposes.
+        if (intf.mFlags == ifi->ifi_flags && strncmp(intf.mName, name, nameLen) == 0 && intf.mName[nameLen] == '\0')
+            return;
+
+        intf.mFlags = ifi->ifi_flags;
+        memcpy(intf.mName, name, nameLen);
+        intf.mName[nameLen] = '\0';
+
+        if (notify)
+            NotifyChange(kInterfaceChange_InterfaceChanged, intf.mId, IPAddress::Any);
+    }
+}
+
+void InterfaceCache::ProcessAddressMessage(const struct nlmsghdr *msg, bool notify)
+{
+    const struct ifaddrmsg *ifa = reinterpret_cast<const struct ifaddrmsg *>(NLMSG_DATA(msg));
+    const struct rtattr *addrAttr = NULL;
+    IPAddress addr;
+    size_t index;
+
+    if (msg->nlmsg_len < NLMSG_LENGTH(sizeof(*ifa)))
+        return;
+
+    // Like getifaddrs(), prefer the local address to the peer address of point-to-point links.
+    int attrsLen = static_cast<int>(msg->nlmsg_len - NLMSG_LENGTH(sizeof(*ifa)));
+    for (const struct rtattr *attr = reinterpret_cast<const struct rtattr *>(reinterpret_cast<const uint8_t *>(ifa) + NLMSG_ALIGN(sizeof(*ifa)));
+         RTA_OK(attr, attrsLen); attr = RTA_NEXT(attr, attrsLen))
+    {
+        if (attr->rta_type == IFA_LOCAL || (attr->rta_type == IFA_ADDRESS && addrAttr == NULL))
+            addrAttr = attr;
+    }
+
+    if (addrAttr == NULL)
+        return;
+
+    if (ifa->ifa_family == AF_INET6 && RTA_PAYLOAD(addrAttr) >= sizeof(struct in6_addr))
+    {
+        struct in6_addr ipv6Addr;
+        memcpy(&ipv6Addr, RTA_DATA(addrAttr), sizeof(ipv6Addr));
+        addr = IPAddress::FromIPv6(ipv6Addr);
+    }
+#if INET_CONFIG_ENABLE_IPV4
+    else if (ifa->ifa_family == AF_INET && RTA_PAYLOAD(addrAttr) >= sizeof(struct in_addr))
+    {
+        struct in_addr ipv4Addr;
+        memcpy(&ipv4Addr, RTA_DATA(addrAttr), sizeof(ipv4Addr));
+        addr = IPAddress::FromIPv4(ipv4Addr);
+    }
+#endif // INET_CONFIG_ENABLE_IPV4
+    else
+        return;
+
+    for (index = 0; index < mNumAddresses; index++)
+        if (mAddresses[index].mIntfId == ifa->ifa_index && mAddresses[index].mAddr == addr)
+            break;
+
+    if (msg->nlmsg_type == RTM_DELADDR)
+    {
+        if (index < mNumAddresses)
+            RemoveAddress(index, notify);
+        else if (!mIsValid)
+        {
+            // The address may have been left out of the table when it was full.
+            mEntriesRemoved = true;
+
+            if (notify)
+                NotifyChange(kInterfaceChange_AddressRemoved, ifa->ifa_index, addr);
+        }
+        return;
+    }
+
+    // IPv6 addresses are announced again whenever their lifetimes are refreshed.
+    if (index < mNumAddresses)
+    {
+        mAddresses[index].mPrefixLength = ifa->ifa_prefixlen;
+        return;
+    }
+
+    if (mNumAddresses == INET_CONFIG_INTERFACE_CACHE_MAX_ADDRESSES)
+    {
+        // Report the address even though the table can't hold it. Once the table is incomplete,
+        // an address left out of it is reported again whenever it is announced again.
+        mIsValid = false;
+
+        if (notify)
+            NotifyChange(kInterfaceChange_AddressAdded, ifa->ifa_index, addr);
+        return;
+    }
+
+    Address &entry = mAddresses[mNumAddresses++];
+    entry.mAddr = addr;
+    entry.mIntfId = ifa->ifa_index;
+    entry.mPrefixLength = ifa->ifa_prefixlen;
+
+    if (notify)
+        NotifyChange(kInterfaceChange_AddressAdded, entry.mIntfId, entry.mAddr);
+}
+
+void InterfaceCache::RemoveAddress(size_t index, bool notify)
+{
+    IPAddress addr = mAddresses[index].mAddr;
+    InterfaceId intfId = mAddresses[index].mIntfId;
+
+    for (mNumAddresses--; index < mNumAddresses; index++)
+        mAddresses[index] = mAddresses[index + 1];
+
+    mEntriesRemoved = true;
+
+    if (notify)
+        NotifyChange(kInterfaceChange_AddressRemoved, intfId, addr);
+}
+
+// Report the differences between the table before and after a reload. The reload may have picked up
+// changes whose notifications are still pending, and would then go unreported; this reports them.
+// An entry missing from the old table may already have been reported, while the table was incomplete;
+// handlers are expected to cope with being told twice. Removals are only reported once the new table
+// is complete, as an entry missing from an incomplete table may still exist.
+void InterfaceCache::NotifyDifferences(const Interface *oldIntfs, size_t numOldIntfs, const Address *oldAddrs,
+    size_t numOldAddrs)
+{
+    size_t i, j;
+
+    if (mIsValid)
+    {
+        for (i = 0; i < numOldAddrs; i++)
+        {
+            for (j = 0; j < mNumAddresses; j++)
+                if (mAddresses[j].mIntfId == oldAddrs[i].mIntfId && mAddresses[j].mAddr == oldAddrs[i].mAddr)
+                    break;
+            if (j == mNumAddresses)
+                NotifyChange(kInterfaceChange_AddressRemoved, oldAddrs[i].mIntfId, oldAddrs[i].mAddr);
+        }
+
+        for (i = 0; i < numOldIntfs; i++)
+            if (FindInterface(oldIntfs[i].mId) == NULL)
+                NotifyChange(kInterfaceChange_InterfaceRemoved, oldIntfs[i].mId, IPAddress::Any);
+    }
+
+    for (i = 0; i < mNumInterfaces; i++)
+    {
+        for (j = 0; j < numOldIntfs; j++)
+            if (oldIntfs[j].mId == mInterfaces[i].mId)
+                break;
+        if (j == numOldIntfs)
+            NotifyChange(kInterfaceChange_InterfaceAdded, mInterfaces[i].mId, IPAddress::Any);
+        else if (oldIntfs[j].mFlags != mInterfaces[i].mFlags || strcmp(oldIntfs[j].mName, mInterfaces[i].mName) != 0)
+            NotifyChange(kInterfaceChange_InterfaceChanged, mInterfaces[i].mId, IPAddress::Any);
+    }
+
+    for (i = 0; i < mNumAddresses; i++)
+    {
+        for (j = 0; j < numOldAddrs; j++)
+            if (oldAddrs[j].mIntfId == mAddresses[i].mIntfId && oldAddrs[j].mAddr == mAddresses[i].mAddr)
+                break;
+        if (j == numOldAddrs)
+            NotifyChange(kInterfaceChange_AddressAdded, mAddresses[i].mIntfId, mAddresses[i].mAddr);
+    }
+}
+
+void InterfaceCache::NotifyChange(InterfaceChangeType changeType, InterfaceId intfId, const IPAddress &addr)
+{
+    for (size_t i = 0; i < INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS; i++)
+    {
+        ChangeHandlerEntry &entry = mChangeHandlers[i];
+
+        if (entry.mHandler != NULL)
+            entry.mHandler(entry.mAppState, changeType, intfId, addr);
+    }
+}
+
+} // namespace Inet
+} // namespace nl
+
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
@@ -0,0 +1,164 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines InterfaceCache, the object that keeps the table
+ *      of system network interfaces and addresses used by InetLayer
+ *      current from an rtnetlink socket.
+ *
+ */
+
+#ifndef INTERFACECACHE_H
+#define INTERFACECACHE_H
+
+#include <InetLayer/IPAddress.h>
+#include <InetLayer/InetError.h>
+#include <InetLayer/InetInterface.h>
+
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+#include <net/if.h>
+#include <sys/select.h>
+
+struct nlmsghdr;
+
+namespace nl {
+namespace Inet {
+
+/**
+ *  @class InterfaceCache
+ *
+ *  @brief
+ *    This is an internal class to InetLayer that holds the system network
+ *    interfaces and their IP addresses. The table is loaded once, with an
+ *    rtnetlink dump, and then kept current from the link and address
+ *    notifications of an rtnetlink socket serviced by the InetLayer event
+ *    loop. There is no public interface available for the application
+ *    layer, other than the interface iterators, GetInterfaceName(),
+ *    InterfaceNameToId() and InetLayer::AddInterfaceChangeHandler().
+ *
+ *    If the system has more interfaces or addresses than the table can
+ *    hold, the cache stops answering queries, but changes keep being
+ *    reported one by one; the table is reloaded once an interface or
+ *    address is removed, in case the system fits again. Only if
+ *    notifications are lost because the socket overflowed is the table
+ *    reloaded and the handlers told to resynchronize.
+ *
+ */
+class InterfaceCache
+{
+    friend class InterfaceCacheTestObject;
+
+public:
+    struct Interface
+    {
+        InterfaceId mId;                    /**< Interface index. */
+        unsigned int mFlags;                /**< IFF_* flags of the interface. */
+        char mName[IF_NAMESIZE];
+    };
+
+    struct Address
+    {
+        IPAddress mAddr;
+        InterfaceId mIntfId;                /**< Index of the interface the address is assigned to. */
+        uint8_t mPrefixLength;
+    };
+
+    INET_ERROR Init(void);
+    void Shutdown(void);
+
+    bool IsValid(void) const;
+
+    INET_ERROR AddChangeHandler(InterfaceChangeHandler handler, void *appState);
+    void RemoveChangeHandler(InterfaceChangeHandler handler, void *appState);
+
+    size_t NumInterfaces(void) const;
+    const Interface &GetInterface(size_t index) const;
+    const Interface *FindInterface(InterfaceId intfId) const;
+    const Interface *FindInterface(const char *intfName) const;
+
+    size_t NumAddresses(void) const;
+    const Address &GetAddress(size_t index) const;
+
+    void PrepareSelect(int &nfds, fd_set *readfds);
+    void HandleSelectResult(fd_set *readfds);
+
+    static const InterfaceCache *GetActive(void);
+
+private:
+    struct ChangeHandlerEntry
+    {
+        InterfaceChangeHandler mHandler;
+        void *mAppState;
+    };
+
+    int mSocket;                            /**< Socket subscribed to link and address notifications. */
+    bool mIsValid;                          /**< True if the table holds every interface and address. */
+    bool mResyncNeeded;                     /**< True if the last reload failed. */
+    bool mEntriesRemoved;                   /**< True if an interface or address was removed since the last reload. */
+    size_t mNumInterfaces;
+    size_t mNumAddresses;
+    Interface mInterfaces[INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES];
+    Address mAddresses[INET_CONFIG_INTERFACE_CACHE_MAX_ADDRESSES];
+    ChangeHandlerEntry mChangeHandlers[INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS];
+
+    static InterfaceCache *sActive;
+
+    void FinishNotifications(bool lostChanges);
+    INET_ERROR Reload(bool notify);
+    INET_ERROR Dump(int dumpSocket, uint16_t msgType, uint32_t seq);
+    void ProcessMessage(const struct nlmsghdr *msg, bool notify);
+    void ProcessLinkMessage(const struct nlmsghdr *msg, bool notify);
+    void ProcessAddressMessage(const struct nlmsghdr *msg, bool notify);
+    void RemoveAddress(size_t index, bool notify);
+    void NotifyDifferences(const Interface *oldIntfs, size_t numOldIntfs, const Address *oldAddrs, size_t numOldAddrs);
+    void NotifyChange(InterfaceChangeType changeType, InterfaceId intfId, const IPAddress &addr);
+};
+
+inline bool InterfaceCache::IsValid(void) const
+{
+    return mIsValid;
+}
+
+inline size_t InterfaceCache::NumInterfaces(void) const
+{
+    return mNumInterfaces;
+}
+
+inline const InterfaceCache::Interface &InterfaceCache::GetInterface(size_t index) const
+{
+    return mInterfaces[index];
+}
+
+inline size_t InterfaceCache::NumAddresses(void) const
+{
+    return mNumAddresses;
+}
+
+inline const InterfaceCache::Address &InterfaceCache::GetAddress(size_t index) const
+{
+    return mAddresses[index];
+}
+
+} // namespace Inet
+} // namespace nl
+
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+#endif // !defined(INTERFACECACHE_H)
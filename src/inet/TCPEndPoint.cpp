@@ -52,6 +52,7 @@
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 #include <sys/socket.h>
 #include <sys/select.h>
+#include <sys/uio.h>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -692,6 +693,17 @@ INET_ERROR TCPEndPoint::Send(PacketBuffer *data, bool push)
     return res;
 }
 
+INET_ERROR TCPEndPoint::PushSendQueue()
+{
+    if (State != kState_Connected && State != kState_ReceiveShutdown)
+        return INET_ERROR_INCORRECT_STATE;
+
+    if (mSendQueue == NULL)
+        return INET_NO_ERROR;
+
+    return DriveSending();
+}
+
 void TCPEndPoint::DisableReceive()
 {
     ReceiveEnabled = false;
@@ -1019,10 +1031,13 @@ INET_ERROR TCPEndPoint::PutBackReceivedData(PacketBuffer *data)
 
 uint32_t TCPEndPoint::PendingSendLength()
 {
-    if (mSendQueue != NULL)
-        return mSendQueue->TotalLength();
-    else
-        return 0;
+    uint32_t len = 0;
+
+    // Sum the buffers individually; the queue may hold more than a single buffer chain's worth of data.
+    for (PacketBuffer *buf = mSendQueue; buf != NULL; buf = buf->Next())
+        len += buf->DataLength();
+
+    return len;
 }
 
 uint32_t TCPEndPoint::PendingReceiveLength()
@@ -1259,9 +1274,31 @@ INET_ERROR TCPEndPoint::DriveSending()
 
     while (mSendQueue != NULL)
     {
-        uint16_t bufLen = mSendQueue->DataLength();
+        struct iovec sendIOV[INET_CONFIG_TCP_SEND_MAX_IOVECS];
+        struct msghdr sendMsgHdr;
+        int iovCount = 0;
+        uint16_t sendLen = 0;
 
-        ssize_t lenSent = send(mSocket, mSendQueue->Start(), (size_t) bufLen, sendFlags);
+        // Gather as many queued buffers as possible into a single send call, limiting the total length such
+        // that it can be reported through the OnDataSent callback.
+        for (PacketBuffer *buf = mSendQueue; buf != NULL && iovCount < INET_CONFIG_TCP_SEND_MAX_IOVECS; buf = buf->Next())
+        {
+            uint16_t bufLen = buf->DataLength();
+
+            if (iovCount > 0 && bufLen > UINT16_MAX - sendLen)
+                break;
+
+            sendIOV[iovCount].iov_base = buf->Start();
+            sendIOV[iovCount].iov_len = bufLen;
+            sendLen += bufLen;
+            iovCount++;
+        }
+
+        memset(&sendMsgHdr, 0, sizeof(sendMsgHdr));
+        sendMsgHdr.msg_iov = sendIOV;
+        sendMsgHdr.msg_iovlen = iovCount;
+
+        ssize_t lenSent = sendmsg(mSocket, &sendMsgHdr, sendFlags);
 
         if (lenSent == -1)
         {
@@ -1273,10 +1310,20 @@ INET_ERROR TCPEndPoint::DriveSending()
         // Mark the connection as being active.
         MarkActive();
 
-        if (lenSent < bufLen)
-            mSendQueue->ConsumeHead(lenSent);
-        else
+        // Release the buffers that were sent in their entirety and advance past the data sent from the last one.
+        for (uint16_t lenRemaining = (uint16_t) lenSent; iovCount > 0; iovCount--)
+        {
+            uint16_t bufLen = mSendQueue->DataLength();
+
+            if (lenRemaining < bufLen)
+            {
+                mSendQueue->ConsumeHead(lenRemaining);
+                break;
+            }
+
+            lenRemaining -= bufLen;
             mSendQueue = PacketBuffer::FreeHead(mSendQueue);
+        }
 
         if (OnDataSent != NULL)
             OnDataSent(this, (uint16_t) lenSent);
@@ -1306,7 +1353,7 @@ INET_ERROR TCPEndPoint::DriveSending()
         }
 #endif // INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
 
-        if (lenSent < bufLen)
+        if (lenSent < sendLen)
             break;
     }
 
@@ -2130,7 +2177,11 @@ void TCPEndPoint::ReceiveData()
         else
         {
             isNewBuf = false;
-            rcvBuf->CompactHead();
+
+            // Reclaim the space ahead of the unconsumed data only once it outweighs the space remaining
+            // after it, rather than moving the data on every read.
+            if (rcvBuf->ReservedSize() > rcvBuf->AvailableDataLength())
+                rcvBuf->CompactHead();
         }
     }
 
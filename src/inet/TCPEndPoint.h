@@ -199,6 +199,19 @@ public:
      */
     INET_ERROR Send(Weave::System::PacketBuffer *data, bool push = true);
 
+    /**
+     * @brief   Send any message text previously queued on the TCP connection.
+     *
+     * @retval  INET_NO_ERROR           success: queued data handed to the transport.
+     * @retval  INET_ERROR_INCORRECT_STATE  TCP connection not established.
+     *
+     * @details
+     *  Completes a sequence of <tt>Send(data, false)</tt> calls, allowing
+     *  several messages to be transmitted together rather than one at a
+     *  time.
+     */
+    INET_ERROR PushSendQueue(void);
+
     /**
      * @brief   Disable reception.
      *
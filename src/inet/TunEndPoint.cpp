@@ -61,6 +61,8 @@ using namespace nl::Weave::Encoding;
 void TunEndPoint::Init(InetLayer *inetLayer)
 {
     InitEndPointBasis(*inetLayer);
+
+    OnReceiveBatchComplete = NULL;
 }
 
 /**
@@ -455,24 +457,40 @@ exit:
 #endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
 
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS
+enum
+{
+    kMaxBuffersPerPacket = 8    // Maximum number of chained buffers holding a single outbound IPv6 packet.
+};
+
 /* Function for sending the IPv6 packets over Linux sockets */
 INET_ERROR TunEndPoint::TunDevSendMessage(PacketBuffer *msg)
 {
     INET_ERROR ret = INET_NO_ERROR;
     ssize_t lenSent = 0;
-    uint8_t *p = NULL;
+    struct iovec msgIOV[kMaxBuffersPerPacket];
+    int iovCount = 0;
 
     // no packet could be read, silently ignore this
     VerifyOrExit(msg != NULL, ret = INET_ERROR_BAD_ARGS);
 
-    p = msg->Start();
+    // A packet may span a chain of buffers; hand the whole chain to the
+    // tun device with a single gathering write, avoiding a compaction copy.
+    // Each write to the tun device delivers exactly one packet.
+    for (PacketBuffer *buf = msg; buf != NULL; buf = buf->Next())
+    {
+        VerifyOrExit(iovCount < kMaxBuffersPerPacket, ret = INET_ERROR_OUTBOUND_MESSAGE_TRUNCATED);
+
+        msgIOV[iovCount].iov_base = buf->Start();
+        msgIOV[iovCount].iov_len = buf->DataLength();
+        iovCount++;
+    }
 
-    lenSent = write(mSocket, p, msg->DataLength());
+    lenSent = writev(mSocket, msgIOV, iovCount);
     if (lenSent < 0)
     {
        ExitNow(ret = Weave::System::MapErrorPOSIX(errno));
     }
-    else if (lenSent < msg->DataLength())
+    else if (lenSent < msg->TotalLength())
     {
         ExitNow(ret = INET_ERROR_OUTBOUND_MESSAGE_TRUNCATED);
     }
@@ -528,6 +546,12 @@ void TunEndPoint::HandleDataReceived (PacketBuffer *msg)
         if (err == INET_NO_ERROR)
         {
             OnPacketReceived(this, msg);
+
+            // Packets are posted from LwIP one at a time, so each one forms a batch of its own.
+            if (mState == kState_Open && OnReceiveBatchComplete != NULL)
+            {
+                OnReceiveBatchComplete(this);
+            }
         }
         else
         {
@@ -665,7 +689,12 @@ INET_ERROR TunEndPoint::TunDevOpen (const char *intfName)
     int fd = INET_INVALID_SOCKET_FD;
     INET_ERROR ret = INET_NO_ERROR;
 
+#if INET_CONFIG_TUN_MAX_READ_BATCH > 1
+    // Reads are drained in batches until the device reports it is empty.
+    if ((fd = open(INET_CONFIG_TUNNEL_DEVICE_NAME, O_RDWR | NL_O_CLOEXEC | O_NONBLOCK)) < 0)
+#else
     if ((fd = open(INET_CONFIG_TUNNEL_DEVICE_NAME, O_RDWR | NL_O_CLOEXEC)) < 0)
+#endif
     {
         ExitNow(ret = Weave::System::MapErrorPOSIX(errno));
     }
@@ -773,37 +802,58 @@ SocketEvents TunEndPoint::PrepareIO ()
 void TunEndPoint::HandlePendingIO ()
 {
     INET_ERROR err = INET_NO_ERROR;
+    int numPktsRcvd = 0;
 
     if (mState == kState_Open && OnPacketReceived != NULL && mPendingIO.IsReadable())
     {
+        // Drain up to a batch of packets from the tun device. The loop ends early
+        // when the device has no more packets queued, or when the upper layer
+        // closes the endpoint or removes its handler from within a callback.
+        for (int i = 0; i < INET_CONFIG_TUN_MAX_READ_BATCH && mState == kState_Open && OnPacketReceived != NULL; i++)
+        {
+            PacketBuffer *buf = PacketBuffer::New(0);
 
-        PacketBuffer *buf = PacketBuffer::New(0);
+            if (buf != NULL)
+            {
+                //Read data from Tun Device
+                err = TunDevRead(buf);
+                if (err == INET_NO_ERROR)
+                {
+                    err = CheckV6Sanity(buf);
+                }
+            }
+            else
+            {
+                err = INET_ERROR_NO_MEMORY;
+            }
 
-        if (buf != NULL)
-        {
-            //Read data from Tun Device
-            err = TunDevRead(buf);
             if (err == INET_NO_ERROR)
             {
-                err = CheckV6Sanity(buf);
+                numPktsRcvd++;
+                OnPacketReceived(this, buf);
             }
-        }
-        else
-        {
-            err = INET_ERROR_NO_MEMORY;
-        }
+            else
+            {
+                PacketBuffer::Free(buf);
 
-        if (err == INET_NO_ERROR)
-        {
-            OnPacketReceived(this, buf);
+                // Nothing more to read during this readiness event.
+                if (err == Weave::System::MapErrorPOSIX(EAGAIN) || err == Weave::System::MapErrorPOSIX(EWOULDBLOCK))
+                {
+                    break;
+                }
+
+                if (OnReceiveError != NULL)
+                {
+                    OnReceiveError(this, err);
+                }
+
+                break;
+            }
         }
-        else
+
+        if (numPktsRcvd > 0 && mState == kState_Open && OnReceiveBatchComplete != NULL)
         {
-            PacketBuffer::Free(buf);
-            if (OnReceiveError != NULL)
-            {
-                OnReceiveError(this, err);
-            }
+            OnReceiveBatchComplete(this);
         }
     }
 
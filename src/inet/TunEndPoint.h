@@ -45,6 +45,7 @@
 #include <net/if.h>
 #include <fcntl.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <errno.h>
 #include <unistd.h>
 #include <netinet/ip6.h>
@@ -181,6 +182,21 @@ public:
     typedef void (*OnReceiveErrorFunct)(TunEndPoint *endPoint, INET_ERROR err);
     OnReceiveErrorFunct OnReceiveError;
 
+    /**
+     * @brief   Type of receive batch completion event handler.
+     *
+     * @details
+     *  Type of delegate to a higher layer to act upon the end of a batch of
+     *  IPv6 packets received from the tunnel, i.e. after the last
+     *  \c OnPacketReceived call made for a single readiness event. A higher
+     *  layer that defers output while packets are being delivered can use
+     *  this event to flush it.
+     *
+     * @param[in] endPoint      The TunEndPoint object.
+     */
+    typedef void (*OnReceiveBatchCompleteFunct)(TunEndPoint *endPoint);
+    OnReceiveBatchCompleteFunct OnReceiveBatchComplete;
+
     InterfaceId GetTunnelInterfaceId(void);
 
 private:
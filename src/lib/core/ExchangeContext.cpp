@@ -43,6 +43,7 @@
 #include <SystemLayer/SystemTimer.h>
 #include <Weave/Support/WeaveFaultInjection.h>
 #include <SystemLayer/SystemStats.h>
+#include <Weave/Core/WeaveStats.h>
 //#include <nestlabs/log/nllog.hpp>
 #undef nlLogError
 #define nlLogError(MSG, ...)
@@ -560,6 +561,11 @@ exit:
                        "sent", profileId, msgType, (int)payloadLen, msgInfo->DestNodeId,
                        (Con ? Con->LogId() : 0), ExchangeId, (long)err);
 #endif
+
+        if (err == WEAVE_NO_ERROR)
+        {
+            WEAVE_STATS_COUNT_MESSAGE_SENT(profileId, msgType);
+        }
     }
     if (err != WEAVE_NO_ERROR && IsResponseExpected())
     {
@@ -1077,6 +1083,15 @@ bool ExchangeContext::WRMPCheckAndRemRetransTable(uint32_t ackMsgId, void **rCtx
             //Return context value
             *rCtxt = ExchangeMgr->RetransTable[i].msgCtxt;
 
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+            // Only a message sent once gives an unambiguous round trip time
+            if (ExchangeMgr->RetransTable[i].sendCount == 1)
+            {
+                SYSTEM_STATS_HISTOGRAM_RECORD(nl::Weave::System::Stats::kHistogram_WRMPRoundTripTime,
+                    static_cast<uint32_t>(nl::Weave::System::Stats::GetTimestampUsec() - ExchangeMgr->RetransTable[i].firstSendTime));
+            }
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
             //Clear the entry from the retransmision table.
             ExchangeMgr->ClearRetransmitTable(ExchangeMgr->RetransTable[i]);
 
@@ -145,6 +145,22 @@
 #define WEAVE_CONFIG_BDX_SEND_INIT_MAX_METADATA_BYTES 64
 #endif // WEAVE_CONFIG_BDX_SEND_INIT_MAX_METADATA_BYTES
 
+/**
+ *  @def WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE
+ *
+ *  @brief
+ *      Maximum number of blocks in flight during an asynchronous transfer.
+ *
+ *  In asynchronous mode the sender keeps sending blocks until this many are
+ *  awaiting a BlockAck, and the receiver holds up to this many blocks that
+ *  arrive ahead of the one it expects.  Each in-flight block occupies a
+ *  PacketBuffer (and, when connection-less, a WRMP retransmission table
+ *  entry) at both ends.  Set to 1 to effectively disable pipelining.
+ */
+#ifndef WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE
+#define WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE 4
+#endif // WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE
+
 
 #if (WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT == 0) && (WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT == 0)
 #error "At least one of WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT or WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT must be enabled"
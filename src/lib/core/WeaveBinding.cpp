@@ -248,7 +248,8 @@ void Binding::DoClose()
     if (mState != kState_Closed)
     {
         // TODO FUTURE: Abort any in-progress async prepare actions associated with the binding,
-        // such as pending connection / session establishments.
+        // such as pending shared session establishments.  (Any pending connection is released
+        // when the configuration is reset below.)
 
         // Clear pointers to application state/code to prevent any further use.
         AppState = NULL;
@@ -323,6 +324,9 @@ exit:
  */
 void Binding::ResetConfig()
 {
+    // Detach from any connection in use by the binding.
+    ReleaseConnection();
+
     mPeerNodeId = kNodeIdNotSpecified;
 
     mAddressingOption = kAddressing_NotSpecified;
@@ -436,6 +440,10 @@ WEAVE_ERROR Binding::DoPrepare(WEAVE_ERROR configErr)
     // App must pick a security option
     VerifyOrExit(kSecurityOption_NotSpecified != mSecurityOption, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
+    // A CASE session with the peer is established over the binding's connection, so requires TCP
+    VerifyOrExit(kSecurityOption_CASESession != mSecurityOption || kTransport_TCP == mTransportOption,
+                 err = WEAVE_ERROR_INVALID_ARGUMENT);
+
     mState = kState_Preparing;
 
     WeaveLogDetail(ExchangeManager, "Binding[%" PRIu8 "] (%" PRIu16 "): Preparing", GetLogId(), mRefCount);
@@ -481,11 +489,32 @@ void Binding::PrepareAddress()
  */
 void Binding::PrepareTransport()
 {
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
     mState = kState_PreparingTransport;
 
-    // TODO FUTURE: Add support for TCP and existing connection
+    // TODO FUTURE: Add support for existing connection
+
+    if (kTransport_TCP == mTransportOption)
+    {
+        // Only a CASE session requested for the binding is established by the connection itself.
+        const WeaveAuthMode conAuthMode = (kSecurityOption_CASESession == mSecurityOption) ? mAuthMode : kWeaveAuthMode_Unauthenticated;
+
+        // Attach to the pooled connection to the peer, establishing it if necessary.
+        err = mExchangeManager->GetPooledConnection(mPeerNodeId, mPeerAddress, mPeerPort, mInterfaceId, conAuthMode, mCon);
+        SuccessOrExit(err);
+
+        // If the connection is still being established, preparation continues in OnConnectionComplete().
+        VerifyOrExit(mCon->State == WeaveConnection::kState_Connected, /* no-op */);
+    }
 
     PrepareSecurity();
+
+exit:
+    if (WEAVE_NO_ERROR != err)
+    {
+        HandleBindingFailed(err, true);
+    }
 }
 
 /**
@@ -528,6 +557,13 @@ void Binding::PrepareSecurity()
         }
         break;
 
+    case kSecurityOption_CASESession:
+        // The session was established along with the binding's connection.
+        mKeyId = mCon->DefaultKeyId;
+        mEncType = mCon->DefaultEncryptionType;
+        HandleBindingReady();
+        break;
+
     case kSecurityOption_SpecificKey:
     case kSecurityOption_None:
         // No further preparation needed.
@@ -562,25 +598,25 @@ void Binding::HandleBindingReady()
     {
         char ipAddrStr[64];
         char intfStr[64];
-        const char *transportStr;
+        char transportStr[24];
         mPeerAddress.ToString(ipAddrStr, sizeof(ipAddrStr));
         nl::Inet::GetInterfaceName(mInterfaceId, intfStr, sizeof(intfStr));
         switch (mTransportOption)
         {
         case kTransport_UDP:
-            transportStr = "UDP";
+            strcpy(transportStr, "UDP");
             break;
         case kTransport_UDP_WRM:
-            transportStr = "WRM";
+            strcpy(transportStr, "WRM");
             break;
         case kTransport_TCP:
-            transportStr = "TCP"; // TODO FUTURE: Add id of connection
+            snprintf(transportStr, sizeof(transportStr), "TCP Con %04" PRIX16, (mCon != NULL) ? mCon->LogId() : 0);
             break;
         case kTransport_ExistingConnection:
-            transportStr = "ExistingCon"; // TODO FUTURE: Add id of connection
+            snprintf(transportStr, sizeof(transportStr), "ExistingCon %04" PRIX16, (mCon != NULL) ? mCon->LogId() : 0);
             break;
         default:
-            transportStr = "Unknown";
+            strcpy(transportStr, "Unknown");
             break;
         }
         WeaveLogDetail(ExchangeManager, "Binding[%" PRIu8 "] (%" PRIu16 "): Ready, peer %016" PRIX64 " @ [%s]:%" PRId16 " (%s) via %s",
@@ -658,6 +694,53 @@ void Binding::HandleBindingFailed(WEAVE_ERROR err, bool raiseEvents)
     Release();
 }
 
+/**
+ * Release the binding's reference to its pooled connection, if any.
+ */
+void Binding::ReleaseConnection()
+{
+    WeaveConnection *con = mCon;
+
+    if (con != NULL)
+    {
+        // Clear the binding's pointer first, since releasing the connection may close it.
+        mCon = NULL;
+        mExchangeManager->ReleasePooledConnection(con);
+    }
+}
+
+/**
+ * Invoked when a pooled connection, and any session established over it, has been established.
+ */
+void Binding::OnConnectionComplete(WeaveConnection *con)
+{
+    // NOTE: This method is called for all bindings whenever a pooled connection completes.  Thus
+    // the code must filter for the connection the binding is waiting on.
+    VerifyOrExit(mState == kState_PreparingTransport && mCon == con, /* no-op */);
+
+    PrepareSecurity();
+
+exit:
+    return;
+}
+
+/**
+ * Invoked when a connection has closed or failed to be established.
+ */
+void Binding::OnConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    // Ignore the close if the binding is not using the connection.
+    VerifyOrExit(mCon != NULL && mCon == con, /* no-op */);
+
+    // The connection has already been removed from the pool, so there is no reference to release.
+    mCon = NULL;
+
+    HandleBindingFailed((conErr != WEAVE_NO_ERROR) ? conErr : WEAVE_ERROR_CONNECTION_CLOSED_UNEXPECTEDLY, true);
+
+exit:
+    return;
+}
+
 /**
  * Invoked when a security session establishment has completed successfully.
  */
@@ -822,12 +905,17 @@ WEAVE_ERROR Binding::NewExchangeContext(nl::Weave::ExchangeContext *& ec)
     // Fail if the binding is not in the Ready state.
     VerifyOrExit(kState_Ready == mState, err = WEAVE_ERROR_INCORRECT_STATE);
 
-    // Attempt to allocate a new exchange context.
-    ec = mExchangeManager->NewContext(mPeerNodeId, mPeerAddress, mPeerPort, mInterfaceId, NULL);
+    // Attempt to allocate a new exchange context, carried over the binding's connection if it has one.
+    if (mCon != NULL)
+    {
+        ec = mExchangeManager->NewContext(mCon, NULL);
+    }
+    else
+    {
+        ec = mExchangeManager->NewContext(mPeerNodeId, mPeerAddress, mPeerPort, mInterfaceId, NULL);
+    }
     VerifyOrExit(NULL != ec, err = WEAVE_ERROR_NO_MEMORY);
 
-    // TODO FUTURE: Add support for connection-based exchanges
-
 #if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
 
     // Set the default WRMP configuration in the new exchange.
@@ -969,11 +1057,14 @@ Binding::Configuration& Binding::Configuration::TargetAddress_WeaveFabric(uint16
 /**
  * Use TCP to communicate with the peer.
  *
+ * The binding attaches to a connection shared with any other TCP bindings to the same peer,
+ * address, port, interface and authentication mode, establishing the connection if necessary.
+ *
  * @return                              A reference to the binding object.
  */
 Binding::Configuration& Binding::Configuration::Transport_TCP()
 {
-    mError = WEAVE_ERROR_NOT_IMPLEMENTED;
+    mBinding.mTransportOption = kTransport_TCP;
     return *this;
 }
 
@@ -1100,6 +1191,23 @@ exit:
     return *this;
 }
 
+/**
+ * When communicating with the peer, send and receive messages encrypted using a CASE session
+ * established with the peer over the binding's connection.
+ *
+ * The session is established along with the connection as part of preparing the binding, and is
+ * shared by all bindings that share the connection.  Requires the use of Transport_TCP().
+ *
+ * @return                              A reference to the binding object.
+ */
+Binding::Configuration& Binding::Configuration::Security_CASESession(void)
+{
+    mBinding.mSecurityOption = kSecurityOption_CASESession;
+    mBinding.mKeyId = WeaveKeyId::kNone;
+    mBinding.mAuthMode = kWeaveAuthMode_CASE_AnyCert;
+    return *this;
+}
+
 /**
  * When communicating with the peer, send and receive messages encrypted using a specified key.
  *
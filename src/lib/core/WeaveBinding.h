@@ -83,6 +83,15 @@ class ExchangeContext;
  * such time as the Binding is closed, or some event, e.g., a network failure, terminates the
  * underlying communication channel.
  *
+ * ## Connection Sharing
+ *
+ * Bindings configured to use TCP do not open a connection of their own.  Instead they attach
+ * to a connection held in a pool by the exchange manager, keyed by the peer's node id, address,
+ * port, interface and the authentication mode of the connection.  Bindings that share these
+ * parameters share a single connection, along with any CASE session established over it, and
+ * their exchanges are multiplexed on that connection.  A pooled connection is closed once it
+ * has been idle (i.e., no bindings or exchanges are using it) for a configurable period.
+ *
  * ## Binding State Changes
  *
  * Over the course of its use, a Binding will deliver API events to the application informing it
@@ -214,6 +223,7 @@ private:
         kSecurityOption_None                        = 1,
         kSecurityOption_SpecificKey                 = 2,
         kSecurityOption_SharedCASESession           = 3,
+        kSecurityOption_CASESession                 = 4,
     };
 
     WeaveExchangeManager * mExchangeManager;
@@ -244,6 +254,9 @@ private:
     WRMPConfig mDefaultWRMPConfig;
 #endif
 
+    // Transport-specific state: the pooled connection over which exchanges are carried (TCP only)
+    WeaveConnection *mCon;
+
     // Note that IPAddress has a (redundant) copy assignment operator defined, so it cannot be part of any union pre C++11
     // This is not a big deal, but peer address is not really needed in ServiceDirectory scenarios
     nl::Inet::IPAddress mPeerAddress;
@@ -256,8 +269,11 @@ private:
     void PrepareTransport();
     void PrepareSecurity();
     void DoClose(void);
+    void ReleaseConnection(void);
     void HandleBindingReady();
     void HandleBindingFailed(WEAVE_ERROR err, bool raiseEvent);
+    void OnConnectionComplete(WeaveConnection *con);
+    void OnConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr);
     void OnSecureSessionReady(uint64_t peerNodeId, uint8_t encType, WeaveAuthMode authMode, uint16_t keyId);
     void OnKeyError(const uint32_t aKeyId, const uint64_t aPeerNodeId, const WEAVE_ERROR aKeyErr);
 };
@@ -298,6 +314,7 @@ public:
     Configuration& Security_None(void);
     Configuration& Security_SharedCASESession(void);
     Configuration& Security_SharedCASESession(uint64_t aRouterNodeId);
+    Configuration& Security_CASESession(void);
     Configuration& Security_Key(uint32_t aKeyId);
     Configuration& Security_AppGroupKey(uint32_t aAppGroupGlobalId, uint32_t aRootKeyId, bool aUseRotatingKey);
     Configuration& Security_EncryptionType(uint8_t aEncType);
@@ -903,6 +903,27 @@
 #define WEAVE_CONFIG_MAX_EC_BITS                            256
 #endif // WEAVE_CONFIG_MAX_EC_BITS
 
+/**
+ *  @def WEAVE_CONFIG_ECDH_KEY_POOL_SIZE
+ *
+ *  @brief
+ *    The number of pre-generated ephemeral ECDH key pairs held for
+ *    CASE and key export.
+ *
+ *    The security manager refills the pool between sessions, taking
+ *    one key generation off the critical path of each handshake.
+ *    Each key is used at most once and cleared when taken. Each entry
+ *    costs approximately three times (#WEAVE_CONFIG_MAX_EC_BITS / 8)
+ *    bytes of RAM.
+ *
+ *    A value of 0 disables the pool; keys are then generated when
+ *    needed.
+ *
+ */
+#ifndef WEAVE_CONFIG_ECDH_KEY_POOL_SIZE
+#define WEAVE_CONFIG_ECDH_KEY_POOL_SIZE                     0
+#endif // WEAVE_CONFIG_ECDH_KEY_POOL_SIZE
+
 /**
  *  @def WEAVE_CONFIG_MAX_PEER_NODES
  *
@@ -1017,6 +1038,34 @@
 #error "Please set WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS to a value greater than zero and smaller than 256."
 #endif // !(WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS > 0 && WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS < 256)
 
+/**
+ *  @def WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE
+ *
+ *  @brief
+ *    Size of the derived key cache kept by the group key store.
+ *    Application keys with no salt (e.g. message encryption keys and
+ *    passcode fingerprint keys), as well as derived root and
+ *    intermediate keys, are remembered here so that they are derived
+ *    with HKDF only once.  The cache is indexed by a hash of the key ID
+ *    and diversifier and is flushed whenever the fabric or application
+ *    keys are changed through WeaveFabricState or the application keys
+ *    trait.  Code that modifies a platform group key store by other
+ *    means must call GroupKeyStoreBase::ClearKeyCache().  Setting this
+ *    to 0 disables the cache.
+ *
+ *    Every entry holds a copy of the secret key material, so this
+ *    should be sized to the number of application groups that are
+ *    actively used, with room for the root and intermediate keys.
+ *
+ */
+#ifndef WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE
+#define WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE                   (2 * WEAVE_CONFIG_MAX_APPLICATION_GROUPS)
+#endif // WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE
+
+#if !(WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE >= 0 && WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE < 256)
+#error "Please set WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE to a value smaller than 256."
+#endif // !(WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE >= 0 && WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE < 256)
+
 /**
  *  @name Weave Encrypted Passcode Configuration
  *
@@ -1128,6 +1177,33 @@
 #define WEAVE_CONFIG_MAX_BINDINGS                           6
 #endif // WEAVE_CONFIG_MAX_BINDINGS
 
+/**
+ *  @def WEAVE_CONFIG_MAX_POOLED_CONNECTIONS
+ *
+ *  @brief
+ *    Maximum number of connections per WeaveExchangeManager that can be
+ *    shared by TCP bindings.  Bindings to the same peer node, address,
+ *    port, interface and authentication mode attach to a single pooled
+ *    connection (and its session) rather than each opening their own.
+ *
+ */
+#ifndef WEAVE_CONFIG_MAX_POOLED_CONNECTIONS
+#define WEAVE_CONFIG_MAX_POOLED_CONNECTIONS                 4
+#endif // WEAVE_CONFIG_MAX_POOLED_CONNECTIONS
+
+/**
+ *  @def WEAVE_CONFIG_POOLED_CONNECTION_IDLE_TIMEOUT
+ *
+ *  @brief
+ *    Time, in milliseconds, that a pooled connection is kept open once no
+ *    bindings or exchanges are using it.  A value of 0 closes the
+ *    connection as soon as it becomes idle.
+ *
+ */
+#ifndef WEAVE_CONFIG_POOLED_CONNECTION_IDLE_TIMEOUT
+#define WEAVE_CONFIG_POOLED_CONNECTION_IDLE_TIMEOUT         30000
+#endif // WEAVE_CONFIG_POOLED_CONNECTION_IDLE_TIMEOUT
+
 /**
  *  @def WEAVE_CONFIG_MAX_INTERFACES
  *
@@ -1669,6 +1745,70 @@
 #define WEAVE_CONFIG_ENABLE_CONDITION_LOGGING 0
 #endif // WEAVE_CONFIG_ENABLE_CONDITION_LOGGING
 
+/**
+ *  @def WEAVE_CONFIG_DEFERRED_LOGGING
+ *
+ *  @brief
+ *    If asserted (1), include support for deferred logging, where
+ *    nl::Weave::Logging::Log only records the module, category,
+ *    format string, and raw arguments of a message into a lock-free
+ *    ring, and formatting and output take place later, on a
+ *    background thread or when the ring is drained. Deferred logging
+ *    has to be started at run time with StartDeferredLogging().
+ *
+ *    Defaults to enabled for the C Standard I/O logging styles.
+ */
+#ifndef WEAVE_CONFIG_DEFERRED_LOGGING
+#define WEAVE_CONFIG_DEFERRED_LOGGING (WEAVE_LOGGING_STYLE_STDIO || WEAVE_LOGGING_STYLE_STDIO_WEAK)
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING
+
+/**
+ *  @def WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS
+ *
+ *  @brief
+ *    The number of messages the deferred logging ring can hold before
+ *    further messages are dropped. Must be a power of two.
+ */
+#ifndef WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS
+#define WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS 256
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS
+
+/**
+ *  @def WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE
+ *
+ *  @brief
+ *    The number of bytes available in each deferred logging record
+ *    for the raw arguments of a message, including copies of its
+ *    string arguments. Arguments that don't fit are dropped from the
+ *    formatted message.
+ */
+#ifndef WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE
+#define WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE 112
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE
+
+/**
+ *  @def WEAVE_CONFIG_DEFERRED_LOGGING_DRAIN_INTERVAL_MS
+ *
+ *  @brief
+ *    How long, in milliseconds, the deferred logging thread sleeps
+ *    when it finds the ring empty.
+ */
+#ifndef WEAVE_CONFIG_DEFERRED_LOGGING_DRAIN_INTERVAL_MS
+#define WEAVE_CONFIG_DEFERRED_LOGGING_DRAIN_INTERVAL_MS 20
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING_DRAIN_INTERVAL_MS
+
+/**
+ *  @def WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS
+ *
+ *  @brief
+ *    The number of distinct profile and message type pairs for which
+ *    message counts are kept when WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+ *    is asserted. Messages of further pairs are counted together.
+ */
+#ifndef WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS
+#define WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS 32
+#endif // WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS
+
 
 /**
  *  @def WEAVE_CONFIG_ENABLE_SERVICE_DIRECTORY
@@ -1705,6 +1845,44 @@
 #define WEAVE_CONFIG_SERVICE_DIR_CONNECT_TIMEOUT_MSECS      (10000)
 #endif // WEAVE_CONFIG_SERVICE_DIR_CONNECT_TIMEOUT_MSECS
 
+/**
+ *  @def WEAVE_CONFIG_SERVICE_DIR_INDEX_SIZE
+ *
+ *  @brief
+ *    The maximum number of service directory entries the service
+ *    manager indexes in memory for lookup. Directories with more
+ *    entries are searched by walking the cached directory.
+ *
+ */
+#ifndef WEAVE_CONFIG_SERVICE_DIR_INDEX_SIZE
+#define WEAVE_CONFIG_SERVICE_DIR_INDEX_SIZE                 (16)
+#endif // WEAVE_CONFIG_SERVICE_DIR_INDEX_SIZE
+
+/**
+ *  @def WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE
+ *
+ *  @brief
+ *    The maximum number of connections the service manager races
+ *    to the entries of a host/port list when connect racing is
+ *    enabled with WeaveServiceManager::enableConnectRacing().
+ *
+ */
+#ifndef WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE
+#define WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE          (3)
+#endif // WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE
+
+/**
+ *  @def WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_STAGGER_MSECS
+ *
+ *  @brief
+ *    The default delay, in milliseconds, between the starts of
+ *    racing connections to a service endpoint.
+ *
+ */
+#ifndef WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_STAGGER_MSECS
+#define WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_STAGGER_MSECS (250)
+#endif // WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_STAGGER_MSECS
+
 /**
  *  @def WEAVE_CONFIG_MSG_COUNTER_SYNC_RESP_TIMEOUT
  *
@@ -1977,6 +2155,71 @@
 #define WEAVE_CONFIG_SERVICE_PROV_RESPONSE_TIMEOUT 60000
 #endif
 
+/**
+ * @def WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS
+ *
+ * @brief
+ *    The number of slots in the timing wheel of the Heartbeat liveness
+ *    tracker.  Together with the tick interval this sets the span of
+ *    time the wheel covers in one revolution; nodes whose timeouts are
+ *    longer than that are revisited once per revolution.
+ */
+#ifndef WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS
+#define WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS 256
+#endif
+
+#if !(WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS > 0 && WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS < 65536)
+#error "Please set WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS to a value greater than zero and smaller than 65536."
+#endif // !(WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS > 0 && WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS < 65536)
+
+/**
+ * @def WEAVE_CONFIG_HEARTBEAT_LIVENESS_TICK_MS
+ *
+ * @brief
+ *    The default interval (in milliseconds) at which the Heartbeat
+ *    liveness tracker advances its timing wheel.  This bounds how late
+ *    a node is declared offline and how long a "came back" notification
+ *    may be held for batching.
+ */
+#ifndef WEAVE_CONFIG_HEARTBEAT_LIVENESS_TICK_MS
+#define WEAVE_CONFIG_HEARTBEAT_LIVENESS_TICK_MS 1000
+#endif
+
+/**
+ * @def WEAVE_CONFIG_HEARTBEAT_LIVENESS_MISSED_HEARTBEATS
+ *
+ * @brief
+ *    The number of consecutive heartbeat intervals a node may stay
+ *    silent before the Heartbeat liveness tracker declares it offline.
+ */
+#ifndef WEAVE_CONFIG_HEARTBEAT_LIVENESS_MISSED_HEARTBEATS
+#define WEAVE_CONFIG_HEARTBEAT_LIVENESS_MISSED_HEARTBEATS 3
+#endif
+
+/**
+ * @def WEAVE_CONFIG_HEARTBEAT_LIVENESS_BATCH_SIZE
+ *
+ * @brief
+ *    The maximum number of node ids reported in a single Heartbeat
+ *    liveness change callback.
+ */
+#ifndef WEAVE_CONFIG_HEARTBEAT_LIVENESS_BATCH_SIZE
+#define WEAVE_CONFIG_HEARTBEAT_LIVENESS_BATCH_SIZE 32
+#endif
+
+/**
+ * @def WEAVE_CONFIG_SWU_DELTA_COPY_BUFFER_SIZE
+ *
+ * @brief
+ *    The size (in bytes) of the scratch buffer through which the
+ *    Software Update delta image applier copies ranges of the base
+ *    image into the target image.  Larger values mean fewer calls to
+ *    the base image read callback at the cost of RAM.
+ */
+#ifndef WEAVE_CONFIG_SWU_DELTA_COPY_BUFFER_SIZE
+#define WEAVE_CONFIG_SWU_DELTA_COPY_BUFFER_SIZE 64
+#endif
+
 /**
  * @def WEAVE_NON_PRODUCTION_MARKER
  *
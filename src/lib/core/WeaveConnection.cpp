@@ -426,6 +426,10 @@ WEAVE_ERROR WeaveConnection::GetPeerAddressInfo(IPPacketInfo& addrInfo)
  *
  *  @param[in] msgBuf           A pointer to the PacketBuffer object holding the packet to send.
  *
+ *  @param[in] push             If true, the message is handed to the network layer immediately;
+ *                              otherwise it is queued until a later send with push set, or a call
+ *                              to PushSendQueue().
+ *
  *  @retval    #WEAVE_NO_ERROR                             on successfully sending the message down to
  *                                                         the network layer.
  *  @retval    #WEAVE_ERROR_INCORRECT_STATE                if the WeaveConnection object is not
@@ -435,7 +439,7 @@ WEAVE_ERROR WeaveConnection::GetPeerAddressInfo(IPPacketInfo& addrInfo)
  *  @retval    other Inet layer errors related to the specific endpoint send operations.
  *
  */
-WEAVE_ERROR WeaveConnection::SendTunneledMessage (WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf)
+WEAVE_ERROR WeaveConnection::SendTunneledMessage (WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf, bool push)
 {
 
     //Set message version to V2
@@ -444,7 +448,7 @@ WEAVE_ERROR WeaveConnection::SendTunneledMessage (WeaveMessageInfo *msgInfo, Pac
     //Set the tunneling flag
     msgInfo->Flags |= kWeaveMessageFlag_TunneledData;
 
-    return SendMessage(msgInfo, msgBuf);
+    return SendMessage(msgInfo, msgBuf, push);
 }
 #endif // WEAVE_CONFIG_ENABLE_TUNNELING
 
@@ -455,6 +459,11 @@ WEAVE_ERROR WeaveConnection::SendTunneledMessage (WeaveMessageInfo *msgInfo, Pac
  *
  *  @param[in] msgBuf           A pointer to the PacketBuffer object holding the packet to send.
  *
+ *  @param[in] push             If true, the message is handed to the network layer immediately;
+ *                              otherwise it is queued until a later send with push set, or a call
+ *                              to PushSendQueue(). Queued messages are coalesced into as few
+ *                              transport writes as possible. Ignored for BLE connections.
+ *
  *  @retval    #WEAVE_NO_ERROR                             on successfully sending the message down to
  *                                                         the network layer.
  *  @retval    #WEAVE_ERROR_INCORRECT_STATE                if the WeaveConnection object is not
@@ -464,7 +473,7 @@ WEAVE_ERROR WeaveConnection::SendTunneledMessage (WeaveMessageInfo *msgInfo, Pac
  *  @retval    other Inet layer errors related to the specific endpoint send operations.
  *
  */
-WEAVE_ERROR WeaveConnection::SendMessage (WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf)
+WEAVE_ERROR WeaveConnection::SendMessage (WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf, bool push)
 {
     WEAVE_ERROR res = WEAVE_NO_ERROR;
 
@@ -524,7 +533,7 @@ WEAVE_ERROR WeaveConnection::SendMessage (WeaveMessageInfo *msgInfo, PacketBuffe
     else
 #endif
     {
-        res = mTcpEndPoint->Send(msgBuf, true);
+        res = mTcpEndPoint->Send(msgBuf, push);
     }
     msgBuf = NULL;
 
@@ -538,6 +547,46 @@ exit:
     return res;
 }
 
+/**
+ *  Send any messages previously queued on the connection with the push argument
+ *  of SendMessage() set to false.
+ *
+ *  @retval    #WEAVE_NO_ERROR                             on successfully handing the queued messages
+ *                                                         down to the network layer.
+ *  @retval    #WEAVE_ERROR_INCORRECT_STATE                if the WeaveConnection object is not
+ *                                                         in the correct state for sending messages.
+ *  @retval    other Inet layer errors related to the specific endpoint send operations.
+ *
+ */
+WEAVE_ERROR WeaveConnection::PushSendQueue (void)
+{
+    WEAVE_ERROR res = WEAVE_NO_ERROR;
+
+    VerifyOrDie(mRefCount != 0);
+
+    VerifyOrExit(StateAllowsSend(), res = WEAVE_ERROR_INCORRECT_STATE);
+
+    if (mTcpEndPoint != NULL)
+    {
+        res = mTcpEndPoint->PushSendQueue();
+    }
+
+exit:
+    return res;
+}
+
+/**
+ *  Get the number of bytes of messages queued on the connection that have not yet been
+ *  taken by the underlying transport.
+ *
+ *  @return    The number of pending bytes; always zero for BLE connections.
+ *
+ */
+uint32_t WeaveConnection::PendingSendLength (void)
+{
+    return (mTcpEndPoint != NULL) ? mTcpEndPoint->PendingSendLength() : 0;
+}
+
 /**
  *  Performs a graceful TCP send-shutdown, ensuring all outgoing data has been sent and received
  *  by the peer's TCP stack. With most (but not all) TCP implementations, receipt of a send-shutdown
@@ -640,6 +689,7 @@ WEAVE_ERROR WeaveConnection::Close(bool suppressCloseLog)
     // Suppress callbacks.
     OnConnectionComplete = NULL;
     OnConnectionClosed = NULL;
+    OnDataSent = NULL;
 
     // Perform a graceful close.
     DoClose(WEAVE_NO_ERROR, kDoCloseFlag_SuppressCallback | (suppressCloseLog ? kDoCloseFlag_SuppressLogging : 0));
@@ -668,6 +718,7 @@ void WeaveConnection::Abort()
     // Suppress callbacks.
     OnConnectionComplete = NULL;
     OnConnectionClosed = NULL;
+    OnDataSent = NULL;
 
     // Perform an abortive close of the connection.
     DoClose(WEAVE_ERROR_CONNECTION_ABORTED, kDoCloseFlag_SuppressCallback);
@@ -1178,7 +1229,7 @@ void WeaveConnection::HandleConnectComplete(TCPEndPoint *endPoint, INET_ERROR co
 
         // Setup various callbacks on the end point.
         endPoint->OnDataReceived = HandleDataReceived;
-        endPoint->OnDataSent = NULL; // TODO: should handle flow control
+        endPoint->OnDataSent = HandleTcpDataSent;
         endPoint->OnConnectionClosed = HandleTcpConnectionClosed;
 
         // Disable TCP Nagle buffering by setting TCP_NODELAY socket option to true
@@ -1243,20 +1294,22 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
         // If the data buffer contains only part of a message...
         if (err == WEAVE_ERROR_MESSAGE_INCOMPLETE)
         {
-            // If there are more buffers in the queue, move as much data as possible into the head buffer
-            // and try again.
-            if (data->Next() != NULL)
-            {
-                data->CompactHead();
+            // If the rest of the message has already been received into subsequent buffers in the queue,
+            // move just that much data into the head buffer and try again. Any data following the message
+            // is left where it is, so that it doesn't have to be copied again when the message is handed
+            // to the application.
+            if (data->PullUpHead(frameLen))
                 continue;
-            }
 
             // Otherwise, we must wait for more data from the peer...
 
             // Open the receive window just enough to allow the remainder of the message to be received.
             // This is necessary in the case where the message size exceeds the TCP window size to ensure
             // the peer has enough window to send us the entire message.
-            uint16_t neededLen = frameLen - data->DataLength();
+            uint16_t rcvdLen = 0;
+            for (PacketBuffer *buf = data; buf != NULL; buf = buf->Next())
+                rcvdLen += buf->DataLength();
+            uint16_t neededLen = frameLen - rcvdLen;
             err = endPoint->AckReceive(neededLen);
             if (err == WEAVE_NO_ERROR)
                 break;
@@ -1288,6 +1341,31 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
                 payloadBuf->SetDataLength(payloadLen);
             }
 
+            // Otherwise, if the data following the message is shorter than the message payload, move
+            // that data into a new buffer instead, and give the original buffer to the application.
+            else if (data->DataLength() < payloadLen)
+            {
+                PacketBuffer *remainingBuf = PacketBuffer::New(0);
+                if (remainingBuf != NULL)
+                {
+                    PacketBuffer *tail = data->DetachTail();
+
+                    memcpy(remainingBuf->Start(), data->Start(), data->DataLength());
+                    remainingBuf->SetDataLength(data->DataLength());
+                    if (tail != NULL)
+                        remainingBuf->AddToEnd(tail);
+
+                    // Adjust the buffer to point at the payload of the message.
+                    payloadBuf = data;
+                    payloadBuf->SetStart(payload);
+                    payloadBuf->SetDataLength(payloadLen);
+
+                    data = remainingBuf;
+                }
+                else
+                    err = WEAVE_ERROR_NO_MEMORY;
+            }
+
             // Otherwise we need to keep the buffer so we can parse the remaining data, so copy the
             // payload data into a new buffer and arrange to pass the new buffer to the application.
             else
@@ -1401,6 +1479,13 @@ void WeaveConnection::HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *da
     }
 }
 
+void WeaveConnection::HandleTcpDataSent(TCPEndPoint *endPoint, uint16_t len)
+{
+    WeaveConnection *con = (WeaveConnection *) endPoint->AppState;
+    if (con->StateAllowsSend() && con->OnDataSent != NULL)
+        con->OnDataSent(con, len);
+}
+
 void WeaveConnection::HandleTcpConnectionClosed(TCPEndPoint *endPoint, INET_ERROR err)
 {
     WeaveConnection *con = (WeaveConnection *) endPoint->AppState;
@@ -1455,6 +1540,7 @@ void WeaveConnection::Init(WeaveMessageLayer *msgLayer)
 #endif
     OnConnectionClosed = DefaultConnectionClosedHandler;
     OnReceiveError = NULL;
+    OnDataSent = NULL;
     memset(&mPeerAddrs, 0, sizeof(mPeerAddrs));
     mTcpEndPoint = NULL;
 #if CONFIG_NETWORK_LAYER_BLE
@@ -1491,7 +1577,7 @@ void WeaveConnection::MakeConnectedTcp(TCPEndPoint *endPoint, const IPAddress &l
     NetworkType = kNetworkType_IP;
     endPoint->AppState = this;
     endPoint->OnDataReceived = HandleDataReceived;
-    endPoint->OnDataSent = NULL; // TODO: should handle flow control
+    endPoint->OnDataSent = HandleTcpDataSent;
     endPoint->OnConnectionClosed = HandleTcpConnectionClosed;
 
     PeerNodeId = (peerAddr.IsIPv6ULA()) ? IPv6InterfaceIdToWeaveNodeId(peerAddr.InterfaceId()) : kNodeIdNotSpecified;
@@ -221,6 +221,29 @@
 #define WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK 1
 #endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
 
+/**
+ *  @def WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+ *
+ *  @brief
+ *    Enable (1) or disable (0) streaming schema validation of
+ *    data lists carried in notify requests and view responses.
+ *
+ *    When enabled, the pre-flight check only validates the
+ *    envelope of these messages, and each data element is
+ *    validated immediately before it is consumed by its sink.
+ *    This avoids walking the data list twice. A schema error
+ *    found mid-list aborts processing, and any trait data sink
+ *    left in the middle of a partial change has its version
+ *    cleared so that it is fully resynchronized later.
+ *
+ *    Has no effect unless
+ *    #WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK is enabled.
+ *
+ */
+#ifndef WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+#define WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK 1
+#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+
 /**
  *  @def WDM_MAX_NUM_SUBSCRIPTION_CLIENTS
  *
@@ -406,6 +429,46 @@
 #endif // WDM_MAX_NUM_COMMAND_OBJECTS
 #endif // WDM_PUBLISHER_ENABLE_CUSTOM_COMMANDS
 
+/**
+ *  @def WDM_PUBLISHER_ENABLE_UPDATES
+ *
+ *  @brief
+ *    Enable (1) or disable (0) update request handler support
+ *    in Weave Data Management Next profile. This feature is
+ *    optional and could be disabled, for example, to save code space.
+ *
+ */
+#ifndef WDM_PUBLISHER_ENABLE_UPDATES
+#define WDM_PUBLISHER_ENABLE_UPDATES 1
+#endif
+
+/**
+ *  @def WDM_UPDATE_CLIENT_MAX_PENDING_PATHS
+ *
+ *  @brief
+ *    The maximum number of property paths an update client can
+ *    hold as pending mutations before they are flushed into an
+ *    update request. Mutations to the same property, or to a
+ *    property under a pending ancestor, share a single entry.
+ *
+ */
+#ifndef WDM_UPDATE_CLIENT_MAX_PENDING_PATHS
+#define WDM_UPDATE_CLIENT_MAX_PENDING_PATHS 16
+#endif
+
+/**
+ *  @def WDM_UPDATE_CLIENT_MAX_IN_FLIGHT
+ *
+ *  @brief
+ *    The maximum number of update requests an update client can
+ *    have outstanding on its binding at any given time. Each one
+ *    uses its own exchange context.
+ *
+ */
+#ifndef WDM_UPDATE_CLIENT_MAX_IN_FLIGHT
+#define WDM_UPDATE_CLIENT_MAX_IN_FLIGHT 2
+#endif
+
 /**
  *  @def WDM_ENABLE_SUBSCRIPTION_PUBLISHER
  *
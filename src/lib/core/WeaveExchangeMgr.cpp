@@ -42,6 +42,7 @@
 #include <Weave/Support/WeaveFaultInjection.h>
 #include <SystemLayer/SystemTimer.h>
 #include <SystemLayer/SystemStats.h>
+#include <Weave/Core/WeaveStats.h>
 
 namespace nl {
 namespace Weave {
@@ -91,6 +92,9 @@ WEAVE_ERROR WeaveExchangeManager::Init(WeaveMessageLayer *msgLayer)
 
     InitBindingPool();
 
+    PooledConnectionIdleTimeout = WEAVE_CONFIG_POOLED_CONNECTION_IDLE_TIMEOUT;
+    InitConnectionPool();
+
     memset(UMHandlerPool, 0, sizeof(UMHandlerPool));
     OnExchangeContextChanged = NULL;
 
@@ -128,6 +132,8 @@ WEAVE_ERROR WeaveExchangeManager::Shutdown()
 {
     if (MessageLayer != NULL)
     {
+        ShutdownConnectionPool();
+
         if (MessageLayer->ExchangeMgr == this)
         {
             MessageLayer->ExchangeMgr = NULL;
@@ -510,6 +516,20 @@ void WeaveExchangeManager::HandleConnectionClosed(WeaveConnection *con, WEAVE_ER
             SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kExchangeMgr_NumUMHandlers);
             umh->Handler = NULL;
         }
+
+    // Remove the connection from the pool.  The pool's reference to the connection is released by the
+    // connection's completion or closed callback, which is called after this method returns.
+    PooledConnection *pooledCon = FindPooledConnection(con);
+    if (pooledCon != NULL)
+    {
+        pooledCon->Con = NULL;
+        pooledCon->RefCount = 0;
+    }
+
+    // Fail any bindings that were using the connection.
+    Binding *binding = BindingPool;
+    for (int i = 0; i < WEAVE_CONFIG_MAX_BINDINGS; i++, binding++)
+        binding->OnConnectionClosed(con, conErr);
 }
 
 /**
@@ -635,6 +655,10 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     bool isMsgCounterSyncResp;
     bool peerGroupMsgIdNotSynchronized;
+#endif
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    const uint64_t dispatchStartTime       = System::Stats::GetTimestampUsec();
+    bool isHeaderDecoded                   = false;
 #endif
     WEAVE_ERROR  err                       = WEAVE_NO_ERROR;
 
@@ -642,6 +666,10 @@ void WeaveExchangeManager::DispatchMessage(WeaveMessageInfo *msgInfo, PacketBuff
     err = DecodeHeader(&exchangeHeader, msgBuf);
     SuccessOrExit(err);
 
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    isHeaderDecoded = true;
+#endif
+
     //Check if the version is supported
     if ((msgInfo->MessageVersion != kWeaveMessageVersion_V1) &&
         (msgInfo->MessageVersion != kWeaveMessageVersion_V2))
@@ -894,6 +922,19 @@ exit:
         PacketBuffer::Free(msgBuf);
     }
 
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    {
+        const uint32_t dispatchTime = static_cast<uint32_t>(System::Stats::GetTimestampUsec() - dispatchStartTime);
+
+        SYSTEM_STATS_HISTOGRAM_RECORD(System::Stats::kHistogram_ExchangeDispatchTime, dispatchTime);
+
+        if (isHeaderDecoded)
+        {
+            WEAVE_STATS_COUNT_MESSAGE_RECEIVED(exchangeHeader.ProfileId, exchangeHeader.MessageType, dispatchTime);
+        }
+    }
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
     return;
 }
 
@@ -1272,6 +1313,8 @@ void WeaveExchangeManager::WRMPExecuteActions(void)
                     WeaveLogError(ExchangeManager, "Failed to Send Weave MsgId:%08" PRIX32 " sendCount: %" PRIu8 " max retries: %" PRIu8,
                                   RetransTable[i].msgId, sendCount, ec->mWRMPConfig.mMaxRetrans);
 
+                    WEAVE_STATS_COUNT(Stats::kCounter_WRMPSendFailures);
+
                     // Remove from Table
                     ClearRetransmitTable(RetransTable[i]);
                 }
@@ -1527,6 +1570,16 @@ WEAVE_ERROR WeaveExchangeManager::SendFromRetransTable(RetransTableEntry *entry)
         entry->msgBuf->SetDataLength(len);
 
         //Update the counters
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+        if (entry->sendCount == 0)
+        {
+            entry->firstSendTime = System::Stats::GetTimestampUsec();
+        }
+        else
+        {
+            WEAVE_STATS_COUNT(Stats::kCounter_WRMPRetransmissions);
+        }
+#endif
         entry->sendCount++;
     }
     else
@@ -1812,6 +1865,302 @@ uint16_t WeaveExchangeManager::GetBindingLogId(const Binding * const binding) co
     return static_cast<uint16_t>(binding - BindingPool);
 }
 
+/**
+ *  Initialize the pool of connections shared by TCP bindings.
+ *
+ */
+void WeaveExchangeManager::InitConnectionPool(void)
+{
+    for (size_t i = 0; i < WEAVE_CONFIG_MAX_POOLED_CONNECTIONS; ++i)
+    {
+        ConnectionPool[i].Con = NULL;
+        ConnectionPool[i].RefCount = 0;
+    }
+}
+
+/**
+ *  Close all pooled connections and stop the idle connection timer.
+ *
+ */
+void WeaveExchangeManager::ShutdownConnectionPool(void)
+{
+    MessageLayer->SystemLayer->CancelTimer(HandleConnectionPoolTimeout, this);
+
+    for (size_t i = 0; i < WEAVE_CONFIG_MAX_POOLED_CONNECTIONS; ++i)
+    {
+        WeaveConnection *con = ConnectionPool[i].Con;
+        if (con != NULL)
+        {
+            ConnectionPool[i].Con = NULL;
+            con->Close();
+        }
+    }
+}
+
+/**
+ *  Attach to a pooled connection to a peer, establishing a new connection if one does not already exist.
+ *
+ *  Connections are shared by all bindings with the same peer node id, address, port, interface and
+ *  authentication mode.  Each successful call must be balanced by a call to ReleasePooledConnection().
+ *
+ *  Note that the returned connection may still be connecting, or establishing its session.  When it
+ *  completes, all bindings using the connection are notified via Binding::OnConnectionComplete();
+ *  if it fails, they are notified via Binding::OnConnectionClosed().
+ *
+ *  @param[in]  peerNodeId      The node id of the peer.
+ *  @param[in]  peerAddr        The IP address of the peer.
+ *  @param[in]  peerPort        The port of the peer.
+ *  @param[in]  intf            The interface over which to connect, or INET_NULL_INTERFACEID.
+ *  @param[in]  authMode        The authentication mode of the session to be established over the connection.
+ *  @param[out] con             A reference to a pointer that will receive the connection, or NULL on failure.
+ *
+ *  @retval #WEAVE_NO_ERROR         If the connection was attached.
+ *  @retval #WEAVE_ERROR_NO_MEMORY  If the pool or the message layer is out of connections.
+ *  @retval other                   Errors returned by WeaveConnection::Connect().
+ *
+ */
+WEAVE_ERROR WeaveExchangeManager::GetPooledConnection(uint64_t peerNodeId, const IPAddress &peerAddr, uint16_t peerPort,
+        InterfaceId intf, WeaveAuthMode authMode, WeaveConnection *& con)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PooledConnection *pooledCon = NULL;
+    PooledConnection *freeEntry = NULL;
+    PooledConnection *idleEntry = NULL;
+    WeaveConnection *newCon;
+
+    con = NULL;
+
+    for (size_t i = 0; i < WEAVE_CONFIG_MAX_POOLED_CONNECTIONS; ++i)
+    {
+        PooledConnection *entry = &ConnectionPool[i];
+
+        if (entry->Con == NULL)
+        {
+            if (freeEntry == NULL)
+                freeEntry = entry;
+        }
+        else if (entry->PeerNodeId == peerNodeId && entry->PeerAddr == peerAddr && entry->PeerPort == peerPort &&
+                 entry->PeerIntf == intf && entry->AuthMode == authMode)
+        {
+            pooledCon = entry;
+            break;
+        }
+        else if (entry->RefCount == 0 && !IsConnectionInUse(entry->Con) &&
+                 (idleEntry == NULL || entry->IdleSince < idleEntry->IdleSince))
+        {
+            idleEntry = entry;
+        }
+    }
+
+    if (pooledCon == NULL)
+    {
+        // If the pool is full, make room by closing the connection that has been idle the longest.
+        if (freeEntry == NULL && idleEntry != NULL)
+        {
+            WeaveConnection *idleCon = idleEntry->Con;
+
+            WeaveLogDetail(ExchangeManager, "Pooled con %04" PRIX16 " evicted", idleCon->LogId());
+
+            idleEntry->Con = NULL;
+            idleCon->Close();
+            freeEntry = idleEntry;
+        }
+        VerifyOrExit(freeEntry != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+        newCon = MessageLayer->NewConnection();
+        VerifyOrExit(newCon != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+        newCon->AppState = this;
+        newCon->OnConnectionComplete = HandlePooledConnectionComplete;
+        AllowUnsolicitedMessages(newCon);
+
+        pooledCon = freeEntry;
+        pooledCon->Con = newCon;
+        pooledCon->PeerNodeId = peerNodeId;
+        pooledCon->PeerAddr = peerAddr;
+        pooledCon->PeerPort = peerPort;
+        pooledCon->PeerIntf = intf;
+        pooledCon->AuthMode = authMode;
+        pooledCon->RefCount = 0;
+
+        err = newCon->Connect(peerNodeId, authMode, peerAddr, peerPort, intf);
+        if (err != WEAVE_NO_ERROR)
+        {
+            pooledCon->Con = NULL;
+            newCon->Close();
+            ExitNow();
+        }
+
+        // Connect() may have failed the connection before returning, in which case the entry has been freed.
+        VerifyOrExit(pooledCon->Con == newCon, err = WEAVE_ERROR_CONNECTION_ABORTED);
+
+        WeaveLogDetail(ExchangeManager, "Pooled con %04" PRIX16 " opened to peer %016" PRIX64, newCon->LogId(), peerNodeId);
+    }
+
+    pooledCon->RefCount++;
+    con = pooledCon->Con;
+
+exit:
+    WeaveLogFunctError(err);
+    return err;
+}
+
+/**
+ *  Release a binding's reference to a pooled connection.
+ *
+ *  When the last reference is released the connection becomes idle, and is closed once it has remained
+ *  idle for #PooledConnectionIdleTimeout milliseconds.
+ *
+ *  @param[in]  con             A connection previously returned by GetPooledConnection().
+ *
+ */
+void WeaveExchangeManager::ReleasePooledConnection(WeaveConnection *con)
+{
+    PooledConnection *pooledCon = FindPooledConnection(con);
+
+    VerifyOrExit(pooledCon != NULL && pooledCon->RefCount > 0, /* no-op */);
+
+    if (--pooledCon->RefCount == 0)
+    {
+        pooledCon->IdleSince = System::Timer::GetCurrentEpoch();
+        ReapIdleConnections();
+    }
+
+exit:
+    return;
+}
+
+/**
+ *  Find the pool entry for a connection.
+ *
+ *  @retval  A pointer to the pool entry, or NULL if the connection is not pooled.
+ *
+ */
+WeaveExchangeManager::PooledConnection *WeaveExchangeManager::FindPooledConnection(const WeaveConnection *con)
+{
+    for (size_t i = 0; i < WEAVE_CONFIG_MAX_POOLED_CONNECTIONS; ++i)
+    {
+        if (con != NULL && ConnectionPool[i].Con == con)
+        {
+            return &ConnectionPool[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ *  Determine whether any exchanges are being carried over a connection.
+ *
+ */
+bool WeaveExchangeManager::IsConnectionInUse(const WeaveConnection *con) const
+{
+    const ExchangeContext *ec = ContextPool;
+
+    for (int i = 0; i < WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS; i++, ec++)
+    {
+        if (ec->ExchangeMgr != NULL && ec->Con == con)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ *  Close pooled connections that have been idle for longer than the idle timeout, and arm the timer
+ *  for the next connection due to expire.
+ *
+ *  A pooled connection is idle when no bindings are attached to it and no exchanges are using it.
+ *
+ */
+void WeaveExchangeManager::ReapIdleConnections(void)
+{
+    // Interval at which an unreferenced connection is re-checked while exchanges are still using it,
+    // if the idle timeout itself is zero.
+    static const uint32_t kBusyConnectionRecheckInterval = 1000;
+
+    const uint64_t now = System::Timer::GetCurrentEpoch();
+    uint32_t nextTimeout = UINT32_MAX;
+
+    MessageLayer->SystemLayer->CancelTimer(HandleConnectionPoolTimeout, this);
+
+    for (size_t i = 0; i < WEAVE_CONFIG_MAX_POOLED_CONNECTIONS; ++i)
+    {
+        PooledConnection *entry = &ConnectionPool[i];
+        WeaveConnection *con = entry->Con;
+
+        if (con == NULL || entry->RefCount != 0)
+            continue;
+
+        uint32_t timeout;
+
+        if (IsConnectionInUse(con))
+        {
+            // Restart the idle period, and check again later.
+            entry->IdleSince = now;
+            timeout = (PooledConnectionIdleTimeout != 0) ? PooledConnectionIdleTimeout : kBusyConnectionRecheckInterval;
+        }
+        else if (now - entry->IdleSince >= PooledConnectionIdleTimeout)
+        {
+            WeaveLogDetail(ExchangeManager, "Pooled con %04" PRIX16 " closed after idle timeout", con->LogId());
+
+            entry->Con = NULL;
+            con->Close();
+            continue;
+        }
+        else
+        {
+            timeout = static_cast<uint32_t>(PooledConnectionIdleTimeout - (now - entry->IdleSince));
+        }
+
+        if (timeout < nextTimeout)
+            nextTimeout = timeout;
+    }
+
+    if (nextTimeout != UINT32_MAX)
+    {
+        MessageLayer->SystemLayer->StartTimer(nextTimeout, HandleConnectionPoolTimeout, this);
+    }
+}
+
+/**
+ *  Handle completion (or failure) of the connection and session establishment for a pooled connection.
+ *
+ */
+void WeaveExchangeManager::HandlePooledConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    WeaveExchangeManager *exchangeMgr = static_cast<WeaveExchangeManager *>(con->AppState);
+
+    // If the connection failed, the bindings waiting on it have already been failed and the connection
+    // removed from the pool (see HandleConnectionClosed()), so just release the pool's reference.
+    if (conErr != WEAVE_NO_ERROR)
+    {
+        con->Close();
+        ExitNow();
+    }
+
+    // Tell the bindings waiting on the connection that it is ready.
+    for (int i = 0; i < WEAVE_CONFIG_MAX_BINDINGS; i++)
+    {
+        exchangeMgr->BindingPool[i].OnConnectionComplete(con);
+    }
+
+exit:
+    return;
+}
+
+void WeaveExchangeManager::HandleConnectionPoolTimeout(System::Layer *aSystemLayer, void *aAppState, System::Error aError)
+{
+    WeaveExchangeManager *exchangeMgr = static_cast<WeaveExchangeManager *>(aAppState);
+
+    if (aError == WEAVE_SYSTEM_NO_ERROR)
+    {
+        exchangeMgr->ReapIdleConnections();
+    }
+}
+
 /**
  *  Handle secure session ready.
  *
@@ -390,6 +390,7 @@ public:
     WeaveMessageLayer *MessageLayer;            /**< [READ ONLY] The associated WeaveMessageLayer object. */
     WeaveFabricState *FabricState;              /**< [READ ONLY] The associated FabricState object. */
     uint8_t State;                              /**< [READ ONLY] The state of the WeaveExchangeManager object. */
+    uint32_t PooledConnectionIdleTimeout;       /**< Time, in milliseconds, an idle pooled connection is kept open. */
 
     WEAVE_ERROR Init(WeaveMessageLayer *msgLayer);
     WEAVE_ERROR Shutdown(void);
@@ -456,6 +457,9 @@ private:
        void                 *msgCtxt;           /**< A pointer to an application level context object associated with the message. */
        uint16_t             nextRetransTime;    /**< A counter representing the next retransmission time for the message. */
        uint8_t              sendCount;          /**< A counter representing the number of times the message has been sent. */
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+       uint64_t             firstSendTime;      /**< The time the message was first sent, in microseconds, for round trip statistics. */
+#endif
     };
     void     WRMPExecuteActions(void);
     void     WRMPExpireTicks(void);
@@ -498,6 +502,29 @@ private:
     Binding BindingPool[WEAVE_CONFIG_MAX_BINDINGS];
     size_t mBindingsInUse;
 
+    /**
+     *  @class PooledConnection
+     *
+     *  @brief
+     *    A connection shared by the TCP bindings to a given peer, address, port, interface and
+     *    authentication mode.  The pool holds the application reference to the connection;
+     *    bindings attach to an entry by reference count.
+     */
+    class PooledConnection
+    {
+    public:
+        WeaveConnection *Con;                   /**< The pooled connection, or NULL if the entry is free. */
+        uint64_t PeerNodeId;                    /**< Node id of the peer. */
+        IPAddress PeerAddr;                     /**< Address of the peer. */
+        uint64_t IdleSince;                     /**< Time, in milliseconds, at which the last binding released the entry. */
+        InterfaceId PeerIntf;                   /**< Interface over which the connection was established. */
+        uint16_t PeerPort;                      /**< Port of the peer. */
+        WeaveAuthMode AuthMode;                 /**< Authentication mode of the session established over the connection. */
+        uint8_t RefCount;                       /**< Number of bindings attached to the connection. */
+    };
+
+    PooledConnection ConnectionPool[WEAVE_CONFIG_MAX_POOLED_CONNECTIONS];
+
     UnsolicitedMessageHandler UMHandlerPool[WEAVE_CONFIG_MAX_UNSOLICITED_MESSAGE_HANDLERS];
     void (*OnExchangeContextChanged)(size_t numContextsInUse);
 
@@ -521,6 +548,17 @@ private:
     void FreeBinding(Binding *binding);
     uint16_t GetBindingLogId(const Binding * const binding) const;
 
+    void InitConnectionPool(void);
+    void ShutdownConnectionPool(void);
+    WEAVE_ERROR GetPooledConnection(uint64_t peerNodeId, const IPAddress &peerAddr, uint16_t peerPort, InterfaceId intf,
+            WeaveAuthMode authMode, WeaveConnection *& con);
+    void ReleasePooledConnection(WeaveConnection *con);
+    PooledConnection *FindPooledConnection(const WeaveConnection *con);
+    bool IsConnectionInUse(const WeaveConnection *con) const;
+    void ReapIdleConnections(void);
+    static void HandlePooledConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr);
+    static void HandleConnectionPoolTimeout(System::Layer *aSystemLayer, void *aAppState, System::Error aError);
+
     WeaveExchangeManager(const WeaveExchangeManager&); // not defined
 };
 
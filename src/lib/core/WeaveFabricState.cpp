@@ -92,6 +92,25 @@ enum
 // Key diversifier used for Weave message encryption key derivation.
 const uint8_t kWeaveMsgEncAppKeyDiversifier[] = { 0xB1, 0x1D, 0xAE, 0x5B };
 
+const WeaveSessionState::ReceiveFlagsType WeaveSessionState::kReceiveFlags_MessageIdSynchronized;
+const WeaveSessionState::ReceiveFlagsType WeaveSessionState::kReceiveFlags_MessageIdFlagsMask;
+
+// Hash a node id, and optionally a key id, for the peer state and session key hash tables.
+static inline uint32_t HashNodeId(uint64_t nodeId, uint16_t keyId = 0)
+{
+    uint32_t hash = static_cast<uint32_t>(nodeId) ^ static_cast<uint32_t>(nodeId >> 32) ^ (static_cast<uint32_t>(keyId) << 16);
+
+    // Fibonacci hashing spreads sequential node ids, which are common within a fabric.
+    return (hash * 0x9E3779B1U) >> 8;
+}
+
+// Return true if slot is cyclically within (emptySlot, probeSlot] -- that is, if an entry whose home
+// is slot and which is stored at probeSlot must stay put when emptySlot is vacated.
+static inline bool IsCyclicallyBetween(size_t emptySlot, size_t slot, size_t probeSlot)
+{
+    return (emptySlot <= probeSlot) ? (emptySlot < slot && slot <= probeSlot) : (emptySlot < slot || slot <= probeSlot);
+}
+
 void WeaveSessionKey::Init(void)
 {
     NodeId = kNodeIdNotSpecified;
@@ -148,6 +167,8 @@ WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
     NextUnencTCPMsgId.Init(0);
     for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
         SessionKeys[i].Init();
+    for (int i = 0; i < kSessionKeyHashTableSize; i++)
+        SessionKeyHashTable[i] = kSessionKeyIndex_None;
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     WEAVE_ERROR err = NextGroupKeyMsgId.Init(WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_ID, WEAVE_CONFIG_PERSISTED_STORAGE_ENC_MSG_CNTR_EPOCH);
     if (err != WEAVE_NO_ERROR)
@@ -158,6 +179,10 @@ WEAVE_ERROR WeaveFabricState::Init(GroupKeyStoreBase *groupKeyStore)
     AppKeyCache.Init();
 #endif
     memset(&PeerStates, 0, sizeof(PeerStates));
+    PeerStates.MostRecentlyUsed = kPeerIndex_None;
+    PeerStates.LeastRecentlyUsed = kPeerIndex_None;
+    for (int i = 0; i < kPeerHashTableSize; i++)
+        PeerStates.HashTable[i] = kPeerIndex_None;
     Delegate = NULL;
     memset(SharedSessionsNodes, 0, sizeof(SharedSessionsNodes));
 
@@ -233,6 +258,8 @@ WEAVE_ERROR WeaveFabricState::AllocSessionKey(uint64_t peerNodeId, WeaveConnecti
     sessionKey->RcvFlags = 0;
     sessionKey->SharedSession = sharedSession;
 
+    AddSessionKeyToHashTable(sessionKey);
+
     return WEAVE_NO_ERROR;
 }
 
@@ -285,7 +312,7 @@ WEAVE_ERROR WeaveFabricState::RemoveSessionKey(uint16_t keyId, uint64_t peerNode
         }
     }
 
-    sessionKey->Clear();
+    ClearSessionKey(sessionKey);
 
 exit:
     return err;
@@ -352,34 +379,6 @@ exit:
     return retVal;
 }
 
-/**
- * This method checks whether end node already recorded and returns true if
- * node is found in the shared end node list.
- *
- * @param[in]  endNodeId          Identifier of the session end node.
- * @param[in]  sessionKey         A pointer to the session key object.
- *
- * @retval     bool               Whether or not end node exists in the
- *                                shared end nodes list.
- *
- */
-bool WeaveFabricState::FindSharedSessionEndNode(uint64_t endNodeId, const WeaveSessionKey *sessionKey)
-{
-    SharedSessionEndNode *endNode = SharedSessionsNodes;
-    bool retVal = false;
-
-    for (int i = 0; i < WEAVE_CONFIG_MAX_SHARED_SESSIONS_END_NODES; i++, endNode++)
-    {
-        if (endNode->SessionKey == sessionKey && endNode->EndNodeId == endNodeId)
-        {
-            retVal = true;
-            break;
-        }
-    }
-
-    return retVal;
-}
-
 /**
  * This method adds new end node to the shared end nodes record.
  *
@@ -785,23 +784,15 @@ exit:
  */
 bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry, PeerIndexType& retPeerIndex)
 {
-    uint16_t i;
-    bool retVal = false;
-
     // Find peer entry in the peer state table.
-    for (i = 0; i < PeerCount; i++)
-    {
-        retPeerIndex = PeerStates.MostRecentlyUsedIndexes[i];
-        if (PeerStates.NodeId[retPeerIndex] == peerNodeId)
-        {
-            retVal = true;
-            break;
-        }
-    }
+    retPeerIndex = LookupPeerEntry(peerNodeId);
 
     // If peer entry is not found in the peer state table and allocation was requested.
-    if (!retVal && allocEntry)
+    if (retPeerIndex == kPeerIndex_None)
     {
+        if (!allocEntry)
+            return false;
+
         // If PeerStates table is full then the least recently used entry is discarded
         // and allocated for the new peer node. The replacement algorithms tries to find
         // least recently used entry that didn't use encryption to avoid future
@@ -809,33 +800,31 @@ bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry
         if (PeerCount == WEAVE_CONFIG_MAX_PEER_NODES)
         {
             // Choose the least recently used peer entry by default.
-            i = WEAVE_CONFIG_MAX_PEER_NODES - 1;
+            retPeerIndex = PeerStates.LeastRecentlyUsed;
 
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
             // Try to find the least recently used peer entry that didn't use encryption.
-            for (int j = WEAVE_CONFIG_MAX_PEER_NODES - 1; j >= 0; j--)
+            for (PeerIndexType peerInd = PeerStates.LeastRecentlyUsed; peerInd != kPeerIndex_None; peerInd = PeerStates.MoreRecentlyUsed[peerInd])
             {
-                PeerIndexType peerInd = PeerStates.MostRecentlyUsedIndexes[j];
                 if ((PeerStates.GroupKeyRcvFlags[peerInd] & WeaveSessionState::kReceiveFlags_MessageIdSynchronized) == 0)
                 {
-                    i = j;
+                    retPeerIndex = peerInd;
                     break;
                 }
             }
 #endif
 
-            // The peer index chosen for replacement.
-            retPeerIndex = PeerStates.MostRecentlyUsedIndexes[i];
+            RemovePeerEntryFromHashTable(retPeerIndex);
+            UnlinkPeerEntry(retPeerIndex);
         }
 
-        // If PeerStates table is not full then the next available entry is "i".
+        // If PeerStates table is not full then the next available entry is allocated.
         // Entries in the table are allocated sequentially and never discarded until
         // the table is full. Only when table is full the least recently used entry
         // is discarded and replaced with the new entry.
         else
         {
-            PeerCount++;
-            retPeerIndex = i;
+            retPeerIndex = PeerCount++;
         }
 
         PeerStates.NodeId[retPeerIndex] = peerNodeId;
@@ -845,19 +834,92 @@ bool WeaveFabricState::FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry
         PeerStates.GroupKeyRcvFlags[retPeerIndex] = 0;
 #endif
         PeerStates.UnencRcvFlags[retPeerIndex] = 0;
-        retVal = true;
+
+        AddPeerEntryToHashTable(retPeerIndex);
+    }
+    else
+    {
+        UnlinkPeerEntry(retPeerIndex);
     }
 
-    // Move the requested entry to the top of the most recently used indexes list.
-    if (retVal)
+    // Move the requested entry to the head of the most recently used list.
+    MarkPeerEntryMostRecentlyUsed(retPeerIndex);
+
+    return true;
+}
+
+// Return the index of the peer entry for a node, or kPeerIndex_None if the node has no entry.
+WeaveFabricState::PeerIndexType WeaveFabricState::LookupPeerEntry(uint64_t peerNodeId) const
+{
+    for (size_t slot = HashNodeId(peerNodeId) % kPeerHashTableSize; ; slot = (slot + 1) % kPeerHashTableSize)
     {
-        memmove(&PeerStates.MostRecentlyUsedIndexes[1],
-                &PeerStates.MostRecentlyUsedIndexes[0],
-                i * sizeof(PeerIndexType));
-        PeerStates.MostRecentlyUsedIndexes[0] = retPeerIndex;
+        PeerIndexType peerIndex = PeerStates.HashTable[slot];
+
+        if (peerIndex == kPeerIndex_None || PeerStates.NodeId[peerIndex] == peerNodeId)
+            return peerIndex;
     }
+}
 
-    return retVal;
+void WeaveFabricState::AddPeerEntryToHashTable(PeerIndexType peerIndex)
+{
+    size_t slot = HashNodeId(PeerStates.NodeId[peerIndex]) % kPeerHashTableSize;
+
+    while (PeerStates.HashTable[slot] != kPeerIndex_None)
+        slot = (slot + 1) % kPeerHashTableSize;
+
+    PeerStates.HashTable[slot] = peerIndex;
+}
+
+// Remove a peer entry from the hash table, shifting later entries of the probe sequence back
+// so that lookups never need tombstones.
+void WeaveFabricState::RemovePeerEntryFromHashTable(PeerIndexType peerIndex)
+{
+    size_t emptySlot = HashNodeId(PeerStates.NodeId[peerIndex]) % kPeerHashTableSize;
+
+    while (PeerStates.HashTable[emptySlot] != peerIndex)
+        emptySlot = (emptySlot + 1) % kPeerHashTableSize;
+
+    for (size_t slot = (emptySlot + 1) % kPeerHashTableSize; PeerStates.HashTable[slot] != kPeerIndex_None; slot = (slot + 1) % kPeerHashTableSize)
+    {
+        size_t homeSlot = HashNodeId(PeerStates.NodeId[PeerStates.HashTable[slot]]) % kPeerHashTableSize;
+
+        if (!IsCyclicallyBetween(emptySlot, homeSlot, slot))
+        {
+            PeerStates.HashTable[emptySlot] = PeerStates.HashTable[slot];
+            emptySlot = slot;
+        }
+    }
+
+    PeerStates.HashTable[emptySlot] = kPeerIndex_None;
+}
+
+void WeaveFabricState::UnlinkPeerEntry(PeerIndexType peerIndex)
+{
+    PeerIndexType moreRecent = PeerStates.MoreRecentlyUsed[peerIndex];
+    PeerIndexType lessRecent = PeerStates.LessRecentlyUsed[peerIndex];
+
+    if (moreRecent != kPeerIndex_None)
+        PeerStates.LessRecentlyUsed[moreRecent] = lessRecent;
+    else
+        PeerStates.MostRecentlyUsed = lessRecent;
+
+    if (lessRecent != kPeerIndex_None)
+        PeerStates.MoreRecentlyUsed[lessRecent] = moreRecent;
+    else
+        PeerStates.LeastRecentlyUsed = moreRecent;
+}
+
+void WeaveFabricState::MarkPeerEntryMostRecentlyUsed(PeerIndexType peerIndex)
+{
+    PeerStates.MoreRecentlyUsed[peerIndex] = kPeerIndex_None;
+    PeerStates.LessRecentlyUsed[peerIndex] = PeerStates.MostRecentlyUsed;
+
+    if (PeerStates.MostRecentlyUsed != kPeerIndex_None)
+        PeerStates.MoreRecentlyUsed[PeerStates.MostRecentlyUsed] = peerIndex;
+    else
+        PeerStates.LeastRecentlyUsed = peerIndex;
+
+    PeerStates.MostRecentlyUsed = peerIndex;
 }
 
 WEAVE_ERROR WeaveFabricState::GetPassword(uint8_t pwSrc, const char *& ps, uint16_t& pwLen)
@@ -925,6 +987,9 @@ WEAVE_ERROR WeaveFabricState::CreateFabric()
     err = GroupKeyStore->StoreGroupKey(fabricSecret);
     SuccessOrExit(err);
 
+    // Don't rely on the key store implementation to drop keys derived from a previous fabric secret.
+    GroupKeyStore->ClearKeyCache();
+
     if (Delegate != NULL)
         Delegate->DidJoinFabric(this, FabricId);
 
@@ -944,6 +1009,7 @@ void WeaveFabricState::ClearFabricState()
     oldFabricId = FabricId;
     FabricId = kFabricIdNotSpecified;
     GroupKeyStore->Clear();
+    GroupKeyStore->ClearKeyCache();
 
     if (oldFabricId != kFabricIdNotSpecified)
     {
@@ -1124,6 +1190,8 @@ WEAVE_ERROR WeaveFabricState::JoinExistingFabric(const uint8_t *fabricState, uin
 
                 err = GroupKeyStore->StoreGroupKey(fabricSecret);
                 SuccessOrExit(err);
+
+                GroupKeyStore->ClearKeyCache();
             }
 
             err = reader.Next(kTLVType_Structure, AnonymousTag);
@@ -1149,7 +1217,7 @@ void WeaveFabricState::HandleConnectionClosed(WeaveConnection *con)
     // Remove any session keys that are bound to the closed connection.
     for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
         if (SessionKeys[i].MsgEncKey.KeyId != WeaveKeyId::kNone && SessionKeys[i].BoundCon == con)
-            SessionKeys[i].Clear();
+            ClearSessionKey(&SessionKeys[i]);
 }
 
 // WeaveSessionState Members
@@ -1282,7 +1350,7 @@ bool WeaveSessionState::IsDuplicateMessage(uint32_t msgId)
         // and check if the message has already been received. If not, set the corresponding flag.
         if (delta <= kReceiveFlags_NumMessageIdFlags)
         {
-            ReceiveFlagsType mask = 1 << (delta - 1);
+            ReceiveFlagsType mask = static_cast<ReceiveFlagsType>(1) << (delta - 1);
             if ((msgIdFlags & mask) == 0)
                 msgIdFlags |= mask;
             else {
@@ -1336,8 +1404,7 @@ exit:
  */
 WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId, bool create, WeaveSessionKey *& retRec)
 {
-    WeaveSessionKey *curRec = SessionKeys;
-    WeaveSessionKey *freeRec = NULL;
+    WeaveSessionKey *curRec;
 
     if (!WeaveKeyId::IsSessionKey(keyId))
         return WEAVE_ERROR_WRONG_KEY_TYPE;
@@ -1345,13 +1412,20 @@ WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId
     if (peerNodeId == kNodeIdNotSpecified || peerNodeId == kAnyNodeId)
         return WEAVE_ERROR_INVALID_ARGUMENT;
 
-    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++, curRec++)
+    curRec = LookupSessionKey(keyId, peerNodeId);
+    if (curRec != NULL)
+    {
+        retRec = curRec;
+        return WEAVE_NO_ERROR;
+    }
+
+    // The peer may be an end node of a shared session, in which case the key is indexed under the
+    // terminating node.
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SHARED_SESSIONS_END_NODES; i++)
     {
-        if (curRec->MsgEncKey.KeyId == WeaveKeyId::kNone && freeRec == NULL)
-            freeRec = curRec;
-        if (curRec->MsgEncKey.KeyId == keyId && (curRec->NodeId == peerNodeId ||
-                                                 (curRec->SharedSession &&
-                                                  FindSharedSessionEndNode(peerNodeId, curRec))))
+        curRec = SharedSessionsNodes[i].SessionKey;
+        if (SharedSessionsNodes[i].EndNodeId == peerNodeId && curRec != NULL && curRec->SharedSession &&
+            curRec->MsgEncKey.KeyId == keyId)
         {
             retRec = curRec;
             return WEAVE_NO_ERROR;
@@ -1361,12 +1435,72 @@ WEAVE_ERROR WeaveFabricState::FindSessionKey(uint16_t keyId, uint64_t peerNodeId
     if (!create)
         return WEAVE_ERROR_KEY_NOT_FOUND;
 
-    if (freeRec == NULL)
-        return WEAVE_ERROR_TOO_MANY_KEYS;
+    curRec = SessionKeys;
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++, curRec++)
+    {
+        if (curRec->MsgEncKey.KeyId == WeaveKeyId::kNone)
+        {
+            retRec = curRec;
+            return WEAVE_NO_ERROR;
+        }
+    }
 
-    retRec = freeRec;
+    return WEAVE_ERROR_TOO_MANY_KEYS;
+}
 
-    return WEAVE_NO_ERROR;
+// Return the session key allocated for a key id and peer node, or NULL.
+WeaveSessionKey *WeaveFabricState::LookupSessionKey(uint16_t keyId, uint64_t peerNodeId) const
+{
+    for (size_t slot = HashNodeId(peerNodeId, keyId) % kSessionKeyHashTableSize; ; slot = (slot + 1) % kSessionKeyHashTableSize)
+    {
+        SessionKeyIndexType keyIndex = SessionKeyHashTable[slot];
+
+        if (keyIndex == kSessionKeyIndex_None)
+            return NULL;
+
+        if (SessionKeys[keyIndex].MsgEncKey.KeyId == keyId && SessionKeys[keyIndex].NodeId == peerNodeId)
+            return const_cast<WeaveSessionKey *>(&SessionKeys[keyIndex]);
+    }
+}
+
+void WeaveFabricState::AddSessionKeyToHashTable(const WeaveSessionKey *sessionKey)
+{
+    size_t slot = HashNodeId(sessionKey->NodeId, sessionKey->MsgEncKey.KeyId) % kSessionKeyHashTableSize;
+
+    while (SessionKeyHashTable[slot] != kSessionKeyIndex_None)
+        slot = (slot + 1) % kSessionKeyHashTableSize;
+
+    SessionKeyHashTable[slot] = static_cast<SessionKeyIndexType>(sessionKey - SessionKeys);
+}
+
+// Remove a session key from the hash table; see RemovePeerEntryFromHashTable().
+void WeaveFabricState::RemoveSessionKeyFromHashTable(const WeaveSessionKey *sessionKey)
+{
+    SessionKeyIndexType keyIndex = static_cast<SessionKeyIndexType>(sessionKey - SessionKeys);
+    size_t emptySlot = HashNodeId(sessionKey->NodeId, sessionKey->MsgEncKey.KeyId) % kSessionKeyHashTableSize;
+
+    while (SessionKeyHashTable[emptySlot] != keyIndex)
+        emptySlot = (emptySlot + 1) % kSessionKeyHashTableSize;
+
+    for (size_t slot = (emptySlot + 1) % kSessionKeyHashTableSize; SessionKeyHashTable[slot] != kSessionKeyIndex_None; slot = (slot + 1) % kSessionKeyHashTableSize)
+    {
+        const WeaveSessionKey& curRec = SessionKeys[SessionKeyHashTable[slot]];
+        size_t homeSlot = HashNodeId(curRec.NodeId, curRec.MsgEncKey.KeyId) % kSessionKeyHashTableSize;
+
+        if (!IsCyclicallyBetween(emptySlot, homeSlot, slot))
+        {
+            SessionKeyHashTable[emptySlot] = SessionKeyHashTable[slot];
+            emptySlot = slot;
+        }
+    }
+
+    SessionKeyHashTable[emptySlot] = kSessionKeyIndex_None;
+}
+
+void WeaveFabricState::ClearSessionKey(WeaveSessionKey *sessionKey)
+{
+    RemoveSessionKeyFromHashTable(sessionKey);
+    sessionKey->Clear();
 }
 
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
@@ -1374,6 +1508,9 @@ WEAVE_ERROR WeaveFabricState::FindMsgEncAppKey(uint16_t keyId, uint8_t encType,
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
+    // Drop cached keys if the group keys they were derived from have changed.
+    AppKeyCache.SyncWithKeyStore(GroupKeyStore->GetKeyCacheGeneration());
+
     // Find key or allocate empty key entry in the key cache.
     retRec = AppKeyCache.FindOrAllocateKeyEntry(keyId, encType);
 
@@ -1486,6 +1623,17 @@ void WeaveMsgEncryptionKeyCache::Reset()
     for (uint8_t keyEntry = 0; keyEntry < WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS; keyEntry++)
         Clear(keyEntry);
     memset(mMostRecentlyUsedKeyEntries, 0, sizeof(mMostRecentlyUsedKeyEntries));
+    mKeyCacheGeneration = 0;
+}
+
+// Clear the cache if the group key store key cache has been flushed since the cached keys were derived.
+void WeaveMsgEncryptionKeyCache::SyncWithKeyStore(uint32_t keyCacheGeneration)
+{
+    if (keyCacheGeneration != mKeyCacheGeneration)
+    {
+        Reset();
+        mKeyCacheGeneration = keyCacheGeneration;
+    }
 }
 
 // Clear key cache entry.
@@ -309,15 +309,18 @@ class WeaveSessionState
 {
 public:
 
-    typedef uint16_t ReceiveFlagsType;
+    // The top bit flags that the message id is synchronized; the remaining 63 bits form the sliding
+    // window of message ids received before the maximum id.
+    typedef uint64_t ReceiveFlagsType;
 
     enum
     {
-        kReceiveFlags_NumMessageIdFlags                 = (sizeof(ReceiveFlagsType) * 8) - 1,
-        kReceiveFlags_MessageIdSynchronized             = (1 << kReceiveFlags_NumMessageIdFlags),
-        kReceiveFlags_MessageIdFlagsMask                = ~kReceiveFlags_MessageIdSynchronized
+        kReceiveFlags_NumMessageIdFlags                 = (sizeof(ReceiveFlagsType) * 8) - 1
     };
 
+    static const ReceiveFlagsType kReceiveFlags_MessageIdSynchronized = (static_cast<ReceiveFlagsType>(1) << kReceiveFlags_NumMessageIdFlags);
+    static const ReceiveFlagsType kReceiveFlags_MessageIdFlagsMask = ~kReceiveFlags_MessageIdSynchronized;
+
     WeaveSessionState(void);
     WeaveSessionState(WeaveMsgEncryptionKey *msgEncKey, WeaveAuthMode authMode,
                       MonotonicallyIncreasingCounter *nextMsgId, uint32_t *maxRcvdMsgId, ReceiveFlagsType *rcvFlags);
@@ -361,12 +364,15 @@ public:
     void Shutdown(void);
 
     WeaveMsgEncryptionKey *FindOrAllocateKeyEntry(uint16_t keyId, uint8_t encType);
+    void SyncWithKeyStore(uint32_t keyCacheGeneration);
 
 private:
     // Array of Weave message encryption keys.
     WeaveMsgEncryptionKey mKeyCache[WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS];
     // Array of key entry indexes in sorted order from most- to least- recently used.
     uint8_t mMostRecentlyUsedKeyEntries[WEAVE_CONFIG_MAX_CACHED_MSG_ENC_APP_KEYS];
+    // Group key store key cache generation from which the cached keys were derived.
+    uint32_t mKeyCacheGeneration;
 
     void Clear(uint8_t keyEntryIndex);
 };
@@ -553,10 +559,29 @@ public:
 #endif // WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
 
 private:
+#if WEAVE_CONFIG_MAX_SESSION_KEYS <= UINT8_MAX
+    typedef uint8_t SessionKeyIndexType;
+#else
+    typedef uint16_t SessionKeyIndexType;
+#endif
+
+    enum
+    {
+        kPeerIndex_None                                 = (WEAVE_CONFIG_MAX_PEER_NODES <= UINT8_MAX) ? UINT8_MAX : UINT16_MAX,
+        kSessionKeyIndex_None                           = (WEAVE_CONFIG_MAX_SESSION_KEYS <= UINT8_MAX) ? UINT8_MAX : UINT16_MAX,
+
+        // Sizes of the open-addressing hash tables that index peer states and session keys. Twice the
+        // number of entries keeps probe sequences short and guarantees every probe ends at an empty slot.
+        kPeerHashTableSize                              = 2 * WEAVE_CONFIG_MAX_PEER_NODES,
+        kSessionKeyHashTableSize                        = 2 * WEAVE_CONFIG_MAX_SESSION_KEYS
+    };
+
     PeerIndexType PeerCount;
     MonotonicallyIncreasingCounter NextUnencUDPMsgId;
     MonotonicallyIncreasingCounter NextUnencTCPMsgId;
     WeaveSessionKey SessionKeys[WEAVE_CONFIG_MAX_SESSION_KEYS];
+    // Hash table from (key id, peer node id) to index in SessionKeys, by linear probing.
+    SessionKeyIndexType SessionKeyHashTable[kSessionKeyHashTableSize];
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     PersistedCounter NextGroupKeyMsgId;
 
@@ -589,8 +614,13 @@ private:
         WeaveSessionState::ReceiveFlagsType GroupKeyRcvFlags[WEAVE_CONFIG_MAX_PEER_NODES];
 #endif
         WeaveSessionState::ReceiveFlagsType UnencRcvFlags[WEAVE_CONFIG_MAX_PEER_NODES];
-        // Array of peer indexes in sorted order from most- to least- recently used.
-        PeerIndexType MostRecentlyUsedIndexes[WEAVE_CONFIG_MAX_PEER_NODES];
+        // Doubly-linked list of peer entries in order from most- to least- recently used.
+        PeerIndexType MoreRecentlyUsed[WEAVE_CONFIG_MAX_PEER_NODES];
+        PeerIndexType LessRecentlyUsed[WEAVE_CONFIG_MAX_PEER_NODES];
+        PeerIndexType MostRecentlyUsed;
+        PeerIndexType LeastRecentlyUsed;
+        // Hash table from peer node id to peer index, by linear probing.
+        PeerIndexType HashTable[kPeerHashTableSize];
     } PeerStates;
     FabricStateDelegate *Delegate;
 
@@ -603,14 +633,22 @@ private:
     // Record of all active shared session end nodes.
     SharedSessionEndNode SharedSessionsNodes[WEAVE_CONFIG_MAX_SHARED_SESSIONS_END_NODES];
 
-    bool FindSharedSessionEndNode(uint64_t endNodeId, const WeaveSessionKey *sessionKey);
-
 #if WEAVE_CONFIG_USE_APP_GROUP_KEYS_FOR_MSG_ENC
     void StartMsgCounterSyncTimer(void);
     static void OnMsgCounterSyncRespTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
 #endif
 
     bool FindOrAllocPeerEntry(uint64_t peerNodeId, bool allocEntry, PeerIndexType& retPeerIndex);
+    PeerIndexType LookupPeerEntry(uint64_t peerNodeId) const;
+    void AddPeerEntryToHashTable(PeerIndexType peerIndex);
+    void RemovePeerEntryFromHashTable(PeerIndexType peerIndex);
+    void UnlinkPeerEntry(PeerIndexType peerIndex);
+    void MarkPeerEntryMostRecentlyUsed(PeerIndexType peerIndex);
+
+    WeaveSessionKey *LookupSessionKey(uint16_t keyId, uint64_t peerNodeId) const;
+    void AddSessionKeyToHashTable(const WeaveSessionKey *sessionKey);
+    void RemoveSessionKeyFromHashTable(const WeaveSessionKey *sessionKey);
+    void ClearSessionKey(WeaveSessionKey *sessionKey);
     WEAVE_ERROR FindMsgEncAppKey(uint16_t keyId, uint8_t encType, WeaveMsgEncryptionKey *& retRec);
     WEAVE_ERROR DeriveMsgEncAppKey(uint32_t keyId, uint8_t encType, WeaveMsgEncryptionKey & appKey, uint32_t& appGroupGlobalId);
 };
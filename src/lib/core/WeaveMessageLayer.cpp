@@ -48,6 +48,7 @@
 #include <Weave/Support/ErrorStr.h>
 #include <Weave/Support/CodeUtils.h>
 #include <Weave/Support/WeaveFaultInjection.h>
+#include <SystemLayer/SystemStats.h>
 
 
 namespace nl {
@@ -199,6 +200,12 @@ WEAVE_ERROR WeaveMessageLayer::Init(InitContext *context)
     if (res != WEAVE_NO_ERROR)
         goto done;
 
+    // Where the InetLayer tracks interface changes, keep the per-address endpoints current as
+    // addresses come and go, rather than waiting for the application to call RefreshEndpoints().
+    res = Inet->AddInterfaceChangeHandler(HandleInterfaceChange, this);
+    if (res == INET_ERROR_NOT_IMPLEMENTED)
+        res = WEAVE_NO_ERROR;
+
 done:
     if (res != WEAVE_NO_ERROR)
         Shutdown();
@@ -219,6 +226,9 @@ done:
  */
 WEAVE_ERROR WeaveMessageLayer::Shutdown()
 {
+    if (Inet != NULL)
+        Inet->RemoveInterfaceChangeHandler(HandleInterfaceChange, this);
+
     CloseEndpoints();
 
     State = kState_NotInitialized;
@@ -1158,6 +1168,8 @@ WEAVE_ERROR WeaveMessageLayer::EncodeMessage(WeaveMessageInfo *msgInfo, PacketBu
         return WEAVE_NO_ERROR;
     }
 
+    SYSTEM_STATS_HISTOGRAM_TIMER(nl::Weave::System::Stats::kHistogram_MessageEncodeTime);
+
     // Compute the number of bytes that will appear before and after the message payload
     // in the final encoded message.
     uint16_t headLen = 6;
@@ -1307,6 +1319,8 @@ WEAVE_ERROR WeaveMessageLayer::DecodeMessage(PacketBuffer *msgBuf, uint64_t sour
     uint16_t msgLen = msgBuf->DataLength();
     uint8_t *msgEnd = msgStart + msgLen;
     uint8_t *p = msgStart;
+    SYSTEM_STATS_HISTOGRAM_TIMER(nl::Weave::System::Stats::kHistogram_MessageDecodeTime);
+
     msgInfo->SourceNodeId = sourceNodeId;
     err = DecodeHeader(msgBuf, msgInfo, &p);
     sourceNodeId = msgInfo->SourceNodeId;
@@ -1749,16 +1763,6 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
         mIPv6UDP = NULL;
     }
 
-    // Close and free all the currently open IPv6 interface endpoints. We will re-create them
-    // below based on the current network interface config.
-    for (int i = 0; i < WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS; i++)
-        if (mIPv6UDPLocalAddr[i] != NULL)
-        {
-            if (mIPv6UDPLocalAddr[i] != mIPv6UDP)
-                mIPv6UDPLocalAddr[i]->Free();
-            mIPv6UDPLocalAddr[i] = NULL;
-        }
-
     // Clear the list of interfaces.
     memset(mInterfaces, 0, sizeof(mInterfaces));
 
@@ -1970,6 +1974,14 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
     // If configured to use a specific IPv6 address...
     if (IsBoundToLocalIPv6Address())
     {
+        // Close any IPv6 interface endpoints left from listening on all addresses.
+        for (int i = 0; i < WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS; i++)
+            if (mIPv6UDPLocalAddr[i] != NULL)
+            {
+                mIPv6UDPLocalAddr[i]->Free();
+                mIPv6UDPLocalAddr[i] = NULL;
+            }
+
         // If IPv6 listening has been enabled, create a IPv6 UDP endpoint for receiving multicast messages.
         // Bind this interface to the link-local, all-nodes multicast address (ff02::1) and the interface
         // associated with the listening IPv6 address.
@@ -2010,108 +2022,313 @@ WEAVE_ERROR WeaveMessageLayer::RefreshEndpoints()
 #endif // WEAVE_CONFIG_ENABLE_TARGETED_LISTEN
 
     {
-        uint16_t epCount = 0;
-        uint16_t i;
+        res = RefreshLocalAddrEndpoints();
+        if (res != WEAVE_NO_ERROR)
+            goto exit;
+    }
 
-        // Scan the list of addresses assigned to the system's network interfaces.  For each address...
-        for (InterfaceAddressIterator addrIter; addrIter.HasCurrent(); addrIter.Next())
+#if CONFIG_NETWORK_LAYER_BLE
+    if (listenBLE)
+    {
+        if (mBle != NULL)
         {
-            InterfaceId curIntfId = addrIter.GetInterface();
-
-#if WEAVE_BIND_DETAIL_LOGGING && WEAVE_DETAIL_LOGGING
-            GetInterfaceName(curIntfId, intfStr, sizeof(intfStr));
+            mBle->mAppState = this;
+            mBle->OnWeaveBleConnectReceived = HandleIncomingBleConnection;
+        }
+        else
+            WeaveLogError(ExchangeManager, "Cannot listen for BLE connections, null BleLayer");
+    }
 #endif
 
-            // Skip any interface that doesn't support multicast.
-            if (!addrIter.SupportsMulticast())
-                continue;
+exit:
+    if (res != WEAVE_NO_ERROR)
+        WeaveBindLog("RefreshEndpoints failed: %ld", (long)res);
+    return res;
+}
 
-            // Add the interface to the interface list if it doesn't already exist.
-            for (i = 0; i < WEAVE_CONFIG_MAX_INTERFACES; i++)
+/**
+ *  Bring the IPv6 interface endpoints in line with the addresses currently assigned to the system's
+ *  network interfaces.
+ *
+ *  An endpoint is kept for as long as its address remains assigned, so only the addresses that
+ *  appeared or disappeared since the last call cost any socket operations. The interface table is
+ *  rebuilt as well.
+ *
+ *  @retval #WEAVE_NO_ERROR on success.
+ *  @retval InetLayer errors based on calls to create UDP endpoints.
+ *
+ */
+WEAVE_ERROR WeaveMessageLayer::RefreshLocalAddrEndpoints()
+{
+    WEAVE_ERROR res = WEAVE_NO_ERROR;
+    bool inUse[WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS] = { false };
+    uint16_t i;
+
+    memset(mInterfaces, 0, sizeof(mInterfaces));
+
+    // Scan the list of addresses assigned to the system's network interfaces, noting the interfaces
+    // and the endpoints still bound to an eligible address.
+    for (InterfaceAddressIterator addrIter; addrIter.HasCurrent(); addrIter.Next())
+    {
+        InterfaceId curIntfId = addrIter.GetInterface();
+
+        // Skip any interface that doesn't support multicast.
+        if (!addrIter.SupportsMulticast())
+            continue;
+
+        AddInterface(curIntfId);
+
+        IPAddress curAddr = addrIter.GetAddress();
+        if (!IsLocalAddrEndpointAddress(curAddr))
+            continue;
+
+        for (i = 0; i < WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS; i++)
+            if (mIPv6UDPLocalAddr[i] != NULL && mIPv6LocalAddrs[i] == curAddr &&
+                mIPv6UDPLocalAddr[i]->GetBoundInterface() == curIntfId)
             {
-                if (mInterfaces[i] == curIntfId)
-                    break;
-                if (mInterfaces[i] == INET_NULL_INTERFACEID)
-                {
-                    WeaveBindLog("Adding %s to interface table", intfStr);
-                    mInterfaces[i] = curIntfId;
-                    break;
-                }
+                inUse[i] = true;
+                break;
             }
-            if (i == WEAVE_CONFIG_MAX_INTERFACES)
-                WeaveLogError(MessageLayer, "Interface table full");
+    }
 
-            // If we haven't exceeded the max ULA endpoints...
-            if (epCount < WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS)
-            {
-                WEAVE_ERROR epErr;
-                UDPEndPoint *& ep = mIPv6UDPLocalAddr[epCount];
+    // Close the endpoints whose address is gone, or no longer eligible.
+    for (i = 0; i < WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS; i++)
+        if (mIPv6UDPLocalAddr[i] != NULL && !inUse[i])
+            CloseLocalAddrEndpoint(i);
+
+    // Create endpoints for the eligible addresses that don't have one yet, while there is room.
+    for (InterfaceAddressIterator addrIter; addrIter.HasCurrent(); addrIter.Next())
+    {
+        if (!addrIter.SupportsMulticast() || !IsLocalAddrEndpointAddress(addrIter.GetAddress()))
+            continue;
+
+        res = OpenLocalAddrEndpoint(addrIter.GetInterface(), addrIter.GetAddress());
+        if (res != WEAVE_NO_ERROR)
+            break;
+    }
 
-                // Skip the address if it is not a ULA.
-                IPAddress curAddr = addrIter.GetAddress();
-                if (!curAddr.IsIPv6ULA())
-                    continue;
+    return res;
+}
 
-                // Skip the address if we're a member of a fabric and the ULA is not a fabric address
-                // (in particular, the global identifier in the ULA does not match the bottom 40 bits of the
-                // fabric id).
-                if (FabricState->FabricId != 0 && !FabricState->IsFabricAddress(curAddr))
-                    continue;
+/**
+ *  Open an IPv6 interface endpoint bound to the given address, unless one is already open or all
+ *  the endpoint slots are in use.
+ *
+ *  @retval #WEAVE_NO_ERROR on success, or if the address could not be bound.
+ *  @retval InetLayer errors based on calls to create UDP endpoints.
+ *
+ */
+WEAVE_ERROR WeaveMessageLayer::OpenLocalAddrEndpoint(InterfaceId intfId, const IPAddress &addr)
+{
+    WEAVE_ERROR res = WEAVE_NO_ERROR;
+    WEAVE_ERROR epErr;
+    int freeIndex = -1;
 
 #if WEAVE_BIND_DETAIL_LOGGING && WEAVE_DETAIL_LOGGING
-                curAddr.ToString(ipAddrStr, sizeof(ipAddrStr));
-                WeaveBindLog("Binding IPv6 UDP interface endpoint to [%s]:%d (%s)", ipAddrStr, WEAVE_PORT, intfStr);
+    char ipAddrStr[64];
+    char intfStr[64];
 #endif
 
-                // Create an IPv6 UDP endpoint to be used for sending/receiving messages over the associated interface.
-                res = Inet->NewUDPEndPoint(&ep);
-                if (res != WEAVE_NO_ERROR)
-                    goto exit;
+    for (int i = 0; i < WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS; i++)
+    {
+        if (mIPv6UDPLocalAddr[i] == NULL)
+        {
+            if (freeIndex < 0)
+                freeIndex = i;
+        }
+        else if (mIPv6LocalAddrs[i] == addr && mIPv6UDPLocalAddr[i]->GetBoundInterface() == intfId)
+            return WEAVE_NO_ERROR;
+    }
+    if (freeIndex < 0)
+        return WEAVE_NO_ERROR;
 
-                // Bind the endpoint to the identified address.  This ensures that messages sent over the endpoint
-                // have the correct source address and port.
-                epErr = ep->Bind(kIPAddressType_IPv6, curAddr, WEAVE_PORT, curIntfId);
+    UDPEndPoint *& ep = mIPv6UDPLocalAddr[freeIndex];
 
-                // Enable reception of incoming messages.
-                WeaveBindLog("Listening on IPv6 UDP interface endpoint");
-                if (epErr == WEAVE_NO_ERROR)
-                {
-                    ep->AppState = this;
-                    ep->OnMessageReceived = HandleUDPMessage;
-                    ep->OnReceiveError = HandleUDPReceiveError;
-                    epErr = ep->Listen();
-                }
+#if WEAVE_BIND_DETAIL_LOGGING && WEAVE_DETAIL_LOGGING
+    GetInterfaceName(intfId, intfStr, sizeof(intfStr));
+    addr.ToString(ipAddrStr, sizeof(ipAddrStr));
+    WeaveBindLog("Binding IPv6 UDP interface endpoint to [%s]:%d (%s)", ipAddrStr, WEAVE_PORT, intfStr);
+#endif
 
-                // If we successfully bound the endpoint, add it to the list. Otherwise, discard it and move on to
-                // the next address.
-                if (epErr == WEAVE_NO_ERROR)
-                    epCount++;
-                else
-                {
-                    ep->Free();
-                    ep = NULL;
-                }
-            }
-        }
+    // Create an IPv6 UDP endpoint to be used for sending/receiving messages over the associated interface.
+    res = Inet->NewUDPEndPoint(&ep);
+    if (res != WEAVE_NO_ERROR)
+        goto exit;
+
+    // Bind the endpoint to the identified address.  This ensures that messages sent over the endpoint
+    // have the correct source address and port.
+    epErr = ep->Bind(kIPAddressType_IPv6, addr, WEAVE_PORT, intfId);
+
+    // Enable reception of incoming messages.
+    WeaveBindLog("Listening on IPv6 UDP interface endpoint");
+    if (epErr == WEAVE_NO_ERROR)
+    {
+        ep->AppState = this;
+        ep->OnMessageReceived = HandleUDPMessage;
+        ep->OnReceiveError = HandleUDPReceiveError;
+        epErr = ep->Listen();
     }
 
-#if CONFIG_NETWORK_LAYER_BLE
-    if (listenBLE)
+    // If we successfully bound the endpoint, keep it. Otherwise, discard it; the caller moves on to the
+    // next address.
+    if (epErr == WEAVE_NO_ERROR)
+        mIPv6LocalAddrs[freeIndex] = addr;
+    else
     {
-        if (mBle != NULL)
+        ep->Free();
+        ep = NULL;
+    }
+
+exit:
+    return res;
+}
+
+void WeaveMessageLayer::CloseLocalAddrEndpoint(int index)
+{
+#if WEAVE_BIND_DETAIL_LOGGING && WEAVE_DETAIL_LOGGING
+    char ipAddrStr[64];
+    mIPv6LocalAddrs[index].ToString(ipAddrStr, sizeof(ipAddrStr));
+    WeaveBindLog("Closing IPv6 UDP interface endpoint for [%s]", ipAddrStr);
+#endif
+
+    if (mIPv6UDPLocalAddr[index] != mIPv6UDP)
+        mIPv6UDPLocalAddr[index]->Free();
+    mIPv6UDPLocalAddr[index] = NULL;
+}
+
+/**
+ *  Add an interface to the interface table, if it isn't there already.
+ */
+void WeaveMessageLayer::AddInterface(InterfaceId intfId)
+{
+    int i;
+
+#if WEAVE_BIND_DETAIL_LOGGING && WEAVE_DETAIL_LOGGING
+    char intfStr[64];
+    GetInterfaceName(intfId, intfStr, sizeof(intfStr));
+#endif
+
+    for (i = 0; i < WEAVE_CONFIG_MAX_INTERFACES; i++)
+    {
+        if (mInterfaces[i] == intfId)
+            break;
+        if (mInterfaces[i] == INET_NULL_INTERFACEID)
         {
-            mBle->mAppState = this;
-            mBle->OnWeaveBleConnectReceived = HandleIncomingBleConnection;
+            WeaveBindLog("Adding %s to interface table", intfStr);
+            mInterfaces[i] = intfId;
+            break;
         }
-        else
-            WeaveLogError(ExchangeManager, "Cannot listen for BLE connections, null BleLayer");
     }
+    if (i == WEAVE_CONFIG_MAX_INTERFACES)
+        WeaveLogError(MessageLayer, "Interface table full");
+}
+
+/**
+ *  Remove an interface from the interface table, keeping the table packed.
+ */
+void WeaveMessageLayer::RemoveInterface(InterfaceId intfId)
+{
+    int i, j;
+
+    for (i = 0, j = 0; i < WEAVE_CONFIG_MAX_INTERFACES; i++)
+        if (mInterfaces[i] != intfId)
+            mInterfaces[j++] = mInterfaces[i];
+    for (; j < WEAVE_CONFIG_MAX_INTERFACES; j++)
+        mInterfaces[j] = INET_NULL_INTERFACEID;
+}
+
+/**
+ *  Check whether an interface address gets its own IPv6 UDP endpoint: it must be a ULA and, once
+ *  the node is a member of a fabric, a fabric address (i.e. the global identifier in the ULA must
+ *  match the bottom 40 bits of the fabric id).
+ */
+bool WeaveMessageLayer::IsLocalAddrEndpointAddress(const IPAddress &addr) const
+{
+    if (!addr.IsIPv6ULA())
+        return false;
+
+    return FabricState->FabricId == 0 || FabricState->IsFabricAddress(addr);
+}
+
+/**
+ *  Apply a change to the system's network interfaces reported by the InetLayer. Added and removed
+ *  addresses, and removed interfaces, only open or close the endpoints concerned; other changes may
+ *  affect any address, and lead to a full refresh of the interface endpoints.
+ */
+void WeaveMessageLayer::HandleInterfaceChange(void *appState, InterfaceChangeType changeType, InterfaceId intfId,
+    const IPAddress &addr)
+{
+    WeaveMessageLayer *msgLayer = static_cast<WeaveMessageLayer *>(appState);
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool endpointsFull = true;
+    bool closedEndpoint = false;
+
+    if (msgLayer->State != kState_Initialized)
+        return;
+
+#if WEAVE_CONFIG_ENABLE_TARGETED_LISTEN
+    // When bound to a specific address, the endpoints are only refreshed by RefreshEndpoints().
+    if (msgLayer->IsBoundToLocalIPv6Address())
+        return;
 #endif
 
-exit:
-    if (res != WEAVE_NO_ERROR)
-        WeaveBindLog("RefreshEndpoints failed: %ld", (long)res);
-    return res;
+    for (int i = 0; i < WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS; i++)
+        if (msgLayer->mIPv6UDPLocalAddr[i] == NULL)
+            endpointsFull = false;
+
+    switch (changeType)
+    {
+    case kInterfaceChange_InterfaceAdded:
+        // A new interface has no addresses yet; those are reported separately.
+        break;
+
+    case kInterfaceChange_AddressAdded:
+        if (!InterfaceSupportsMulticast(intfId))
+            break;
+
+        msgLayer->AddInterface(intfId);
+
+        if (msgLayer->IsLocalAddrEndpointAddress(addr))
+            err = msgLayer->OpenLocalAddrEndpoint(intfId, addr);
+        break;
+
+    case kInterfaceChange_AddressRemoved:
+    case kInterfaceChange_InterfaceRemoved:
+        for (int i = 0; i < WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS; i++)
+            if (msgLayer->mIPv6UDPLocalAddr[i] != NULL && msgLayer->mIPv6UDPLocalAddr[i]->GetBoundInterface() == intfId &&
+                (changeType == kInterfaceChange_InterfaceRemoved || msgLayer->mIPv6LocalAddrs[i] == addr))
+            {
+                msgLayer->CloseLocalAddrEndpoint(i);
+                closedEndpoint = true;
+            }
+
+        // An interface left without addresses stays in the interface table until the next full refresh.
+        if (changeType == kInterfaceChange_InterfaceRemoved)
+            msgLayer->RemoveInterface(intfId);
+
+        // An address that found no free endpoint slot may take the one just released.
+        if (closedEndpoint && endpointsFull)
+            err = msgLayer->RefreshLocalAddrEndpoints();
+        break;
+
+    default:
+        // The flags of an interface, e.g. its multicast support, may have changed, or the changes
+        // were not tracked; check every address.
+        err = msgLayer->RefreshLocalAddrEndpoints();
+        break;
+    }
+
+    if (err != WEAVE_NO_ERROR)
+        WeaveLogError(MessageLayer, "Refreshing interface endpoints failed: %s", ErrorStr(err));
+}
+
+bool WeaveMessageLayer::InterfaceSupportsMulticast(InterfaceId intfId)
+{
+    for (InterfaceIterator intfIter; intfIter.HasCurrent(); intfIter.Next())
+        if (intfIter.GetInterface() == intfId)
+            return intfIter.SupportsMulticast();
+
+    return false;
 }
 
 void WeaveMessageLayer::Encrypt_AES128CTRSHA1(const WeaveMessageInfo *msgInfo, const uint8_t *key,
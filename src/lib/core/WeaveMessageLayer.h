@@ -243,13 +243,15 @@ public:
 
     WEAVE_ERROR GetPeerAddressInfo(IPPacketInfo& addrInfo);
 
-    WEAVE_ERROR SendMessage(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
+    WEAVE_ERROR SendMessage(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf, bool push = true);
 #if WEAVE_CONFIG_ENABLE_TUNNELING
 /**
  * Function to send a Tunneled packet over a Weave connection.
  */
-    WEAVE_ERROR SendTunneledMessage(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf);
+    WEAVE_ERROR SendTunneledMessage(WeaveMessageInfo *msgInfo, PacketBuffer *msgBuf, bool push = true);
 #endif
+    WEAVE_ERROR PushSendQueue(void);
+    uint32_t PendingSendLength(void);
 
     // TODO COM-311: implement EnableReceived/DisableReceive for BLE WeaveConnections.
     void EnableReceive(void);
@@ -337,6 +339,23 @@ public:
     typedef void (*ReceiveErrorFunct)(WeaveConnection *con, WEAVE_ERROR err);
     ReceiveErrorFunct OnReceiveError;
 
+    /**
+     *  This function is the application callback invoked when data queued on a TCP-based Weave connection has
+     *  been taken by the underlying transport, i.e. written to the socket or acknowledged by the peer when
+     *  running over LwIP. Applications can use it to pace their sends against PendingSendLength().
+     *
+     *  @note
+     *    Messages sent from within this callback are transmitted by the transport once the callback
+     *    returns; the callback must not call PushSendQueue().
+     *
+     *  @param[in]     con            A pointer to the WeaveConnection object.
+     *
+     *  @param[in]     len            The number of bytes taken by the transport.
+     *
+     */
+    typedef void (*DataSentFunct)(WeaveConnection *con, uint16_t len);
+    DataSentFunct OnDataSent;
+
 private:
     enum
     {
@@ -366,6 +385,7 @@ private:
     static void HandleConnectComplete(TCPEndPoint *endPoint, INET_ERROR conRes);
     static void HandleDataReceived(TCPEndPoint *endPoint, PacketBuffer *data);
     static void HandleTcpConnectionClosed(TCPEndPoint *endPoint, INET_ERROR err);
+    static void HandleTcpDataSent(TCPEndPoint *endPoint, uint16_t len);
     static void HandleSecureSessionEstablished(WeaveSecurityManager *sm, WeaveConnection *con, void *reqState, uint16_t sessionKeyId, uint64_t peerNodeId, uint8_t encType);
     static void HandleSecureSessionError(WeaveSecurityManager *sm, WeaveConnection *con, void *reqState, WEAVE_ERROR localErr, uint64_t peerNodeId,
                                          Profiles::StatusReporting::StatusReport *statusReport);
@@ -663,6 +683,7 @@ private:
     TCPEndPoint *mIPv6TCPListen;
     UDPEndPoint *mIPv6UDP;
     UDPEndPoint *mIPv6UDPLocalAddr[WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS];
+    IPAddress mIPv6LocalAddrs[WEAVE_CONFIG_MAX_LOCAL_ADDR_UDP_ENDPOINTS]; // Address each mIPv6UDPLocalAddr endpoint is bound to.
     InterfaceId mInterfaces[WEAVE_CONFIG_MAX_INTERFACES];
     WeaveConnection mConPool[WEAVE_CONFIG_MAX_CONNECTIONS]; // TODO: rename to mConPool
     WeaveConnectionTunnel mTunnelPool[WEAVE_CONFIG_MAX_TUNNELS];
@@ -690,6 +711,16 @@ private:
     WEAVE_ERROR DisableUnsecuredListen(void);
     bool IsUnsecuredListenEnabled(void) const;
 
+    WEAVE_ERROR RefreshLocalAddrEndpoints(void);
+    WEAVE_ERROR OpenLocalAddrEndpoint(InterfaceId intfId, const IPAddress &addr);
+    void CloseLocalAddrEndpoint(int index);
+    bool IsLocalAddrEndpointAddress(const IPAddress &addr) const;
+    void AddInterface(InterfaceId intfId);
+    void RemoveInterface(InterfaceId intfId);
+    static bool InterfaceSupportsMulticast(InterfaceId intfId);
+    static void HandleInterfaceChange(void *appState, InterfaceChangeType changeType, InterfaceId intfId,
+        const IPAddress &addr);
+
     WEAVE_ERROR SendMessage(const IPAddress &destAddr, uint16_t destPort, InterfaceId sendIntfId, PacketBuffer *payload, uint16_t udpSendFlags);
     WEAVE_ERROR SelectDestNodeIdAndAddress(uint64_t& destNodeId, IPAddress& destAddr);
     WEAVE_ERROR DecodeMessage(PacketBuffer *msgBuf, uint64_t sourceNodeId, WeaveConnection *con,
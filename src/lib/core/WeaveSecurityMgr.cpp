@@ -36,6 +36,7 @@
 #include <Weave/Profiles/status-report/StatusReportProfile.h>
 #include <Weave/Profiles/service-directory/ServiceDirectory.h>
 #include <Weave/Support/crypto/WeaveCrypto.h>
+#include <Weave/Support/crypto/ECDHKeyPool.h>
 #include <Weave/Support/WeaveFaultInjection.h>
 
 namespace nl {
@@ -146,6 +147,15 @@ WEAVE_ERROR WeaveSecurityManager::Init(WeaveExchangeManager& aExchangeMgr, Syste
 
     State = kState_Idle;
 
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0 && (WEAVE_CONFIG_ENABLE_CASE_INITIATOR || WEAVE_CONFIG_ENABLE_CASE_RESPONDER)
+    // Warm the ECDH key pool for the default CASE curve. Other curves claim entries as they are used.
+    for (int i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE; i++)
+        ECDHKeyPool::Reserve(WeaveCurveIdToOID(WEAVE_CONFIG_DEFAULT_CASE_CURVE_ID));
+#endif
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+    ScheduleECDHKeyPoolRefill();
+#endif
+
 exit:
     return err;
 }
@@ -171,6 +181,11 @@ WEAVE_ERROR WeaveSecurityManager::Shutdown(void)
 
         Reset();
 
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+        mSystemLayer->CancelTimer(HandleECDHKeyPoolRefill, this);
+        ECDHKeyPool::Clear();
+#endif
+
         State = kState_NotInitialized;
     }
 
@@ -3159,8 +3174,44 @@ void WeaveSecurityManager::Reset(void)
     mStartSecureSession_OnComplete = NULL;
     mStartSecureSession_OnError = NULL;
     mStartSecureSession_ReqState = NULL;
+
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+    // Replace any ECDH keys the finished session took from the pool.
+    ScheduleECDHKeyPoolRefill();
+#endif
+}
+
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+
+void WeaveSecurityManager::ScheduleECDHKeyPoolRefill(void)
+{
+    if (ECDHKeyPool::NeedsRefill())
+    {
+        mSystemLayer->StartTimer(0, HandleECDHKeyPoolRefill, this);
+    }
 }
 
+/**
+ * Generate one pool key per turn of the event loop while no session is being established, so that
+ * refilling never delays a handshake by more than a single key generation.
+ */
+void WeaveSecurityManager::HandleECDHKeyPoolRefill(System::Layer* aSystemLayer, void* aAppState, System::Error aError)
+{
+    WeaveSecurityManager* securityMgr = reinterpret_cast<WeaveSecurityManager*>(aAppState);
+
+    // A session in progress reschedules the refill when it ends.
+    VerifyOrExit(securityMgr->State == kState_Idle, );
+
+    SuccessOrExit(ECDHKeyPool::Refill());
+
+    securityMgr->ScheduleECDHKeyPoolRefill();
+
+exit:
+    return;
+}
+
+#endif // WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+
 void WeaveSecurityManager::StartSessionTimer(void)
 {
     WeaveLogProgress(SecurityManager, "%s", __FUNCTION__);
@@ -411,6 +411,11 @@ private:
     void CancelSessionTimer(void);
     static void HandleSessionTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
 
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+    void ScheduleECDHKeyPoolRefill(void);
+    static void HandleECDHKeyPoolRefill(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
+#endif
+
     static void HandleUnsolicitedMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
             uint32_t profileId, uint8_t msgType, PacketBuffer *msgBuf);
 
@@ -33,8 +33,20 @@ namespace nl {
 namespace Weave {
 namespace Stats {
 
+using namespace nl::Weave::TLV;
+
 static WeaveMessageLayer *sMessageLayer;
 
+static const char *sCounterStrings[kNumCounters] =
+{
+    "ExchangeMgr_WRMPRetransmissions",
+    "ExchangeMgr_WRMPSendFailures",
+    "Stats_MessageCountersOverflow",
+};
+
+static uint32_t sCounters[kNumCounters];
+static MessageCounter sMessageCounters[WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS];
+
 /**
  * Registers weave objects with the stats infra.
  *
@@ -67,6 +79,283 @@ void UpdateSnapshot(nl::Weave::System::Stats::Snapshot &aSnapshot)
     }
 }
 
+/**
+ * Finds, or allocates, the counter of a profile and message type.
+ *
+ * @return The counter, or NULL if all the counters are taken by other
+ *         profile and message type pairs.
+ */
+static MessageCounter *FindMessageCounter(uint32_t aProfileId, uint8_t aMsgType)
+{
+    const size_t kNumMessageCounters = WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS;
+    size_t index = ((aProfileId * 31) + aMsgType) % kNumMessageCounters;
+
+    // Counters are never freed, except all at once; probe linearly from the hashed slot
+    for (size_t i = 0; i < kNumMessageCounters; i++)
+    {
+        MessageCounter &counter = sMessageCounters[index];
+
+        if (!counter.mIsInUse)
+        {
+            counter.mIsInUse = true;
+            counter.mProfileId = aProfileId;
+            counter.mMsgType = aMsgType;
+            return &counter;
+        }
+
+        if (counter.mProfileId == aProfileId && counter.mMsgType == aMsgType)
+        {
+            return &counter;
+        }
+
+        index = (index + 1) % kNumMessageCounters;
+    }
+
+    sCounters[kCounter_MessageCountersOverflow]++;
+
+    return NULL;
+}
+
+/**
+ * Counts a message sent.
+ *
+ * @param[in] aProfileId    The profile of the message.
+ * @param[in] aMsgType      The type of the message.
+ */
+void CountMessageSent(uint32_t aProfileId, uint8_t aMsgType)
+{
+    MessageCounter *counter = FindMessageCounter(aProfileId, aMsgType);
+
+    if (counter != NULL)
+    {
+        counter->mNumSent++;
+    }
+}
+
+/**
+ * Counts a message received.
+ *
+ * @param[in] aProfileId        The profile of the message.
+ * @param[in] aMsgType          The type of the message.
+ * @param[in] aDispatchTimeUsec The time it took to dispatch the message
+ *                              to its handler, in microseconds.
+ */
+void CountMessageReceived(uint32_t aProfileId, uint8_t aMsgType, uint32_t aDispatchTimeUsec)
+{
+    MessageCounter *counter = FindMessageCounter(aProfileId, aMsgType);
+
+    if (counter != NULL)
+    {
+        counter->mNumReceived++;
+        counter->mDispatchTimeUsec += aDispatchTimeUsec;
+    }
+}
+
+uint32_t *GetCounters(void)
+{
+    return sCounters;
+}
+
+const char **GetCounterStrings(void)
+{
+    return sCounterStrings;
+}
+
+/**
+ * Copies out the message counters in use.
+ *
+ * @param[out] aCounters        The array receiving the counters.
+ * @param[in]  aMaxCounters     The size of @a aCounters.
+ *
+ * @return The number of counters copied.
+ */
+size_t GetMessageCounters(MessageCounter *aCounters, size_t aMaxCounters)
+{
+    size_t numCounters = 0;
+
+    for (size_t i = 0; i < WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS && numCounters < aMaxCounters; i++)
+    {
+        if (sMessageCounters[i].mIsInUse)
+        {
+            aCounters[numCounters++] = sMessageCounters[i];
+        }
+    }
+
+    return numCounters;
+}
+
+/**
+ * Resets the histograms, the message counters, and the event counters.
+ */
+void ResetCounters(void)
+{
+    nl::Weave::System::Stats::ResetHistograms();
+
+    memset(sCounters, 0, sizeof(sCounters));
+    memset(sMessageCounters, 0, sizeof(sMessageCounters));
+}
+
+static WEAVE_ERROR EncodeCounts(TLVWriter &aWriter, uint64_t aTag, const nl::Weave::System::Stats::count_t *aCounts)
+{
+    WEAVE_ERROR err;
+    TLVType containerType;
+
+    err = aWriter.StartContainer(aTag, kTLVType_Array, containerType);
+    SuccessOrExit(err);
+
+    for (int i = 0; i < nl::Weave::System::Stats::kNumEntries; i++)
+    {
+        err = aWriter.Put(AnonymousTag, static_cast<int32_t>(aCounts[i]));
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(containerType);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR EncodeHistogram(TLVWriter &aWriter, const nl::Weave::System::Stats::Histogram &aHistogram)
+{
+    WEAVE_ERROR err;
+    TLVType structureType;
+    TLVType arrayType;
+
+    err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, structureType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_Histogram_Count), aHistogram.mCount);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_Histogram_Sum), aHistogram.mSum);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_Histogram_Min), aHistogram.mMin);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_Histogram_Max), aHistogram.mMax);
+    SuccessOrExit(err);
+
+    err = aWriter.StartContainer(ContextTag(kTag_Histogram_Buckets), kTLVType_Array, arrayType);
+    SuccessOrExit(err);
+
+    for (int i = 0; i < nl::Weave::System::Stats::Histogram::kNumBuckets; i++)
+    {
+        err = aWriter.Put(AnonymousTag, aHistogram.mBuckets[i]);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(arrayType);
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(structureType);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR EncodeMessageCounter(TLVWriter &aWriter, const MessageCounter &aCounter)
+{
+    WEAVE_ERROR err;
+    TLVType structureType;
+
+    err = aWriter.StartContainer(AnonymousTag, kTLVType_Structure, structureType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_MessageCounter_ProfileId), aCounter.mProfileId);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_MessageCounter_MsgType), aCounter.mMsgType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_MessageCounter_NumSent), aCounter.mNumSent);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_MessageCounter_NumReceived), aCounter.mNumReceived);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(kTag_MessageCounter_DispatchTime), aCounter.mDispatchTimeUsec);
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(structureType);
+
+exit:
+    return err;
+}
+
+/**
+ * Encodes the current statistics in TLV, for scraping by a remote
+ * node. See the kTag_* enumeration for the format.
+ *
+ * @param[in] aWriter   The writer to encode the statistics with.
+ * @param[in] aTag      The tag of the outermost structure.
+ *
+ * @retval #WEAVE_NO_ERROR  On success.
+ * @retval other            Errors from the TLVWriter.
+ */
+WEAVE_ERROR EncodeStats(TLVWriter &aWriter, uint64_t aTag)
+{
+    WEAVE_ERROR err;
+    nl::Weave::System::Stats::Snapshot snapshot;
+    TLVType structureType;
+    TLVType arrayType;
+
+    nl::Weave::Stats::UpdateSnapshot(snapshot);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, structureType);
+    SuccessOrExit(err);
+
+    err = EncodeCounts(aWriter, ContextTag(kTag_ResourcesInUse), snapshot.mResourcesInUse);
+    SuccessOrExit(err);
+
+    err = EncodeCounts(aWriter, ContextTag(kTag_HighWatermarks), snapshot.mHighWatermarks);
+    SuccessOrExit(err);
+
+    err = aWriter.StartContainer(ContextTag(kTag_Histograms), kTLVType_Array, arrayType);
+    SuccessOrExit(err);
+
+    for (int i = 0; i < nl::Weave::System::Stats::kNumHistograms; i++)
+    {
+        err = EncodeHistogram(aWriter, snapshot.mHistograms[i]);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(arrayType);
+    SuccessOrExit(err);
+
+    err = aWriter.StartContainer(ContextTag(kTag_MessageCounters), kTLVType_Array, arrayType);
+    SuccessOrExit(err);
+
+    for (size_t i = 0; i < WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS; i++)
+    {
+        if (sMessageCounters[i].mIsInUse)
+        {
+            err = EncodeMessageCounter(aWriter, sMessageCounters[i]);
+            SuccessOrExit(err);
+        }
+    }
+
+    err = aWriter.EndContainer(arrayType);
+    SuccessOrExit(err);
+
+    err = aWriter.StartContainer(ContextTag(kTag_Counters), kTLVType_Array, arrayType);
+    SuccessOrExit(err);
+
+    for (int i = 0; i < kNumCounters; i++)
+    {
+        err = aWriter.Put(AnonymousTag, sCounters[i]);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(arrayType);
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(structureType);
+
+exit:
+    return err;
+}
+
 } // namespace Stats
 } // namespace Weave
 } // namespace nl
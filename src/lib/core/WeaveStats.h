@@ -29,18 +29,114 @@
 #include <Weave/Core/WeaveCore.h>
 #include <Weave/Core/WeaveMessageLayer.h>
 #include <Weave/Core/WeaveConfig.h>
+#include <Weave/Core/WeaveTLV.h>
 #include <SystemLayer/SystemStats.h>
 
 namespace nl {
 namespace Weave {
 namespace Stats {
 
+enum
+{
+    kCounter_WRMPRetransmissions,
+    kCounter_WRMPSendFailures,
+    kCounter_MessageCountersOverflow,
+
+    kNumCounters
+};
+
+/**
+ *  Context tags of the TLV encoding of the statistics written by
+ *  EncodeStats().
+ *
+ *  The encoding is a structure holding arrays of the resource counts
+ *  and high watermarks, of the histograms, of the message counters,
+ *  and of the event counters, indexed as in the System::Stats and
+ *  Weave::Stats enumerations.
+ */
+enum
+{
+    kTag_ResourcesInUse             = 1,    /**< Array of signed integers. */
+    kTag_HighWatermarks             = 2,    /**< Array of signed integers. */
+    kTag_Histograms                 = 3,    /**< Array of histogram structures. */
+    kTag_MessageCounters            = 4,    /**< Array of message counter structures. */
+    kTag_Counters                   = 5,    /**< Array of unsigned integers. */
+
+    // Histogram structure
+    kTag_Histogram_Count            = 1,    /**< Unsigned integer. */
+    kTag_Histogram_Sum              = 2,    /**< Unsigned integer, microseconds. */
+    kTag_Histogram_Min              = 3,    /**< Unsigned integer, microseconds. */
+    kTag_Histogram_Max              = 4,    /**< Unsigned integer, microseconds. */
+    kTag_Histogram_Buckets          = 5,    /**< Array of unsigned integers. */
+
+    // Message counter structure
+    kTag_MessageCounter_ProfileId   = 1,    /**< Unsigned integer. */
+    kTag_MessageCounter_MsgType     = 2,    /**< Unsigned integer. */
+    kTag_MessageCounter_NumSent     = 3,    /**< Unsigned integer. */
+    kTag_MessageCounter_NumReceived = 4,    /**< Unsigned integer. */
+    kTag_MessageCounter_DispatchTime = 5,   /**< Unsigned integer, microseconds. */
+};
+
+/**
+ *  @class MessageCounter
+ *
+ *  @brief
+ *    The number of messages of one profile and message type sent and
+ *    received, and the total time spent dispatching the received ones.
+ */
+class MessageCounter
+{
+public:
+    uint32_t mProfileId;
+    uint8_t mMsgType;
+    bool mIsInUse;
+    uint32_t mNumSent;
+    uint32_t mNumReceived;
+    uint64_t mDispatchTimeUsec;
+};
+
 void UpdateSnapshot(nl::Weave::System::Stats::Snapshot &aSnapshot);
 
 void SetObjects(WeaveMessageLayer *aMessageLayer);
 
+void CountMessageSent(uint32_t aProfileId, uint8_t aMsgType);
+void CountMessageReceived(uint32_t aProfileId, uint8_t aMsgType, uint32_t aDispatchTimeUsec);
+uint32_t *GetCounters(void);
+const char **GetCounterStrings(void);
+size_t GetMessageCounters(MessageCounter *aCounters, size_t aMaxCounters);
+void ResetCounters(void);
+
+WEAVE_ERROR EncodeStats(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag);
+
 } // namespace Stats
 } // namespace Weave
 } // namespace nl
 
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+#define WEAVE_STATS_COUNT(entry) \
+    do { \
+        nl::Weave::Stats::GetCounters()[entry]++; \
+    } while (0);
+
+#define WEAVE_STATS_COUNT_MESSAGE_SENT(profileId, msgType) \
+    do { \
+        nl::Weave::Stats::CountMessageSent(profileId, msgType); \
+    } while (0);
+
+#define WEAVE_STATS_COUNT_MESSAGE_RECEIVED(profileId, msgType, dispatchTimeUsec) \
+    do { \
+        nl::Weave::Stats::CountMessageReceived(profileId, msgType, dispatchTimeUsec); \
+    } while (0);
+
+#else // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
+#define WEAVE_STATS_COUNT(entry)
+
+#define WEAVE_STATS_COUNT_MESSAGE_SENT(profileId, msgType)
+
+#define WEAVE_STATS_COUNT_MESSAGE_RECEIVED(profileId, msgType, dispatchTimeUsec)
+
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
 #endif // WEAVE_STATS_H
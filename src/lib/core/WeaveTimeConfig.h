@@ -262,6 +262,35 @@
 #define WEAVE_CONFIG_TIME_CLIENT_CONNECTION_FOR_SERVICE 1
 #endif // WEAVE_CONFIG_TIME_CLIENT_CONNECTION_FOR_SERVICE
 
+/**
+ *  @def WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+ *
+ *  @brief
+ *    Disabled: 0, Enabled: 1. If enabled, the client provides an API
+ *    to sync with all local contacts concurrently, each on its own
+ *    Weave Exchange, instead of contacting them one after another.
+ *    Concurrent sync costs one exchange context per contact.
+ *
+ */
+#ifndef WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+#define WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC 1
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
+/**
+ *  @def WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC_QUORUM
+ *
+ *  @brief
+ *    This only applies to Time Sync Client/Coordinator roles with
+ *    #WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC enabled. Default number
+ *    of usable responses after which a concurrent round stops waiting
+ *    for the remaining contacts. 0 means waiting for every contact to
+ *    either respond or time out.
+ *
+ */
+#ifndef WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC_QUORUM
+#define WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC_QUORUM 0
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC_QUORUM
+
 /**
  *  @def WEAVE_CONFIG_TIME_CLIENT_MIN_OFFSET_FROM_SERVER_USEC
  *
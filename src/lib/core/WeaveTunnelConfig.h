@@ -66,15 +66,129 @@
  *  @def WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
  *
  *  @brief
- *    This defines the default queue depth for queueing data packets
- *    destined for the Service when the connection to the Service
- *    is not yet established.
+ *    This defines the default queue depth, per traffic class, for
+ *    queueing data packets destined for the Service when the
+ *    connection to the Service is not yet established, or is not
+ *    accepting more data.
  *
  */
 #ifndef WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
 #define WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED              (8)
 #endif // WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED
 
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUEUE_BYTES
+ *
+ *  @brief
+ *    This defines the maximum number of bytes of encapsulated
+ *    packets held in the high priority traffic class queue.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUEUE_BYTES
+#define WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUEUE_BYTES              (4096)
+#endif // WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUEUE_BYTES
+
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUEUE_BYTES
+ *
+ *  @brief
+ *    This defines the maximum number of bytes of encapsulated
+ *    packets held in the normal traffic class queue.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUEUE_BYTES
+#define WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUEUE_BYTES            (8192)
+#endif // WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUEUE_BYTES
+
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUEUE_BYTES
+ *
+ *  @brief
+ *    This defines the maximum number of bytes of encapsulated
+ *    packets held in the bulk traffic class queue.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUEUE_BYTES
+#define WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUEUE_BYTES              (8192)
+#endif // WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUEUE_BYTES
+
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUANTUM
+ *
+ *  @brief
+ *    This defines the number of bytes the high priority traffic
+ *    class may send to the Service per deficit round-robin round.
+ *
+ *  @note
+ *    Each quantum should be at least the size of the largest
+ *    encapsulated packet so that every class makes progress on
+ *    each round.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUANTUM
+#define WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUANTUM                  (8192)
+#endif // WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUANTUM
+
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUANTUM
+ *
+ *  @brief
+ *    This defines the number of bytes the normal traffic class
+ *    may send to the Service per deficit round-robin round.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUANTUM
+#define WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUANTUM                (3072)
+#endif // WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUANTUM
+
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUANTUM
+ *
+ *  @brief
+ *    This defines the number of bytes the bulk traffic class
+ *    may send to the Service per deficit round-robin round.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUANTUM
+#define WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUANTUM                  (1536)
+#endif // WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUANTUM
+
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_MAX_PENDING_SEND_BYTES
+ *
+ *  @brief
+ *    This defines the number of bytes that may be pending on the
+ *    tunnel connection before the tunnel agent stops feeding it and
+ *    holds outbound packets in the traffic class queues.
+ *
+ *    Keeping this small bounds the time a newly queued high priority
+ *    packet waits behind lower priority traffic already committed to
+ *    the connection.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_MAX_PENDING_SEND_BYTES
+#define WEAVE_CONFIG_TUNNELING_MAX_PENDING_SEND_BYTES              (4096)
+#endif // WEAVE_CONFIG_TUNNELING_MAX_PENDING_SEND_BYTES
+
+/**
+ *  @def WEAVE_CONFIG_TUNNELING_MAX_NUM_COALESCED_PACKETS
+ *
+ *  @brief
+ *    This defines the maximum number of encapsulated packets
+ *    that the tunnel agent accumulates on a tunnel connection
+ *    before handing them to the transport in a single write.
+ *
+ *    Packets read from the tunnel endpoint in one batch are
+ *    coalesced up to this limit; the remainder of a batch is
+ *    flushed when the tunnel endpoint signals the end of the
+ *    batch. Set to 1 to send every packet as soon as it is
+ *    encapsulated.
+ *
+ */
+#ifndef WEAVE_CONFIG_TUNNELING_MAX_NUM_COALESCED_PACKETS
+#define WEAVE_CONFIG_TUNNELING_MAX_NUM_COALESCED_PACKETS           (8)
+#endif // WEAVE_CONFIG_TUNNELING_MAX_NUM_COALESCED_PACKETS
+
 /**
  *  @def WEAVE_CONFIG_TUNNELING_MAX_NUM_SHORTCUT_TUNNEL_PEERS
  *
@@ -506,7 +506,8 @@ WEAVE_ERROR SendAccept::init(uint8_t aVersion, uint8_t aTransferMode, uint16_t a
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     VerifyOrExit((aTransferMode & kMode_SenderDrive ||
-                  aTransferMode & kMode_ReceiverDrive),
+                  aTransferMode & kMode_ReceiverDrive ||
+                  aTransferMode & kMode_Asynchronous),
                  err = WEAVE_ERROR_INVALID_TRANSFER_MODE);
 
     mVersion = aVersion;
@@ -661,7 +662,8 @@ WEAVE_ERROR ReceiveAccept::init(uint8_t aVersion, uint8_t aTransferMode, uint16_
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     VerifyOrExit((aTransferMode & kMode_SenderDrive ||
-                  aTransferMode & kMode_ReceiverDrive),
+                  aTransferMode & kMode_ReceiverDrive ||
+                  aTransferMode & kMode_Asynchronous),
                  err = WEAVE_ERROR_INVALID_TRANSFER_MODE);
 
     mDefiniteLength = (aLength != 0);
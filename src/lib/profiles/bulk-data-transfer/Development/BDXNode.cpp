@@ -740,8 +740,7 @@ void BdxNode::HandleReceiveInit(ExchangeContext *anEc, const IPPacketInfo *aPktI
     // Validate the requested transfer mode
     VerifyOrExit(!(((xfer->mTransferMode == kMode_ReceiverDrive) && !receiveInit.mReceiverDriveSupported) ||
                    ((xfer->mTransferMode == kMode_SenderDrive) && !receiveInit.mSenderDriveSupported) ||
-                   ((xfer->mTransferMode == kMode_Asynchronous))),
-        //TODO: merge this up one line when async supported: && !receiveInit.mAsynchronousModeSupported)
+                   ((xfer->mTransferMode == kMode_Asynchronous) && (!receiveInit.mAsynchronousModeSupported || xfer->mVersion != 1))),
                  err = WEAVE_ERROR_INVALID_TRANSFER_MODE; statusCode = kStatus_ServerBadState);
 
     // TODO: validate max block size?  anything else?
@@ -879,8 +878,7 @@ void BdxNode::HandleSendInit(ExchangeContext *anEc, const IPPacketInfo *aPktInfo
     // Validate the requested transfer mode
     VerifyOrExit(!(((xfer->mTransferMode == kMode_ReceiverDrive) && !sendInit.mReceiverDriveSupported) ||
                    ((xfer->mTransferMode == kMode_SenderDrive) && !sendInit.mSenderDriveSupported) ||
-                   ((xfer->mTransferMode == kMode_Asynchronous))),
-        //TODO: merge this up one line when async supported: && !sendInit.mAsynchronousModeSupported)
+                   ((xfer->mTransferMode == kMode_Asynchronous) && (!sendInit.mAsynchronousModeSupported || xfer->mVersion != 1))),
                  err = WEAVE_ERROR_INVALID_TRANSFER_MODE; statusCode = kStatus_ServerBadState);
 
     WeaveLogDetail(BDX, "HandleSendInit validated request\n");
@@ -1047,6 +1045,13 @@ WEAVE_ERROR BdxNode::SendReceiveAccept(ExchangeContext *anEc, BDXTransfer *aXfer
         VerifyOrExit(err == WEAVE_NO_ERROR,
                      WeaveLogDetail(BDX, "Error sending first block in SendReceiveAccept: %d", err));
     }
+    else if (aXfer->IsAsync())
+    {
+        WeaveLogDetail(BDX, "ReceiveAccept sent: Async transfer so sending first window of blocks");
+        err = BdxProtocol::SendBlockWindowV1(*aXfer);
+        VerifyOrExit(err == WEAVE_NO_ERROR,
+                     WeaveLogDetail(BDX, "Error sending first window in SendReceiveAccept: %d", err));
+    }
 
 exit:
     if (payload)
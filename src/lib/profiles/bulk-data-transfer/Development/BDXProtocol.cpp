@@ -554,20 +554,21 @@ exit:
 
 /**
  * @brief
- *  This function sends the next BlockSendV1 retrieved by calling the BDXTransfer's
- *  GetBlockHandler.
+ *  This function sends block number aXfer.mBlockCounter, retrieved by calling the
+ *  BDXTransfer's GetBlockHandler, as a BlockSendV1 or BlockEOFV1.
  *
  * @param[in]       aXfer   The BDXTransfer whose GetBlockHandler is called to get the
  *                          next block before sending it using the associated ExchangeContext
+ * @param[out]      aIsLast Set to true if the block was sent as a BlockEOFV1
  *
  * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
  */
-WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
+static WEAVE_ERROR SendBlockV1(BDXTransfer &aXfer, bool &aIsLast)
 {
     WEAVE_ERROR     err         = WEAVE_NO_ERROR;
     uint64_t        length;
     uint8_t*        data;
-    bool            isLast;
+    bool            isLast      = false;
     uint8_t         msgType;
     PacketBuffer*   buffer      = PacketBuffer::New();
     uint16_t        flags;
@@ -621,13 +622,16 @@ WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
         msgType = kMsgType_BlockSendV1;
     }
 
-    // TODO: for async aXfer, don't expect response. For now, we always expect an ACK or
-    // another BlockQuery
-    flags = aXfer.GetDefaultFlags(true);
+    // We always expect an ACK or another BlockQuery.  An exchange can only have
+    // one response outstanding, so while an async window is in flight only the
+    // first block arms the response timer; a cumulative ACK answers them all.
+    flags = aXfer.GetDefaultFlags(!aXfer.IsAsync() || !aXfer.mExchangeContext->IsResponseExpected());
 
     err = aXfer.mExchangeContext->SendMessage(kWeaveProfile_BDX, msgType, buffer, flags);
     buffer = NULL;
 
+    aIsLast = isLast;
+
 exit:
     if (buffer != NULL)
     {
@@ -637,6 +641,67 @@ exit:
     return err;
 }
 
+/**
+ * @brief
+ *  This function sends the next BlockSendV1 retrieved by calling the BDXTransfer's
+ *  GetBlockHandler.
+ *
+ * @param[in]       aXfer   The BDXTransfer whose GetBlockHandler is called to get the
+ *                          next block before sending it using the associated ExchangeContext
+ *
+ * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
+ */
+WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer)
+{
+    bool isLast;
+
+    return SendBlockV1(aXfer, isLast);
+}
+
+/**
+ * @brief
+ *  This function fills the send window of an asynchronous transfer, sending
+ *  blocks until #WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE blocks are awaiting a
+ *  BlockAckV1 or the BlockEOFV1 has been sent.
+ *
+ *  On return, aXfer.mBlockCounter is the next block to send or, once the
+ *  BlockEOFV1 has been sent, the counter of that last block.
+ *
+ * @note
+ *   Lost blocks are recovered by WRMP retransmission (or by TCP), so the
+ *   window only advances as cumulative BlockAckV1 messages arrive.
+ *
+ * @param[in]       aXfer   The asynchronous BDXTransfer to send blocks for
+ *
+ * @retval          #WEAVE_ERROR_INCORRECT_STATE    If the GetBlockHandler is NULL
+ */
+WEAVE_ERROR SendBlockWindowV1(BDXTransfer &aXfer)
+{
+    WEAVE_ERROR     err         = WEAVE_NO_ERROR;
+    bool            isLast;
+
+    while (!aXfer.mAsyncEOF &&
+           (aXfer.mBlockCounter - aXfer.mAsyncWindowStart) < WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE)
+    {
+        isLast = false;
+
+        err = SendBlockV1(aXfer, isLast);
+        SuccessOrExit(err);
+
+        if (isLast)
+        {
+            aXfer.mAsyncEOF = true;
+        }
+        else
+        {
+            aXfer.mBlockCounter++;
+        }
+    }
+
+exit:
+    return err;
+}
+
 /**
  * @brief
  *  The main handler for messages arriving on the BDX exchange.  It essentially
@@ -916,14 +981,30 @@ WEAVE_ERROR HandleResponseTransmit(BDXTransfer &aXfer, uint32_t aProfileId, uint
                 {
                     BlockAckV1 ackV1;
 
-                    VerifyOrExit(aXfer.IsDriver() && !aXfer.IsAsync(), err = WEAVE_NO_ERROR);
+                    VerifyOrExit(aXfer.IsDriver() || aXfer.IsAsync(), err = WEAVE_NO_ERROR);
 
                     err = BlockAckV1::parse(aPacketBuffer, ackV1);
                     VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "BlockAckV1 parse failed."));
 
                     rcvdCounter = ackV1.mBlockCounter;
 
-                    if (rcvdCounter == aXfer.mBlockCounter)
+                    if (aXfer.IsAsync())
+                    {
+                        // Acks are cumulative: slide the window past the acknowledged
+                        // block and refill it.  Acks for blocks that are no longer in
+                        // the window are duplicates and are ignored.
+                        if (rcvdCounter >= aXfer.mAsyncWindowStart && rcvdCounter < aXfer.mBlockCounter)
+                        {
+                            aXfer.mAsyncWindowStart = rcvdCounter + 1;
+                            aXfer.mNext = SendBlockWindowV1;
+                        }
+                        else if (rcvdCounter >= aXfer.mBlockCounter)
+                        {
+                            WeaveLogDetail(BDX, "Received BlockAckV1 for unsent block: %d, next: %d", rcvdCounter, aXfer.mBlockCounter);
+                            aXfer.mNext = SendBadBlockCounterStatusReport;
+                        }
+                    }
+                    else if (rcvdCounter == aXfer.mBlockCounter)
                     {
                         // Update the counter and send the next block
                         aXfer.mBlockCounter++;
@@ -1092,6 +1173,103 @@ exit:
 #endif // WEAVE_CONFIG_BDX_CLIENT_SEND_SUPPORT
 
 #if WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT
+/**
+ * @brief
+ *  Handle a BlockSendV1 or BlockEOFV1 received during an asynchronous transfer.
+ *
+ *  Blocks that arrive ahead of aXfer.mBlockCounter, but within the window, are
+ *  held until the missing blocks arrive; blocks are always passed to the
+ *  PutBlockHandler in order.  Every block that advances the transfer is
+ *  answered with a cumulative BlockAckV1 (or the BlockEOFAckV1 once the last
+ *  block has been delivered).
+ *
+ * @param[in]   aXfer           The asynchronous BDXTransfer receiving the block
+ * @param[in]   aBlock          The parsed block
+ * @param[in]   aPacketBuffer   The buffer the block was parsed from
+ * @param[in]   aIsLast         True if the block was received as a BlockEOFV1
+ *
+ * @return #WEAVE_NO_ERROR unless a held block could not be parsed
+ */
+static WEAVE_ERROR HandleAsyncBlockV1(BDXTransfer &aXfer, BlockSendV1 &aBlock, PacketBuffer *aPacketBuffer, bool aIsLast)
+{
+    WEAVE_ERROR     err         = WEAVE_NO_ERROR;
+    uint32_t        rcvdCounter = aBlock.mBlockCounter;
+    uint8_t         slot;
+    PacketBuffer *  held;
+    bool            isLast;
+
+    if (rcvdCounter < aXfer.mBlockCounter)
+    {
+        // Duplicate of a block we already delivered; our ack was probably lost.
+        WeaveLogDetail(BDX, "Received duplicate block: %d, expected: %d", rcvdCounter, aXfer.mBlockCounter);
+        aXfer.mNext = SendBlockAckV1;
+        ExitNow();
+    }
+
+    if ((rcvdCounter - aXfer.mBlockCounter) >= WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE ||
+        (aXfer.mAsyncEOF && rcvdCounter > aXfer.mAsyncEOFCounter))
+    {
+        WeaveLogDetail(BDX, "Received bad block counter: %d, expected: %d", rcvdCounter, aXfer.mBlockCounter);
+        aXfer.mNext = SendBadBlockCounterStatusReport;
+        ExitNow();
+    }
+
+    if (rcvdCounter != aXfer.mBlockCounter)
+    {
+        // Hold the block until the ones before it arrive.
+        slot = rcvdCounter % WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE;
+
+        if (aXfer.mAsyncBlocks[slot] == NULL)
+        {
+            aPacketBuffer->AddRef();
+            aXfer.mAsyncBlocks[slot] = aPacketBuffer;
+
+            if (aIsLast)
+            {
+                aXfer.mAsyncEOF = true;
+                aXfer.mAsyncEOFCounter = rcvdCounter;
+            }
+        }
+
+        ExitNow();
+    }
+
+    aXfer.DispatchPutBlockHandler(aBlock.mLength, aBlock.mData, aIsLast);
+    isLast = aIsLast;
+
+    // Deliver any held blocks that are now in order.
+    while (!isLast)
+    {
+        aXfer.mBlockCounter++;
+
+        slot = aXfer.mBlockCounter % WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE;
+        held = aXfer.mAsyncBlocks[slot];
+        if (held == NULL)
+        {
+            break;
+        }
+
+        aXfer.mAsyncBlocks[slot] = NULL;
+        isLast = aXfer.mAsyncEOF && aXfer.mBlockCounter == aXfer.mAsyncEOFCounter;
+
+        {
+            BlockSendV1 heldBlock;
+
+            err = BlockSendV1::parse(held, heldBlock);
+            PacketBuffer::Free(held);
+            SuccessOrExit(err);
+
+            aXfer.DispatchPutBlockHandler(heldBlock.mLength, heldBlock.mData, isLast);
+        }
+    }
+
+    // SendBlockAckV1 will by design send out the ack for mBlockCounter - 1
+    aXfer.mNext = isLast ? SendBlockEOFAckV1 : SendBlockAckV1;
+
+exit:
+    return err;
+}
+
 /*
  * otherwise, I'm the receiver. I should expect to get
  * a block here and then, If I'm driving, send out a
@@ -1140,6 +1318,12 @@ WEAVE_ERROR HandleResponseReceive(BDXTransfer &aXfer, uint32_t aProfileId, uint8
                     err = BlockSendV1::parse(aPacketBuffer, blockSendV1);
                     VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "BlockSendV1 parse failed."));
 
+                    if (aXfer.IsAsync())
+                    {
+                        err = HandleAsyncBlockV1(aXfer, blockSendV1, aPacketBuffer, false);
+                        break;
+                    }
+
                     rcvdCounter = blockSendV1.mBlockCounter;
 
                     if (rcvdCounter == aXfer.mBlockCounter)
@@ -1198,6 +1382,12 @@ WEAVE_ERROR HandleResponseReceive(BDXTransfer &aXfer, uint32_t aProfileId, uint8
                     err = BlockEOFV1::parse(aPacketBuffer, blockEOFV1);
                     VerifyOrExit(err == WEAVE_NO_ERROR, WeaveLogDetail(BDX, "BlockEOFV1 parse failed."));
 
+                    if (aXfer.IsAsync())
+                    {
+                        err = HandleAsyncBlockV1(aXfer, blockEOFV1, aPacketBuffer, true);
+                        break;
+                    }
+
                     rcvdCounter = blockEOFV1.mBlockCounter;
 
                     if (rcvdCounter == aXfer.mBlockCounter)
@@ -1329,8 +1519,9 @@ WEAVE_ERROR HandleResponseNotAccepted(BDXTransfer &aXfer, uint32_t aProfileId, u
                             break;
 
                         case kMode_Asynchronous:
-                            WeaveLogDetail(BDX, "Received request for Async transfer mode, but it's not implemented yet!");
-                            err = WEAVE_ERROR_INVALID_TRANSFER_MODE;
+                            // Async transfers are only defined for V1 messages
+                            VerifyOrExit(aXfer.mVersion == 1, err = WEAVE_ERROR_UNSUPPORTED_MESSAGE_VERSION);
+                            aXfer.mNext = SendBlockWindowV1;
                             break;
 
                         default:
@@ -1405,8 +1596,8 @@ WEAVE_ERROR HandleResponseNotAccepted(BDXTransfer &aXfer, uint32_t aProfileId, u
                             break;
 
                         case kMode_Asynchronous:
-                            WeaveLogDetail(BDX, "Received request for Async transfer mode, but it's not implemented yet!");
-                            err = WEAVE_ERROR_INVALID_TRANSFER_MODE;
+                            WeaveLogDetail(BDX, "Receive accepted: async transfer, so waiting for first BlockSend");
+                            VerifyOrExit(aXfer.mVersion == 1, err = WEAVE_ERROR_UNSUPPORTED_MESSAGE_VERSION);
                             break;
 
                         default:
@@ -66,6 +66,8 @@ WEAVE_ERROR SendNextBlock(BDXTransfer &aXfer);
 
 WEAVE_ERROR SendNextBlockV1(BDXTransfer &aXfer);
 
+WEAVE_ERROR SendBlockWindowV1(BDXTransfer &aXfer);
+
 // The following handlers are stateless callbacks meant to be passed to the
 // ExchangeContext in order to handle incoming BDX messages.
 // They handle the actual BDX protocol interaction and defer to the previously
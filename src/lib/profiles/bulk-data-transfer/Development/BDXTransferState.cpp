@@ -65,6 +65,8 @@ void BDXTransfer::Shutdown(void)
         }
     }
 
+    FreeAsyncBlocks();
+
     Reset();
 }
 
@@ -86,6 +88,14 @@ void BDXTransfer::Reset(void)
     mIsWideRange                    = false;
     mIsCompletedSuccessfully        = false;
     mAmInitiator                    = false;
+    mAsyncWindowStart               = 0;
+    mAsyncEOFCounter                = 0;
+    mAsyncEOF                       = false;
+
+    for (int i = 0; i < WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE; i++)
+    {
+        mAsyncBlocks[i]             = NULL;
+    }
 
     mHandlers.mSendAcceptHandler    = NULL;
     mHandlers.mReceiveAcceptHandler = NULL;
@@ -99,10 +109,31 @@ void BDXTransfer::Reset(void)
 
 /**
  * @brief
- *      Returns true if this transfer is asynchronous, false otherwise.
+ *      Frees any out-of-order blocks held by an asynchronous receiver.
  *
  * @note
- *   Asynchronous transfer is not currently implemented!
+ *   Reset() only clears the held block pointers, since it is also used to
+ *   initialize transfer objects; call this first to release the buffers.
+ */
+void BDXTransfer::FreeAsyncBlocks(void)
+{
+    for (int i = 0; i < WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE; i++)
+    {
+        if (mAsyncBlocks[i] != NULL)
+        {
+            PacketBuffer::Free(mAsyncBlocks[i]);
+            mAsyncBlocks[i] = NULL;
+        }
+    }
+}
+
+/**
+ * @brief
+ *      Returns true if this transfer is asynchronous, false otherwise.
+ *
+ * In an asynchronous transfer the sender keeps up to
+ * #WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE blocks in flight and neither party
+ * drives the transfer with BlockQuery messages.
  *
  * @return true iff the transfer is asynchronous.
  */
@@ -290,6 +290,18 @@ struct BDXTransfer
      */
     uint32_t            mBlockCounter;
 
+    /** Asynchronous transfer state.
+     * When sending, mAsyncWindowStart is the oldest block that has not been
+     * acknowledged yet and mAsyncEOF is true once the BlockEOF has been sent.
+     * When receiving, mAsyncBlocks holds blocks that arrived ahead of
+     * mBlockCounter (indexed by block counter modulo the window size), and
+     * mAsyncEOF and mAsyncEOFCounter record a held BlockEOF.
+     */
+    uint32_t            mAsyncWindowStart;
+    uint32_t            mAsyncEOFCounter;
+    bool                mAsyncEOF;
+    PacketBuffer *      mAsyncBlocks[WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE];
+
     // application-supplied handlers
     //TODO: make these private when BdxProtocol doesn't inspect them directly
     //before calling DispatchGetBlockHandler().  We'll have to remove that check
@@ -302,6 +314,8 @@ struct BDXTransfer
 
     void Reset(void);
 
+    void FreeAsyncBlocks(void);
+
     bool IsAsync(void);
 
     bool IsDriver(void);
@@ -1380,16 +1380,8 @@ WEAVE_ERROR DataList::Parser::CheckSchemaValidity (void) const
 
     while (WEAVE_NO_ERROR == (err = reader.Next()))
     {
-        VerifyOrExit(nl::Weave::TLV::AnonymousTag == reader.GetTag(), err = WEAVE_ERROR_INVALID_TLV_TAG);
-        VerifyOrExit(nl::Weave::TLV::kTLVType_Structure == reader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
-
-        {
-            DataElement::Parser data;
-            err = data.Init(reader);
-            SuccessOrExit(err);
-            err = data.CheckSchemaValidity();
-            SuccessOrExit(err);
-        }
+        err = CheckElementSchemaValidity(reader);
+        SuccessOrExit(err);
 
         ++NumDataElement;
     }
@@ -1406,6 +1398,29 @@ WEAVE_ERROR DataList::Parser::CheckSchemaValidity (void) const
         }
     }
 
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+// Verify a single element of a data list, including
+// 1) the element is anonymous and of Structure type
+// 2) the Data Element is also valid in schema
+WEAVE_ERROR DataList::Parser::CheckElementSchemaValidity (const nl::Weave::TLV::TLVReader & aReader)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    DataElement::Parser data;
+
+    VerifyOrExit(nl::Weave::TLV::AnonymousTag == aReader.GetTag(), err = WEAVE_ERROR_INVALID_TLV_TAG);
+    VerifyOrExit(nl::Weave::TLV::kTLVType_Structure == aReader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    err = data.Init(aReader);
+    SuccessOrExit(err);
+
+    err = data.CheckSchemaValidity();
+    SuccessOrExit(err);
+
 exit:
     WeaveLogFunctError(err);
 
@@ -2294,6 +2309,206 @@ VersionList::Builder & VersionList::Builder::EndOfVersionList (void)
     return *this;
 }
 
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+WEAVE_ERROR StatusList::Parser::CheckSchemaValidity (void) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVReader reader;
+    nl::Weave::TLV::TLVType dummyContainerType;
+    uint32_t profileId;
+    uint16_t statusCode;
+    uint64_t version;
+
+    PRETTY_PRINT("StatusList = ");
+    PRETTY_PRINT("[");
+
+    reader.Init(mReader);
+
+    while (WEAVE_NO_ERROR == (err = reader.Next()))
+    {
+        uint16_t TagPresenceMask = 0;
+
+        VerifyOrExit (nl::Weave::TLV::AnonymousTag == reader.GetTag(), err = WEAVE_ERROR_INVALID_TLV_TAG);
+        VerifyOrExit (nl::Weave::TLV::kTLVType_Structure == reader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+        err = reader.EnterContainer(dummyContainerType);
+        SuccessOrExit(err);
+
+        while (WEAVE_NO_ERROR == (err = reader.Next()))
+        {
+            const uint64_t tag = reader.GetTag();
+
+            if (nl::Weave::TLV::ContextTag(kCsTag_ProfileId) == tag)
+            {
+                VerifyOrExit (!(TagPresenceMask & (1 << kCsTag_ProfileId)), err = WEAVE_ERROR_INVALID_TLV_TAG);
+                TagPresenceMask |= (1 << kCsTag_ProfileId);
+
+                err = reader.Get(profileId);
+                SuccessOrExit(err);
+            }
+            else if (nl::Weave::TLV::ContextTag(kCsTag_Status) == tag)
+            {
+                VerifyOrExit (!(TagPresenceMask & (1 << kCsTag_Status)), err = WEAVE_ERROR_INVALID_TLV_TAG);
+                TagPresenceMask |= (1 << kCsTag_Status);
+
+                err = reader.Get(statusCode);
+                SuccessOrExit(err);
+            }
+            else if (nl::Weave::TLV::ContextTag(kCsTag_Version) == tag)
+            {
+                VerifyOrExit (!(TagPresenceMask & (1 << kCsTag_Version)), err = WEAVE_ERROR_INVALID_TLV_TAG);
+                TagPresenceMask |= (1 << kCsTag_Version);
+
+                err = reader.Get(version);
+                SuccessOrExit(err);
+            }
+            else
+            {
+                PRETTY_PRINT("\tUnknown tag 0x%" PRIx64, tag);
+            }
+        }
+
+        VerifyOrExit(WEAVE_END_OF_TLV == err, );
+
+        {
+            const uint16_t RequiredFields = (1 << kCsTag_ProfileId) | (1 << kCsTag_Status);
+            VerifyOrExit((TagPresenceMask & RequiredFields) == RequiredFields, err = WEAVE_ERROR_INVALID_TLV_ELEMENT);
+        }
+
+        if (TagPresenceMask & (1 << kCsTag_Version))
+        {
+            PRETTY_PRINT("\t{ 0x%" PRIx32 ", 0x%" PRIx16 ", 0x%" PRIx64 " },", profileId, statusCode, version);
+        }
+        else
+        {
+            PRETTY_PRINT("\t{ 0x%" PRIx32 ", 0x%" PRIx16 " },", profileId, statusCode);
+        }
+
+        err = reader.ExitContainer(dummyContainerType);
+        SuccessOrExit(err);
+    }
+
+    PRETTY_PRINT("],");
+
+    if (WEAVE_END_OF_TLV == err)
+    {
+        err = WEAVE_NO_ERROR;
+    }
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+
+// Position apReader on the specified field of the current element
+WEAVE_ERROR StatusList::Parser::GetReaderOnElementField (const uint8_t aContextTag, nl::Weave::TLV::TLVReader * const apReader) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVReader reader;
+    nl::Weave::TLV::TLVType dummyContainerType;
+
+    VerifyOrExit (nl::Weave::TLV::kTLVType_Structure == mReader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    reader.Init(mReader);
+
+    err = reader.EnterContainer(dummyContainerType);
+    SuccessOrExit(err);
+
+    // WEAVE_END_OF_TLV if there is no such field
+    err = LookForElementWithTag(reader, nl::Weave::TLV::ContextTag(aContextTag), apReader);
+
+exit:
+    return err;
+}
+
+WEAVE_ERROR StatusList::Parser::GetStatus (uint32_t * const apProfileId, uint16_t * const apStatusCode) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVReader reader;
+
+    err = GetReaderOnElementField(kCsTag_ProfileId, &reader);
+    SuccessOrExit(err);
+
+    err = reader.Get(*apProfileId);
+    SuccessOrExit(err);
+
+    err = GetReaderOnElementField(kCsTag_Status, &reader);
+    SuccessOrExit(err);
+
+    err = reader.Get(*apStatusCode);
+    SuccessOrExit(err);
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+// WEAVE_END_OF_TLV if the current element doesn't carry a version
+WEAVE_ERROR StatusList::Parser::GetVersion (uint64_t * const apVersion) const
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVReader reader;
+
+    err = GetReaderOnElementField(kCsTag_Version, &reader);
+    SuccessOrExit(err);
+
+    err = reader.Get(*apVersion);
+
+exit:
+    return err;
+}
+
+StatusList::Builder & StatusList::Builder::AddStatus (const uint32_t aProfileId, const uint16_t aStatusCode)
+{
+    return AddStatusElement(aProfileId, aStatusCode, NULL);
+}
+
+StatusList::Builder & StatusList::Builder::AddStatus (const uint32_t aProfileId, const uint16_t aStatusCode, const uint64_t aVersion)
+{
+    return AddStatusElement(aProfileId, aStatusCode, &aVersion);
+}
+
+StatusList::Builder & StatusList::Builder::AddStatusElement (const uint32_t aProfileId, const uint16_t aStatusCode, const uint64_t * const apVersion)
+{
+    nl::Weave::TLV::TLVType dummyContainerType;
+
+    // skip if error has already been set
+    SuccessOrExit(mError);
+
+    mError = mpWriter->StartContainer(nl::Weave::TLV::AnonymousTag, nl::Weave::TLV::kTLVType_Structure, dummyContainerType);
+    SuccessOrExit(mError);
+
+    mError = mpWriter->Put(nl::Weave::TLV::ContextTag(kCsTag_ProfileId), aProfileId);
+    SuccessOrExit(mError);
+
+    mError = mpWriter->Put(nl::Weave::TLV::ContextTag(kCsTag_Status), aStatusCode);
+    SuccessOrExit(mError);
+
+    if (NULL != apVersion)
+    {
+        mError = mpWriter->Put(nl::Weave::TLV::ContextTag(kCsTag_Version), *apVersion);
+        SuccessOrExit(mError);
+    }
+
+    mError = mpWriter->EndContainer(dummyContainerType);
+    SuccessOrExit(mError);
+
+exit:
+    WeaveLogFunctError(mError);
+
+    return *this;
+}
+
+// Mark the end of this array and recover the type for outer container
+StatusList::Builder & StatusList::Builder::EndOfStatusList (void)
+{
+    EndOfContainer();
+    return *this;
+}
+
 // aReader has to be on the element of anonymous container
 WEAVE_ERROR BaseMessageWithSubscribeId::Parser::Init (const nl::Weave::TLV::TLVReader & aReader)
 {
@@ -2948,6 +3163,13 @@ SubscribeConfirmRequest::Builder & SubscribeConfirmRequest::Builder::EndOfReques
 // 3) any tag can only appear once
 // At the top level of the message, unknown tags are ignored for foward compatibility
 WEAVE_ERROR NotificationRequest::Parser::CheckSchemaValidity (void) const
+{
+    return CheckSchemaValidity(true);
+}
+
+// Same as above, but when aCheckDataElements is false, the data elements in the
+// data list are left to be verified by the caller as they are consumed
+WEAVE_ERROR NotificationRequest::Parser::CheckSchemaValidity (const bool aCheckDataElements) const
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     uint16_t TagPresenceMask = 0;
@@ -3055,14 +3277,17 @@ WEAVE_ERROR NotificationRequest::Parser::CheckSchemaValidity (void) const
             TagPresenceMask |= (1 << kBit_DataList);
             VerifyOrExit(nl::Weave::TLV::kTLVType_Array == reader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
 
-            dataList.Init(reader);
+            if (aCheckDataElements)
+            {
+                dataList.Init(reader);
 
-            PRETTY_PRINT_INCDEPTH();
+                PRETTY_PRINT_INCDEPTH();
 
-            err = dataList.CheckSchemaValidity();
-            SuccessOrExit(err);
+                err = dataList.CheckSchemaValidity();
+                SuccessOrExit(err);
 
-            PRETTY_PRINT_DECDEPTH();
+                PRETTY_PRINT_DECDEPTH();
+            }
         }
         else
         {
@@ -429,6 +429,12 @@ public:
     // 2) all elements are anonymous and of Structure type
     // 3) every Data Element is also valid in schema
     WEAVE_ERROR CheckSchemaValidity(void) const;
+
+    // Verify a single element of a data list, as positioned by aReader, including
+    // 1) the element is anonymous and of Structure type
+    // 2) the Data Element is also valid in schema
+    // Used to validate a data list while it is being consumed
+    static WEAVE_ERROR CheckElementSchemaValidity(const nl::Weave::TLV::TLVReader & aReader);
 };
 
 class DataList::Builder: public ListBuilderBase
@@ -614,6 +620,74 @@ namespace ViewResponse
     };
 };
 
+namespace UpdateRequest
+{
+    enum
+    {
+        kCsTag_DataList                 = 1,
+    };
+};
+
+// The response to an Update Request is a Status Report of Common:Success,
+// with an Update Response structure carried as its additional information
+namespace UpdateResponse
+{
+    enum
+    {
+        kCsTag_StatusList               = 1,
+    };
+};
+
+/**
+ *  @brief
+ *    WDM Status List definition, which carries one Status Element per data element of an Update Request
+ */
+namespace StatusList
+{
+    enum
+    {
+        kCsTag_ProfileId                = 1,
+        kCsTag_Status                   = 2,
+        kCsTag_Version                  = 3,
+    };
+
+    class Parser;
+    class Builder;
+};
+
+class StatusList::Parser : public ListParserBase
+{
+public:
+
+    // Roughly verify the schema is right, including
+    // 1) all elements are anonymous and of Structure type
+    // 2) every element has a profile id and a status code of unsigned integer type
+    WEAVE_ERROR CheckSchemaValidity(void) const;
+
+    // Read the profile id and status code of the current element
+    WEAVE_ERROR GetStatus(uint32_t * const apProfileId, uint16_t * const apStatusCode) const;
+
+    // WEAVE_END_OF_TLV if the current element doesn't carry a version
+    WEAVE_ERROR GetVersion(uint64_t * const apVersion) const;
+
+private:
+    WEAVE_ERROR GetReaderOnElementField(const uint8_t aContextTag, nl::Weave::TLV::TLVReader * const apReader) const;
+};
+
+class StatusList::Builder: public ListBuilderBase
+{
+public:
+
+    StatusList::Builder & AddStatus(const uint32_t aProfileId, const uint16_t aStatusCode);
+    StatusList::Builder & AddStatus(const uint32_t aProfileId, const uint16_t aStatusCode, const uint64_t aVersion);
+
+    // Mark the end of this array and recover the type for outer container
+    StatusList::Builder & EndOfStatusList(void);
+
+private:
+    StatusList::Builder & AddStatusElement(const uint32_t aProfileId, const uint16_t aStatusCode, const uint64_t * const apVersion);
+};
+
 namespace BaseMessageWithSubscribeId
 {
     enum
@@ -987,6 +1061,11 @@ public:
     // 4) any tag can only appear once
     WEAVE_ERROR CheckSchemaValidity(void) const;
 
+    // Same as above, but if aCheckDataElements is false, only the type of the data list
+    // is verified and the data elements it contains are left for the caller to check,
+    // one at a time, with DataList::Parser::CheckElementSchemaValidity
+    WEAVE_ERROR CheckSchemaValidity(const bool aCheckDataElements) const;
+
     // Get a TLVReader for the Paths. Next() must be called before accessing them.
     WEAVE_ERROR GetDataList(DataList::Parser * const apDataList) const;
 
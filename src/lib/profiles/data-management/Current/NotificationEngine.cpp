@@ -36,6 +36,7 @@
 
 #include <Weave/Profiles/status-report/StatusReportProfile.h>
 #include <Weave/Profiles/time/WeaveTime.h>
+#include <SystemLayer/SystemStats.h>
 
 using namespace ::nl::Weave;
 using namespace ::nl::Weave::TLV;
@@ -1455,7 +1456,10 @@ void NotificationEngine::Run()
         if (subHandler->IsNotifiable()) {
             // This is needed because some error could trigger abort on subscription, which leads to destroy of the handler
             subHandler->_AddRef();
-            err = BuildSingleNotifyRequest(subHandler, subscriptionHandled, isSubscriptionClean);
+            {
+                SYSTEM_STATS_HISTOGRAM_TIMER(nl::Weave::System::Stats::kHistogram_NotifyBuildTime);
+                err = BuildSingleNotifyRequest(subHandler, subscriptionHandled, isSubscriptionClean);
+            }
             SuccessOrExit(err);
 
             if (isSubscriptionClean) {
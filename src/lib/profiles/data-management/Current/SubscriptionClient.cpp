@@ -1231,11 +1231,25 @@ WEAVE_ERROR SubscriptionClient::ProcessDataList(nl::Weave::TLV::TLVReader &aRead
     // that get aborted and restarted within the same notify. See WEAV-1586 for more details.
     bool isPartialChange = false;
     uint8_t flags;
+    // The sink, if any, that has seen the beginning of a change but not yet its end.
+    // It is rolled back if processing of the data list fails before the change completes.
+    TraitDataSink *partialChangeSink = NULL;
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+    size_t numDataElements = 0;
+#endif
 
     while (WEAVE_NO_ERROR == (err = aReader.Next()))
     {
         nl::Weave::TLV::TLVReader pathReader;
 
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+        // the data elements were not covered by the pre-flight check, so verify each one right before it is consumed
+        err = DataList::Parser::CheckElementSchemaValidity(aReader);
+        SuccessOrExit(err);
+
+        ++numDataElements;
+#endif
+
         {
             DataElement::Parser element;
 
@@ -1300,6 +1314,7 @@ WEAVE_ERROR SubscriptionClient::ProcessDataList(nl::Weave::TLV::TLVReader &aRead
         SuccessOrExit(err);
 
         mPrevIsPartialChange = isPartialChange;
+        partialChangeSink = isPartialChange ? DataSink : NULL;
 
 #if WDM_ENABLE_PROTOCOL_CHECKS
         mPrevTraitDataHandle = handle;
@@ -1312,7 +1327,22 @@ WEAVE_ERROR SubscriptionClient::ProcessDataList(nl::Weave::TLV::TLVReader &aRead
         err = WEAVE_NO_ERROR;
     }
 
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+    // a data list must contain at least one data element
+    VerifyOrExit(numDataElements > 0, err = WEAVE_ERROR_INVALID_DATA_LIST);
+#endif
+
 exit:
+    if ((WEAVE_NO_ERROR != err) && (NULL != partialChangeSink))
+    {
+        // The rest of the change is never going to be applied. Invalidate the version of the sink,
+        // so the partially updated trait instance gets fully resynchronized instead of being trusted.
+        WeaveLogDetail(DataManagement, "Rolling back partial change on error");
+
+        partialChangeSink->AbortChange();
+        mPrevIsPartialChange = false;
+    }
+
     return err;
 }
 
@@ -1399,7 +1429,12 @@ void SubscriptionClient::NotificationRequestHandler (nl::Weave::ExchangeContext
 
 #if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
     // simple schema checking
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+    // data elements are verified one at a time in ProcessDataList
+    err = notify.CheckSchemaValidity(false);
+#else
     err = notify.CheckSchemaValidity();
+#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
     SuccessOrExit(err);
 #endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
 
@@ -327,6 +327,12 @@ void SubscriptionEngine::UnsolicitedMessageHandler (nl::Weave::ExchangeContext *
             func = OnCustomCommandRequest;
             break;
 
+#if WDM_PUBLISHER_ENABLE_UPDATES
+        case kMsgType_UpdateRequest:
+            func = OnUpdateRequest;
+            break;
+#endif // WDM_PUBLISHER_ENABLE_UPDATES
+
 #endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER
 
 #if WDM_ENABLE_SUBSCRIPTION_CANCEL
@@ -1154,6 +1160,315 @@ exit:
 }
 #endif // WDM_PUBLISHER_ENABLE_CUSTOM_COMMANDS
 
+#if WDM_PUBLISHER_ENABLE_UPDATES
+/**
+ * Handler for Update Requests. The response is a Status Report of Common:Success carrying an Update Response
+ * structure, which lists the status of every data element in the request, or an error Status Report if the
+ * request could not be processed at all.
+ * This function is a @ref ExchangeContext::MessageReceiveFunct.
+ */
+void SubscriptionEngine::OnUpdateRequest (nl::Weave::ExchangeContext *aEC, const nl::Inet::IPPacketInfo *aPktInfo,
+        const nl::Weave::WeaveMessageInfo *aMsgInfo, uint32_t aProfileId,
+        uint8_t aMsgType, PacketBuffer *aPayload)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    SubscriptionEngine * const pEngine = reinterpret_cast<SubscriptionEngine *>(aEC->AppState);
+    PacketBuffer * msgBuf = NULL;
+    uint32_t statusReportProfile = nl::Weave::Profiles::kWeaveProfile_WDM;
+    uint16_t statusReportCode = nl::Weave::Profiles::DataManagement::kStatus_GeneralSchemaViolation;
+    bool responseSent = false;
+
+    // WRM, in general, only works with WRM. Reject anything not requesting ACK immediately
+    // and do not propagate this request downstream.
+    VerifyOrExit(aEC->HasPeerRequestedAck(), err = WEAVE_ERROR_INVALID_TRANSFER_MODE);
+
+    if (!pEngine->mIsPublisherEnabled)
+    {
+        // Has to be a publisher to be processing an update request
+        statusReportProfile = nl::Weave::Profiles::kWeaveProfile_Common;
+        statusReportCode = nl::Weave::Profiles::Common::kStatus_UnsupportedMessage;
+        ExitNow(err = WEAVE_ERROR_INVALID_MESSAGE_TYPE);
+    }
+
+    msgBuf = PacketBuffer::New();
+    if (NULL == msgBuf)
+    {
+        statusReportProfile = nl::Weave::Profiles::kWeaveProfile_Common;
+        statusReportCode = nl::Weave::Profiles::Common::kStatus_OutOfMemory;
+        ExitNow(err = WEAVE_ERROR_NO_MEMORY);
+    }
+
+    {
+        nl::Weave::TLV::TLVReader reader;
+        nl::Weave::TLV::TLVWriter writer;
+        uint8_t * p = msgBuf->Start();
+
+        // Status Report header, followed by the Update Response as additional information
+        nl::Weave::Encoding::LittleEndian::Write32(p, nl::Weave::Profiles::kWeaveProfile_Common);
+        nl::Weave::Encoding::LittleEndian::Write16(p, nl::Weave::Profiles::Common::kStatus_Success);
+        msgBuf->SetDataLength(static_cast<uint16_t>(p - msgBuf->Start()));
+
+        reader.Init(aPayload);
+
+        err = reader.Next();
+        SuccessOrExit(err);
+
+        writer.Init(msgBuf);
+
+        err = pEngine->ProcessUpdateRequest(reader, writer);
+        SuccessOrExit(err);
+
+        err = writer.Finalize();
+        SuccessOrExit(err);
+    }
+
+    err = aEC->SendMessage(nl::Weave::Profiles::kWeaveProfile_Common, nl::Weave::Profiles::Common::kMsgType_StatusReport, msgBuf,
+            aEC->HasPeerRequestedAck() ? nl::Weave::ExchangeContext::kSendFlag_RequestAck : 0);
+    msgBuf = NULL;
+    responseSent = true;
+    SuccessOrExit(err);
+
+exit:
+    WeaveLogFunctError(err);
+
+    // aPayload is guaranteed to be non-NULL
+    PacketBuffer::Free(aPayload);
+
+    if (NULL != msgBuf)
+    {
+        PacketBuffer::Free(msgBuf);
+        msgBuf = NULL;
+    }
+
+    // Report the failure of the whole request, unless the request itself is not acceptable over this exchange
+    // or the response has already been handed over to the exchange
+    if ((WEAVE_NO_ERROR != err) && !responseSent && (WEAVE_ERROR_INVALID_TRANSFER_MODE != err))
+    {
+        err = SendStatusReport(aEC, statusReportProfile, statusReportCode);
+        WeaveLogFunctError(err);
+    }
+
+    // aEC is guaranteed to be non-NULL
+    aEC->Close();
+}
+
+WEAVE_ERROR SubscriptionEngine::ProcessUpdateRequest (nl::Weave::TLV::TLVReader & aReader, nl::Weave::TLV::TLVWriter & aWriter)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVType requestContainerType;
+    nl::Weave::TLV::TLVType responseContainerType;
+    DataList::Parser dataList;
+    StatusList::Builder statusList;
+    TraitDataSource * changeSource = NULL;
+    bool changeFailed = false;
+    uint32_t changeStatusProfile = nl::Weave::Profiles::kWeaveProfile_Common;
+    uint16_t changeStatusCode = nl::Weave::Profiles::Common::kStatus_Success;
+
+    VerifyOrExit(nl::Weave::TLV::kTLVType_Structure == aReader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    err = aReader.EnterContainer(requestContainerType);
+    SuccessOrExit(err);
+
+    err = dataList.InitIfPresent(aReader, UpdateRequest::kCsTag_DataList);
+    if (WEAVE_END_OF_TLV == err)
+    {
+        err = WEAVE_ERROR_INVALID_DATA_LIST;
+    }
+    SuccessOrExit(err);
+
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+    err = dataList.CheckSchemaValidity();
+    SuccessOrExit(err);
+#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+
+    err = aWriter.StartContainer(nl::Weave::TLV::AnonymousTag, nl::Weave::TLV::kTLVType_Structure, responseContainerType);
+    SuccessOrExit(err);
+
+    err = statusList.Init(&aWriter, UpdateResponse::kCsTag_StatusList);
+    SuccessOrExit(err);
+
+    // Consecutive data elements flagged as partial change, plus the first one that isn't, form a single change
+    // to one trait instance. The change is applied within one Lock/Unlock session, so it results in a single
+    // version increment. Once an element of a change fails, the rest of that change is skipped.
+    while (WEAVE_NO_ERROR == (err = dataList.Next()))
+    {
+        nl::Weave::TLV::TLVReader elementReader;
+        DataElement::Parser element;
+        bool isPartialChange = false;
+        uint32_t statusProfile = nl::Weave::Profiles::kWeaveProfile_Common;
+        uint16_t statusCode = nl::Weave::Profiles::Common::kStatus_Success;
+
+        dataList.GetReader(&elementReader);
+
+        err = element.Init(elementReader);
+        SuccessOrExit(err);
+
+        err = element.GetPartialChangeFlag(&isPartialChange);
+        VerifyOrExit((WEAVE_NO_ERROR == err) || (WEAVE_END_OF_TLV == err), );
+
+        if (changeFailed)
+        {
+            statusProfile = changeStatusProfile;
+            statusCode = changeStatusCode;
+        }
+        else
+        {
+            err = StoreUpdateDataElement(element, changeSource, statusProfile, statusCode);
+            if (WEAVE_NO_ERROR != err)
+            {
+                WeaveLogDetail(DataManagement, "Update rejected: %s", ErrorStr(err));
+
+                changeFailed = true;
+                changeStatusProfile = statusProfile;
+                changeStatusCode = statusCode;
+            }
+        }
+
+        if (isPartialChange)
+        {
+            statusList.AddStatus(statusProfile, statusCode);
+        }
+        else
+        {
+            if (NULL != changeSource)
+            {
+                changeSource->Unlock();
+            }
+
+            if (changeFailed || (NULL == changeSource))
+            {
+                statusList.AddStatus(statusProfile, statusCode);
+            }
+            else
+            {
+                // The last element of a successful change carries the resulting version
+                statusList.AddStatus(statusProfile, statusCode, changeSource->GetVersion());
+            }
+
+            changeSource = NULL;
+            changeFailed = false;
+        }
+
+        err = statusList.GetError();
+        SuccessOrExit(err);
+    }
+
+    // A data list that ends in the middle of a change is malformed
+    VerifyOrExit(WEAVE_END_OF_TLV == err, );
+    VerifyOrExit((NULL == changeSource) && !changeFailed, err = WEAVE_ERROR_INVALID_DATA_LIST);
+
+    statusList.EndOfStatusList();
+    err = statusList.GetError();
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(responseContainerType);
+    SuccessOrExit(err);
+
+exit:
+    WeaveLogFunctError(err);
+
+    if (NULL != changeSource)
+    {
+        changeSource->Unlock();
+    }
+
+    return err;
+}
+
+/**
+ * Store the data of one update data element into its trait data source. The first element of a change locates
+ * the source, checks its version condition, and locks it; the following ones must address the same source.
+ */
+WEAVE_ERROR SubscriptionEngine::StoreUpdateDataElement (const DataElement::Parser & aElement, TraitDataSource * & aChangeSource,
+        uint32_t & aStatusProfile, uint16_t & aStatusCode)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVReader pathReader;
+    nl::Weave::TLV::TLVReader dataReader;
+    TraitDataHandle traitDataHandle;
+    TraitDataSource * dataSource = NULL;
+    PropertyPathHandle pathHandle;
+    SchemaVersionRange requestedSchemaVersion, computedVersionIntersection;
+    uint64_t requiredVersion;
+
+    aStatusProfile = nl::Weave::Profiles::kWeaveProfile_WDM;
+    aStatusCode = nl::Weave::Profiles::DataManagement::kStatus_InvalidPath;
+
+    err = aElement.GetReaderOnPath(&pathReader);
+    SuccessOrExit(err);
+
+    err = mPublisherCatalog->AddressToHandle(pathReader, traitDataHandle, requestedSchemaVersion);
+    SuccessOrExit(err);
+
+    err = mPublisherCatalog->Locate(traitDataHandle, &dataSource);
+    SuccessOrExit(err);
+
+    if (NULL == aChangeSource)
+    {
+        if (!dataSource->GetSchemaEngine()->GetVersionIntersection(requestedSchemaVersion, computedVersionIntersection))
+        {
+            WeaveLogDetail(DataManagement, "Mismatch in requested version on handle %u (requested: %u, %u)", traitDataHandle, requestedSchemaVersion.mMaxVersion, requestedSchemaVersion.mMinVersion);
+
+            aStatusCode = nl::Weave::Profiles::DataManagement::kStatus_IncompatibleDataSchemaVersion;
+            ExitNow(err = WEAVE_ERROR_INCOMPATIBLE_SCHEMA_VERSION);
+        }
+
+        // The version in the first data element of a change, if present, is the version the source must be at
+        err = aElement.GetVersion(&requiredVersion);
+        if (WEAVE_NO_ERROR == err)
+        {
+            if (requiredVersion != dataSource->GetVersion())
+            {
+                WeaveLogDetail(DataManagement, "Version required 0x%" PRIX64 ", current: 0x%" PRIX64, requiredVersion, dataSource->GetVersion());
+
+                aStatusCode = nl::Weave::Profiles::DataManagement::kStatus_VersionMismatch;
+                ExitNow(err = WEAVE_ERROR_INCORRECT_STATE);
+            }
+        }
+        else if (WEAVE_END_OF_TLV == err)
+        {
+            err = WEAVE_NO_ERROR;
+        }
+        else
+        {
+            ExitNow();
+        }
+
+        err = dataSource->Lock();
+        SuccessOrExit(err);
+
+        aChangeSource = dataSource;
+    }
+    else
+    {
+        // All the data elements of a change must address the same trait instance
+        VerifyOrExit(dataSource == aChangeSource, err = WEAVE_ERROR_INVALID_DATA_LIST);
+    }
+
+    err = dataSource->GetSchemaEngine()->MapPathToHandle(pathReader, pathHandle);
+    SuccessOrExit(err);
+
+    aStatusCode = nl::Weave::Profiles::DataManagement::kStatus_GeneralSchemaViolation;
+
+    err = aElement.GetData(&dataReader);
+    SuccessOrExit(err);
+
+    err = dataSource->StoreData(pathHandle, dataReader);
+    if (WEAVE_ERROR_UNSUPPORTED_WEAVE_FEATURE == err)
+    {
+        aStatusProfile = nl::Weave::Profiles::kWeaveProfile_Common;
+        aStatusCode = nl::Weave::Profiles::Common::kStatus_UnsupportedMessage;
+    }
+    SuccessOrExit(err);
+
+    aStatusProfile = nl::Weave::Profiles::kWeaveProfile_Common;
+    aStatusCode = nl::Weave::Profiles::Common::kStatus_Success;
+
+exit:
+    return err;
+}
+#endif // WDM_PUBLISHER_ENABLE_UPDATES
+
 #endif // #if WDM_ENABLE_SUBSCRIPTION_PUBLISHER
 
 }; // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
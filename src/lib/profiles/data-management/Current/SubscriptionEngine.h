@@ -332,6 +332,19 @@ private:
         uint8_t aMsgType, PacketBuffer *aPayload);
 #endif // WDM_PUBLISHER_ENABLE_CUSTOM_COMMANDS
 
+#if WDM_PUBLISHER_ENABLE_UPDATES
+    static void OnUpdateRequest (nl::Weave::ExchangeContext *aEC, const nl::Inet::IPPacketInfo *aPktInfo,
+        const nl::Weave::WeaveMessageInfo *aMsgInfo, uint32_t aProfileId,
+        uint8_t aMsgType, PacketBuffer *aPayload);
+
+    // Apply the data list of an update request, positioned at aReader, to the published trait instances,
+    // and write the corresponding update response structure into aWriter
+    WEAVE_ERROR ProcessUpdateRequest (nl::Weave::TLV::TLVReader & aReader, nl::Weave::TLV::TLVWriter & aWriter);
+
+    WEAVE_ERROR StoreUpdateDataElement (const DataElement::Parser & aElement, TraitDataSource * & aChangeSource,
+        uint32_t & aStatusProfile, uint16_t & aStatusCode);
+#endif // WDM_PUBLISHER_ENABLE_UPDATES
+
 #endif // WDM_ENABLE_SUBSCRIPTION_PUBLISHER
 };
 
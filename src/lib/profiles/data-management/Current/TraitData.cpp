@@ -777,6 +777,57 @@ WEAVE_ERROR TraitDataSink::SetData(PropertyPathHandle aHandle,
     return err;
 }
 
+/*
+ * Presents the locally held values of a sink as a data source, so the schema engine can serialize them into an update request.
+ */
+class TraitDataSink::UpdateDataSource : public TraitSchemaEngine::IDataSourceDelegate
+{
+public:
+    UpdateDataSource(TraitDataSink *aSink) : mSink(aSink) { }
+
+    WEAVE_ERROR GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, TLVWriter &aWriter) __OVERRIDE
+    {
+        return mSink->GetLeafData(aLeafHandle, aTagToWrite, aWriter);
+    }
+
+    WEAVE_ERROR GetData(PropertyPathHandle aHandle, uint64_t aTagToWrite, TLVWriter &aWriter, bool &aIsNull, bool &aIsPresent) __OVERRIDE
+    {
+        WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+        aIsNull = false;
+        aIsPresent = true;
+        if (mSink->mSchemaEngine->IsLeaf(aHandle))
+        {
+            err = GetLeafData(aHandle, aTagToWrite, aWriter);
+        }
+
+        return err;
+    }
+
+#if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
+    // Dictionaries can only be updated item by item, so never enumerate their contents
+    WEAVE_ERROR GetNextDictionaryItemKey(PropertyPathHandle aDictionaryHandle, uintptr_t &aContext, PropertyDictionaryKey &aKey) __OVERRIDE
+    {
+        return WEAVE_END_OF_INPUT;
+    }
+#endif
+
+private:
+    TraitDataSink *mSink;
+};
+
+WEAVE_ERROR TraitDataSink::ReadData(PropertyPathHandle aHandle, uint64_t aTagToWrite, TLVWriter &aWriter)
+{
+    UpdateDataSource source(this);
+
+    return mSchemaEngine->RetrieveData(aHandle, aTagToWrite, aWriter, &source);
+}
+
+WEAVE_ERROR TraitDataSink::GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, TLVWriter &aWriter)
+{
+    return WEAVE_ERROR_UNSUPPORTED_WEAVE_FEATURE;
+}
+
 TraitDataSource::TraitDataSource(const TraitSchemaEngine *aEngine)
 {
     mVersion = 0;
@@ -854,6 +905,56 @@ WEAVE_ERROR TraitDataSource::ReadData(PropertyPathHandle aHandle, uint64_t aTagT
     return err;
 }
 
+/*
+ * Feeds the data of an update request into a source, through the same schema walk used to store notified data into sinks.
+ */
+class TraitDataSource::UpdateDataSink : public TraitSchemaEngine::IDataSinkDelegate
+{
+public:
+    UpdateDataSink(TraitDataSource *aSource) : mSource(aSource) { }
+
+    WEAVE_ERROR SetLeafData(PropertyPathHandle aLeafHandle, TLVReader &aReader) __OVERRIDE
+    {
+        return mSource->SetLeafData(aLeafHandle, aReader);
+    }
+
+    WEAVE_ERROR SetData(PropertyPathHandle aHandle, TLVReader &aReader, bool aIsNull) __OVERRIDE
+    {
+        WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+        if (mSource->mSchemaEngine->IsLeaf(aHandle))
+        {
+            err = SetLeafData(aHandle, aReader);
+        }
+
+        return err;
+    }
+
+    void OnDataSinkEvent(DataSinkEventType aType, PropertyPathHandle aHandle) __OVERRIDE { }
+
+private:
+    TraitDataSource *mSource;
+};
+
+WEAVE_ERROR TraitDataSource::StoreData(PropertyPathHandle aHandle, TLVReader &aReader)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    UpdateDataSink sink(this);
+
+    err = mSchemaEngine->StoreData(aHandle, aReader, &sink);
+    SuccessOrExit(err);
+
+    SetDirty(aHandle);
+
+exit:
+    return err;
+}
+
+WEAVE_ERROR TraitDataSource::SetLeafData(PropertyPathHandle aLeafHandle, TLVReader &aReader)
+{
+    return WEAVE_ERROR_UNSUPPORTED_WEAVE_FEATURE;
+}
+
 void TraitDataSource::SetDirty(PropertyPathHandle aPropertyHandle)
 {
     if (aPropertyHandle != kNullPropertyPathHandle) {
@@ -467,6 +467,21 @@ public:
      */
     bool IsVersionValid(void) const { return mHasValidVersion; }
 
+    /**
+     * Abandons a change that was started with kFirstElementInChange but is never going to be completed. The version of this sink is
+     * invalidated, so the partially applied data is not trusted and gets refreshed in full by the publisher.
+     */
+    void AbortChange(void) { mHasValidVersion = false; }
+
+    /**
+     * Given a path handle and a writer, retrieve the locally held value of that property from this sink by invoking GetLeafData, and
+     * write it out in a schema compliant manner. This is used by the update client to compose update requests.
+     *
+     * @retval #WEAVE_NO_ERROR On success.
+     * @retval other           Encountered errors writing out the data.
+     */
+    WEAVE_ERROR ReadData(PropertyPathHandle aHandle, uint64_t aTagToWrite, TLV::TLVWriter &aWriter);
+
     /**
      * Convenience function for data sinks to handle unknown leaf handles with
      * a system level tolerance for mismatched schema as defined by
@@ -582,8 +597,15 @@ protected: // IDataSinkDelegate
     /* Subclass can invoke this to clear out their version */
     void ClearVersion(void) { mHasValidVersion = false; }
 
+    /* Sinks that are updated through the update client override this to provide the locally mutated value of a leaf property.
+     * The default implementation returns WEAVE_ERROR_UNSUPPORTED_WEAVE_FEATURE.
+     */
+    virtual WEAVE_ERROR GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, nl::Weave::TLV::TLVWriter &aWriter);
+
     const TraitSchemaEngine *mSchemaEngine;
 private:
+    class UpdateDataSource;
+
     void OnDataSinkEvent(DataSinkEventType aType, PropertyPathHandle aHandle) __OVERRIDE;
 
     uint64_t mVersion;
@@ -604,6 +626,17 @@ public:
 
     WEAVE_ERROR ReadData(PropertyPathHandle aHandle, uint64_t aTagToWrite, TLV::TLVWriter &aWriter);
 
+    /**
+     * Given a path handle and a reader positioned on the data of a data element received in an update request, store the data into
+     * this source by invoking SetLeafData whenever a leaf data item is encountered, and mark the path dirty. This has to be called
+     * within a locked context, so that all the paths of a change are covered by a single version increment.
+     *
+     * @retval #WEAVE_NO_ERROR                          On success.
+     * @retval #WEAVE_ERROR_UNSUPPORTED_WEAVE_FEATURE   If this source doesn't accept updates.
+     * @retval other                                    Encountered errors parsing/processing the data.
+     */
+    WEAVE_ERROR StoreData(PropertyPathHandle aHandle, TLV::TLVReader &aReader);
+
     /* Interactions with the underlying data has to always be done within a locked context. This applies to both the app logic (e.g a publisher when modifying its source data)
      * as well as to the core WDM logic (when trying to access that published data). This is required of both publishers and clients.
      */
@@ -657,6 +690,11 @@ protected: // IDataSourceDelegate
 
     virtual WEAVE_ERROR GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, nl::Weave::TLV::TLVWriter &aWriter)  __OVERRIDE = 0 ;
 
+    /* Sources that accept update requests override this to store the new value of a leaf property.
+     * The default implementation returns WEAVE_ERROR_UNSUPPORTED_WEAVE_FEATURE, which rejects the update.
+     */
+    virtual WEAVE_ERROR SetLeafData(PropertyPathHandle aLeafHandle, nl::Weave::TLV::TLVReader &aReader);
+
 #if TDM_ENABLE_PUBLISHER_DICTIONARY_SUPPORT
     virtual WEAVE_ERROR GetNextDictionaryItemKey(PropertyPathHandle aDictionaryHandle, uintptr_t &aContext, PropertyDictionaryKey &aKey) __OVERRIDE { return WEAVE_ERROR_INVALID_ARGUMENT; }
 #endif
@@ -669,6 +707,7 @@ protected: // IDataSourceDelegate
 
     const TraitSchemaEngine *mSchemaEngine;
 private:
+    class UpdateDataSink;
 
     // Tracks whether SetDirty was called within a Lock/Unlock 'session'
     bool mSetDirtyCalled;
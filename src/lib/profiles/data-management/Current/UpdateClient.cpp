@@ -0,0 +1,652 @@
+/*
+ *
+ *    Copyright (c) 2016-2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the Update Client for Weave
+ *      Data Management (WDM) profile.
+ *
+ */
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif // __STDC_FORMAT_MACROS
+
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+#include <Weave/Profiles/data-management/DataManagement.h>
+#include <Weave/Profiles/status-report/StatusReportProfile.h>
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+
+UpdateClient::UpdateClient () :
+    mCurrentState(kState_Canceled),
+    mBinding(NULL),
+    mAppState(NULL),
+    mEventCallback(NULL),
+    mDataSinkCatalog(NULL),
+    mFlushRequested(false),
+    mNumPendingPaths(0)
+{
+    for (size_t i = 0; i < WDM_UPDATE_CLIENT_MAX_IN_FLIGHT; ++i)
+    {
+        mRequests[i].mClient = this;
+        mRequests[i].mEC = NULL;
+        mRequests[i].mNumPaths = 0;
+        mRequests[i].mNumPathsDone = 0;
+    }
+}
+
+// AddRef to Binding
+// store pointers to binding, app state, and catalog
+WEAVE_ERROR UpdateClient::Init (Binding * const apBinding, void * const apAppState, EventCallback const aEventCallback,
+        TraitCatalogBase<TraitDataSink> * const apCatalog)
+{
+    // drop whatever state a previous use left behind
+    (void)Cancel ();
+
+    // add reference to the binding
+    apBinding->AddRef();
+
+    // make a copy of the pointers
+    mBinding = apBinding;
+    mAppState = apAppState;
+    mEventCallback = aEventCallback;
+    mDataSinkCatalog = apCatalog;
+
+    mCurrentState = kState_Initialized;
+
+    return WEAVE_NO_ERROR;
+}
+
+WEAVE_ERROR UpdateClient::SetUpdated (TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyPathHandle, bool aIsConditional)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TraitDataSink * pDataSink;
+    const TraitSchemaEngine * pSchemaEngine;
+    size_t i;
+
+    VerifyOrExit(kState_Initialized == mCurrentState, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    err = mDataSinkCatalog->Locate(aTraitDataHandle, &pDataSink);
+    SuccessOrExit(err);
+
+    // A conditional update is checked against the version the sink holds
+    VerifyOrExit(!aIsConditional || pDataSink->IsVersionValid(), err = WEAVE_ERROR_INCORRECT_STATE);
+
+    pSchemaEngine = pDataSink->GetSchemaEngine();
+
+    // Nothing to add if the path is already covered by a pending one
+    for (i = 0; i < mNumPendingPaths; ++i)
+    {
+        PendingPath & pending = mPendingPaths[i];
+
+        if ((pending.mPath.mTraitDataHandle == aTraitDataHandle) &&
+            IsCovering(pSchemaEngine, pending.mPath.mPropertyPathHandle, aPropertyPathHandle))
+        {
+            pending.mIsConditional = pending.mIsConditional || aIsConditional;
+            ExitNow();
+        }
+    }
+
+    // Drop the pending paths the new one covers, preserving the order of the rest
+    i = 0;
+    while (i < mNumPendingPaths)
+    {
+        PendingPath & pending = mPendingPaths[i];
+
+        if ((pending.mPath.mTraitDataHandle == aTraitDataHandle) &&
+            IsCovering(pSchemaEngine, aPropertyPathHandle, pending.mPath.mPropertyPathHandle))
+        {
+            aIsConditional = aIsConditional || pending.mIsConditional;
+
+            for (size_t j = i + 1; j < mNumPendingPaths; ++j)
+            {
+                mPendingPaths[j - 1] = mPendingPaths[j];
+            }
+            --mNumPendingPaths;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    VerifyOrExit(mNumPendingPaths < WDM_UPDATE_CLIENT_MAX_PENDING_PATHS, err = WEAVE_ERROR_NO_MEMORY);
+
+    mPendingPaths[mNumPendingPaths].mPath = TraitPath(aTraitDataHandle, aPropertyPathHandle);
+    mPendingPaths[mNumPendingPaths].mIsConditional = aIsConditional;
+    ++mNumPendingPaths;
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+WEAVE_ERROR UpdateClient::FlushUpdate (void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    InFlightRequest * pRequest = NULL;
+
+    VerifyOrExit(kState_Initialized == mCurrentState, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    mFlushRequested = false;
+
+    VerifyOrExit(mNumPendingPaths > 0, );
+
+    for (size_t i = 0; i < WDM_UPDATE_CLIENT_MAX_IN_FLIGHT; ++i)
+    {
+        if (mRequests[i].IsFree())
+        {
+            pRequest = &mRequests[i];
+            break;
+        }
+    }
+
+    // All request slots are busy; the pending paths go out as soon as one completes
+    if (NULL == pRequest)
+    {
+        mFlushRequested = true;
+        ExitNow();
+    }
+
+    MovePendingPaths(*pRequest);
+
+    // Whatever is still pending waits for an earlier conditional update of the same trait instance
+    mFlushRequested = (mNumPendingPaths > 0);
+
+    VerifyOrExit(!pRequest->IsFree(), );
+
+    err = SendRequest(*pRequest);
+    if (WEAVE_NO_ERROR != err)
+    {
+        CompleteRequest(*pRequest, err);
+    }
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+// release binding, close all ECs, drop all paths
+WEAVE_ERROR UpdateClient::Cancel (void)
+{
+    if (kState_Canceled != mCurrentState)
+    {
+        mEventCallback = NULL;
+
+        if (NULL != mBinding)
+        {
+            mBinding->Release();
+            mBinding = NULL;
+        }
+
+        for (size_t i = 0; i < WDM_UPDATE_CLIENT_MAX_IN_FLIGHT; ++i)
+        {
+            if (NULL != mRequests[i].mEC)
+            {
+                mRequests[i].mEC->Close();
+                mRequests[i].mEC = NULL;
+            }
+
+            mRequests[i].mNumPaths = 0;
+            mRequests[i].mNumPathsDone = 0;
+        }
+
+        mNumPendingPaths = 0;
+        mFlushRequested = false;
+        mDataSinkCatalog = NULL;
+
+        mCurrentState = kState_Canceled;
+        mAppState = NULL;
+    }
+
+    return WEAVE_NO_ERROR;
+}
+
+size_t UpdateClient::GetNumRequestsInFlight (void) const
+{
+    size_t numRequests = 0;
+
+    for (size_t i = 0; i < WDM_UPDATE_CLIENT_MAX_IN_FLIGHT; ++i)
+    {
+        if (!mRequests[i].IsFree())
+        {
+            ++numRequests;
+        }
+    }
+
+    return numRequests;
+}
+
+bool UpdateClient::IsCovering (const TraitSchemaEngine * const apSchemaEngine, PropertyPathHandle aAncestorHandle,
+        PropertyPathHandle aPropertyPathHandle)
+{
+    // IsParent stops at the root, which covers everything
+    return (kRootPropertyPathHandle == aAncestorHandle) || apSchemaEngine->IsParent(aPropertyPathHandle, aAncestorHandle);
+}
+
+bool UpdateClient::IsConditionalInFlight (TraitDataHandle aTraitDataHandle) const
+{
+    for (size_t i = 0; i < WDM_UPDATE_CLIENT_MAX_IN_FLIGHT; ++i)
+    {
+        for (size_t j = 0; j < mRequests[i].mNumPaths; ++j)
+        {
+            if ((mRequests[i].mPaths[j].mPath.mTraitDataHandle == aTraitDataHandle) && mRequests[i].mPaths[j].mIsConditional)
+            {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+void UpdateClient::MovePendingPaths (InFlightRequest & aRequest)
+{
+    bool isMoved[WDM_UPDATE_CLIENT_MAX_PENDING_PATHS] = { false };
+    size_t numRemaining = 0;
+
+    aRequest.mNumPaths = 0;
+    aRequest.mNumPathsDone = 0;
+
+    for (size_t i = 0; i < mNumPendingPaths; ++i)
+    {
+        const TraitDataHandle traitDataHandle = mPendingPaths[i].mPath.mTraitDataHandle;
+        bool isConditional = false;
+        bool isGroupStart = true;
+
+        for (size_t j = 0; j < i; ++j)
+        {
+            if (mPendingPaths[j].mPath.mTraitDataHandle == traitDataHandle)
+            {
+                isGroupStart = false;
+                break;
+            }
+        }
+
+        if (!isGroupStart)
+        {
+            continue;
+        }
+
+        // All the paths of a trait instance form a single change, which is conditional if any of them is
+        for (size_t j = i; j < mNumPendingPaths; ++j)
+        {
+            if (mPendingPaths[j].mPath.mTraitDataHandle == traitDataHandle)
+            {
+                isConditional = isConditional || mPendingPaths[j].mIsConditional;
+            }
+        }
+
+        // A conditional change has to be checked against the version resulting from an earlier one
+        if (isConditional && IsConditionalInFlight(traitDataHandle))
+        {
+            continue;
+        }
+
+        for (size_t j = i; j < mNumPendingPaths; ++j)
+        {
+            if (mPendingPaths[j].mPath.mTraitDataHandle == traitDataHandle)
+            {
+                aRequest.mPaths[aRequest.mNumPaths] = mPendingPaths[j];
+                aRequest.mPaths[aRequest.mNumPaths].mIsConditional = isConditional;
+                ++aRequest.mNumPaths;
+                isMoved[j] = true;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < mNumPendingPaths; ++i)
+    {
+        if (!isMoved[i])
+        {
+            mPendingPaths[numRemaining++] = mPendingPaths[i];
+        }
+    }
+
+    mNumPendingPaths = numRemaining;
+}
+
+WEAVE_ERROR UpdateClient::SendRequest (InFlightRequest & aRequest)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    PacketBuffer *MsgBuf = NULL;
+
+    MsgBuf = PacketBuffer::New();
+    VerifyOrExit(NULL != MsgBuf, err = WEAVE_ERROR_NO_MEMORY);
+
+    {
+        nl::Weave::TLV::TLVWriter writer;
+        writer.Init(MsgBuf);
+
+        err = BuildUpdateRequest(aRequest, writer);
+        SuccessOrExit(err);
+
+        err = writer.Finalize();
+        SuccessOrExit(err);
+    }
+
+    err = mBinding->NewExchangeContext(aRequest.mEC);
+    SuccessOrExit(err);
+
+    aRequest.mEC->AppState = &aRequest;
+    aRequest.mEC->OnMessageReceived = OnMessageReceived;
+    aRequest.mEC->OnResponseTimeout = OnResponseTimeout;
+    aRequest.mEC->OnSendError = OnSendError;
+
+    err = aRequest.mEC->SendMessage(nl::Weave::Profiles::kWeaveProfile_WDM, kMsgType_UpdateRequest, MsgBuf,
+            nl::Weave::ExchangeContext::kSendFlag_ExpectResponse);
+    MsgBuf = NULL;
+    SuccessOrExit(err);
+
+exit:
+    WeaveLogFunctError(err);
+
+    if (NULL != MsgBuf)
+    {
+        PacketBuffer::Free(MsgBuf);
+        MsgBuf = NULL;
+    }
+
+    return err;
+}
+
+WEAVE_ERROR UpdateClient::BuildUpdateRequest (const InFlightRequest & aRequest, nl::Weave::TLV::TLVWriter & aWriter)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::TLV::TLVType dummyContainerType;
+    DataList::Builder dataList;
+    SchemaVersionRange requestedSchemaVersionRange;
+
+    err = aWriter.StartContainer(nl::Weave::TLV::AnonymousTag, nl::Weave::TLV::kTLVType_Structure, dummyContainerType);
+    SuccessOrExit(err);
+
+    err = dataList.Init(&aWriter, UpdateRequest::kCsTag_DataList);
+    SuccessOrExit(err);
+
+    for (size_t i = 0; i < aRequest.mNumPaths; ++i)
+    {
+        const TraitPath & path = aRequest.mPaths[i].mPath;
+        const bool isFirstOfChange = (0 == i) || (aRequest.mPaths[i - 1].mPath.mTraitDataHandle != path.mTraitDataHandle);
+        const bool isLastOfChange = ((i + 1) == aRequest.mNumPaths) || (aRequest.mPaths[i + 1].mPath.mTraitDataHandle != path.mTraitDataHandle);
+        TraitDataSink * pDataSink;
+        nl::Weave::TLV::TLVType dummyContainerType2;
+        nl::Weave::TLV::TLVType dummyContainerType3;
+
+        err = mDataSinkCatalog->Locate(path.mTraitDataHandle, &pDataSink);
+        SuccessOrExit(err);
+
+        err = aWriter.StartContainer(nl::Weave::TLV::AnonymousTag, nl::Weave::TLV::kTLVType_Structure, dummyContainerType2);
+        SuccessOrExit(err);
+
+        // Start the TLV Path
+        err = aWriter.StartContainer(nl::Weave::TLV::ContextTag(DataElement::kCsTag_Path), nl::Weave::TLV::kTLVType_Path, dummyContainerType3);
+        SuccessOrExit(err);
+
+        // Start, fill, and close the TLV Structure that contains ResourceID, ProfileID, and InstanceID
+        err = mDataSinkCatalog->HandleToAddress(path.mTraitDataHandle, aWriter, requestedSchemaVersionRange);
+        SuccessOrExit(err);
+
+        // Append zero or more TLV tags based on the Path Handle
+        err = pDataSink->GetSchemaEngine()->MapHandleToPath(path.mPropertyPathHandle, aWriter);
+        SuccessOrExit(err);
+
+        // Close the TLV Path
+        err = aWriter.EndContainer(dummyContainerType3);
+        SuccessOrExit(err);
+
+        // The version the publisher has to be at for a conditional change is carried by its first data element
+        if (isFirstOfChange && aRequest.mPaths[i].mIsConditional)
+        {
+            err = aWriter.Put(nl::Weave::TLV::ContextTag(DataElement::kCsTag_Version), pDataSink->GetVersion());
+            SuccessOrExit(err);
+        }
+
+        if (!isLastOfChange)
+        {
+            err = aWriter.PutBoolean(nl::Weave::TLV::ContextTag(DataElement::kCsTag_IsPartialChange), true);
+            SuccessOrExit(err);
+        }
+
+        err = pDataSink->ReadData(path.mPropertyPathHandle, nl::Weave::TLV::ContextTag(DataElement::kCsTag_Data), aWriter);
+        SuccessOrExit(err);
+
+        err = aWriter.EndContainer(dummyContainerType2);
+        SuccessOrExit(err);
+    }
+
+    err = dataList.EndOfDataList().GetError();
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(dummyContainerType);
+    SuccessOrExit(err);
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+WEAVE_ERROR UpdateClient::ProcessUpdateResponse (InFlightRequest & aRequest, PacketBuffer * aPayload)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::Profiles::StatusReporting::StatusReport status;
+    nl::Weave::TLV::TLVReader reader;
+    nl::Weave::TLV::TLVType dummyContainerType;
+    StatusList::Parser statusList;
+
+    err = nl::Weave::Profiles::StatusReporting::StatusReport::parse(aPayload, status);
+    SuccessOrExit(err);
+
+    if (!status.success())
+    {
+        // The request as a whole has been rejected
+        FailPaths(aRequest, WEAVE_ERROR_STATUS_REPORT_RECEIVED, status.mProfileId, status.mStatusCode);
+        ExitNow(err = WEAVE_ERROR_STATUS_REPORT_RECEIVED);
+    }
+
+    reader.Init(status.mAdditionalInfo.theData, status.mAdditionalInfo.theLength);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    VerifyOrExit(nl::Weave::TLV::kTLVType_Structure == reader.GetType(), err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    err = reader.EnterContainer(dummyContainerType);
+    SuccessOrExit(err);
+
+    err = statusList.InitIfPresent(reader, UpdateResponse::kCsTag_StatusList);
+    SuccessOrExit(err);
+
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+    err = statusList.CheckSchemaValidity();
+    SuccessOrExit(err);
+#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+
+    // There is one status element per data element, in the same order
+    while (WEAVE_NO_ERROR == (err = statusList.Next()))
+    {
+        uint32_t statusProfileId;
+        uint16_t statusCode;
+        uint64_t version = 0;
+        bool isVersionValid = false;
+
+        // The app may cancel this client from within the callback
+        VerifyOrExit(kState_Initialized == mCurrentState, err = WEAVE_ERROR_INCORRECT_STATE);
+        VerifyOrExit(aRequest.mNumPathsDone < aRequest.mNumPaths, err = WEAVE_ERROR_INVALID_LIST_LENGTH);
+
+        err = statusList.GetStatus(&statusProfileId, &statusCode);
+        SuccessOrExit(err);
+
+        err = statusList.GetVersion(&version);
+        if (WEAVE_NO_ERROR == err)
+        {
+            isVersionValid = true;
+        }
+        else if (WEAVE_END_OF_TLV == err)
+        {
+            err = WEAVE_NO_ERROR;
+        }
+        SuccessOrExit(err);
+
+        DeliverPathStatus(aRequest.mPaths[aRequest.mNumPathsDone++], WEAVE_NO_ERROR, statusProfileId, statusCode, isVersionValid, version);
+    }
+
+    VerifyOrExit(WEAVE_END_OF_TLV == err, );
+    VerifyOrExit(aRequest.mNumPathsDone == aRequest.mNumPaths, err = WEAVE_ERROR_INVALID_LIST_LENGTH);
+
+    err = WEAVE_NO_ERROR;
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+void UpdateClient::DeliverPathStatus (const PendingPath & aPath, WEAVE_ERROR aReason, uint32_t aStatusProfileId, uint16_t aStatusCode,
+        bool aIsVersionValid, uint64_t aVersion)
+{
+    EventParam Param;
+
+    if ((kState_Initialized == mCurrentState) && (NULL != mEventCallback))
+    {
+        Param.mPathStatusEventParam.mTraitDataHandle = aPath.mPath.mTraitDataHandle;
+        Param.mPathStatusEventParam.mPropertyPathHandle = aPath.mPath.mPropertyPathHandle;
+        Param.mPathStatusEventParam.mStatusProfileId = aStatusProfileId;
+        Param.mPathStatusEventParam.mStatusCode = aStatusCode;
+        Param.mPathStatusEventParam.mIsVersionValid = aIsVersionValid;
+        Param.mPathStatusEventParam.mVersion = aVersion;
+
+        mEventCallback(mAppState, kEvent_PathStatus, aReason, Param);
+    }
+}
+
+void UpdateClient::FailPaths (InFlightRequest & aRequest, WEAVE_ERROR aReason, uint32_t aStatusProfileId, uint16_t aStatusCode)
+{
+    while ((aRequest.mNumPathsDone < aRequest.mNumPaths) && (kState_Initialized == mCurrentState))
+    {
+        DeliverPathStatus(aRequest.mPaths[aRequest.mNumPathsDone++], aReason, aStatusProfileId, aStatusCode, false, 0);
+    }
+}
+
+void UpdateClient::CompleteRequest (InFlightRequest & aRequest, WEAVE_ERROR aReason)
+{
+    EventParam Param;
+    size_t numPaths;
+
+    // Cancel might have been called from within a callback
+    VerifyOrExit(!aRequest.IsFree(), );
+
+    if (NULL != aRequest.mEC)
+    {
+        aRequest.mEC->Close();
+        aRequest.mEC = NULL;
+    }
+
+    if (WEAVE_NO_ERROR != aReason)
+    {
+        FailPaths(aRequest, aReason, nl::Weave::Profiles::kWeaveProfile_Common, nl::Weave::Profiles::Common::kStatus_InternalError);
+    }
+
+    numPaths = aRequest.mNumPaths;
+    aRequest.mNumPaths = 0;
+    aRequest.mNumPathsDone = 0;
+
+    VerifyOrExit(kState_Initialized == mCurrentState, );
+
+    if (NULL != mEventCallback)
+    {
+        Param.mUpdateCompleteEventParam.mNumPaths = numPaths;
+        mEventCallback(mAppState, kEvent_UpdateComplete, aReason, Param);
+    }
+
+    // Paths that have been waiting for a request slot, or for this request, go out now
+    if ((kState_Initialized == mCurrentState) && mFlushRequested)
+    {
+        (void)FlushUpdate();
+    }
+
+exit:
+    return;
+}
+
+void UpdateClient::OnSendError (ExchangeContext *aEC, WEAVE_ERROR aErrorCode, void *aMsgSpecificContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    InFlightRequest * const pRequest = reinterpret_cast<InFlightRequest *>(aEC->AppState);
+
+    VerifyOrExit(aEC == pRequest->mEC, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    pRequest->mClient->CompleteRequest(*pRequest, aErrorCode);
+
+exit:
+    WeaveLogFunctError(err);
+}
+
+void UpdateClient::OnResponseTimeout (nl::Weave::ExchangeContext *aEC)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    InFlightRequest * const pRequest = reinterpret_cast<InFlightRequest *>(aEC->AppState);
+
+    VerifyOrExit(aEC == pRequest->mEC, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    pRequest->mClient->CompleteRequest(*pRequest, WEAVE_ERROR_TIMEOUT);
+
+exit:
+    WeaveLogFunctError(err);
+}
+
+void UpdateClient::OnMessageReceived (nl::Weave::ExchangeContext *aEC, const nl::Inet::IPPacketInfo *aPktInfo,
+    const nl::Weave::WeaveMessageInfo *aMsgInfo, uint32_t aProfileId,
+    uint8_t aMsgType, PacketBuffer *aPayload)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    InFlightRequest * const pRequest = reinterpret_cast<InFlightRequest *>(aEC->AppState);
+
+    VerifyOrExit(aEC == pRequest->mEC, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    if ((nl::Weave::Profiles::kWeaveProfile_Common == aProfileId) && (nl::Weave::Profiles::Common::kMsgType_StatusReport == aMsgType))
+    {
+        err = pRequest->mClient->ProcessUpdateResponse(*pRequest, aPayload);
+    }
+    else
+    {
+        err = WEAVE_ERROR_INVALID_MESSAGE_TYPE;
+    }
+
+    pRequest->mClient->CompleteRequest(*pRequest, err);
+
+exit:
+    WeaveLogFunctError(err);
+
+    PacketBuffer::Free(aPayload);
+}
+
+}; // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+}; // Profiles
+}; // Weave
+}; // nl
+
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
@@ -0,0 +1,195 @@
+/*
+ *
+ *    Copyright (c) 2016-2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the Update Client for Weave
+ *      Data Management (WDM) profile.
+ *
+ *      The update client collects mutations to properties of local
+ *      trait data sinks, coalesces them, and sends them to the
+ *      publisher in batched update requests, keeping a bounded
+ *      number of requests in flight at a time.
+ *
+ */
+
+#ifndef _WEAVE_DATA_MANAGEMENT_UPDATE_CLIENT_CURRENT_H
+#define _WEAVE_DATA_MANAGEMENT_UPDATE_CLIENT_CURRENT_H
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif // __STDC_FORMAT_MACROS
+
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Profiles/data-management/MessageDef.h>
+#include <Weave/Profiles/data-management/TraitCatalog.h>
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+
+class UpdateClient
+{
+public:
+
+    enum EventID
+    {
+        // The outcome of one updated path is known. mStatusProfileId/mStatusCode is Common:Success if the
+        // publisher applied the path. If the whole request failed, the error code is set and the status is
+        // either the one reported by the publisher or Common:InternalError
+        kEvent_PathStatus                   = 1,
+
+        // An update request has completed, after all its kEvent_PathStatus events have been delivered.
+        // Pending paths, if any, are flushed right after this callback returns if a flush was requested earlier
+        kEvent_UpdateComplete               = 2,
+    };
+
+    // union of structures for each event some of them might be empty
+    union EventParam
+    {
+        // kEvent_PathStatus
+        struct
+        {
+            TraitDataHandle mTraitDataHandle;
+            PropertyPathHandle mPropertyPathHandle;
+            uint32_t mStatusProfileId;
+            uint16_t mStatusCode;
+
+            // True if the publisher reported the version of the trait instance after this update
+            bool mIsVersionValid;
+            uint64_t mVersion;
+        } mPathStatusEventParam;
+
+        // kEvent_UpdateComplete
+        struct
+        {
+            // Number of paths carried by the completed request
+            size_t mNumPaths;
+        } mUpdateCompleteEventParam;
+    };
+
+    typedef void (*EventCallback) (void * const aAppState, EventID aEvent, WEAVE_ERROR aErrorCode, EventParam & aEventParam);
+
+    // Start out canceled
+    UpdateClient (void);
+
+    // AddRef to Binding
+    // store pointers to binding, delegate, and the catalog of sinks whose properties are updated
+    WEAVE_ERROR Init (Binding * const apBinding, void * const apAppState, EventCallback const aEventCallback,
+        TraitCatalogBase<TraitDataSink> * const apCatalog);
+
+    // Mark a property path of a local sink as updated. The path is coalesced with the paths already pending:
+    // nothing is added if the path or one of its ancestors is already pending, and pending descendants are
+    // replaced by the path. A conditional update is only applied by the publisher if its trait instance is
+    // still at the version the sink currently holds.
+    // WEAVE_ERROR_INCORRECT_STATE if the update is conditional but the sink doesn't hold a valid version
+    // WEAVE_ERROR_NO_MEMORY if WDM_UPDATE_CLIENT_MAX_PENDING_PATHS paths are already pending
+    WEAVE_ERROR SetUpdated (TraitDataHandle aTraitDataHandle, PropertyPathHandle aPropertyPathHandle, bool aIsConditional);
+
+    // Send the pending paths in a single update request. If WDM_UPDATE_CLIENT_MAX_IN_FLIGHT requests are
+    // already outstanding, or some conditional paths have to wait for an earlier conditional update of the same
+    // trait instance, the remaining paths are sent as soon as a request completes
+    WEAVE_ERROR FlushUpdate (void);
+
+    // Abort all outstanding requests and drop all pending paths, release binding
+    WEAVE_ERROR Cancel (void);
+
+    size_t GetNumPendingPaths (void) const { return mNumPendingPaths; }
+    size_t GetNumRequestsInFlight (void) const;
+
+private:
+    friend class TestTdm;
+
+    struct PendingPath
+    {
+        TraitPath mPath;
+        bool mIsConditional;
+    };
+
+    struct InFlightRequest
+    {
+        UpdateClient * mClient;
+        nl::Weave::ExchangeContext * mEC;
+        size_t mNumPaths;
+
+        // Number of paths whose status has already been delivered
+        size_t mNumPathsDone;
+
+        // Paths in the order they appear in the data list, grouped by trait instance
+        PendingPath mPaths[WDM_UPDATE_CLIENT_MAX_PENDING_PATHS];
+
+        bool IsFree (void) const { return (0 == mNumPaths); }
+    };
+
+    enum
+    {
+        kState_Canceled         = 1,
+        kState_Initialized      = 2,
+    } mCurrentState;
+
+    Binding * mBinding;
+    void * mAppState;
+    EventCallback mEventCallback;
+    TraitCatalogBase<TraitDataSink> * mDataSinkCatalog;
+    bool mFlushRequested;
+
+    size_t mNumPendingPaths;
+    PendingPath mPendingPaths[WDM_UPDATE_CLIENT_MAX_PENDING_PATHS];
+    InFlightRequest mRequests[WDM_UPDATE_CLIENT_MAX_IN_FLIGHT];
+
+    static bool IsCovering (const TraitSchemaEngine * const apSchemaEngine, PropertyPathHandle aAncestorHandle,
+        PropertyPathHandle aPropertyPathHandle);
+    bool IsConditionalInFlight (TraitDataHandle aTraitDataHandle) const;
+
+    // Move the pending paths that can be sent now into aRequest, grouped by trait instance
+    void MovePendingPaths (InFlightRequest & aRequest);
+
+    // Compose the update request for aRequest and send it over a new exchange context
+    WEAVE_ERROR SendRequest (InFlightRequest & aRequest);
+
+    // Write the update request for aRequest
+    WEAVE_ERROR BuildUpdateRequest (const InFlightRequest & aRequest, nl::Weave::TLV::TLVWriter & aWriter);
+
+    // Deliver kEvent_PathStatus for every path of aRequest out of the Status Report in aPayload
+    WEAVE_ERROR ProcessUpdateResponse (InFlightRequest & aRequest, PacketBuffer * aPayload);
+
+    void DeliverPathStatus (const PendingPath & aPath, WEAVE_ERROR aReason, uint32_t aStatusProfileId, uint16_t aStatusCode,
+        bool aIsVersionValid, uint64_t aVersion);
+
+    // Deliver kEvent_PathStatus with the given status for every path of aRequest not reported yet
+    void FailPaths (InFlightRequest & aRequest, WEAVE_ERROR aReason, uint32_t aStatusProfileId, uint16_t aStatusCode);
+
+    // Close the exchange context, fail the paths not reported yet, free aRequest, and deliver kEvent_UpdateComplete
+    void CompleteRequest (InFlightRequest & aRequest, WEAVE_ERROR aReason);
+
+    static void OnSendError (ExchangeContext *aEC, WEAVE_ERROR aErrorCode, void *aMsgSpecificContext);
+    static void OnResponseTimeout (nl::Weave::ExchangeContext *aEC);
+    static void OnMessageReceived (nl::Weave::ExchangeContext *aEC, const nl::Inet::IPPacketInfo *aPktInfo,
+        const nl::Weave::WeaveMessageInfo *aMsgInfo, uint32_t aProfileId,
+        uint8_t aMsgType, PacketBuffer *aPayload);
+};
+
+}; // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+}; // Profiles
+}; // Weave
+}; // nl
+
+#endif // _WEAVE_DATA_MANAGEMENT_UPDATE_CLIENT_CURRENT_H
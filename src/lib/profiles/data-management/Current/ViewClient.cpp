@@ -330,6 +330,8 @@ void ViewClient::OnMessageReceived (nl::Weave::ExchangeContext *aEC, const nl::I
     void * const pAppState = pViewClient->mAppState;
     EventCallback CallbackFunc = pViewClient->mEventCallback;
     EventParam Param;
+    // The sink, if any, that has seen the beginning of a change but not yet its end
+    TraitDataSink * partialChangeSink = NULL;
 
     VerifyOrExit((kMode_DataSink == pViewClient->mCurrentMode) || (kMode_WithoutDataSink == pViewClient->mCurrentMode),
             err = WEAVE_ERROR_INCORRECT_STATE);
@@ -365,11 +367,11 @@ void ViewClient::OnMessageReceived (nl::Weave::ExchangeContext *aEC, const nl::I
         DataList::Parser dataList;
         dataList.Init(reader);
 
-#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && !WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
         // simple schema checking
         err = dataList.CheckSchemaValidity();
         SuccessOrExit(err);
-#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK
+#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && !WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
 
         // re-initialize the reader to point to individual data element (reuse to save stack depth)
         dataList.GetReader(&reader);
@@ -378,10 +380,21 @@ void ViewClient::OnMessageReceived (nl::Weave::ExchangeContext *aEC, const nl::I
 
         bool isPartialChange = false;
         uint8_t flags;
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+        size_t numDataElements = 0;
+#endif
 
         while (WEAVE_NO_ERROR == (err = reader.Next()))
         {
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+            // verify each data element right before it is consumed
+            err = DataList::Parser::CheckElementSchemaValidity(reader);
+            SuccessOrExit(err);
+
+            ++numDataElements;
+#else
             // schema checking has been done earlier with the whole data list
+#endif
 
             if (kMode_DataSink == pViewClient->mCurrentMode)
             {
@@ -465,6 +478,7 @@ void ViewClient::OnMessageReceived (nl::Weave::ExchangeContext *aEC, const nl::I
                 SuccessOrExit(err);
 
                 pViewClient->mPrevIsPartialChange = isPartialChange;
+                partialChangeSink = isPartialChange ? DataSink : NULL;
 
 #if WDM_ENABLE_PROTOCOL_CHECKS
                 // it's important to clear out mPrevTraitDataHandle if this isn't a partial change so that an ensuing notify
@@ -495,6 +509,11 @@ void ViewClient::OnMessageReceived (nl::Weave::ExchangeContext *aEC, const nl::I
             err = WEAVE_NO_ERROR;
         }
 
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+        // a data list must contain at least one data element
+        VerifyOrExit(numDataElements > 0, err = WEAVE_ERROR_INVALID_DATA_LIST);
+#endif
+
         err = reader.ExitContainer(dummyContainerType);
         SuccessOrExit(err);
 
@@ -514,6 +533,14 @@ void ViewClient::OnMessageReceived (nl::Weave::ExchangeContext *aEC, const nl::I
 exit:
     WeaveLogFunctError(err);
 
+    if ((WEAVE_NO_ERROR != err) && (NULL != partialChangeSink))
+    {
+        // the rest of the change is never going to be applied, so make sure the partially
+        // updated trait instance is not trusted at its current version
+        partialChangeSink->AbortChange();
+        pViewClient->mPrevIsPartialChange = false;
+    }
+
     // aEC should be the same as pViewClient->mEC and be closed in InternalCancel
     // If they are not the same, we're in big trouble
     pViewClient->Cancel();
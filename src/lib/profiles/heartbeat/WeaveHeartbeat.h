@@ -170,6 +170,115 @@ struct WeaveHeartbeatSender::OutEventParam
 
 
 
+/**
+ * Weave Heartbeat liveness tracker class
+ *
+ * Tracks whether each of a (potentially large) set of heartbeat senders is still alive, using
+ * a single timer for the whole set.  Node state lives in a table supplied by the application,
+ * indexed by node id, and deadlines are kept in a timing wheel that is swept once per tick.
+ * Receiving a heartbeat only records the time; nodes are moved within the wheel lazily, when
+ * their slot is swept.
+ *
+ * Transitions are reported in batches: nodes that missed
+ * #WEAVE_CONFIG_HEARTBEAT_LIVENESS_MISSED_HEARTBEATS consecutive heartbeats are reported
+ * offline when their slot is swept, and nodes heard from again are reported at the next tick.
+ */
+class NL_DLL_EXPORT WeaveHeartbeatLivenessTracker
+{
+public:
+    /**
+     * Per-node tracking state.  The application supplies an array of these to Init(); their
+     * contents are private to the tracker.
+     */
+    struct NodeEntry
+    {
+        uint64_t NodeId;
+        uint64_t LastSeen;
+        uint32_t TimeoutMs;
+        uint32_t HashNext;
+        uint32_t BucketHead;
+        uint32_t WheelNext;
+        uint32_t WheelPrev;
+        uint16_t WheelSlot;
+        uint8_t State;
+    };
+
+    enum LivenessEvent
+    {
+        kLivenessEvent_WentOffline              = 1,    //< The nodes missed too many heartbeats.
+        kLivenessEvent_CameBack                 = 2,    //< A heartbeat was received from nodes that were offline.
+    };
+
+    /**
+     * Aggregate liveness statistics.
+     */
+    struct Stats
+    {
+        uint32_t Capacity;                              //< Number of nodes the table can hold.
+        uint32_t NodesTracked;                          //< Number of nodes currently tracked.
+        uint32_t NodesOnline;                           //< Number of tracked nodes currently online.
+        uint32_t NodesOffline;                          //< Number of tracked nodes currently offline.
+        uint32_t HeartbeatsReceived;                    //< Heartbeats received from tracked nodes.
+        uint32_t HeartbeatsUntracked;                   //< Heartbeats received from nodes not in the table.
+        uint32_t WentOfflineCount;                      //< Total online to offline transitions.
+        uint32_t CameBackCount;                         //< Total offline to online transitions.
+    };
+
+    typedef void (*LivenessChangeHandler)(void *appState, LivenessEvent event, const uint64_t *nodeIds, uint32_t numNodeIds);
+
+    void *AppState;
+    LivenessChangeHandler OnLivenessChange;
+
+    WeaveHeartbeatLivenessTracker(void);
+
+    WEAVE_ERROR Init(System::Layer *systemLayer, NodeEntry *entries, uint32_t numEntries,
+                     uint32_t tickMs = WEAVE_CONFIG_HEARTBEAT_LIVENESS_TICK_MS);
+    WEAVE_ERROR Shutdown(void);
+
+    WEAVE_ERROR AddNode(uint64_t nodeId, uint32_t heartbeatIntervalMs);
+    WEAVE_ERROR RemoveNode(uint64_t nodeId);
+    WEAVE_ERROR HandleHeartbeat(uint64_t nodeId);
+
+    bool IsNodeTracked(uint64_t nodeId) const;
+    bool IsNodeOnline(uint64_t nodeId) const;
+    void GetStats(Stats& stats) const;
+
+private:
+    enum
+    {
+        kNodeState_Free                         = 0,
+        kNodeState_Online                       = 1,
+        kNodeState_Offline                      = 2,
+    };
+
+    static const uint32_t kInvalidIndex = 0xFFFFFFFFUL;
+
+    uint32_t FindNode(uint64_t nodeId) const;
+    uint32_t HashNodeId(uint64_t nodeId) const;
+    uint16_t SlotForDeadline(uint64_t deadline) const;
+    void LinkToWheel(uint32_t index);
+    void UnlinkFromWheel(uint32_t index);
+    void SweepSlot(uint16_t slot, uint64_t now);
+    void QueueEvent(LivenessEvent event, uint64_t nodeId);
+    void FlushEvents(void);
+    static void HandleTick(System::Layer *systemLayer, void *appState, System::Error error);
+    WeaveHeartbeatLivenessTracker(const WeaveHeartbeatLivenessTracker&); // Not defined.
+
+    System::Layer *             mSystemLayer;
+    NodeEntry *                 mEntries;
+    uint32_t                    mNumEntries;
+    uint32_t                    mFreeHead;
+    uint32_t                    mTickMs;
+    uint64_t                    mCurrentTick;
+    Stats                       mStats;
+    uint32_t                    mWheel[WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS];
+    uint64_t                    mBatch[WEAVE_CONFIG_HEARTBEAT_LIVENESS_BATCH_SIZE];
+    uint32_t                    mBatchCount;
+    LivenessEvent               mBatchEvent;
+    bool                        mInCallback;
+};
+
+
 /**
  * Weave Heartbeat Receiver class
  */
@@ -183,9 +292,14 @@ public:
     typedef void (*OnHeartbeatReceivedHandler)(const WeaveMessageInfo *aMsgInfo, uint8_t nodeState, WEAVE_ERROR err);
     OnHeartbeatReceivedHandler OnHeartbeatReceived;
 
+    WeaveHeartbeatLivenessTracker *GetLivenessTracker(void) const;
+    void SetLivenessTracker(WeaveHeartbeatLivenessTracker *tracker);
+
 private:
     static void HandleHeartbeat(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, uint32_t profileId, uint8_t msgType, PacketBuffer *payload);
     WeaveHeartbeatReceiver(const WeaveHeartbeatReceiver&);
+
+    WeaveHeartbeatLivenessTracker *mLivenessTracker;
 };
 
 
@@ -230,6 +344,16 @@ inline void WeaveHeartbeatSender::SetEventCallback(EventCallback eventCallback)
     mEventCallback = eventCallback;
 }
 
+inline WeaveHeartbeatLivenessTracker *WeaveHeartbeatReceiver::GetLivenessTracker() const
+{
+    return mLivenessTracker;
+}
+
+inline void WeaveHeartbeatReceiver::SetLivenessTracker(WeaveHeartbeatLivenessTracker *tracker)
+{
+    mLivenessTracker = tracker;
+}
+
 
 } // namespace Heartbeat
 } // namespace Profiles
@@ -0,0 +1,470 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the Weave Heartbeat liveness tracker, which
+ *      keeps track of which of a set of heartbeat senders are still
+ *      alive.
+ *
+ *      Each tracked node sits in a slot of a timing wheel chosen from its
+ *      deadline (the time it was last heard from plus its timeout).  A
+ *      heartbeat only moves the deadline later, so receiving one just
+ *      records the time; when the node's slot is swept it is either
+ *      declared offline or re-filed under its new deadline.  The cost of
+ *      a tick is therefore proportional to the number of nodes filed in
+ *      one slot, not to the size of the fleet.
+ *
+ */
+
+#include <string.h>
+
+#include "WeaveHeartbeat.h"
+#include <Weave/Support/CodeUtils.h>
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace Heartbeat {
+
+WeaveHeartbeatLivenessTracker::WeaveHeartbeatLivenessTracker()
+{
+    AppState = NULL;
+    OnLivenessChange = NULL;
+    mSystemLayer = NULL;
+    mEntries = NULL;
+    mNumEntries = 0;
+    mFreeHead = kInvalidIndex;
+    mTickMs = 0;
+    mCurrentTick = 0;
+    memset(&mStats, 0, sizeof(mStats));
+    mBatchCount = 0;
+    mBatchEvent = kLivenessEvent_WentOffline;
+    mInCallback = false;
+}
+
+/**
+ * Initialize the liveness tracker and start its tick timer.
+ *
+ * @param[in] systemLayer   A pointer to the System Layer used for the tick timer.
+ * @param[in] entries       Storage for the node table; it must remain valid until Shutdown().
+ * @param[in] numEntries    The number of elements in @a entries, i.e. the maximum number of tracked nodes.
+ * @param[in] tickMs        The interval, in milliseconds, at which the timing wheel is advanced.
+ *
+ * @retval #WEAVE_ERROR_INCORRECT_STATE     If the tracker is already initialized.
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT    If any argument is NULL or zero.
+ * @retval #WEAVE_NO_ERROR                  On success.
+ * @retval other                            Errors returned by the System Layer when starting the timer.
+ */
+WEAVE_ERROR WeaveHeartbeatLivenessTracker::Init(System::Layer *systemLayer, NodeEntry *entries, uint32_t numEntries,
+                                                uint32_t tickMs)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit(mSystemLayer == NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(systemLayer != NULL && entries != NULL && tickMs != 0, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(numEntries != 0 && numEntries != kInvalidIndex, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    mEntries = entries;
+    mNumEntries = numEntries;
+    mTickMs = tickMs;
+
+    for (uint32_t i = 0; i < numEntries; i++)
+    {
+        mEntries[i].State = kNodeState_Free;
+        mEntries[i].BucketHead = kInvalidIndex;
+        mEntries[i].HashNext = (i + 1 < numEntries) ? i + 1 : kInvalidIndex;
+    }
+    mFreeHead = 0;
+
+    for (uint16_t i = 0; i < WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS; i++)
+        mWheel[i] = kInvalidIndex;
+
+    memset(&mStats, 0, sizeof(mStats));
+    mStats.Capacity = numEntries;
+    mBatchCount = 0;
+    mInCallback = false;
+    mCurrentTick = static_cast<uint64_t>(System::Timer::GetCurrentEpoch()) / mTickMs;
+
+    err = systemLayer->StartTimer(mTickMs, HandleTick, this);
+    SuccessOrExit(err);
+
+    mSystemLayer = systemLayer;
+
+exit:
+    return err;
+}
+
+/**
+ * Stop the tick timer and forget all tracked nodes.  Pending notifications are discarded.
+ *
+ * @retval #WEAVE_NO_ERROR unconditionally.
+ */
+WEAVE_ERROR WeaveHeartbeatLivenessTracker::Shutdown()
+{
+    if (mSystemLayer != NULL)
+        mSystemLayer->CancelTimer(HandleTick, this);
+
+    mSystemLayer = NULL;
+    mEntries = NULL;
+    mNumEntries = 0;
+    mFreeHead = kInvalidIndex;
+    mBatchCount = 0;
+
+    return WEAVE_NO_ERROR;
+}
+
+/**
+ * Start tracking a node, or change the heartbeat interval of a node that is already tracked.
+ *
+ * A newly added node is considered online, as if a heartbeat had just been received from it.
+ *
+ * @param[in] nodeId                The node id of the heartbeat sender.
+ * @param[in] heartbeatIntervalMs   The interval, in milliseconds, at which the node sends heartbeats.
+ *
+ * @retval #WEAVE_ERROR_INCORRECT_STATE     If the tracker is not initialized or a liveness callback is running.
+ * @retval #WEAVE_ERROR_INVALID_ARGUMENT    If @a heartbeatIntervalMs is zero.
+ * @retval #WEAVE_ERROR_NO_MEMORY           If the node table is full.
+ * @retval #WEAVE_NO_ERROR                  On success.
+ */
+WEAVE_ERROR WeaveHeartbeatLivenessTracker::AddNode(uint64_t nodeId, uint32_t heartbeatIntervalMs)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint64_t timeout = static_cast<uint64_t>(heartbeatIntervalMs) * WEAVE_CONFIG_HEARTBEAT_LIVENESS_MISSED_HEARTBEATS;
+    uint32_t index;
+    uint32_t bucket;
+    NodeEntry *entry;
+
+    VerifyOrExit(mSystemLayer != NULL && !mInCallback, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(heartbeatIntervalMs != 0, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    index = FindNode(nodeId);
+    if (index != kInvalidIndex)
+    {
+        entry = &mEntries[index];
+        if (entry->State == kNodeState_Online)
+            UnlinkFromWheel(index);
+    }
+    else
+    {
+        VerifyOrExit(mFreeHead != kInvalidIndex, err = WEAVE_ERROR_NO_MEMORY);
+
+        index = mFreeHead;
+        entry = &mEntries[index];
+        mFreeHead = entry->HashNext;
+
+        bucket = HashNodeId(nodeId);
+        entry->NodeId = nodeId;
+        entry->HashNext = mEntries[bucket].BucketHead;
+        mEntries[bucket].BucketHead = index;
+        entry->State = kNodeState_Online;
+
+        mStats.NodesTracked++;
+        mStats.NodesOnline++;
+    }
+
+    entry->TimeoutMs = (timeout > 0xFFFFFFFFUL) ? 0xFFFFFFFFUL : static_cast<uint32_t>(timeout);
+    entry->LastSeen = static_cast<uint64_t>(System::Timer::GetCurrentEpoch());
+
+    if (entry->State == kNodeState_Online)
+        LinkToWheel(index);
+
+exit:
+    return err;
+}
+
+/**
+ * Stop tracking a node.  No notification is generated for the node.
+ *
+ * @param[in] nodeId    The node id of the heartbeat sender.
+ *
+ * @retval #WEAVE_ERROR_INCORRECT_STATE     If the tracker is not initialized or a liveness callback is running.
+ * @retval #WEAVE_ERROR_KEY_NOT_FOUND       If the node is not tracked.
+ * @retval #WEAVE_NO_ERROR                  On success.
+ */
+WEAVE_ERROR WeaveHeartbeatLivenessTracker::RemoveNode(uint64_t nodeId)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint32_t bucket;
+    uint32_t *link;
+    uint32_t index;
+
+    VerifyOrExit(mSystemLayer != NULL && !mInCallback, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    bucket = HashNodeId(nodeId);
+    for (link = &mEntries[bucket].BucketHead; *link != kInvalidIndex; link = &mEntries[*link].HashNext)
+    {
+        if (mEntries[*link].NodeId == nodeId)
+            break;
+    }
+    VerifyOrExit(*link != kInvalidIndex, err = WEAVE_ERROR_KEY_NOT_FOUND);
+
+    index = *link;
+    *link = mEntries[index].HashNext;
+
+    if (mEntries[index].State == kNodeState_Online)
+    {
+        UnlinkFromWheel(index);
+        mStats.NodesOnline--;
+    }
+    else
+    {
+        mStats.NodesOffline--;
+    }
+    mStats.NodesTracked--;
+
+    mEntries[index].State = kNodeState_Free;
+    mEntries[index].HashNext = mFreeHead;
+    mFreeHead = index;
+
+exit:
+    return err;
+}
+
+/**
+ * Record that a heartbeat was received from a node.
+ *
+ * If the node was offline it is reported as having come back at the next tick, or sooner if a
+ * full batch of such nodes has accumulated.
+ *
+ * @param[in] nodeId    The node id of the heartbeat sender.
+ *
+ * @retval #WEAVE_ERROR_INCORRECT_STATE     If the tracker is not initialized or a liveness callback is running.
+ * @retval #WEAVE_ERROR_KEY_NOT_FOUND       If the node is not tracked.
+ * @retval #WEAVE_NO_ERROR                  On success.
+ */
+WEAVE_ERROR WeaveHeartbeatLivenessTracker::HandleHeartbeat(uint64_t nodeId)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint32_t index;
+    NodeEntry *entry;
+
+    VerifyOrExit(mSystemLayer != NULL && !mInCallback, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    index = FindNode(nodeId);
+    if (index == kInvalidIndex)
+    {
+        mStats.HeartbeatsUntracked++;
+        ExitNow(err = WEAVE_ERROR_KEY_NOT_FOUND);
+    }
+
+    mStats.HeartbeatsReceived++;
+
+    entry = &mEntries[index];
+    entry->LastSeen = static_cast<uint64_t>(System::Timer::GetCurrentEpoch());
+
+    // An online node stays in the slot of its earlier deadline; it is re-filed when that slot is swept.
+    if (entry->State == kNodeState_Offline)
+    {
+        entry->State = kNodeState_Online;
+        mStats.NodesOffline--;
+        mStats.NodesOnline++;
+        mStats.CameBackCount++;
+
+        LinkToWheel(index);
+        QueueEvent(kLivenessEvent_CameBack, nodeId);
+    }
+
+exit:
+    return err;
+}
+
+/**
+ * Return whether a node is in the node table.
+ */
+bool WeaveHeartbeatLivenessTracker::IsNodeTracked(uint64_t nodeId) const
+{
+    return FindNode(nodeId) != kInvalidIndex;
+}
+
+/**
+ * Return whether a node is tracked and currently considered online.
+ */
+bool WeaveHeartbeatLivenessTracker::IsNodeOnline(uint64_t nodeId) const
+{
+    uint32_t index = FindNode(nodeId);
+
+    return index != kInvalidIndex && mEntries[index].State == kNodeState_Online;
+}
+
+/**
+ * Get aggregate liveness statistics for the tracked nodes.
+ *
+ * @param[out] stats    Receives the statistics.
+ */
+void WeaveHeartbeatLivenessTracker::GetStats(Stats& stats) const
+{
+    stats = mStats;
+}
+
+uint32_t WeaveHeartbeatLivenessTracker::HashNodeId(uint64_t nodeId) const
+{
+    return static_cast<uint32_t>((nodeId ^ (nodeId >> 32)) % mNumEntries);
+}
+
+uint32_t WeaveHeartbeatLivenessTracker::FindNode(uint64_t nodeId) const
+{
+    uint32_t index = kInvalidIndex;
+
+    if (mEntries != NULL)
+    {
+        for (index = mEntries[HashNodeId(nodeId)].BucketHead; index != kInvalidIndex; index = mEntries[index].HashNext)
+        {
+            if (mEntries[index].NodeId == nodeId)
+                break;
+        }
+    }
+
+    return index;
+}
+
+uint16_t WeaveHeartbeatLivenessTracker::SlotForDeadline(uint64_t deadline) const
+{
+    uint64_t tick = (deadline + mTickMs - 1) / mTickMs;
+
+    // A deadline that falls before the next tick is checked at the next tick.
+    if (tick <= mCurrentTick)
+        tick = mCurrentTick + 1;
+
+    return static_cast<uint16_t>(tick % WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS);
+}
+
+void WeaveHeartbeatLivenessTracker::LinkToWheel(uint32_t index)
+{
+    NodeEntry *entry = &mEntries[index];
+    uint16_t slot = SlotForDeadline(entry->LastSeen + entry->TimeoutMs);
+
+    entry->WheelSlot = slot;
+    entry->WheelPrev = kInvalidIndex;
+    entry->WheelNext = mWheel[slot];
+    if (entry->WheelNext != kInvalidIndex)
+        mEntries[entry->WheelNext].WheelPrev = index;
+    mWheel[slot] = index;
+}
+
+void WeaveHeartbeatLivenessTracker::UnlinkFromWheel(uint32_t index)
+{
+    NodeEntry *entry = &mEntries[index];
+
+    if (entry->WheelPrev != kInvalidIndex)
+        mEntries[entry->WheelPrev].WheelNext = entry->WheelNext;
+    else
+        mWheel[entry->WheelSlot] = entry->WheelNext;
+
+    if (entry->WheelNext != kInvalidIndex)
+        mEntries[entry->WheelNext].WheelPrev = entry->WheelPrev;
+}
+
+void WeaveHeartbeatLivenessTracker::SweepSlot(uint16_t slot, uint64_t now)
+{
+    uint32_t index = mWheel[slot];
+    uint32_t next;
+    NodeEntry *entry;
+
+    // Detach the slot first so that nodes re-filed into the same slot are not visited again.
+    mWheel[slot] = kInvalidIndex;
+
+    for (; index != kInvalidIndex; index = next)
+    {
+        entry = &mEntries[index];
+        next = entry->WheelNext;
+
+        if (entry->LastSeen + entry->TimeoutMs <= now)
+        {
+            entry->State = kNodeState_Offline;
+            mStats.NodesOnline--;
+            mStats.NodesOffline++;
+            mStats.WentOfflineCount++;
+
+            QueueEvent(kLivenessEvent_WentOffline, entry->NodeId);
+
+            // The tracker may have been shut down by the application callback.
+            if (mSystemLayer == NULL)
+                break;
+        }
+        else
+        {
+            LinkToWheel(index);
+        }
+    }
+}
+
+void WeaveHeartbeatLivenessTracker::QueueEvent(LivenessEvent event, uint64_t nodeId)
+{
+    if (mBatchCount != 0 && mBatchEvent != event)
+        FlushEvents();
+
+    mBatchEvent = event;
+    mBatch[mBatchCount++] = nodeId;
+
+    if (mBatchCount == WEAVE_CONFIG_HEARTBEAT_LIVENESS_BATCH_SIZE)
+        FlushEvents();
+}
+
+void WeaveHeartbeatLivenessTracker::FlushEvents()
+{
+    uint32_t count = mBatchCount;
+
+    mBatchCount = 0;
+
+    if (count != 0 && OnLivenessChange != NULL)
+    {
+        mInCallback = true;
+        OnLivenessChange(AppState, mBatchEvent, mBatch, count);
+        mInCallback = false;
+    }
+}
+
+void WeaveHeartbeatLivenessTracker::HandleTick(System::Layer *systemLayer, void *appState, System::Error error)
+{
+    WeaveHeartbeatLivenessTracker *tracker = static_cast<WeaveHeartbeatLivenessTracker *>(appState);
+    uint64_t now = static_cast<uint64_t>(System::Timer::GetCurrentEpoch());
+    uint64_t tick = now / tracker->mTickMs;
+    uint64_t lastTick = tracker->mCurrentTick;
+    uint32_t slotsToSweep;
+
+    VerifyOrExit(tracker->mSystemLayer != NULL, );
+
+    // Deliver nodes that came back since the last tick before any that are now going offline.
+    tracker->FlushEvents();
+
+    // Timers may fire late; sweep every slot passed since the last tick, but never more than one revolution.
+    slotsToSweep = (tick - lastTick > WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS) ?
+            WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS : static_cast<uint32_t>(tick - lastTick);
+
+    tracker->mCurrentTick = tick;
+
+    for (uint32_t i = 1; i <= slotsToSweep && tracker->mSystemLayer != NULL; i++)
+        tracker->SweepSlot(static_cast<uint16_t>((lastTick + i) % WEAVE_CONFIG_HEARTBEAT_LIVENESS_WHEEL_SLOTS), now);
+
+    if (tracker->mSystemLayer != NULL)
+        tracker->FlushEvents();
+
+    // The tracker may have been shut down by the application callback.
+    VerifyOrExit(tracker->mSystemLayer != NULL, );
+
+    systemLayer->StartTimer(tracker->mTickMs, HandleTick, tracker);
+
+exit:
+    return;
+}
+
+} // namespace Heartbeat
+} // namespace Profiles
+} // namespace Weave
+} // namespace nl
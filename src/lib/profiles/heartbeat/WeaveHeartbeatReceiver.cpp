@@ -35,6 +35,7 @@ WeaveHeartbeatReceiver::WeaveHeartbeatReceiver()
     FabricState = NULL;
     ExchangeMgr = NULL;
     OnHeartbeatReceived = NULL;
+    mLivenessTracker = NULL;
 }
 
 /**
@@ -111,6 +112,9 @@ void WeaveHeartbeatReceiver::HandleHeartbeat(ExchangeContext *ec, const IPPacket
 
     receiver = static_cast<WeaveHeartbeatReceiver *>(ec->AppState);
 
+    if (receiver->mLivenessTracker != NULL)
+        receiver->mLivenessTracker->HandleHeartbeat(msgInfo->SourceNodeId);
+
     if (receiver->OnHeartbeatReceived != NULL)
     {
         p       = payload->Start();
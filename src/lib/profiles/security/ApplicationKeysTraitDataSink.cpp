@@ -100,6 +100,7 @@ WEAVE_ERROR ApplicationKeysTraitDataSink::SetLeafData(PropertyPathHandle aLeafHa
     uint8_t keyCount;
     uint8_t maxKeyCount;
     WeaveGroupKey groupKey;
+    bool keysChanged = false;
 
     if (ApplicationKeysTrait::kPropertyHandle_EpochKeys == aLeafHandle)
     {
@@ -131,6 +132,7 @@ WEAVE_ERROR ApplicationKeysTraitDataSink::SetLeafData(PropertyPathHandle aLeafHa
 
         // Delete all group keys of the specified type from the group key store.
         GroupKeyStore->DeleteGroupKeysOfAType(keyType);
+        keysChanged = true;
 
         while ((err = aReader.Next(kTLVType_Structure, AnonymousTag)) == WEAVE_NO_ERROR)
         {
@@ -223,6 +225,10 @@ WEAVE_ERROR ApplicationKeysTraitDataSink::SetLeafData(PropertyPathHandle aLeafHa
 exit:
     ClearSecretData(groupKey.Key, sizeof(groupKey.Key));
 
+    // Flush keys derived from the replaced set, even if the update stopped part way through.
+    if (keysChanged)
+        GroupKeyStore->ClearKeyCache();
+
     return err;
 }
 
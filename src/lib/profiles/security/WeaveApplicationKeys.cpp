@@ -27,6 +27,8 @@
 #define __STDC_LIMIT_MACROS
 #endif
 
+#include <string.h>
+
 #include <Weave/Core/WeaveCore.h>
 #include <Weave/Core/WeaveKeyIds.h>
 #include "WeaveApplicationKeys.h"
@@ -116,6 +118,14 @@ void GroupKeyStoreBase::Init(void)
 {
     LastUsedEpochKeyId = WeaveKeyId::kNone;
     NextEpochKeyStartTime = UINT32_MAX;
+    KeyCacheGeneration = 0;
+
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    for (uint8_t i = 0; i < WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE; i++)
+        KeyCache[i].KeyId = WeaveKeyId::kNone;
+#endif
+
+    ClearKeyCache();
 }
 
 /**
@@ -129,8 +139,118 @@ void GroupKeyStoreBase::OnEpochKeysChange(void)
 {
     LastUsedEpochKeyId = WeaveKeyId::kNone;
     NextEpochKeyStartTime = UINT32_MAX;
+
+    ClearKeyCache();
+}
+
+/**
+ * Flushes all keys derived from the previous set of group keys.
+ * It is the responsibility of the subclass that implements StoreGroupKey(), DeleteGroupKey(),
+ * and DeleteGroupKeysOfAType() functions to call this method (or OnEpochKeysChange() when
+ * epoch keys are affected) whenever any key in the store is added, replaced or removed.
+ */
+void GroupKeyStoreBase::OnGroupKeysChange(void)
+{
+    ClearKeyCache();
 }
 
+/**
+ * Flushes the derived key cache.
+ * All cached key material is cleared and the key cache generation is advanced so that
+ * derived keys held elsewhere (e.g. message encryption keys) are discarded as well.
+ */
+void GroupKeyStoreBase::ClearKeyCache(void)
+{
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    for (uint8_t i = 0; i < WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE; i++)
+    {
+        if (KeyCache[i].KeyId != WeaveKeyId::kNone)
+            ClearSecretData((uint8_t *)&KeyCache[i], sizeof(KeyCache[i]));
+        KeyCache[i].KeyId = WeaveKeyId::kNone;
+    }
+    KeyCacheUseCounter = 0;
+#endif
+
+    KeyCacheGeneration++;
+}
+
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+
+// Home entry of a key in the key cache.
+uint8_t GroupKeyStoreBase::KeyCacheIndex(uint32_t keyId, const uint8_t *keyDiversifier, uint8_t diversifierLen)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (uint8_t i = 0; i < 4; i++, keyId >>= 8)
+        hash = (hash ^ (keyId & 0xFF)) * 16777619UL;
+
+    hash = (hash ^ diversifierLen) * 16777619UL;
+
+    if (diversifierLen != kKeyCacheDiversifierLen_GroupKey)
+        for (uint8_t i = 0; i < diversifierLen; i++)
+            hash = (hash ^ keyDiversifier[i]) * 16777619UL;
+
+    return static_cast<uint8_t>(hash % WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE);
+}
+
+// Returns the cache entry holding the specified key, or NULL if the key is not cached.
+GroupKeyStoreBase::KeyCacheEntry *GroupKeyStoreBase::FindCachedKey(uint32_t keyId, const uint8_t *keyDiversifier,
+                                                                   uint8_t diversifierLen, uint8_t keyLen)
+{
+    uint8_t index = KeyCacheIndex(keyId, keyDiversifier, diversifierLen);
+
+    for (uint8_t i = 0; i < kKeyCacheProbeLimit && i < WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE; i++)
+    {
+        KeyCacheEntry *entry = &KeyCache[(index + i) % WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE];
+
+        if (entry->KeyId == keyId && keyId != WeaveKeyId::kNone &&
+            entry->KeyLen == keyLen && entry->DiversifierLen == diversifierLen &&
+            (diversifierLen == kKeyCacheDiversifierLen_GroupKey || diversifierLen == 0 ||
+             memcmp(entry->Diversifier, keyDiversifier, diversifierLen) == 0))
+        {
+            entry->LastUsed = ++KeyCacheUseCounter;
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+// Adds a key to the cache, replacing the least-recently used key near its home entry if needed.
+void GroupKeyStoreBase::CacheKey(uint32_t keyId, const uint8_t *keyDiversifier, uint8_t diversifierLen,
+                                 const uint8_t *key, uint8_t keyLen, uint32_t globalId)
+{
+    uint8_t index = KeyCacheIndex(keyId, keyDiversifier, diversifierLen);
+    KeyCacheEntry *entry = NULL;
+
+    for (uint8_t i = 0; i < kKeyCacheProbeLimit && i < WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE; i++)
+    {
+        KeyCacheEntry *candidate = &KeyCache[(index + i) % WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE];
+
+        if (candidate->KeyId == WeaveKeyId::kNone)
+        {
+            entry = candidate;
+            break;
+        }
+
+        if (entry == NULL || candidate->LastUsed < entry->LastUsed)
+            entry = candidate;
+    }
+
+    ClearSecretData((uint8_t *)entry, sizeof(*entry));
+
+    entry->KeyId = keyId;
+    entry->GlobalId = globalId;
+    entry->LastUsed = ++KeyCacheUseCounter;
+    entry->KeyLen = keyLen;
+    entry->DiversifierLen = diversifierLen;
+    if (diversifierLen != kKeyCacheDiversifierLen_GroupKey && diversifierLen > 0)
+        memcpy(entry->Diversifier, keyDiversifier, diversifierLen);
+    memcpy(entry->Key, key, keyLen);
+}
+
+#endif // WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+
 /**
  * Returns current key ID.
  * Finds current epoch key based on the current system time and the start time parameter
@@ -277,11 +397,26 @@ WEAVE_ERROR GroupKeyStoreBase::GetGroupKey(uint32_t keyId, WeaveGroupKey& groupK
     WEAVE_ERROR err;
     uint32_t rootKeyId;
     uint8_t expectedKeyLen;
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    KeyCacheEntry *cachedKey;
+#endif
 
     // Get current key Id.
     err = GetCurrentAppKeyId(keyId, keyId);
     SuccessOrExit(err);
 
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    // Use the previously derived root or intermediate key, if there is one.
+    cachedKey = FindCachedKey(keyId, NULL, kKeyCacheDiversifierLen_GroupKey, kWeaveAppGroupKeySize);
+    if (cachedKey != NULL)
+    {
+        groupKey.KeyId = keyId;
+        groupKey.KeyLen = cachedKey->KeyLen;
+        memcpy(groupKey.Key, cachedKey->Key, cachedKey->KeyLen);
+        ExitNow();
+    }
+#endif
+
     switch (WeaveKeyId::GetType(keyId))
     {
     case WeaveKeyId::kType_AppRootKey:
@@ -320,6 +455,14 @@ WEAVE_ERROR GroupKeyStoreBase::GetGroupKey(uint32_t keyId, WeaveGroupKey& groupK
     VerifyOrExit(groupKey.KeyLen == expectedKeyLen &&
                  groupKey.KeyId == keyId, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    // Remember derived root and intermediate keys.
+    if (WeaveKeyId::GetType(keyId) == WeaveKeyId::kType_AppIntermediateKey ||
+        (WeaveKeyId::IsAppRootKey(keyId) &&
+         (WeaveKeyId::GetRootKeyId(keyId) == WeaveKeyId::kFabricRootKey || WeaveKeyId::GetRootKeyId(keyId) == WeaveKeyId::kClientRootKey)))
+        CacheKey(keyId, NULL, kKeyCacheDiversifierLen_GroupKey, groupKey.Key, groupKey.KeyLen, 0);
+#endif
+
 exit:
     return err;
 }
@@ -479,6 +622,10 @@ WEAVE_ERROR GroupKeyStoreBase::DeriveApplicationKey(uint32_t& keyId,
     WeaveGroupKey intermediateKey;
     WeaveGroupKey groupMasterKey;
     uint32_t localKeyId;
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    KeyCacheEntry *cachedKey;
+    bool cacheable;
+#endif
 
     // Verify that key identifier has correct type.
     VerifyOrExit(WeaveKeyId::IsAppGroupKey(keyId), err = WEAVE_ERROR_INVALID_ARGUMENT);
@@ -487,6 +634,23 @@ WEAVE_ERROR GroupKeyStoreBase::DeriveApplicationKey(uint32_t& keyId,
     err = GetCurrentAppKeyId(keyId, keyId);
     SuccessOrExit(err);
 
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    // Only keys derived without salt are cached; salted keys are specific to a single use.
+    cacheable = (saltLen == 0 && diversifierLen <= kKeyCacheMaxDiversifierLen && keyLen <= WeaveGroupKey::MaxKeySize);
+    if (cacheable)
+    {
+        cachedKey = FindCachedKey(keyId, keyDiversifier, diversifierLen, keyLen);
+        if (cachedKey != NULL)
+        {
+            VerifyOrExit(keyLen <= keyBufSize, err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+            memcpy(appKey, cachedKey->Key, keyLen);
+            appGroupGlobalId = cachedKey->GlobalId;
+            ExitNow();
+        }
+    }
+#endif
+
     // Set first requested key material, which can be of two types:
     //  - If keyId is an app static key then localKeyId is root key id.
     //  - If keyId is an app rotating key then localKeyId is intermediate key id.
@@ -522,6 +686,11 @@ WEAVE_ERROR GroupKeyStoreBase::DeriveApplicationKey(uint32_t& keyId,
     // Return the global id of the associated application group.
     appGroupGlobalId = groupMasterKey.GlobalId;
 
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    if (cacheable)
+        CacheKey(keyId, keyDiversifier, diversifierLen, appKey, keyLen, appGroupGlobalId);
+#endif
+
 exit:
     ClearSecretData(intermediateKey.Key, intermediateKey.MaxKeySize);
     ClearSecretData(groupMasterKey.Key, groupMasterKey.MaxKeySize);
@@ -158,12 +158,23 @@ public:
                                      uint8_t *appKey, uint8_t keyBufSize, uint8_t keyLen,
                                      uint32_t& appGroupGlobalId);
 
+    // Flush the derived key cache.
+    void ClearKeyCache(void);
+
+    /**
+     * Get the derived key cache generation.
+     * The generation changes every time the derived key cache is flushed; callers that keep
+     * their own copies of derived keys should discard them when it does.
+     */
+    uint32_t GetKeyCacheGeneration(void) const { return KeyCacheGeneration; }
+
 protected:
     uint32_t LastUsedEpochKeyId;
     uint32_t NextEpochKeyStartTime;
 
     void Init(void);
     void OnEpochKeysChange(void);
+    void OnGroupKeysChange(void);
 
     // Retrieve and Store LastUsedEpochKeyId value.
     virtual WEAVE_ERROR RetrieveLastUsedEpochKeyId(void) = 0;
@@ -175,6 +186,36 @@ private:
 
     // Derive intermediate key.
     WEAVE_ERROR DeriveIntermediateKey(uint32_t keyId, WeaveGroupKey& intermediateKey);
+
+    uint32_t KeyCacheGeneration;
+
+#if WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
+    enum
+    {
+        kKeyCacheMaxDiversifierLen                      = 8,    /**< Longest application key diversifier that is cached. */
+        kKeyCacheDiversifierLen_GroupKey                = 0xFF, /**< Marks an entry holding a derived root or intermediate key. */
+        kKeyCacheProbeLimit                             = 4,    /**< Number of consecutive entries searched for a key. */
+    };
+
+    struct KeyCacheEntry
+    {
+        uint32_t KeyId;
+        uint32_t GlobalId;
+        uint32_t LastUsed;
+        uint8_t KeyLen;
+        uint8_t DiversifierLen;
+        uint8_t Diversifier[kKeyCacheMaxDiversifierLen];
+        uint8_t Key[WeaveGroupKey::MaxKeySize];
+    };
+
+    KeyCacheEntry KeyCache[WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE];
+    uint32_t KeyCacheUseCounter;
+
+    KeyCacheEntry *FindCachedKey(uint32_t keyId, const uint8_t *keyDiversifier, uint8_t diversifierLen, uint8_t keyLen);
+    void CacheKey(uint32_t keyId, const uint8_t *keyDiversifier, uint8_t diversifierLen,
+                  const uint8_t *key, uint8_t keyLen, uint32_t globalId);
+    static uint8_t KeyCacheIndex(uint32_t keyId, const uint8_t *keyDiversifier, uint8_t diversifierLen);
+#endif // WEAVE_CONFIG_GROUP_KEY_CACHE_SIZE > 0
 };
 
 
@@ -40,6 +40,7 @@
 #include <Weave/Support/crypto/WeaveCrypto.h>
 #include <Weave/Support/crypto/HashAlgos.h>
 #include <Weave/Support/crypto/EllipticCurve.h>
+#include <Weave/Support/crypto/ECDHKeyPool.h>
 #include <Weave/Support/CodeUtils.h>
 #include <Weave/Support/WeaveFaultInjection.h>
 
@@ -541,13 +542,13 @@ WEAVE_ERROR WeaveCASEEngine::AppendNewECDHKey(BeginSessionMessageBase& msg, Pack
 
     WeaveLogDetail(SecurityManager, "CASE:AppendNewECDHKey");
 
-    // Generate an ephemeral public/private key. Store the public key directly into the message and store
-    // the private key in the provided object.
+    // Get an ephemeral public/private key, pre-generated if the pool has one. Store the public key directly
+    // into the message and store the private key in the provided object.
     msg.ECDHPublicKey.ECPoint = msgBuf->Start() + msgLen;
-    msg.ECDHPublicKey.ECPointLen = msgBuf->AvailableDataLength(); // GenerateECDHKey() will update with final length.
+    msg.ECDHPublicKey.ECPointLen = msgBuf->AvailableDataLength(); // GetKey() will update with final length.
     privKey.PrivKey = mSecureState.BeforeKeyGen.ECDHPrivateKey;
     privKey.PrivKeyLen = sizeof(mSecureState.BeforeKeyGen.ECDHPrivateKey);
-    err = GenerateECDHKey(WeaveCurveIdToOID(msg.CurveId), msg.ECDHPublicKey, privKey);
+    err = ECDHKeyPool::GetKey(WeaveCurveIdToOID(msg.CurveId), msg.ECDHPublicKey, privKey);
     SuccessOrExit(err);
 
 #if WEAVE_CONFIG_SECURITY_TEST_MODE
@@ -27,6 +27,7 @@
 #include "WeaveSecurity.h"
 #include <Weave/Profiles/security/WeaveSig.h>
 #include <Weave/Support/crypto/WeaveCrypto.h>
+#include <Weave/Support/crypto/ECDHKeyPool.h>
 #include <Weave/Support/CodeUtils.h>
 #include <Weave/Profiles/WeaveProfiles.h>
 
@@ -497,13 +498,13 @@ WEAVE_ERROR WeaveKeyExport::AppendNewECDHKey(uint8_t *& buf)
     EncodedECPrivateKey ecdhPrivKey;
     EncodedECPublicKey ecdhPubKey;
 
-    // Generate an ephemeral ECDH public/private key pair. Store the public key directly into
-    // the message buffer and store the private key in the object variable.
+    // Get an ephemeral ECDH public/private key pair, pre-generated if the pool has one. Store the
+    // public key directly into the message buffer and store the private key in the object variable.
     ecdhPubKey.ECPoint = buf;
-    ecdhPubKey.ECPointLen = GetECDHPublicKeyLen();    // GenerateECDHKey() will update with the actual length.
+    ecdhPubKey.ECPointLen = GetECDHPublicKeyLen();    // GetKey() will update with the actual length.
     ecdhPrivKey.PrivKey = ECDHPrivateKey;
-    ecdhPrivKey.PrivKeyLen = sizeof(ECDHPrivateKey);  // GenerateECDHKey() will update with the actual length.
-    err = GenerateECDHKey(GetCurveOID(), ecdhPubKey, ecdhPrivKey);
+    ecdhPrivKey.PrivKeyLen = sizeof(ECDHPrivateKey);  // GetKey() will update with the actual length.
+    err = ECDHKeyPool::GetKey(GetCurveOID(), ecdhPubKey, ecdhPrivKey);
     SuccessOrExit(err);
 
     // Update length of generated private key.
@@ -249,6 +249,10 @@ WeaveServiceManager::WeaveServiceManager()
     mExchangeContext = NULL;
     mServiceEndpointQueryBegin = NULL;
     mServiceEndpointQueryEndWithTimeInfo = NULL;
+    mRaceMaxAttempts = 1;
+    mRaceStaggerMsecs = WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_STAGGER_MSECS;
+
+    memset(&mDirectoryRace, 0, sizeof(mDirectoryRace));
 
     freeConnectRequests();
 
@@ -412,6 +416,7 @@ WEAVE_ERROR WeaveServiceManager::connect(uint64_t aServiceEp,
 
         mDirectory.base = mCache.base;
         mDirectory.length = 1;
+        mIndexValid = false;
 
         mCacheState = kServiceMgrState_Resolving;
     }
@@ -430,6 +435,7 @@ WEAVE_ERROR WeaveServiceManager::connect(uint64_t aServiceEp,
         VerifyOrExit(mConnection, err = WEAVE_ERROR_NO_MEMORY);
 
         err = lookupAndConnect(mConnection,
+                               mDirectoryRace,
                                kServiceEndpoint_Directory,
                                mDirAuthMode,
                                this,
@@ -491,6 +497,7 @@ WEAVE_ERROR WeaveServiceManager::connect(uint64_t aServiceEp,
         WeaveLogProgress(ServiceDirectory, "resolved");
 
         err = lookupAndConnect(req->mConnection,
+                               req->mRace,
                                req->mServiceEp,
                                req->mAuthMode,
                                req,
@@ -568,6 +575,33 @@ WEAVE_ERROR WeaveServiceManager::lookup(uint64_t aServiceEp, uint8_t *aControlBy
     WEAVE_FAULT_INJECT(nl::Weave::FaultInjection::kFault_ServiceManager_Lookup,
                        memset(&aServiceEp, 0x0F, sizeof(aServiceEp)));
 
+    /*
+     * the directory is parsed into the index the first time it's
+     * looked up after it changes. a directory that can't be indexed
+     * is walked below, which also reports any encoding error.
+     */
+
+    if (!mIndexValid)
+        indexDirectory();
+
+    if (mIndexValid)
+    {
+        for (uint8_t i = 0; i < mIndexLength; i++)
+        {
+            if (mIndex[i].serviceEp == aServiceEp)
+            {
+                WeaveLogProgress(ServiceDirectory, "found [%x,%llx]", mIndex[i].ctrlByte, aServiceEp);
+
+                *aControlByte = mIndex[i].ctrlByte;
+                *aDirectoryEntry = mDirectory.base + mIndex[i].offset;
+
+                ExitNow(err = WEAVE_NO_ERROR);
+            }
+        }
+
+        ExitNow(err = WEAVE_ERROR_INVALID_SERVICE_EP);
+    }
+
     for (uint8_t i = 0; i < mDirectory.length; i++)
     {
         uint8_t  entryCtrlByte = Read8(p);
@@ -655,6 +689,12 @@ WEAVE_ERROR WeaveServiceManager::replaceOrAddCacheEntry(uint16_t port,
 
         mDirAndSuffTableSize -= entryLength;
     }
+    else
+    {
+        // Not found, so the entry is simply added.
+
+        err = WEAVE_NO_ERROR;
+    }
 
     // Make space for the new entry by moving the directory down the cache by the appropriate length.
 
@@ -695,6 +735,7 @@ WEAVE_ERROR WeaveServiceManager::replaceOrAddCacheEntry(uint16_t port,
     // Update the directory length by this new entry and write it in the directory control byte.
 
     mDirectory.length++;
+    mIndexValid = false;
 
 exit:
     return err;
@@ -1061,6 +1102,7 @@ void WeaveServiceManager::onResponseReceived(uint32_t aProfileId, uint8_t aMsgTy
 
             mDirectory.length = dirLen;
             writePtr = mDirectory.base = mCache.base;
+            mIndexValid = false;
 
             err = cacheDirectory(i, mDirectory.length, writePtr);
             SuccessOrExit(err);
@@ -1115,6 +1157,7 @@ void WeaveServiceManager::onResponseReceived(uint32_t aProfileId, uint8_t aMsgTy
             WeaveLogProgress(ServiceDirectory, "onResponseReceived(): redirecting");
 
             err = lookupAndConnect(mConnection,
+                                   mDirectoryRace,
                                    kServiceEndpoint_Directory,
                                    mDirAuthMode,
                                    this,
@@ -1150,6 +1193,7 @@ void WeaveServiceManager::onResponseReceived(uint32_t aProfileId, uint8_t aMsgTy
                     WeaveLogProgress(ServiceDirectory, "onResponseReceived() txn = %llx", req->mServiceEp);
 
                     conErr = lookupAndConnect(req->mConnection,
+                                              req->mRace,
                                               req->mServiceEp,
                                               req->mAuthMode,
                                               req,
@@ -1253,6 +1297,8 @@ void WeaveServiceManager::ConnectRequest::free(void)
     {
         SYSTEM_STATS_DECREMENT(nl::Weave::System::Stats::kServiceMgr_NumRequests);
 
+        mRace.abort();
+
         memset(this, 0, sizeof(*this));
     }
 }
@@ -1386,14 +1432,102 @@ WEAVE_ERROR WeaveServiceManager::calculateEntryLength(uint8_t *entryStart,
     return err;
 }
 
+/**
+ *  @brief
+ *    This method parses the cached directory into the in-memory index.
+ *
+ *  The index is left invalid if the directory has more entries than
+ *  #WEAVE_CONFIG_SERVICE_DIR_INDEX_SIZE or cannot be parsed, in which case
+ *  lookup() walks the cached directory instead.
+ *
+ *  @return #WEAVE_NO_ERROR on success; otherwise, a respective error code.
+ */
+WEAVE_ERROR WeaveServiceManager::indexDirectory(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t *p = mDirectory.base;
+    uint16_t entryLen = 0;
+
+    mIndexLength = 0;
+    mIndexValid = false;
+
+    VerifyOrExit(mDirectory.length <= ARRAY_SIZE(mIndex), err = WEAVE_ERROR_NO_MEMORY);
+
+    for (uint8_t i = 0; i < mDirectory.length; i++)
+    {
+        IndexEntry &entry = mIndex[i];
+
+        entry.ctrlByte = Read8(p);
+        entry.serviceEp = Read64(p);
+        entry.offset = p - mDirectory.base;
+
+        err = calculateEntryLength(p, entry.ctrlByte, &entryLen);
+        SuccessOrExit(err);
+
+        p += entryLen;
+    }
+
+    mIndexLength = mDirectory.length;
+    mIndexValid = true;
+
+exit:
+    return err;
+}
+
+/**
+ *  @brief
+ *    This method enables racing connections to service endpoints.
+ *
+ *  With connect racing enabled, a connection to a service endpoint whose
+ *  directory entry lists more than one host starts with the first host and,
+ *  if it hasn't completed after the stagger interval or as soon as it fails,
+ *  starts another connection to the next host, up to the given number of
+ *  connections. The first connection to complete is passed to the
+ *  connection complete handler and the others are aborted.
+ *
+ *  @param [in] aMaxAttempts   The maximum number of simultaneous connections,
+ *    capped at #WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE. A value of 1 or
+ *    less disables racing.
+ *
+ *  @param [in] aStaggerMsecs  The delay in milliseconds between the starts
+ *    of successive connections.
+ */
+void WeaveServiceManager::enableConnectRacing(uint8_t aMaxAttempts, uint32_t aStaggerMsecs)
+{
+    if (aMaxAttempts < 1)
+        aMaxAttempts = 1;
+
+    if (aMaxAttempts > WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE)
+        aMaxAttempts = WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE;
+
+    mRaceMaxAttempts = aMaxAttempts;
+    mRaceStaggerMsecs = aStaggerMsecs;
+}
+
+/**
+ *  @brief
+ *    This method disables racing connections to service endpoints, so
+ *    that the hosts of a directory entry are tried one at a time.
+ *    Races already in progress are not affected.
+ */
+void WeaveServiceManager::disableConnectRacing(void)
+{
+    mRaceMaxAttempts = 1;
+}
+
 /**
  *  @brief
  *    This method looks up the given service endpoint in the cache and sets up an
  *    Weave connection with completion callback.
  *
+ *  If connect racing is enabled and the directory entry lists more than one
+ *  host, the connection is raced against connections to the other hosts and
+ *  aConnection is replaced by the connection that completes first.
+ *
  *  @return #WEAVE_NO_ERROR on success; otherwise, a respective error code.
  */
-WEAVE_ERROR WeaveServiceManager::lookupAndConnect(WeaveConnection *aConnection,
+WEAVE_ERROR WeaveServiceManager::lookupAndConnect(WeaveConnection *&aConnection,
+                                                  ConnectRace &aRace,
                                                   uint64_t aServiceEp,
                                                   WeaveAuthMode aAuthMode,
                                                   void *aAppState,
@@ -1416,6 +1550,21 @@ WEAVE_ERROR WeaveServiceManager::lookupAndConnect(WeaveConnection *aConnection,
 
     itemCount = ctrlByte & kMask_HostPortListLen;
 
+    if (mRaceMaxAttempts > 1 && itemCount > 1)
+    {
+        err = aRace.start(this,
+                          aConnection,
+                          entry,
+                          itemCount,
+                          aServiceEp,
+                          aAuthMode,
+                          aAppState,
+                          aHandler,
+                          aConnectTimeoutMsecs,
+                          aConnectIntf);
+        ExitNow();
+    }
+
     aConnection->AppState = aAppState;
     aConnection->OnConnectionComplete = aHandler;
 
@@ -1435,6 +1584,336 @@ exit:
 }
 
 
+/**
+ *  @brief
+ *    This method starts racing connections to the items of a host/port list.
+ *
+ *  The first connection uses aConnection. Further connections are allocated
+ *  from the message layer as they are started. When the race ends,
+ *  aConnection is set to the connection passed to aHandler.
+ *
+ *  @return #WEAVE_NO_ERROR on success; otherwise, a respective error code, in
+ *    which case no connection has been started and aHandler is not called.
+ */
+WEAVE_ERROR WeaveServiceManager::ConnectRace::start(WeaveServiceManager *aManager,
+                                                    WeaveConnection *&aConnection,
+                                                    uint8_t *aEntry,
+                                                    uint8_t aItemCount,
+                                                    uint64_t aServiceEp,
+                                                    WeaveAuthMode aAuthMode,
+                                                    void *aAppState,
+                                                    WeaveConnection::ConnectionCompleteFunct aHandler,
+                                                    const uint32_t aConnectTimeoutMsecs,
+                                                    const InterfaceId aConnectIntf)
+{
+    WEAVE_ERROR err;
+
+    VerifyOrExit(!isActive(), err = WEAVE_ERROR_INCORRECT_STATE);
+
+    memset(mAttempts, 0, sizeof(mAttempts));
+
+    mManager = aManager;
+    mMessageLayer = aManager->mExchangeManager->MessageLayer;
+    mConnection = &aConnection;
+    mNextItem = aEntry;
+    mItemsLeft = aItemCount;
+    mNumStarted = 0;
+    mServiceEp = aServiceEp;
+    mAuthMode = aAuthMode;
+    mAppState = aAppState;
+    mHandler = aHandler;
+    mConnectTimeoutMsecs = aConnectTimeoutMsecs;
+    mConnIntf = aConnectIntf;
+
+    WeaveLogProgress(ServiceDirectory, "race(%llx) %d hosts", aServiceEp, aItemCount);
+
+    err = startAttempt(aConnection);
+
+    /*
+     * an error returned without a completion callback means the
+     * connection could not be started at all, which is just as true of
+     * any other connection, so give up the race. the caller still owns
+     * the connection.
+     */
+
+    if (err != WEAVE_NO_ERROR && removeAttempt(aConnection))
+    {
+        abort();
+    }
+    else
+    {
+        err = WEAVE_NO_ERROR;
+    }
+
+exit:
+    return err;
+}
+
+/**
+ *  @brief
+ *    This method aborts a race in progress.
+ *
+ *  All racing connections other than the owner's connection are aborted;
+ *  the owner remains responsible for its connection.
+ */
+void WeaveServiceManager::ConnectRace::abort(void)
+{
+    VerifyOrExit(isActive(), );
+
+    mMessageLayer->SystemLayer->CancelTimer(handleStaggerTimer, this);
+
+    for (uint8_t i = 0; i < ARRAY_SIZE(mAttempts); i++)
+    {
+        WeaveConnection *con = mAttempts[i];
+
+        if (con != NULL && con != *mConnection)
+            con->Abort();
+    }
+
+    memset(mAttempts, 0, sizeof(mAttempts));
+    mManager = NULL;
+
+exit:
+    return;
+}
+
+/**
+ *  @brief
+ *    This method starts a connection to the next item of the host/port list.
+ *    The last connection the race may start gets all the remaining items.
+ *
+ *  @return #WEAVE_NO_ERROR on success; otherwise, the error returned by
+ *    WeaveConnection::Connect().
+ */
+WEAVE_ERROR WeaveServiceManager::ConnectRace::startAttempt(WeaveConnection *aConnection)
+{
+    WEAVE_ERROR err;
+    uint8_t *item = mNextItem;
+    uint8_t count = 1;
+    uint16_t itemLen = 0;
+
+    if (mNumStarted + 1 >= mManager->mRaceMaxAttempts)
+        count = mItemsLeft;
+
+    mAttempts[mNumStarted++] = aConnection;
+
+    err = mManager->calculateEntryLength(item, kDirectoryEntryType_HostPortList | count, &itemLen);
+    if (err != WEAVE_NO_ERROR)
+    {
+        // the rest of the list can't be parsed either.
+
+        mItemsLeft = 0;
+        ExitNow();
+    }
+
+    mNextItem += itemLen;
+    mItemsLeft -= count;
+
+    if (mItemsLeft > 0)
+        mMessageLayer->SystemLayer->StartTimer(mManager->mRaceStaggerMsecs, handleStaggerTimer, this);
+
+    aConnection->AppState = this;
+    aConnection->OnConnectionComplete = handleAttemptComplete;
+
+    aConnection->SetConnectTimeout(mConnectTimeoutMsecs);
+
+    err = aConnection->Connect(mServiceEp,
+                               mAuthMode,
+                               HostPortList(item, count, mManager->mSuffixTable.base, mManager->mSuffixTable.length),
+                               mConnIntf);
+
+exit:
+    return err;
+}
+
+/**
+ *  @brief
+ *    This method starts another racing connection, unless all the host/port
+ *    list items have been tried or the message layer is out of connections.
+ */
+void WeaveServiceManager::ConnectRace::startNextAttempt(void)
+{
+    WeaveConnection *con;
+
+    VerifyOrExit(mItemsLeft > 0, );
+
+    con = mMessageLayer->NewConnection();
+    VerifyOrExit(con != NULL, WeaveLogProgress(ServiceDirectory, "race(%llx) no connection", mServiceEp));
+
+    launchAttempt(con);
+
+exit:
+    return;
+}
+
+/**
+ *  @brief
+ *    This method starts a racing connection after the first. An error
+ *    returned without a completion callback is handled as a failure of
+ *    that connection.
+ */
+void WeaveServiceManager::ConnectRace::launchAttempt(WeaveConnection *aConnection)
+{
+    WEAVE_ERROR err = startAttempt(aConnection);
+
+    if (err != WEAVE_NO_ERROR && findAttempt(aConnection) != NULL)
+        onAttemptComplete(aConnection, err);
+}
+
+/**
+ *  @brief
+ *    This method handles the completion of a racing connection.
+ *
+ *  A successful connection wins the race. A failed connection is dropped and
+ *  replaced by a connection to the next host, if any, without waiting for the
+ *  stagger interval. When the last connection fails, its error is reported.
+ */
+void WeaveServiceManager::ConnectRace::onAttemptComplete(WeaveConnection *aConnection, WEAVE_ERROR aError)
+{
+    WeaveConnection *next = NULL;
+
+    WeaveLogProgress(ServiceDirectory, "race(%llx) attempt <= %s", mServiceEp, ErrorStr(aError));
+
+    if (aError == WEAVE_NO_ERROR)
+    {
+        finish(aConnection, aError);
+        ExitNow();
+    }
+
+    removeAttempt(aConnection);
+
+    if (mItemsLeft > 0)
+        next = mMessageLayer->NewConnection();
+
+    if (next != NULL)
+    {
+        retire(aConnection);
+        launchAttempt(next);
+    }
+    else if (hasActiveAttempts())
+    {
+        retire(aConnection);
+    }
+    else
+    {
+        finish(aConnection, aError);
+    }
+
+exit:
+    return;
+}
+
+/**
+ *  @brief
+ *    This method ends the race, aborting every racing connection but the
+ *    given one and passing that one to the connection complete handler.
+ */
+void WeaveServiceManager::ConnectRace::finish(WeaveConnection *aConnection, WEAVE_ERROR aError)
+{
+    WeaveConnection::ConnectionCompleteFunct handler = mHandler;
+
+    WeaveLogProgress(ServiceDirectory, "race(%llx) done <= %s", mServiceEp, ErrorStr(aError));
+
+    removeAttempt(aConnection);
+
+    *mConnection = aConnection;
+
+    abort();
+
+    aConnection->AppState = mAppState;
+    aConnection->OnConnectionComplete = handler;
+
+    handler(aConnection, aError);
+}
+
+/**
+ *  @brief
+ *    This method finds a connection in the set of racing connections.
+ *
+ *  @return A pointer to the slot holding the connection, or NULL if the
+ *    connection isn't racing.
+ */
+WeaveConnection **WeaveServiceManager::ConnectRace::findAttempt(WeaveConnection *aConnection)
+{
+    for (uint8_t i = 0; i < ARRAY_SIZE(mAttempts); i++)
+    {
+        if (mAttempts[i] == aConnection)
+            return &mAttempts[i];
+    }
+
+    return NULL;
+}
+
+/**
+ *  @brief
+ *    This method removes a connection from the set of racing connections.
+ *
+ *  @return true if the connection was racing, false otherwise.
+ */
+bool WeaveServiceManager::ConnectRace::removeAttempt(WeaveConnection *aConnection)
+{
+    WeaveConnection **slot = findAttempt(aConnection);
+
+    if (slot != NULL)
+        *slot = NULL;
+
+    return (slot != NULL);
+}
+
+/**
+ *  @brief
+ *    This method tests if any racing connection is still in progress.
+ *
+ *  @return true if the test passes, false otherwise.
+ */
+bool WeaveServiceManager::ConnectRace::hasActiveAttempts(void) const
+{
+    for (uint8_t i = 0; i < ARRAY_SIZE(mAttempts); i++)
+    {
+        if (mAttempts[i] != NULL)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ *  @brief
+ *    This method closes a failed racing connection, clearing the owner's
+ *    connection if it was that one.
+ */
+void WeaveServiceManager::ConnectRace::retire(WeaveConnection *aConnection)
+{
+    if (*mConnection == aConnection)
+        *mConnection = NULL;
+
+    aConnection->Close();
+}
+
+/**
+ *  This method is a trampoline for the connection complete event of a racing
+ *  connection.
+ */
+void WeaveServiceManager::ConnectRace::handleAttemptComplete(WeaveConnection *aConnection, WEAVE_ERROR aError)
+{
+    ConnectRace *race = (ConnectRace *)aConnection->AppState;
+
+    if (race && race->isActive())
+        race->onAttemptComplete(aConnection, aError);
+}
+
+/**
+ *  This method is the stagger timer handler, which starts the next racing
+ *  connection.
+ */
+void WeaveServiceManager::ConnectRace::handleStaggerTimer(System::Layer *aSystemLayer, void *aAppState, System::Error aError)
+{
+    ConnectRace *race = (ConnectRace *)aAppState;
+
+    if (race->isActive())
+        race->startNextAttempt();
+}
+
 /**
  *  @brief
  *    This method updates the local directory cache with the response we
@@ -1693,6 +2172,8 @@ void WeaveServiceManager::cleanupExchangeContext(WEAVE_ERROR aErr)
         mExchangeContext = NULL;
     }
 
+    mDirectoryRace.abort();
+
     if (mConnection)
     {
         if (WEAVE_NO_ERROR == aErr)
@@ -1731,6 +2212,8 @@ void WeaveServiceManager::clearWorkingState(void)
     mSuffixTable.length = 0;
     mSuffixTable.base = NULL;
     mDirAndSuffTableSize = 0;
+    mIndexLength = 0;
+    mIndexValid = false;
 }
 
 /**
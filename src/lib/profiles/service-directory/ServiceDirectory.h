@@ -286,6 +286,10 @@ public:
     // goes to the service directory endpoint first
     void clearCache(void);
 
+    void enableConnectRacing(uint8_t aMaxAttempts = WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE,
+                             uint32_t aStaggerMsecs = WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_STAGGER_MSECS);
+    void disableConnectRacing(void);
+
     enum
     {
         /**
@@ -296,6 +300,75 @@ public:
         kWeave_DefaultSendTimeout = 15000
     };
 
+    /**
+     *  @class ConnectRace
+     *
+     *  @brief This class races connections to the entries of a host/port list.
+     *
+     *  When connect racing is enabled, the service manager connects to the
+     *  first entry of a directory entry's host/port list and, every stagger
+     *  interval or as soon as an attempt fails, starts another connection
+     *  to the next entry. The first attempt to complete wins and the others
+     *  are aborted. The last attempt that may be started walks the rest of
+     *  the list in order, as a plain connect would.
+     */
+    class ConnectRace
+    {
+    public:
+
+        WEAVE_ERROR start(WeaveServiceManager *aManager,
+                          WeaveConnection *&aConnection,
+                          uint8_t *aEntry,
+                          uint8_t aItemCount,
+                          uint64_t aServiceEp,
+                          WeaveAuthMode aAuthMode,
+                          void *aAppState,
+                          WeaveConnection::ConnectionCompleteFunct aHandler,
+                          const uint32_t aConnectTimeoutMsecs,
+                          const InterfaceId aConnectIntf);
+
+        void abort(void);
+
+        /**
+         *  This function tests if the race is in progress.
+         *
+         *  @return true if the test passes, false otherwise.
+         */
+        inline bool isActive(void) const
+        {
+            return (mManager != NULL);
+        }
+
+    private:
+
+        WEAVE_ERROR startAttempt(WeaveConnection *aConnection);
+        void startNextAttempt(void);
+        void launchAttempt(WeaveConnection *aConnection);
+        void onAttemptComplete(WeaveConnection *aConnection, WEAVE_ERROR aError);
+        void finish(WeaveConnection *aConnection, WEAVE_ERROR aError);
+        WeaveConnection **findAttempt(WeaveConnection *aConnection);
+        bool removeAttempt(WeaveConnection *aConnection);
+        bool hasActiveAttempts(void) const;
+        void retire(WeaveConnection *aConnection);
+
+        static void handleAttemptComplete(WeaveConnection *aConnection, WEAVE_ERROR aError);
+        static void handleStaggerTimer(System::Layer *aSystemLayer, void *aAppState, System::Error aError);
+
+        WeaveServiceManager *mManager;              ///< the manager that started the race, NULL when idle.
+        WeaveMessageLayer *mMessageLayer;           ///< the message layer racing connections are allocated from.
+        WeaveConnection **mConnection;              ///< the owner's connection, set to the outcome when the race ends.
+        WeaveConnection *mAttempts[WEAVE_CONFIG_SERVICE_DIR_CONNECT_RACE_SIZE];
+        uint8_t *mNextItem;                         ///< the first host/port list item not yet tried.
+        uint64_t mServiceEp;
+        WeaveAuthMode mAuthMode;
+        void *mAppState;
+        WeaveConnection::ConnectionCompleteFunct mHandler;
+        uint32_t mConnectTimeoutMsecs;
+        InterfaceId mConnIntf;
+        uint8_t mItemsLeft;                         ///< the number of host/port list items not yet tried.
+        uint8_t mNumStarted;                        ///< the number of attempts started so far.
+    };
+
     /**
      *  @class ConnectRequest
      *
@@ -349,6 +422,9 @@ public:
 
         void onConnectionComplete(WEAVE_ERROR aError);
 
+        /// The connect race in progress for this request, if any.
+        ConnectRace     mRace;
+
         // data members (basically the connect call arguments)
 
         uint64_t        mServiceEp;
@@ -378,11 +454,19 @@ private:
         size_t  length;
     };
 
+    struct IndexEntry
+    {
+        uint64_t serviceEp;                                   ///< the service endpoint identifier of the entry
+        uint16_t offset;                                      ///< the offset of the entry body from the start of the directory
+        uint8_t  ctrlByte;                                    ///< the directory entry control byte
+    };
+
     void freeConnectRequests(void);
     void finalizeConnectRequests(void);
     ConnectRequest *getAvailableRequest(void);
 
-    WEAVE_ERROR lookupAndConnect(WeaveConnection *aConnection,
+    WEAVE_ERROR lookupAndConnect(WeaveConnection *&aConnection,
+                                 ConnectRace &aRace,
                                  uint64_t aServiceEp,
                                  WeaveAuthMode aAuthMode,
                                  void *aAppState,
@@ -393,6 +477,7 @@ private:
     WEAVE_ERROR cacheDirectory(MessageIterator &, uint8_t, uint8_t *&);
     WEAVE_ERROR cacheSuffixes(MessageIterator &, uint8_t, uint8_t *&);
     WEAVE_ERROR calculateEntryLength(uint8_t *entryStart, uint8_t entryCtrlByte, uint16_t *entryLen);
+    WEAVE_ERROR indexDirectory(void);
     /*
      *  A group of methods that clear up working state and free
      *  resources - generally in the case of a failure. one of
@@ -434,6 +519,12 @@ private:
     bool                    mWasRelocated;                ///< true iff the service manager has been relocated once.
     WeaveAuthMode           mDirAuthMode;                 ///< the authentication mode to use when talking to the directory service.
     uint32_t                mDirAndSuffTableSize;         ///< the size of the directory and suffix table  in the cache.
+    IndexEntry              mIndex[WEAVE_CONFIG_SERVICE_DIR_INDEX_SIZE]; ///< the directory entries, in directory order
+    uint8_t                 mIndexLength;                 ///< the number of entries in mIndex
+    bool                    mIndexValid;                  ///< true iff mIndex reflects the current directory
+    ConnectRace             mDirectoryRace;               ///< the connect race for the directory connection, if any
+    uint8_t                 mRaceMaxAttempts;             ///< the maximum number of racing connections, 1 if racing is off
+    uint32_t                mRaceStaggerMsecs;            ///< the delay before starting the next racing connection
 
     /**
      *  Callback happens right before we send out the service endpoing query request
@@ -0,0 +1,405 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the streaming applier for Weave delta
+ *      image patches.
+ *
+ */
+
+#include <string.h>
+
+#include "DeltaImageApplier.h"
+#include <Weave/Core/WeaveEncoding.h>
+#include <Weave/Support/CodeUtils.h>
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace SoftwareUpdate {
+
+using namespace nl::Weave::Encoding;
+
+DeltaImageApplier::DeltaImageApplier(void)
+{
+    Reset();
+}
+
+/**
+ *  Prepare to apply a patch.
+ *
+ *  @param[in] delegate             Accessors for the base and target images.
+ *  @param[in] patchSpec            The patch specification from the image query response.
+ *  @param[in] targetIntegritySpec  The integrity spec of the target image, from the image query response.
+ *
+ *  @retval #WEAVE_NO_ERROR                     On success.
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT       If @a delegate is NULL or the patch format is not supported.
+ *  @retval #WEAVE_ERROR_INVALID_INTEGRITY_TYPE If the base or target integrity type is neither SHA-1 nor SHA-256.
+ */
+WEAVE_ERROR DeltaImageApplier::Init(Delegate *delegate, const PatchSpec &patchSpec, const IntegritySpec &targetIntegritySpec)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    Reset();
+
+    VerifyOrExit(delegate != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
+    VerifyOrExit(patchSpec.format == kPatchFormat_WeaveDelta, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    switch (patchSpec.baseIntegritySpec.type)
+    {
+    case kIntegrityType_SHA160:
+        memcpy(mBaseDigest, patchSpec.baseIntegritySpec.value, kLength_SHA160);
+        break;
+    case kIntegrityType_SHA256:
+        memcpy(mBaseDigest, patchSpec.baseIntegritySpec.value, kLength_SHA256);
+        break;
+    default:
+        ExitNow(err = WEAVE_ERROR_INVALID_INTEGRITY_TYPE);
+    }
+
+    switch (targetIntegritySpec.type)
+    {
+    case kIntegrityType_SHA160:
+        memcpy(mExpectedDigest, targetIntegritySpec.value, kLength_SHA160);
+        break;
+    case kIntegrityType_SHA256:
+        memcpy(mExpectedDigest, targetIntegritySpec.value, kLength_SHA256);
+        break;
+    default:
+        ExitNow(err = WEAVE_ERROR_INVALID_INTEGRITY_TYPE);
+    }
+
+    mDelegate = delegate;
+    mBaseIntegrityType = patchSpec.baseIntegritySpec.type;
+    mIntegrityType = targetIntegritySpec.type;
+    mExpectedPatchSize = patchSpec.patchSize;
+
+    ExpectField(kState_Header, kDeltaImageHeaderLength);
+
+exit:
+    return err;
+}
+
+/**
+ *  Consume the next piece of the patch.
+ *
+ *  The patch may be split at any byte boundary; typically this is called once for each
+ *  received BDX block.  Any error is terminal and the applier must be re-initialized.
+ *
+ *  @retval #WEAVE_NO_ERROR                 On success.
+ *  @retval #WEAVE_ERROR_INCORRECT_STATE        If the applier has not been initialized or has failed.
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT       If the patch is malformed or inconsistent with its header.
+ *  @retval #WEAVE_ERROR_INTEGRITY_CHECK_FAILED If the installed image does not match the base integrity spec.
+ *  @retval other                               Errors returned by the delegate.
+ */
+WEAVE_ERROR DeltaImageApplier::ProcessPatchData(const uint8_t *data, uint16_t dataLen)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint16_t chunkLen;
+
+    VerifyOrExit(mState != kState_Idle && mState != kState_Failed, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(mState != kState_Complete || dataLen == 0, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    mPatchBytesProcessed += dataLen;
+    VerifyOrExit(mExpectedPatchSize == 0 || mPatchBytesProcessed <= mExpectedPatchSize, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    while (dataLen > 0)
+    {
+        if (mState == kState_InsertData)
+        {
+            // Literal data goes straight to the target image.
+            chunkLen = (mInsertRemaining < dataLen) ? (uint16_t) mInsertRemaining : dataLen;
+
+            err = WriteTarget(data, chunkLen);
+            SuccessOrExit(err);
+
+            mInsertRemaining -= chunkLen;
+            if (mInsertRemaining == 0)
+                ExpectField(kState_Opcode, 1);
+        }
+        else
+        {
+            // Data following the end of the patch is an error.
+            VerifyOrExit(mState != kState_Complete, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+            chunkLen = mFieldLen - mFieldOffset;
+            if (chunkLen > dataLen)
+                chunkLen = dataLen;
+
+            memcpy(mField + mFieldOffset, data, chunkLen);
+            mFieldOffset += chunkLen;
+
+            if (mFieldOffset == mFieldLen)
+            {
+                err = ProcessField();
+                SuccessOrExit(err);
+            }
+        }
+
+        data += chunkLen;
+        dataLen -= chunkLen;
+    }
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+        mState = kState_Failed;
+
+    return err;
+}
+
+/**
+ *  Verify that the complete patch has been applied and that the resulting target image matches
+ *  its integrity spec.
+ *
+ *  @retval #WEAVE_NO_ERROR                     If the target image is complete and verified.
+ *  @retval #WEAVE_ERROR_INCORRECT_STATE        If the end of the patch has not been reached.
+ *  @retval #WEAVE_ERROR_INVALID_ARGUMENT       If the patch length differs from the patch spec.
+ *  @retval #WEAVE_ERROR_INTEGRITY_CHECK_FAILED If the target image digest does not match.
+ */
+WEAVE_ERROR DeltaImageApplier::Finish(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t digest[kLength_SHA256];
+    uint8_t digestLen;
+
+    VerifyOrExit(mState == kState_Complete, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(mExpectedPatchSize == 0 || mPatchBytesProcessed == mExpectedPatchSize, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    if (mIntegrityType == kIntegrityType_SHA160)
+    {
+        mSHA1.Finish(digest);
+        digestLen = kLength_SHA160;
+    }
+    else
+    {
+        mSHA256.Finish(digest);
+        digestLen = kLength_SHA256;
+    }
+
+    VerifyOrExit(memcmp(digest, mExpectedDigest, digestLen) == 0, err = WEAVE_ERROR_INTEGRITY_CHECK_FAILED);
+
+exit:
+    if (err != WEAVE_NO_ERROR && err != WEAVE_ERROR_INCORRECT_STATE)
+        mState = kState_Failed;
+
+    return err;
+}
+
+/**
+ *  Return the applier to its uninitialized state.
+ */
+void DeltaImageApplier::Reset(void)
+{
+    mDelegate = NULL;
+    mState = kState_Idle;
+    mIntegrityType = kIntegrityType_SHA160;
+    mBaseIntegrityType = kIntegrityType_SHA160;
+    mExpectedPatchSize = 0;
+    mPatchBytesProcessed = 0;
+    mBaseLength = 0;
+    mTargetLength = 0;
+    mTargetBytesWritten = 0;
+    mInsertRemaining = 0;
+    mFieldLen = 0;
+    mFieldOffset = 0;
+    mSHA1.Reset();
+    mSHA256.Reset();
+}
+
+void DeltaImageApplier::ExpectField(State state, uint8_t fieldLen)
+{
+    mState = state;
+    mFieldLen = fieldLen;
+    mFieldOffset = 0;
+}
+
+WEAVE_ERROR DeltaImageApplier::ProcessField(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint32_t offset;
+    uint32_t len;
+
+    switch (mState)
+    {
+    case kState_Header:
+        VerifyOrExit(LittleEndian::Get32(mField) == kDeltaImageMagic, err = WEAVE_ERROR_INVALID_ARGUMENT);
+        VerifyOrExit(mField[4] == kDeltaImageVersion, err = WEAVE_ERROR_INVALID_ARGUMENT);
+        mBaseLength = LittleEndian::Get32(mField + 5);
+        mTargetLength = LittleEndian::Get32(mField + 9);
+
+        err = VerifyBaseImage();
+        SuccessOrExit(err);
+
+        BeginTargetDigest();
+        ExpectField(kState_Opcode, 1);
+        break;
+
+    case kState_Opcode:
+        switch (mField[0])
+        {
+        case kDeltaOp_Copy:
+            ExpectField(kState_CopyArgs, 8);
+            break;
+        case kDeltaOp_Insert:
+            ExpectField(kState_InsertLength, 4);
+            break;
+        case kDeltaOp_End:
+            VerifyOrExit(mTargetBytesWritten == mTargetLength, err = WEAVE_ERROR_INVALID_ARGUMENT);
+            mState = kState_Complete;
+            break;
+        default:
+            ExitNow(err = WEAVE_ERROR_INVALID_ARGUMENT);
+        }
+        break;
+
+    case kState_CopyArgs:
+        offset = LittleEndian::Get32(mField);
+        len = LittleEndian::Get32(mField + 4);
+        VerifyOrExit(offset <= mBaseLength && len <= mBaseLength - offset, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+        err = CopyFromBase(offset, len);
+        SuccessOrExit(err);
+
+        ExpectField(kState_Opcode, 1);
+        break;
+
+    case kState_InsertLength:
+        mInsertRemaining = LittleEndian::Get32(mField);
+        VerifyOrExit(mInsertRemaining <= mTargetLength - mTargetBytesWritten, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+        if (mInsertRemaining == 0)
+            ExpectField(kState_Opcode, 1);
+        else
+            mState = kState_InsertData;
+        break;
+
+    default:
+        ExitNow(err = WEAVE_ERROR_INCORRECT_STATE);
+    }
+
+exit:
+    return err;
+}
+
+/**
+ *  Digest the whole installed image and compare it against the base integrity spec, so that a
+ *  patch is never applied to an image other than the one it was generated against.
+ */
+WEAVE_ERROR DeltaImageApplier::VerifyBaseImage(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t digest[kLength_SHA256];
+    uint8_t digestLen;
+    uint32_t offset = 0;
+    uint16_t chunkLen;
+
+    if (mBaseIntegrityType == kIntegrityType_SHA160)
+        mSHA1.Begin();
+    else
+        mSHA256.Begin();
+
+    while (offset < mBaseLength)
+    {
+        chunkLen = (mBaseLength - offset < sizeof(mCopyBuf)) ? (uint16_t) (mBaseLength - offset) : (uint16_t) sizeof(mCopyBuf);
+
+        err = mDelegate->ReadBaseImage(offset, mCopyBuf, chunkLen);
+        SuccessOrExit(err);
+
+        if (mBaseIntegrityType == kIntegrityType_SHA160)
+            mSHA1.AddData(mCopyBuf, chunkLen);
+        else
+            mSHA256.AddData(mCopyBuf, chunkLen);
+
+        offset += chunkLen;
+    }
+
+    if (mBaseIntegrityType == kIntegrityType_SHA160)
+    {
+        mSHA1.Finish(digest);
+        digestLen = kLength_SHA160;
+    }
+    else
+    {
+        mSHA256.Finish(digest);
+        digestLen = kLength_SHA256;
+    }
+
+    VerifyOrExit(memcmp(digest, mBaseDigest, digestLen) == 0, err = WEAVE_ERROR_INTEGRITY_CHECK_FAILED);
+
+exit:
+    return err;
+}
+
+void DeltaImageApplier::BeginTargetDigest(void)
+{
+    if (mIntegrityType == kIntegrityType_SHA160)
+        mSHA1.Begin();
+    else
+        mSHA256.Begin();
+}
+
+WEAVE_ERROR DeltaImageApplier::CopyFromBase(uint32_t offset, uint32_t len)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint16_t chunkLen;
+
+    VerifyOrExit(len <= mTargetLength - mTargetBytesWritten, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    while (len > 0)
+    {
+        chunkLen = (len < sizeof(mCopyBuf)) ? (uint16_t) len : (uint16_t) sizeof(mCopyBuf);
+
+        err = mDelegate->ReadBaseImage(offset, mCopyBuf, chunkLen);
+        SuccessOrExit(err);
+
+        err = WriteTarget(mCopyBuf, chunkLen);
+        SuccessOrExit(err);
+
+        offset += chunkLen;
+        len -= chunkLen;
+    }
+
+exit:
+    return err;
+}
+
+WEAVE_ERROR DeltaImageApplier::WriteTarget(const uint8_t *data, uint16_t len)
+{
+    WEAVE_ERROR err;
+
+    VerifyOrExit(len <= mTargetLength - mTargetBytesWritten, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    err = mDelegate->WriteTargetImage(data, len);
+    SuccessOrExit(err);
+
+    if (mIntegrityType == kIntegrityType_SHA160)
+        mSHA1.AddData(data, len);
+    else
+        mSHA256.AddData(data, len);
+
+    mTargetBytesWritten += len;
+
+exit:
+    return err;
+}
+
+} // namespace SoftwareUpdate
+} // namespace Profiles
+} // namespace Weave
+} // namespace nl
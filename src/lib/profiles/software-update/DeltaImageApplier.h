@@ -0,0 +1,168 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the Weave delta image patch format and a
+ *      streaming applier that reconstructs a target firmware image from
+ *      the installed (base) image and a patch received block by block,
+ *      e.g. over BDX, without buffering the patch.
+ *
+ *      A patch in kPatchFormat_WeaveDelta format consists of a header
+ *      followed by a sequence of commands, each introduced by an opcode
+ *      byte.  All multi-byte integers are little-endian.
+ *
+ *          | magic "WDLT" (4) | version (1) | base length (4) | target length (4) |
+ *
+ *          kDeltaOp_Copy   | base offset (4) | length (4) |
+ *              append length bytes of the base image, starting at base offset
+ *
+ *          kDeltaOp_Insert | length (4) | <length bytes of data> |
+ *              append the literal data that follows
+ *
+ *          kDeltaOp_End
+ *              the target image is complete
+ *
+ *      The target image is always written sequentially; only the base
+ *      image needs random access.
+ *
+ */
+
+#ifndef _DELTA_IMAGE_APPLIER_H
+#define _DELTA_IMAGE_APPLIER_H
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Profiles/ProfileCommon.h>
+#include <Weave/Support/crypto/HashAlgos.h>
+#include "SoftwareUpdateProfile.h"
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace SoftwareUpdate {
+
+enum
+{
+    kDeltaImageMagic                = 0x544C4457,   ///< "WDLT", as read little-endian.
+    kDeltaImageVersion              = 1,
+    kDeltaImageHeaderLength         = 13,
+};
+
+enum
+{
+    kDeltaOp_End                    = 0,
+    kDeltaOp_Copy                   = 1,
+    kDeltaOp_Insert                 = 2,
+};
+
+/**
+ *  @class DeltaImageApplier
+ *
+ *  @brief
+ *    Applies a delta image patch to the installed image as the patch
+ *    arrives.
+ *
+ *  The applier holds only a small amount of state: the partially
+ *  received command header, a copy buffer of
+ *  #WEAVE_CONFIG_SWU_DELTA_COPY_BUFFER_SIZE bytes and a running digest of
+ *  the target image.  Literal data is passed straight from the patch
+ *  blocks to the target image.
+ *
+ *  Once the patch header gives the length of the base image, the applier
+ *  reads the whole installed image through the delegate and checks it
+ *  against the base integrity spec in the PatchSpec.  Nothing is written
+ *  to the target image unless the two match.
+ */
+class NL_DLL_EXPORT DeltaImageApplier
+{
+public:
+    /**
+     *  Storage accessors used by the applier.
+     */
+    class Delegate
+    {
+    public:
+        /**
+         *  Read @a len bytes of the installed image starting at @a offset.
+         */
+        virtual WEAVE_ERROR ReadBaseImage(uint32_t offset, uint8_t *buf, uint16_t len) = 0;
+
+        /**
+         *  Append @a len bytes to the target image.
+         */
+        virtual WEAVE_ERROR WriteTargetImage(const uint8_t *data, uint16_t len) = 0;
+    };
+
+    DeltaImageApplier(void);
+
+    WEAVE_ERROR Init(Delegate *delegate, const PatchSpec &patchSpec, const IntegritySpec &targetIntegritySpec);
+    WEAVE_ERROR ProcessPatchData(const uint8_t *data, uint16_t dataLen);
+    WEAVE_ERROR Finish(void);
+    void Reset(void);
+
+    bool IsComplete(void) const { return mState == kState_Complete; }
+    uint32_t GetTargetLength(void) const { return mTargetLength; }
+    uint32_t GetTargetBytesWritten(void) const { return mTargetBytesWritten; }
+    uint32_t GetPatchBytesProcessed(void) const { return mPatchBytesProcessed; }
+
+private:
+    enum State
+    {
+        kState_Idle,
+        kState_Header,
+        kState_Opcode,
+        kState_CopyArgs,
+        kState_InsertLength,
+        kState_InsertData,
+        kState_Complete,
+        kState_Failed,
+    };
+
+    Delegate *mDelegate;
+    State mState;
+    uint8_t mIntegrityType;
+    uint8_t mExpectedDigest[kLength_SHA256];
+    uint8_t mBaseIntegrityType;
+    uint8_t mBaseDigest[kLength_SHA256];
+    uint32_t mExpectedPatchSize;
+    uint32_t mPatchBytesProcessed;
+    uint32_t mBaseLength;
+    uint32_t mTargetLength;
+    uint32_t mTargetBytesWritten;
+    uint32_t mInsertRemaining;
+    uint8_t mField[kDeltaImageHeaderLength];
+    uint8_t mFieldLen;
+    uint8_t mFieldOffset;
+    uint8_t mCopyBuf[WEAVE_CONFIG_SWU_DELTA_COPY_BUFFER_SIZE];
+    nl::Weave::Platform::Security::SHA1 mSHA1;
+    nl::Weave::Platform::Security::SHA256 mSHA256;
+
+    void ExpectField(State state, uint8_t fieldLen);
+    WEAVE_ERROR ProcessField(void);
+    WEAVE_ERROR VerifyBaseImage(void);
+    void BeginTargetDigest(void);
+    WEAVE_ERROR CopyFromBase(uint32_t offset, uint32_t len);
+    WEAVE_ERROR WriteTarget(const uint8_t *data, uint16_t len);
+};
+
+} // namespace SoftwareUpdate
+} // namespace Profiles
+} // namespace Weave
+} // namespace nl
+
+#endif // _DELTA_IMAGE_APPLIER_H
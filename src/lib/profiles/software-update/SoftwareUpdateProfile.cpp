@@ -102,17 +102,17 @@ bool IntegrityTypeList::operator == (const IntegrityTypeList &another) const
 UpdateSchemeList::UpdateSchemeList()
 {
   theLength=0;
-  for (int i=0; i<4; i++) theList[i]=kUpdateScheme_HTTP;
+  for (int i=0; i<5; i++) theList[i]=kUpdateScheme_HTTP;
 }
 /*
  * parameters:
- * - uint8_t aLength, an 8-bit length value for the list (<5)
+ * - uint8_t aLength, an 8-bit length value for the list (<6)
  * - uint8_t *aList, pointer to an array of update scheme values
  * return: error/status
  */
 WEAVE_ERROR UpdateSchemeList::init(uint8_t aLength, uint8_t *aList)
 {
-  if (aLength>4) return WEAVE_ERROR_INVALID_LIST_LENGTH;
+  if (aLength>5) return WEAVE_ERROR_INVALID_LIST_LENGTH;
   theLength=aLength;
   for (int i=0; i<theLength; i++) theList[i]=aList[i];
   return WEAVE_NO_ERROR;
@@ -140,6 +140,7 @@ WEAVE_ERROR UpdateSchemeList::pack(MessageIterator &i)
 WEAVE_ERROR UpdateSchemeList::parse(MessageIterator &i, UpdateSchemeList &aList)
 {
   i.readByte(&aList.theLength);
+  if (aList.theLength>5) return WEAVE_ERROR_INVALID_LIST_LENGTH;
   if (!i.hasData(aList.theLength)) return WEAVE_ERROR_INVALID_LIST_LENGTH;
   for (int j=0; j<aList.theLength; j++) i.readByte(&aList.theList[j]);
   return WEAVE_NO_ERROR;
@@ -183,6 +184,8 @@ bool ProductSpec::operator == (const ProductSpec &another) const
   return ((vendorId == another.vendorId) && (productId == another.productId) && (productRev == another.productRev));
 }
 
+static WEAVE_ERROR packInstalledImageHash(MessageIterator &i, IntegritySpec &aSpec);
+static WEAVE_ERROR parseInstalledImageHash(MessageIterator &i, bool &aPresent, IntegritySpec &aSpec);
 /*
  * the no-arg constructor for an ImageQuery
  */
@@ -197,6 +200,7 @@ ImageQuery::ImageQuery()
   localeSpec.theLength=0;
   localeSpec.isShort=true;
   targetNodeId=0;
+  installedImageHashPresent=false;
 }
 /*
  * parameters:
@@ -207,6 +211,8 @@ ImageQuery::ImageQuery()
  * - ReferencedString *aPackage, the sending device's package spec (optional)
  * - ReferencedString *aLocale, the sending device's locale spec (optional)
  * - ReferencedTLVData *aMetaData, optional TLV-encoded vendor data
+ * - IntegritySpec *aInstalledImageHash, the integrity spec of the sending
+ * device's installed image, for delta updates (optional)
  return: error/status
 */
 WEAVE_ERROR ImageQuery::init(ProductSpec &aProductSpec,
@@ -216,7 +222,8 @@ WEAVE_ERROR ImageQuery::init(ProductSpec &aProductSpec,
                              ReferencedString *aPackage,
                              ReferencedString *aLocale,
                              uint64_t aTargetNodeId,
-                             ReferencedTLVData *aMetaData)
+                             ReferencedTLVData *aMetaData,
+                             IntegritySpec *aInstalledImageHash)
 {
   productSpec=aProductSpec;
   version=aVersion;
@@ -230,6 +237,8 @@ WEAVE_ERROR ImageQuery::init(ProductSpec &aProductSpec,
   if (aLocale!=NULL) localeSpec=*aLocale;
   targetNodeId=aTargetNodeId;
   if (aMetaData!=NULL) theMetaData=*aMetaData;
+  installedImageHashPresent=(aInstalledImageHash!=NULL);
+  if (aInstalledImageHash!=NULL) installedImageHash=*aInstalledImageHash;
   return WEAVE_NO_ERROR;
 }
 /*
@@ -263,6 +272,7 @@ WEAVE_ERROR ImageQuery::pack(PacketBuffer *aBuffer)
   if (packageSpec.theLength!=0) TRY(packageSpec.pack(i));
   if (localeSpec.theLength!=0) TRY(localeSpec.pack(i));
   if (targetNodeId!=0) TRY(i.write64(targetNodeId));
+  if (installedImageHashPresent) TRY(packInstalledImageHash(i, installedImageHash));
   theMetaData.pack(i);
   return WEAVE_NO_ERROR;
 }
@@ -294,6 +304,8 @@ WEAVE_ERROR ImageQuery::parse(PacketBuffer *aBuffer, ImageQuery &aQuery)
   if (frameCtl & kFlag_LocaleSpecPresent) TRY(ReferencedString::parse(i, aQuery.localeSpec));
   // if a target node id is provided then get it
   if (frameCtl & kFlag_TargetNodeIdPresent) TRY(i.read64(&aQuery.targetNodeId));
+  // the installed image's integrity spec, if provided, leads the metadata
+  TRY(parseInstalledImageHash(i, aQuery.installedImageHashPresent, aQuery.installedImageHash));
   // and maybe the metadata
   ReferencedTLVData::parse(i, aQuery.theMetaData);
   return WEAVE_NO_ERROR;
@@ -315,6 +327,8 @@ bool ImageQuery::operator == (const ImageQuery &another) const
           (packageSpec==another.packageSpec) &&
           (localeSpec==another.localeSpec) &&
           (targetNodeId==another.targetNodeId) &&
+          (installedImageHashPresent==another.installedImageHashPresent) &&
+          (!installedImageHashPresent || installedImageHash==another.installedImageHash) &&
           (theMetaData==another.theMetaData));
 }
 /*
@@ -336,6 +350,66 @@ inline int integrityLength(uint8_t aType)
     return 0;
   }
 }
+/*
+ * the installed image's integrity spec is carried in the image query's
+ * metadata as a byte string holding the integrity type followed by the
+ * value, i.e. the same bytes as a packed IntegritySpec.
+ *
+ * parameters:
+ * - MessageIterator &i, an iterator over the message being packed
+ * - IntegritySpec &aSpec, the integrity spec of the installed image
+ * returns: error/status
+ */
+static WEAVE_ERROR packInstalledImageHash(MessageIterator &i, IntegritySpec &aSpec)
+{
+  uint8_t elem[1+kLength_SHA512];
+  uint8_t len=integrityLength(aSpec.type);
+  TLV::TLVWriter writer;
+  if (len==0) return WEAVE_ERROR_INVALID_INTEGRITY_TYPE;
+  elem[0]=aSpec.type;
+  memcpy(&elem[1], aSpec.value, len);
+  writer.Init(i.GetBuffer());
+  TRY(writer.PutBytes(TLV::ProfileTag(kWeaveProfile_SWU, kTag_InstalledImageIntegritySpec), elem, 1+len));
+  TRY(writer.Finalize());
+  i.append();
+  return WEAVE_NO_ERROR;
+}
+/*
+ * parameters:
+ * - MessageIterator &i, an iterator over the message being parsed,
+ * positioned at the start of the metadata. it is advanced past the
+ * installed image's integrity spec if there is one.
+ * - bool &aPresent, set to whether the integrity spec was found
+ * - IntegritySpec &aSpec, an object to contain the result
+ * returns: error/status
+ */
+static WEAVE_ERROR parseInstalledImageHash(MessageIterator &i, bool &aPresent, IntegritySpec &aSpec)
+{
+  PacketBuffer *buff=i.GetBuffer();
+  uint16_t remaining=buff->DataLength()-(i.thePoint-buff->Start());
+  uint8_t elem[1+kLength_SHA512];
+  uint32_t headerLen;
+  uint32_t len;
+  TLV::TLVReader reader;
+  aPresent=false;
+  if (remaining==0) return WEAVE_NO_ERROR;
+  // vendor metadata that isn't well-formed TLV is still passed through
+  // untouched, so only an element with our tag is of interest here.
+  reader.Init(i.thePoint, remaining);
+  if (reader.Next()!=WEAVE_NO_ERROR ||
+      reader.GetTag()!=TLV::ProfileTag(kWeaveProfile_SWU, kTag_InstalledImageIntegritySpec))
+    return WEAVE_NO_ERROR;
+  if (reader.GetType()!=TLV::kTLVType_ByteString) return WEAVE_ERROR_WRONG_TLV_TYPE;
+  headerLen=reader.GetLengthRead();
+  len=reader.GetLength();
+  if (len<1 || len>sizeof(elem)) return WEAVE_ERROR_INVALID_TLV_ELEMENT;
+  TRY(reader.GetBytes(elem, len));
+  if (integrityLength(elem[0])!=(int)len-1) return WEAVE_ERROR_INVALID_INTEGRITY_TYPE;
+  TRY(aSpec.init(elem[0], &elem[1]));
+  aPresent=true;
+  i.thePoint+=headerLen+len;
+  return WEAVE_NO_ERROR;
+}
 /*
  * the no-arg contructor for an IntegritySpec
  */
@@ -395,6 +469,63 @@ bool IntegritySpec::operator == (const IntegritySpec &another) const
   }
   return true;
 }
+/*
+ * the no-arg constructor for a PatchSpec
+ */
+PatchSpec::PatchSpec()
+{
+  format=kPatchFormat_WeaveDelta;
+  patchSize=0;
+}
+/*
+ * parameters:
+ * - uint8_t aFormat, the patch format
+ * - IntegritySpec &aBaseIntegrity, the integrity spec of the image the patch applies to
+ * - uint32_t aPatchSize, the size of the patch in bytes
+ * return: error/status
+ */
+WEAVE_ERROR PatchSpec::init(uint8_t aFormat, IntegritySpec &aBaseIntegrity, uint32_t aPatchSize)
+{
+  format=aFormat;
+  baseIntegritySpec=aBaseIntegrity;
+  patchSize=aPatchSize;
+  return WEAVE_NO_ERROR;
+}
+/*
+ * parameters: MessageIterator &i, an iterator over the message
+ * being packed
+ * returns: error/status
+ */
+WEAVE_ERROR PatchSpec::pack(MessageIterator &i)
+{
+  TRY(i.writeByte(format));
+  TRY(baseIntegritySpec.pack(i));
+  TRY(i.write32(patchSize));
+  return WEAVE_NO_ERROR;
+}
+/*
+ * parameters:
+ * - MessageIterator &i, an iterator over the message being parsed
+ * - PatchSpec &aSpec, a pointer to an object to contain the result
+ * returns: error/status
+ */
+WEAVE_ERROR PatchSpec::parse(MessageIterator &i, PatchSpec &aSpec)
+{
+  TRY(i.readByte(&aSpec.format));
+  TRY(IntegritySpec::parse(i, aSpec.baseIntegritySpec));
+  TRY(i.read32(&aSpec.patchSize));
+  return WEAVE_NO_ERROR;
+}
+/*
+ * parameter: PatchSpec &another, another spec to check against
+ * returns: true if the patch specs are equal, false otherwise
+ */
+bool PatchSpec::operator == (const PatchSpec &another) const
+{
+  return ((format==another.format) &&
+          (baseIntegritySpec==another.baseIntegritySpec) &&
+          (patchSize==another.patchSize));
+}
 /*
  * parameters:
  * - ReferencedString &aUri, the URI at which the new firmware image is to be found
@@ -405,13 +536,16 @@ bool IntegritySpec::operator == (const IntegritySpec &another) const
  * - UpdateCondition aCondition, the condition under which to update
  * - bool aReportStatus, if true requests the client to report after download and
  * update, otherwise the client will not report
+ * - PatchSpec *aPatchSpec, the patch to download, required if and only if the
+ * update scheme is kUpdateScheme_BDXDelta
  * return: error/status
  */
 WEAVE_ERROR ImageQueryResponse::init(ReferencedString &aUri, ReferencedString &aVersion,
                                      IntegritySpec &aIntegrity, uint8_t aScheme,
                                      UpdatePriority aPriority, UpdateCondition aCondition,
-                                     bool aReportStatus)
+                                     bool aReportStatus, PatchSpec *aPatchSpec)
 {
+  if ((aScheme==kUpdateScheme_BDXDelta)!=(aPatchSpec!=NULL)) return WEAVE_ERROR_INVALID_ARGUMENT;
   // we assume success here (woohoo! optional)
   uri=aUri;
   versionSpec=aVersion;
@@ -421,6 +555,7 @@ WEAVE_ERROR ImageQueryResponse::init(ReferencedString &aUri, ReferencedString &a
   updatePriority=aPriority;
   updateCondition=aCondition;
   reportStatus=aReportStatus;
+  if (aPatchSpec!=NULL) patchSpec=*aPatchSpec;
   return WEAVE_NO_ERROR;
 }
 /*
@@ -449,6 +584,7 @@ WEAVE_ERROR ImageQueryResponse::pack(PacketBuffer* aBuffer)
   uint8_t updateOptions=(uint8_t)updatePriority|((uint8_t)updateCondition<<kOffset_UpdateCondition);
   if (reportStatus) updateOptions|=kMask_ReportStatus;
   TRY(i.writeByte(updateOptions));
+  if (updateScheme==kUpdateScheme_BDXDelta) TRY(patchSpec.pack(i));
   return WEAVE_NO_ERROR;
 }
 /*
@@ -469,6 +605,7 @@ WEAVE_ERROR ImageQueryResponse::parse(PacketBuffer *aBuffer, ImageQueryResponse
   aResponse.updatePriority=(UpdatePriority)(updateOptions&kMask_UpdatePriority);
   aResponse.updateCondition=(UpdateCondition)((updateOptions&kMask_UpdateCondition)>>kOffset_UpdateCondition);
   aResponse.reportStatus=(updateOptions&kMask_ReportStatus)==kMask_ReportStatus;
+  if (aResponse.updateScheme==kUpdateScheme_BDXDelta) TRY(PatchSpec::parse(i, aResponse.patchSpec));
   return WEAVE_NO_ERROR;
 }
 /*
@@ -483,5 +620,6 @@ bool ImageQueryResponse::operator ==(const ImageQueryResponse &another) const
           (updateScheme==another.updateScheme) &&
           (updatePriority==another.updatePriority) &&
           (updateCondition==another.updateCondition) &&
-          (reportStatus==another.reportStatus));
+          (reportStatus==another.reportStatus) &&
+          (updateScheme!=kUpdateScheme_BDXDelta || patchSpec==another.patchSpec));
 }
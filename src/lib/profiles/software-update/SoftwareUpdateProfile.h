@@ -167,6 +167,15 @@ namespace SoftwareUpdate {
     kUpdateScheme_HTTPS	=				1,
     kUpdateScheme_SFTP =				2,
     kUpdateScheme_BDX =					3, // Nest Weave download protocol
+    kUpdateScheme_BDXDelta =				4, // Nest Weave download protocol, delta image
+  };
+  /*
+   * when the update scheme is kUpdateScheme_BDXDelta the client downloads a
+   * patch rather than a full image and applies it to the image it currently
+   * has installed. the format of the patch is identified by one of:
+   */
+  enum {
+    kPatchFormat_WeaveDelta =				0, // see DeltaImageApplier.h
   };
 
   /*
@@ -180,7 +189,8 @@ namespace SoftwareUpdate {
     kTag_InstalledLocales       = 0x00,    // Fully-Qualified  Array of strings   Required
     kTag_CertBodyId             = 0x01,    // Fully-Qualified  Integer            Required
     kTag_WirelessRegDom         = 0x02,    // Fully-Qualified  Integer            Optional
-    kTag_SufficientBatterySWU   = 0x03     // Fully-Qualified  Bool               Required
+    kTag_SufficientBatterySWU   = 0x03,    // Fully-Qualified  Bool               Required
+    kTag_InstalledImageIntegritySpec = 0x04 // Fully-Qualified Byte string        Optional
   };
 
 
@@ -207,6 +217,9 @@ namespace SoftwareUpdate {
    * bit 0 - 1==vendor-specifc data present, 0==not present
    * bit 1 - 1==locale specification present, 0==not present
    *
+   * a client that can apply delta images sends the hash of its installed
+   * image in the TLV metadata, under kTag_InstalledImageIntegritySpec.
+   *
    * the image query, as a structure reads slightly differently from the in-flight
    * representation. in particular, the version and locale are null-terminated
    * strings and both of the optional items are represented as nullable pointers
@@ -237,7 +250,7 @@ namespace SoftwareUpdate {
   /*
    * an auxiliary class that holds a list of update schemes as part of
    * the image query. these are pretty simple and are essenitlly wrappers
-   * around a 4-element array of values drawn from the above enumeration.
+   * around a 5-element array of values drawn from the above enumeration.
    */
   class NL_DLL_EXPORT UpdateSchemeList {
   public:
@@ -256,7 +269,7 @@ namespace SoftwareUpdate {
     // 0 this indicates that the list is undefined since, to be useful,
     // one of these things has to caontain at least one element.
     uint8_t theLength;
-    uint8_t theList[4];
+    uint8_t theList[5];
   };
   /*
    * an auxiliary class that represents a product specification, which
@@ -278,10 +291,40 @@ namespace SoftwareUpdate {
     uint16_t productId;
     uint16_t productRev;
   };
+  /*
+   * an integrity specification is a simple object that contains an
+   * integrity type, as defined in the above enumeration, plus an integrity
+   * check value.
+   *
+   * and the integrity specification object itself is sized to fit
+   * the largest of these.
+   */
+  class NL_DLL_EXPORT IntegritySpec {
+  public:
+    //constructor
+    IntegritySpec();
+    // initializer
+    WEAVE_ERROR init(uint8_t, uint8_t*);
+    // packing and parsing
+    WEAVE_ERROR pack(MessageIterator&);
+    static WEAVE_ERROR parse(MessageIterator&, IntegritySpec&);
+    // comparison
+    bool operator == (const IntegritySpec&) const;
+    // data members
+    uint8_t type;
+    uint8_t value[64];
+  };
   /*
    * ImageQuery also declares a utility print method but obviously this
    * can only be defined is there's some way to do printing, e.g. on a test
    * platform or framework.
+   *
+   * a client that offers kUpdateScheme_BDXDelta should also supply the
+   * integrity spec of its installed image so that the server can select a
+   * patch whose base is exactly that image. it travels as the first element
+   * of the TLV metadata, tagged kTag_InstalledImageIntegritySpec, so that
+   * servers which do not know about it see nothing but extra metadata.
+   * theMetaData holds only the vendor metadata that follows it.
    */
   class NL_DLL_EXPORT ImageQuery {
   public:
@@ -295,7 +338,8 @@ namespace SoftwareUpdate {
                      ReferencedString *aPackage=NULL, // 1 byte length
                      ReferencedString *aLocale=NULL,
                      uint64_t aTargetNodeId=0,
-                     ReferencedTLVData *aMetaData=NULL); // 2 byte length
+                     ReferencedTLVData *aMetaData=NULL, // 2 byte length
+                     IntegritySpec *aInstalledImageHash=NULL);
     // packing and parsing
     WEAVE_ERROR pack(PacketBuffer*);
     uint16_t packedLength();
@@ -313,13 +357,15 @@ namespace SoftwareUpdate {
     ReferencedString packageSpec;	// optional
     ReferencedString localeSpec;		// optional
     ReferencedTLVData theMetaData;	// optional
+    bool installedImageHashPresent;
+    IntegritySpec installedImageHash;	// optional
   };
   /*
    * the image query response message has the form:
    *
    * | <status report> | URI (optional) | | <version specification> (optional) |
    * | <integrity specification> (optional) | <update scheme> (optional) |
-   * | <update options> (optional) |
+   * | <update options> (optional) | <patch specification> (delta only) |
    *
    * where all the the fields following the status report field are optional and
    * have values of significance only if the status report denotes success.
@@ -359,40 +405,49 @@ namespace SoftwareUpdate {
     OnOptIn
   };
   /*
-   * an integrity specification is a simple object that contains an
-   * integrity type, as defined in the above enumeration, plus an integrity
-   * check value.
+   * a patch specification describes a delta image, i.e. a binary patch that
+   * transforms the client's installed image into the image described by the
+   * image query response. it consists of:
+   * - the patch format, drawn from the enumeration above
+   * - the integrity spec of the base image to which the patch applies
+   * - the size in bytes of the patch
    *
-   * and the integrity specification object itself is sized to fit
-   * the largest of these.
+   * the integrity spec of the target image is the one carried by the image
+   * query response itself.
    */
-  class NL_DLL_EXPORT IntegritySpec {
+  class NL_DLL_EXPORT PatchSpec {
   public:
-    //constructor
-    IntegritySpec();
+    // constructor
+    PatchSpec();
     // initializer
-    WEAVE_ERROR init(uint8_t, uint8_t*);
+    WEAVE_ERROR init(uint8_t, IntegritySpec&, uint32_t);
     // packing and parsing
     WEAVE_ERROR pack(MessageIterator&);
-    static WEAVE_ERROR parse(MessageIterator&, IntegritySpec&);
+    static WEAVE_ERROR parse(MessageIterator&, PatchSpec&);
     // comparison
-    bool operator == (const IntegritySpec&) const;
+    bool operator == (const PatchSpec&) const;
     // data members
-    uint8_t type;
-    uint8_t value[64];
+    uint8_t format;
+    IntegritySpec baseIntegritySpec;
+    uint32_t patchSize;
   };
   /*
    * the image query response is only sent in the case where
    * the image query is processed successfully and produces an
    * image to download. it eszentially constitues download instructions
    * for the node the submitted the query.
+   *
+   * when the update scheme is kUpdateScheme_BDXDelta, the URI designates a
+   * patch rather than an image and a patch specification follows the update
+   * options field on the wire.
    */
   class NL_DLL_EXPORT ImageQueryResponse {
   public:
     // constructor
     ImageQueryResponse();
     // initializers
-    WEAVE_ERROR init (ReferencedString&, ReferencedString&, IntegritySpec&, uint8_t, UpdatePriority, UpdateCondition, bool);
+    WEAVE_ERROR init (ReferencedString&, ReferencedString&, IntegritySpec&, uint8_t, UpdatePriority, UpdateCondition, bool,
+                      PatchSpec *aPatchSpec=NULL);
     // packing and parsing
     WEAVE_ERROR pack(PacketBuffer*);
     uint16_t packedLength();
@@ -409,6 +464,7 @@ namespace SoftwareUpdate {
     UpdatePriority updatePriority;
     UpdateCondition updateCondition;
     bool reportStatus;
+    PatchSpec patchSpec;	// only if updateScheme is kUpdateScheme_BDXDelta
   };
 } // namespace SoftwareUpdate
 } // namespace Profiles
@@ -822,6 +822,31 @@ public:
      */
     WEAVE_ERROR SyncWithNodes(const int16_t aNumNode, const ServingNode aNodes[]);
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    /**
+     * enable concurrent sync.
+     * in each round of a local sync, requests are sent to all contacts at once, each on its own
+     * Weave Exchange with its own response timeout, instead of one contact after another.
+     * a round ends when every contact has responded or timed out, or as soon as aQuorum usable
+     * responses have arrived, in which case requests still outstanding are abandoned.
+     * sync with the service is not affected.
+     * only available in idle state.
+     * not available in callbacks.
+     *
+     * @param[in] aQuorum                       number of usable responses that completes a round.
+     *                                          0 means waiting for every contact
+     *
+     * @return                                  WEAVE_NO_ERROR on success
+     *
+     */
+    WEAVE_ERROR EnableConcurrentSync(const uint8_t aQuorum = WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC_QUORUM);
+
+    /// disable concurrent sync, so contacts are reached one after another.
+    /// only available in idle state.
+    /// not available in callbacks.
+    void DisableConcurrentSync(void);
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
     /**
      * force the engine to go back to idle state, aborting anything it is doing.
      * note no sync success or failure would be called.
@@ -955,6 +980,17 @@ protected:
     timesync_t mUnadjTimestampLastSent_usec;
     //@}
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    //@{
+    /// communication contexts for concurrent sync, indexed the same way as mContacts
+    bool mIsConcurrentSyncEnabled;
+    uint8_t mConcurrentSyncQuorum;
+    uint8_t mNumConcurrentResponses;
+    ExchangeContext * mConcurrentExchangeContexts[WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS];
+    timesync_t mConcurrentTimestampLastSent_usec[WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS];
+    //@}
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
 #if WEAVE_CONFIG_TIME_CLIENT_FABRIC_LOCAL_DISCOVERY
     int8_t mLastLikelihoodSent;
 #endif // WEAVE_CONFIG_TIME_CLIENT_FABRIC_LOCAL_DISCOVERY
@@ -1031,7 +1067,9 @@ protected:
 #endif // WEAVE_CONFIG_TIME_CLIENT_FABRIC_LOCAL_DISCOVERY
 
     /// process a response coming back from a unicast request
-    void UpdateUnicastSyncResponse(const TimeSyncResponse & aResponse);
+    /// aUnadjTimestampSent_usec is the unadjusted timestamp at which the request was sent to aContact
+    void UpdateUnicastSyncResponse(Contact * const aContact, const timesync_t aUnadjTimestampSent_usec,
+        const TimeSyncResponse & aResponse);
 
     // wrap up a local sync and calculate the correction
     void EndLocalSyncAndTryCalculateTimeFix(void);
@@ -1057,6 +1095,26 @@ protected:
     /// close the Weave ExchangeContext
     bool DestroyCommContext(void);
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    /// close all exchange contexts used by concurrent sync.
+    /// returns true if any of them was still open
+    bool DestroyConcurrentCommContexts(void);
+
+    /// send sync requests to all idle contacts at once.
+    /// *rNumMessageSent will be set to the number of requests that are waiting for a response or timeout.
+    WEAVE_ERROR SendConcurrentSyncRequests(int16_t * const rNumMessageSent);
+
+    /// send one sync request on the concurrent exchange context of contact aIndex.
+    /// communication errors are handled the same way as in SendSyncRequest
+    WEAVE_ERROR SendConcurrentSyncRequest(bool * const rIsMessageSent, const int aIndex);
+
+    /// return the index of the contact using exchange context ec, or -1 if there is none
+    int FindConcurrentContact(const ExchangeContext * const ec) const;
+
+    /// decide if the current concurrent round is over, and move on to the next state if so
+    void ContinueConcurrentSync(const ClientState aClientStateAtEntry);
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
     /// create new Weave Exchange for unicast communication
     WEAVE_ERROR SetupUnicastCommContext(Contact * const aContact);
 
@@ -1103,6 +1161,12 @@ protected:
 
     static void HandleUnicastResponseTimeout(ExchangeContext * const ec);
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    static void HandleConcurrentSyncResponse(ExchangeContext *ec, const IPPacketInfo *pktInfo,
+        const WeaveMessageInfo *msgInfo, uint32_t profileId, uint8_t msgType, PacketBuffer *payload);
+    static void HandleConcurrentResponseTimeout(ExchangeContext * const ec);
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
     static void HandleAutoSyncTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError);
 
 #endif // WEAVE_CONFIG_TIME_ENABLE_CLIENT
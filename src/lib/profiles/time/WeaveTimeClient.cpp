@@ -121,6 +121,17 @@ WEAVE_ERROR TimeSyncNode::_InitClient(const uint8_t aEncryptionType,
     mExchageContext = NULL;
     mUnadjTimestampLastSent_usec = 0;
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    mIsConcurrentSyncEnabled = false;
+    mConcurrentSyncQuorum = WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC_QUORUM;
+    mNumConcurrentResponses = 0;
+    for (int i = 0; i < WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS; ++i)
+    {
+        mConcurrentExchangeContexts[i] = NULL;
+        mConcurrentTimestampLastSent_usec[i] = TIMESYNC_INVALID;
+    }
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
 exit:
     WeaveLogFunctError(err);
     SetClientState((WEAVE_NO_ERROR == err) ? kClientState_Idle : kClientState_InitializationFailed);
@@ -444,9 +455,224 @@ bool TimeSyncNode::DestroyCommContext(void)
     mActiveContact = NULL;
     mUnadjTimestampLastSent_usec = TIMESYNC_INVALID;
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    if (DestroyConcurrentCommContexts())
+    {
+        HaveToClose = true;
+    }
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
     return HaveToClose;
 }
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+bool TimeSyncNode::DestroyConcurrentCommContexts(void)
+{
+    bool HaveToClose = false;
+
+    for (int i = 0; i < WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS; ++i)
+    {
+        if (NULL != mConcurrentExchangeContexts[i])
+        {
+            mConcurrentExchangeContexts[i]->Close();
+            mConcurrentExchangeContexts[i] = NULL;
+            HaveToClose = true;
+        }
+        mConcurrentTimestampLastSent_usec[i] = TIMESYNC_INVALID;
+    }
+
+    return HaveToClose;
+}
+
+int TimeSyncNode::FindConcurrentContact(const ExchangeContext * const ec) const
+{
+    int rIndex = -1;
+
+    for (int i = 0; i < WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS; ++i)
+    {
+        if ((NULL != ec) && (ec == mConcurrentExchangeContexts[i]))
+        {
+            rIndex = i;
+            break;
+        }
+    }
+
+    return rIndex;
+}
+
+WEAVE_ERROR TimeSyncNode::SendConcurrentSyncRequest(bool * const rIsMessageSent, const int aIndex)
+{
+    WEAVE_ERROR         err         = WEAVE_NO_ERROR;
+    TimeSyncRequest     request;
+    PacketBuffer*       msgBuf      = NULL;
+    Contact * const     contact     = &mContacts[aIndex];
+    ExchangeContext *   ec          = NULL;
+
+    *rIsMessageSent = false;
+
+    // we're sending request to this node
+    contact->mCommState = uint8_t(kCommState_Active);
+
+    // allocate buffer and then encode the response into it
+    msgBuf = PacketBuffer::NewWithAvailableSize(TimeSyncRequest::kPayloadLen);
+    if (NULL == msgBuf)
+    {
+        ExitNow(err = WEAVE_ERROR_NO_MEMORY);
+    }
+
+    // encode request into the buffer
+    // since this is unicast, we're using the maximum likelihood here
+    request.Init(TimeSyncRequest::kLikelihoodForResponse_Max, (kTimeSyncRole_Coordinator == mRole) ? true : false);
+
+    err = request.Encode(msgBuf);
+    SuccessOrExit(err);
+
+    // each contact gets its own exchange context, and hence its own response timeout
+    ec = GetExchangeMgr()->NewContext(contact->mNodeId, contact->mNodeAddr, this);
+    if (NULL == ec)
+    {
+        ExitNow(err = WEAVE_ERROR_NO_MEMORY);
+    }
+    mConcurrentExchangeContexts[aIndex] = ec;
+
+    // Configure the encryption and key used to send the request
+    ec->EncryptionType = mEncryptionType;
+    ec->KeyId = mKeyId;
+
+    ec->OnMessageReceived = HandleConcurrentSyncResponse;
+
+    ec->ResponseTimeout = WEAVE_CONFIG_TIME_CLIENT_TIMER_UNICAST_MSEC;
+    ec->OnResponseTimeout = HandleConcurrentResponseTimeout;
+
+    // acquire unadjusted timestamp
+    err = Platform::Time::GetMonotonicRawTime(&mConcurrentTimestampLastSent_usec[aIndex]);
+    SuccessOrExit(err);
+
+    // send out the request
+    err = ec->SendMessage(kWeaveProfile_Time, kTimeMessageType_TimeSyncRequest, msgBuf,
+        ExchangeContext::kSendFlag_ExpectResponse);
+    msgBuf = NULL;
+    if (WEAVE_NO_ERROR == err)
+    {
+        // if nothing goes wrong, we should see either a response message or a timeout event
+        *rIsMessageSent = true;
+    }
+    else
+    {
+        // same as the sequential case, failing to reach one node is not fatal to the round
+        WeaveLogFunctError(err);
+        err = WEAVE_NO_ERROR;
+        RegisterCommError(contact);
+        ec->Close();
+        mConcurrentExchangeContexts[aIndex] = NULL;
+    }
+
+exit:
+    WeaveLogFunctError(err);
+
+    if (NULL != msgBuf)
+    {
+        PacketBuffer::Free(msgBuf);
+    }
+
+    if (WEAVE_NO_ERROR != err)
+    {
+        // marking this contact as invalid is weird, but we're just trying to avoid any problem next time
+        contact->mCommState = uint8_t(kCommState_Invalid);
+
+        if (NULL != mConcurrentExchangeContexts[aIndex])
+        {
+            mConcurrentExchangeContexts[aIndex]->Close();
+            mConcurrentExchangeContexts[aIndex] = NULL;
+        }
+    }
+
+    return err;
+}
+
+WEAVE_ERROR TimeSyncNode::SendConcurrentSyncRequests(int16_t * const rNumMessageSent)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    bool isMessageSent = false;
+
+    *rNumMessageSent = 0;
+    mNumConcurrentResponses = 0;
+
+    for (int i = 0; i < WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS; ++i)
+    {
+        if (uint8_t(kCommState_Idle) != mContacts[i].mCommState)
+        {
+            continue;
+        }
+
+        err = SendConcurrentSyncRequest(&isMessageSent, i);
+        SuccessOrExit(err);
+
+        if (isMessageSent)
+        {
+            ++(*rNumMessageSent);
+        }
+    }
+
+    WEAVE_TIME_PROGRESS_LOG(TimeService, "Concurrent sync requests sent to %d contact(s)", int(*rNumMessageSent));
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+void TimeSyncNode::ContinueConcurrentSync(const ClientState aClientStateAtEntry)
+{
+    bool isRoundOver = true;
+
+    if ((0 != mConcurrentSyncQuorum) && (mNumConcurrentResponses >= mConcurrentSyncQuorum))
+    {
+        // we have heard from enough nodes. abandon the rest for this round, without counting it
+        // against them, and keep whatever they told us in previous rounds
+        for (int i = 0; i < WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS; ++i)
+        {
+            if (NULL != mConcurrentExchangeContexts[i])
+            {
+                mConcurrentExchangeContexts[i]->Close();
+                mConcurrentExchangeContexts[i] = NULL;
+                mContacts[i].mCommState = uint8_t(kCommState_Completed);
+            }
+        }
+
+        WEAVE_TIME_PROGRESS_LOG(TimeService, "Concurrent sync quorum of %d reached", int(mConcurrentSyncQuorum));
+    }
+    else
+    {
+        for (int i = 0; i < WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS; ++i)
+        {
+            if (NULL != mConcurrentExchangeContexts[i])
+            {
+                // keep waiting for a response or timeout from this contact
+                isRoundOver = false;
+                break;
+            }
+        }
+    }
+
+    if (!isRoundOver)
+    {
+        // do nothing
+    }
+    else if (kClientState_Sync_1 == aClientStateAtEntry)
+    {
+        // Sync_1 => Sync_2
+        SetAllCompletedContactsToIdle();
+        EnterState_Sync_2();
+    }
+    else
+    {
+        // we have no more nodes to contact, try to calculate a time fix
+        EndLocalSyncAndTryCalculateTimeFix();
+    }
+}
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
 WEAVE_ERROR TimeSyncNode::SyncWithNodes(const int16_t aNumNode, const ServingNode aNodes[])
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -750,6 +976,25 @@ void TimeSyncNode::EnterState_Sync_1(void)
         ExitNow(err = WEAVE_ERROR_INCORRECT_STATE);
     }
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    if (mIsConcurrentSyncEnabled)
+    {
+        int16_t numMessageSent;
+
+        err = SendConcurrentSyncRequests(&numMessageSent);
+        SuccessOrExit(err);
+
+        if (0 == numMessageSent)
+        {
+            // no one to wait for, move to Sync_2 anyways
+            SetAllCompletedContactsToIdle();
+            EnterState_Sync_2();
+        }
+
+        ExitNow();
+    }
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
     do
     {
         contact = GetNextIdleContact();
@@ -797,6 +1042,24 @@ void TimeSyncNode::EnterState_Sync_2(void)
         ExitNow(err = WEAVE_ERROR_INCORRECT_STATE);
     }
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    if (mIsConcurrentSyncEnabled)
+    {
+        int16_t numMessageSent;
+
+        err = SendConcurrentSyncRequests(&numMessageSent);
+        SuccessOrExit(err);
+
+        if (0 == numMessageSent)
+        {
+            // no one to wait for, try to calculate a time fix or fail
+            EndLocalSyncAndTryCalculateTimeFix();
+        }
+
+        ExitNow();
+    }
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
     do
     {
         // try to get the next contact to reach
@@ -1153,7 +1416,7 @@ void TimeSyncNode::UpdateMulticastSyncResponse(const uint64_t aNodeId,
     mActiveContact->mNodeAddr = aNodeAddr;
     mActiveContact->mResponseStatus = uint8_t(kResponseStatus_Invalid);
     // update the contact with response, reusing the unicast code
-    UpdateUnicastSyncResponse(aResponse);
+    UpdateUnicastSyncResponse(mActiveContact, mUnadjTimestampLastSent_usec, aResponse);
 
 exit:
     WeaveLogFunctError(err);
@@ -1165,7 +1428,8 @@ exit:
 }
 #endif // WEAVE_CONFIG_TIME_CLIENT_FABRIC_LOCAL_DISCOVERY
 
-void TimeSyncNode::UpdateUnicastSyncResponse(const TimeSyncResponse & aResponse)
+void TimeSyncNode::UpdateUnicastSyncResponse(Contact * const aContact, const timesync_t aUnadjTimestampSent_usec,
+    const TimeSyncResponse & aResponse)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
 
@@ -1177,7 +1441,7 @@ void TimeSyncNode::UpdateUnicastSyncResponse(const TimeSyncResponse & aResponse)
     SuccessOrExit(err);
 
     {
-        const timesync_t rtt64_usec = timestamp_now_usec - mUnadjTimestampLastSent_usec;
+        const timesync_t rtt64_usec = timestamp_now_usec - aUnadjTimestampSent_usec;
         if (rtt64_usec < INT32_MAX)
         {
             rtt_usec = int32_t(rtt64_usec);
@@ -1191,15 +1455,15 @@ void TimeSyncNode::UpdateUnicastSyncResponse(const TimeSyncResponse & aResponse)
 
 #if WEAVE_CONFIG_TIME_CLIENT_FABRIC_LOCAL_DISCOVERY
     // we have received a response from it, so a time change notification is 'normal' contact now
-    mActiveContact->mIsTimeChangeNotification = false;
+    aContact->mIsTimeChangeNotification = false;
 #endif // WEAVE_CONFIG_TIME_CLIENT_FABRIC_LOCAL_DISCOVERY
 
-    if (uint8_t(kCommState_Active) != mActiveContact->mCommState)
+    if (uint8_t(kCommState_Active) != aContact->mCommState)
     {
         ExitNow(err = WEAVE_ERROR_INCORRECT_STATE);
     }
 
-    if (uint8_t(kResponseStatus_Invalid) == mActiveContact->mResponseStatus)
+    if (uint8_t(kResponseStatus_Invalid) == aContact->mResponseStatus)
     {
         // this is the first response we receive from this node
         // Preserve all data, but mark response status to reflect the qualification
@@ -1211,35 +1475,35 @@ void TimeSyncNode::UpdateUnicastSyncResponse(const TimeSyncResponse & aResponse)
             // or
             // the timestamp of the responding node is so low that we cannot compensate for flight time
             // this is not right, as the epoch is 1970/1/1, and no one should have that low timestamp
-            mActiveContact->mResponseStatus = uint8_t(kResponseStatus_UnusableResponse);
+            aContact->mResponseStatus = uint8_t(kResponseStatus_UnusableResponse);
         }
         else if (aResponse.mTimeSinceLastSyncWithServer_min
             > WEAVE_CONFIG_TIME_CLIENT_REASONABLE_TIME_SINCE_LAST_SYNC_MIN)
         {
-            mActiveContact->mResponseStatus = uint8_t(kResponseStatus_LessReliableResponse);
+            aContact->mResponseStatus = uint8_t(kResponseStatus_LessReliableResponse);
         }
         else
         {
-            mActiveContact->mResponseStatus = uint8_t(kResponseStatus_ReliableResponse);
+            aContact->mResponseStatus = uint8_t(kResponseStatus_ReliableResponse);
         }
 
-        mActiveContact->mRemoteTimestamp_usec = aResponse.mTimeOfResponse;
-        mActiveContact->mRole = uint8_t((aResponse.mIsTimeCoordinator) ? kTimeSyncRole_Coordinator : kTimeSyncRole_Server);
-        mActiveContact->mFlightTime_usec = rtt_usec / 2;
-        mActiveContact->mNumberOfContactUsedInLastLocalSync = aResponse.mNumContributorInLastLocalSync;
-        mActiveContact->mTimeSinceLastSuccessfulSync_min = aResponse.mTimeSinceLastSyncWithServer_min;
-        mActiveContact->mUnadjTimestampLastContact_usec = timestamp_now_usec;
+        aContact->mRemoteTimestamp_usec = aResponse.mTimeOfResponse;
+        aContact->mRole = uint8_t((aResponse.mIsTimeCoordinator) ? kTimeSyncRole_Coordinator : kTimeSyncRole_Server);
+        aContact->mFlightTime_usec = rtt_usec / 2;
+        aContact->mNumberOfContactUsedInLastLocalSync = aResponse.mNumContributorInLastLocalSync;
+        aContact->mTimeSinceLastSuccessfulSync_min = aResponse.mTimeSinceLastSyncWithServer_min;
+        aContact->mUnadjTimestampLastContact_usec = timestamp_now_usec;
 
         // state moved to completed
-        mActiveContact->mCommState = uint8_t(kCommState_Completed);
+        aContact->mCommState = uint8_t(kCommState_Completed);
 
         WeaveLogDetail(TimeService,
             "Received 1st response from node %" PRIX64 ", with RTT/2 %d usec",
-            mActiveContact->mNodeId, mActiveContact->mFlightTime_usec);
+            aContact->mNodeId, aContact->mFlightTime_usec);
 
-        WeaveLogDetail(TimeService, "Role:%d, #Error:%d, #Contributor:%d, LastSync:%d", mActiveContact->mRole,
-            mActiveContact->mCountCommError, mActiveContact->mNumberOfContactUsedInLastLocalSync,
-            mActiveContact->mTimeSinceLastSuccessfulSync_min);
+        WeaveLogDetail(TimeService, "Role:%d, #Error:%d, #Contributor:%d, LastSync:%d", aContact->mRole,
+            aContact->mCountCommError, aContact->mNumberOfContactUsedInLastLocalSync,
+            aContact->mTimeSinceLastSuccessfulSync_min);
     }
     else
     {
@@ -1256,8 +1520,8 @@ void TimeSyncNode::UpdateUnicastSyncResponse(const TimeSyncResponse & aResponse)
 
             // do nothing, keep the previous result
         }
-        else if ((aResponse.mTimeSinceLastSyncWithServer_min >= mActiveContact->mTimeSinceLastSuccessfulSync_min)
-            && ((rtt_usec / 2) > mActiveContact->mFlightTime_usec))
+        else if ((aResponse.mTimeSinceLastSyncWithServer_min >= aContact->mTimeSinceLastSuccessfulSync_min)
+            && ((rtt_usec / 2) > aContact->mFlightTime_usec))
         {
             // the second response is not based on some newer sync, and the flight time is longer
             // note we probably should use 'age' respective to each response here, but the 2 responses
@@ -1271,34 +1535,34 @@ void TimeSyncNode::UpdateUnicastSyncResponse(const TimeSyncResponse & aResponse)
             if (aResponse.mTimeSinceLastSyncWithServer_min
                 > WEAVE_CONFIG_TIME_CLIENT_REASONABLE_TIME_SINCE_LAST_SYNC_MIN)
             {
-                mActiveContact->mResponseStatus = uint8_t(kResponseStatus_LessReliableResponse);
+                aContact->mResponseStatus = uint8_t(kResponseStatus_LessReliableResponse);
             }
             else
             {
                 // set it to be a reliable response
-                mActiveContact->mResponseStatus = uint8_t(kResponseStatus_ReliableResponse);
+                aContact->mResponseStatus = uint8_t(kResponseStatus_ReliableResponse);
             }
 
             // all response related data is updated to match with the current round
 
-            mActiveContact->mRemoteTimestamp_usec = aResponse.mTimeOfResponse;
-            mActiveContact->mRole = uint8_t((aResponse.mIsTimeCoordinator) ? kTimeSyncRole_Coordinator : kTimeSyncRole_Server);
-            mActiveContact->mFlightTime_usec = rtt_usec / 2;
-            mActiveContact->mNumberOfContactUsedInLastLocalSync = aResponse.mNumContributorInLastLocalSync;
-            mActiveContact->mTimeSinceLastSuccessfulSync_min = aResponse.mTimeSinceLastSyncWithServer_min;
-            mActiveContact->mUnadjTimestampLastContact_usec = timestamp_now_usec;
+            aContact->mRemoteTimestamp_usec = aResponse.mTimeOfResponse;
+            aContact->mRole = uint8_t((aResponse.mIsTimeCoordinator) ? kTimeSyncRole_Coordinator : kTimeSyncRole_Server);
+            aContact->mFlightTime_usec = rtt_usec / 2;
+            aContact->mNumberOfContactUsedInLastLocalSync = aResponse.mNumContributorInLastLocalSync;
+            aContact->mTimeSinceLastSuccessfulSync_min = aResponse.mTimeSinceLastSyncWithServer_min;
+            aContact->mUnadjTimestampLastContact_usec = timestamp_now_usec;
         }
 
         // state moved to completed
-        mActiveContact->mCommState = uint8_t(kCommState_Completed);
+        aContact->mCommState = uint8_t(kCommState_Completed);
 
         WeaveLogDetail(TimeService,
             "Received 2nd round from node %" PRIX64 ", with RTT/2 %d usec",
-            mActiveContact->mNodeId, mActiveContact->mFlightTime_usec);
+            aContact->mNodeId, aContact->mFlightTime_usec);
 
-        WeaveLogDetail(TimeService, "Role:%d, #Error:%d, #Contributor:%d, LastSync:%d", mActiveContact->mRole,
-            mActiveContact->mCountCommError, mActiveContact->mNumberOfContactUsedInLastLocalSync,
-            mActiveContact->mTimeSinceLastSuccessfulSync_min);
+        WeaveLogDetail(TimeService, "Role:%d, #Error:%d, #Contributor:%d, LastSync:%d", aContact->mRole,
+            aContact->mCountCommError, aContact->mNumberOfContactUsedInLastLocalSync,
+            aContact->mTimeSinceLastSuccessfulSync_min);
     }
 
 exit:
@@ -1764,7 +2028,7 @@ void TimeSyncNode::HandleUnicastSyncResponse(ExchangeContext *ec, const IPPacket
 
         // now we believe we have received a response from the node we intend to hear from
         // update the record now
-        client->UpdateUnicastSyncResponse(response);
+        client->UpdateUnicastSyncResponse(client->mActiveContact, client->mUnadjTimestampLastSent_usec, response);
 
         // Close this exchange context
         // note we need to close it before we enter any of Sync_1 or Sync_2 states,
@@ -1816,7 +2080,7 @@ void TimeSyncNode::HandleUnicastSyncResponse(ExchangeContext *ec, const IPPacket
 
         // now we believe we have received a response from the node we intend to hear from
         // update the record now
-        client->UpdateUnicastSyncResponse(response);
+        client->UpdateUnicastSyncResponse(client->mActiveContact, client->mUnadjTimestampLastSent_usec, response);
 
         // Close this exchange context
         // note we need to close it before we enter any other states,
@@ -2162,6 +2426,146 @@ void TimeSyncNode::HandleUnicastResponseTimeout(ExchangeContext * const ec)
     return;
 }
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+void TimeSyncNode::HandleConcurrentSyncResponse(ExchangeContext *ec, const IPPacketInfo *pktInfo,
+    const WeaveMessageInfo *msgInfo,
+    uint32_t profileId, uint8_t msgType, PacketBuffer *payload)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    TimeSyncNode * const client = reinterpret_cast<TimeSyncNode *>(ec->AppState);
+    TimeSyncResponse response;
+    const TimeSyncNode::ClientState ClientStateAtEntry(client->GetClientState());
+    const int index = client->FindConcurrentContact(ec);
+    Contact * contact;
+
+    if ((kClientState_Sync_1 != ClientStateAtEntry) && (kClientState_Sync_2 != ClientStateAtEntry))
+    {
+        err = WEAVE_ERROR_INCORRECT_STATE;
+        client->DestroyCommContext();
+        client->AbortOnError(err);
+        ExitNow();
+    }
+
+    if (index < 0)
+    {
+        // this context is not one of ours any more
+        ExitNow(err = WEAVE_ERROR_INCORRECT_STATE);
+    }
+
+    if (kTimeMessageType_TimeSyncResponse != msgType)
+    {
+        ExitNow(err = WEAVE_ERROR_INVALID_MESSAGE_TYPE);
+    }
+
+    err = TimeSyncResponse::Decode(&response, payload);
+    SuccessOrExit(err);
+
+    // Verify the response was received via an authenticated session
+    // note that under this error, we just throw the whole message away, so communication with
+    // this node will be treated as timeout
+    if ((ec->KeyId != client->mKeyId) || (ec->EncryptionType != client->mEncryptionType))
+    {
+        ExitNow(err = WEAVE_ERROR_UNSUPPORTED_AUTH_MODE);
+    }
+
+    contact = &client->mContacts[index];
+    client->UpdateUnicastSyncResponse(contact, client->mConcurrentTimestampLastSent_usec[index], response);
+
+    if ((uint8_t(kResponseStatus_ReliableResponse) == contact->mResponseStatus)
+        || (uint8_t(kResponseStatus_LessReliableResponse) == contact->mResponseStatus))
+    {
+        ++client->mNumConcurrentResponses;
+    }
+
+    // Close this exchange context only. Others might still be waiting for their responses
+    client->mConcurrentExchangeContexts[index] = NULL;
+    ec->Close();
+    ec = NULL;
+
+    client->ContinueConcurrentSync(ClientStateAtEntry);
+
+exit:
+    // note we have to be very careful about what we do at here
+    // as the state of 'client' might have changed due to transition
+    WeaveLogFunctError(err);
+    if (NULL != payload)
+    {
+        PacketBuffer::Free(payload);
+    }
+}
+
+void TimeSyncNode::HandleConcurrentResponseTimeout(ExchangeContext * const ec)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    TimeSyncNode * const client = reinterpret_cast<TimeSyncNode *>(ec->AppState);
+    const TimeSyncNode::ClientState ClientStateAtEntry(client->GetClientState());
+    const int index = client->FindConcurrentContact(ec);
+
+    WeaveLogDetail(TimeService, "Concurrent unicast just timed out at client state: %d (%s)", client->GetClientState(),
+        client->GetClientStateName());
+
+    if (((kClientState_Sync_1 != ClientStateAtEntry) && (kClientState_Sync_2 != ClientStateAtEntry)) || (index < 0))
+    {
+        err = WEAVE_ERROR_INCORRECT_STATE;
+        ec->Close();
+        client->AbortOnError(err);
+        ExitNow();
+    }
+
+    // close this context as timeout
+    client->mConcurrentExchangeContexts[index] = NULL;
+    ec->Close();
+
+    // register communication error
+    // note we don't invalidated the contact easily
+    client->RegisterCommError(&client->mContacts[index]);
+
+    client->ContinueConcurrentSync(ClientStateAtEntry);
+
+exit:
+    // Note that we have to be careful what to do at here, as
+    // the state of 'client' might have been changed in those state transitions
+    WeaveLogFunctError(err);
+
+    return;
+}
+
+WEAVE_ERROR TimeSyncNode::EnableConcurrentSync(const uint8_t aQuorum)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    if (mIsInCallback)
+    {
+        ExitNow(err = WEAVE_ERROR_INCORRECT_STATE);
+    }
+
+    if (kClientState_Idle != GetClientState())
+    {
+        ExitNow(err = WEAVE_ERROR_INCORRECT_STATE);
+    }
+
+    if (aQuorum > WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS)
+    {
+        ExitNow(err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+
+    mIsConcurrentSyncEnabled = true;
+    mConcurrentSyncQuorum = aQuorum;
+
+exit:
+    WeaveLogFunctError(err);
+
+    return err;
+}
+
+void TimeSyncNode::DisableConcurrentSync(void)
+{
+    mIsConcurrentSyncEnabled = false;
+}
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
 void TimeSyncNode::DisableAutoSync(void)
 {
     GetExchangeMgr()->MessageLayer->SystemLayer->CancelTimer(HandleAutoSyncTimeout, this);
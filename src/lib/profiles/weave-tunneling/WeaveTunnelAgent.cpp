@@ -68,8 +68,8 @@ WeaveTunnelAgent::WeaveTunnelAgent()
 #endif
 
     mPeerNodeId               = 0;
-    qFront                    = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
-    qRear                     = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
+    mCurrentClass             = kTrafficClass_High;
+    mNumCoalescedPackets      = 0;
     mTunAgentState            = kState_NotInitialized;
     mPeerNodeId               = kNodeIdNotSpecified;
     mServiceAddress           = IPAddress::Any;
@@ -171,7 +171,8 @@ WEAVE_ERROR WeaveTunnelAgent::ConfigureAndInit (InetLayer *inet, WeaveExchangeMa
     mRole                    = role;
     mAuthMode                = authMode;
     mAppContext              = appContext;
-    memset(queuedMsgs, 0, sizeof(queuedMsgs));
+    memset(mClassQueues, 0, sizeof(mClassQueues));
+    mCurrentClass            = kTrafficClass_High;
 #if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
     memset(&mWeaveTunnelStats, 0, sizeof(mWeaveTunnelStats));
 #endif
@@ -228,6 +229,8 @@ WEAVE_ERROR WeaveTunnelAgent::ConfigureAndInit (InetLayer *inet, WeaveExchangeMa
     // Register Recv function for TunEndPoint
 
     mTunEP->OnPacketReceived = RecvdFromTunnelEndPoint;
+    mTunEP->OnReceiveBatchComplete = RecvdBatchCompleteFromTunnelEndPoint;
+    mNumCoalescedPackets = 0;
 
     // Set the TunEndPoint appState to the WeaveTunnelAgent.
 
@@ -878,6 +881,22 @@ exit:
     return;
 }
 
+/**
+ * Handler invoked by the Tunnel EndPoint once it has delivered a batch of IPv6 packets through
+ * RecvdFromTunnelEndPoint. Any encapsulated packets that were coalesced on the tunnel connection
+ * while the batch was in progress are sent to the Service.
+ *
+ * @param[in] tunEP                        A pointer to the TunEndPoint object.
+ *
+ * @return void
+ */
+void WeaveTunnelAgent::RecvdBatchCompleteFromTunnelEndPoint(TunEndPoint *tunEP)
+{
+    WeaveTunnelAgent *tAgent    = static_cast<WeaveTunnelAgent *>(tunEP->AppState);
+
+    tAgent->PushCoalescedPackets();
+}
+
 /**
  * Handler to receive tunneled IPv6 packets from the Service TCP connection and forward to the Tunnel
  * EndPoint interface after decapsulating the raw IPv6 packet from inside the tunnel header.
@@ -1045,7 +1064,8 @@ WEAVE_ERROR WeaveTunnelAgent::SendMessageUponPktTransitAnalysis(const WeaveTunne
                                                                 TunnelType tunType,
                                                                 WeaveMessageInfo *msgInfo,
                                                                 PacketBuffer *msg,
-                                                                bool &dropPacket)
+                                                                bool &dropPacket,
+                                                                bool push)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     uint32_t msgLen = 0;
@@ -1061,7 +1081,7 @@ WEAVE_ERROR WeaveTunnelAgent::SendMessageUponPktTransitAnalysis(const WeaveTunne
     if (!dropPacket)
     {
         msgLen = msg->DataLength();
-        err = connMgr->mServiceCon->SendTunneledMessage(msgInfo, msg);
+        err = connMgr->mServiceCon->SendTunneledMessage(msgInfo, msg, push);
         SuccessOrExit(err);
 #if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
         UpdateOutboundMessageStatistics(connMgr->mTunType, msgLen);
@@ -1084,66 +1104,36 @@ exit:
 WEAVE_ERROR WeaveTunnelAgent::HandleSendingToService(PacketBuffer *msg)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    bool dropPacket = false;
+    const WeaveTunnelConnectionMgr *connMgr = NULL;
 
-    if (mPrimaryTunConnMgr.mConnectionState != WeaveTunnelConnectionMgr::kState_TunnelOpen
-#if WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
-        && mBackupTunConnMgr.mConnectionState != WeaveTunnelConnectionMgr::kState_TunnelOpen
-#endif // WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
-       )
-    {
-        // Enqueue message until Service tunnel established
+    // All outbound traffic passes through the per-class queues so that it is
+    // scheduled according to its priority and the connection's backlog.
 
-        WeaveLogDetail(WeaveTunnel, "Tunnel connection not up: Enqueuing message\n");
-        err = EnQueuePacket(msg);
+    err = EnQueuePacket(msg);
+    if (err != WEAVE_NO_ERROR)
+    {
+        PacketBuffer::Free(msg);
 
-        if (err == WEAVE_NO_ERROR)
-        {
-            msg = NULL;
-        }
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+        // Update tunnel statistics
+        mWeaveTunnelStats.mDroppedMessagesCount++;
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
 
         ExitNow();
     }
 
-    // Send on primary tunnel if open; else send over backup tunnel
-
-    if (mPrimaryTunConnMgr.mConnectionState == WeaveTunnelConnectionMgr::kState_TunnelOpen)
+    connMgr = GetActiveTunnelConnMgr();
+    if (connMgr == NULL)
     {
-        WeaveMessageInfo msgInfo;
-
-        PopulateTunnelMsgHeader(&msgInfo, &mPrimaryTunConnMgr);
+        // Hold message until Service tunnel established
 
-        err = SendMessageUponPktTransitAnalysis(&mPrimaryTunConnMgr, kDir_Outbound, kType_TunnelPrimary,
-                                                &msgInfo, msg, dropPacket);
-    }
-#if WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
-    else if (mBackupTunConnMgr.mConnectionState == WeaveTunnelConnectionMgr::kState_TunnelOpen)
-    {
-        WeaveMessageInfo msgInfo;
-
-        PopulateTunnelMsgHeader(&msgInfo, &mBackupTunConnMgr);
-
-        err = SendMessageUponPktTransitAnalysis(&mBackupTunConnMgr, kDir_Outbound, kType_TunnelBackup,
-                                                &msgInfo, msg, dropPacket);
+        WeaveLogDetail(WeaveTunnel, "Tunnel connection not up: Enqueuing message\n");
+        ExitNow();
     }
-#endif // WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
 
-    if (!dropPacket)
-    {
-        msg = NULL;
-    }
+    SendQueuedMessages(connMgr, true);
 
 exit:
-    if (msg != NULL || dropPacket)
-    {
-        PacketBuffer::Free(msg);
-
-#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
-        // Update tunnel statistics
-        mWeaveTunnelStats.mDroppedMessagesCount++;
-#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
-    }
-
     return err;
 }
 
@@ -1329,27 +1319,82 @@ void WeaveTunnelAgent::UpdateTunnelDownStatistics(const TunnelType tunType, cons
 }
 #endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
 
-/* Queue packet for Remote tunnel connection to get established */
+/* Map an encapsulated IPv6 packet to an outbound traffic class based on the
+ * DSCP bits of its Traffic Class field */
+TunnelTrafficClass WeaveTunnelAgent::ClassifyPacket(const PacketBuffer &pkt)
+{
+    enum
+    {
+        kDSCP_LowerEffort       = 1,  // LE (RFC 8622)
+        kDSCP_BulkMin           = 8,  // CS1
+        kDSCP_BulkMax           = 15, // AF1x
+        kDSCP_HighPriorityMin   = 40  // CS5 and above, including EF
+    };
+
+    TunnelTrafficClass trafficClass = kTrafficClass_Normal;
+    const uint8_t *p = pkt.Start() + TUN_HDR_SIZE_IN_BYTES;
+    uint8_t dscp;
+
+    VerifyOrExit(pkt.DataLength() >= TUN_HDR_SIZE_IN_BYTES + 2, /* no-op */);
+
+    // The 8-bit Traffic Class straddles the first two bytes of the IPv6 header,
+    // right after the 4-bit version; the DSCP is its upper 6 bits.
+
+    dscp = static_cast<uint8_t>(((p[0] & 0x0F) << 2) | (p[1] >> 6));
+
+    if (dscp >= kDSCP_HighPriorityMin)
+    {
+        trafficClass = kTrafficClass_High;
+    }
+    else if (dscp == kDSCP_LowerEffort || (dscp >= kDSCP_BulkMin && dscp <= kDSCP_BulkMax))
+    {
+        trafficClass = kTrafficClass_Bulk;
+    }
+
+exit:
+    return trafficClass;
+}
+
+/* Queue packet for Remote tunnel connection to get established or to drain */
 WEAVE_ERROR WeaveTunnelAgent::EnQueuePacket(PacketBuffer *pkt)
 {
+    static const uint32_t sClassQueueBytes[kTrafficClass_Max] =
+    {
+        WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUEUE_BYTES,
+        WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUEUE_BYTES,
+        WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUEUE_BYTES
+    };
+
     WEAVE_ERROR err = WEAVE_NO_ERROR;
+    TunnelTrafficClass trafficClass = ClassifyPacket(*pkt);
+    TrafficClassQueue &queue = mClassQueues[trafficClass];
+    uint16_t pktLen = pkt->DataLength();
 
-    if ((qFront == qRear + 1) || (qFront == 0 && qRear == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED - 1))
+    if (queue.mCount == WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED ||
+        (queue.mCount != 0 && queue.mBytes + pktLen > sClassQueueBytes[trafficClass]))
     {
-        // Queue full;
+        // Queue full; an empty queue always admits one packet so that a
+        // maximally-sized packet is never starved by a small byte budget.
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+        mWeaveTunnelStats.mTrafficClassStats[trafficClass].mDroppedMessages++;
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
 
         err = WEAVE_ERROR_TUNNEL_SERVICE_QUEUE_FULL;
         ExitNow();
     }
-    else
+
+    queue.mPkts[(queue.mHead + queue.mCount) % WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED] = pkt;
+    queue.mCount++;
+    queue.mBytes += pktLen;
+
+#if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
+    mWeaveTunnelStats.mTrafficClassStats[trafficClass].mQueuedMessages++;
+    if (queue.mBytes > mWeaveTunnelStats.mTrafficClassStats[trafficClass].mQueuedBytesHighWatermark)
     {
-        if (qFront == TUNNEL_PACKET_QUEUE_INVALID_INDEX)
-        {
-            qFront = 0;
-        }
-        qRear = (qRear + 1) % WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED;
-        queuedMsgs[qRear] = pkt;
+        mWeaveTunnelStats.mTrafficClassStats[trafficClass].mQueuedBytesHighWatermark = queue.mBytes;
     }
+#endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
 
 exit:
 
@@ -1360,64 +1405,220 @@ void WeaveTunnelAgent::DumpQueuedMessages(void)
 {
     PacketBuffer *queuedPkt = NULL;
 
-    while (qFront != TUNNEL_PACKET_QUEUE_INVALID_INDEX)
+    for (uint8_t i = 0; i < kTrafficClass_Max; i++)
     {
-        queuedPkt = DeQueuePacket();
-        if (queuedPkt)
+        while ((queuedPkt = DeQueuePacket(static_cast<TunnelTrafficClass>(i))) != NULL)
         {
             PacketBuffer::Free(queuedPkt);
 
 #if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
             // Update tunnel statistics
             mWeaveTunnelStats.mDroppedMessagesCount++;
+            mWeaveTunnelStats.mTrafficClassStats[i].mDroppedMessages++;
 #endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
-
-            queuedPkt = NULL;
         }
+
+        mClassQueues[i].mDeficit = 0;
     }
+
+    mCurrentClass = kTrafficClass_High;
 }
 
-/* Dequeue a packet for sending via Service tunnel */
-PacketBuffer *WeaveTunnelAgent::DeQueuePacket(void)
+/* Dequeue a packet of a traffic class for sending via Service tunnel */
+PacketBuffer *WeaveTunnelAgent::DeQueuePacket(TunnelTrafficClass trafficClass)
 {
+    TrafficClassQueue &queue = mClassQueues[trafficClass];
     PacketBuffer *retPkt = NULL;
-    if (qFront != TUNNEL_PACKET_QUEUE_INVALID_INDEX)
+
+    if (queue.mCount != 0)
     {
-        retPkt = queuedMsgs[qFront];
-        if (qFront == qRear) // Only one packet in queue
+        retPkt = queue.mPkts[queue.mHead];
+        queue.mPkts[queue.mHead] = NULL;
+        queue.mHead = (queue.mHead + 1) % WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED;
+        queue.mCount--;
+        queue.mBytes -= retPkt->DataLength();
+    }
+
+    return retPkt;
+}
+
+bool WeaveTunnelAgent::HasQueuedPackets(void) const
+{
+    for (uint8_t i = 0; i < kTrafficClass_Max; i++)
+    {
+        if (mClassQueues[i].mCount != 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Return the tunnel connection that data traffic is sent over: the primary
+ * tunnel if open, else the backup tunnel if open, else NULL */
+const WeaveTunnelConnectionMgr *WeaveTunnelAgent::GetActiveTunnelConnMgr(void) const
+{
+    if (mPrimaryTunConnMgr.mConnectionState == WeaveTunnelConnectionMgr::kState_TunnelOpen)
+    {
+        return &mPrimaryTunConnMgr;
+    }
+
+#if WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
+    if (mBackupTunConnMgr.mConnectionState == WeaveTunnelConnectionMgr::kState_TunnelOpen)
+    {
+        return &mBackupTunConnMgr;
+    }
+#endif // WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
+
+    return NULL;
+}
+
+/* Send any encapsulated packets that were coalesced on the open tunnel
+ * connection(s) but not yet handed to the transport */
+void WeaveTunnelAgent::PushCoalescedPackets(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    if (mNumCoalescedPackets == 0)
+    {
+        ExitNow();
+    }
+
+    mNumCoalescedPackets = 0;
+
+    if (mPrimaryTunConnMgr.mConnectionState == WeaveTunnelConnectionMgr::kState_TunnelOpen)
+    {
+        err = mPrimaryTunConnMgr.mServiceCon->PushSendQueue();
+        if (err != WEAVE_NO_ERROR)
         {
-            qFront = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
-            qRear  = TUNNEL_PACKET_QUEUE_INVALID_INDEX;
+            WeaveLogError(WeaveTunnel, "Primary tunnel send err %ld\n", (long)err);
         }
-        else
+    }
+
+#if WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
+    if (mBackupTunConnMgr.mConnectionState == WeaveTunnelConnectionMgr::kState_TunnelOpen)
+    {
+        err = mBackupTunConnMgr.mServiceCon->PushSendQueue();
+        if (err != WEAVE_NO_ERROR)
         {
-            qFront = (qFront + 1) % WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED;
+            WeaveLogError(WeaveTunnel, "Backup tunnel send err %ld\n", (long)err);
         }
     }
+#endif // WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
 
-    return retPkt;
+exit:
+    return;
 }
 
-/* Flush queued messages that were pending because Service tunnel
- * was not setup */
-void WeaveTunnelAgent::SendQueuedMessages(const WeaveTunnelConnectionMgr *connMgr)
+/* Drain queued messages onto a tunnel connection using deficit round-robin
+ * across the traffic classes. Draining stops once the connection holds
+ * WEAVE_CONFIG_TUNNELING_MAX_PENDING_SEND_BYTES of unsent data and resumes
+ * from WeaveTunnelConnectionDataSent as the transport makes progress. Any
+ * coalesced messages are pushed before stopping so that the transport has
+ * something in flight to report progress on.
+ *
+ * When allowPush is false the messages are only queued on the connection;
+ * the caller is responsible for getting them written out. */
+void WeaveTunnelAgent::SendQueuedMessages(const WeaveTunnelConnectionMgr *connMgr, bool allowPush)
 {
+    static const uint32_t sClassQuantum[kTrafficClass_Max] =
+    {
+        WEAVE_CONFIG_TUNNELING_HIGH_CLASS_QUANTUM,
+        WEAVE_CONFIG_TUNNELING_NORMAL_CLASS_QUANTUM,
+        WEAVE_CONFIG_TUNNELING_BULK_CLASS_QUANTUM
+    };
+
     WeaveMessageInfo  msgInfo;
     PacketBuffer*     queuedPkt   = NULL;
+    WEAVE_ERROR       err         = WEAVE_NO_ERROR;
+    bool              dropPacket  = false;
+    bool              push        = false;
+    uint16_t          pktLen      = 0;
 
-    while ((queuedPkt = DeQueuePacket()) != NULL)
+    while (HasQueuedPackets())
     {
-        PopulateTunnelMsgHeader(&msgInfo, connMgr);
+        TrafficClassQueue &queue = mClassQueues[mCurrentClass];
 
-        // Send over TCP Connection
+        if (connMgr->mServiceCon->PendingSendLength() >= WEAVE_CONFIG_TUNNELING_MAX_PENDING_SEND_BYTES)
+        {
+            // The pending bytes include messages that are still being coalesced. Push them
+            // now, otherwise nothing is written and WeaveTunnelConnectionDataSent never
+            // fires to resume the drain.
+
+            if (allowPush && mNumCoalescedPackets > 0)
+            {
+                mNumCoalescedPackets = 0;
+
+                err = connMgr->mServiceCon->PushSendQueue();
+                if (err != WEAVE_NO_ERROR)
+                {
+                    WeaveLogError(WeaveTunnel, "Queued msg push err %ld\n", (long)err);
+                }
+            }
+
+            break;
+        }
 
+        if (queue.mCount == 0)
+        {
+            // An idle class does not accumulate credit.
+
+            queue.mDeficit = 0;
+            mCurrentClass = (mCurrentClass + 1) % kTrafficClass_Max;
+            mClassQueues[mCurrentClass].mDeficit += sClassQuantum[mCurrentClass];
+            continue;
+        }
+
+        pktLen = queue.mPkts[queue.mHead]->DataLength();
+        if (queue.mDeficit < pktLen)
+        {
+            mCurrentClass = (mCurrentClass + 1) % kTrafficClass_Max;
+            mClassQueues[mCurrentClass].mDeficit += sClassQuantum[mCurrentClass];
+            continue;
+        }
+
+        queue.mDeficit -= pktLen;
+        queuedPkt = DeQueuePacket(static_cast<TunnelTrafficClass>(mCurrentClass));
+
+        PopulateTunnelMsgHeader(&msgInfo, connMgr);
         msgInfo.DestNodeId = connMgr->mServiceCon->PeerNodeId;
-        connMgr->mServiceCon->SendTunneledMessage(&msgInfo, queuedPkt);
+
+        // Defer the transport write until either enough packets have been coalesced on the
+        // connection or the Tunnel EndPoint signals the end of the current receive batch.
+
+        push = (++mNumCoalescedPackets >= WEAVE_CONFIG_TUNNELING_MAX_NUM_COALESCED_PACKETS) && allowPush;
+        if (push)
+        {
+            mNumCoalescedPackets = 0;
+        }
+
+        dropPacket = false;
+        err = SendMessageUponPktTransitAnalysis(connMgr, kDir_Outbound, connMgr->mTunType,
+                                                &msgInfo, queuedPkt, dropPacket, push);
+        if (dropPacket)
+        {
+            PacketBuffer::Free(queuedPkt);
+        }
 
 #if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
-        UpdateOutboundMessageStatistics(connMgr->mTunType, queuedPkt->DataLength());
+        if (dropPacket)
+        {
+            mWeaveTunnelStats.mDroppedMessagesCount++;
+            mWeaveTunnelStats.mTrafficClassStats[mCurrentClass].mDroppedMessages++;
+        }
+        else if (err == WEAVE_NO_ERROR)
+        {
+            mWeaveTunnelStats.mTrafficClassStats[mCurrentClass].mSentMessages++;
+            mWeaveTunnelStats.mTrafficClassStats[mCurrentClass].mSentBytes += pktLen;
+        }
 #endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
 
+        if (err != WEAVE_NO_ERROR)
+        {
+            WeaveLogError(WeaveTunnel, "Queued msg send err %ld\n", (long)err);
+        }
+
         queuedPkt = NULL;
     }
 
@@ -1642,6 +1843,19 @@ void WeaveTunnelAgent::WeaveTunnelConnectionDown(const WeaveTunnelConnectionMgr
     }
 }
 
+/* Post processing function after data has been written out on a tunnel connection */
+void WeaveTunnelAgent::WeaveTunnelConnectionDataSent(const WeaveTunnelConnectionMgr *connMgr)
+{
+    // Refill the connection with queued messages now that it has room. The
+    // messages are only queued here; the transport is already sending and
+    // will pick them up when it completes the current write.
+
+    if (HasQueuedPackets() && GetActiveTunnelConnMgr() == connMgr)
+    {
+        SendQueuedMessages(connMgr, false);
+    }
+}
+
 void WeaveTunnelAgent::WeaveTunnelDownNotifyAndSetState(WEAVE_ERROR conErr)
 {
     // Change TunnelAgent state
@@ -1681,9 +1895,10 @@ void WeaveTunnelAgent::WeaveTunnelUpNotifyAndSetState(AgentState state,
 
     // Check if queue is non-empty; then send queued packets through established tunnel;
 
-    if (qFront != TUNNEL_PACKET_QUEUE_INVALID_INDEX)
+    if (HasQueuedPackets())
     {
-        SendQueuedMessages(connMgr);
+        SendQueuedMessages(connMgr, true);
+        PushCoalescedPackets();
     }
 
     // Notify application of successful tunnel establishment
@@ -39,8 +39,6 @@
 #define TUN_INTF_NAME_MAX_LEN                 (64)
 #define WEAVE_ULA_FABRIC_DEFAULT_PREFIX_LEN   (48)
 
-#define TUNNEL_PACKET_QUEUE_INVALID_INDEX     (-1)
-
 namespace nl {
 namespace Weave {
 namespace Profiles {
@@ -108,6 +106,19 @@ typedef struct WeaveTunnelCommonStatistics
     uint64_t     mLastTimeTunnelEstablished;                               /**< Last time Weave Tunnel was Established. */
 } WeaveTunnelCommonStatistics;
 
+/**
+ *  This structure contains the statistics counters for one traffic class of the
+ *  outbound queue to the Service.
+ */
+typedef struct WeaveTunnelTrafficClassStatistics
+{
+    uint32_t     mQueuedMessages;                                          /**< Number of messages accepted into the traffic class queue. */
+    uint32_t     mSentMessages;                                            /**< Number of messages scheduled from the queue onto a tunnel connection. */
+    uint32_t     mDroppedMessages;                                         /**< Number of messages dropped because the queue was full. */
+    uint64_t     mSentBytes;                                               /**< Number of bytes scheduled from the queue onto a tunnel connection. */
+    uint32_t     mQueuedBytesHighWatermark;                                /**< Largest number of bytes held in the queue at once. */
+} WeaveTunnelTrafficClassStatistics;
+
 /**
  *  This structure contains the relevant statistics counters for the WeaveTunnel.
  */
@@ -116,6 +127,7 @@ typedef struct WeaveTunnelStatistics
     WeaveTunnelCommonStatistics mPrimaryStats;                             /**< Primary Weave Tunnel statistics counters. */
     uint32_t     mDroppedMessagesCount;                                    /**< Number of dropped messages by the WeaveTunnelAgent. */
     TunnelType   mCurrentActiveTunnel;                                     /**< The Weave tunnel that is currently being used for data traffic. */
+    WeaveTunnelTrafficClassStatistics mTrafficClassStats[kTrafficClass_Max]; /**< Outbound queue statistics counters, indexed by TunnelTrafficClass. */
 #if WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
     WeaveTunnelCommonStatistics mBackupStats;                              /**< Backup Weave Tunnel statistics counters. */
     uint32_t     mTunnelFailoverCount;                                     /**< Counter for the Weave Tunnel Failover events. */
@@ -442,6 +454,12 @@ public:
  */
     static void RecvdFromTunnelEndPoint(TunEndPoint *tunEP, PacketBuffer *message);
 
+/**
+ * Handler invoked by the Tunnel EndPoint at the end of each batch of received IPv6 packets. Sends to the
+ * Service any encapsulated packets that were coalesced on the tunnel connection during the batch.
+ */
+    static void RecvdBatchCompleteFromTunnelEndPoint(TunEndPoint *tunEP);
+
 /**
  * Handler to receive tunneled IPv6 packets over the shortcut UDP tunnel between the border gateway and the mobile
  * device and forward to the Tunnel EndPoint interface after decapsulating the raw IPv6 packet from inside the
@@ -478,10 +496,28 @@ private:
 
     WeaveAuthMode mAuthMode;
 
-    // Queued messages for Service; pending until connection established.
+    // Queued messages for Service, one queue per traffic class; pending until
+    // the connection is established and has room for more data.
+
+    struct TrafficClassQueue
+    {
+        PacketBuffer *mPkts[WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED];
+        uint8_t mHead;                      // Index of the oldest packet
+        uint8_t mCount;                     // Number of packets queued
+        uint32_t mBytes;                    // Number of bytes queued
+        uint32_t mDeficit;                  // Deficit round-robin byte allowance
+    };
+
+    TrafficClassQueue mClassQueues[kTrafficClass_Max];
+
+    // Traffic class currently being served by the deficit round-robin scheduler.
+
+    uint8_t mCurrentClass;
+
+    // Number of encapsulated packets written to the tunnel connection but not
+    // yet pushed to the transport.
 
-    PacketBuffer *queuedMsgs[WEAVE_CONFIG_TUNNELING_MAX_NUM_PACKETS_QUEUED];
-    int qFront, qRear;
+    uint8_t mNumCoalescedPackets;
 
     // Role; Border gateway or Mobile device
 
@@ -572,22 +608,28 @@ private:
                                                   TunnelType tunType,
                                                   WeaveMessageInfo *msgInfo,
                                                   PacketBuffer *msg,
-                                                  bool &dropPacket);
+                                                  bool &dropPacket,
+                                                  bool push = true);
 
     static void ServiceMgrStatusHandler(void* appState, WEAVE_ERROR err, StatusReport *report);
 
     // Service queue management functions
 
-    void SendQueuedMessages(const WeaveTunnelConnectionMgr *connMgr);
+    void SendQueuedMessages(const WeaveTunnelConnectionMgr *connMgr, bool allowPush);
+    void PushCoalescedPackets(void);
     WEAVE_ERROR EnQueuePacket(PacketBuffer *pkt);
-    PacketBuffer *DeQueuePacket(void);
+    PacketBuffer *DeQueuePacket(TunnelTrafficClass trafficClass);
+    bool HasQueuedPackets(void) const;
     void DumpQueuedMessages(void);
+    const WeaveTunnelConnectionMgr *GetActiveTunnelConnMgr(void) const;
+    static TunnelTrafficClass ClassifyPacket(const PacketBuffer &pkt);
 
     // Tunnel Control post-processing functions
 
     void WeaveTunnelConnectionUp(const WeaveMessageInfo *msgInfo,
                                  const WeaveTunnelConnectionMgr *connMgr);
     void WeaveTunnelConnectionDown(const WeaveTunnelConnectionMgr *connMgr, WEAVE_ERROR conErr);
+    void WeaveTunnelConnectionDataSent(const WeaveTunnelConnectionMgr *connMgr);
     void WeaveTunnelServiceReconnectRequested(const WeaveTunnelConnectionMgr *connMgr,
                                               const char *redirectHost, const uint16_t redirectPort);
     void WeaveTunnelDownNotifyAndSetState(WEAVE_ERROR conErr);
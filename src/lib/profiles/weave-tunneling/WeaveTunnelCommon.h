@@ -83,6 +83,16 @@ typedef enum TunnelPktDirection
     kDir_Outbound                              = 2, ///<Indicates packet going out of the border gateway over the tunnel.
 } TunnelPktDirection;
 
+/// Traffic classes used to schedule outbound packets onto the tunnel to the Service.
+typedef enum TunnelTrafficClass
+{
+    kTrafficClass_High                         = 0, ///<Latency-sensitive traffic, e.g. alarms; IPv6 DSCP of CS5 and above (including EF).
+    kTrafficClass_Normal                       = 1, ///<Default class for traffic not otherwise marked.
+    kTrafficClass_Bulk                         = 2, ///<Throughput-oriented traffic, e.g. firmware or log transfers; IPv6 DSCP of LE or CS1/AF1x.
+
+    kTrafficClass_Max                          = 3, ///<Number of traffic classes.
+} TunnelTrafficClass;
+
 /// Roles that the Tunnel Agent can assume; i.e., either border gateway or mobile device.
 typedef enum Role
 {
@@ -686,6 +686,7 @@ void WeaveTunnelConnectionMgr::HandleServiceConnectionComplete(WeaveConnection *
 
     tConnMgr->mServiceCon->OnConnectionClosed = HandleServiceConnectionClosed;
     tConnMgr->mServiceCon->OnTunneledMessageReceived = RecvdFromService;
+    tConnMgr->mServiceCon->OnDataSent = HandleServiceConnectionDataSent;
 
     // Set the appropriate route priority based on the tunnel type
 
@@ -771,6 +772,23 @@ exit:
     return;
 }
 
+/**
+ * Handler invoked when data queued on the Service TCP connection has been written out. The
+ * Tunnel Agent uses this to refill the connection from its traffic class queues.
+ *
+ * @param[in] con                          A pointer to the WeaveConnection object.
+ *
+ * @param[in] len                          The number of bytes written out.
+ *
+ * @return void
+ */
+void WeaveTunnelConnectionMgr::HandleServiceConnectionDataSent (WeaveConnection *con, uint16_t len)
+{
+    WeaveTunnelConnectionMgr *tConnMgr = static_cast<WeaveTunnelConnectionMgr *>(con->AppState);
+
+    tConnMgr->mTunAgent->WeaveTunnelConnectionDataSent(tConnMgr);
+}
+
 /**
  * Handler invoked when Service TCP connection is closed. The device, subsequently, tries to
  * re-establish the connection to the Service.
@@ -172,6 +172,12 @@ class NL_DLL_EXPORT WeaveTunnelConnectionMgr
  */
     static void HandleServiceConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr);
 
+/**
+ * Handler invoked when data has been written out on the Service TCP connection. Messages still held
+ * in the Tunnel Agent's outbound queues are scheduled onto the connection as it drains.
+ */
+    static void HandleServiceConnectionDataSent(WeaveConnection *con, uint16_t len);
+
 /**
  * Handler to receive tunneled IPv6 packets from the Service TCP connection and forward to the Tunnel
  * EndPoint interface after decapsulating the raw IPv6 packet from inside the tunnel header.
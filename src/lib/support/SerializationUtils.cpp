@@ -15,6 +15,8 @@
  *    See the License for the specific language governing permissions and
  *    limitations under the License.
  */
+#include <string.h>
+
 #include <Weave/Support/CodeUtils.h>
 #include <Weave/Support/logging/WeaveLogging.h>
 #include <Weave/Support/SerializationUtils.h>
@@ -48,6 +50,13 @@ using namespace nl::Weave::TLV;
 // only on resource-rich platforms where dynamic memory allocation is
 // supported.
 //
+// Alternatively, a SerializationArena can be attached to the
+// SerializationContext.  Everything de-serialized with that context is
+// then allocated from the arena's buffer, DeallocateDeserializedStructure()
+// has nothing to do, and the memory is reclaimed in one step by
+// SerializationArena::Reset().  This avoids allocator churn for callers
+// that de-serialize many small objects per message.
+//
 
 #if WEAVE_CONFIG_SERIALIZATION_USE_MALLOC
 #if HAVE_MALLOC && HAVE_FREE && HAVE_REALLOC
@@ -76,6 +85,237 @@ static void *unsupported_realloc(void *ptr, size_t size)
 static MemoryManagement sDefaultMemoryManagement = { unsupported_malloc, unsupported_free, unsupported_realloc };
 #endif // WEAVE_CONFIG_SERIALIZATION_USE_MALLOC
 
+/**
+ * @brief
+ *   Return the memory management functions used to deserialize with the given context.
+ *
+ * @param aContext[in]          The serialization context, or NULL
+ *
+ * @return The context's memory management functions if all of them are set,
+ *         otherwise the default ones.
+ *
+ */
+MemoryManagement *GetSerializationMemoryManagement(SerializationContext *aContext)
+{
+    if ((aContext == NULL) || !(aContext->memMgmt.mem_alloc && aContext->memMgmt.mem_free && aContext->memMgmt.mem_realloc))
+    {
+        return &sDefaultMemoryManagement;
+    }
+
+    return &aContext->memMgmt;
+}
+
+/**
+ * @brief
+ *   Allocate memory for deserialized data, from the context's arena if it has one.
+ *
+ * @param aContext[in]          The serialization context, or NULL
+ *
+ * @param aSize[in]             The number of bytes to allocate
+ *
+ * @return A pointer to the memory, or NULL if it could not be allocated.
+ *
+ */
+void *SerializationAllocate(SerializationContext *aContext, size_t aSize)
+{
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+    {
+        return aContext->mArena->Allocate(aSize);
+    }
+
+    return GetSerializationMemoryManagement(aContext)->mem_alloc(aSize);
+}
+
+/**
+ * @brief
+ *   Resize memory allocated by SerializationAllocate(), with realloc() semantics.
+ *
+ * @param aContext[in]          The serialization context, or NULL
+ *
+ * @param aPtr[in]              The memory to resize, or NULL to allocate new memory
+ *
+ * @param aSize[in]             The new size in bytes
+ *
+ * @return A pointer to the resized memory, or NULL if it could not be resized, in
+ *         which case aPtr is left untouched.
+ *
+ */
+void *SerializationReallocate(SerializationContext *aContext, void *aPtr, size_t aSize)
+{
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+    {
+        return aContext->mArena->Reallocate(aPtr, aSize);
+    }
+
+    return GetSerializationMemoryManagement(aContext)->mem_realloc(aPtr, aSize);
+}
+
+/**
+ * @brief
+ *   Free memory allocated by SerializationAllocate().  Memory allocated from an arena
+ *   is only reclaimed when the arena is reset, so this does nothing for it.
+ *
+ * @param aContext[in]          The serialization context, or NULL
+ *
+ * @param aPtr[in]              The memory to free, or NULL
+ *
+ */
+void SerializationFree(SerializationContext *aContext, void *aPtr)
+{
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+    {
+        return;
+    }
+
+    GetSerializationMemoryManagement(aContext)->mem_free(aPtr);
+}
+
+SerializationContext::SerializationContext(void) :
+    mArena(NULL)
+{
+    memMgmt.mem_alloc = NULL;
+    memMgmt.mem_free = NULL;
+    memMgmt.mem_realloc = NULL;
+}
+
+SerializationArena::SerializationArena(void) :
+    mBuffer(NULL),
+    mBufferSize(0),
+    mBytesUsed(0),
+    mLastAllocation(NULL)
+{
+}
+
+/**
+ * @brief
+ *   Attach the arena to the buffer it allocates from, and empty it.
+ *
+ * @param aBuffer[in]           The buffer to allocate from; it must outlive the arena's use
+ *
+ * @param aBufferSize[in]       The size of the buffer in bytes
+ *
+ */
+void SerializationArena::Init(void *aBuffer, size_t aBufferSize)
+{
+    uint8_t *start = static_cast<uint8_t *>(aBuffer);
+    size_t padding = (aBuffer != NULL) ? RoundUp(reinterpret_cast<uintptr_t>(start)) - reinterpret_cast<uintptr_t>(start) : 0;
+
+    if (padding > aBufferSize)
+    {
+        padding = aBufferSize;
+    }
+
+    mBuffer = start + padding;
+    mBufferSize = aBufferSize - padding;
+
+    Reset();
+}
+
+/**
+ * @brief
+ *   Release everything allocated from the arena at once.  Any deserialized data still
+ *   referring to the arena must not be used afterwards.
+ */
+void SerializationArena::Reset(void)
+{
+    mBytesUsed = 0;
+    mLastAllocation = NULL;
+}
+
+/**
+ * @brief
+ *   Allocate memory from the arena.
+ *
+ * @param aSize[in]             The number of bytes to allocate
+ *
+ * @return A pointer to the memory, aligned to 8 bytes, or NULL if the arena is exhausted.
+ *
+ */
+void *SerializationArena::Allocate(size_t aSize)
+{
+    uint8_t *allocation;
+
+    if ((mBuffer == NULL) || (aSize > mBufferSize) || (RoundUp(aSize) + kHeaderSize > mBufferSize - mBytesUsed))
+    {
+        return NULL;
+    }
+
+    allocation = mBuffer + mBytesUsed + kHeaderSize;
+    *reinterpret_cast<size_t *>(allocation - kHeaderSize) = aSize;
+
+    mBytesUsed += kHeaderSize + RoundUp(aSize);
+    mLastAllocation = allocation;
+
+    return allocation;
+}
+
+/**
+ * @brief
+ *   Resize memory allocated from the arena.  The most recent allocation grows or shrinks
+ *   in place; any other is copied to a new allocation, and its old space is reclaimed
+ *   only when the arena is reset.
+ *
+ * @param aPtr[in]              The memory to resize, or NULL to allocate new memory
+ *
+ * @param aSize[in]             The new size in bytes
+ *
+ * @return A pointer to the resized memory, or NULL if the arena is exhausted or aPtr
+ *         was not allocated from it.
+ *
+ */
+void *SerializationArena::Reallocate(void *aPtr, size_t aSize)
+{
+    uint8_t *allocation = static_cast<uint8_t *>(aPtr);
+    size_t oldSize;
+    void *newAllocation;
+
+    if (allocation == NULL)
+    {
+        return Allocate(aSize);
+    }
+
+    if (!Contains(allocation))
+    {
+        return NULL;
+    }
+
+    oldSize = *reinterpret_cast<size_t *>(allocation - kHeaderSize);
+
+    if (allocation == mLastAllocation)
+    {
+        size_t offset = allocation - mBuffer;
+
+        if ((aSize > mBufferSize) || (RoundUp(aSize) > mBufferSize - offset))
+        {
+            return NULL;
+        }
+
+        *reinterpret_cast<size_t *>(allocation - kHeaderSize) = aSize;
+        mBytesUsed = offset + RoundUp(aSize);
+
+        return allocation;
+    }
+
+    newAllocation = Allocate(aSize);
+    if (newAllocation != NULL)
+    {
+        memcpy(newAllocation, allocation, (oldSize < aSize) ? oldSize : aSize);
+    }
+
+    return newAllocation;
+}
+
+/**
+ * @brief
+ *   Check whether memory was allocated from the arena's buffer.
+ */
+bool SerializationArena::Contains(const void *aPtr) const
+{
+    const uint8_t *ptr = static_cast<const uint8_t *>(aPtr);
+
+    return (mBuffer != NULL) && (ptr >= mBuffer) && (ptr < mBuffer + mBufferSize);
+}
+
 static WEAVE_ERROR WriteArrayData(TLVWriter &aWriter,
                                   void *aStructureData,
                                   const FieldDescriptor * aFieldPtr);
@@ -524,19 +764,9 @@ WEAVE_ERROR ReadArrayData(TLVReader &aReader, void *aStructureData, const FieldD
     char *outputBuffer = NULL;
     size_t outputBufferNumItems = 0;
     size_t outputBufferNumResizes = 0;
-    MemoryManagement *memMgmt = NULL;
     uint32_t elementSize = 0;
     bool endOfTLV = false;
 
-    if ((aContext == NULL) || !(aContext->memMgmt.mem_alloc && aContext->memMgmt.mem_free && aContext->memMgmt.mem_realloc))
-    {
-        memMgmt = &sDefaultMemoryManagement;
-    }
-    else
-    {
-        memMgmt = &aContext->memMgmt;
-    }
-
     // aStructureData should be pointing to the wrapped length and buffer structure
     array = static_cast<ArrayLengthAndBuffer *>(aStructureData);
 
@@ -568,8 +798,9 @@ WEAVE_ERROR ReadArrayData(TLVReader &aReader, void *aStructureData, const FieldD
         if (count >= outputBufferNumItems)
         {
             outputBufferNumItems = (1 << ++outputBufferNumResizes);
-            outputBuffer = (char *)memMgmt->mem_realloc((void *)outputBuffer, outputBufferNumItems*elementSize);
-            VerifyOrExit(outputBuffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+            char *newOutputBuffer = (char *)SerializationReallocate(aContext, (void *)outputBuffer, outputBufferNumItems*elementSize);
+            VerifyOrExit(newOutputBuffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+            outputBuffer = newOutputBuffer;
 
             LogReadWrite("%s allocating array memory at 0x%x", "R", outputBuffer);
         }
@@ -598,7 +829,7 @@ exit:
     {
         if (outputBuffer != NULL)
         {
-            memMgmt->mem_free(outputBuffer);
+            SerializationFree(aContext, outputBuffer);
         }
     }
 
@@ -719,16 +950,6 @@ WEAVE_ERROR ReadDataForType(TLVReader &aReader, void *aStructureData, const Fiel
 #if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     TLVType containerType;
-    MemoryManagement *memMgmt = NULL;
-
-    if ((aContext == NULL) || !(aContext->memMgmt.mem_alloc && aContext->memMgmt.mem_free && aContext->memMgmt.mem_realloc))
-    {
-        memMgmt = &sDefaultMemoryManagement;
-    }
-    else
-    {
-        memMgmt = &aContext->memMgmt;
-    }
 
     LogReadWrite("%s aStructureData 0x%x", "R", aStructureData);
 
@@ -838,7 +1059,7 @@ WEAVE_ERROR ReadDataForType(TLVReader &aReader, void *aStructureData, const Fiel
 
             LogReadWrite("%s int64 %d", "R", v);
 
-            *static_cast<int8_t *>(aStructureData) = v;
+            *static_cast<int64_t *>(aStructureData) = v;
             break;
         }
 
@@ -876,7 +1097,7 @@ WEAVE_ERROR ReadDataForType(TLVReader &aReader, void *aStructureData, const Fiel
             // TLV Strings are not null terminated
             uint32_t length = aReader.GetLength() + 1;
 
-            dst = (char *)memMgmt->mem_alloc(length);
+            dst = (char *)SerializationAllocate(aContext, length);
             VerifyOrExit(dst != NULL, err = WEAVE_ERROR_NO_MEMORY);
 
             err = aReader.GetString(dst, length);
@@ -892,7 +1113,7 @@ WEAVE_ERROR ReadDataForType(TLVReader &aReader, void *aStructureData, const Fiel
             SerializedByteString byteString;
             byteString.mLen = aReader.GetLength();
 
-            byteString.mBuf = static_cast<uint8_t *>(memMgmt->mem_alloc(byteString.mLen));
+            byteString.mBuf = static_cast<uint8_t *>(SerializationAllocate(aContext, byteString.mLen));
             VerifyOrExit(byteString.mBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
             aReader.GetBytes(byteString.mBuf, byteString.mLen);
 
@@ -1264,27 +1485,17 @@ WEAVE_ERROR DeallocateDeserializedArray(void *aArrayData,
 {
 #if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
     WEAVE_ERROR err = WEAVE_NO_ERROR;
-    MemoryManagement *memMgmt = NULL;
     ArrayLengthAndBuffer *array = NULL;
 
     // aStructureData should be pointing to the wrapped length and buffer structure
     array = static_cast<ArrayLengthAndBuffer *>(aArrayData);
 
-    if ((aContext == NULL) || !(aContext->memMgmt.mem_alloc && aContext->memMgmt.mem_free && aContext->memMgmt.mem_realloc))
-    {
-        memMgmt = &sDefaultMemoryManagement;
-    }
-    else
-    {
-        memMgmt = &aContext->memMgmt;
-    }
-
     if (aFieldDescriptors == NULL)
     {
         LogReadWrite("%s Freeing array of primitive type at 0x%x", "R", array->mElementBuffer);
 
         // The elements are of a primitive type, we can free the array now.
-        memMgmt->mem_free(array->mElementBuffer);
+        SerializationFree(aContext, array->mElementBuffer);
     }
     else
     {
@@ -1299,7 +1510,7 @@ WEAVE_ERROR DeallocateDeserializedArray(void *aArrayData,
         LogReadWrite("%s Freeing array of structures at 0x%x", "R", array->mElementBuffer);
 
         // Free the array now.
-        memMgmt->mem_free(array->mElementBuffer);
+        SerializationFree(aContext, array->mElementBuffer);
     }
 
 exit:
@@ -1317,16 +1528,9 @@ WEAVE_ERROR DeallocateDeserializedStructure(void *aStructureData,
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     const FieldDescriptor *fieldPtr = aFieldDescriptors->mFields;
     const FieldDescriptor *endFieldPtr = &(aFieldDescriptors->mFields[aFieldDescriptors->mNumFieldDescriptorElements]);
-    MemoryManagement *memMgmt = NULL;
 
-    if ((aContext == NULL) || !(aContext->memMgmt.mem_alloc && aContext->memMgmt.mem_free && aContext->memMgmt.mem_realloc))
-    {
-        memMgmt = &sDefaultMemoryManagement;
-    }
-    else
-    {
-        memMgmt = &aContext->memMgmt;
-    }
+    // Memory allocated from an arena is released all at once when the arena is reset.
+    VerifyOrExit((aContext == NULL) || (aContext->mArena == NULL), );
 
     while (fieldPtr < endFieldPtr)
     {
@@ -1365,7 +1569,7 @@ WEAVE_ERROR DeallocateDeserializedStructure(void *aStructureData,
                 LogReadWrite("%s Freeing UTF8String '%s' at 0x%x", "R", str, str);
 
                 // Go ahead and free it here.
-                memMgmt->mem_free(str);
+                SerializationFree(aContext, str);
                 break;
             }
 
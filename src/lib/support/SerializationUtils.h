@@ -248,14 +248,64 @@ struct MemoryManagement
 
 /**
  * @brief
- *   A c-struct containing any context or state we need for serializing or deserializing.
-     For now, just memory management.
+ *   A bump-pointer arena from which deserialized data can be allocated.
+ *
+ *   When a SerializationContext refers to an arena, every string, byte
+ *   string and array allocated while deserializing is carved out of the
+ *   arena's buffer instead of coming from the MemoryManagement functions,
+ *   and freeing it is a no-op.  All of it is released at once by Reset(),
+ *   typically after each message or notification has been processed.
+ */
+class SerializationArena
+{
+public:
+    SerializationArena(void);
+
+    void Init(void *aBuffer, size_t aBufferSize);
+    void Reset(void);
+
+    void *Allocate(size_t aSize);
+    void *Reallocate(void *aPtr, size_t aSize);
+
+    bool Contains(const void *aPtr) const;
+
+    size_t GetBytesUsed(void) const { return mBytesUsed; }
+    size_t GetBufferSize(void) const { return mBufferSize; }
+
+private:
+    enum
+    {
+        kAlignment = 8,                                     //!< Alignment of every allocation
+        kHeaderSize = kAlignment,                           //!< Space reserved ahead of each allocation for its size
+    };
+
+    static size_t RoundUp(size_t aSize) { return (aSize + kAlignment - 1) & ~static_cast<size_t>(kAlignment - 1); }
+
+    uint8_t *mBuffer;
+    size_t mBufferSize;
+    size_t mBytesUsed;
+    uint8_t *mLastAllocation;                               //!< Most recent allocation, which can be resized in place
+};
+
+/**
+ * @brief
+ *   A c-struct containing any context or state we need for serializing or deserializing:
+ *   the memory management functions, and optionally an arena that takes their place.
  */
 struct SerializationContext
 {
+    SerializationContext(void);
+
     MemoryManagement memMgmt;
+    SerializationArena *mArena;                             //!< If not NULL, deserialized data is allocated from this arena
 };
 
+MemoryManagement *GetSerializationMemoryManagement(SerializationContext *aContext);
+
+void *SerializationAllocate(SerializationContext *aContext, size_t aSize);
+void *SerializationReallocate(SerializationContext *aContext, void *aPtr, size_t aSize);
+void SerializationFree(SerializationContext *aContext, void *aPtr);
+
 WEAVE_ERROR SerializedDataToTLVWriter(nl::Weave::TLV::TLVWriter &aWriter,
                                       void *aStructureData,
                                       const SchemaFieldDescriptor *aFieldDescriptors);
@@ -0,0 +1,259 @@
+/*
+ *
+ *    Copyright (c) 2013-2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a pool of pre-generated, single-use ephemeral
+ *      ECDH key pairs.
+ *
+ */
+
+#include <string.h>
+
+#include "WeaveCrypto.h"
+#include "ECDHKeyPool.h"
+#include <Weave/Support/CodeUtils.h>
+
+namespace nl {
+namespace Weave {
+namespace Crypto {
+
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+
+ECDHKeyPool::Entry ECDHKeyPool::sEntries[WEAVE_CONFIG_ECDH_KEY_POOL_SIZE];
+
+/**
+ *  Get an ephemeral ECDH key pair, from the pool if one is ready for the curve, otherwise by
+ *  generating one.
+ *
+ *  The arguments are as for GenerateECDHKey(): on entry the lengths of @a encodedPubKey and
+ *  @a encodedPrivKey give the sizes of their buffers, and on return the lengths of the key.
+ *
+ *  @param[in]    curveOID          The curve of the key pair.
+ *  @param[inout] encodedPubKey     The public key, in X9.62 uncompressed format.
+ *  @param[inout] encodedPrivKey    The private key.
+ *
+ *  @retval #WEAVE_NO_ERROR                 On success.
+ *  @retval #WEAVE_ERROR_BUFFER_TOO_SMALL   If a buffer is too small for the key.
+ *  @retval other                           Errors from GenerateECDHKey().
+ */
+WEAVE_ERROR ECDHKeyPool::GetKey(OID curveOID, EncodedECPublicKey& encodedPubKey, EncodedECPrivateKey& encodedPrivKey)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    Entry *entry = Find(curveOID, kEntryState_Ready);
+
+    if (entry == NULL)
+    {
+        Reserve(curveOID);
+        ExitNow(err = GenerateECDHKey(curveOID, encodedPubKey, encodedPrivKey));
+    }
+
+    VerifyOrExit(entry->PubKeyLen <= encodedPubKey.ECPointLen && entry->PrivKeyLen <= encodedPrivKey.PrivKeyLen,
+                 err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    memcpy(encodedPubKey.ECPoint, entry->PubKey, entry->PubKeyLen);
+    encodedPubKey.ECPointLen = entry->PubKeyLen;
+    memcpy(encodedPrivKey.PrivKey, entry->PrivKey, entry->PrivKeyLen);
+    encodedPrivKey.PrivKeyLen = entry->PrivKeyLen;
+
+    // The key is single-use; remove every trace of the private key before it is replaced.
+    ClearSecretData(entry->PrivKey, sizeof(entry->PrivKey));
+    entry->PrivKeyLen = 0;
+    entry->State = kEntryState_Wanted;
+
+exit:
+    return err;
+}
+
+/**
+ *  Reserve a pool entry for keys on the specified curve.
+ *
+ *  A free entry is used if there is one. Otherwise an entry reserved for another curve is taken
+ *  over, provided its key has not been generated yet and that curve keeps at least one other
+ *  entry. Ready keys are never discarded, so curves used in turn do not throw away each other's
+ *  precomputed keys; nothing is done if no entry can be taken.
+ */
+void ECDHKeyPool::Reserve(OID curveOID)
+{
+    Entry *entry = Find(ASN1::kOID_NotSpecified, kEntryState_Free);
+
+    for (size_t i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE && entry == NULL; i++)
+    {
+        if (sEntries[i].CurveOID != curveOID && sEntries[i].State == kEntryState_Wanted &&
+            GetReservedCount(sEntries[i].CurveOID) > 1)
+            entry = &sEntries[i];
+    }
+
+    VerifyOrExit(entry != NULL, );
+
+    ClearSecretData(entry->PrivKey, sizeof(entry->PrivKey));
+    entry->CurveOID = curveOID;
+    entry->PrivKeyLen = 0;
+    entry->PubKeyLen = 0;
+    entry->State = kEntryState_Wanted;
+
+exit:
+    return;
+}
+
+/**
+ *  Return true if a reserved pool entry is waiting for its key to be generated.
+ */
+bool ECDHKeyPool::NeedsRefill(void)
+{
+    for (size_t i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE; i++)
+    {
+        if (sEntries[i].State == kEntryState_Wanted)
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ *  Generate the key for one reserved pool entry.
+ *
+ *  Each call performs at most one key generation, so that callers can spread refilling over
+ *  several turns of the event loop. If generation fails the entry is released.
+ */
+WEAVE_ERROR ECDHKeyPool::Refill(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    EncodedECPublicKey encodedPubKey;
+    EncodedECPrivateKey encodedPrivKey;
+    Entry *entry = NULL;
+
+    for (size_t i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE && entry == NULL; i++)
+    {
+        if (sEntries[i].State == kEntryState_Wanted)
+            entry = &sEntries[i];
+    }
+
+    VerifyOrExit(entry != NULL, );
+
+    encodedPubKey.ECPoint = entry->PubKey;
+    encodedPubKey.ECPointLen = sizeof(entry->PubKey);
+    encodedPrivKey.PrivKey = entry->PrivKey;
+    encodedPrivKey.PrivKeyLen = sizeof(entry->PrivKey);
+
+    err = GenerateECDHKey(entry->CurveOID, encodedPubKey, encodedPrivKey);
+    if (err != WEAVE_NO_ERROR)
+    {
+        ClearSecretData(entry->PrivKey, sizeof(entry->PrivKey));
+        entry->CurveOID = ASN1::kOID_NotSpecified;
+        entry->State = kEntryState_Free;
+        ExitNow();
+    }
+
+    entry->PubKeyLen = static_cast<uint8_t>(encodedPubKey.ECPointLen);
+    entry->PrivKeyLen = static_cast<uint8_t>(encodedPrivKey.PrivKeyLen);
+    entry->State = kEntryState_Ready;
+
+exit:
+    return err;
+}
+
+/**
+ *  Return the number of keys ready in the pool for the specified curve.
+ */
+uint8_t ECDHKeyPool::GetReadyCount(OID curveOID)
+{
+    uint8_t count = 0;
+
+    for (size_t i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE; i++)
+    {
+        if (sEntries[i].CurveOID == curveOID && sEntries[i].State == kEntryState_Ready)
+            count++;
+    }
+
+    return count;
+}
+
+/**
+ *  Clear every key from the pool and release all entries.
+ */
+void ECDHKeyPool::Clear(void)
+{
+    ClearSecretData(reinterpret_cast<uint8_t *>(sEntries), sizeof(sEntries));
+
+    for (size_t i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE; i++)
+    {
+        sEntries[i].CurveOID = ASN1::kOID_NotSpecified;
+        sEntries[i].State = kEntryState_Free;
+    }
+}
+
+uint8_t ECDHKeyPool::GetReservedCount(OID curveOID)
+{
+    uint8_t count = 0;
+
+    for (size_t i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE; i++)
+    {
+        if (sEntries[i].CurveOID == curveOID && sEntries[i].State != kEntryState_Free)
+            count++;
+    }
+
+    return count;
+}
+
+ECDHKeyPool::Entry *ECDHKeyPool::Find(OID curveOID, uint8_t state)
+{
+    for (size_t i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE; i++)
+    {
+        if (sEntries[i].State == state && (state == kEntryState_Free || sEntries[i].CurveOID == curveOID))
+            return &sEntries[i];
+    }
+
+    return NULL;
+}
+
+#else // WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+
+WEAVE_ERROR ECDHKeyPool::GetKey(OID curveOID, EncodedECPublicKey& encodedPubKey, EncodedECPrivateKey& encodedPrivKey)
+{
+    return GenerateECDHKey(curveOID, encodedPubKey, encodedPrivKey);
+}
+
+void ECDHKeyPool::Reserve(OID curveOID)
+{
+}
+
+bool ECDHKeyPool::NeedsRefill(void)
+{
+    return false;
+}
+
+WEAVE_ERROR ECDHKeyPool::Refill(void)
+{
+    return WEAVE_NO_ERROR;
+}
+
+uint8_t ECDHKeyPool::GetReadyCount(OID curveOID)
+{
+    return 0;
+}
+
+void ECDHKeyPool::Clear(void)
+{
+}
+
+#endif // WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+
+} // namespace Crypto
+} // namespace Weave
+} // namespace nl
@@ -0,0 +1,109 @@
+/*
+ *
+ *    Copyright (c) 2013-2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines a pool of pre-generated, single-use ephemeral
+ *      ECDH key pairs.
+ *
+ */
+
+#ifndef ECDHKEYPOOL_H_
+#define ECDHKEYPOOL_H_
+
+#include "EllipticCurve.h"
+
+namespace nl {
+namespace Weave {
+namespace Crypto {
+
+/**
+ *  @class ECDHKeyPool
+ *
+ *  @brief
+ *    A pool of pre-generated ephemeral ECDH key pairs, shared by all
+ *    protocol engines in the process.
+ *
+ *    Each pool entry remembers the curve it was last used for. Taking a
+ *    key leaves the entry wanting a replacement for the same curve, which
+ *    Refill() generates later, outside the handshake. Taking a key for a
+ *    curve that has no ready entry generates the key inline and reserves
+ *    an entry for that curve, so the pool follows the curves in use. An
+ *    entry is only taken from another curve while its key is still to be
+ *    generated and that curve keeps another entry, so ready keys are never
+ *    discarded and every curve in use keeps at least one entry.
+ *
+ *    Keys are handed out at most once and cleared from the pool when
+ *    taken, so forward secrecy is preserved.
+ *
+ *    The pool is not thread-safe; it must only be used from the thread
+ *    that runs the Weave event loop.
+ *
+ *    When #WEAVE_CONFIG_ECDH_KEY_POOL_SIZE is 0, GetKey() is equivalent
+ *    to GenerateECDHKey() and the remaining methods do nothing.
+ */
+class NL_DLL_EXPORT ECDHKeyPool
+{
+public:
+    static WEAVE_ERROR GetKey(OID curveOID, EncodedECPublicKey& encodedPubKey, EncodedECPrivateKey& encodedPrivKey);
+
+    static void Reserve(OID curveOID);
+    static bool NeedsRefill(void);
+    static WEAVE_ERROR Refill(void);
+    static uint8_t GetReadyCount(OID curveOID);
+    static void Clear(void);
+
+private:
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+
+    enum
+    {
+        kMaxPrivateKeySize                      = ((WEAVE_CONFIG_MAX_EC_BITS + 7) / 8) + 1,
+        kMaxPublicKeySize                       = (2 * ((WEAVE_CONFIG_MAX_EC_BITS + 7) / 8)) + 1
+    };
+
+    enum EntryState
+    {
+        kEntryState_Free                        = 0,
+        kEntryState_Wanted                      = 1,
+        kEntryState_Ready                       = 2
+    };
+
+    struct Entry
+    {
+        OID CurveOID;
+        uint8_t State;
+        uint8_t PubKeyLen;
+        uint8_t PrivKeyLen;
+        uint8_t PubKey[kMaxPublicKeySize];
+        uint8_t PrivKey[kMaxPrivateKeySize];
+    };
+
+    static Entry sEntries[WEAVE_CONFIG_ECDH_KEY_POOL_SIZE];
+
+    static Entry *Find(OID curveOID, uint8_t state);
+    static uint8_t GetReservedCount(OID curveOID);
+
+#endif // WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+};
+
+} // namespace Crypto
+} // namespace Weave
+} // namespace nl
+
+#endif /* ECDHKEYPOOL_H_ */
@@ -0,0 +1,771 @@
+#!/usr/bin/env python
+
+#
+#    Copyright (c) 2017 Nest Labs, Inc.
+#    All rights reserved.
+#
+#    Licensed under the Apache License, Version 2.0 (the "License");
+#    you may not use this file except in compliance with the License.
+#    You may obtain a copy of the License at
+#
+#        http://www.apache.org/licenses/LICENSE-2.0
+#
+#    Unless required by applicable law or agreed to in writing, software
+#    distributed under the License is distributed on an "AS IS" BASIS,
+#    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+#    See the License for the specific language governing permissions and
+#    limitations under the License.
+#
+
+#
+#    @file
+#      This file implements a Python script to generate a C++ header of
+#      specialized TLV serializers from the nl::FieldDescriptor and
+#      nl::SchemaFieldDescriptor tables used by SerializationUtils.
+#
+#      For every schema found in the input files, the header provides:
+#
+#        Serialize<Schema>()            - write the structure as a TLV
+#                                         structure with the given tag.
+#        Serialize<Schema>Helper()      - an EventWriterFunct that takes
+#                                         the structure as its app data.
+#        Deserialize<Schema>()          - read the TLV structure the
+#                                         reader is positioned on.
+#        Deserialize<Schema>Helper()    - counterpart of
+#                                         TLVReaderToDeserializedDataHelper().
+#        Deallocate<Schema>()           - release the memory allocated by
+#                                         Deserialize<Schema>().
+#
+#      The generated code produces the same encoding as the interpreter
+#      in SerializationUtils.cpp and accepts the same input: fields are
+#      expected in schema order, unknown or out of order fields are
+#      skipped, and nullable fields that are absent are nullified.
+#
+#      Usage: gen-tlv-serializers.py [--include <header>]... <source>...
+#
+
+import argparse
+import re
+import sys
+
+# Field type: (C type, writer method)
+fieldTypes = {
+    "Boolean":          ( "bool",                       "PutBoolean" ),
+    "UInt8":            ( "uint8_t",                    "Put" ),
+    "UInt16":           ( "uint16_t",                   "Put" ),
+    "UInt32":           ( "uint32_t",                   "Put" ),
+    "UInt64":           ( "uint64_t",                   "Put" ),
+    "Int8":             ( "int8_t",                     "Put" ),
+    "Int16":            ( "int16_t",                    "Put" ),
+    "Int32":            ( "int32_t",                    "Put" ),
+    "Int64":            ( "int64_t",                    "Put" ),
+    "FloatingPoint32":  ( "float",                      "Put" ),
+    "FloatingPoint64":  ( "double",                     "Put" ),
+    "UTF8String":       ( "char *",                     "PutString" ),
+    "ByteString":       ( "nl::SerializedByteString",   "PutBytes" ),
+    "Structure":        ( None,                         None ),
+    "Array":            ( None,                         None ),
+}
+
+class GeneratorError(Exception):
+    pass
+
+class Field(object):
+    def __init__(self, nested, offset, type, nullable, tag):
+        self.nested = nested            # Name of the nested schema, as referenced, or None
+        self.offset = offset            # Offset expression
+        self.type = type
+        self.nullable = nullable
+        self.tag = tag
+        self.element = None             # Element descriptor of an array
+        self.nullableIndex = None
+        self.nestedSchema = None
+
+class Schema(object):
+    def __init__(self, name, namespace, fieldsName, sizeExpr, path):
+        self.name = name
+        self.namespace = namespace
+        self.fieldsName = fieldsName
+        self.sizeExpr = sizeExpr
+        self.path = path
+        self.fields = None
+        self.lastDescriptor = None
+        self.numNullable = 0
+
+    def qualifiedParts(self):
+        return self.namespace + self.name.split("::")
+
+    def identifier(self):
+        parts = self.name.split("::")
+        return "_".join([ parts[0][0].upper() + parts[0][1:] ] + parts[1:])
+
+    def qualifiedFunction(self, prefix, suffix = ""):
+        return "::" + "::".join(self.namespace + [ prefix + self.identifier() + suffix ])
+
+def stripComments(text):
+    def replace(match):
+        s = match.group(0)
+        if s.startswith("/"):
+            # Keep line breaks so positions remain meaningful.
+            return "\n" * s.count("\n") if s.startswith("/*") else ""
+        return s
+    pattern = re.compile(r'//[^\n]*|/\*.*?\*/|"(?:\\.|[^\\"])*"', re.DOTALL)
+    return re.sub(pattern, replace, text)
+
+def splitTopLevel(text, sep = ","):
+    parts = []
+    depth = 0
+    current = ""
+    for c in text:
+        if c in "([{":
+            depth += 1
+        elif c in ")]}":
+            depth -= 1
+        if c == sep and depth == 0:
+            parts.append(current.strip())
+            current = ""
+        else:
+            current += c
+    if current.strip():
+        parts.append(current.strip())
+    return parts
+
+def matchingBrace(text, start):
+    depth = 0
+    for i in range(start, len(text)):
+        if text[i] == "{":
+            depth += 1
+        elif text[i] == "}":
+            depth -= 1
+            if depth == 0:
+                return i
+    raise GeneratorError("unbalanced braces")
+
+def namespaceSnapshots(text):
+    # Return a list of (position, namespace list) recorded at every brace.
+    snapshots = [ (0, []) ]
+    stack = []
+    for match in re.finditer(r'namespace\s+(\w+(?:\s*\([^)]*\))?)\s*\{|[{}]', text):
+        if match.group(1) is not None:
+            stack.append(re.sub(r'\s+', " ", match.group(1)))
+        elif match.group(0) == "{":
+            stack.append(None)
+        elif stack:
+            stack.pop()
+        snapshots.append((match.end(), [ n for n in stack if n is not None ] if None not in stack else None))
+    return snapshots
+
+def namespaceAt(snapshots, pos):
+    namespace = []
+    for snapshotPos, snapshotNamespace in snapshots:
+        if snapshotPos > pos:
+            break
+        namespace = snapshotNamespace
+    return namespace
+
+def parseInt(text, path):
+    try:
+        return int(text, 0)
+    except ValueError:
+        raise GeneratorError("%s: unsupported field descriptor value '%s'" % (path, text))
+
+def parseFieldDescriptor(entry, path):
+    parts = splitTopLevel(entry)
+    if len(parts) != 4:
+        raise GeneratorError("%s: unsupported field descriptor '%s'" % (path, entry))
+    nested, offset, typeAndFlags, tag = parts
+    if nested in ("NULL", "0"):
+        nested = None
+    elif nested.startswith("&"):
+        nested = nested[1:].strip()
+    else:
+        raise GeneratorError("%s: unsupported nested schema '%s'" % (path, nested))
+    match = re.match(r'SET_TYPE_AND_FLAGS\s*\(\s*(?:::)?(?:nl::)?SerializedFieldType(\w+)\s*,\s*(\w+)\s*\)$', typeAndFlags)
+    if match is None or match.group(1) not in fieldTypes:
+        raise GeneratorError("%s: unsupported field type '%s'" % (path, typeAndFlags))
+    return Field(nested, re.sub(r'\s+', " ", offset), match.group(1), parseInt(match.group(2), path) != 0, parseInt(tag, path))
+
+def parseSource(path, schemas, descriptorTables):
+    text = stripComments(open(path).read())
+    snapshots = namespaceSnapshots(text)
+
+    for match in re.finditer(r'\b(?:nl::)?FieldDescriptor\s+(\w+)\s*\[\s*\]\s*=\s*\{', text):
+        end = matchingBrace(text, match.end() - 1)
+        body = text[match.end():end]
+        entries = [ e.strip()[1:-1] for e in splitTopLevel(body) ]
+        descriptorTables[(path, match.group(1))] = [ parseFieldDescriptor(e, path) for e in entries ]
+
+    for match in re.finditer(r'\b(?:nl::)?SchemaFieldDescriptor\s+([\w:]+)\s*=\s*\{', text):
+        namespace = namespaceAt(snapshots, match.start())
+        if namespace is None:
+            raise GeneratorError("%s: schema %s is not in a named namespace" % (path, match.group(1)))
+        end = matchingBrace(text, match.end() - 1)
+        members = splitTopLevel(text[match.end():end])
+        values = {}
+        for i, member in enumerate(members):
+            designated = re.match(r'\.(\w+)\s*=\s*(.*)$', member, re.DOTALL)
+            if designated:
+                values[designated.group(1)] = designated.group(2).strip()
+            elif i < 3:
+                values[("mNumFieldDescriptorElements", "mFields", "mSize")[i]] = member
+        size = re.match(r'sizeof\s*\((.*)\)$', values.get("mSize", ""), re.DOTALL)
+        if "mFields" not in values or size is None:
+            raise GeneratorError("%s: unsupported schema definition %s" % (path, match.group(1)))
+        schemas.append(Schema(match.group(1), namespace, values["mFields"], size.group(1).strip(), path))
+
+def resolveSchemas(schemas, descriptorTables):
+    for schema in schemas:
+        descriptors = descriptorTables.get((schema.path, schema.fieldsName))
+        if descriptors is None:
+            raise GeneratorError("%s: field descriptors %s for schema %s not found" % (schema.path, schema.fieldsName, schema.name))
+        schema.lastDescriptor = descriptors[-1]
+
+        # An array descriptor is followed by the descriptor of its elements.
+        schema.fields = []
+        i = 0
+        while i < len(descriptors):
+            field = descriptors[i]
+            if field.type == "Array":
+                i += 1
+                if i == len(descriptors) or descriptors[i].type == "Array":
+                    raise GeneratorError("%s: array field %d of schema %s has no element type" % (schema.path, field.tag, schema.name))
+                field.element = descriptors[i]
+            if field.nullable:
+                field.nullableIndex = schema.numNullable
+                schema.numNullable += 1
+            schema.fields.append(field)
+            i += 1
+
+        tags = [ f.tag for f in schema.fields ]
+        if len(set(tags)) != len(tags):
+            raise GeneratorError("%s: schema %s has duplicate tags" % (schema.path, schema.name))
+
+        for field in schema.fields + [ f.element for f in schema.fields if f.element is not None ]:
+            if (field.type == "Structure") != (field.nested is not None):
+                raise GeneratorError("%s: field %d of schema %s has an invalid nested schema" % (schema.path, field.tag, schema.name))
+            if field.nested is not None:
+                field.nestedSchema = findSchema(schemas, field.nested, schema)
+
+def findSchema(schemas, reference, referrer):
+    parts = reference.lstrip(":").split("::")
+    candidates = [ s for s in schemas if s.qualifiedParts()[-len(parts):] == parts ]
+    if len(candidates) > 1:
+        # Prefer the schema visible from the referring namespace.
+        candidates = [ s for s in candidates if referrer.namespace[:len(s.namespace)] == s.namespace ] or candidates
+    if len(candidates) != 1:
+        raise GeneratorError("%s: cannot resolve nested schema %s of %s" % (referrer.path, reference, referrer.name))
+    return candidates[0]
+
+def orderSchemas(schemas):
+    # Nested schemas must be emitted before the schemas that use them.
+    ordered = []
+    visiting = set()
+    def visit(schema):
+        if schema in ordered:
+            return
+        if schema in visiting:
+            raise GeneratorError("%s: schema %s is recursive" % (schema.path, schema.name))
+        visiting.add(schema)
+        for field in schema.fields:
+            for f in (field, field.element):
+                if f is not None and f.nestedSchema is not None:
+                    visit(f.nestedSchema)
+        ordered.append(schema)
+    for schema in schemas:
+        visit(schema)
+    return ordered
+
+class Emitter(object):
+    def __init__(self):
+        self.lines = []
+        self.indent = 0
+
+    def line(self, text = ""):
+        self.lines.append(("    " * self.indent + text) if text else "")
+
+    def open(self, text = None):
+        if text is not None:
+            self.line(text)
+        self.line("{")
+        self.indent += 1
+
+    def close(self):
+        self.indent -= 1
+        self.line("}")
+
+    def exitLabel(self):
+        self.indent -= 1
+        self.line("exit:")
+        self.indent += 1
+
+def fieldPointer(field, cType, const):
+    qualifier = "const " if const else ""
+    separator = "" if cType.endswith("*") else " "
+    return "reinterpret_cast<%s%s%s*>(data + (%s))" % (qualifier, cType, separator, field.offset)
+
+def nullifiedFieldsPointer(schema, const):
+    last = schema.lastDescriptor
+    if last.nestedSchema is not None:
+        size = "%s.mSize" % last.nested
+    else:
+        size = "sizeof(%s)" % (fieldTypes[last.type][0] if fieldTypes[last.type][0] is not None else "void *")
+    qualifier = "const " if const else ""
+    return "%suint8_t *nullifiedFields = reinterpret_cast<%suint8_t *>(data + (%s) + %s);" % (qualifier, qualifier, last.offset, size)
+
+def emitWriteValue(e, field, tag, pointer):
+    if field.type == "Structure":
+        e.line("err = %s(aWriter, %s, %s);" % (field.nestedSchema.qualifiedFunction("Serialize"), tag, pointer))
+    elif field.type == "ByteString":
+        e.line("err = aWriter.PutBytes(%s, (%s)->mBuf, (%s)->mLen);" % (tag, pointer, pointer))
+    elif field.type == "Array":
+        emitWriteArray(e, field, tag, pointer)
+        return
+    else:
+        e.line("err = aWriter.%s(%s, *%s);" % (fieldTypes[field.type][1], tag, pointer))
+    e.line("SuccessOrExit(err);")
+
+def emitWriteArray(e, field, tag, pointer):
+    element = field.element
+
+    if element.type == "Structure":
+        elementPointer = "static_cast<const char *>(array->mElementBuffer) + i * %s.mSize" % element.nested
+    else:
+        elementPointer = "(static_cast<const %s *>(array->mElementBuffer) + i)" % fieldTypes[element.type][0]
+
+    e.open()
+    e.line("const nl::ArrayLengthAndBuffer *array = %s;" % pointer)
+    e.line("TLVType arrayType;")
+    e.line()
+    e.line("err = aWriter.StartContainer(%s, kTLVType_Array, arrayType);" % tag)
+    e.line("SuccessOrExit(err);")
+    e.line()
+    e.open("for (uint32_t i = 0; i < array->mNumElements; i++)")
+    emitWriteValue(e, element, "AnonymousTag", elementPointer)
+    e.close()
+    e.line()
+    e.line("err = aWriter.EndContainer(arrayType);")
+    e.line("SuccessOrExit(err);")
+    e.close()
+
+def emitSerialize(e, schema):
+    e.line("inline WEAVE_ERROR Serialize%s(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)" % schema.identifier())
+    e.open()
+    e.line("using namespace nl::Weave::TLV;")
+    e.line()
+    e.line("WEAVE_ERROR err;")
+    e.line("TLVType containerType;")
+    e.line("const char *data = static_cast<const char *>(aStructureData);")
+    if schema.numNullable > 0:
+        e.line(nullifiedFieldsPointer(schema, True))
+    e.line()
+    e.line("err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);")
+    e.line("SuccessOrExit(err);")
+
+    for field in schema.fields:
+        tag = "ContextTag(%d)" % field.tag
+        cType = fieldTypes[field.type][0]
+        if field.type in ("Structure",):
+            pointer = "data + (%s)" % field.offset
+        elif field.type == "Array":
+            pointer = fieldPointer(field, "nl::ArrayLengthAndBuffer", True)
+        elif field.type == "UTF8String":
+            pointer = fieldPointer(field, "char * const", True)
+        else:
+            pointer = fieldPointer(field, cType, True)
+
+        e.line()
+        if field.nullable:
+            e.open("if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, %d))" % field.nullableIndex)
+            e.line("err = aWriter.PutNull(%s);" % tag)
+            e.line("SuccessOrExit(err);")
+            e.close()
+            e.open("else")
+            emitWriteValue(e, field, tag, pointer)
+            e.close()
+        else:
+            emitWriteValue(e, field, tag, pointer)
+
+    e.line()
+    e.line("err = aWriter.EndContainer(containerType);")
+    e.line("SuccessOrExit(err);")
+    e.line()
+    e.exitLabel()
+    e.line("return err;")
+    e.close()
+    e.line()
+
+def emitReadValue(e, field, pointer):
+    if field.type == "Structure":
+        e.line("err = %s(aReader, %s, aContext);" % (field.nestedSchema.qualifiedFunction("Deserialize"), pointer))
+        e.line("SuccessOrExit(err);")
+    elif field.type == "FloatingPoint32":
+        e.open()
+        e.line("double value;")
+        e.line()
+        e.line("err = aReader.Get(value);")
+        e.line("SuccessOrExit(err);")
+        e.line("*%s = static_cast<float>(value);" % pointer)
+        e.close()
+    elif field.type == "UTF8String":
+        # TLV strings are not null terminated.
+        e.open()
+        e.line("uint32_t length = aReader.GetLength() + 1;")
+        e.line("char *string = static_cast<char *>(nl::SerializationAllocate(aContext, length));")
+        e.line()
+        e.line("VerifyOrExit(string != NULL, err = WEAVE_ERROR_NO_MEMORY);")
+        e.line()
+        e.line("err = aReader.GetString(string, length);")
+        e.line("if (err != WEAVE_NO_ERROR)")
+        e.line("    nl::SerializationFree(aContext, string);")
+        e.line("SuccessOrExit(err);")
+        e.line("*%s = string;" % pointer)
+        e.close()
+    elif field.type == "ByteString":
+        # The buffer is only handed over once it is filled, so that a failed read neither leaks it nor leaves
+        # it behind for the deallocator.
+        e.open()
+        e.line("nl::SerializedByteString *byteString = %s;" % pointer)
+        e.line("uint32_t length = aReader.GetLength();")
+        e.line("uint8_t *buffer = static_cast<uint8_t *>(nl::SerializationAllocate(aContext, length));")
+        e.line()
+        e.line("VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);")
+        e.line()
+        e.line("err = aReader.GetBytes(buffer, length);")
+        e.line("if (err != WEAVE_NO_ERROR)")
+        e.line("    nl::SerializationFree(aContext, buffer);")
+        e.line("SuccessOrExit(err);")
+        e.line("byteString->mBuf = buffer;")
+        e.line("byteString->mLen = length;")
+        e.close()
+    elif field.type == "Array":
+        emitReadArray(e, field, pointer)
+    else:
+        e.line("err = aReader.Get(*%s);" % pointer)
+        e.line("SuccessOrExit(err);")
+
+def emitReadArray(e, field, pointer):
+    element = field.element
+
+    if element.type == "Structure":
+        elementSize = "%s.mSize" % element.nested
+        elementPointer = "static_cast<char *>(array->mElementBuffer) + array->mNumElements * %s" % elementSize
+    else:
+        elementType = fieldTypes[element.type][0]
+        elementSize = "sizeof(%s)" % elementType
+        elementPointer = "(static_cast<%s *>(array->mElementBuffer) + array->mNumElements)" % elementType
+
+    # The element buffer grows by doubling, starting with two elements, as in the interpreter.
+    e.open()
+    e.line("nl::ArrayLengthAndBuffer *array = %s;" % pointer)
+    e.line("TLVType arrayType;")
+    e.line("uint32_t capacity = 0;")
+    e.line()
+    e.line("array->mNumElements = 0;")
+    e.line("array->mElementBuffer = NULL;")
+    e.line()
+    e.line("err = aReader.EnterContainer(arrayType);")
+    e.line("SuccessOrExit(err);")
+    e.line("VerifyOrExit(aReader.GetContainerType() == kTLVType_Array, err = WEAVE_ERROR_WRONG_TLV_TYPE);")
+    e.line()
+    e.open("while ((err = aReader.Next()) == WEAVE_NO_ERROR)")
+    e.open("if (array->mNumElements == capacity)")
+    e.line("void *buffer;")
+    e.line()
+    e.line("capacity = (capacity == 0) ? 2 : capacity * 2;")
+    e.line("buffer = nl::SerializationReallocate(aContext, array->mElementBuffer, capacity * %s);" % elementSize)
+    e.line("VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);")
+    e.line("array->mElementBuffer = buffer;")
+    e.close()
+    e.line()
+    emitReadValue(e, element, elementPointer)
+    e.line("array->mNumElements++;")
+    e.close()
+    e.line()
+    e.line("VerifyOrExit(err == WEAVE_END_OF_TLV, );")
+    e.line()
+    e.line("err = aReader.ExitContainer(arrayType);")
+    e.line("SuccessOrExit(err);")
+    e.close()
+
+def emitDeserialize(e, schema):
+    e.line("inline WEAVE_ERROR Deserialize%s(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)" % schema.identifier())
+    e.open()
+    e.line("using namespace nl::Weave::TLV;")
+    e.line()
+    e.line("WEAVE_ERROR err;")
+    e.line("TLVType containerType;")
+    e.line("char *data = static_cast<char *>(aStructureData);")
+    if schema.numNullable > 0:
+        e.line(nullifiedFieldsPointer(schema, False))
+    e.line("uint32_t nextField = 0;")
+    e.line()
+    e.line("err = aReader.EnterContainer(containerType);")
+    e.line("SuccessOrExit(err);")
+    e.line("VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);")
+    e.line()
+    if schema.numNullable > 0:
+        e.line("// Nullable fields that are not present are left nullified.")
+        for i in range(schema.numNullable):
+            e.line("SET_FIELD_NULLIFIED_BIT(nullifiedFields, %d);" % i)
+        e.line()
+    e.line("// Fields are expected in schema order; one found out of order is skipped like an unknown field.")
+    e.open("while ((err = aReader.Next()) == WEAVE_NO_ERROR)")
+    e.line("switch (TagNumFromTag(aReader.GetTag()))")
+    e.line("{")
+
+    for index, field in enumerate(schema.fields):
+        cType = fieldTypes[field.type][0]
+        if field.type == "Structure":
+            pointer = "data + (%s)" % field.offset
+        elif field.type == "Array":
+            pointer = fieldPointer(field, "nl::ArrayLengthAndBuffer", False)
+        else:
+            pointer = fieldPointer(field, cType, False)
+
+        e.line("case %d:" % field.tag)
+        e.open()
+        e.line("if (nextField > %d)" % index)
+        e.indent += 1
+        e.line("break;")
+        e.indent -= 1
+        e.line("nextField = %d;" % (index + 1))
+        e.line()
+        if field.nullable:
+            e.line("if (aReader.GetType() == kTLVType_Null)")
+            e.indent += 1
+            e.line("break;")
+            e.indent -= 1
+            e.line("CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, %d);" % field.nullableIndex)
+            e.line()
+        emitReadValue(e, field, pointer)
+        e.line("break;")
+        e.close()
+
+    e.line("default:")
+    e.indent += 1
+    e.line("// Unknown fields are skipped.")
+    e.line("break;")
+    e.indent -= 1
+    e.line("}")
+    e.close()
+    e.line()
+    e.line("VerifyOrExit(err == WEAVE_END_OF_TLV, );")
+    e.line()
+    e.line("err = aReader.ExitContainer(containerType);")
+    e.line("SuccessOrExit(err);")
+    e.line()
+    e.exitLabel()
+    e.line("return err;")
+    e.close()
+    e.line()
+
+def needsDeallocation(field):
+    return field.type in ("UTF8String", "ByteString", "Structure", "Array")
+
+def emitFreeValue(e, field, pointer):
+    if field.type == "Structure":
+        e.line("err = %s(%s, aContext);" % (field.nestedSchema.qualifiedFunction("Deallocate"), pointer))
+        e.line("SuccessOrExit(err);")
+    elif field.type == "UTF8String":
+        e.line("nl::SerializationFree(aContext, *%s);" % pointer)
+    elif field.type == "ByteString":
+        e.line("nl::SerializationFree(aContext, (%s)->mBuf);" % pointer)
+    elif field.type == "Array":
+        element = field.element
+        e.open()
+        e.line("nl::ArrayLengthAndBuffer *array = %s;" % pointer)
+        if needsDeallocation(element):
+            if element.type == "Structure":
+                elementPointer = "static_cast<char *>(array->mElementBuffer) + i * %s.mSize" % element.nested
+            else:
+                elementPointer = "(static_cast<%s *>(array->mElementBuffer) + i)" % fieldTypes[element.type][0]
+            e.line()
+            e.open("for (uint32_t i = 0; i < array->mNumElements; i++)")
+            emitFreeValue(e, element, elementPointer)
+            e.close()
+            e.line()
+        e.line("nl::SerializationFree(aContext, array->mElementBuffer);")
+        e.close()
+
+def emitDeallocate(e, schema):
+    fields = [ f for f in schema.fields if needsDeallocation(f) ]
+    nested = [ f for f in fields if f.type == "Structure" or (f.element is not None and f.element.type == "Structure") ]
+    nullable = [ f for f in fields if f.nullable ]
+
+    e.line("inline WEAVE_ERROR Deallocate%s(void *aStructureData, nl::SerializationContext *aContext)" % schema.identifier())
+    e.open()
+    if not fields:
+        e.line("return WEAVE_NO_ERROR;")
+        e.close()
+        e.line()
+        return
+
+    e.line("WEAVE_ERROR err = WEAVE_NO_ERROR;")
+    e.line("char *data = static_cast<char *>(aStructureData);")
+    if nullable:
+        e.line(nullifiedFieldsPointer(schema, False))
+    e.line()
+    e.line("// Memory allocated from an arena is released all at once when the arena is reset.")
+    e.line("if ((aContext != NULL) && (aContext->mArena != NULL))")
+    e.line("    return WEAVE_NO_ERROR;")
+
+    for field in fields:
+        cType = fieldTypes[field.type][0]
+        if field.type == "Structure":
+            pointer = "data + (%s)" % field.offset
+        elif field.type == "Array":
+            pointer = fieldPointer(field, "nl::ArrayLengthAndBuffer", False)
+        else:
+            pointer = fieldPointer(field, cType, False)
+
+        e.line()
+        if field.nullable:
+            e.open("if (!GET_FIELD_NULLIFIED_BIT(nullifiedFields, %d))" % field.nullableIndex)
+            emitFreeValue(e, field, pointer)
+            e.close()
+        else:
+            emitFreeValue(e, field, pointer)
+
+    e.line()
+    if nested:
+        e.exitLabel()
+    e.line("return err;")
+    e.close()
+    e.line()
+
+def emitHelpers(e, schema):
+    identifier = schema.identifier()
+
+    e.line("inline WEAVE_ERROR Serialize%sHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)" % identifier)
+    e.open()
+    e.line("return Serialize%s(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);" % identifier)
+    e.close()
+    e.line()
+    e.line("#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION")
+    e.line("inline WEAVE_ERROR Deserialize%sHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData," % identifier)
+    e.line("        nl::SerializationContext *aContext = NULL)")
+    e.open()
+    e.line("WEAVE_ERROR err = Deserialize%s(aReader, aAppData, aContext);" % identifier)
+    e.line()
+    e.line("if (err == WEAVE_NO_ERROR)")
+    e.indent += 1
+    e.line("err = aReader.Next();")
+    e.indent -= 1
+    e.line()
+    e.line("return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;")
+    e.close()
+    e.line("#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION")
+    e.line()
+
+def emitHeader(schemas, includes, inputs, guard):
+    e = Emitter()
+    e.line("/*")
+    e.line(" *")
+    e.line(" *    Copyright (c) 2017 Nest Labs, Inc.")
+    e.line(" *    All rights reserved.")
+    e.line(" *")
+    e.line(" *    Licensed under the Apache License, Version 2.0 (the \"License\");")
+    e.line(" *    you may not use this file except in compliance with the License.")
+    e.line(" *    You may obtain a copy of the License at")
+    e.line(" *")
+    e.line(" *        http://www.apache.org/licenses/LICENSE-2.0")
+    e.line(" *")
+    e.line(" *    Unless required by applicable law or agreed to in writing, software")
+    e.line(" *    distributed under the License is distributed on an \"AS IS\" BASIS,")
+    e.line(" *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.")
+    e.line(" *    See the License for the specific language governing permissions and")
+    e.line(" *    limitations under the License.")
+    e.line(" */")
+    e.line()
+    e.line("/**")
+    e.line(" *    @file")
+    e.line(" *      Specialized TLV serializers for the schemas in:")
+    e.line(" *")
+    for path in inputs:
+        e.line(" *        %s" % path)
+    e.line(" *")
+    e.line(" *      !!! WARNING !!! WARNING !!! WARNING !!!")
+    e.line(" *")
+    e.line(" *      DO NOT EDIT THIS FILE! This file is generated by the")
+    e.line(" *      gen-tlv-serializers.py script.")
+    e.line(" *")
+    e.line(" *      To make changes, edit the schema definitions and re-run the")
+    e.line(" *      script to generate this file.")
+    e.line(" *")
+    e.line(" */")
+    e.line()
+    e.line("#ifndef %s" % guard)
+    e.line("#define %s" % guard)
+    e.line()
+    e.line("#include <stddef.h>")
+    e.line()
+    e.line("#include <Weave/Support/CodeUtils.h>")
+    e.line("#include <Weave/Support/SerializationUtils.h>")
+    for include in includes:
+        e.line("#include %s" % include)
+    e.line()
+
+    namespace = []
+    for schema in schemas:
+        if schema.namespace != namespace:
+            for n in reversed(namespace):
+                e.line("} // %s" % n)
+            if namespace:
+                e.line()
+            for n in schema.namespace:
+                e.line("namespace %s {" % n)
+            if schema.namespace:
+                e.line()
+            namespace = schema.namespace
+
+        e.line("// %s" % schema.name)
+        e.line()
+        emitSerialize(e, schema)
+        e.line("#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION")
+        emitDeserialize(e, schema)
+        emitDeallocate(e, schema)
+        e.lines.pop()
+        e.line("#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION")
+        e.line()
+        emitHelpers(e, schema)
+
+    for n in reversed(namespace):
+        e.line("} // %s" % n)
+    if namespace:
+        e.line()
+    e.line("#endif // %s" % guard)
+    return "\n".join(e.lines) + "\n"
+
+def main():
+    parser = argparse.ArgumentParser(description = "Generate specialized TLV serializers from SerializationUtils schema descriptors.")
+    parser.add_argument("--include", action = "append", default = [], help = "header to include in the output, e.g. '<Foo.h>'")
+    parser.add_argument("--guard", default = None, help = "include guard of the output")
+    parser.add_argument("--output", "-o", default = None, help = "output file (default: stdout)")
+    parser.add_argument("sources", nargs = "+", help = "C/C++ files defining the schemas")
+    args = parser.parse_args()
+
+    schemas = []
+    descriptorTables = {}
+    try:
+        for path in args.sources:
+            parseSource(path, schemas, descriptorTables)
+        resolveSchemas(schemas, descriptorTables)
+        schemas = orderSchemas(schemas)
+    except (GeneratorError, IOError) as error:
+        sys.stderr.write("gen-tlv-serializers.py: %s\n" % error)
+        return 1
+
+    guard = args.guard
+    if guard is None:
+        name = args.output.split("/")[-1] if args.output else "TLV_SERIALIZERS_H"
+        guard = re.sub(r'\W', "_", name).upper() + "_"
+
+    header = emitHeader(schemas, args.include, args.sources, guard)
+    if args.output:
+        open(args.output, "w").write(header)
+    else:
+        sys.stdout.write(header)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
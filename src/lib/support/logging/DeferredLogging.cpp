@@ -0,0 +1,899 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements the deferred logging backend of the Weave
+ *      SDK logging interface: a bounded, lock-free, multiple-producer
+ *      ring of raw log records, and the formatter that turns them back
+ *      into text.
+ *
+ */
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <Weave/Support/NLDLLUtil.h>
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Support/CodeUtils.h>
+#include "WeaveLogging.h"
+#include "DeferredLogging.h"
+
+#if WEAVE_CONFIG_DEFERRED_LOGGING
+
+#if HAVE_SYS_TIME_H
+#include <sys/time.h>
+#endif // HAVE_SYS_TIME_H
+
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+#include <pthread.h>
+#include <time.h>
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+namespace nl {
+namespace Weave {
+namespace Logging {
+
+namespace {
+
+enum ArgClass
+{
+    kArgClass_None          = 0,    // '%%'
+    kArgClass_Signed,
+    kArgClass_Unsigned,
+    kArgClass_Double,
+    kArgClass_String,
+    kArgClass_Pointer,
+    kArgClass_Unsupported,
+};
+
+enum LengthModifier
+{
+    kLength_None            = 0,
+    kLength_hh,
+    kLength_h,
+    kLength_l,
+    kLength_ll,
+    kLength_j,
+    kLength_z,
+    kLength_t,
+    kLength_L,
+};
+
+/*
+ * One conversion specification of a format string, split so that it
+ * can be rebuilt with the '*' fields resolved and the length modifier
+ * normalized to the type the argument is stored as.
+ */
+struct ConversionSpec
+{
+    const char *mFlags;
+    size_t mFlagsLen;
+    const char *mWidth;
+    size_t mWidthLen;
+    const char *mPrecision;         // Excluding the '.'
+    size_t mPrecisionLen;
+    bool mHasPrecision;
+    bool mIsWidthFromArg;
+    bool mIsPrecisionFromArg;
+    LengthModifier mLength;
+    char mConversion;
+    ArgClass mClass;
+};
+
+DeferredLogRecord sRing[WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS];
+
+// Producers claim slots by advancing sEnqueuePos; the single consumer owns sDequeuePos
+volatile uint32_t sEnqueuePos;
+volatile uint32_t sDequeuePos;
+volatile uint32_t sIsDraining;
+volatile uint32_t sDropCount;
+uint32_t sReportedDropCount;
+
+volatile bool sIsActive;
+bool sIsRingInitialized;
+
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+pthread_t sDrainThread;
+volatile bool sIsDrainThreadRunning;
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+const uint32_t kRingMask = WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS - 1;
+const size_t kMaxSpecLen = 32;
+const size_t kMaxStringArgLen = 0xFFFF;
+
+/*
+ * Parse the conversion specification following a '%'. On return,
+ * aFormat points just past the conversion character.
+ */
+void ParseConversionSpec(const char *&aFormat, ConversionSpec &aSpec)
+{
+    const char *p = aFormat;
+
+    memset(&aSpec, 0, sizeof(aSpec));
+
+    aSpec.mFlags = p;
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0')
+        p++;
+    aSpec.mFlagsLen = p - aSpec.mFlags;
+
+    aSpec.mWidth = p;
+    if (*p == '*')
+    {
+        aSpec.mIsWidthFromArg = true;
+        p++;
+    }
+    else
+    {
+        while (*p >= '0' && *p <= '9')
+            p++;
+    }
+    aSpec.mWidthLen = p - aSpec.mWidth;
+
+    if (*p == '.')
+    {
+        p++;
+        aSpec.mHasPrecision = true;
+        aSpec.mPrecision = p;
+        if (*p == '*')
+        {
+            aSpec.mIsPrecisionFromArg = true;
+            p++;
+        }
+        else
+        {
+            while (*p >= '0' && *p <= '9')
+                p++;
+        }
+        aSpec.mPrecisionLen = p - aSpec.mPrecision;
+    }
+
+    switch (*p)
+    {
+    case 'h':
+        p++;
+        aSpec.mLength = kLength_h;
+        if (*p == 'h')
+        {
+            p++;
+            aSpec.mLength = kLength_hh;
+        }
+        break;
+    case 'l':
+        p++;
+        aSpec.mLength = kLength_l;
+        if (*p == 'l')
+        {
+            p++;
+            aSpec.mLength = kLength_ll;
+        }
+        break;
+    case 'j': p++; aSpec.mLength = kLength_j; break;
+    case 'z': p++; aSpec.mLength = kLength_z; break;
+    case 't': p++; aSpec.mLength = kLength_t; break;
+    case 'L': p++; aSpec.mLength = kLength_L; break;
+    default: break;
+    }
+
+    aSpec.mConversion = *p;
+
+    switch (*p)
+    {
+    case '%':
+        aSpec.mClass = kArgClass_None;
+        break;
+    case 'd': case 'i':
+        aSpec.mClass = kArgClass_Signed;
+        break;
+    case 'c':
+        // Wide characters are not supported
+        aSpec.mClass = (aSpec.mLength == kLength_None) ? kArgClass_Signed : kArgClass_Unsupported;
+        break;
+    case 'u': case 'o': case 'x': case 'X':
+        aSpec.mClass = kArgClass_Unsigned;
+        break;
+    case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+        aSpec.mClass = kArgClass_Double;
+        break;
+    case 's':
+        aSpec.mClass = (aSpec.mLength == kLength_None) ? kArgClass_String : kArgClass_Unsupported;
+        break;
+    case 'p':
+        aSpec.mClass = kArgClass_Pointer;
+        break;
+    default:
+        // '%n', wide strings, and anything unknown, including a truncated specification
+        aSpec.mClass = kArgClass_Unsupported;
+        break;
+    }
+
+    if (*p != '\0')
+        p++;
+
+    aFormat = p;
+}
+
+/*
+ * Sequential writer/reader over the argument area of a record.
+ */
+class ArgBuffer
+{
+public:
+    ArgBuffer(uint8_t *aBuf, size_t aLen) : mBuf(aBuf), mLen(aLen), mPos(0) { }
+
+    bool Put(const void *aData, size_t aLen)
+    {
+        if (aLen > mLen - mPos)
+            return false;
+        memcpy(mBuf + mPos, aData, aLen);
+        mPos += aLen;
+        return true;
+    }
+
+    bool Get(void *aData, size_t aLen)
+    {
+        if (aLen > mLen - mPos)
+            return false;
+        memcpy(aData, mBuf + mPos, aLen);
+        mPos += aLen;
+        return true;
+    }
+
+    const uint8_t *Skip(size_t aLen)
+    {
+        const uint8_t *data = mBuf + mPos;
+        if (aLen > mLen - mPos)
+            return NULL;
+        mPos += aLen;
+        return data;
+    }
+
+    size_t GetLength(void) const { return mPos; }
+
+private:
+    uint8_t *mBuf;
+    size_t mLen;
+    size_t mPos;
+};
+
+int64_t GetSignedArg(LengthModifier aLength, va_list &aArgs)
+{
+    switch (aLength)
+    {
+    case kLength_hh: return static_cast<signed char>(va_arg(aArgs, int));
+    case kLength_h:  return static_cast<short>(va_arg(aArgs, int));
+    case kLength_l:  return va_arg(aArgs, long);
+    case kLength_ll: return va_arg(aArgs, long long);
+    case kLength_j:  return va_arg(aArgs, intmax_t);
+    case kLength_z:  return static_cast<int64_t>(va_arg(aArgs, size_t));
+    case kLength_t:  return va_arg(aArgs, ptrdiff_t);
+    default:         return va_arg(aArgs, int);
+    }
+}
+
+uint64_t GetUnsignedArg(LengthModifier aLength, va_list &aArgs)
+{
+    switch (aLength)
+    {
+    case kLength_hh: return static_cast<unsigned char>(va_arg(aArgs, unsigned int));
+    case kLength_h:  return static_cast<unsigned short>(va_arg(aArgs, unsigned int));
+    case kLength_l:  return va_arg(aArgs, unsigned long);
+    case kLength_ll: return va_arg(aArgs, unsigned long long);
+    case kLength_j:  return va_arg(aArgs, uintmax_t);
+    case kLength_z:  return va_arg(aArgs, size_t);
+    case kLength_t:  return static_cast<uint64_t>(va_arg(aArgs, ptrdiff_t));
+    default:         return va_arg(aArgs, unsigned int);
+    }
+}
+
+/*
+ * Copy the arguments of aFormat into aArgBuf. Returns false if the
+ * format string uses a conversion that cannot be deferred.
+ */
+bool PackArgs(const char *aFormat, va_list aArgs, ArgBuffer &aArgBuf, bool &aIsTruncated)
+{
+    ConversionSpec spec;
+    va_list args;
+    bool retval = true;
+
+    va_copy(args, aArgs);
+
+    while (*aFormat != '\0')
+    {
+        int32_t precision = -1;
+
+        if (*aFormat++ != '%')
+            continue;
+
+        ParseConversionSpec(aFormat, spec);
+
+        VerifyOrExit(spec.mClass != kArgClass_Unsupported, retval = false);
+
+        if (spec.mIsWidthFromArg)
+        {
+            int32_t width = va_arg(args, int);
+            aIsTruncated = aIsTruncated || !aArgBuf.Put(&width, sizeof(width));
+        }
+
+        if (spec.mIsPrecisionFromArg)
+        {
+            precision = va_arg(args, int);
+            aIsTruncated = aIsTruncated || !aArgBuf.Put(&precision, sizeof(precision));
+        }
+        else if (spec.mHasPrecision)
+        {
+            precision = static_cast<int32_t>(strtoul(spec.mPrecision, NULL, 10));
+        }
+
+        // Keep consuming the arguments after truncation so an unsupported conversion is still detected
+        switch (spec.mClass)
+        {
+        case kArgClass_Signed:
+        {
+            int64_t val = GetSignedArg(spec.mLength, args);
+            aIsTruncated = aIsTruncated || !aArgBuf.Put(&val, sizeof(val));
+            break;
+        }
+        case kArgClass_Unsigned:
+        {
+            uint64_t val = GetUnsignedArg(spec.mLength, args);
+            aIsTruncated = aIsTruncated || !aArgBuf.Put(&val, sizeof(val));
+            break;
+        }
+        case kArgClass_Double:
+        {
+            double val = (spec.mLength == kLength_L) ? static_cast<double>(va_arg(args, long double)) : va_arg(args, double);
+            aIsTruncated = aIsTruncated || !aArgBuf.Put(&val, sizeof(val));
+            break;
+        }
+        case kArgClass_Pointer:
+        {
+            void *val = va_arg(args, void *);
+            aIsTruncated = aIsTruncated || !aArgBuf.Put(&val, sizeof(val));
+            break;
+        }
+        case kArgClass_String:
+        {
+            const char *val = va_arg(args, const char *);
+            size_t len;
+            size_t space;
+            uint16_t storedLen;
+
+            if (val == NULL)
+                val = "(null)";
+
+            if (aIsTruncated)
+                break;
+
+            // A precision bounds the characters printed, so the string need not be NUL terminated
+            len = (precision >= 0 && static_cast<size_t>(precision) < kMaxStringArgLen) ? static_cast<size_t>(precision) : kMaxStringArgLen;
+            len = strnlen(val, len);
+
+            // Store as much of the string as fits after its length prefix; the arguments after a clipped string are dropped
+            space = WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE - aArgBuf.GetLength();
+            if (space < sizeof(storedLen))
+            {
+                aIsTruncated = true;
+                break;
+            }
+
+            if (len > space - sizeof(storedLen))
+            {
+                len = space - sizeof(storedLen);
+                aIsTruncated = true;
+            }
+
+            storedLen = static_cast<uint16_t>(len);
+            aArgBuf.Put(&storedLen, sizeof(storedLen));
+            aArgBuf.Put(val, len);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+exit:
+    va_end(args);
+
+    return retval;
+}
+
+/*
+ * Append the text of one conversion to aBuf, rebuilding the
+ * specification for the type its argument was stored as.
+ */
+void AppendConversion(const ConversionSpec &aSpec, ArgBuffer &aArgBuf, char *aBuf, size_t aBufSize, size_t &aPos, bool &aIsTruncated)
+{
+    char specBuf[kMaxSpecLen];
+    char *s = specBuf;
+    int32_t width = 0;
+    int32_t precision = 0;
+    int len = 0;
+
+    if (aSpec.mIsWidthFromArg && !aArgBuf.Get(&width, sizeof(width)))
+        ExitNow(aIsTruncated = true);
+    if (aSpec.mIsPrecisionFromArg && !aArgBuf.Get(&precision, sizeof(precision)))
+        ExitNow(aIsTruncated = true);
+
+    // The flags, width, and precision of a literal format string are short; clip anything else
+    VerifyOrExit(aSpec.mFlagsLen + aSpec.mWidthLen + aSpec.mPrecisionLen < kMaxSpecLen - 24, aIsTruncated = true);
+
+    *s++ = '%';
+    memcpy(s, aSpec.mFlags, aSpec.mFlagsLen);
+    s += aSpec.mFlagsLen;
+
+    if (aSpec.mIsWidthFromArg)
+    {
+        s += snprintf(s, 12, "%d", static_cast<int>(width));
+    }
+    else
+    {
+        memcpy(s, aSpec.mWidth, aSpec.mWidthLen);
+        s += aSpec.mWidthLen;
+    }
+
+    if (aSpec.mHasPrecision)
+    {
+        *s++ = '.';
+        if (aSpec.mIsPrecisionFromArg)
+        {
+            s += snprintf(s, 12, "%d", static_cast<int>(precision));
+        }
+        else
+        {
+            memcpy(s, aSpec.mPrecision, aSpec.mPrecisionLen);
+            s += aSpec.mPrecisionLen;
+        }
+    }
+
+    switch (aSpec.mClass)
+    {
+    case kArgClass_Signed:
+    case kArgClass_Unsigned:
+    {
+        uint64_t val;
+
+        VerifyOrExit(aArgBuf.Get(&val, sizeof(val)), aIsTruncated = true);
+
+        if (aSpec.mConversion != 'c')
+        {
+            *s++ = 'l';
+            *s++ = 'l';
+        }
+        *s++ = aSpec.mConversion;
+        *s = '\0';
+
+        if (aSpec.mConversion == 'c')
+            len = snprintf(aBuf + aPos, aBufSize - aPos, specBuf, static_cast<int>(val));
+        else if (aSpec.mClass == kArgClass_Signed)
+            len = snprintf(aBuf + aPos, aBufSize - aPos, specBuf, static_cast<long long>(val));
+        else
+            len = snprintf(aBuf + aPos, aBufSize - aPos, specBuf, static_cast<unsigned long long>(val));
+        break;
+    }
+    case kArgClass_Double:
+    {
+        double val;
+
+        VerifyOrExit(aArgBuf.Get(&val, sizeof(val)), aIsTruncated = true);
+
+        *s++ = aSpec.mConversion;
+        *s = '\0';
+        len = snprintf(aBuf + aPos, aBufSize - aPos, specBuf, val);
+        break;
+    }
+    case kArgClass_Pointer:
+    {
+        void *val;
+
+        VerifyOrExit(aArgBuf.Get(&val, sizeof(val)), aIsTruncated = true);
+
+        *s++ = 'p';
+        *s = '\0';
+        len = snprintf(aBuf + aPos, aBufSize - aPos, specBuf, val);
+        break;
+    }
+    case kArgClass_String:
+    {
+        uint16_t storedLen;
+        const uint8_t *val;
+
+        VerifyOrExit(aArgBuf.Get(&storedLen, sizeof(storedLen)), aIsTruncated = true);
+        val = aArgBuf.Skip(storedLen);
+        VerifyOrExit(val != NULL, aIsTruncated = true);
+
+        // The copy is not NUL terminated; bound it through the precision
+        if (!aSpec.mHasPrecision)
+        {
+            *s++ = '.';
+            *s++ = '*';
+            *s++ = 's';
+            *s = '\0';
+            len = snprintf(aBuf + aPos, aBufSize - aPos, specBuf, static_cast<int>(storedLen), reinterpret_cast<const char *>(val));
+        }
+        else
+        {
+            // Move the explicit precision into an argument, capped by the stored length
+            int32_t maxLen = aSpec.mIsPrecisionFromArg ? precision : static_cast<int32_t>(strtoul(aSpec.mPrecision, NULL, 10));
+
+            if (maxLen < 0 || maxLen > storedLen)
+                maxLen = storedLen;
+
+            s = specBuf + 1 + aSpec.mFlagsLen;
+            if (aSpec.mIsWidthFromArg)
+                s += snprintf(s, 12, "%d", static_cast<int>(width));
+            else
+                s += aSpec.mWidthLen;
+            *s++ = '.';
+            *s++ = '*';
+            *s++ = 's';
+            *s = '\0';
+            len = snprintf(aBuf + aPos, aBufSize - aPos, specBuf, static_cast<int>(maxLen), reinterpret_cast<const char *>(val));
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+exit:
+    if (len > 0)
+    {
+        aPos += static_cast<size_t>(len);
+        if (aPos >= aBufSize)
+            aPos = aBufSize - 1;
+    }
+}
+
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+void *DrainThreadMain(void *aArg)
+{
+    struct timespec interval;
+
+    interval.tv_sec = WEAVE_CONFIG_DEFERRED_LOGGING_DRAIN_INTERVAL_MS / 1000;
+    interval.tv_nsec = (WEAVE_CONFIG_DEFERRED_LOGGING_DRAIN_INTERVAL_MS % 1000) * 1000000;
+
+    while (sIsDrainThreadRunning)
+    {
+        if (DrainDeferredLog() == 0)
+        {
+            nanosleep(&interval, NULL);
+        }
+    }
+
+    return NULL;
+}
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+} // namespace
+
+/**
+ * Start capturing log messages into the deferred logging ring
+ * instead of formatting them on the calling thread.
+ *
+ * @param[in] aStartThread  If true, and the platform supports POSIX
+ *                          threads, start a background thread that
+ *                          drains the ring. Otherwise the application
+ *                          is expected to call DrainDeferredLog()
+ *                          periodically.
+ *
+ * @retval #WEAVE_NO_ERROR                     On success.
+ * @retval #WEAVE_ERROR_INCORRECT_STATE        If deferred logging is already active.
+ * @retval #WEAVE_ERROR_UNSUPPORTED_WEAVE_FEATURE
+ *                                             If a thread was requested but the
+ *                                             platform has none.
+ * @retval other                               Errors starting the thread.
+ */
+NL_DLL_EXPORT WEAVE_ERROR StartDeferredLogging(bool aStartThread)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    VerifyOrExit(!sIsActive, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    if (!sIsRingInitialized)
+    {
+        for (uint32_t i = 0; i < WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS; i++)
+        {
+            sRing[i].mSequence = i;
+        }
+
+        sEnqueuePos = 0;
+        sDequeuePos = 0;
+        sIsRingInitialized = true;
+        __sync_synchronize();
+    }
+
+    if (aStartThread)
+    {
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+        int pthreadErr;
+
+        sIsDrainThreadRunning = true;
+
+        pthreadErr = pthread_create(&sDrainThread, NULL, DrainThreadMain, NULL);
+        if (pthreadErr != 0)
+        {
+            sIsDrainThreadRunning = false;
+            ExitNow(err = System::MapErrorPOSIX(pthreadErr));
+        }
+#else
+        ExitNow(err = WEAVE_ERROR_UNSUPPORTED_WEAVE_FEATURE);
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+    }
+
+    sIsActive = true;
+
+exit:
+    return err;
+}
+
+/**
+ * Stop capturing log messages, stop the background thread if any,
+ * and write out whatever is left in the ring.
+ */
+NL_DLL_EXPORT void StopDeferredLogging(void)
+{
+    sIsActive = false;
+    __sync_synchronize();
+
+#if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+    if (sIsDrainThreadRunning)
+    {
+        sIsDrainThreadRunning = false;
+        pthread_join(sDrainThread, NULL);
+    }
+#endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+    if (sIsRingInitialized)
+    {
+        DrainDeferredLog();
+    }
+}
+
+NL_DLL_EXPORT bool IsDeferredLoggingActive(void)
+{
+    return sIsActive;
+}
+
+/**
+ * Record a log message into the deferred logging ring. This is
+ * called by Log() and doesn't format anything.
+ *
+ * @return true if the message has been taken care of, i.e. recorded,
+ *         or dropped because the ring was full. false if deferred
+ *         logging isn't active, or the message uses a conversion
+ *         that cannot be deferred, in which case the caller should
+ *         log it synchronously.
+ */
+NL_DLL_EXPORT bool CaptureDeferredLog(uint8_t aModule, uint8_t aCategory, const char *aFormat, va_list aArgs)
+{
+    uint8_t args[WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE];
+    ArgBuffer argBuf(args, sizeof(args));
+    DeferredLogRecord *record;
+    uint32_t timeSec = 0;
+    uint32_t timeUsec = 0;
+    uint32_t pos;
+    bool isTruncated = false;
+
+    if (!sIsActive)
+        return false;
+
+    // Pack the arguments before claiming a slot, since a claimed slot cannot be given back
+    if (!PackArgs(aFormat, aArgs, argBuf, isTruncated))
+        return false;
+
+#if HAVE_SYS_TIME_H
+    {
+        struct timeval tv;
+
+        if (gettimeofday(&tv, NULL) == 0)
+        {
+            timeSec = static_cast<uint32_t>(tv.tv_sec);
+            timeUsec = static_cast<uint32_t>(tv.tv_usec);
+        }
+    }
+#endif // HAVE_SYS_TIME_H
+
+    // Claim a slot: the one at sEnqueuePos is free once the consumer has moved its sequence to pos
+    pos = sEnqueuePos;
+    for (;;)
+    {
+        int32_t diff;
+
+        record = &sRing[pos & kRingMask];
+        diff = static_cast<int32_t>(record->mSequence - pos);
+        __sync_synchronize();
+
+        if (diff == 0)
+        {
+            if (__sync_bool_compare_and_swap(&sEnqueuePos, pos, pos + 1))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Full; dropping keeps the caller from ever blocking
+            __sync_fetch_and_add(&sDropCount, 1);
+            return true;
+        }
+
+        pos = sEnqueuePos;
+    }
+
+    record->mModule = aModule;
+    record->mCategory = aCategory;
+    record->mIsTruncated = isTruncated;
+    record->mArgsLen = static_cast<uint16_t>(argBuf.GetLength());
+    record->mTimeSec = timeSec;
+    record->mTimeUsec = timeUsec;
+    record->mFormat = aFormat;
+    memcpy(record->mArgs, args, argBuf.GetLength());
+
+    __sync_synchronize();
+    record->mSequence = pos + 1;
+
+    return true;
+}
+
+/**
+ * Copy the oldest record out of the deferred logging ring and free
+ * its slot. Only one consumer may pop at a time.
+ *
+ * @return true if a record was popped, false if the ring is empty.
+ */
+NL_DLL_EXPORT bool PopDeferredLogRecord(DeferredLogRecord &aRecord)
+{
+    const uint32_t pos = sDequeuePos;
+    DeferredLogRecord &slot = sRing[pos & kRingMask];
+    int32_t diff = static_cast<int32_t>(slot.mSequence - (pos + 1));
+
+    __sync_synchronize();
+
+    if (!sIsRingInitialized || diff < 0)
+        return false;
+
+    aRecord.mModule = slot.mModule;
+    aRecord.mCategory = slot.mCategory;
+    aRecord.mIsTruncated = slot.mIsTruncated;
+    aRecord.mArgsLen = slot.mArgsLen;
+    aRecord.mTimeSec = slot.mTimeSec;
+    aRecord.mTimeUsec = slot.mTimeUsec;
+    aRecord.mFormat = slot.mFormat;
+    memcpy(aRecord.mArgs, slot.mArgs, slot.mArgsLen);
+
+    __sync_synchronize();
+    slot.mSequence = pos + kRingMask + 1;
+    sDequeuePos = pos + 1;
+
+    return true;
+}
+
+/**
+ * Format a record popped from the deferred logging ring, the way
+ * vsnprintf would have formatted the original message.
+ *
+ * @param[in]  aRecord   The record to format.
+ * @param[out] aBuf      The buffer receiving the NUL-terminated text.
+ * @param[in]  aBufSize  The size of @a aBuf.
+ *
+ * @return The length of the text written to @a aBuf.
+ */
+NL_DLL_EXPORT size_t FormatDeferredLogRecord(const DeferredLogRecord &aRecord, char *aBuf, size_t aBufSize)
+{
+    ArgBuffer argBuf(const_cast<uint8_t *>(aRecord.mArgs), aRecord.mArgsLen);
+    const char *format = aRecord.mFormat;
+    bool isTruncated = false;
+    size_t pos = 0;
+
+    VerifyOrExit(aBufSize > 0, );
+
+    aBuf[0] = '\0';
+
+    while (*format != '\0' && !isTruncated && pos < aBufSize - 1)
+    {
+        ConversionSpec spec;
+
+        if (*format != '%')
+        {
+            aBuf[pos++] = *format++;
+            continue;
+        }
+
+        format++;
+        ParseConversionSpec(format, spec);
+
+        if (spec.mClass == kArgClass_None)
+        {
+            aBuf[pos++] = '%';
+            continue;
+        }
+
+        AppendConversion(spec, argBuf, aBuf, aBufSize, pos, isTruncated);
+    }
+
+    aBuf[pos] = '\0';
+
+    if (isTruncated || aRecord.mIsTruncated)
+    {
+        int len = snprintf(aBuf + pos, aBufSize - pos, "...");
+        if (len > 0)
+            pos += static_cast<size_t>(len);
+        if (pos >= aBufSize)
+            pos = aBufSize - 1;
+    }
+
+exit:
+    return pos;
+}
+
+/**
+ * Format and write out all the records currently in the deferred
+ * logging ring, preceded by a note on the number of messages
+ * dropped since the last drain, if any. Concurrent callers return
+ * immediately.
+ *
+ * @return The number of records written out.
+ */
+NL_DLL_EXPORT size_t DrainDeferredLog(void)
+{
+    DeferredLogRecord record;
+    char msg[256];
+    size_t numDrained = 0;
+    uint32_t dropCount;
+
+    if (!__sync_bool_compare_and_swap(&sIsDraining, 0, 1))
+        return 0;
+
+    while (PopDeferredLogRecord(record))
+    {
+        FormatDeferredLogRecord(record, msg, sizeof(msg));
+        EmitDeferredLog(record.mModule, record.mCategory, record.mTimeSec, record.mTimeUsec, msg);
+        numDrained++;
+    }
+
+    dropCount = sDropCount;
+    if (dropCount != sReportedDropCount)
+    {
+        snprintf(msg, sizeof(msg), "%u log messages dropped", static_cast<unsigned>(dropCount - sReportedDropCount));
+        EmitDeferredLog(kLogModule_Support, kLogCategory_Error, 0, 0, msg);
+        sReportedDropCount = dropCount;
+    }
+
+    __sync_synchronize();
+    sIsDraining = 0;
+
+    return numDrained;
+}
+
+/**
+ * Get the number of messages dropped so far because the deferred
+ * logging ring was full.
+ */
+NL_DLL_EXPORT uint32_t GetDeferredLogDropCount(void)
+{
+    return sDropCount;
+}
+
+} // namespace Logging
+} // namespace Weave
+} // namespace nl
+
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING
@@ -0,0 +1,107 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file defines the deferred logging backend of the Weave SDK
+ *      logging interface.
+ *
+ *      When deferred logging is started, nl::Weave::Logging::Log no
+ *      longer formats messages on the calling thread. It records the
+ *      module, category, timestamp, format string pointer, and raw
+ *      arguments of each message into a fixed-size, lock-free ring,
+ *      which is drained, formatted, and written out later, either by
+ *      a background thread or by explicit calls to DrainDeferredLog().
+ *
+ *      The WeaveLogError(), WeaveLogProgress(), WeaveLogDetail(), and
+ *      WeaveLogRetain() macros are unaffected. Format strings are
+ *      expected to be string literals, which outlive the record;
+ *      string arguments are copied into the record.
+ *
+ */
+
+#ifndef WEAVEDEFERREDLOGGING_H_
+#define WEAVEDEFERREDLOGGING_H_
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <Weave/Core/WeaveConfig.h>
+#include <Weave/Core/WeaveError.h>
+
+#if WEAVE_CONFIG_DEFERRED_LOGGING
+
+#if (WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS & (WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS - 1)) != 0
+#error "WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS must be a power of two"
+#endif
+
+namespace nl {
+namespace Weave {
+namespace Logging {
+
+/**
+ *  @struct DeferredLogRecord
+ *
+ *  @brief
+ *    One message captured by the deferred logging backend.
+ *
+ *    The arguments are packed back to back, in the order of the
+ *    conversion specifications of the format string: integers as
+ *    64-bit values, floating point numbers as doubles, pointers as
+ *    such, and strings as a 16-bit length followed by the characters.
+ *
+ */
+struct DeferredLogRecord
+{
+    /**
+     *  Sequence number that coordinates producers and the consumer
+     *  of the ring slot holding this record.
+     */
+    volatile uint32_t mSequence;
+
+    uint8_t mModule;                /**< The LogModule of the message. */
+    uint8_t mCategory;              /**< The LogCategory of the message. */
+    uint8_t mIsTruncated;           /**< Non-zero if some arguments didn't fit. */
+    uint16_t mArgsLen;              /**< Number of bytes used in mArgs. */
+    uint32_t mTimeSec;              /**< Capture time, seconds since the epoch. */
+    uint32_t mTimeUsec;             /**< Capture time, microseconds part. */
+    const char *mFormat;            /**< The format string of the message. */
+    uint8_t mArgs[WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE];
+};
+
+extern WEAVE_ERROR StartDeferredLogging(bool aStartThread);
+extern void StopDeferredLogging(void);
+extern bool IsDeferredLoggingActive(void);
+
+extern bool CaptureDeferredLog(uint8_t aModule, uint8_t aCategory, const char *aFormat, va_list aArgs);
+extern bool PopDeferredLogRecord(DeferredLogRecord &aRecord);
+extern size_t FormatDeferredLogRecord(const DeferredLogRecord &aRecord, char *aBuf, size_t aBufSize);
+extern size_t DrainDeferredLog(void);
+extern uint32_t GetDeferredLogDropCount(void);
+
+// Writes out a message drained from the ring; implemented by the logging style in WeaveLogging.cpp
+extern void EmitDeferredLog(uint8_t aModule, uint8_t aCategory, uint32_t aTimeSec, uint32_t aTimeUsec, const char *aMsg);
+
+} // namespace Logging
+} // namespace Weave
+} // namespace nl
+
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING
+
+#endif /* WEAVEDEFERREDLOGGING_H_ */
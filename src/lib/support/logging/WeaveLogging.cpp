@@ -31,6 +31,7 @@
 #include <Weave/Core/WeaveCore.h>
 #include <Weave/Support/CodeUtils.h>
 #include "WeaveLogging.h"
+#include "DeferredLogging.h"
 
 #if WEAVE_LOGGING_STYLE_ANDROID && defined(__ANDROID__)
 #include <android/log.h>
@@ -110,20 +111,13 @@ void GetMessageWithPrefix(char *buf, uint8_t bufSize, uint8_t module, const char
     snprintf(buf, bufSize, WeavePrefix "%s" WeavePrefixSeparator "%s" WeaveMessageTrailer, moduleName, msg);
 }
 
-void PrintMessagePrefix(uint8_t module)
-{
-    char moduleName[nlWeaveLoggingModuleNameLen + 1];
-    GetModuleName(moduleName, module);
-
 #if WEAVE_LOGGING_STYLE_STDIO_WITH_TIMESTAMPS
-    struct timeval tv;
+static void PrintMessagePrefixAt(const char *moduleName, const struct timeval &tv)
+{
     struct tm* time_ptr;
     char detailed_time[30];
     int64_t milliseconds;
-    int status;
-
-    status = gettimeofday(&tv, NULL);
-    VerifyOrExit(status == 0, perror("gettimeofday"));
+    int status = 0;
 
     time_ptr = localtime(&tv.tv_sec);
     VerifyOrExit(time_ptr != NULL, status = -1; perror("localtime"));
@@ -139,6 +133,28 @@ exit:
     {
         printf("\?\?\?\?-\?\?-\?\? \?\?:\?\?:\?\?.\?\?\?+\?\?\?\?" WeavePrefix "%s: ", moduleName);
     }
+}
+#endif // WEAVE_LOGGING_STYLE_STDIO_WITH_TIMESTAMPS
+
+void PrintMessagePrefix(uint8_t module)
+{
+    char moduleName[nlWeaveLoggingModuleNameLen + 1];
+    GetModuleName(moduleName, module);
+
+#if WEAVE_LOGGING_STYLE_STDIO_WITH_TIMESTAMPS
+    struct timeval tv;
+    int status;
+
+    status = gettimeofday(&tv, NULL);
+    if (status != 0)
+    {
+        perror("gettimeofday");
+        printf("\?\?\?\?-\?\?-\?\? \?\?:\?\?:\?\?.\?\?\?+\?\?\?\?" WeavePrefix "%s: ", moduleName);
+    }
+    else
+    {
+        PrintMessagePrefixAt(moduleName, tv);
+    }
 
 #else // !WEAVE_LOGGING_STYLE_STDIO_WITH_TIMESTAMPS
 
@@ -213,6 +229,12 @@ NL_DLL_EXPORT __WEAVE_LOGGING_LINK_ATTRIBUTE void Log(uint8_t module, uint8_t ca
 
 #elif WEAVE_LOGGING_STYLE_STDIO || WEAVE_LOGGING_STYLE_STDIO_WEAK
 
+#if WEAVE_CONFIG_DEFERRED_LOGGING
+        // Formatting and output are left to whoever drains the ring
+        if (IsDeferredLoggingActive() && CaptureDeferredLog(module, category, msg, v))
+            ExitNow();
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING
+
         PrintMessagePrefix(module);
         vprintf(msg, v);
         printf("\n");
@@ -225,8 +247,52 @@ NL_DLL_EXPORT __WEAVE_LOGGING_LINK_ATTRIBUTE void Log(uint8_t module, uint8_t ca
 
     }
 
+#if WEAVE_CONFIG_DEFERRED_LOGGING && (WEAVE_LOGGING_STYLE_STDIO || WEAVE_LOGGING_STYLE_STDIO_WEAK)
+exit:
+#endif
     va_end(v);
 }
+
+#if WEAVE_CONFIG_DEFERRED_LOGGING && (WEAVE_LOGGING_STYLE_STDIO || WEAVE_LOGGING_STYLE_STDIO_WEAK)
+/**
+ * Write out a message drained from the deferred logging ring, with
+ * the prefix it would have had if it had been logged synchronously
+ * at the time it was captured.
+ *
+ * @param[in] aModule     The LogModule of the message.
+ * @param[in] aCategory   The LogCategory of the message.
+ * @param[in] aTimeSec    The capture time, in seconds since the epoch.
+ * @param[in] aTimeUsec   The microseconds part of the capture time.
+ * @param[in] aMsg        The formatted message.
+ *
+ */
+NL_DLL_EXPORT void EmitDeferredLog(uint8_t aModule, uint8_t aCategory, uint32_t aTimeSec, uint32_t aTimeUsec, const char *aMsg)
+{
+    char moduleName[nlWeaveLoggingModuleNameLen + 1];
+    GetModuleName(moduleName, aModule);
+
+#if WEAVE_LOGGING_STYLE_STDIO_WITH_TIMESTAMPS
+    struct timeval tv;
+
+    if (aTimeSec == 0 && aTimeUsec == 0)
+    {
+        gettimeofday(&tv, NULL);
+    }
+    else
+    {
+        tv.tv_sec = aTimeSec;
+        tv.tv_usec = aTimeUsec;
+    }
+
+    PrintMessagePrefixAt(moduleName, tv);
+#else
+    printf(WeavePrefix "%s: ", moduleName);
+#endif // WEAVE_LOGGING_STYLE_STDIO_WITH_TIMESTAMPS
+
+    printf("%s\n", aMsg);
+}
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING && (WEAVE_LOGGING_STYLE_STDIO || WEAVE_LOGGING_STYLE_STDIO_WEAK)
+
 #endif /* !WEAVE_LOGGING_STYLE_EXTERNAL */
 
 NL_DLL_EXPORT uint8_t GetLogFilter()
@@ -394,6 +394,18 @@ struct LwIPEvent;
 #define WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS 0
 #endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
 
+/**
+ *  @def WEAVE_SYSTEM_CONFIG_STATS_HISTOGRAM_BUCKETS
+ *
+ *  @brief
+ *      This is the number of buckets of each latency histogram gathered when WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS is asserted.
+ *      Bucket @a i counts the samples in [2^i, 2^(i+1)) microseconds, except for the first bucket, which also counts the
+ *      samples of 0, and the last, which also counts all longer samples. The default covers samples of up to about 8 seconds.
+ */
+#ifndef WEAVE_SYSTEM_CONFIG_STATS_HISTOGRAM_BUCKETS
+#define WEAVE_SYSTEM_CONFIG_STATS_HISTOGRAM_BUCKETS 24
+#endif // WEAVE_SYSTEM_CONFIG_STATS_HISTOGRAM_BUCKETS
+
 /**
  *  @def WEAVE_SYSTEM_CONFIG_TEST
  *
@@ -30,6 +30,7 @@
 
 // Include local headers
 #include <SystemLayer/SystemTimer.h>
+#include <SystemLayer/SystemStats.h>
 
 // Include additional Weave headers
 #include <Weave/Support/logging/WeaveLogging.h>
@@ -102,6 +103,10 @@ Layer::Layer()
     this->mWakePipeIn = 0;
     this->mWakePipeOut = 0;
 
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    this->mSelectResultTime = 0;
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     this->mHandleSelectThread = PTHREAD_NULL;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
@@ -387,6 +392,16 @@ void Layer::PrepareSelect(int& aSetSize, fd_set* aReadSet, fd_set* aWriteSet, fd
 
     FD_SET(this->mWakePipeIn, aReadSet);
 
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    // The event loop is about to wait again; the iteration that started in HandleSelectResult() is over
+    if (this->mSelectResultTime != 0)
+    {
+        SYSTEM_STATS_HISTOGRAM_RECORD(Stats::kHistogram_EventLoopIterationTime,
+            static_cast<uint32_t>(Stats::GetTimestampUsec() - this->mSelectResultTime));
+        this->mSelectResultTime = 0;
+    }
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
     const Timer::Epoch kCurrentEpoch = Timer::GetCurrentEpoch();
     Timer::Epoch lAwakenEpoch = kCurrentEpoch + aSleepTime.tv_sec * 1000 + aSleepTime.tv_usec / 1000;
 
@@ -439,6 +454,10 @@ void Layer::HandleSelectResult(int aSetSize, fd_set* aReadSet, fd_set* aWriteSet
     if (aSetSize < 0)
         return;
 
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    this->mSelectResultTime = Stats::GetTimestampUsec();
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     lThreadSelf = pthread_self();
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
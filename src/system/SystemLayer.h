@@ -195,6 +195,11 @@ private:
 #if WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
     pthread_t mHandleSelectThread;
 #endif // WEAVE_SYSTEM_CONFIG_POSIX_LOCKING
+
+#if WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
+    // When the event loop last woke up from select(), or 0 if it is waiting in select()
+    uint64_t mSelectResultTime;
+#endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
 #endif // WEAVE_SYSTEM_CONFIG_USE_SOCKETS
 
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
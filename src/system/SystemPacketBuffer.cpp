@@ -298,6 +298,65 @@ void PacketBuffer::CompactHead()
     }
 }
 
+/**
+ * Move just enough data from subsequent buffers in the chain into the current buffer for it to hold the first \c aLength bytes of
+ * the chain contiguously.
+ *
+ *  Unlike CompactHead(), data beyond the first \c aLength bytes of the chain is left in place, and the data within the current
+ *  buffer is only moved to the front of the buffer if there is not enough space after it. If a subsequent buffer in the chain is
+ *  moved into the current buffer in its entirety, it is removed from the chain and freed.
+ *
+ *  @param[in] aLength - the number of bytes required at the start of the current buffer.
+ *
+ *  @return \c true if the current buffer holds at least \c aLength bytes, or \c false if the chain does not contain enough data or
+ *      the current buffer cannot hold that many bytes. On failure, the chain is left unmodified.
+ */
+bool PacketBuffer::PullUpHead(uint16_t aLength)
+{
+    uint8_t* const kStart = reinterpret_cast<uint8_t*>(this) + WEAVE_SYSTEM_PACKETBUFFER_HEADER_SIZE;
+    uint32_t lChainLength = 0;
+
+    if (this->len >= aLength)
+        return true;
+
+    if (aLength > static_cast<uint32_t>(this->MaxDataLength()) + this->ReservedSize())
+        return false;
+
+    for (const PacketBuffer* lCursor = this; lCursor != NULL && lChainLength < aLength; lCursor = lCursor->Next())
+        lChainLength += lCursor->len;
+
+    if (lChainLength < aLength)
+        return false;
+
+    if (this->AvailableDataLength() < aLength - this->len)
+    {
+        memmove(kStart, this->payload, this->len);
+        this->payload = kStart;
+    }
+
+    while (this->len < aLength)
+    {
+        PacketBuffer& lNextPacket = *static_cast<PacketBuffer*>(this->next);
+        VerifyOrDieWithMsg(lNextPacket.ref == 1, WeaveSystemLayer, "next buffer %p is not exclusive to this chain", &lNextPacket);
+
+        uint16_t lMoveLength = lNextPacket.len;
+        if (lMoveLength > aLength - this->len)
+            lMoveLength = aLength - this->len;
+
+        memcpy(static_cast<uint8_t*>(this->payload) + this->len, lNextPacket.payload, lMoveLength);
+
+        lNextPacket.payload = (uint8_t *) lNextPacket.payload + lMoveLength;
+        this->len += lMoveLength;
+        lNextPacket.len -= lMoveLength;
+        lNextPacket.tot_len -= lMoveLength;
+
+        if (lNextPacket.len == 0)
+            this->next = this->FreeHead(&lNextPacket);
+    }
+
+    return true;
+}
+
 /**
  * Adjust the current buffer to indicate the amount of data consumed.
  *
@@ -115,6 +115,7 @@ public:
     void AddToEnd(PacketBuffer* aPacket);
     PacketBuffer* DetachTail(void);
     void CompactHead(void);
+    bool PullUpHead(uint16_t aLength);
     PacketBuffer* Consume(uint16_t aConsumeLength);
     void ConsumeHead(uint16_t aConsumeLength);
     bool EnsureReservedSize(uint16_t aReservedSize);
@@ -33,6 +33,10 @@
 
 #include <string.h>
 
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && HAVE_CLOCK_GETTIME && HAVE_DECL_CLOCK_MONOTONIC
+#include <time.h>
+#endif
+
 namespace nl {
 namespace Weave {
 namespace System {
@@ -64,8 +68,19 @@ static const char *sStatsStrings[nl::Weave::System::Stats::kNumEntries] =
     "kWDMNext_NumCommands",
 };
 
+static const char *sHistogramStrings[nl::Weave::System::Stats::kNumHistograms] =
+{
+    "MessageLayer_EncodeTime",
+    "MessageLayer_DecodeTime",
+    "ExchangeMgr_DispatchTime",
+    "ExchangeMgr_WRMPRoundTripTime",
+    "WDMNext_NotifyBuildTime",
+    "SystemLayer_EventLoopIterationTime",
+};
+
 count_t sResourcesInUse[kNumEntries];
 count_t sHighWatermarks[kNumEntries];
+Histogram sHistograms[kNumHistograms];
 
 const char **GetStrings(void)
 {
@@ -82,10 +97,134 @@ count_t *GetHighWatermarks(void)
     return sHighWatermarks;
 }
 
+const char **GetHistogramStrings(void)
+{
+    return sHistogramStrings;
+}
+
+Histogram *GetHistograms(void)
+{
+    return sHistograms;
+}
+
+void ResetHistograms(void)
+{
+    for (int i = 0; i < kNumHistograms; i++)
+    {
+        sHistograms[i].Reset();
+    }
+}
+
+/**
+ * Returns a monotonic timestamp, in microseconds, for timing the
+ * samples of the latency histograms. The resolution falls back to
+ * that of the system timers where no finer clock is available.
+ */
+uint64_t GetTimestampUsec(void)
+{
+#if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && HAVE_CLOCK_GETTIME && HAVE_DECL_CLOCK_MONOTONIC
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (static_cast<uint64_t>(ts.tv_sec) * 1000000) + (static_cast<uint64_t>(ts.tv_nsec) / 1000);
+#else
+    return static_cast<uint64_t>(Timer::GetCurrentEpoch()) * 1000;
+#endif
+}
+
+/**
+ * Returns the index of the bucket counting a sample.
+ *
+ * @param[in] aValue    The sample, in microseconds.
+ */
+uint8_t Histogram::GetBucket(uint32_t aValue)
+{
+    uint8_t bucket = 0;
+
+    while (aValue > 1 && bucket < kNumBuckets - 1)
+    {
+        aValue >>= 1;
+        bucket++;
+    }
+
+    return bucket;
+}
+
+/**
+ * Returns the exclusive upper bound, in microseconds, of the samples
+ * counted by a bucket, or UINT32_MAX for the last bucket.
+ */
+uint32_t Histogram::GetBucketUpperBound(uint8_t aBucket)
+{
+    return (aBucket >= kNumBuckets - 1 || aBucket >= 31) ? UINT32_MAX : (static_cast<uint32_t>(2) << aBucket);
+}
+
+void Histogram::Record(uint32_t aValue)
+{
+    if (mCount == 0 || aValue < mMin)
+    {
+        mMin = aValue;
+    }
+
+    if (aValue > mMax)
+    {
+        mMax = aValue;
+    }
+
+    mCount++;
+    mSum += aValue;
+    mBuckets[GetBucket(aValue)]++;
+}
+
+void Histogram::Reset(void)
+{
+    memset(this, 0, sizeof(*this));
+}
+
+/**
+ * Returns an estimate of a percentile of the samples: the upper bound
+ * of the bucket holding it, capped by the largest sample.
+ *
+ * @param[in] aPercent  The percentile, from 0 to 100.
+ *
+ * @return The estimate in microseconds, or 0 if there are no samples.
+ */
+uint32_t Histogram::GetPercentile(uint8_t aPercent) const
+{
+    uint64_t rank;
+    uint64_t seen = 0;
+    uint32_t retval = 0;
+
+    if (mCount == 0)
+        return 0;
+
+    if (aPercent > 100)
+        aPercent = 100;
+
+    // The rank of the sample, rounded up so that the 100th percentile is the last sample
+    rank = (static_cast<uint64_t>(mCount) * aPercent + 99) / 100;
+    if (rank == 0)
+        rank = 1;
+
+    for (uint8_t i = 0; i < kNumBuckets; i++)
+    {
+        seen += mBuckets[i];
+        if (seen >= rank)
+        {
+            retval = GetBucketUpperBound(i);
+            break;
+        }
+    }
+
+    return (retval > mMax) ? mMax : retval;
+}
+
 void UpdateSnapshot(Snapshot &aSnapshot)
 {
     memcpy(&aSnapshot.mResourcesInUse, &sResourcesInUse, sizeof(aSnapshot.mResourcesInUse));
     memcpy(&aSnapshot.mHighWatermarks, &sHighWatermarks, sizeof(aSnapshot.mHighWatermarks));
+    memcpy(&aSnapshot.mHistograms, &sHistograms, sizeof(aSnapshot.mHistograms));
 
     nl::Weave::System::Timer::GetStatistics(aSnapshot.mResourcesInUse[kSystemLayer_NumTimers]);
 
@@ -117,6 +256,21 @@ bool Difference(Snapshot &result, Snapshot &after, Snapshot &before)
         }
     }
 
+    // The samples recorded in between; min and max can only be those of the later snapshot
+    for (i = 0; i < kNumHistograms; i++)
+    {
+        Histogram &delta = result.mHistograms[i];
+
+        delta = after.mHistograms[i];
+        delta.mCount -= before.mHistograms[i].mCount;
+        delta.mSum -= before.mHistograms[i].mSum;
+
+        for (int j = 0; j < Histogram::kNumBuckets; j++)
+        {
+            delta.mBuckets[j] -= before.mHistograms[i].mBuckets[j];
+        }
+    }
+
     return leak;
 }
 
@@ -69,17 +69,81 @@ enum
     kNumEntries
 };
 
+enum
+{
+    kHistogram_MessageEncodeTime,
+    kHistogram_MessageDecodeTime,
+    kHistogram_ExchangeDispatchTime,
+    kHistogram_WRMPRoundTripTime,
+    kHistogram_NotifyBuildTime,
+    kHistogram_EventLoopIterationTime,
+
+    kNumHistograms
+};
+
 typedef int32_t count_t;
 
 extern count_t ResourcesInUse[kNumEntries];
 extern count_t HighWatermarks[kNumEntries];
 
+/**
+ *  @class Histogram
+ *
+ *  @brief
+ *    A fixed-size, log-scale histogram of durations in microseconds.
+ *
+ *    Recording a sample costs a few instructions and no memory
+ *    allocation, so that histograms can be kept on hot paths.
+ */
+class Histogram
+{
+public:
+    enum
+    {
+        kNumBuckets = WEAVE_SYSTEM_CONFIG_STATS_HISTOGRAM_BUCKETS
+    };
+
+    uint32_t mCount;                    /**< Number of samples. */
+    uint32_t mMin;                      /**< Smallest sample, valid if mCount is non-zero. */
+    uint32_t mMax;                      /**< Largest sample. */
+    uint64_t mSum;                      /**< Sum of the samples. */
+    uint32_t mBuckets[kNumBuckets];     /**< Number of samples per bucket. */
+
+    void Record(uint32_t aValue);
+    void Reset(void);
+    uint32_t GetPercentile(uint8_t aPercent) const;
+
+    static uint8_t GetBucket(uint32_t aValue);
+    static uint32_t GetBucketUpperBound(uint8_t aBucket);
+};
+
+Histogram *GetHistograms(void);
+uint64_t GetTimestampUsec(void);
+
+/**
+ *  @class HistogramTimer
+ *
+ *  @brief
+ *    Records the lifetime of the object into a histogram.
+ */
+class HistogramTimer
+{
+public:
+    HistogramTimer(int aHistogram) : mHistogram(aHistogram), mStart(GetTimestampUsec()) { }
+    ~HistogramTimer(void) { GetHistograms()[mHistogram].Record(static_cast<uint32_t>(GetTimestampUsec() - mStart)); }
+
+private:
+    int mHistogram;
+    uint64_t mStart;
+};
+
 class Snapshot
 {
 public:
 
     count_t mResourcesInUse[kNumEntries];
     count_t mHighWatermarks[kNumEntries];
+    Histogram mHistograms[kNumHistograms];
 };
 
 bool Difference(Snapshot &result, Snapshot &after, Snapshot &before);
@@ -88,6 +152,9 @@ count_t *GetResourcesInUse(void);
 count_t *GetHighWatermarks(void);
 const char **GetStrings(void);
 
+const char **GetHistogramStrings(void);
+void ResetHistograms(void);
+
 } // namespace Stats
 } // namespace System
 } // namespace Weave
@@ -128,7 +195,17 @@ const char **GetStrings(void);
         nl::Weave::System::Stats::GetResourcesInUse()[entry] = 0; \
     } while (0);
 
+#define SYSTEM_STATS_HISTOGRAM_RECORD(entry, value) \
+    do { \
+        nl::Weave::System::Stats::GetHistograms()[entry].Record(value); \
+    } while (0);
 
+/*
+ * Records the time from this point to the end of the enclosing scope.
+ * Since this declares a variable, it must not be jumped over by a goto.
+ */
+#define SYSTEM_STATS_HISTOGRAM_TIMER(entry) \
+    nl::Weave::System::Stats::HistogramTimer _systemStatsHistogramTimer(entry)
 
 #else // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
 
@@ -140,6 +217,10 @@ const char **GetStrings(void);
 
 #define SYSTEM_STATS_RESET(entry)
 
+#define SYSTEM_STATS_HISTOGRAM_RECORD(entry, value)
+
+#define SYSTEM_STATS_HISTOGRAM_TIMER(entry)
+
 #endif // WEAVE_SYSTEM_CONFIG_PROVIDE_STATISTICS
 
 #endif // defined(SYSTEMSTATS_H)
@@ -0,0 +1,192 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a simple greedy generator of Weave delta
+ *      image patches.  Every offset of the base image is indexed by a
+ *      hash of the block that starts there; the target image is then
+ *      scanned and each block found in the base is extended as far as
+ *      it matches and emitted as a copy, with everything else emitted
+ *      as inserted literal data.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+
+#include "DeltaImageGenerator.h"
+#include <Weave/Core/WeaveEncoding.h>
+#include <Weave/Profiles/ProfileCommon.h>
+#include <Weave/Profiles/software-update/DeltaImageApplier.h>
+#include <Weave/Support/CodeUtils.h>
+
+using namespace nl::Weave::Profiles::SoftwareUpdate;
+
+// Shortest run of the base image worth encoding as a copy.
+#define DELTA_MIN_MATCH_LENGTH  16
+
+static uint32_t HashBlock(const uint8_t *p)
+{
+    uint32_t hash = 2166136261UL;
+
+    for (int i = 0; i < DELTA_MIN_MATCH_LENGTH; i++)
+        hash = (hash ^ p[i]) * 16777619UL;
+
+    return hash;
+}
+
+static void Append32(std::vector<uint8_t> &patch, uint32_t val)
+{
+    uint8_t buf[4];
+
+    nl::Weave::Encoding::LittleEndian::Put32(buf, val);
+    patch.insert(patch.end(), buf, buf + sizeof(buf));
+}
+
+static void AppendInsert(std::vector<uint8_t> &patch, const uint8_t *data, uint32_t len)
+{
+    if (len == 0)
+        return;
+
+    patch.push_back(kDeltaOp_Insert);
+    Append32(patch, len);
+    patch.insert(patch.end(), data, data + len);
+}
+
+static void AppendCopy(std::vector<uint8_t> &patch, uint32_t offset, uint32_t len)
+{
+    patch.push_back(kDeltaOp_Copy);
+    Append32(patch, offset);
+    Append32(patch, len);
+}
+
+WEAVE_ERROR GenerateDeltaImage(const uint8_t *base, uint32_t baseLen, const uint8_t *target, uint32_t targetLen,
+                               std::vector<uint8_t> &patch)
+{
+    std::vector<int32_t> index;
+    uint32_t mask;
+    uint32_t pos = 0;
+    uint32_t literalStart = 0;
+
+    patch.clear();
+    Append32(patch, kDeltaImageMagic);
+    patch.push_back(kDeltaImageVersion);
+    Append32(patch, baseLen);
+    Append32(patch, targetLen);
+
+    // Index every offset of the base image; later offsets replace earlier ones on collision.
+    for (mask = 1023; mask < baseLen * 2 && mask < 0x7FFFFFFF; mask = (mask << 1) | 1)
+        ;
+    index.assign(mask + 1, -1);
+    for (uint32_t i = 0; i + DELTA_MIN_MATCH_LENGTH <= baseLen; i++)
+        index[HashBlock(base + i) & mask] = (int32_t) i;
+
+    while (pos + DELTA_MIN_MATCH_LENGTH <= targetLen)
+    {
+        int32_t candidate = index[HashBlock(target + pos) & mask];
+        uint32_t matchLen = 0;
+
+        if (candidate >= 0)
+        {
+            while ((uint32_t) candidate + matchLen < baseLen && pos + matchLen < targetLen &&
+                   base[candidate + matchLen] == target[pos + matchLen])
+                matchLen++;
+        }
+
+        if (matchLen >= DELTA_MIN_MATCH_LENGTH)
+        {
+            AppendInsert(patch, target + literalStart, pos - literalStart);
+            AppendCopy(patch, (uint32_t) candidate, matchLen);
+            pos += matchLen;
+            literalStart = pos;
+        }
+        else
+        {
+            pos++;
+        }
+    }
+
+    AppendInsert(patch, target + literalStart, targetLen - literalStart);
+    patch.push_back(kDeltaOp_End);
+
+    return WEAVE_NO_ERROR;
+}
+
+static WEAVE_ERROR ReadFile(const char *path, std::vector<uint8_t> &data)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t block[512];
+    size_t bytesRead;
+    FILE *file;
+
+    file = fopen(path, "r");
+    if (file == NULL)
+    {
+        printf("Unable to open %s: %s\n", path, strerror(errno));
+        ExitNow(err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+
+    data.clear();
+    while ((bytesRead = fread(block, 1, sizeof(block), file)) > 0)
+        data.insert(data.end(), block, block + bytesRead);
+
+    VerifyOrExit(!ferror(file), err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+exit:
+    if (file != NULL)
+        fclose(file);
+
+    return err;
+}
+
+WEAVE_ERROR GenerateDeltaImageFile(const char *basePath, const char *targetPath, const char *patchPath, uint32_t &patchLen)
+{
+    WEAVE_ERROR err;
+    std::vector<uint8_t> base;
+    std::vector<uint8_t> target;
+    std::vector<uint8_t> patch;
+    FILE *file = NULL;
+
+    err = ReadFile(basePath, base);
+    SuccessOrExit(err);
+
+    err = ReadFile(targetPath, target);
+    SuccessOrExit(err);
+
+    err = GenerateDeltaImage(base.empty() ? NULL : &base[0], base.size(), target.empty() ? NULL : &target[0], target.size(), patch);
+    SuccessOrExit(err);
+
+    file = fopen(patchPath, "w");
+    if (file == NULL)
+    {
+        printf("Unable to create %s: %s\n", patchPath, strerror(errno));
+        ExitNow(err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+
+    VerifyOrExit(fwrite(&patch[0], 1, patch.size(), file) == patch.size(), err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    patchLen = patch.size();
+
+exit:
+    if (file != NULL)
+        fclose(file);
+
+    return err;
+}
@@ -0,0 +1,38 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file declares a host-side generator of Weave delta image
+ *      patches (see DeltaImageApplier.h for the format) used by the mock
+ *      Software Update server and its tests.
+ *
+ */
+
+#ifndef DELTAIMAGEGENERATOR_H_
+#define DELTAIMAGEGENERATOR_H_
+
+#include <vector>
+
+#include <Weave/Core/WeaveCore.h>
+
+WEAVE_ERROR GenerateDeltaImage(const uint8_t *base, uint32_t baseLen, const uint8_t *target, uint32_t targetLen,
+                               std::vector<uint8_t> &patch);
+WEAVE_ERROR GenerateDeltaImageFile(const char *basePath, const char *targetPath, const char *patchPath, uint32_t &patchLen);
+
+#endif /* DELTAIMAGEGENERATOR_H_ */
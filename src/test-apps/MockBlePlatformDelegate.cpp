@@ -16,52 +16,264 @@
  *    limitations under the License.
  */
 
+/**
+ *    @file
+ *      This file implements a mock BLE platform delegate, optionally
+ *      connected in loopback to a peer delegate.
+ *
+ */
+
+#include <string.h>
+
 #include <BleLayer/BlePlatformDelegate.h>
+#include <BleLayer/WoBle.h>
+#include <Weave/Support/CodeUtils.h>
 #include "MockBlePlatformDelegate.h"
 
-bool MockBlePlatformDelegate::SubscribeCharacteristic(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId)
+using nl::Ble::BleLayer;
+using nl::Ble::WeaveBleUUID;
+using nl::Ble::WoBle;
+using nl::Weave::System::PacketBuffer;
+
+MockBlePlatformDelegate::MockBlePlatformDelegate(void) :
+    mLayer(NULL),
+    mPeer(NULL),
+    mMTU(0),
+    mReceiveWindowSize(0),
+    mFirstPending(0),
+    mNumPending(0)
 {
-    // TODO mock implementation
-    return false;
+    ResetStats();
+}
+
+/**
+ *  Connect this delegate in loopback to a peer delegate.
+ *
+ *  GATT operations requested by \c aLayer through this delegate are queued until delivered to the
+ *  peer's BleLayer by DeliverPendingOperations() or RunConnectionEvent().
+ *
+ *  @param[in]  aLayer              The BleLayer that uses this delegate.
+ *  @param[in]  aPeer               The delegate of the BleLayer at the other end of the link.
+ *  @param[in]  aMTU                The ATT MTU to report for the link, or 0 if unknown.
+ *  @param[in]  aReceiveWindowSize  The BTP receive window to report for the link, or 0 if unknown.
+ */
+void MockBlePlatformDelegate::Connect(BleLayer *aLayer, MockBlePlatformDelegate *aPeer, uint16_t aMTU, uint8_t aReceiveWindowSize)
+{
+    Disconnect();
+
+    mLayer = aLayer;
+    mPeer = aPeer;
+    mMTU = aMTU;
+    mReceiveWindowSize = aReceiveWindowSize;
+    ResetStats();
 }
 
-bool MockBlePlatformDelegate::UnsubscribeCharacteristic(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId)
+/**
+ *  Disconnect this delegate from its peer, discarding any undelivered GATT operations.
+ */
+void MockBlePlatformDelegate::Disconnect(void)
 {
-    // TODO mock implementation
-    return false;
+    while (mNumPending > 0)
+    {
+        Operation &op = mPending[mFirstPending];
+
+        if (op.mBuf != NULL)
+        {
+            PacketBuffer::Free(op.mBuf);
+        }
+
+        mFirstPending = (mFirstPending + 1) % kMaxPendingOperations;
+        mNumPending--;
+    }
+
+    mFirstPending = 0;
+    mLayer = NULL;
+    mPeer = NULL;
+    mMTU = 0;
+    mReceiveWindowSize = 0;
+}
+
+/**
+ *  Deliver queued GATT operations to the peer, in order, and confirm them to the local BleLayer.
+ *
+ *  Operations queued while delivering are left for a later call.
+ *
+ *  @param[in]  aMaxOperations  The maximum number of operations to deliver.
+ *
+ *  @return The number of operations delivered.
+ */
+size_t MockBlePlatformDelegate::DeliverPendingOperations(size_t aMaxOperations)
+{
+    size_t numDelivered = 0;
+
+    while (numDelivered < aMaxOperations && mNumPending > 0)
+    {
+        Operation op = mPending[mFirstPending];
+
+        mFirstPending = (mFirstPending + 1) % kMaxPendingOperations;
+        mNumPending--;
+
+        Deliver(op);
+        numDelivered++;
+    }
+
+    return numDelivered;
+}
+
+/**
+ *  Simulate one BLE connection event: deliver the operations that each side of the link had queued
+ *  at its start. As writes and indications are confirmed in the event that carries them, each side
+ *  sends at most one of them per event.
+ *
+ *  @return The number of operations delivered.
+ */
+size_t MockBlePlatformDelegate::RunConnectionEvent(MockBlePlatformDelegate &aCentral, MockBlePlatformDelegate &aPeripheral)
+{
+    const size_t numCentral = aCentral.NumPendingOperations();
+    const size_t numPeripheral = aPeripheral.NumPendingOperations();
+
+    return aCentral.DeliverPendingOperations(numCentral) + aPeripheral.DeliverPendingOperations(numPeripheral);
+}
+
+void MockBlePlatformDelegate::ResetStats(void)
+{
+    memset(&mStats, 0, sizeof(mStats));
+}
+
+bool MockBlePlatformDelegate::Enqueue(OperationType aType, const WeaveBleUUID *aSvcId, const WeaveBleUUID *aCharId, PacketBuffer *aBuf)
+{
+    PacketBuffer *copy = NULL;
+    bool retval = false;
+
+    VerifyOrExit(mPeer != NULL && mNumPending < kMaxPendingOperations, );
+
+    if (aBuf != NULL)
+    {
+        const uint8_t flags = aBuf->Start()[0];
+
+        // Copy the characteristic value on the downcall, as the iOS and Android platforms do, since Weave reuses the
+        // message buffer for the fragments that follow.
+        copy = PacketBuffer::New(0);
+        VerifyOrExit(copy != NULL, );
+
+        memcpy(copy->Start(), aBuf->Start(), aBuf->DataLength());
+        copy->SetDataLength(aBuf->DataLength());
+
+        if (aType == kOperation_Write)
+            mStats.mWrites++;
+        else
+            mStats.mIndications++;
+
+        if ((flags & (WoBle::kHeaderFlag_StartMessage | WoBle::kHeaderFlag_ContinueMessage | WoBle::kHeaderFlag_EndMessage)) == 0)
+            mStats.mStandAloneAcks++;
+
+        mStats.mBytes += copy->DataLength();
+    }
+
+    {
+        Operation &op = mPending[(mFirstPending + mNumPending) % kMaxPendingOperations];
+
+        op.mType = aType;
+        op.mSvcId = aSvcId;
+        op.mCharId = aCharId;
+        op.mBuf = copy;
+        mNumPending++;
+    }
+
+    retval = true;
+
+exit:
+    if (aBuf != NULL)
+    {
+        PacketBuffer::Free(aBuf);
+    }
+
+    return retval;
+}
+
+void MockBlePlatformDelegate::Deliver(Operation &aOp)
+{
+    // Either BleLayer may close the connection while handling the operation, so capture both ends first.
+    BleLayer *localLayer = mLayer;
+    BleLayer *peerLayer = mPeer->mLayer;
+    BLE_CONNECTION_OBJECT localConnObj = GetConnectionObject();
+    BLE_CONNECTION_OBJECT peerConnObj = mPeer->GetConnectionObject();
+
+    switch (aOp.mType)
+    {
+    case kOperation_Subscribe:
+        peerLayer->HandleSubscribeReceived(peerConnObj, aOp.mSvcId, aOp.mCharId);
+        localLayer->HandleSubscribeComplete(localConnObj, aOp.mSvcId, aOp.mCharId);
+        break;
+
+    case kOperation_Unsubscribe:
+        peerLayer->HandleUnsubscribeReceived(peerConnObj, aOp.mSvcId, aOp.mCharId);
+        localLayer->HandleUnsubscribeComplete(localConnObj, aOp.mSvcId, aOp.mCharId);
+        break;
+
+    case kOperation_Write:
+        if (!peerLayer->HandleWriteReceived(peerConnObj, aOp.mSvcId, aOp.mCharId, aOp.mBuf))
+            PacketBuffer::Free(aOp.mBuf);
+        localLayer->HandleWriteConfirmation(localConnObj, aOp.mSvcId, aOp.mCharId);
+        break;
+
+    case kOperation_Indication:
+        if (!peerLayer->HandleIndicationReceived(peerConnObj, aOp.mSvcId, aOp.mCharId, aOp.mBuf))
+            PacketBuffer::Free(aOp.mBuf);
+        localLayer->HandleIndicationConfirmation(localConnObj, aOp.mSvcId, aOp.mCharId);
+        break;
+    }
+}
+
+bool MockBlePlatformDelegate::SubscribeCharacteristic(BLE_CONNECTION_OBJECT connObj, const WeaveBleUUID *svcId, const WeaveBleUUID *charId)
+{
+    return Enqueue(kOperation_Subscribe, svcId, charId, NULL);
+}
+
+bool MockBlePlatformDelegate::UnsubscribeCharacteristic(BLE_CONNECTION_OBJECT connObj, const WeaveBleUUID *svcId, const WeaveBleUUID *charId)
+{
+    return Enqueue(kOperation_Unsubscribe, svcId, charId, NULL);
 }
 
 bool MockBlePlatformDelegate::CloseConnection(BLE_CONNECTION_OBJECT connObj)
 {
-    // TODO mock implementation
-    return false;
+    if (mPeer == NULL)
+    {
+        return false;
+    }
+
+    Disconnect();
+
+    return true;
 }
 
 uint16_t MockBlePlatformDelegate::GetMTU(BLE_CONNECTION_OBJECT connObj) const
 {
-    // TODO mock implementation
-    return 0;
+    return mMTU;
 }
 
-bool MockBlePlatformDelegate::SendIndication(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId, nl::Weave::System::PacketBuffer *pBuf)
+uint8_t MockBlePlatformDelegate::GetReceiveWindowSize(BLE_CONNECTION_OBJECT connObj) const
 {
-    // TODO mock implementation
-    return false;
+    return mReceiveWindowSize;
 }
 
-bool MockBlePlatformDelegate::SendWriteRequest(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId, nl::Weave::System::PacketBuffer *pBuf)
+bool MockBlePlatformDelegate::SendIndication(BLE_CONNECTION_OBJECT connObj, const WeaveBleUUID *svcId, const WeaveBleUUID *charId, PacketBuffer *pBuf)
 {
-    // TODO mock implementation
-    return false;
+    return Enqueue(kOperation_Indication, svcId, charId, pBuf);
+}
+
+bool MockBlePlatformDelegate::SendWriteRequest(BLE_CONNECTION_OBJECT connObj, const WeaveBleUUID *svcId, const WeaveBleUUID *charId, PacketBuffer *pBuf)
+{
+    return Enqueue(kOperation_Write, svcId, charId, pBuf);
 }
 
-bool MockBlePlatformDelegate::SendReadRequest(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId, nl::Weave::System::PacketBuffer *pBuf)
+bool MockBlePlatformDelegate::SendReadRequest(BLE_CONNECTION_OBJECT connObj, const WeaveBleUUID *svcId, const WeaveBleUUID *charId, PacketBuffer *pBuf)
 {
     // TODO mock implementation
     return false;
 }
 
-bool MockBlePlatformDelegate::SendReadResponse(BLE_CONNECTION_OBJECT connObj, BLE_READ_REQUEST_CONTEXT requestContext, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId)
+bool MockBlePlatformDelegate::SendReadResponse(BLE_CONNECTION_OBJECT connObj, BLE_READ_REQUEST_CONTEXT requestContext, const WeaveBleUUID *svcId, const WeaveBleUUID *charId)
 {
     // TODO mock implementation
     return false;
@@ -16,22 +16,93 @@
  *    limitations under the License.
  */
 
+/**
+ *    @file
+ *      This file defines a mock BLE platform delegate. Unless connected
+ *      to a peer, all GATT operations fail. Two delegates connected to
+ *      one another form an in-process loopback link between two BleLayer
+ *      objects, with GATT operations queued and delivered one connection
+ *      event at a time, for testing and benchmarking Weave over BLE.
+ *
+ */
+
 #ifndef MOCKBLEPLATFORMDELEGATE_H_
 #define MOCKBLEPLATFORMDELEGATE_H_
 
 #include <BleLayer/BlePlatformDelegate.h>
+#include <BleLayer/BleLayer.h>
 
 class MockBlePlatformDelegate :
     public nl::Ble::BlePlatformDelegate
 {
+public:
+    struct Stats
+    {
+        uint32_t mWrites;                   ///< GATT writes sent.
+        uint32_t mIndications;              ///< GATT indications sent.
+        uint32_t mStandAloneAcks;           ///< BTP stand-alone acks among the writes and indications sent.
+        uint32_t mBytes;                    ///< Characteristic bytes sent.
+    };
+
+    MockBlePlatformDelegate(void);
+
+    void Connect(nl::Ble::BleLayer *aLayer, MockBlePlatformDelegate *aPeer, uint16_t aMTU, uint8_t aReceiveWindowSize);
+    void Disconnect(void);
+
+    size_t NumPendingOperations(void) const { return mNumPending; }
+    size_t DeliverPendingOperations(size_t aMaxOperations);
+
+    static size_t RunConnectionEvent(MockBlePlatformDelegate &aCentral, MockBlePlatformDelegate &aPeripheral);
+
+    BLE_CONNECTION_OBJECT GetConnectionObject(void) { return static_cast<BLE_CONNECTION_OBJECT>(this); }
+
+    const Stats &GetStats(void) const { return mStats; }
+    void ResetStats(void);
+
     bool SubscribeCharacteristic(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId);
     bool UnsubscribeCharacteristic(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId);
     bool CloseConnection(BLE_CONNECTION_OBJECT connObj);
     uint16_t GetMTU(BLE_CONNECTION_OBJECT connObj) const;
+    uint8_t GetReceiveWindowSize(BLE_CONNECTION_OBJECT connObj) const;
     bool SendIndication(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId, nl::Weave::System::PacketBuffer *pBuf);
     bool SendWriteRequest(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId, nl::Weave::System::PacketBuffer *pBuf);
     bool SendReadRequest(BLE_CONNECTION_OBJECT connObj, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId, nl::Weave::System::PacketBuffer *pBuf);
     bool SendReadResponse(BLE_CONNECTION_OBJECT connObj, BLE_READ_REQUEST_CONTEXT requestContext, const nl::Ble::WeaveBleUUID *svcId, const nl::Ble::WeaveBleUUID *charId);
+
+private:
+    enum
+    {
+        kMaxPendingOperations = 8
+    };
+
+    enum OperationType
+    {
+        kOperation_Subscribe,
+        kOperation_Unsubscribe,
+        kOperation_Write,
+        kOperation_Indication
+    };
+
+    struct Operation
+    {
+        OperationType mType;
+        const nl::Ble::WeaveBleUUID *mSvcId;
+        const nl::Ble::WeaveBleUUID *mCharId;
+        nl::Weave::System::PacketBuffer *mBuf;
+    };
+
+    bool Enqueue(OperationType aType, const nl::Ble::WeaveBleUUID *aSvcId, const nl::Ble::WeaveBleUUID *aCharId,
+                 nl::Weave::System::PacketBuffer *aBuf);
+    void Deliver(Operation &aOp);
+
+    nl::Ble::BleLayer *mLayer;
+    MockBlePlatformDelegate *mPeer;
+    uint16_t mMTU;
+    uint8_t mReceiveWindowSize;
+    Operation mPending[kMaxPendingOperations];
+    size_t mFirstPending;
+    size_t mNumPending;
+    Stats mStats;
 };
 
 #endif /* MOCKBLEPLATFORMDELEGATE_H_ */
@@ -37,6 +37,7 @@
 #include <Weave/Core/WeaveEncoding.h>
 #include <Weave/Profiles/WeaveProfiles.h>
 #include "MockSWUServer.h"
+#include "DeltaImageGenerator.h"
 #include <Weave/Profiles/common/CommonProfile.h>
 
 
@@ -47,6 +48,8 @@ MockSoftwareUpdateServer::MockSoftwareUpdateServer()
     mCurServerOp = NULL;
     mRefImageQuery = NULL;
     mFileDesignator = NULL;
+    mBaseImage = NULL;
+    mPatchFileName[0] = 0;
     mCurServerOpBuf = NULL;
 }
 
@@ -191,12 +194,55 @@ exit:
     return err;
 }
 
-WEAVE_ERROR MockSoftwareUpdateServer::SendImageQueryResponse()
+/*
+ * A delta image can only be offered when the client reports an installed image identical to
+ * the configured base image.  When it does, generate a patch from the base image to the
+ * served image alongside the latter and describe it in aPatchSpec.
+ */
+bool MockSoftwareUpdateServer::PreparePatch(ImageQuery &aQuery, PatchSpec &aPatchSpec)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint8_t baseDigest[nl::Weave::Platform::Security::SHA256::kHashLength];
+    IntegritySpec baseIntegritySpec;
+    uint32_t patchLen = 0;
+
+    VerifyOrExit(mBaseImage != NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+    VerifyOrExit(aQuery.installedImageHashPresent, err = WEAVE_ERROR_INVALID_ARGUMENT);
+
+    err = GenerateImageDigest(mBaseImage, aQuery.installedImageHash.type, baseDigest);
+    SuccessOrExit(err);
+
+    err = baseIntegritySpec.init(aQuery.installedImageHash.type, baseDigest);
+    SuccessOrExit(err);
+
+    if (!(baseIntegritySpec == aQuery.installedImageHash))
+    {
+        printf("Installed image does not match the base image, offering the full image\n");
+        ExitNow(err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+
+    snprintf(mPatchFileName, sizeof(mPatchFileName), "%s.delta", mFileDesignator);
+
+    err = GenerateDeltaImageFile(mBaseImage, mFileDesignator, mPatchFileName, patchLen);
+    SuccessOrExit(err);
+
+    err = aPatchSpec.init(kPatchFormat_WeaveDelta, baseIntegritySpec, patchLen);
+    SuccessOrExit(err);
+
+    printf("Generated delta image %s (%u bytes)\n", mPatchFileName, patchLen);
+
+exit:
+    return err == WEAVE_NO_ERROR;
+}
+
+WEAVE_ERROR MockSoftwareUpdateServer::SendImageQueryResponse(ImageQuery &aQuery)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
     ImageQueryResponse imageQueryResponse;
     IntegritySpec integritySpec;
+    PatchSpec patchSpec;
     ReferencedString URI;
+    const char *uriString;
     uint8_t imageDigest[nl::Weave::Platform::Security::SHA256::kHashLength];
     uint8_t supported_update_scheme;
     int integrityType = -1;
@@ -204,8 +250,8 @@ WEAVE_ERROR MockSoftwareUpdateServer::SendImageQueryResponse()
 
     VerifyOrExit(mFileDesignator != NULL, err = WEAVE_ERROR_INVALID_ARGUMENT);
 
-    // Use the first one
-    supported_update_scheme = mRefImageQuery->updateSchemes.theList[0];
+    // Use the client's preferred scheme, which HandleImageQuery() has checked that we support.
+    supported_update_scheme = aQuery.updateSchemes.theList[0];
 
     // Scan the offered list of integrity types for SHA1 or SHA256.  Prefer SHA256 when offered.
     for (i = 0; i < mRefImageQuery->integrityTypes.theLength; i++)
@@ -232,14 +278,25 @@ WEAVE_ERROR MockSoftwareUpdateServer::SendImageQueryResponse()
     err = GenerateImageDigest(mFileDesignator, (uint8_t)integrityType, imageDigest);
     SuccessOrExit(err);
 
-    err = integritySpec.init(mRefImageQuery->integrityTypes.theList[i], imageDigest);
+    err = integritySpec.init((uint8_t)integrityType, imageDigest);
     SuccessOrExit(err);
 
-    err = URI.init((uint16_t)(strlen(mFileDesignator) + 1), (char *)mFileDesignator);
+    // Fall back to downloading the full image when no patch applies to the client's installed image.
+    uriString = mFileDesignator;
+    if (supported_update_scheme == kUpdateScheme_BDXDelta)
+    {
+        if (PreparePatch(aQuery, patchSpec))
+            uriString = mPatchFileName;
+        else
+            supported_update_scheme = kUpdateScheme_BDX;
+    }
+
+    err = URI.init((uint16_t)(strlen(uriString) + 1), (char *)uriString);
     SuccessOrExit(err);
 
     err = imageQueryResponse.init(URI, mRefImageQuery->version, integritySpec,
-                                  supported_update_scheme, Normal, Unconditionally, false);
+                                  supported_update_scheme, Normal, Unconditionally, false,
+                                  (supported_update_scheme == kUpdateScheme_BDXDelta) ? &patchSpec : NULL);
     SuccessOrExit(err);
 
     mCurServerOpBuf = PacketBuffer::New();
@@ -364,7 +421,7 @@ WEAVE_ERROR MockSoftwareUpdateServer::HandleImageQuery(ExchangeContext *ec, cons
 exit:
     if (update_available && common_update_scheme_found && common_integrity_scheme_found)
     {
-        server->SendImageQueryResponse();
+        server->SendImageQueryResponse(ParsedImageQueryRequest);
     }
     else
     {
@@ -448,6 +505,21 @@ WEAVE_ERROR MockSoftwareUpdateServer::SetFileDesignator(const char *aFileDesigna
     return WEAVE_NO_ERROR;
 }
 
+WEAVE_ERROR MockSoftwareUpdateServer::SetBaseImage(const char *aBaseImage)
+{
+    FILE *file;
+
+    // Make sure we can open the base image file
+    file = fopen(aBaseImage, "r");
+    if (file == NULL)
+        return WEAVE_ERROR_INCORRECT_STATE;
+
+    fclose(file);
+
+    mBaseImage = aBaseImage;
+    return WEAVE_NO_ERROR;
+}
+
 WEAVE_ERROR MockSoftwareUpdateServer::SendImageAnnounce(WeaveConnection *con)
 {
     // Discard any existing exchange context.
@@ -49,6 +49,7 @@ public:
 
     void SetReferenceImageQuery(ImageQuery *aRefImageQuery);
     WEAVE_ERROR SetFileDesignator(const char *aFileDesignator);
+    WEAVE_ERROR SetBaseImage(const char *aBaseImage);
     WEAVE_ERROR SendImageAnnounce(WeaveConnection *con);
     WEAVE_ERROR SendImageAnnounce(uint64_t nodeId, IPAddress nodeAddr);
     WEAVE_ERROR SendImageAnnounce(uint64_t nodeId, IPAddress nodeAddr, uint16_t port);
@@ -59,6 +60,8 @@ protected:
     ExchangeContext *mCurServerOp;
     ImageQuery *mRefImageQuery;
     const char *mFileDesignator;
+    const char *mBaseImage;
+    char mPatchFileName[256];
     PacketBuffer *mCurServerOpBuf;
 
 private:
@@ -68,7 +71,8 @@ private:
             uint8_t msgType, PacketBuffer *payload);
     static WEAVE_ERROR HandleServerConnectionClosed(ExchangeContext *ec, WeaveConnection *con, WEAVE_ERROR conErr);
 
-    WEAVE_ERROR SendImageQueryResponse();
+    WEAVE_ERROR SendImageQueryResponse(ImageQuery &aQuery);
+    bool PreparePatch(ImageQuery &aQuery, PatchSpec &aPatchSpec);
     WEAVE_ERROR SendImageQueryStatus();
     WEAVE_ERROR ConvertIntegrityType(char *aIntegrityType, uint8_t aIntegrity);
     WEAVE_ERROR GenerateImageDigest(const char *imagePath, uint8_t integrityType, uint8_t *digest);
@@ -159,8 +159,17 @@ void MockSingleSourceTimeSyncClient::HandleSyncCompleted(void * const aApp, cons
 MockTimeSyncClient::MockTimeSyncClient()
 {
     memset(mContacts, 0, sizeof(mContacts));
+    mIsConcurrentSyncEnabled = false;
+    mNumLocalContacts = 1;
 }
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+void MockTimeSyncClient::SetConcurrentSync(const bool isEnabled)
+{
+    mIsConcurrentSyncEnabled = isEnabled;
+}
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
 void MockTimeSyncClient::SetupContacts(void)
 {
     // contacts for manually run
@@ -236,6 +245,17 @@ WEAVE_ERROR MockTimeSyncClient::Init(
     err = mClient.InitClient(this, exchangeMgr, encryptionType, keyId);
     SuccessOrExit(err);
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    if (mIsConcurrentSyncEnabled)
+    {
+        // contact both nodes at once. the client node doesn't answer, so the server's
+        // response completes each round without waiting for the other request to time out
+        err = mClient.EnableConcurrentSync(1);
+        SuccessOrExit(err);
+        mNumLocalContacts = 2;
+    }
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
     mOperatingMode = mode;
     mClient.OnTimeChangeNotificationReceived = OnTimeChangeNotificationReceived;
     mClient.OnSyncSucceeded = OnSyncSucceeded;
@@ -276,7 +296,7 @@ WEAVE_ERROR MockTimeSyncClient::Init(
         // periodically sync with local nodes using UDP connection
         err = mClient.GetExchangeMgr()->MessageLayer->SystemLayer->StartTimer(20 * 1000, HandleSyncTimer, this);
         SuccessOrExit(err);
-        err = mClient.SyncWithNodes(1, mContacts);
+        err = mClient.SyncWithNodes(mNumLocalContacts, mContacts);
         SuccessOrExit(err);
         break;
     default:
@@ -388,7 +408,7 @@ void MockTimeSyncClient::HandleSyncTimer(nl::Weave::System::Layer* aSystemLayer,
         err = client->mClient.GetExchangeMgr()->MessageLayer->SystemLayer->StartTimer(30000,
             HandleSyncTimer, &client->mClient);
         SuccessOrExit(err);
-        err = client->mClient.SyncWithNodes(1, client->mContacts);
+        err = client->mClient.SyncWithNodes(client->mNumLocalContacts, client->mContacts);
         SuccessOrExit(err);
         break;
     default:
@@ -40,11 +40,19 @@ public:
 
     WEAVE_ERROR Shutdown(void);
 
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    // must be called before Init
+    void SetConcurrentSync(const bool isEnabled);
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
 private:
     nl::Weave::Profiles::Time::TimeSyncNode mClient;
 
     OperatingMode mOperatingMode;
 
+    bool mIsConcurrentSyncEnabled;
+    int16_t mNumLocalContacts;
+
     nl::Weave::Profiles::Time::ServingNode mContacts[7];
     void SetupContacts(void);
 
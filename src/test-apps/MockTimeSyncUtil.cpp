@@ -75,6 +75,7 @@ static MockTimeSyncServer gMockServer;
 #if WEAVE_CONFIG_TIME_ENABLE_CLIENT
 static MockTimeSyncClient gMockClient;
 static OperatingMode gTimeSyncMode = kOperatingMode_AssignedLocalNodes;
+static bool gIsConcurrentSyncEnabled = false;
 #endif // WEAVE_CONFIG_TIME_ENABLE_CLIENT
 
 #if WEAVE_CONFIG_TIME_ENABLE_COORDINATOR
@@ -100,6 +101,9 @@ WEAVE_ERROR MockTimeSync::Init(nl::Weave::WeaveExchangeManager * const exchangeM
     {
 #if WEAVE_CONFIG_TIME_ENABLE_CLIENT
         printf("Initializing Mock Time Sync Client\n");
+#if WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+        gMockClient.SetConcurrentSync(gIsConcurrentSyncEnabled);
+#endif // WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
         err = gMockClient.Init(exchangeMgr, gTimeSyncMode, serviceNodeId, serviceNodeAddr);
 #else // WEAVE_CONFIG_TIME_ENABLE_CLIENT
         printf("Mock Time Sync Client not supported\n");
@@ -158,6 +162,20 @@ exit:
     return err;
 }
 
+WEAVE_ERROR MockTimeSync::SetConcurrentSync(const bool isEnabled)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+#if WEAVE_CONFIG_TIME_ENABLE_CLIENT && WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    gIsConcurrentSyncEnabled = isEnabled;
+#else
+    VerifyOrExit(!isEnabled, err = WEAVE_ERROR_NOT_IMPLEMENTED);
+
+exit:
+#endif // WEAVE_CONFIG_TIME_ENABLE_CLIENT && WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    return err;
+}
+
 WEAVE_ERROR MockTimeSync::SetRole(const MockTimeSyncRole role)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
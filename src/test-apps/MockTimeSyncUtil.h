@@ -55,6 +55,10 @@ static WEAVE_ERROR SetRole(const MockTimeSyncRole role);
 // this function is called at the cmd line argument parsing stage of mock-device
 static WEAVE_ERROR SetMode(const OperatingMode mode);
 
+// Make the Time Sync Client contact its local nodes concurrently
+// this function is called at the cmd line argument parsing stage of mock-device
+static WEAVE_ERROR SetConcurrentSync(const bool isEnabled);
+
 // Initialize this mock device for Time Services, according to the role that was set earlier
 static WEAVE_ERROR Init(nl::Weave::WeaveExchangeManager * const exchangeMgr, uint64_t serviceNodeId, const char * serviceNodeAddr);
 
@@ -408,6 +408,134 @@ void GetAppGroupMasterKeyId_Test(nlTestSuite *inSuite, void *inContext)
 }
 
 
+void KeyCache_Test(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    TestGroupKeyStore keyStore;
+    WeaveGroupKey intermediateKey;
+    WeaveGroupKey groupMasterKey;
+    uint8_t appStaticKey[sAppStaticKeyLen_CRK_G10];
+    uint8_t appStaticKeyHKDF[sAppStaticKeyLen_CRK_G10];
+    uint32_t keyId;
+    uint32_t appGroupGlobalId;
+    uint32_t generation;
+
+    // Derive application static key twice; the second request is served from the key cache.
+    for (int i = 0; i < 2; i++)
+    {
+        keyId = sAppStaticKeyId_CRK_G10;
+        appGroupGlobalId = 0;
+        memset(appStaticKey, 0, sizeof(appStaticKey));
+
+        err = keyStore.DeriveApplicationKey(keyId, NULL, 0,
+                                            sAppStaticKeyDiversifier_CRK_G10, sAppStaticKeyDiversifierLen_CRK_G10,
+                                            appStaticKey, sizeof(appStaticKey), sAppStaticKeyLen_CRK_G10, appGroupGlobalId);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, appGroupGlobalId == sAppGroupMasterKey10_GlobalId);
+        NL_TEST_ASSERT(inSuite, memcmp(appStaticKey, sAppStaticKey_CRK_G10, sAppStaticKeyLen_CRK_G10) == 0);
+    }
+
+    // A cached key is still subject to the buffer size check.
+    keyId = sAppStaticKeyId_CRK_G10;
+    err = keyStore.DeriveApplicationKey(keyId, NULL, 0,
+                                        sAppStaticKeyDiversifier_CRK_G10, sAppStaticKeyDiversifierLen_CRK_G10,
+                                        appStaticKey, sAppStaticKeyLen_CRK_G10 - 1, sAppStaticKeyLen_CRK_G10, appGroupGlobalId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+    // Derived intermediate keys are cached as well.
+    for (int i = 0; i < 2; i++)
+    {
+        err = keyStore.GetGroupKey(sIntermediateKeyId_FRK_E2, intermediateKey);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, intermediateKey.KeyId == sIntermediateKeyId_FRK_E2);
+        NL_TEST_ASSERT(inSuite, intermediateKey.KeyLen == kWeaveAppIntermediateKeySize);
+        NL_TEST_ASSERT(inSuite, memcmp(intermediateKey.Key, sIntermediateKey_FRK_E2, sIntermediateKeyLen_FRK_E2) == 0);
+    }
+
+    // Replace group master key #10; keys derived from the old key must not be returned.
+    generation = keyStore.GetKeyCacheGeneration();
+
+    err = keyStore.RetrieveGroupKey(sAppGroupMasterKey10_KeyId, groupMasterKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    groupMasterKey.Key[0] ^= 0xFF;
+    err = keyStore.StoreGroupKey(groupMasterKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, keyStore.GetKeyCacheGeneration() != generation);
+
+    keyId = sAppStaticKeyId_CRK_G10;
+    err = keyStore.DeriveApplicationKey(keyId, NULL, 0,
+                                        sAppStaticKeyDiversifier_CRK_G10, sAppStaticKeyDiversifierLen_CRK_G10,
+                                        appStaticKey, sizeof(appStaticKey), sAppStaticKeyLen_CRK_G10, appGroupGlobalId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, memcmp(appStaticKey, sAppStaticKey_CRK_G10, sAppStaticKeyLen_CRK_G10) != 0);
+
+    err = HKDFSHA1::DeriveKey(NULL, 0,
+                              sClientRootKey, sClientRootKeyLen,
+                              groupMasterKey.Key, groupMasterKey.KeyLen,
+                              sAppStaticKeyDiversifier_CRK_G10, sAppStaticKeyDiversifierLen_CRK_G10,
+                              appStaticKeyHKDF, sizeof(appStaticKeyHKDF), sAppStaticKeyLen_CRK_G10);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, memcmp(appStaticKey, appStaticKeyHKDF, sAppStaticKeyLen_CRK_G10) == 0);
+
+    // Deleting the key makes derivation fail rather than return a cached key.
+    err = keyStore.DeleteGroupKey(sAppGroupMasterKey10_KeyId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    keyId = sAppStaticKeyId_CRK_G10;
+    err = keyStore.DeriveApplicationKey(keyId, NULL, 0,
+                                        sAppStaticKeyDiversifier_CRK_G10, sAppStaticKeyDiversifierLen_CRK_G10,
+                                        appStaticKey, sizeof(appStaticKey), sAppStaticKeyLen_CRK_G10, appGroupGlobalId);
+    NL_TEST_ASSERT(inSuite, err != WEAVE_NO_ERROR);
+
+    ClearSecretKeyMaterial(intermediateKey);
+    ClearSecretKeyMaterial(groupMasterKey);
+}
+
+
+// A group key store that, like an older implementation, does not flush the derived key cache
+// itself when it is cleared.
+class NonFlushingGroupKeyStore : public TestGroupKeyStore
+{
+public:
+    virtual WEAVE_ERROR Clear(void) { return WEAVE_NO_ERROR; }
+};
+
+void KeyCacheFabricStateFlush_Test(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    static NonFlushingGroupKeyStore keyStore;
+    static WeaveFabricState fabricState;
+    uint8_t appStaticKey[sAppStaticKeyLen_CRK_G10];
+    uint32_t keyId = sAppStaticKeyId_CRK_G10;
+    uint32_t appGroupGlobalId;
+    uint32_t generation;
+
+    err = fabricState.Init(&keyStore);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = keyStore.DeriveApplicationKey(keyId, NULL, 0,
+                                        sAppStaticKeyDiversifier_CRK_G10, sAppStaticKeyDiversifierLen_CRK_G10,
+                                        appStaticKey, sizeof(appStaticKey), sAppStaticKeyLen_CRK_G10, appGroupGlobalId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Leaving the fabric flushes the cache regardless of the key store implementation.
+    generation = keyStore.GetKeyCacheGeneration();
+    fabricState.ClearFabricState();
+    NL_TEST_ASSERT(inSuite, keyStore.GetKeyCacheGeneration() != generation);
+
+    // As does creating a new fabric.
+    generation = keyStore.GetKeyCacheGeneration();
+    err = fabricState.CreateFabric();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, keyStore.GetKeyCacheGeneration() != generation);
+
+    fabricState.Shutdown();
+
+    ClearSecretData(appStaticKey, sizeof(appStaticKey));
+}
+
+
 int main(int argc, char *argv[])
 {
     static const nlTest tests[] = {
@@ -417,6 +545,8 @@ int main(int argc, char *argv[])
         NL_TEST_DEF("DeriveAppRotatingKey",             DeriveAppRotatingKey_Test),
         NL_TEST_DEF("DerivePasscodeKeys",               DerivePasscodeKeys_Test),
         NL_TEST_DEF("GetAppGroupMasterKeyId",           GetAppGroupMasterKeyId_Test),
+        NL_TEST_DEF("KeyCache",                         KeyCache_Test),
+        NL_TEST_DEF("KeyCacheFabricStateFlush",         KeyCacheFabricStateFlush_Test),
         NL_TEST_SENTINEL()
     };
 
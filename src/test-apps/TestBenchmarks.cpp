@@ -0,0 +1,944 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements micro-benchmarks for the core primitives of
+ *      the Weave stack: TLV encoding and decoding, message encryption,
+ *      packet buffers, timers, exchange contexts, key derivation,
+ *      elliptic curve operations, event logging and schema-driven
+ *      serialization.
+ *
+ *      Each benchmark is calibrated to run for a minimum amount of time
+ *      and its result is emitted as one JSON object per line, on stdout
+ *      and, if a file name is given as the first argument, to that file,
+ *      so that CI can track regressions over time.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <nltest.h>
+
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+
+#include "ToolCommon.h"
+#include "TestEventLoggingSchemaSerializers.h"
+#include <Weave/Core/WeaveTLV.h>
+#include <Weave/Support/ASN1.h>
+#include <Weave/Support/crypto/EllipticCurve.h>
+#include <Weave/Support/crypto/HKDF.h>
+#include <Weave/Profiles/data-management/DataManagement.h>
+
+using namespace nl::Weave::TLV;
+using namespace nl::Weave::ASN1;
+using namespace nl::Weave::Crypto;
+using namespace nl::Weave::Profiles::Security;
+
+namespace nl {
+namespace Weave {
+
+class NL_DLL_EXPORT WeaveMessageLayerTestObject
+{
+public:
+    WeaveMessageLayer *msgLayer;
+
+    WEAVE_ERROR DecodeMessage(PacketBuffer *msgBuf, uint64_t sourceNodeId, WeaveConnection *con,
+            WeaveMessageInfo *msgInfo, uint8_t **rPayload, uint16_t *rPayloadLen)
+    {
+        return msgLayer->DecodeMessage(msgBuf, sourceNodeId, con, msgInfo, rPayload, rPayloadLen);
+    }
+};
+
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+namespace Platform {
+    // for unit tests, the dummy critical section is sufficient.
+    void CriticalSectionEnter()
+    {
+        return;
+    }
+
+    void CriticalSectionExit()
+    {
+        return;
+    }
+} // Platform
+} // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+} // Profiles
+
+} // namespace Weave
+} // namespace nl
+
+nl::Weave::Profiles::DataManagement::SubscriptionEngine * nl::Weave::Profiles::DataManagement::SubscriptionEngine::GetInstance()
+{
+    static nl::Weave::Profiles::DataManagement::SubscriptionEngine gWdmSubscriptionEngine;
+
+    return &gWdmSubscriptionEngine;
+}
+
+/**
+ *  A benchmark body. It performs the measured operation @a iterations times.
+ */
+typedef WEAVE_ERROR (*BenchmarkFunct)(uint32_t iterations);
+
+// Minimum time each benchmark is run for once calibrated.
+#define BENCHMARK_MIN_TIME_NS       200000000ULL
+
+static FILE *sOutputFile = NULL;
+
+static uint64_t MonotonicNowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((uint64_t) ts.tv_sec * 1000000000ULL) + (uint64_t) ts.tv_nsec;
+}
+
+static void EmitResult(FILE *file, const char *name, uint32_t iterations, uint64_t elapsedNs, uint32_t bytesPerOp)
+{
+    double nsPerOp = ((double) elapsedNs) / iterations;
+
+    fprintf(file, "{\"suite\":\"weave-micro-benchmarks\",\"benchmark\":\"%s\",\"iterations\":%u,\"ns_per_op\":%.1f,"
+            "\"ops_per_sec\":%.1f,\"bytes_per_op\":%u}\n",
+            name, iterations, nsPerOp, 1e9 / nsPerOp, bytesPerOp);
+}
+
+/**
+ *  Run a benchmark, doubling the iteration count until a run lasts at
+ *  least BENCHMARK_MIN_TIME_NS, and report the last run.
+ */
+static WEAVE_ERROR RunBenchmark(const char *name, BenchmarkFunct funct, uint32_t bytesPerOp = 0)
+{
+    WEAVE_ERROR err;
+    uint32_t iterations = 1;
+    uint64_t elapsedNs;
+
+    while (true)
+    {
+        uint64_t start = MonotonicNowNs();
+
+        err = funct(iterations);
+        SuccessOrExit(err);
+
+        elapsedNs = MonotonicNowNs() - start;
+
+        if (elapsedNs >= BENCHMARK_MIN_TIME_NS || iterations >= UINT32_MAX / 2)
+            break;
+
+        // Jump close to the target once the run is long enough to extrapolate from.
+        if (elapsedNs > BENCHMARK_MIN_TIME_NS / 100)
+        {
+            uint64_t target = (BENCHMARK_MIN_TIME_NS * 12 / 10) * iterations / elapsedNs;
+            iterations = (target < UINT32_MAX / 2) ? (uint32_t) target : UINT32_MAX / 2;
+        }
+        else
+            iterations *= 2;
+    }
+
+    EmitResult(stdout, name, iterations, elapsedNs, bytesPerOp);
+    if (sOutputFile != NULL)
+        EmitResult(sOutputFile, name, iterations, elapsedNs, bytesPerOp);
+
+exit:
+    if (err != WEAVE_NO_ERROR)
+        fprintf(stderr, "Benchmark %s failed: %s\n", name, nl::ErrorStr(err));
+    return err;
+}
+
+// ===== TLV
+
+static uint8_t sTLVBuf[1024];
+static uint32_t sTLVLen = 0;
+
+/**
+ *  Encode a payload shaped like the data list of a WDM NotifyRequest: a
+ *  handful of data elements, each with a path, a version and a trait
+ *  structure holding the common scalar types.
+ */
+static WEAVE_ERROR EncodeNotifyPayload(uint8_t *buf, uint32_t bufSize, uint32_t &encodedLen)
+{
+    WEAVE_ERROR err;
+    TLVWriter writer;
+    TLVType outerContainer, dataList, dataElement, path, data, nested;
+
+    writer.Init(buf, bufSize);
+
+    err = writer.StartContainer(AnonymousTag, kTLVType_Structure, outerContainer);
+    SuccessOrExit(err);
+
+    err = writer.StartContainer(ContextTag(1), kTLVType_Array, dataList);
+    SuccessOrExit(err);
+
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        err = writer.StartContainer(AnonymousTag, kTLVType_Structure, dataElement);
+        SuccessOrExit(err);
+
+        err = writer.StartContainer(ContextTag(1), kTLVType_Path, path);
+        SuccessOrExit(err);
+        err = writer.Put(ContextTag(1), (uint32_t) (0x235A0000 + i));
+        SuccessOrExit(err);
+        err = writer.Put(ContextTag(2), (uint64_t) 0x18B4300000000001ULL);
+        SuccessOrExit(err);
+        err = writer.Put(ProfileTag(0x235A0000 + i, 2), (uint32_t) i);
+        SuccessOrExit(err);
+        err = writer.EndContainer(path);
+        SuccessOrExit(err);
+
+        err = writer.Put(ContextTag(2), (uint64_t) (0x1000 + i));
+        SuccessOrExit(err);
+
+        err = writer.StartContainer(ContextTag(3), kTLVType_Structure, data);
+        SuccessOrExit(err);
+        err = writer.PutBoolean(ContextTag(1), (i & 1) != 0);
+        SuccessOrExit(err);
+        err = writer.Put(ContextTag(2), (int32_t) (-1000 * (int32_t) i));
+        SuccessOrExit(err);
+        err = writer.Put(ContextTag(3), (uint64_t) 1500000000000ULL + i);
+        SuccessOrExit(err);
+        err = writer.Put(ContextTag(4), 21.5f + i);
+        SuccessOrExit(err);
+        err = writer.PutString(ContextTag(5), "living room thermostat");
+        SuccessOrExit(err);
+        err = writer.StartContainer(ContextTag(6), kTLVType_Structure, nested);
+        SuccessOrExit(err);
+        err = writer.Put(ContextTag(1), (uint32_t) 42);
+        SuccessOrExit(err);
+        err = writer.PutNull(ContextTag(2));
+        SuccessOrExit(err);
+        err = writer.EndContainer(nested);
+        SuccessOrExit(err);
+        err = writer.EndContainer(data);
+        SuccessOrExit(err);
+
+        err = writer.EndContainer(dataElement);
+        SuccessOrExit(err);
+    }
+
+    err = writer.EndContainer(dataList);
+    SuccessOrExit(err);
+
+    err = writer.EndContainer(outerContainer);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    encodedLen = writer.GetLengthWritten();
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR DecodeElements(TLVReader &reader, uint32_t &count)
+{
+    WEAVE_ERROR err;
+
+    while ((err = reader.Next()) == WEAVE_NO_ERROR)
+    {
+        count++;
+
+        switch (reader.GetType())
+        {
+        case kTLVType_Structure:
+        case kTLVType_Array:
+        case kTLVType_Path:
+        {
+            TLVType container;
+
+            err = reader.EnterContainer(container);
+            SuccessOrExit(err);
+            err = DecodeElements(reader, count);
+            SuccessOrExit(err);
+            err = reader.ExitContainer(container);
+            SuccessOrExit(err);
+            break;
+        }
+        case kTLVType_SignedInteger:
+        {
+            int64_t v;
+            err = reader.Get(v);
+            SuccessOrExit(err);
+            break;
+        }
+        case kTLVType_UnsignedInteger:
+        {
+            uint64_t v;
+            err = reader.Get(v);
+            SuccessOrExit(err);
+            break;
+        }
+        case kTLVType_Boolean:
+        {
+            bool v;
+            err = reader.Get(v);
+            SuccessOrExit(err);
+            break;
+        }
+        case kTLVType_FloatingPointNumber:
+        {
+            double v;
+            err = reader.Get(v);
+            SuccessOrExit(err);
+            break;
+        }
+        case kTLVType_UTF8String:
+        case kTLVType_ByteString:
+        {
+            const uint8_t *v;
+            err = reader.GetDataPtr(v);
+            SuccessOrExit(err);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    if (err == WEAVE_END_OF_TLV)
+        err = WEAVE_NO_ERROR;
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR BenchTLVEncode(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = EncodeNotifyPayload(sTLVBuf, sizeof(sTLVBuf), sTLVLen);
+
+    return err;
+}
+
+static WEAVE_ERROR BenchTLVDecode(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+    {
+        TLVReader reader;
+        uint32_t count = 0;
+
+        reader.Init(sTLVBuf, sTLVLen);
+        err = DecodeElements(reader, count);
+    }
+
+    return err;
+}
+
+static void CheckTLV(nlTestSuite *inSuite, void *inContext)
+{
+    // Encode once up front so the payload size is known before it is reported.
+    NL_TEST_ASSERT(inSuite, EncodeNotifyPayload(sTLVBuf, sizeof(sTLVBuf), sTLVLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sTLVLen != 0);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("TLVEncodeNotify", BenchTLVEncode, sTLVLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("TLVDecodeNotify", BenchTLVDecode, sTLVLen) == WEAVE_NO_ERROR);
+}
+
+// ===== Message encoding
+
+static const uint8_t sMsgEncKey_DataKey[] =
+{
+    0xF7, 0xE7, 0xD7, 0xC7, 0xB7, 0xA7, 0x97, 0x87, 0x07, 0x17, 0x27, 0x37, 0x47, 0x57, 0x67, 0x77
+};
+
+static const uint8_t sMsgEncKey_IntegrityKey[] =
+{
+    0xFD, 0xED, 0xDD, 0xCD, 0xBD, 0xAD, 0x9D, 0x8D, 0x0D, 0x1D, 0x2D, 0x3D, 0x4D, 0x5D, 0x6D, 0x7D,
+    0x82, 0x52, 0x78, 0x2D
+};
+
+static const uint64_t kBenchLocalNodeId = 0x18B4300000000002ULL;
+
+static WeaveFabricState sMsgFabricState;
+static WeaveMessageLayer sMsgLayer;
+static uint32_t sNextMsgId = 1;
+
+static WEAVE_ERROR InitMessageEncryption(void)
+{
+    WEAVE_ERROR err;
+    WeaveEncryptionKey key;
+    uint16_t keyId = sTestDefaultSessionKeyId;
+
+    err = sMsgFabricState.Init();
+    SuccessOrExit(err);
+
+    sMsgFabricState.LocalNodeId = kBenchLocalNodeId;
+
+    memcpy(key.AES128CTRSHA1.DataKey, sMsgEncKey_DataKey, sizeof(sMsgEncKey_DataKey));
+    memcpy(key.AES128CTRSHA1.IntegrityKey, sMsgEncKey_IntegrityKey, sizeof(sMsgEncKey_IntegrityKey));
+
+    // Messages are sent to, and decoded from, the local node, so one key serves both directions.
+    err = sMsgFabricState.AllocSessionKey(kBenchLocalNodeId, NULL, keyId);
+    SuccessOrExit(err);
+
+    err = sMsgFabricState.SetSessionKey(keyId, kBenchLocalNodeId, kWeaveEncryptionType_AES128CTRSHA1,
+            kWeaveAuthMode_CASE_Device, &key);
+    SuccessOrExit(err);
+
+    sMsgLayer.FabricState = &sMsgFabricState;
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR EncodeBenchMessage(PacketBuffer *&msgBuf)
+{
+    WEAVE_ERROR err;
+    WeaveMessageInfo msgInfo;
+
+    msgBuf = PacketBuffer::New();
+    VerifyOrExit(msgBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    memcpy(msgBuf->Start(), sTLVBuf, sTLVLen);
+    msgBuf->SetDataLength(sTLVLen);
+
+    msgInfo.Clear();
+    msgInfo.SourceNodeId = kBenchLocalNodeId;
+    msgInfo.DestNodeId = kBenchLocalNodeId;
+    msgInfo.MessageId = sNextMsgId++;
+    msgInfo.KeyId = sTestDefaultSessionKeyId;
+    msgInfo.Flags = kWeaveMessageFlag_DestNodeId | kWeaveMessageFlag_SourceNodeId | kWeaveMessageFlag_ReuseMessageId;
+    msgInfo.MessageVersion = kWeaveMessageVersion_V2;
+    msgInfo.EncryptionType = kWeaveEncryptionType_AES128CTRSHA1;
+
+    err = sMsgLayer.EncodeMessage(&msgInfo, msgBuf, NULL, UINT16_MAX, 0);
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR BenchMessageEncode(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+    {
+        PacketBuffer *msgBuf = NULL;
+
+        err = EncodeBenchMessage(msgBuf);
+        PacketBuffer::Free(msgBuf);
+    }
+
+    return err;
+}
+
+static WEAVE_ERROR BenchMessageEncodeDecode(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    WeaveMessageLayerTestObject testObject;
+
+    testObject.msgLayer = &sMsgLayer;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+    {
+        PacketBuffer *msgBuf = NULL;
+        WeaveMessageInfo msgInfo;
+        uint8_t *payload;
+        uint16_t payloadLen;
+
+        err = EncodeBenchMessage(msgBuf);
+        if (err == WEAVE_NO_ERROR)
+            err = testObject.DecodeMessage(msgBuf, kBenchLocalNodeId, NULL, &msgInfo, &payload, &payloadLen);
+        if (err == WEAVE_NO_ERROR && payloadLen != sTLVLen)
+            err = WEAVE_ERROR_MESSAGE_INCOMPLETE;
+        PacketBuffer::Free(msgBuf);
+    }
+
+    return err;
+}
+
+static void CheckMessageEncoding(nlTestSuite *inSuite, void *inContext)
+{
+    NL_TEST_ASSERT(inSuite, InitMessageEncryption() == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("EncodeMessageAES128CTRSHA1", BenchMessageEncode, sTLVLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("EncodeDecodeMessageAES128CTRSHA1", BenchMessageEncodeDecode, sTLVLen) == WEAVE_NO_ERROR);
+}
+
+// ===== Packet buffers
+
+static WEAVE_ERROR BenchPacketBufferAllocFree(uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        PacketBuffer *buf = PacketBuffer::New();
+        if (buf == NULL)
+            return WEAVE_ERROR_NO_MEMORY;
+        PacketBuffer::Free(buf);
+    }
+
+    return WEAVE_NO_ERROR;
+}
+
+static void CheckPacketBuffer(nlTestSuite *inSuite, void *inContext)
+{
+    NL_TEST_ASSERT(inSuite, RunBenchmark("PacketBufferAllocFree", BenchPacketBufferAllocFree) == WEAVE_NO_ERROR);
+}
+
+// ===== Timers
+
+static void HandleBenchTimer(nl::Weave::System::Layer *aLayer, void *aAppState, nl::Weave::System::Error aError)
+{
+}
+
+static WEAVE_ERROR BenchTimerStartCancel(uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        nl::Weave::System::Error err = SystemLayer.StartTimer(60000, HandleBenchTimer, NULL);
+        if (err != WEAVE_SYSTEM_NO_ERROR)
+            return err;
+        SystemLayer.CancelTimer(HandleBenchTimer, NULL);
+    }
+
+    return WEAVE_NO_ERROR;
+}
+
+static void CheckTimer(nlTestSuite *inSuite, void *inContext)
+{
+    NL_TEST_ASSERT(inSuite, RunBenchmark("SystemTimerStartCancel", BenchTimerStartCancel) == WEAVE_NO_ERROR);
+}
+
+// ===== Exchange contexts
+
+static void HandleBenchMessage(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, uint32_t profileId,
+        uint8_t msgType, PacketBuffer *payload)
+{
+    PacketBuffer::Free(payload);
+}
+
+static WEAVE_ERROR BenchExchangeAllocClose(uint32_t iterations)
+{
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        ExchangeContext *ec = ExchangeMgr.NewContext(kBenchLocalNodeId, IPAddress::Any, NULL);
+        if (ec == NULL)
+            return WEAVE_ERROR_NO_MEMORY;
+        ec->OnMessageReceived = HandleBenchMessage;
+        ec->Close();
+    }
+
+    return WEAVE_NO_ERROR;
+}
+
+static WEAVE_ERROR BenchUnsolicitedHandlerRegistration(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+    {
+        err = ExchangeMgr.RegisterUnsolicitedMessageHandler(0x235A0000, HandleBenchMessage, NULL);
+        if (err == WEAVE_NO_ERROR)
+            err = ExchangeMgr.UnregisterUnsolicitedMessageHandler(0x235A0000);
+    }
+
+    return err;
+}
+
+static void CheckExchangeContext(nlTestSuite *inSuite, void *inContext)
+{
+    NL_TEST_ASSERT(inSuite, RunBenchmark("ExchangeContextAllocClose", BenchExchangeAllocClose) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("UnsolicitedHandlerRegisterUnregister", BenchUnsolicitedHandlerRegistration) == WEAVE_NO_ERROR);
+}
+
+// ===== Key derivation and elliptic curve operations
+
+static const OID kBenchCurveOID = kOID_EllipticCurve_prime256v1;
+
+static uint8_t sPubKeyBuf[65];
+static uint8_t sPrivKeyBuf[33];
+static uint8_t sPeerPubKeyBuf[65];
+static uint8_t sPeerPrivKeyBuf[33];
+static EncodedECPublicKey sPubKey;
+static EncodedECPrivateKey sPrivKey;
+static EncodedECPublicKey sPeerPubKey;
+static EncodedECPrivateKey sPeerPrivKey;
+
+static WEAVE_ERROR BenchHKDF(uint32_t iterations)
+{
+    static const uint8_t salt[32] = { 0x01 };
+    static const uint8_t keyMaterial[32] = { 0x02 };
+    static const uint8_t info[8] = { 0x03 };
+    uint8_t key[36];
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = HKDFSHA256::DeriveKey(salt, sizeof(salt), keyMaterial, sizeof(keyMaterial), NULL, 0, info, sizeof(info),
+                key, sizeof(key), sizeof(key));
+
+    return err;
+}
+
+static WEAVE_ERROR BenchECDHGenerateKey(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+    {
+        sPubKey.ECPoint = sPubKeyBuf;
+        sPubKey.ECPointLen = sizeof(sPubKeyBuf);
+        sPrivKey.PrivKey = sPrivKeyBuf;
+        sPrivKey.PrivKeyLen = sizeof(sPrivKeyBuf);
+
+        err = GenerateECDHKey(kBenchCurveOID, sPubKey, sPrivKey);
+    }
+
+    return err;
+}
+
+static WEAVE_ERROR BenchECDHSharedSecret(uint32_t iterations)
+{
+    uint8_t secret[32];
+    uint16_t secretLen;
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = ECDHComputeSharedSecret(kBenchCurveOID, sPeerPubKey, sPrivKey, secret, sizeof(secret), secretLen);
+
+    return err;
+}
+
+static const uint8_t sMsgHash[32] =
+{
+    0x2C, 0x26, 0xB4, 0x6B, 0x68, 0xFF, 0xC6, 0x8F, 0xF9, 0x9B, 0x45, 0x3C, 0x1D, 0x30, 0x41, 0x34,
+    0x13, 0x42, 0x2D, 0x70, 0x64, 0x83, 0xBF, 0xA0, 0xF9, 0x8A, 0x5E, 0x88, 0x62, 0x66, 0xE7, 0xAE
+};
+
+static uint8_t sSignature[64];
+
+static WEAVE_ERROR BenchECDSASign(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = GenerateECDSASignature(kBenchCurveOID, sMsgHash, sizeof(sMsgHash), sPrivKey, sSignature);
+
+    return err;
+}
+
+static WEAVE_ERROR BenchECDSAVerify(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = VerifyECDSASignature(kBenchCurveOID, sMsgHash, sizeof(sMsgHash), sSignature, sPubKey);
+
+    return err;
+}
+
+static void CheckCrypto(nlTestSuite *inSuite, void *inContext)
+{
+    NL_TEST_ASSERT(inSuite, RunBenchmark("HKDFSHA256DeriveKey", BenchHKDF) == WEAVE_NO_ERROR);
+
+    sPeerPubKey.ECPoint = sPeerPubKeyBuf;
+    sPeerPubKey.ECPointLen = sizeof(sPeerPubKeyBuf);
+    sPeerPrivKey.PrivKey = sPeerPrivKeyBuf;
+    sPeerPrivKey.PrivKeyLen = sizeof(sPeerPrivKeyBuf);
+    NL_TEST_ASSERT(inSuite, GenerateECDHKey(kBenchCurveOID, sPeerPubKey, sPeerPrivKey) == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, RunBenchmark("ECDHGenerateKeyP256", BenchECDHGenerateKey) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("ECDHSharedSecretP256", BenchECDHSharedSecret) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("ECDSASignP256", BenchECDSASign) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("ECDSAVerifyP256", BenchECDSAVerify) == WEAVE_NO_ERROR);
+}
+
+// ===== Event logging
+
+static uint64_t sDebugEventBuffer[256];
+static uint64_t sInfoEventBuffer[256];
+static uint64_t sProdEventBuffer[512];
+static uint64_t sCritEventBuffer[256];
+
+static WEAVE_ERROR BenchLogFreeform(uint32_t iterations)
+{
+    nl::Weave::Profiles::DataManagement::event_id_t firstId = 0;
+    nl::Weave::Profiles::DataManagement::event_id_t lastId = 0;
+
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        lastId = nl::Weave::Profiles::DataManagement::LogFreeform(nl::Weave::Profiles::DataManagement::Production,
+                "Freeform entry %u", i);
+        if (i == 0)
+            firstId = lastId;
+    }
+
+    // Event ids start at zero, so a logged event is detected by the id sequence advancing rather than by a
+    // non-zero return.
+    return (iterations == 0 || lastId - firstId == iterations - 1) ? WEAVE_NO_ERROR : WEAVE_ERROR_NO_MEMORY;
+}
+
+static void CheckEventLogging(nlTestSuite *inSuite, void *inContext)
+{
+    size_t arraySizes[] = { sizeof(sDebugEventBuffer), sizeof(sInfoEventBuffer), sizeof(sProdEventBuffer), sizeof(sCritEventBuffer) };
+    void *arrays[] = { sDebugEventBuffer, sInfoEventBuffer, sProdEventBuffer, sCritEventBuffer };
+
+    nl::Weave::Profiles::DataManagement::LoggingManagement::CreateLoggingManagement(&ExchangeMgr, sizeof(arrays) / sizeof(arrays[0]),
+            arraySizes, arrays, NULL, NULL, NULL);
+    nl::Weave::Profiles::DataManagement::LoggingConfiguration::GetInstance().mGlobalImportance =
+            nl::Weave::Profiles::DataManagement::Production;
+
+    NL_TEST_ASSERT(inSuite, RunBenchmark("LogFreeformEvent", BenchLogFreeform) == WEAVE_NO_ERROR);
+
+    nl::Weave::Profiles::DataManagement::LoggingManagement::GetInstance().DestroyLoggingManagement();
+}
+
+// ===== Schema serialization
+
+static uint32_t sSamples[] = { 2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53 };
+static nl::MemoryManagement sSerializationMemMgmt = { malloc, free, realloc };
+static uint8_t sEventBuf[256];
+static uint32_t sEventLen = 0;
+static uint64_t sArenaBuf[64];
+static nl::SerializationArena sArena;
+
+static void InitSampleEvent(nl::Weave::Profiles::DataManagement::SampleTrait::Event &ev)
+{
+    memset(&ev, 0, sizeof(ev));
+    ev.state = 5;
+    ev.timestamp = 0x12345678;
+    ev.structure.a = true;
+    ev.structure.b.str = "sample event";
+    ev.samples.num_samples = sizeof(sSamples) / sizeof(sSamples[0]);
+    ev.samples.samples_buf = sSamples;
+}
+
+static WEAVE_ERROR EncodeSampleEvent(bool generated)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::Profiles::DataManagement::SampleTrait::Event ev;
+    nl::StructureSchemaPointerPair pair = { &ev, &nl::Weave::Profiles::DataManagement::sampleEventSchema };
+    TLVWriter writer;
+    TLVType outerType;
+
+    InitSampleEvent(ev);
+    writer.Init(sEventBuf, sizeof(sEventBuf));
+
+    err = writer.StartContainer(AnonymousTag, kTLVType_Structure, outerType);
+    SuccessOrExit(err);
+
+    if (generated)
+        err = nl::Weave::Profiles::DataManagement::SerializeSampleEventSchemaHelper(writer, 1, &ev);
+    else
+        err = nl::SerializedDataToTLVWriterHelper(writer, 1, &pair);
+    SuccessOrExit(err);
+
+    err = writer.EndContainer(outerType);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    sEventLen = writer.GetLengthWritten();
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR DecodeSampleEvent(bool generated, bool useArena)
+{
+    WEAVE_ERROR err;
+    nl::Weave::Profiles::DataManagement::SampleTrait::Event ev;
+    nl::StructureSchemaPointerPair pair = { &ev, &nl::Weave::Profiles::DataManagement::sampleEventSchema };
+    nl::SerializationContext context;
+    TLVReader reader;
+    TLVType outerType;
+
+    context.memMgmt = sSerializationMemMgmt;
+    if (useArena)
+        context.mArena = &sArena;
+    memset(&ev, 0, sizeof(ev));
+    reader.Init(sEventBuf, sEventLen);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    err = reader.EnterContainer(outerType);
+    SuccessOrExit(err);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    if (generated)
+    {
+        err = nl::Weave::Profiles::DataManagement::DeserializeSampleEventSchemaHelper(reader, 1, &ev, &context);
+        nl::Weave::Profiles::DataManagement::DeallocateSampleEventSchema(&ev, &context);
+    }
+    else
+    {
+        err = nl::TLVReaderToDeserializedDataHelper(reader, 1, &pair, &context);
+        nl::DeallocateDeserializedStructure(&ev, &nl::Weave::Profiles::DataManagement::sampleEventSchema, &context);
+    }
+
+    if (useArena)
+        sArena.Reset();
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR BenchSerializeInterpreted(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = EncodeSampleEvent(false);
+
+    return err;
+}
+
+static WEAVE_ERROR BenchSerializeGenerated(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = EncodeSampleEvent(true);
+
+    return err;
+}
+
+static WEAVE_ERROR BenchDeserializeInterpreted(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = DecodeSampleEvent(false, false);
+
+    return err;
+}
+
+static WEAVE_ERROR BenchDeserializeGenerated(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = DecodeSampleEvent(true, false);
+
+    return err;
+}
+
+static WEAVE_ERROR BenchDeserializeInterpretedArena(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = DecodeSampleEvent(false, true);
+
+    return err;
+}
+
+static WEAVE_ERROR BenchDeserializeGeneratedArena(uint32_t iterations)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    for (uint32_t i = 0; i < iterations && err == WEAVE_NO_ERROR; i++)
+        err = DecodeSampleEvent(true, true);
+
+    return err;
+}
+
+static void CheckSerialization(nlTestSuite *inSuite, void *inContext)
+{
+    sArena.Init(sArenaBuf, sizeof(sArenaBuf));
+
+    NL_TEST_ASSERT(inSuite, EncodeSampleEvent(false) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sEventLen != 0);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("SerializeSampleEventInterpreted", BenchSerializeInterpreted, sEventLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("SerializeSampleEventGenerated", BenchSerializeGenerated, sEventLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("DeserializeSampleEventInterpreted", BenchDeserializeInterpreted, sEventLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("DeserializeSampleEventGenerated", BenchDeserializeGenerated, sEventLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("DeserializeSampleEventInterpretedArena", BenchDeserializeInterpretedArena, sEventLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, RunBenchmark("DeserializeSampleEventGeneratedArena", BenchDeserializeGeneratedArena, sEventLen) == WEAVE_NO_ERROR);
+}
+
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(false, true);
+
+    // Keep per-operation progress logging out of the measurements.
+    nl::Weave::Logging::SetLogFilter(nl::Weave::Logging::kLogCategory_Error);
+
+    return SUCCESS;
+}
+
+static int TestTeardown(void *inContext)
+{
+    nl::Weave::Logging::SetLogFilter(nl::Weave::Logging::kLogCategory_Max);
+
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    static const nlTest tests[] = {
+        NL_TEST_DEF("TLV",                              CheckTLV),
+        NL_TEST_DEF("MessageEncoding",                  CheckMessageEncoding),
+        NL_TEST_DEF("PacketBuffer",                     CheckPacketBuffer),
+        NL_TEST_DEF("Timer",                            CheckTimer),
+        NL_TEST_DEF("ExchangeContext",                  CheckExchangeContext),
+        NL_TEST_DEF("Crypto",                           CheckCrypto),
+        NL_TEST_DEF("EventLogging",                     CheckEventLogging),
+        NL_TEST_DEF("Serialization",                    CheckSerialization),
+        NL_TEST_SENTINEL()
+    };
+
+    static nlTestSuite testSuite = {
+        "micro-benchmarks",
+        &tests[0],
+        TestSetup,
+        TestTeardown
+    };
+    int ret;
+
+    if (argc > 1)
+    {
+        sOutputFile = fopen(argv[1], "w");
+        if (sOutputFile == NULL)
+        {
+            fprintf(stderr, "Unable to open %s\n", argv[1]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&testSuite, NULL);
+
+    ret = nlTestRunnerStats(&testSuite);
+
+    if (sOutputFile != NULL)
+        fclose(sOutputFile);
+
+    return ret;
+}
@@ -0,0 +1,368 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file tests the sharing of connections between TCP bindings
+ *      to the same peer, against listeners on the loopback interface:
+ *      that bindings attach to a single pooled connection, that idle
+ *      connections are reused and then reaped, and that the bindings
+ *      sharing a connection all fail when it fails.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "ToolCommon.h"
+#include <nltest.h>
+
+using namespace nl::Weave;
+
+#define TEST_PEER_NODE_ID       0x18B4300000000001ULL
+#define TEST_WAIT_LIMIT_MS      2000
+#define TEST_IDLE_TIMEOUT_MS    50
+
+enum
+{
+    kListener_Shared            = 0,
+    kListener_Other,
+    kListener_PeerClose,
+    kListener_Refused,
+
+    kListener_Count
+};
+
+struct BindingEvents
+{
+    uint32_t Ready;
+    uint32_t PrepareFailed;
+    uint32_t BindingFailed;
+    WEAVE_ERROR LastError;
+};
+
+static int sListenerFds[kListener_Count] = { -1, -1, -1, -1 };
+static uint16_t sListenerPorts[kListener_Count];
+static IPAddress sLoopbackAddr;
+
+static void HandleBindingEvent(void *apAppState, Binding::EventType aEvent, const Binding::InEventParam &aInParam,
+                               Binding::OutEventParam &aOutParam)
+{
+    BindingEvents *events = static_cast<BindingEvents *>(apAppState);
+
+    switch (aEvent)
+    {
+    case Binding::kEvent_BindingReady:
+        events->Ready++;
+        break;
+    case Binding::kEvent_PrepareFailed:
+        events->PrepareFailed++;
+        events->LastError = aInParam.PrepareFailed.Reason;
+        break;
+    case Binding::kEvent_BindingFailed:
+        events->BindingFailed++;
+        events->LastError = aInParam.BindingFailed.Reason;
+        break;
+    default:
+        Binding::DefaultEventHandler(apAppState, aEvent, aInParam, aOutParam);
+        break;
+    }
+}
+
+static int OpenListener(int backlog, uint16_t &port)
+{
+    struct sockaddr_in6 addr;
+    socklen_t addrLen = sizeof(addr);
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_loopback;
+
+    if (fd < 0 ||
+        bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        getsockname(fd, (struct sockaddr *)&addr, &addrLen) != 0 ||
+        (backlog >= 0 && listen(fd, backlog) != 0))
+    {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+
+    port = ntohs(addr.sin6_port);
+
+    return fd;
+}
+
+static int32_t NumConnections(void)
+{
+    nl::Weave::System::Stats::count_t inUse = 0;
+
+    MessageLayer.GetConnectionPoolStats(inUse);
+
+    return inUse;
+}
+
+// Service events until the number of open connections reaches the expected value or the wait limit expires.
+static void WaitForConnections(int32_t expected)
+{
+    const uint64_t deadline = NowMs() + TEST_WAIT_LIMIT_MS;
+
+    while (NumConnections() != expected && NowMs() < deadline)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 1000;
+        ServiceNetwork(sleepTime);
+    }
+}
+
+static Binding *PrepareTCPBinding(nlTestSuite *inSuite, BindingEvents &events, uint8_t listener)
+{
+    WEAVE_ERROR err;
+    Binding *binding = ExchangeMgr.NewBinding(HandleBindingEvent, &events);
+
+    NL_TEST_ASSERT(inSuite, binding != NULL);
+
+    if (binding != NULL)
+    {
+        err = binding->BeginConfiguration()
+            .Target_NodeId(TEST_PEER_NODE_ID)
+            .TargetAddress_IP(sLoopbackAddr, sListenerPorts[listener])
+            .Transport_TCP()
+            .Security_None()
+            .PrepareBinding();
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    return binding;
+}
+
+static void CheckConfiguration(nlTestSuite *inSuite, void *inContext)
+{
+    BindingEvents events;
+    Binding *binding;
+    WEAVE_ERROR err;
+
+    memset(&events, 0, sizeof(events));
+
+    // A CASE session over the binding's connection requires TCP.
+    binding = ExchangeMgr.NewBinding(HandleBindingEvent, &events);
+    NL_TEST_ASSERT(inSuite, binding != NULL);
+
+    err = binding->BeginConfiguration()
+        .Target_NodeId(TEST_PEER_NODE_ID)
+        .Transport_UDP()
+        .Security_CASESession()
+        .PrepareBinding();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, NumConnections() == 0);
+
+    binding->Close();
+}
+
+static void CheckSharedConnection(nlTestSuite *inSuite, void *inContext)
+{
+    BindingEvents events;
+    Binding *bindingA;
+    Binding *bindingB;
+    Binding *bindingC;
+    ExchangeContext *ecA = NULL;
+    ExchangeContext *ecB = NULL;
+    WEAVE_ERROR err;
+
+    memset(&events, 0, sizeof(events));
+
+    // Two bindings to the same peer share one connection; a third to another port gets its own.
+    bindingA = PrepareTCPBinding(inSuite, events, kListener_Shared);
+    bindingB = PrepareTCPBinding(inSuite, events, kListener_Shared);
+    bindingC = PrepareTCPBinding(inSuite, events, kListener_Other);
+
+    ServiceNetworkUntilCount(events.Ready, 3, TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, events.Ready == 3);
+    NL_TEST_ASSERT(inSuite, events.PrepareFailed == 0);
+    NL_TEST_ASSERT(inSuite, NumConnections() == 2);
+
+    // Exchanges from both bindings are carried over the shared connection.
+    err = bindingA->NewExchangeContext(ecA);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    err = bindingB->NewExchangeContext(ecB);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ecA != NULL && ecB != NULL && ecA->Con != NULL && ecA->Con == ecB->Con);
+
+    if (ecA != NULL)
+        ecA->Close();
+    if (ecB != NULL)
+        ecB->Close();
+
+    // Closing the bindings leaves the connections open until the idle timeout.
+    bindingA->Close();
+    bindingB->Close();
+    bindingC->Close();
+    NL_TEST_ASSERT(inSuite, NumConnections() == 2);
+
+    // A new binding to the same peer reuses the idle connection.
+    bindingA = PrepareTCPBinding(inSuite, events, kListener_Shared);
+    ServiceNetworkUntilCount(events.Ready, 4, TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, events.Ready == 4);
+    NL_TEST_ASSERT(inSuite, NumConnections() == 2);
+
+    // Once the binding is released, both idle connections are reaped.
+    ExchangeMgr.PooledConnectionIdleTimeout = TEST_IDLE_TIMEOUT_MS;
+    bindingA->Close();
+    NL_TEST_ASSERT(inSuite, NumConnections() == 2);
+
+    WaitForConnections(0);
+    NL_TEST_ASSERT(inSuite, NumConnections() == 0);
+
+    ExchangeMgr.PooledConnectionIdleTimeout = WEAVE_CONFIG_POOLED_CONNECTION_IDLE_TIMEOUT;
+}
+
+static void CheckPeerClose(nlTestSuite *inSuite, void *inContext)
+{
+    BindingEvents events;
+    Binding *bindingA;
+    Binding *bindingB;
+    int fd;
+
+    memset(&events, 0, sizeof(events));
+
+    bindingA = PrepareTCPBinding(inSuite, events, kListener_PeerClose);
+    bindingB = PrepareTCPBinding(inSuite, events, kListener_PeerClose);
+
+    ServiceNetworkUntilCount(events.Ready, 2, TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, events.Ready == 2);
+    NL_TEST_ASSERT(inSuite, NumConnections() == 1);
+
+    // When the peer closes the shared connection, every binding using it fails.
+    fd = accept(sListenerFds[kListener_PeerClose], NULL, NULL);
+    NL_TEST_ASSERT(inSuite, fd >= 0);
+    if (fd >= 0)
+        close(fd);
+
+    ServiceNetworkUntilCount(events.BindingFailed, 2, TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, events.BindingFailed == 2);
+    NL_TEST_ASSERT(inSuite, !bindingA->IsReady() && !bindingB->IsReady());
+
+    WaitForConnections(0);
+    NL_TEST_ASSERT(inSuite, NumConnections() == 0);
+
+    bindingA->Close();
+    bindingB->Close();
+}
+
+static void CheckConnectFailure(nlTestSuite *inSuite, void *inContext)
+{
+    BindingEvents events;
+    Binding *bindingA;
+    Binding *bindingB;
+
+    memset(&events, 0, sizeof(events));
+
+    // Both bindings waiting on a connection that cannot be established fail to prepare.
+    bindingA = PrepareTCPBinding(inSuite, events, kListener_Refused);
+    bindingB = PrepareTCPBinding(inSuite, events, kListener_Refused);
+
+    ServiceNetworkUntilCount(events.PrepareFailed, 2, TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, events.PrepareFailed == 2);
+    NL_TEST_ASSERT(inSuite, events.Ready == 0);
+    NL_TEST_ASSERT(inSuite, events.LastError != WEAVE_NO_ERROR);
+
+    WaitForConnections(0);
+    NL_TEST_ASSERT(inSuite, NumConnections() == 0);
+
+    bindingA->Close();
+    bindingB->Close();
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Configuration",                CheckConfiguration),
+    NL_TEST_DEF("Shared Connection",            CheckSharedConnection),
+    NL_TEST_DEF("Peer Close",                   CheckPeerClose),
+    NL_TEST_DEF("Connect Failure",              CheckConnectFailure),
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite: start the Weave stack and open the listeners.
+ */
+static int TestSetup(void *inContext)
+{
+    int result = SUCCESS;
+
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(false, true);
+
+    IPAddress::FromString("::1", sLoopbackAddr);
+
+    for (int i = 0; i < kListener_Count; i++)
+    {
+        // Nothing listens on the refused listener's port.
+        sListenerFds[i] = OpenListener((i == kListener_Refused) ? -1 : 16, sListenerPorts[i]);
+        if (sListenerFds[i] < 0)
+            result = FAILURE;
+    }
+
+    close(sListenerFds[kListener_Refused]);
+    sListenerFds[kListener_Refused] = -1;
+
+    return result;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    for (int i = 0; i < kListener_Count; i++)
+        if (sListenerFds[i] >= 0)
+            close(sListenerFds[i]);
+
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+int main(void)
+{
+    nlTestSuite theSuite = {
+        "Binding-Connection-Pool",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
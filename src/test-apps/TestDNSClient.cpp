@@ -0,0 +1,504 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file tests the DNS cache, the coalescing of identical
+ *      requests, and the UDP DNS client of the InetLayer against a
+ *      stub name server running on the loopback interface.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+#include "ToolCommon.h"
+#include <nltest.h>
+#include <Weave/Core/WeaveEncoding.h>
+
+using namespace nl::Inet;
+using namespace nl::Weave::Encoding;
+using nl::Weave::System::PacketBuffer;
+
+#define TOOL_NAME "TestDNSClient"
+
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+#define STUB_SERVER_PORT                    35353
+#define RESOLVE_TIMEOUT_MILLISECS           5000
+
+#define kDNSType_A                          1
+#define kDNSType_AAAA                       28
+
+struct StubName
+{
+    const char *mName;
+    const char *mIPv6Addr;                  // NULL for no AAAA record
+    const char *mIPv4Addr;                  // NULL for no A record
+    uint32_t mTTL;
+    uint8_t mRcode;
+    uint8_t mNumToDrop;                     // Number of queries to leave unanswered
+    uint8_t mNumDropped;
+    uint32_t mNumQueries;
+};
+
+static StubName sStubNames[] = {
+    { "host.test",      "fd00::1",  "10.0.0.1", 300,    0, 0, 0, 0 },
+    { "other.test",     "fd00::2",  NULL,       300,    0, 0, 0, 0 },
+    { "short.test",     "fd00::3",  NULL,       1,      0, 0, 0, 0 },
+    { "missing.test",   NULL,       NULL,       0,      3, 0, 0, 0 },
+    { "nodata.test",    NULL,       NULL,       300,    0, 0, 0, 0 },
+    { "lossy.test",     "fd00::4",  NULL,       300,    0, 1, 0, 0 },
+};
+
+static UDPEndPoint *sStubEndPoint = NULL;
+static IPAddress sStubServerAddr;
+
+struct ResolveRequest
+{
+    bool mIsDone;
+    INET_ERROR mError;
+    uint8_t mNumAddrs;
+    IPAddress mAddrs[4];
+};
+
+static StubName *FindStubName(const char *name)
+{
+    for (size_t i = 0; i < sizeof(sStubNames) / sizeof(sStubNames[0]); i++)
+    {
+        if (strcasecmp(sStubNames[i].mName, name) == 0)
+            return &sStubNames[i];
+    }
+
+    return NULL;
+}
+
+static uint32_t GetNumQueries(const char *name)
+{
+    return FindStubName(name)->mNumQueries;
+}
+
+static uint32_t GetNumQueriesPerRequest(void)
+{
+#if INET_CONFIG_ENABLE_IPV4
+    return 2;
+#else
+    return 1;
+#endif
+}
+
+static void WriteAddressRecord(uint8_t *&p, uint16_t type, uint32_t ttl, const char *addrStr)
+{
+    IPAddress addr;
+
+    IPAddress::FromString(addrStr, addr);
+
+    BigEndian::Write16(p, 0xC00C);          // Pointer to the name in the question
+    BigEndian::Write16(p, type);
+    BigEndian::Write16(p, 1);
+    BigEndian::Write32(p, ttl);
+
+    if (type == kDNSType_AAAA)
+    {
+        BigEndian::Write16(p, 16);
+        addr.WriteAddress(p);
+    }
+    else
+    {
+        BigEndian::Write16(p, 4);
+        memcpy(p, &addr.Addr[3], 4);
+        p += 4;
+    }
+}
+
+/**
+ *  Answer the queries of the UDP DNS client according to sStubNames.
+ */
+static void HandleStubQuery(UDPEndPoint *endPoint, PacketBuffer *msg, const IPPacketInfo *pktInfo)
+{
+    uint8_t *start = msg->Start();
+    uint8_t *p = start + 12;
+    uint8_t *end = start + msg->DataLength();
+    char name[256];
+    size_t nameLen = 0;
+    uint16_t type;
+    StubName *stubName;
+    const char *addrStr;
+    uint16_t flags;
+
+    // Decode the question
+    while (p < end && *p != 0)
+    {
+        uint8_t len = *p++;
+
+        if (nameLen > 0)
+            name[nameLen++] = '.';
+        memcpy(&name[nameLen], p, len);
+        nameLen += len;
+        p += len;
+    }
+    name[nameLen] = '\0';
+    p++;
+    type = BigEndian::Get16(p);
+    p += 4;
+
+    stubName = FindStubName(name);
+    VerifyOrExit(stubName != NULL, );
+
+    stubName->mNumQueries++;
+
+    if (stubName->mNumDropped < stubName->mNumToDrop && type == kDNSType_AAAA)
+    {
+        stubName->mNumDropped++;
+        ExitNow();
+    }
+
+    // Turn the query into its response
+    flags = BigEndian::Get16(start + 2);
+    BigEndian::Put16(start + 2, flags | 0x8080 | stubName->mRcode);
+
+    addrStr = (type == kDNSType_AAAA) ? stubName->mIPv6Addr : stubName->mIPv4Addr;
+    if (addrStr != NULL && stubName->mRcode == 0)
+    {
+        BigEndian::Put16(start + 6, 1);
+        WriteAddressRecord(p, type, stubName->mTTL, addrStr);
+    }
+
+    msg->SetDataLength(p - start);
+
+    endPoint->SendTo(pktInfo->SrcAddress, pktInfo->SrcPort, msg);
+    msg = NULL;
+
+exit:
+    if (msg != NULL)
+        PacketBuffer::Free(msg);
+}
+
+static void HandleResolveComplete(void *appState, INET_ERROR err, uint8_t addrCount, IPAddress *addrArray)
+{
+    ResolveRequest *request = static_cast<ResolveRequest *>(appState);
+
+    request->mIsDone = true;
+    request->mError = err;
+    request->mNumAddrs = addrCount;
+}
+
+static INET_ERROR StartResolve(const char *name, ResolveRequest &request, uint8_t maxAddrs = 4)
+{
+    request = ResolveRequest();
+
+    return Inet.ResolveHostAddress(name, maxAddrs, request.mAddrs, HandleResolveComplete, &request);
+}
+
+static bool WaitFor(ResolveRequest *requests, size_t numRequests)
+{
+    const uint64_t deadline = NowMs() + RESOLVE_TIMEOUT_MILLISECS;
+    bool isDone = false;
+
+    while (!isDone && NowMs() < deadline)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+        ServiceNetwork(sleepTime);
+
+        isDone = true;
+        for (size_t i = 0; i < numRequests; i++)
+            isDone = isDone && requests[i].mIsDone;
+    }
+
+    return isDone;
+}
+
+static void ServiceFor(uint32_t aIntervalMs)
+{
+    ServiceNetworkUntil(NULL, &aIntervalMs);
+}
+
+static bool HasAddress(const ResolveRequest &request, const char *addrStr)
+{
+    IPAddress addr;
+
+    IPAddress::FromString(addrStr, addr);
+
+    for (uint8_t i = 0; i < request.mNumAddrs; i++)
+    {
+        if (request.mAddrs[i] == addr)
+            return true;
+    }
+
+    return false;
+}
+
+static void CheckResolution(nlTestSuite *inSuite, void *inContext)
+{
+    ResolveRequest request;
+    INET_ERROR err;
+
+    err = StartResolve("host.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, WaitFor(&request, 1));
+    NL_TEST_ASSERT(inSuite, request.mError == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasAddress(request, "fd00::1"));
+#if INET_CONFIG_ENABLE_IPV4
+    NL_TEST_ASSERT(inSuite, request.mNumAddrs == 2);
+    NL_TEST_ASSERT(inSuite, HasAddress(request, "10.0.0.1"));
+#else
+    NL_TEST_ASSERT(inSuite, request.mNumAddrs == 1);
+#endif
+    NL_TEST_ASSERT(inSuite, GetNumQueries("host.test") == GetNumQueriesPerRequest());
+}
+
+static void CheckPositiveCache(nlTestSuite *inSuite, void *inContext)
+{
+    const uint32_t numQueries = GetNumQueries("host.test");
+    ResolveRequest request;
+    INET_ERROR err;
+
+    // Served from the cache before ResolveHostAddress returns
+    err = StartResolve("HOST.test.", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, request.mIsDone);
+    NL_TEST_ASSERT(inSuite, request.mError == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasAddress(request, "fd00::1"));
+    NL_TEST_ASSERT(inSuite, GetNumQueries("host.test") == numQueries);
+
+    // A flushed cache doesn't
+    Inet.FlushDNSCache();
+
+    err = StartResolve("host.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !request.mIsDone);
+    NL_TEST_ASSERT(inSuite, WaitFor(&request, 1));
+    NL_TEST_ASSERT(inSuite, GetNumQueries("host.test") == numQueries + GetNumQueriesPerRequest());
+}
+
+static void CheckNegativeCache(nlTestSuite *inSuite, void *inContext)
+{
+    ResolveRequest request;
+    INET_ERROR err;
+
+    err = StartResolve("missing.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WaitFor(&request, 1));
+    NL_TEST_ASSERT(inSuite, request.mError == INET_ERROR_HOST_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, request.mNumAddrs == 0);
+    NL_TEST_ASSERT(inSuite, GetNumQueries("missing.test") == GetNumQueriesPerRequest());
+
+    err = StartResolve("missing.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, request.mIsDone);
+    NL_TEST_ASSERT(inSuite, request.mError == INET_ERROR_HOST_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, GetNumQueries("missing.test") == GetNumQueriesPerRequest());
+
+    // A name that exists but has no address is not found either
+    err = StartResolve("nodata.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WaitFor(&request, 1));
+    NL_TEST_ASSERT(inSuite, request.mError == INET_ERROR_HOST_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, request.mNumAddrs == 0);
+
+    err = StartResolve("nodata.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, request.mIsDone);
+    NL_TEST_ASSERT(inSuite, request.mError == INET_ERROR_HOST_NOT_FOUND);
+    NL_TEST_ASSERT(inSuite, GetNumQueries("nodata.test") == GetNumQueriesPerRequest());
+}
+
+static void CheckExpiry(nlTestSuite *inSuite, void *inContext)
+{
+    ResolveRequest request;
+    INET_ERROR err;
+
+    err = StartResolve("short.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WaitFor(&request, 1));
+    NL_TEST_ASSERT(inSuite, request.mError == INET_NO_ERROR);
+
+    err = StartResolve("short.test", request);
+    NL_TEST_ASSERT(inSuite, request.mIsDone);
+    NL_TEST_ASSERT(inSuite, GetNumQueries("short.test") == GetNumQueriesPerRequest());
+
+    // The record TTL is one second
+    ServiceFor(1100);
+
+    err = StartResolve("short.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WaitFor(&request, 1));
+    NL_TEST_ASSERT(inSuite, GetNumQueries("short.test") == 2 * GetNumQueriesPerRequest());
+}
+
+static void CheckCoalescing(nlTestSuite *inSuite, void *inContext)
+{
+    ResolveRequest requests[3];
+    INET_ERROR err;
+
+    Inet.FlushDNSCache();
+
+    const uint32_t numQueries = GetNumQueries("host.test");
+
+    err = StartResolve("host.test", requests[0]);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = StartResolve("host.test", requests[1]);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = StartResolve("host.test", requests[2], 1);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, WaitFor(requests, 3));
+
+    // All three requests are answered by one round of queries
+    NL_TEST_ASSERT(inSuite, GetNumQueries("host.test") == numQueries + GetNumQueriesPerRequest());
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        NL_TEST_ASSERT(inSuite, requests[i].mError == INET_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, HasAddress(requests[i], "fd00::1"));
+    }
+
+    NL_TEST_ASSERT(inSuite, requests[1].mNumAddrs == requests[0].mNumAddrs);
+    NL_TEST_ASSERT(inSuite, requests[2].mNumAddrs == 1);
+}
+
+static void CheckCancelLeader(nlTestSuite *inSuite, void *inContext)
+{
+    ResolveRequest requests[2];
+    INET_ERROR err;
+
+    err = StartResolve("other.test", requests[0]);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    err = StartResolve("other.test", requests[1]);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+
+    // The waiting request issues the query again
+    Inet.CancelResolveHostAddress(HandleResolveComplete, &requests[0]);
+
+    NL_TEST_ASSERT(inSuite, WaitFor(&requests[1], 1));
+    NL_TEST_ASSERT(inSuite, requests[1].mError == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasAddress(requests[1], "fd00::2"));
+    NL_TEST_ASSERT(inSuite, !requests[0].mIsDone);
+    NL_TEST_ASSERT(inSuite, GetNumQueries("other.test") == 2 * GetNumQueriesPerRequest());
+}
+
+static void CheckRetransmission(nlTestSuite *inSuite, void *inContext)
+{
+    ResolveRequest request;
+    INET_ERROR err;
+
+    err = StartResolve("lossy.test", request);
+    NL_TEST_ASSERT(inSuite, err == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, WaitFor(&request, 1));
+    NL_TEST_ASSERT(inSuite, request.mError == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, HasAddress(request, "fd00::4"));
+    NL_TEST_ASSERT(inSuite, GetNumQueries("lossy.test") == GetNumQueriesPerRequest() + 1);
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Resolution",                     CheckResolution),
+    NL_TEST_DEF("Positive Cache",                 CheckPositiveCache),
+    NL_TEST_DEF("Negative Cache",                 CheckNegativeCache),
+    NL_TEST_DEF("Expiry",                         CheckExpiry),
+    NL_TEST_DEF("Coalescing",                     CheckCoalescing),
+    NL_TEST_DEF("Cancel Leader",                  CheckCancelLeader),
+    NL_TEST_DEF("Retransmission",                 CheckRetransmission),
+
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite: start the stub name server on the IPv6
+ *  loopback address and point the UDP DNS client at it.
+ */
+static int TestSetup(void *inContext)
+{
+    INET_ERROR err;
+
+    InitSystemLayer();
+    InitNetwork();
+
+    IPAddress::FromString("::1", sStubServerAddr);
+
+    err = Inet.NewUDPEndPoint(&sStubEndPoint);
+    SuccessOrExit(err);
+
+    err = sStubEndPoint->Bind(kIPAddressType_IPv6, sStubServerAddr, STUB_SERVER_PORT);
+    SuccessOrExit(err);
+
+    sStubEndPoint->OnMessageReceived = HandleStubQuery;
+
+    err = sStubEndPoint->Listen();
+    SuccessOrExit(err);
+
+    err = Inet.SetDNSServer(sStubServerAddr, STUB_SERVER_PORT);
+    SuccessOrExit(err);
+
+exit:
+    return (err == INET_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    Inet.SetDNSServer(IPAddress::Any);
+
+    if (sStubEndPoint != NULL)
+    {
+        sStubEndPoint->Free();
+        sStubEndPoint = NULL;
+    }
+
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+
+int main(void)
+{
+#if INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+    nlTestSuite theSuite = {
+        "DNS-Client",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+#else
+    return 0;
+#endif // INET_CONFIG_ENABLE_DNS_RESOLVER && INET_CONFIG_ENABLE_DNS_UDP_CLIENT
+}
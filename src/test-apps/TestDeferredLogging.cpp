@@ -0,0 +1,248 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a process to effect a functional test for
+ *      the Weave deferred logging interfaces.
+ *
+ */
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Support/logging/WeaveLogging.h>
+#include <Weave/Support/logging/DeferredLogging.h>
+
+#include <nltest.h>
+
+#include "ToolCommon.h"
+
+#if WEAVE_CONFIG_DEFERRED_LOGGING
+
+using namespace nl::Weave::Logging;
+
+static bool PopFormatted(char *aBuf, size_t aBufSize)
+{
+    DeferredLogRecord record;
+
+    if (!PopDeferredLogRecord(record))
+        return false;
+
+    FormatDeferredLogRecord(record, aBuf, aBufSize);
+
+    return true;
+}
+
+static void CheckFormatting(nlTestSuite *inSuite, void *inContext)
+{
+    char buf[256];
+    char expected[256];
+    void *ptr = &buf;
+    uint64_t nodeId = 0x18B4300000000001ULL;
+
+    Log(kLogModule_Support, kLogCategory_Error, "plain message");
+    Log(kLogModule_Support, kLogCategory_Error, "%d %u %x %5.2f %c %% %s", -42, 42U, 0xBEEFU, 3.14159, 'W', "str");
+    Log(kLogModule_Support, kLogCategory_Error, "%016" PRIX64 " %-6hd| %*d %.*s %p", nodeId, (short) -7, 4, 9, 3, "abcdef", ptr);
+    Log(kLogModule_Support, kLogCategory_Error, "%s %.2s %8s", (const char *) NULL, "xyz", "right");
+
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+    NL_TEST_ASSERT(inSuite, strcmp(buf, "plain message") == 0);
+
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+    snprintf(expected, sizeof(expected), "%d %u %x %5.2f %c %% %s", -42, 42U, 0xBEEFU, 3.14159, 'W', "str");
+    NL_TEST_ASSERT(inSuite, strcmp(buf, expected) == 0);
+
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+    snprintf(expected, sizeof(expected), "%016" PRIX64 " %-6hd| %*d %.*s %p", nodeId, (short) -7, 4, 9, 3, "abcdef", ptr);
+    NL_TEST_ASSERT(inSuite, strcmp(buf, expected) == 0);
+
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+    NL_TEST_ASSERT(inSuite, strcmp(buf, "(null) xy    right") == 0);
+
+    NL_TEST_ASSERT(inSuite, !PopFormatted(buf, sizeof(buf)));
+}
+
+static void CheckStringCopy(nlTestSuite *inSuite, void *inContext)
+{
+    char name[16];
+    char buf[256];
+
+    strcpy(name, "before");
+    Log(kLogModule_Support, kLogCategory_Error, "name=%s", name);
+    strcpy(name, "after");
+
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+    NL_TEST_ASSERT(inSuite, strcmp(buf, "name=before") == 0);
+
+    // With a precision, only that much of the string is read; it need not be NUL terminated
+    memset(name, 'n', sizeof(name));
+    Log(kLogModule_Support, kLogCategory_Error, "name=%.4s|%.*s|%.0s", name, (int) sizeof(name), name, name);
+
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+    NL_TEST_ASSERT(inSuite, strcmp(buf, "name=nnnn|nnnnnnnnnnnnnnnn|") == 0);
+}
+
+static void CheckTruncation(nlTestSuite *inSuite, void *inContext)
+{
+    char longStr[WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE + 16];
+    char expected[WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE + 16];
+    char buf[256];
+
+    memset(longStr, 'a', sizeof(longStr) - 1);
+    longStr[sizeof(longStr) - 1] = '\0';
+
+    // The string is clipped to the space left after the integer and the string's length prefix, and the argument
+    // after it is dropped
+    Log(kLogModule_Support, kLogCategory_Error, "%d %s %d", 1, longStr, 2);
+
+    snprintf(expected, sizeof(expected), "1 %.*s ...",
+             (int) (WEAVE_CONFIG_DEFERRED_LOGGING_ARGS_SIZE - sizeof(int64_t) - sizeof(uint16_t)), longStr);
+
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+    NL_TEST_ASSERT(inSuite, strcmp(buf, expected) == 0);
+
+    // The output buffer is shorter than the message
+    Log(kLogModule_Support, kLogCategory_Error, "%s-%s", "0123456789", "0123456789");
+
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, 8));
+    NL_TEST_ASSERT(inSuite, strcmp(buf, "0123456") == 0);
+}
+
+static void CheckUnsupported(nlTestSuite *inSuite, void *inContext)
+{
+    char buf[256];
+    int count = 0;
+
+    // %n cannot be deferred; the message is logged synchronously instead
+    Log(kLogModule_Support, kLogCategory_Error, "synchronous%n", &count);
+
+    NL_TEST_ASSERT(inSuite, !PopFormatted(buf, sizeof(buf)));
+    NL_TEST_ASSERT(inSuite, count == 11);
+}
+
+static void CheckOverflow(nlTestSuite *inSuite, void *inContext)
+{
+    char buf[256];
+    uint32_t dropCount = GetDeferredLogDropCount();
+    int i;
+
+    for (i = 0; i < WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS + 3; i++)
+    {
+        Log(kLogModule_Support, kLogCategory_Error, "message %d", i);
+    }
+
+    NL_TEST_ASSERT(inSuite, GetDeferredLogDropCount() == dropCount + 3);
+
+    // The oldest messages are kept
+    for (i = 0; i < WEAVE_CONFIG_DEFERRED_LOGGING_NUM_RECORDS; i++)
+    {
+        char expected[32];
+
+        snprintf(expected, sizeof(expected), "message %d", i);
+        NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+        NL_TEST_ASSERT(inSuite, strcmp(buf, expected) == 0);
+    }
+
+    NL_TEST_ASSERT(inSuite, !PopFormatted(buf, sizeof(buf)));
+
+    // The ring is usable again once drained
+    Log(kLogModule_Support, kLogCategory_Error, "after overflow");
+    NL_TEST_ASSERT(inSuite, PopFormatted(buf, sizeof(buf)));
+    NL_TEST_ASSERT(inSuite, strcmp(buf, "after overflow") == 0);
+}
+
+static void CheckDrain(nlTestSuite *inSuite, void *inContext)
+{
+    char buf[256];
+
+    Log(kLogModule_Support, kLogCategory_Error, "drained %d", 1);
+    Log(kLogModule_Support, kLogCategory_Error, "drained %d", 2);
+
+    NL_TEST_ASSERT(inSuite, DrainDeferredLog() == 2);
+    NL_TEST_ASSERT(inSuite, !PopFormatted(buf, sizeof(buf)));
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Formatting",                     CheckFormatting),
+    NL_TEST_DEF("String Copy",                    CheckStringCopy),
+    NL_TEST_DEF("Truncation",                     CheckTruncation),
+    NL_TEST_DEF("Unsupported Conversion",         CheckUnsupported),
+    NL_TEST_DEF("Overflow",                       CheckOverflow),
+    NL_TEST_DEF("Drain",                          CheckDrain),
+
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite.
+ *  Deferred logging is started without a thread, so that the tests
+ *  drain the ring themselves.
+ */
+static int TestSetup(void *inContext)
+{
+    return (StartDeferredLogging(false) == WEAVE_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    StopDeferredLogging();
+
+    return (SUCCESS);
+}
+
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING
+
+int main(void)
+{
+#if WEAVE_CONFIG_DEFERRED_LOGGING
+    nlTestSuite theSuite = {
+        "Deferred-Logging",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+#else
+    return 0;
+#endif // WEAVE_CONFIG_DEFERRED_LOGGING
+}
@@ -0,0 +1,263 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file tests the Weave Device Pairing Manager against a mock
+ *      device description server in the same process, reached over the
+ *      loopback interface: argument checking, the queueing of devices
+ *      beyond the concurrency limit, and the bounded wait for a busy
+ *      security manager.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ToolCommon.h"
+#include "MockDDServer.h"
+#include <WeaveDevicePairingManager.h>
+#include <Weave/Support/WeaveFaultInjection.h>
+#include <nltest.h>
+
+using namespace nl::Weave;
+using namespace nl::Weave::DeviceManager;
+
+#define TEST_PAIRING_CODE           "TESTPC"
+#define TEST_SECURE_SESSION_WAIT_MS 200
+#define TEST_WAIT_LIMIT_MS          10000
+
+enum
+{
+    kMaxTestDevices = WeaveDevicePairingManager::kMaxPairingSessions + 1
+};
+
+struct PairingEvents
+{
+    uint32_t Count;
+    uint8_t MaxActiveSessions;
+    DevicePairingResult Results[kMaxTestDevices];
+};
+
+static MockDeviceDescriptionServer sMockDDServer;
+static IPAddress sLoopbackAddr;
+
+static void HandleDevicePaired(WeaveDevicePairingManager *pairingMgr, void *appReqState, const DevicePairingResult *result)
+{
+    PairingEvents *events = static_cast<PairingEvents *>(appReqState);
+    uint8_t numActive = pairingMgr->GetNumActiveSessions();
+
+    if (events->Count < kMaxTestDevices)
+        events->Results[events->Count] = *result;
+    events->Count++;
+
+    if (numActive > events->MaxActiveSessions)
+        events->MaxActiveSessions = numActive;
+}
+
+static void InitPairingManager(nlTestSuite *inSuite, WeaveDevicePairingManager &pairingMgr, uint8_t maxConcurrentSessions)
+{
+    DevicePairingConfig config;
+
+    config.SecureSessionWaitMs = TEST_SECURE_SESSION_WAIT_MS;
+
+    NL_TEST_ASSERT(inSuite, pairingMgr.Init(&ExchangeMgr, &SecurityMgr, config, maxConcurrentSessions) == WEAVE_NO_ERROR);
+}
+
+static void CheckArguments(nlTestSuite *inSuite, void *inContext)
+{
+    static WeaveDevicePairingManager pairingMgr;
+    DevicePairingConfig config;
+    PairingEvents events;
+
+    memset(&events, 0, sizeof(events));
+
+    NL_TEST_ASSERT(inSuite, pairingMgr.Init(NULL, &SecurityMgr, config, 1) == WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, pairingMgr.Init(&ExchangeMgr, &SecurityMgr, config, 0) == WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, pairingMgr.Init(&ExchangeMgr, &SecurityMgr, config,
+                                            WeaveDevicePairingManager::kMaxPairingSessions + 1) == WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, pairingMgr.PairDevice(1, sLoopbackAddr, TEST_PAIRING_CODE, &events, HandleDevicePaired) ==
+                            WEAVE_ERROR_INCORRECT_STATE);
+
+    InitPairingManager(inSuite, pairingMgr, 1);
+    NL_TEST_ASSERT(inSuite, pairingMgr.Init(&ExchangeMgr, &SecurityMgr, config, 1) == WEAVE_ERROR_INCORRECT_STATE);
+
+    NL_TEST_ASSERT(inSuite, pairingMgr.PairDevice(1, sLoopbackAddr, NULL, &events, HandleDevicePaired) == WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, pairingMgr.PairDevice(1, sLoopbackAddr, "0123456789ABCDEFG", &events, HandleDevicePaired) ==
+                            WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, pairingMgr.PairDevice(1, sLoopbackAddr, TEST_PAIRING_CODE, &events, NULL) == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    // Every pairing session can hold a device, whatever the concurrency limit.
+    for (int i = 0; i < WeaveDevicePairingManager::kMaxPairingSessions; i++)
+        NL_TEST_ASSERT(inSuite, pairingMgr.PairDevice(1, sLoopbackAddr, TEST_PAIRING_CODE, &events, HandleDevicePaired) ==
+                                WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pairingMgr.GetNumQueuedDevices() == WeaveDevicePairingManager::kMaxPairingSessions);
+    NL_TEST_ASSERT(inSuite, pairingMgr.PairDevice(1, sLoopbackAddr, TEST_PAIRING_CODE, &events, HandleDevicePaired) ==
+                            WEAVE_ERROR_NO_MEMORY);
+
+    // Shutting down abandons the devices without reporting them.
+    pairingMgr.Shutdown();
+    NL_TEST_ASSERT(inSuite, pairingMgr.GetNumQueuedDevices() == 0);
+
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+        ServiceNetwork(sleepTime);
+    }
+    NL_TEST_ASSERT(inSuite, events.Count == 0);
+}
+
+static void CheckSecurityManagerBusy(nlTestSuite *inSuite, void *inContext)
+{
+    static WeaveDevicePairingManager pairingMgr;
+    nl::FaultInjection::Manager &faultMgr = nl::Weave::FaultInjection::GetManager();
+    PairingEvents events;
+    uint64_t startTime;
+
+    memset(&events, 0, sizeof(events));
+
+    InitPairingManager(inSuite, pairingMgr, 1);
+
+    // The security manager never frees up; the device gives up once the configured wait is over.
+    faultMgr.FailAtFault(nl::Weave::FaultInjection::kFault_SecMgrBusy, 0, UINT32_MAX);
+
+    startTime = NowMs();
+    NL_TEST_ASSERT(inSuite, pairingMgr.PairDevice(FabricState.LocalNodeId, sLoopbackAddr, TEST_PAIRING_CODE, &events,
+                                                  HandleDevicePaired) == WEAVE_NO_ERROR);
+    ServiceNetworkUntilCount(events.Count, 1, TEST_WAIT_LIMIT_MS);
+
+    faultMgr.ResetFaultCounters();
+    faultMgr.ResetFaultConfigurations();
+
+    NL_TEST_ASSERT(inSuite, events.Count == 1);
+    NL_TEST_ASSERT(inSuite, NowMs() - startTime < TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, events.Results[0].Error == WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+    NL_TEST_ASSERT(inSuite, events.Results[0].LastStage == kPairingStage_SecureSession);
+    NL_TEST_ASSERT(inSuite, events.Results[0].StageTimeMs[kPairingStage_SecureSession] >= TEST_SECURE_SESSION_WAIT_MS);
+    NL_TEST_ASSERT(inSuite, pairingMgr.GetNumActiveSessions() == 0);
+
+    pairingMgr.Shutdown();
+}
+
+static void CheckQueueing(nlTestSuite *inSuite, void *inContext)
+{
+    static WeaveDevicePairingManager pairingMgr;
+    nl::FaultInjection::Manager &faultMgr = nl::Weave::FaultInjection::GetManager();
+    const uint32_t numDevices = 4;
+    uint32_t numWaited = 0;
+    PairingEvents events;
+
+    memset(&events, 0, sizeof(events));
+
+    InitPairingManager(inSuite, pairingMgr, 2);
+
+    faultMgr.FailAtFault(nl::Weave::FaultInjection::kFault_SecMgrBusy, 0, UINT32_MAX);
+
+    for (uint32_t i = 0; i < numDevices; i++)
+        NL_TEST_ASSERT(inSuite, pairingMgr.PairDevice(FabricState.LocalNodeId, sLoopbackAddr, TEST_PAIRING_CODE, &events,
+                                                      HandleDevicePaired) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, pairingMgr.GetNumQueuedDevices() == numDevices);
+
+    ServiceNetworkUntilCount(events.Count, numDevices, TEST_WAIT_LIMIT_MS);
+
+    faultMgr.ResetFaultCounters();
+    faultMgr.ResetFaultConfigurations();
+
+    NL_TEST_ASSERT(inSuite, events.Count == numDevices);
+
+    // No more than two devices were paired at once, so at most one other was still being paired when a device
+    // completed, and the two devices beyond the limit waited for a session to free up.
+    NL_TEST_ASSERT(inSuite, events.MaxActiveSessions <= 1);
+    for (uint32_t i = 0; i < numDevices; i++)
+    {
+        NL_TEST_ASSERT(inSuite, events.Results[i].Error == WEAVE_ERROR_SECURITY_MANAGER_BUSY);
+        NL_TEST_ASSERT(inSuite, events.Results[i].LastStage == kPairingStage_SecureSession);
+
+        if (events.Results[i].QueuedTimeMs >= TEST_SECURE_SESSION_WAIT_MS)
+            numWaited++;
+    }
+    NL_TEST_ASSERT(inSuite, numWaited >= numDevices - 2);
+
+    NL_TEST_ASSERT(inSuite, pairingMgr.GetNumActiveSessions() == 0);
+    NL_TEST_ASSERT(inSuite, pairingMgr.GetNumQueuedDevices() == 0);
+
+    pairingMgr.Shutdown();
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Arguments",                    CheckArguments),
+    NL_TEST_DEF("Security Manager Busy",        CheckSecurityManagerBusy),
+    NL_TEST_DEF("Queueing",                     CheckQueueing),
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite: start the Weave stack, listening for the device manager's connections, and the
+ *  mock device description server that answers its identify requests.
+ */
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(true, true);
+
+    IPAddress::FromString("::1", sLoopbackAddr);
+
+    if (sMockDDServer.Init(&ExchangeMgr) != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    sMockDDServer.Shutdown();
+
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+int main(void)
+{
+    nlTestSuite theSuite = {
+        "Device-Pairing-Manager",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
@@ -28,6 +28,7 @@
 #include <stdio.h>
 #include "ToolCommon.h"
 #include <Weave/Support/crypto/EllipticCurve.h>
+#include <Weave/Support/crypto/ECDHKeyPool.h>
 #include <Weave/Support/ASN1.h>
 
 #ifndef VERIFY_USING_OPENSSL_API
@@ -265,6 +266,141 @@ void ECDHTest_TestFixedKeys()
     printf("TestFixedKeys complete\n");
 }
 
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+
+void ECDHTest_TestKeyPool()
+{
+    WEAVE_ERROR err;
+    EncodedECPublicKey encodedPubKey1;
+    EncodedECPublicKey encodedPubKey2;
+    EncodedECPrivateKey encodedPrivKey1;
+    EncodedECPrivateKey encodedPrivKey2;
+    uint8_t pubKey1[128], pubKey2[128];
+    uint8_t privKey1[128], privKey2[128];
+    uint8_t sharedSecret1[128], sharedSecret2[128];
+    uint16_t sharedSecret1Len, sharedSecret2Len;
+
+    ECDHKeyPool::Clear();
+    VerifyOrFail(!ECDHKeyPool::NeedsRefill(), "Cleared pool needs refill\n");
+
+    // Taking a key for a curve with no ready key generates it inline and reserves an entry for the curve.
+    encodedPubKey1.ECPoint = pubKey1;
+    encodedPubKey1.ECPointLen = sizeof(pubKey1);
+    encodedPrivKey1.PrivKey = privKey1;
+    encodedPrivKey1.PrivKeyLen = sizeof(privKey1);
+    err = ECDHKeyPool::GetKey(sECTestKey_CurveOID, encodedPubKey1, encodedPrivKey1);
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::GetKey() failed\n");
+    VerifyOrFail(ECDHKeyPool::NeedsRefill(), "Pool did not reserve an entry for the curve\n");
+
+    err = ECDHKeyPool::Refill();
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::Refill() failed\n");
+    VerifyOrFail(ECDHKeyPool::GetReadyCount(sECTestKey_CurveOID) == 1, "Pool has no ready key after refill\n");
+    VerifyOrFail(!ECDHKeyPool::NeedsRefill(), "Pool needs refill after refill\n");
+
+    // A buffer too small for the pooled key is rejected without consuming the key.
+    encodedPubKey2.ECPoint = pubKey2;
+    encodedPubKey2.ECPointLen = 8;
+    encodedPrivKey2.PrivKey = privKey2;
+    encodedPrivKey2.PrivKeyLen = sizeof(privKey2);
+    err = ECDHKeyPool::GetKey(sECTestKey_CurveOID, encodedPubKey2, encodedPrivKey2);
+    VerifyOrFail(err == WEAVE_ERROR_BUFFER_TOO_SMALL, "ECDHKeyPool::GetKey() accepted a short buffer\n");
+    VerifyOrFail(ECDHKeyPool::GetReadyCount(sECTestKey_CurveOID) == 1, "Failed GetKey() consumed the pooled key\n");
+
+    // Take the pooled key.
+    encodedPubKey2.ECPointLen = sizeof(pubKey2);
+    err = ECDHKeyPool::GetKey(sECTestKey_CurveOID, encodedPubKey2, encodedPrivKey2);
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::GetKey() failed\n");
+    VerifyOrFail(ECDHKeyPool::GetReadyCount(sECTestKey_CurveOID) == 0, "Pooled key was not removed from the pool\n");
+    VerifyOrFail(ECDHKeyPool::NeedsRefill(), "Pool did not ask to replace the taken key\n");
+    VerifyOrFail(encodedPubKey1.ECPointLen != encodedPubKey2.ECPointLen ||
+                 memcmp(pubKey1, pubKey2, encodedPubKey1.ECPointLen) != 0, "Pool returned a previously used key\n");
+
+    // The pooled key pair agrees on a shared secret with the inline-generated one.
+    err = ECDHComputeSharedSecret(sECTestKey_CurveOID, encodedPubKey1, encodedPrivKey2, sharedSecret1, sizeof(sharedSecret1), sharedSecret1Len);
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHComputeSharedSecret() failed\n");
+    err = ECDHComputeSharedSecret(sECTestKey_CurveOID, encodedPubKey2, encodedPrivKey1, sharedSecret2, sizeof(sharedSecret2), sharedSecret2Len);
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHComputeSharedSecret() failed\n");
+    VerifyOrFail(sharedSecret1Len == sharedSecret2Len && memcmp(sharedSecret1, sharedSecret2, sharedSecret1Len) == 0,
+                 "Pooled key produced a mismatched shared secret\n");
+
+    ECDHKeyPool::Clear();
+
+    printf("TestKeyPool complete\n");
+}
+
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 1
+
+void ECDHTest_TestKeyPoolCurves()
+{
+    WEAVE_ERROR err;
+    const OID otherCurveOID = kOID_EllipticCurve_prime256v1;
+    EncodedECPublicKey encodedPubKey;
+    EncodedECPrivateKey encodedPrivKey;
+    uint8_t pubKey[128];
+    uint8_t privKey[128];
+
+    encodedPubKey.ECPoint = pubKey;
+    encodedPrivKey.PrivKey = privKey;
+
+    // Fill the pool with ready keys for the test curve.
+    ECDHKeyPool::Clear();
+    for (size_t i = 0; i < WEAVE_CONFIG_ECDH_KEY_POOL_SIZE; i++)
+        ECDHKeyPool::Reserve(sECTestKey_CurveOID);
+    while (ECDHKeyPool::NeedsRefill())
+    {
+        err = ECDHKeyPool::Refill();
+        VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::Refill() failed\n");
+    }
+    VerifyOrFail(ECDHKeyPool::GetReadyCount(sECTestKey_CurveOID) == WEAVE_CONFIG_ECDH_KEY_POOL_SIZE, "Pool was not filled\n");
+
+    // A key for another curve is generated inline without discarding any of the ready keys.
+    encodedPubKey.ECPointLen = sizeof(pubKey);
+    encodedPrivKey.PrivKeyLen = sizeof(privKey);
+    err = ECDHKeyPool::GetKey(otherCurveOID, encodedPubKey, encodedPrivKey);
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::GetKey() failed\n");
+    VerifyOrFail(ECDHKeyPool::GetReadyCount(sECTestKey_CurveOID) == WEAVE_CONFIG_ECDH_KEY_POOL_SIZE,
+                 "Pool discarded a ready key for another curve\n");
+    VerifyOrFail(!ECDHKeyPool::NeedsRefill(), "Pool reserved an entry held by a ready key\n");
+
+    // Once a key has been taken, the other curve takes over its entry.
+    encodedPubKey.ECPointLen = sizeof(pubKey);
+    encodedPrivKey.PrivKeyLen = sizeof(privKey);
+    err = ECDHKeyPool::GetKey(sECTestKey_CurveOID, encodedPubKey, encodedPrivKey);
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::GetKey() failed\n");
+
+    encodedPubKey.ECPointLen = sizeof(pubKey);
+    encodedPrivKey.PrivKeyLen = sizeof(privKey);
+    err = ECDHKeyPool::GetKey(otherCurveOID, encodedPubKey, encodedPrivKey);
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::GetKey() failed\n");
+
+    err = ECDHKeyPool::Refill();
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::Refill() failed\n");
+    VerifyOrFail(ECDHKeyPool::GetReadyCount(otherCurveOID) == 1, "Pool did not reserve an entry for the other curve\n");
+    VerifyOrFail(ECDHKeyPool::GetReadyCount(sECTestKey_CurveOID) == WEAVE_CONFIG_ECDH_KEY_POOL_SIZE - 1,
+                 "Pool discarded a ready key for another curve\n");
+
+    // The only entry of a curve is not taken over by another one.
+    encodedPubKey.ECPointLen = sizeof(pubKey);
+    encodedPrivKey.PrivKeyLen = sizeof(privKey);
+    err = ECDHKeyPool::GetKey(otherCurveOID, encodedPubKey, encodedPrivKey);
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::GetKey() failed\n");
+
+    ECDHKeyPool::Reserve(sECTestKey_CurveOID);
+
+    err = ECDHKeyPool::Refill();
+    VerifyOrFail(err == WEAVE_NO_ERROR, "ECDHKeyPool::Refill() failed\n");
+    VerifyOrFail(ECDHKeyPool::GetReadyCount(otherCurveOID) == 1, "Pool took over the only entry of a curve\n");
+    VerifyOrFail(!ECDHKeyPool::NeedsRefill(), "Pool needs refill after refill\n");
+
+    ECDHKeyPool::Clear();
+
+    printf("TestKeyPoolCurves complete\n");
+}
+
+#endif // WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 1
+
+#endif // WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+
 
 int main(int argc, char *argv[])
 {
@@ -275,5 +411,11 @@ int main(int argc, char *argv[])
 
     ECDHTest_TestFixedKeys();
     ECDHTest_TestEphemeralKeys();
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 0
+    ECDHTest_TestKeyPool();
+#endif
+#if WEAVE_CONFIG_ECDH_KEY_POOL_SIZE > 1
+    ECDHTest_TestKeyPoolCurves();
+#endif
     printf("All tests succeeded\n");
 }
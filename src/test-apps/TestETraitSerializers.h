@@ -0,0 +1,1374 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Specialized TLV serializers for the schemas in:
+ *
+ *        schema/nest/test/trait/TestETrait.cpp
+ *        schema/nest/test/trait/StructEStructSchema.cpp
+ *        schema/nest/test/trait/CommonStructEStructSchema.cpp
+ *        schema/nest/test/trait/NullableEStructSchema.cpp
+ *
+ *      !!! WARNING !!! WARNING !!! WARNING !!!
+ *
+ *      DO NOT EDIT THIS FILE! This file is generated by the
+ *      gen-tlv-serializers.py script.
+ *
+ *      To make changes, edit the schema definitions and re-run the
+ *      script to generate this file.
+ *
+ */
+
+#ifndef TESTETRAITSERIALIZERS_H_
+#define TESTETRAITSERIALIZERS_H_
+
+#include <stddef.h>
+
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/SerializationUtils.h>
+#include <nest/test/trait/TestETrait.h>
+
+namespace Schema {
+namespace Nest {
+namespace Test {
+namespace Trait {
+namespace TestETrait {
+
+// StructE::FieldSchema
+
+inline WEAVE_ERROR SerializeStructE_FieldSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(1), *reinterpret_cast<const uint32_t *>(data + (offsetof(StructE, seA))));
+    SuccessOrExit(err);
+
+    err = aWriter.PutBoolean(ContextTag(2), *reinterpret_cast<const bool *>(data + (offsetof(StructE, seB))));
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(3), *reinterpret_cast<const int32_t *>(data + (offsetof(StructE, seC))));
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeStructE_FieldSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(StructE, seA))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 2:
+        {
+            if (nextField > 1)
+                break;
+            nextField = 2;
+
+            err = aReader.Get(*reinterpret_cast<bool *>(data + (offsetof(StructE, seB))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 3:
+        {
+            if (nextField > 2)
+                break;
+            nextField = 3;
+
+            err = aReader.Get(*reinterpret_cast<int32_t *>(data + (offsetof(StructE, seC))));
+            SuccessOrExit(err);
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateStructE_FieldSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    return WEAVE_NO_ERROR;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeStructE_FieldSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeStructE_FieldSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeStructE_FieldSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeStructE_FieldSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+} // TestETrait
+} // Trait
+} // Test
+} // Nest
+} // Schema
+
+namespace Schema {
+namespace Nest {
+namespace Test {
+namespace Trait {
+namespace TestCommonTrait {
+
+// CommonStructE::FieldSchema
+
+inline WEAVE_ERROR SerializeCommonStructE_FieldSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(1), *reinterpret_cast<const uint32_t *>(data + (offsetof(CommonStructE, seA))));
+    SuccessOrExit(err);
+
+    err = aWriter.PutBoolean(ContextTag(2), *reinterpret_cast<const bool *>(data + (offsetof(CommonStructE, seB))));
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeCommonStructE_FieldSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(CommonStructE, seA))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 2:
+        {
+            if (nextField > 1)
+                break;
+            nextField = 2;
+
+            err = aReader.Get(*reinterpret_cast<bool *>(data + (offsetof(CommonStructE, seB))));
+            SuccessOrExit(err);
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateCommonStructE_FieldSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    return WEAVE_NO_ERROR;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeCommonStructE_FieldSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeCommonStructE_FieldSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeCommonStructE_FieldSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeCommonStructE_FieldSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+} // TestCommonTrait
+} // Trait
+} // Test
+} // Nest
+} // Schema
+
+namespace Schema {
+namespace Nest {
+namespace Test {
+namespace Trait {
+namespace TestETrait {
+
+// TestEEvent::FieldSchema
+
+inline WEAVE_ERROR SerializeTestEEvent_FieldSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+    const uint8_t *nullifiedFields = reinterpret_cast<const uint8_t *>(data + (offsetof(TestEEvent, teS)) + sizeof(uint32_t));
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(1), *reinterpret_cast<const uint32_t *>(data + (offsetof(TestEEvent, teA))));
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(2), *reinterpret_cast<const int32_t *>(data + (offsetof(TestEEvent, teB))));
+    SuccessOrExit(err);
+
+    err = aWriter.PutBoolean(ContextTag(3), *reinterpret_cast<const bool *>(data + (offsetof(TestEEvent, teC))));
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(4), *reinterpret_cast<const int32_t *>(data + (offsetof(TestEEvent, teD))));
+    SuccessOrExit(err);
+
+    err = ::Schema::Nest::Test::Trait::TestETrait::SerializeStructE_FieldSchema(aWriter, ContextTag(5), data + (offsetof(TestEEvent, teE)));
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(6), *reinterpret_cast<const int32_t *>(data + (offsetof(TestEEvent, teF))));
+    SuccessOrExit(err);
+
+    err = ::Schema::Nest::Test::Trait::TestCommonTrait::SerializeCommonStructE_FieldSchema(aWriter, ContextTag(7), data + (offsetof(TestEEvent, teG)));
+    SuccessOrExit(err);
+
+    {
+        const nl::ArrayLengthAndBuffer *array = reinterpret_cast<const nl::ArrayLengthAndBuffer *>(data + (offsetof(TestEEvent, teH) + offsetof(teH_array, num)));
+        TLVType arrayType;
+
+        err = aWriter.StartContainer(ContextTag(8), kTLVType_Array, arrayType);
+        SuccessOrExit(err);
+
+        for (uint32_t i = 0; i < array->mNumElements; i++)
+        {
+            err = aWriter.Put(AnonymousTag, *(static_cast<const uint32_t *>(array->mElementBuffer) + i));
+            SuccessOrExit(err);
+        }
+
+        err = aWriter.EndContainer(arrayType);
+        SuccessOrExit(err);
+    }
+
+    {
+        const nl::ArrayLengthAndBuffer *array = reinterpret_cast<const nl::ArrayLengthAndBuffer *>(data + (offsetof(TestEEvent, teI) + offsetof(teI_array, num)));
+        TLVType arrayType;
+
+        err = aWriter.StartContainer(ContextTag(9), kTLVType_Array, arrayType);
+        SuccessOrExit(err);
+
+        for (uint32_t i = 0; i < array->mNumElements; i++)
+        {
+            err = ::Schema::Nest::Test::Trait::TestCommonTrait::SerializeCommonStructE_FieldSchema(aWriter, AnonymousTag, static_cast<const char *>(array->mElementBuffer) + i * Schema::Nest::Test::Trait::TestCommonTrait::CommonStructE::FieldSchema.mSize);
+            SuccessOrExit(err);
+        }
+
+        err = aWriter.EndContainer(arrayType);
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 0))
+    {
+        err = aWriter.PutNull(ContextTag(10));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(10), *reinterpret_cast<const int16_t *>(data + (offsetof(TestEEvent, teJ))));
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.PutBytes(ContextTag(13), (reinterpret_cast<const nl::SerializedByteString *>(data + (offsetof(TestEEvent, teK))))->mBuf, (reinterpret_cast<const nl::SerializedByteString *>(data + (offsetof(TestEEvent, teK))))->mLen);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(14), *reinterpret_cast<const uint32_t *>(data + (offsetof(TestEEvent, teL))));
+    SuccessOrExit(err);
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 1))
+    {
+        err = aWriter.PutNull(ContextTag(15));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(15), *reinterpret_cast<const uint64_t *>(data + (offsetof(TestEEvent, teM))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 2))
+    {
+        err = aWriter.PutNull(ContextTag(16));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.PutBytes(ContextTag(16), (reinterpret_cast<const nl::SerializedByteString *>(data + (offsetof(TestEEvent, teN))))->mBuf, (reinterpret_cast<const nl::SerializedByteString *>(data + (offsetof(TestEEvent, teN))))->mLen);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.Put(ContextTag(17), *reinterpret_cast<const uint32_t *>(data + (offsetof(TestEEvent, teO))));
+    SuccessOrExit(err);
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 3))
+    {
+        err = aWriter.PutNull(ContextTag(18));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(18), *reinterpret_cast<const int64_t *>(data + (offsetof(TestEEvent, teP))));
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.Put(ContextTag(19), *reinterpret_cast<const int64_t *>(data + (offsetof(TestEEvent, teQ))));
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(20), *reinterpret_cast<const uint32_t *>(data + (offsetof(TestEEvent, teR))));
+    SuccessOrExit(err);
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 4))
+    {
+        err = aWriter.PutNull(ContextTag(21));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(21), *reinterpret_cast<const uint32_t *>(data + (offsetof(TestEEvent, teS))));
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeTestEEvent_FieldSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint8_t *nullifiedFields = reinterpret_cast<uint8_t *>(data + (offsetof(TestEEvent, teS)) + sizeof(uint32_t));
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Nullable fields that are not present are left nullified.
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 0);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 1);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 2);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 3);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 4);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(TestEEvent, teA))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 2:
+        {
+            if (nextField > 1)
+                break;
+            nextField = 2;
+
+            err = aReader.Get(*reinterpret_cast<int32_t *>(data + (offsetof(TestEEvent, teB))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 3:
+        {
+            if (nextField > 2)
+                break;
+            nextField = 3;
+
+            err = aReader.Get(*reinterpret_cast<bool *>(data + (offsetof(TestEEvent, teC))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 4:
+        {
+            if (nextField > 3)
+                break;
+            nextField = 4;
+
+            err = aReader.Get(*reinterpret_cast<int32_t *>(data + (offsetof(TestEEvent, teD))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 5:
+        {
+            if (nextField > 4)
+                break;
+            nextField = 5;
+
+            err = ::Schema::Nest::Test::Trait::TestETrait::DeserializeStructE_FieldSchema(aReader, data + (offsetof(TestEEvent, teE)), aContext);
+            SuccessOrExit(err);
+            break;
+        }
+        case 6:
+        {
+            if (nextField > 5)
+                break;
+            nextField = 6;
+
+            err = aReader.Get(*reinterpret_cast<int32_t *>(data + (offsetof(TestEEvent, teF))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 7:
+        {
+            if (nextField > 6)
+                break;
+            nextField = 7;
+
+            err = ::Schema::Nest::Test::Trait::TestCommonTrait::DeserializeCommonStructE_FieldSchema(aReader, data + (offsetof(TestEEvent, teG)), aContext);
+            SuccessOrExit(err);
+            break;
+        }
+        case 8:
+        {
+            if (nextField > 7)
+                break;
+            nextField = 8;
+
+            {
+                nl::ArrayLengthAndBuffer *array = reinterpret_cast<nl::ArrayLengthAndBuffer *>(data + (offsetof(TestEEvent, teH) + offsetof(teH_array, num)));
+                TLVType arrayType;
+                uint32_t capacity = 0;
+
+                array->mNumElements = 0;
+                array->mElementBuffer = NULL;
+
+                err = aReader.EnterContainer(arrayType);
+                SuccessOrExit(err);
+                VerifyOrExit(aReader.GetContainerType() == kTLVType_Array, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+                while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+                {
+                    if (array->mNumElements == capacity)
+                    {
+                        void *buffer;
+
+                        capacity = (capacity == 0) ? 2 : capacity * 2;
+                        buffer = nl::SerializationReallocate(aContext, array->mElementBuffer, capacity * sizeof(uint32_t));
+                        VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+                        array->mElementBuffer = buffer;
+                    }
+
+                    err = aReader.Get(*(static_cast<uint32_t *>(array->mElementBuffer) + array->mNumElements));
+                    SuccessOrExit(err);
+                    array->mNumElements++;
+                }
+
+                VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+                err = aReader.ExitContainer(arrayType);
+                SuccessOrExit(err);
+            }
+            break;
+        }
+        case 9:
+        {
+            if (nextField > 8)
+                break;
+            nextField = 9;
+
+            {
+                nl::ArrayLengthAndBuffer *array = reinterpret_cast<nl::ArrayLengthAndBuffer *>(data + (offsetof(TestEEvent, teI) + offsetof(teI_array, num)));
+                TLVType arrayType;
+                uint32_t capacity = 0;
+
+                array->mNumElements = 0;
+                array->mElementBuffer = NULL;
+
+                err = aReader.EnterContainer(arrayType);
+                SuccessOrExit(err);
+                VerifyOrExit(aReader.GetContainerType() == kTLVType_Array, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+                while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+                {
+                    if (array->mNumElements == capacity)
+                    {
+                        void *buffer;
+
+                        capacity = (capacity == 0) ? 2 : capacity * 2;
+                        buffer = nl::SerializationReallocate(aContext, array->mElementBuffer, capacity * Schema::Nest::Test::Trait::TestCommonTrait::CommonStructE::FieldSchema.mSize);
+                        VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+                        array->mElementBuffer = buffer;
+                    }
+
+                    err = ::Schema::Nest::Test::Trait::TestCommonTrait::DeserializeCommonStructE_FieldSchema(aReader, static_cast<char *>(array->mElementBuffer) + array->mNumElements * Schema::Nest::Test::Trait::TestCommonTrait::CommonStructE::FieldSchema.mSize, aContext);
+                    SuccessOrExit(err);
+                    array->mNumElements++;
+                }
+
+                VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+                err = aReader.ExitContainer(arrayType);
+                SuccessOrExit(err);
+            }
+            break;
+        }
+        case 10:
+        {
+            if (nextField > 9)
+                break;
+            nextField = 10;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 0);
+
+            err = aReader.Get(*reinterpret_cast<int16_t *>(data + (offsetof(TestEEvent, teJ))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 13:
+        {
+            if (nextField > 10)
+                break;
+            nextField = 11;
+
+            {
+                nl::SerializedByteString *byteString = reinterpret_cast<nl::SerializedByteString *>(data + (offsetof(TestEEvent, teK)));
+                uint32_t length = aReader.GetLength();
+                uint8_t *buffer = static_cast<uint8_t *>(nl::SerializationAllocate(aContext, length));
+
+                VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+                err = aReader.GetBytes(buffer, length);
+                if (err != WEAVE_NO_ERROR)
+                    nl::SerializationFree(aContext, buffer);
+                SuccessOrExit(err);
+                byteString->mBuf = buffer;
+                byteString->mLen = length;
+            }
+            break;
+        }
+        case 14:
+        {
+            if (nextField > 11)
+                break;
+            nextField = 12;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(TestEEvent, teL))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 15:
+        {
+            if (nextField > 12)
+                break;
+            nextField = 13;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 1);
+
+            err = aReader.Get(*reinterpret_cast<uint64_t *>(data + (offsetof(TestEEvent, teM))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 16:
+        {
+            if (nextField > 13)
+                break;
+            nextField = 14;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 2);
+
+            {
+                nl::SerializedByteString *byteString = reinterpret_cast<nl::SerializedByteString *>(data + (offsetof(TestEEvent, teN)));
+                uint32_t length = aReader.GetLength();
+                uint8_t *buffer = static_cast<uint8_t *>(nl::SerializationAllocate(aContext, length));
+
+                VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+                err = aReader.GetBytes(buffer, length);
+                if (err != WEAVE_NO_ERROR)
+                    nl::SerializationFree(aContext, buffer);
+                SuccessOrExit(err);
+                byteString->mBuf = buffer;
+                byteString->mLen = length;
+            }
+            break;
+        }
+        case 17:
+        {
+            if (nextField > 14)
+                break;
+            nextField = 15;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(TestEEvent, teO))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 18:
+        {
+            if (nextField > 15)
+                break;
+            nextField = 16;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 3);
+
+            err = aReader.Get(*reinterpret_cast<int64_t *>(data + (offsetof(TestEEvent, teP))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 19:
+        {
+            if (nextField > 16)
+                break;
+            nextField = 17;
+
+            err = aReader.Get(*reinterpret_cast<int64_t *>(data + (offsetof(TestEEvent, teQ))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 20:
+        {
+            if (nextField > 17)
+                break;
+            nextField = 18;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(TestEEvent, teR))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 21:
+        {
+            if (nextField > 18)
+                break;
+            nextField = 19;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 4);
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(TestEEvent, teS))));
+            SuccessOrExit(err);
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateTestEEvent_FieldSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char *data = static_cast<char *>(aStructureData);
+    uint8_t *nullifiedFields = reinterpret_cast<uint8_t *>(data + (offsetof(TestEEvent, teS)) + sizeof(uint32_t));
+
+    // Memory allocated from an arena is released all at once when the arena is reset.
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+        return WEAVE_NO_ERROR;
+
+    err = ::Schema::Nest::Test::Trait::TestETrait::DeallocateStructE_FieldSchema(data + (offsetof(TestEEvent, teE)), aContext);
+    SuccessOrExit(err);
+
+    err = ::Schema::Nest::Test::Trait::TestCommonTrait::DeallocateCommonStructE_FieldSchema(data + (offsetof(TestEEvent, teG)), aContext);
+    SuccessOrExit(err);
+
+    {
+        nl::ArrayLengthAndBuffer *array = reinterpret_cast<nl::ArrayLengthAndBuffer *>(data + (offsetof(TestEEvent, teH) + offsetof(teH_array, num)));
+        nl::SerializationFree(aContext, array->mElementBuffer);
+    }
+
+    {
+        nl::ArrayLengthAndBuffer *array = reinterpret_cast<nl::ArrayLengthAndBuffer *>(data + (offsetof(TestEEvent, teI) + offsetof(teI_array, num)));
+
+        for (uint32_t i = 0; i < array->mNumElements; i++)
+        {
+            err = ::Schema::Nest::Test::Trait::TestCommonTrait::DeallocateCommonStructE_FieldSchema(static_cast<char *>(array->mElementBuffer) + i * Schema::Nest::Test::Trait::TestCommonTrait::CommonStructE::FieldSchema.mSize, aContext);
+            SuccessOrExit(err);
+        }
+
+        nl::SerializationFree(aContext, array->mElementBuffer);
+    }
+
+    nl::SerializationFree(aContext, (reinterpret_cast<nl::SerializedByteString *>(data + (offsetof(TestEEvent, teK))))->mBuf);
+
+    if (!GET_FIELD_NULLIFIED_BIT(nullifiedFields, 2))
+    {
+        nl::SerializationFree(aContext, (reinterpret_cast<nl::SerializedByteString *>(data + (offsetof(TestEEvent, teN))))->mBuf);
+    }
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeTestEEvent_FieldSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeTestEEvent_FieldSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeTestEEvent_FieldSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeTestEEvent_FieldSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+// NullableE::FieldSchema
+
+inline WEAVE_ERROR SerializeNullableE_FieldSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+    const uint8_t *nullifiedFields = reinterpret_cast<const uint8_t *>(data + (offsetof(NullableE, neB)) + sizeof(bool));
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 0))
+    {
+        err = aWriter.PutNull(ContextTag(1));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(1), *reinterpret_cast<const uint32_t *>(data + (offsetof(NullableE, neA))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 1))
+    {
+        err = aWriter.PutNull(ContextTag(2));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.PutBoolean(ContextTag(2), *reinterpret_cast<const bool *>(data + (offsetof(NullableE, neB))));
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeNullableE_FieldSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint8_t *nullifiedFields = reinterpret_cast<uint8_t *>(data + (offsetof(NullableE, neB)) + sizeof(bool));
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Nullable fields that are not present are left nullified.
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 0);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 1);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 0);
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(NullableE, neA))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 2:
+        {
+            if (nextField > 1)
+                break;
+            nextField = 2;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 1);
+
+            err = aReader.Get(*reinterpret_cast<bool *>(data + (offsetof(NullableE, neB))));
+            SuccessOrExit(err);
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateNullableE_FieldSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    return WEAVE_NO_ERROR;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeNullableE_FieldSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeNullableE_FieldSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeNullableE_FieldSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeNullableE_FieldSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+// TestENullableEvent::FieldSchema
+
+inline WEAVE_ERROR SerializeTestENullableEvent_FieldSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+    const uint8_t *nullifiedFields = reinterpret_cast<const uint8_t *>(data + (offsetof(TestENullableEvent, neJ)) + Schema::Nest::Test::Trait::TestETrait::NullableE::FieldSchema.mSize);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 0))
+    {
+        err = aWriter.PutNull(ContextTag(1));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(1), *reinterpret_cast<const uint32_t *>(data + (offsetof(TestENullableEvent, neA))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 1))
+    {
+        err = aWriter.PutNull(ContextTag(2));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(2), *reinterpret_cast<const int32_t *>(data + (offsetof(TestENullableEvent, neB))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 2))
+    {
+        err = aWriter.PutNull(ContextTag(3));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.PutBoolean(ContextTag(3), *reinterpret_cast<const bool *>(data + (offsetof(TestENullableEvent, neC))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 3))
+    {
+        err = aWriter.PutNull(ContextTag(4));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.PutString(ContextTag(4), *reinterpret_cast<const char * const *>(data + (offsetof(TestENullableEvent, neD))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 4))
+    {
+        err = aWriter.PutNull(ContextTag(5));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(5), *reinterpret_cast<const int16_t *>(data + (offsetof(TestENullableEvent, neE))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 5))
+    {
+        err = aWriter.PutNull(ContextTag(6));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(6), *reinterpret_cast<const uint32_t *>(data + (offsetof(TestENullableEvent, neF))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 6))
+    {
+        err = aWriter.PutNull(ContextTag(7));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.Put(ContextTag(7), *reinterpret_cast<const int32_t *>(data + (offsetof(TestENullableEvent, neG))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 7))
+    {
+        err = aWriter.PutNull(ContextTag(8));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.PutBoolean(ContextTag(8), *reinterpret_cast<const bool *>(data + (offsetof(TestENullableEvent, neH))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 8))
+    {
+        err = aWriter.PutNull(ContextTag(9));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = aWriter.PutString(ContextTag(9), *reinterpret_cast<const char * const *>(data + (offsetof(TestENullableEvent, neI))));
+        SuccessOrExit(err);
+    }
+
+    if (GET_FIELD_NULLIFIED_BIT(nullifiedFields, 9))
+    {
+        err = aWriter.PutNull(ContextTag(10));
+        SuccessOrExit(err);
+    }
+    else
+    {
+        err = ::Schema::Nest::Test::Trait::TestETrait::SerializeNullableE_FieldSchema(aWriter, ContextTag(10), data + (offsetof(TestENullableEvent, neJ)));
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeTestENullableEvent_FieldSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint8_t *nullifiedFields = reinterpret_cast<uint8_t *>(data + (offsetof(TestENullableEvent, neJ)) + Schema::Nest::Test::Trait::TestETrait::NullableE::FieldSchema.mSize);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Nullable fields that are not present are left nullified.
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 0);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 1);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 2);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 3);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 4);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 5);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 6);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 7);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 8);
+    SET_FIELD_NULLIFIED_BIT(nullifiedFields, 9);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 0);
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(TestENullableEvent, neA))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 2:
+        {
+            if (nextField > 1)
+                break;
+            nextField = 2;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 1);
+
+            err = aReader.Get(*reinterpret_cast<int32_t *>(data + (offsetof(TestENullableEvent, neB))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 3:
+        {
+            if (nextField > 2)
+                break;
+            nextField = 3;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 2);
+
+            err = aReader.Get(*reinterpret_cast<bool *>(data + (offsetof(TestENullableEvent, neC))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 4:
+        {
+            if (nextField > 3)
+                break;
+            nextField = 4;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 3);
+
+            {
+                uint32_t length = aReader.GetLength() + 1;
+                char *string = static_cast<char *>(nl::SerializationAllocate(aContext, length));
+
+                VerifyOrExit(string != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+                err = aReader.GetString(string, length);
+                if (err != WEAVE_NO_ERROR)
+                    nl::SerializationFree(aContext, string);
+                SuccessOrExit(err);
+                *reinterpret_cast<char **>(data + (offsetof(TestENullableEvent, neD))) = string;
+            }
+            break;
+        }
+        case 5:
+        {
+            if (nextField > 4)
+                break;
+            nextField = 5;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 4);
+
+            err = aReader.Get(*reinterpret_cast<int16_t *>(data + (offsetof(TestENullableEvent, neE))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 6:
+        {
+            if (nextField > 5)
+                break;
+            nextField = 6;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 5);
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(TestENullableEvent, neF))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 7:
+        {
+            if (nextField > 6)
+                break;
+            nextField = 7;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 6);
+
+            err = aReader.Get(*reinterpret_cast<int32_t *>(data + (offsetof(TestENullableEvent, neG))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 8:
+        {
+            if (nextField > 7)
+                break;
+            nextField = 8;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 7);
+
+            err = aReader.Get(*reinterpret_cast<bool *>(data + (offsetof(TestENullableEvent, neH))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 9:
+        {
+            if (nextField > 8)
+                break;
+            nextField = 9;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 8);
+
+            {
+                uint32_t length = aReader.GetLength() + 1;
+                char *string = static_cast<char *>(nl::SerializationAllocate(aContext, length));
+
+                VerifyOrExit(string != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+                err = aReader.GetString(string, length);
+                if (err != WEAVE_NO_ERROR)
+                    nl::SerializationFree(aContext, string);
+                SuccessOrExit(err);
+                *reinterpret_cast<char **>(data + (offsetof(TestENullableEvent, neI))) = string;
+            }
+            break;
+        }
+        case 10:
+        {
+            if (nextField > 9)
+                break;
+            nextField = 10;
+
+            if (aReader.GetType() == kTLVType_Null)
+                break;
+            CLEAR_FIELD_NULLIFIED_BIT(nullifiedFields, 9);
+
+            err = ::Schema::Nest::Test::Trait::TestETrait::DeserializeNullableE_FieldSchema(aReader, data + (offsetof(TestENullableEvent, neJ)), aContext);
+            SuccessOrExit(err);
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateTestENullableEvent_FieldSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char *data = static_cast<char *>(aStructureData);
+    uint8_t *nullifiedFields = reinterpret_cast<uint8_t *>(data + (offsetof(TestENullableEvent, neJ)) + Schema::Nest::Test::Trait::TestETrait::NullableE::FieldSchema.mSize);
+
+    // Memory allocated from an arena is released all at once when the arena is reset.
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+        return WEAVE_NO_ERROR;
+
+    if (!GET_FIELD_NULLIFIED_BIT(nullifiedFields, 3))
+    {
+        nl::SerializationFree(aContext, *reinterpret_cast<char **>(data + (offsetof(TestENullableEvent, neD))));
+    }
+
+    if (!GET_FIELD_NULLIFIED_BIT(nullifiedFields, 8))
+    {
+        nl::SerializationFree(aContext, *reinterpret_cast<char **>(data + (offsetof(TestENullableEvent, neI))));
+    }
+
+    if (!GET_FIELD_NULLIFIED_BIT(nullifiedFields, 9))
+    {
+        err = ::Schema::Nest::Test::Trait::TestETrait::DeallocateNullableE_FieldSchema(data + (offsetof(TestENullableEvent, neJ)), aContext);
+        SuccessOrExit(err);
+    }
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeTestENullableEvent_FieldSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeTestENullableEvent_FieldSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeTestENullableEvent_FieldSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeTestENullableEvent_FieldSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+} // TestETrait
+} // Trait
+} // Test
+} // Nest
+} // Schema
+
+#endif // TESTETRAITSERIALIZERS_H_
@@ -1747,6 +1747,118 @@ exit:
     return;
 }
 
+static void CheckArenaEventDeserialization(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+
+    Schema::Nest::Test::Trait::TestETrait::TestEEvent ev = { 0 };
+    Schema::Nest::Test::Trait::TestETrait::TestEEvent ev2 = { 0 };
+    nl::StructureSchemaPointerPair appData;
+    nl::Weave::TLV::TLVWriter outer, writer;
+    nl::Weave::TLV::TLVReader reader, outerReader;
+    uint8_t sBuffer[512];
+    uint64_t arenaBuffer[64];
+    nl::SerializationArena arena;
+    nl::SerializationContext serializationContext;
+    uint8_t *first;
+    uint8_t *second;
+    uint8_t *grown;
+
+    // The most recent allocation grows in place; an earlier one is copied.
+    arena.Init(arenaBuffer, sizeof(arenaBuffer));
+    first = static_cast<uint8_t *>(arena.Allocate(3));
+    NL_TEST_ASSERT(inSuite, first != NULL && arena.Contains(first));
+    memcpy(first, "abc", 3);
+    grown = static_cast<uint8_t *>(arena.Reallocate(first, 40));
+    NL_TEST_ASSERT(inSuite, grown == first);
+    second = static_cast<uint8_t *>(arena.Allocate(1));
+    NL_TEST_ASSERT(inSuite, second != NULL && (reinterpret_cast<uintptr_t>(second) % 8) == 0);
+    grown = static_cast<uint8_t *>(arena.Reallocate(first, 80));
+    NL_TEST_ASSERT(inSuite, grown != NULL && grown != first && memcmp(grown, "abc", 3) == 0);
+    NL_TEST_ASSERT(inSuite, arena.Allocate(sizeof(arenaBuffer)) == NULL);
+    NL_TEST_ASSERT(inSuite, arena.Reallocate(sBuffer, 1) == NULL);
+    arena.Reset();
+    NL_TEST_ASSERT(inSuite, arena.GetBytesUsed() == 0);
+
+    uint32_t numbaz[5] = { 1, 3, 5, 7, 10 };
+    Schema::Nest::Test::Trait::TestCommonTrait::CommonStructE strukchaz[3];
+    uint8_t bytes[4] = { 0xde, 0xad, 0xbe, 0xef };
+    strukchaz[0].seA = 1111111;
+    strukchaz[0].seB = true;
+    strukchaz[1].seA = 2222222;
+    strukchaz[1].seB = false;
+    strukchaz[2].seA = 3333333;
+    strukchaz[2].seB = true;
+    ev.teA = 444444;
+    ev.teH.num = sizeof(numbaz)/sizeof(numbaz[0]);
+    ev.teH.buf = numbaz;
+    ev.teI.num = sizeof(strukchaz)/sizeof(strukchaz[0]);
+    ev.teI.buf = strukchaz;
+    ev.teJ = 12121;
+    ev.teK.mBuf = bytes;
+    ev.teK.mLen = sizeof(bytes);
+
+    appData.mStructureData = static_cast<void *>(&ev);
+    appData.mFieldSchema = &Schema::Nest::Test::Trait::TestETrait::TestEEvent::FieldSchema;
+
+    outer.Init(sBuffer, sizeof(sBuffer));
+
+    err = outer.OpenContainer(ProfileTag(0x0A00, 1), kTLVType_Structure, writer);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = SerializedDataToTLVWriterHelper(writer, kTag_EventData, &appData);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = outer.CloseContainer(writer);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = outer.Finalize();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Now de-serialize into the arena, without any memory management functions.
+
+    serializationContext.mArena = &arena;
+
+    outerReader.Init(sBuffer, outer.GetLengthWritten());
+
+    err = outerReader.Next();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = outerReader.OpenContainer(reader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = reader.Next();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = nl::DeserializeEvent(reader, &ev2, &serializationContext);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    SuccessOrExit(err);
+
+    NL_TEST_ASSERT(inSuite, ev2.teA == ev.teA);
+    NL_TEST_ASSERT(inSuite, ev2.teH.num == ev.teH.num && arena.Contains(ev2.teH.buf));
+    for (uint32_t i = 0; i < ev2.teH.num; i++)
+    {
+        NL_TEST_ASSERT(inSuite, ev2.teH.buf[i] == ev.teH.buf[i]);
+    }
+    NL_TEST_ASSERT(inSuite, ev2.teI.num == ev.teI.num && arena.Contains(ev2.teI.buf));
+    for (uint32_t i = 0; i < ev2.teI.num; i++)
+    {
+        NL_TEST_ASSERT(inSuite, ev2.teI.buf[i].seA == ev.teI.buf[i].seA);
+        NL_TEST_ASSERT(inSuite, ev2.teI.buf[i].seB == ev.teI.buf[i].seB);
+    }
+    NL_TEST_ASSERT(inSuite, ev2.teK.mLen == ev.teK.mLen && arena.Contains(ev2.teK.mBuf));
+    NL_TEST_ASSERT(inSuite, memcmp(ev2.teK.mBuf, bytes, sizeof(bytes)) == 0);
+    NL_TEST_ASSERT(inSuite, arena.GetBytesUsed() > 0);
+
+    // Deallocation is left to the arena.
+    NL_TEST_ASSERT(inSuite, nl::DeallocateEvent(&ev2, &serializationContext) == WEAVE_NO_ERROR);
+    arena.Reset();
+    NL_TEST_ASSERT(inSuite, arena.GetBytesUsed() == 0);
+
+exit:
+    return;
+}
+
 static void CheckEmptyArrayEventDeserialization(nlTestSuite *inSuite, void *inContext)
 {
     TestLoggingContext *context = static_cast<TestLoggingContext *>(inContext);
@@ -3163,6 +3275,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("Basic Deserialization Test", CheckBasicEventDeserialization),
     NL_TEST_DEF("Complex Deserialization Test", CheckComplexEventDeserialization),
     NL_TEST_DEF("Empty Array Deserialization Test", CheckEmptyArrayEventDeserialization),
+    NL_TEST_DEF("Arena Deserialization Test", CheckArenaEventDeserialization),
     NL_TEST_DEF("Simple Nullable Fields Test", CheckNullableFieldsSimple),
     NL_TEST_DEF("Complex Nullable Fields Test", CheckNullableFieldsComplex),
     NL_TEST_DEF("Check Deserializing an Event from a Newer Version", CheckDeserializingNewerVersion),
@@ -0,0 +1,841 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      Specialized TLV serializers for the schemas in:
+ *
+ *        TestEventLoggingSchemaExamples.h
+ *
+ *      !!! WARNING !!! WARNING !!! WARNING !!!
+ *
+ *      DO NOT EDIT THIS FILE! This file is generated by the
+ *      gen-tlv-serializers.py script.
+ *
+ *      To make changes, edit the schema definitions and re-run the
+ *      script to generate this file.
+ *
+ */
+
+#ifndef TESTEVENTLOGGINGSCHEMASERIALIZERS_H_
+#define TESTEVENTLOGGINGSCHEMASERIALIZERS_H_
+
+#include <stddef.h>
+
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/SerializationUtils.h>
+#include "TestEventLoggingSchemaExamples.h"
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+
+// eventStatsSchema
+
+inline WEAVE_ERROR SerializeEventStatsSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.PutString(ContextTag(1), *reinterpret_cast<const char * const *>(data + (offsetof(eventStats, str))));
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeEventStatsSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            {
+                uint32_t length = aReader.GetLength() + 1;
+                char *string = static_cast<char *>(nl::SerializationAllocate(aContext, length));
+
+                VerifyOrExit(string != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+                err = aReader.GetString(string, length);
+                if (err != WEAVE_NO_ERROR)
+                    nl::SerializationFree(aContext, string);
+                SuccessOrExit(err);
+                *reinterpret_cast<char **>(data + (offsetof(eventStats, str))) = string;
+            }
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateEventStatsSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char *data = static_cast<char *>(aStructureData);
+
+    // Memory allocated from an arena is released all at once when the arena is reset.
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+        return WEAVE_NO_ERROR;
+
+    nl::SerializationFree(aContext, *reinterpret_cast<char **>(data + (offsetof(eventStats, str))));
+
+    return err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeEventStatsSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeEventStatsSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeEventStatsSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeEventStatsSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+// eventStructSchema
+
+inline WEAVE_ERROR SerializeEventStructSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.PutBoolean(ContextTag(1), *reinterpret_cast<const bool *>(data + (offsetof(eventStruct, a))));
+    SuccessOrExit(err);
+
+    err = ::nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)::SerializeEventStatsSchema(aWriter, ContextTag(2), data + (offsetof(eventStruct, b)));
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeEventStructSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            err = aReader.Get(*reinterpret_cast<bool *>(data + (offsetof(eventStruct, a))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 2:
+        {
+            if (nextField > 1)
+                break;
+            nextField = 2;
+
+            err = ::nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)::DeserializeEventStatsSchema(aReader, data + (offsetof(eventStruct, b)), aContext);
+            SuccessOrExit(err);
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateEventStructSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char *data = static_cast<char *>(aStructureData);
+
+    // Memory allocated from an arena is released all at once when the arena is reset.
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+        return WEAVE_NO_ERROR;
+
+    err = ::nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)::DeallocateEventStatsSchema(data + (offsetof(eventStruct, b)), aContext);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeEventStructSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeEventStructSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeEventStructSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeEventStructSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+// sampleEventSchema
+
+inline WEAVE_ERROR SerializeSampleEventSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(1), *reinterpret_cast<const uint32_t *>(data + (offsetof(SampleTrait::Event, state))));
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(2), *reinterpret_cast<const uint32_t *>(data + (offsetof(SampleTrait::Event, timestamp))));
+    SuccessOrExit(err);
+
+    err = ::nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)::SerializeEventStructSchema(aWriter, ContextTag(3), data + (offsetof(SampleTrait::Event, structure)));
+    SuccessOrExit(err);
+
+    {
+        const nl::ArrayLengthAndBuffer *array = reinterpret_cast<const nl::ArrayLengthAndBuffer *>(data + (offsetof(SampleTrait::Event, samples) + offsetof(SampleTrait::samplesArray, num_samples)));
+        TLVType arrayType;
+
+        err = aWriter.StartContainer(ContextTag(4), kTLVType_Array, arrayType);
+        SuccessOrExit(err);
+
+        for (uint32_t i = 0; i < array->mNumElements; i++)
+        {
+            err = aWriter.Put(AnonymousTag, *(static_cast<const uint32_t *>(array->mElementBuffer) + i));
+            SuccessOrExit(err);
+        }
+
+        err = aWriter.EndContainer(arrayType);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeSampleEventSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(SampleTrait::Event, state))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 2:
+        {
+            if (nextField > 1)
+                break;
+            nextField = 2;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(SampleTrait::Event, timestamp))));
+            SuccessOrExit(err);
+            break;
+        }
+        case 3:
+        {
+            if (nextField > 2)
+                break;
+            nextField = 3;
+
+            err = ::nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)::DeserializeEventStructSchema(aReader, data + (offsetof(SampleTrait::Event, structure)), aContext);
+            SuccessOrExit(err);
+            break;
+        }
+        case 4:
+        {
+            if (nextField > 3)
+                break;
+            nextField = 4;
+
+            {
+                nl::ArrayLengthAndBuffer *array = reinterpret_cast<nl::ArrayLengthAndBuffer *>(data + (offsetof(SampleTrait::Event, samples) + offsetof(SampleTrait::samplesArray, num_samples)));
+                TLVType arrayType;
+                uint32_t capacity = 0;
+
+                array->mNumElements = 0;
+                array->mElementBuffer = NULL;
+
+                err = aReader.EnterContainer(arrayType);
+                SuccessOrExit(err);
+                VerifyOrExit(aReader.GetContainerType() == kTLVType_Array, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+                while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+                {
+                    if (array->mNumElements == capacity)
+                    {
+                        void *buffer;
+
+                        capacity = (capacity == 0) ? 2 : capacity * 2;
+                        buffer = nl::SerializationReallocate(aContext, array->mElementBuffer, capacity * sizeof(uint32_t));
+                        VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+                        array->mElementBuffer = buffer;
+                    }
+
+                    err = aReader.Get(*(static_cast<uint32_t *>(array->mElementBuffer) + array->mNumElements));
+                    SuccessOrExit(err);
+                    array->mNumElements++;
+                }
+
+                VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+                err = aReader.ExitContainer(arrayType);
+                SuccessOrExit(err);
+            }
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateSampleEventSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char *data = static_cast<char *>(aStructureData);
+
+    // Memory allocated from an arena is released all at once when the arena is reset.
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+        return WEAVE_NO_ERROR;
+
+    err = ::nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)::DeallocateEventStructSchema(data + (offsetof(SampleTrait::Event, structure)), aContext);
+    SuccessOrExit(err);
+
+    {
+        nl::ArrayLengthAndBuffer *array = reinterpret_cast<nl::ArrayLengthAndBuffer *>(data + (offsetof(SampleTrait::Event, samples) + offsetof(SampleTrait::samplesArray, num_samples)));
+        nl::SerializationFree(aContext, array->mElementBuffer);
+    }
+
+exit:
+    return err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeSampleEventSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeSampleEventSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeSampleEventSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeSampleEventSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+// openCloseEventSchema
+
+inline WEAVE_ERROR SerializeOpenCloseEventSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.Put(ContextTag(1), *reinterpret_cast<const uint32_t *>(data + (offsetof(OpenCloseTrait::Event, state))));
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeOpenCloseEventSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            err = aReader.Get(*reinterpret_cast<uint32_t *>(data + (offsetof(OpenCloseTrait::Event, state))));
+            SuccessOrExit(err);
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateOpenCloseEventSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    return WEAVE_NO_ERROR;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeOpenCloseEventSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeOpenCloseEventSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeOpenCloseEventSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeOpenCloseEventSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+// ByteStringTestEventSchema
+
+inline WEAVE_ERROR SerializeByteStringTestEventSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    err = aWriter.PutBytes(ContextTag(1), (reinterpret_cast<const nl::SerializedByteString *>(data + (offsetof(ByteStringTestTrait::Event, byte_string))))->mBuf, (reinterpret_cast<const nl::SerializedByteString *>(data + (offsetof(ByteStringTestTrait::Event, byte_string))))->mLen);
+    SuccessOrExit(err);
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeByteStringTestEventSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            {
+                nl::SerializedByteString *byteString = reinterpret_cast<nl::SerializedByteString *>(data + (offsetof(ByteStringTestTrait::Event, byte_string)));
+                uint32_t length = aReader.GetLength();
+                uint8_t *buffer = static_cast<uint8_t *>(nl::SerializationAllocate(aContext, length));
+
+                VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+                err = aReader.GetBytes(buffer, length);
+                if (err != WEAVE_NO_ERROR)
+                    nl::SerializationFree(aContext, buffer);
+                SuccessOrExit(err);
+                byteString->mBuf = buffer;
+                byteString->mLen = length;
+            }
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateByteStringTestEventSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char *data = static_cast<char *>(aStructureData);
+
+    // Memory allocated from an arena is released all at once when the arena is reset.
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+        return WEAVE_NO_ERROR;
+
+    nl::SerializationFree(aContext, (reinterpret_cast<nl::SerializedByteString *>(data + (offsetof(ByteStringTestTrait::Event, byte_string))))->mBuf);
+
+    return err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeByteStringTestEventSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeByteStringTestEventSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeByteStringTestEventSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeByteStringTestEventSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+// ByteStringArrayTestEventSchema
+
+inline WEAVE_ERROR SerializeByteStringArrayTestEventSchema(nl::Weave::TLV::TLVWriter &aWriter, uint64_t aTag, const void *aStructureData)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    const char *data = static_cast<const char *>(aStructureData);
+
+    err = aWriter.StartContainer(aTag, kTLVType_Structure, containerType);
+    SuccessOrExit(err);
+
+    {
+        const nl::ArrayLengthAndBuffer *array = reinterpret_cast<const nl::ArrayLengthAndBuffer *>(data + (offsetof(ByteStringArrayTestTrait::Event, testArray) + offsetof(ByteStringArrayTestTrait::byteString_array, num)));
+        TLVType arrayType;
+
+        err = aWriter.StartContainer(ContextTag(1), kTLVType_Array, arrayType);
+        SuccessOrExit(err);
+
+        for (uint32_t i = 0; i < array->mNumElements; i++)
+        {
+            err = aWriter.PutBytes(AnonymousTag, ((static_cast<const nl::SerializedByteString *>(array->mElementBuffer) + i))->mBuf, ((static_cast<const nl::SerializedByteString *>(array->mElementBuffer) + i))->mLen);
+            SuccessOrExit(err);
+        }
+
+        err = aWriter.EndContainer(arrayType);
+        SuccessOrExit(err);
+    }
+
+    err = aWriter.EndContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeByteStringArrayTestEventSchema(nl::Weave::TLV::TLVReader &aReader, void *aStructureData, nl::SerializationContext *aContext)
+{
+    using namespace nl::Weave::TLV;
+
+    WEAVE_ERROR err;
+    TLVType containerType;
+    char *data = static_cast<char *>(aStructureData);
+    uint32_t nextField = 0;
+
+    err = aReader.EnterContainer(containerType);
+    SuccessOrExit(err);
+    VerifyOrExit(aReader.GetContainerType() == kTLVType_Structure, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+    // Fields are expected in schema order; one found out of order is skipped like an unknown field.
+    while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+    {
+        switch (TagNumFromTag(aReader.GetTag()))
+        {
+        case 1:
+        {
+            if (nextField > 0)
+                break;
+            nextField = 1;
+
+            {
+                nl::ArrayLengthAndBuffer *array = reinterpret_cast<nl::ArrayLengthAndBuffer *>(data + (offsetof(ByteStringArrayTestTrait::Event, testArray) + offsetof(ByteStringArrayTestTrait::byteString_array, num)));
+                TLVType arrayType;
+                uint32_t capacity = 0;
+
+                array->mNumElements = 0;
+                array->mElementBuffer = NULL;
+
+                err = aReader.EnterContainer(arrayType);
+                SuccessOrExit(err);
+                VerifyOrExit(aReader.GetContainerType() == kTLVType_Array, err = WEAVE_ERROR_WRONG_TLV_TYPE);
+
+                while ((err = aReader.Next()) == WEAVE_NO_ERROR)
+                {
+                    if (array->mNumElements == capacity)
+                    {
+                        void *buffer;
+
+                        capacity = (capacity == 0) ? 2 : capacity * 2;
+                        buffer = nl::SerializationReallocate(aContext, array->mElementBuffer, capacity * sizeof(nl::SerializedByteString));
+                        VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+                        array->mElementBuffer = buffer;
+                    }
+
+                    {
+                        nl::SerializedByteString *byteString = (static_cast<nl::SerializedByteString *>(array->mElementBuffer) + array->mNumElements);
+                        uint32_t length = aReader.GetLength();
+                        uint8_t *buffer = static_cast<uint8_t *>(nl::SerializationAllocate(aContext, length));
+
+                        VerifyOrExit(buffer != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+                        err = aReader.GetBytes(buffer, length);
+                        if (err != WEAVE_NO_ERROR)
+                            nl::SerializationFree(aContext, buffer);
+                        SuccessOrExit(err);
+                        byteString->mBuf = buffer;
+                        byteString->mLen = length;
+                    }
+                    array->mNumElements++;
+                }
+
+                VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+                err = aReader.ExitContainer(arrayType);
+                SuccessOrExit(err);
+            }
+            break;
+        }
+        default:
+            // Unknown fields are skipped.
+            break;
+        }
+    }
+
+    VerifyOrExit(err == WEAVE_END_OF_TLV, );
+
+    err = aReader.ExitContainer(containerType);
+    SuccessOrExit(err);
+
+exit:
+    return err;
+}
+
+inline WEAVE_ERROR DeallocateByteStringArrayTestEventSchema(void *aStructureData, nl::SerializationContext *aContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    char *data = static_cast<char *>(aStructureData);
+
+    // Memory allocated from an arena is released all at once when the arena is reset.
+    if ((aContext != NULL) && (aContext->mArena != NULL))
+        return WEAVE_NO_ERROR;
+
+    {
+        nl::ArrayLengthAndBuffer *array = reinterpret_cast<nl::ArrayLengthAndBuffer *>(data + (offsetof(ByteStringArrayTestTrait::Event, testArray) + offsetof(ByteStringArrayTestTrait::byteString_array, num)));
+
+        for (uint32_t i = 0; i < array->mNumElements; i++)
+        {
+            nl::SerializationFree(aContext, ((static_cast<nl::SerializedByteString *>(array->mElementBuffer) + i))->mBuf);
+        }
+
+        nl::SerializationFree(aContext, array->mElementBuffer);
+    }
+
+    return err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+inline WEAVE_ERROR SerializeByteStringArrayTestEventSchemaHelper(nl::Weave::TLV::TLVWriter &aWriter, uint8_t aDataTag, void *aAppData)
+{
+    return SerializeByteStringArrayTestEventSchema(aWriter, nl::Weave::TLV::ContextTag(aDataTag), aAppData);
+}
+
+#if WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+inline WEAVE_ERROR DeserializeByteStringArrayTestEventSchemaHelper(nl::Weave::TLV::TLVReader &aReader, uint8_t aDataTag, void *aAppData,
+        nl::SerializationContext *aContext = NULL)
+{
+    WEAVE_ERROR err = DeserializeByteStringArrayTestEventSchema(aReader, aAppData, aContext);
+
+    if (err == WEAVE_NO_ERROR)
+        err = aReader.Next();
+
+    return (err == WEAVE_END_OF_TLV) ? WEAVE_NO_ERROR : err;
+}
+#endif // WEAVE_CONFIG_SERIALIZATION_ENABLE_DESERIALIZATION
+
+} // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+} // Profiles
+} // Weave
+} // nl
+
+#endif // TESTEVENTLOGGINGSCHEMASERIALIZERS_H_
@@ -0,0 +1,207 @@
+/*
+ *
+ *    Copyright (c) 2016-2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements unit tests for the peer state and session
+ *      key tables of WeaveFabricState, including duplicate message
+ *      detection across peer table eviction.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdio.h>
+#include <nltest.h>
+
+#include "ToolCommon.h"
+#include <Weave/Core/WeaveConfig.h>
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+#include "lwip/tcpip.h"
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+using namespace nl::Weave;
+
+static const uint64_t kTestPeerNodeIdBase = 0x18B4300000000100ULL;
+static const uint64_t kTestNumKeyPeers = 7;
+
+static WeaveFabricState sFabricState;
+
+static bool IsDuplicate(uint64_t peerNodeId, uint32_t msgId)
+{
+    WeaveSessionState sessionState;
+
+    sFabricState.GetSessionState(peerNodeId, WeaveKeyId::kNone, kWeaveEncryptionType_None, NULL, sessionState);
+
+    return sessionState.IsDuplicateMessage(msgId);
+}
+
+static uint16_t TestKeyId(int i)
+{
+    return WeaveKeyId::MakeSessionKeyId(static_cast<uint16_t>(1 + i / kTestNumKeyPeers));
+}
+
+static uint64_t TestKeyPeer(int i)
+{
+    return kTestPeerNodeIdBase + (i % kTestNumKeyPeers);
+}
+
+static void CheckSessionKeyTable(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    WeaveSessionKey *sessionKey;
+    uint16_t keyId;
+
+    // Fill the table. Key ids repeat across peers, so keys are only distinguished by (key id, peer).
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        keyId = TestKeyId(i);
+        err = sFabricState.AllocSessionKey(TestKeyPeer(i), NULL, keyId);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    keyId = WeaveKeyId::MakeSessionKeyId(0x7FF);
+    err = sFabricState.AllocSessionKey(kTestPeerNodeIdBase, NULL, keyId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_TOO_MANY_KEYS);
+
+    keyId = TestKeyId(0);
+    err = sFabricState.AllocSessionKey(TestKeyPeer(0), NULL, keyId);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_DUPLICATE_KEY_ID);
+
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.GetSessionKey(TestKeyId(i), TestKeyPeer(i), sessionKey);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR && sessionKey->NodeId == TestKeyPeer(i) && sessionKey->MsgEncKey.KeyId == TestKeyId(i));
+    }
+
+    err = sFabricState.GetSessionKey(TestKeyId(0), kTestPeerNodeIdBase + kTestNumKeyPeers, sessionKey);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_KEY_NOT_FOUND);
+
+    // Removing keys must leave every other key reachable, whatever its position in the probe sequences.
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i += 3)
+    {
+        err = sFabricState.RemoveSessionKey(TestKeyId(i), TestKeyPeer(i));
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.GetSessionKey(TestKeyId(i), TestKeyPeer(i), sessionKey);
+        NL_TEST_ASSERT(inSuite, err == ((i % 3 == 0) ? WEAVE_ERROR_KEY_NOT_FOUND : WEAVE_NO_ERROR));
+    }
+
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i += 3)
+    {
+        keyId = TestKeyId(i);
+        err = sFabricState.AllocSessionKey(TestKeyPeer(i), NULL, keyId);
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+
+    for (int i = 0; i < WEAVE_CONFIG_MAX_SESSION_KEYS; i++)
+    {
+        err = sFabricState.RemoveSessionKey(TestKeyId(i), TestKeyPeer(i));
+        NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    }
+}
+
+static void CheckReplayWindow(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t peerNodeId = kTestPeerNodeIdBase;
+    const uint32_t maxMsgId = 1000;
+
+    NL_TEST_ASSERT(inSuite, !IsDuplicate(peerNodeId, maxMsgId));
+    NL_TEST_ASSERT(inSuite, IsDuplicate(peerNodeId, maxMsgId));
+
+    // Every one of the 63 message ids preceding the maximum is tracked.
+    for (uint32_t delta = 1; delta <= WeaveSessionState::kReceiveFlags_NumMessageIdFlags; delta++)
+        NL_TEST_ASSERT(inSuite, !IsDuplicate(peerNodeId, maxMsgId - delta));
+
+    for (uint32_t delta = 0; delta <= WeaveSessionState::kReceiveFlags_NumMessageIdFlags; delta++)
+        NL_TEST_ASSERT(inSuite, IsDuplicate(peerNodeId, maxMsgId - delta));
+
+    // Advancing the window by less than its width keeps the ids still inside it.
+    NL_TEST_ASSERT(inSuite, !IsDuplicate(peerNodeId, maxMsgId + 10));
+    NL_TEST_ASSERT(inSuite, IsDuplicate(peerNodeId, maxMsgId + 10 - WeaveSessionState::kReceiveFlags_NumMessageIdFlags));
+    NL_TEST_ASSERT(inSuite, !IsDuplicate(peerNodeId, maxMsgId + 9));
+}
+
+static void CheckPeerEviction(nlTestSuite *inSuite, void *inContext)
+{
+    const uint64_t activePeerNodeId = 0x18B43000000000AAULL;
+    const uint64_t churnPeerNodeIdBase = 0x18B4300000010000ULL;
+    const int numChurnPeers = 4 * WEAVE_CONFIG_MAX_PEER_NODES;
+    uint32_t activeMsgId = 5000;
+
+    // A peer that keeps talking survives any number of other peers passing through the table.
+    for (int i = 0; i < numChurnPeers; i++)
+    {
+        NL_TEST_ASSERT(inSuite, !IsDuplicate(churnPeerNodeIdBase + i, 7));
+        NL_TEST_ASSERT(inSuite, !IsDuplicate(activePeerNodeId, ++activeMsgId));
+    }
+
+    NL_TEST_ASSERT(inSuite, IsDuplicate(activePeerNodeId, activeMsgId));
+    NL_TEST_ASSERT(inSuite, IsDuplicate(activePeerNodeId, activeMsgId - 1));
+
+    // The most recent other peers are still tracked...
+    for (int i = numChurnPeers - (WEAVE_CONFIG_MAX_PEER_NODES - 1); i < numChurnPeers; i++)
+        NL_TEST_ASSERT(inSuite, IsDuplicate(churnPeerNodeIdBase + i, 7));
+
+    // ...while the least recently used were evicted, so their state starts afresh.
+    NL_TEST_ASSERT(inSuite, !IsDuplicate(churnPeerNodeIdBase, 7));
+}
+
+static int TestSetup(void *inContext)
+{
+    return (sFabricState.Init() == WEAVE_NO_ERROR) ? SUCCESS : FAILURE;
+}
+
+static int TestTeardown(void *inContext)
+{
+    sFabricState.Shutdown();
+    return SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+    static const nlTest tests[] = {
+        NL_TEST_DEF("SessionKeyTable",                  CheckSessionKeyTable),
+        NL_TEST_DEF("ReplayWindow",                     CheckReplayWindow),
+        NL_TEST_DEF("PeerEviction",                     CheckPeerEviction),
+        NL_TEST_SENTINEL()
+    };
+
+    static nlTestSuite testSuite = {
+        "fabric-state-peers",
+        &tests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+#if WEAVE_SYSTEM_CONFIG_USE_LWIP
+    tcpip_init(NULL, NULL);
+#endif // WEAVE_SYSTEM_CONFIG_USE_LWIP
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&testSuite, NULL);
+
+    return nlTestRunnerStats(&testSuite);
+}
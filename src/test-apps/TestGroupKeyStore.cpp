@@ -465,6 +465,9 @@ WEAVE_ERROR TestGroupKeyStore::StoreGroupKey(const WeaveGroupKey& key)
     else if (WeaveKeyId::IsAppGroupMasterKey(key.KeyId))
         Keys[ind].GlobalId = key.GlobalId;
 
+    // Keys derived from the old key material are no longer valid.
+    OnGroupKeysChange();
+
 exit:
     return err;
 }
@@ -484,6 +487,9 @@ WEAVE_ERROR TestGroupKeyStore::DeleteGroupKey(uint32_t keyId)
             Keys[i].StartTime = 0;
             Keys[i].GlobalId = 0;
 
+            // Keys derived from the deleted key are no longer valid.
+            OnGroupKeysChange();
+
             ExitNow();
         }
     }
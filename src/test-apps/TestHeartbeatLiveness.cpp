@@ -0,0 +1,247 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for
+ *      <tt>nl::Weave::Profiles::Heartbeat::WeaveHeartbeatLivenessTracker</tt>,
+ *      which tracks whether heartbeat senders are still alive.
+ *
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <nltest.h>
+
+#include "ToolCommon.h"
+#include <Weave/Profiles/heartbeat/WeaveHeartbeat.h>
+
+using namespace nl::Weave::Profiles::Heartbeat;
+
+#define TEST_TICK_MS            10
+#define TEST_INTERVAL_MS        10
+#define TEST_NUM_ENTRIES        100
+#define TEST_WAIT_LIMIT_MS      2000
+
+struct TestContext
+{
+    WeaveHeartbeatLivenessTracker Tracker;
+    WeaveHeartbeatLivenessTracker::NodeEntry Entries[TEST_NUM_ENTRIES];
+    uint32_t WentOffline;
+    uint32_t CameBack;
+    uint32_t Callbacks;
+    uint32_t LargestBatch;
+};
+
+static TestContext sContext;
+
+static void HandleLivenessChange(void *appState, WeaveHeartbeatLivenessTracker::LivenessEvent event, const uint64_t *nodeIds,
+                                 uint32_t numNodeIds)
+{
+    TestContext *context = static_cast<TestContext *>(appState);
+
+    if (event == WeaveHeartbeatLivenessTracker::kLivenessEvent_WentOffline)
+        context->WentOffline += numNodeIds;
+    else
+        context->CameBack += numNodeIds;
+
+    context->Callbacks++;
+    if (numNodeIds > context->LargestBatch)
+        context->LargestBatch = numNodeIds;
+}
+
+static void InitTracker(nlTestSuite *inSuite, TestContext *context, uint32_t numEntries)
+{
+    WEAVE_ERROR err;
+
+    memset(&context->Entries, 0, sizeof(context->Entries));
+    context->WentOffline = 0;
+    context->CameBack = 0;
+    context->Callbacks = 0;
+    context->LargestBatch = 0;
+
+    context->Tracker.AppState = context;
+    context->Tracker.OnLivenessChange = HandleLivenessChange;
+
+    err = context->Tracker.Init(&SystemLayer, context->Entries, numEntries, TEST_TICK_MS);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+}
+
+static void CheckArguments(nlTestSuite *inSuite, void *inContext)
+{
+    TestContext *context = static_cast<TestContext *>(inContext);
+    WeaveHeartbeatLivenessTracker &tracker = context->Tracker;
+
+    NL_TEST_ASSERT(inSuite, tracker.AddNode(1, TEST_INTERVAL_MS) == WEAVE_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, tracker.Init(&SystemLayer, context->Entries, 0, TEST_TICK_MS) == WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, tracker.Init(&SystemLayer, NULL, TEST_NUM_ENTRIES, TEST_TICK_MS) == WEAVE_ERROR_INVALID_ARGUMENT);
+
+    InitTracker(inSuite, context, TEST_NUM_ENTRIES);
+
+    NL_TEST_ASSERT(inSuite, tracker.Init(&SystemLayer, context->Entries, TEST_NUM_ENTRIES, TEST_TICK_MS) == WEAVE_ERROR_INCORRECT_STATE);
+    NL_TEST_ASSERT(inSuite, tracker.AddNode(1, 0) == WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, tracker.RemoveNode(1) == WEAVE_ERROR_KEY_NOT_FOUND);
+
+    tracker.Shutdown();
+}
+
+static void CheckCapacity(nlTestSuite *inSuite, void *inContext)
+{
+    TestContext *context = static_cast<TestContext *>(inContext);
+    WeaveHeartbeatLivenessTracker &tracker = context->Tracker;
+    WeaveHeartbeatLivenessTracker::Stats stats;
+
+    InitTracker(inSuite, context, 4);
+
+    // Node ids that collide in the 4-bucket index.
+    for (uint64_t i = 0; i < 4; i++)
+        NL_TEST_ASSERT(inSuite, tracker.AddNode(0x18B4300000000000ULL + i * 4, 1000) == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, tracker.AddNode(0x18B4300000000100ULL, 1000) == WEAVE_ERROR_NO_MEMORY);
+
+    // Re-adding a tracked node updates it rather than consuming an entry.
+    NL_TEST_ASSERT(inSuite, tracker.AddNode(0x18B4300000000004ULL, 2000) == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, tracker.RemoveNode(0x18B4300000000004ULL) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !tracker.IsNodeTracked(0x18B4300000000004ULL));
+    NL_TEST_ASSERT(inSuite, tracker.IsNodeOnline(0x18B4300000000008ULL));
+    NL_TEST_ASSERT(inSuite, tracker.AddNode(0x18B4300000000100ULL, 1000) == WEAVE_NO_ERROR);
+
+    tracker.GetStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.Capacity == 4);
+    NL_TEST_ASSERT(inSuite, stats.NodesTracked == 4);
+    NL_TEST_ASSERT(inSuite, stats.NodesOnline == 4);
+
+    tracker.Shutdown();
+}
+
+static void CheckOfflineAndBack(nlTestSuite *inSuite, void *inContext)
+{
+    TestContext *context = static_cast<TestContext *>(inContext);
+    WeaveHeartbeatLivenessTracker &tracker = context->Tracker;
+    WeaveHeartbeatLivenessTracker::Stats stats;
+    const uint32_t kNumNodes = TEST_NUM_ENTRIES;
+
+    InitTracker(inSuite, context, TEST_NUM_ENTRIES);
+
+    for (uint64_t i = 1; i <= kNumNodes; i++)
+        NL_TEST_ASSERT(inSuite, tracker.AddNode(i, TEST_INTERVAL_MS) == WEAVE_NO_ERROR);
+
+    // With no heartbeats every node goes offline, reported in batches.
+    ServiceNetworkUntilCount(context->WentOffline, kNumNodes, TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, context->WentOffline == kNumNodes);
+    NL_TEST_ASSERT(inSuite, context->LargestBatch <= WEAVE_CONFIG_HEARTBEAT_LIVENESS_BATCH_SIZE);
+    NL_TEST_ASSERT(inSuite, context->Callbacks < kNumNodes);
+    NL_TEST_ASSERT(inSuite, !tracker.IsNodeOnline(1));
+
+    tracker.GetStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.NodesOffline == kNumNodes);
+    NL_TEST_ASSERT(inSuite, stats.WentOfflineCount == kNumNodes);
+
+    // A heartbeat brings a node back immediately; the notification follows at the next tick.
+    for (uint64_t i = 1; i <= kNumNodes / 2; i++)
+        NL_TEST_ASSERT(inSuite, tracker.HandleHeartbeat(i) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, tracker.IsNodeOnline(1));
+    NL_TEST_ASSERT(inSuite, tracker.HandleHeartbeat(kNumNodes + 1) == WEAVE_ERROR_KEY_NOT_FOUND);
+
+    ServiceNetworkUntilCount(context->CameBack, kNumNodes / 2, TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, context->CameBack == kNumNodes / 2);
+
+    tracker.GetStats(stats);
+    NL_TEST_ASSERT(inSuite, stats.NodesOnline == kNumNodes / 2);
+    NL_TEST_ASSERT(inSuite, stats.CameBackCount == kNumNodes / 2);
+    NL_TEST_ASSERT(inSuite, stats.HeartbeatsReceived == kNumNodes / 2);
+    NL_TEST_ASSERT(inSuite, stats.HeartbeatsUntracked == 1);
+
+    // Those nodes go silent again.
+    ServiceNetworkUntilCount(context->WentOffline, kNumNodes + kNumNodes / 2, TEST_WAIT_LIMIT_MS);
+    NL_TEST_ASSERT(inSuite, context->WentOffline == kNumNodes + kNumNodes / 2);
+
+    tracker.Shutdown();
+}
+
+static void CheckStaysOnline(nlTestSuite *inSuite, void *inContext)
+{
+    TestContext *context = static_cast<TestContext *>(inContext);
+    WeaveHeartbeatLivenessTracker &tracker = context->Tracker;
+    uint64_t start;
+    uint64_t lastBeat;
+    uint64_t now;
+
+    InitTracker(inSuite, context, TEST_NUM_ENTRIES);
+
+    // Node 1 keeps sending heartbeats; node 2 is silent.
+    NL_TEST_ASSERT(inSuite, tracker.AddNode(1, TEST_INTERVAL_MS) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, tracker.AddNode(2, TEST_INTERVAL_MS) == WEAVE_NO_ERROR);
+
+    start = lastBeat = static_cast<uint64_t>(nl::Weave::System::Timer::GetCurrentEpoch());
+    do
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 1000;
+        ServiceEvents(sleepTime);
+
+        now = static_cast<uint64_t>(nl::Weave::System::Timer::GetCurrentEpoch());
+        if (now - lastBeat >= TEST_INTERVAL_MS)
+        {
+            tracker.HandleHeartbeat(1);
+            lastBeat = now;
+        }
+    } while (now - start < 20 * TEST_INTERVAL_MS);
+
+    NL_TEST_ASSERT(inSuite, tracker.IsNodeOnline(1));
+    NL_TEST_ASSERT(inSuite, !tracker.IsNodeOnline(2));
+    NL_TEST_ASSERT(inSuite, context->WentOffline == 1);
+    NL_TEST_ASSERT(inSuite, context->CameBack == 0);
+
+    tracker.Shutdown();
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF("HeartbeatLiveness::Arguments",         CheckArguments),
+    NL_TEST_DEF("HeartbeatLiveness::Capacity",          CheckCapacity),
+    NL_TEST_DEF("HeartbeatLiveness::OfflineAndBack",    CheckOfflineAndBack),
+    NL_TEST_DEF("HeartbeatLiveness::StaysOnline",       CheckStaysOnline),
+    NL_TEST_SENTINEL()
+};
+
+int main(int argc, char *argv[])
+{
+    nlTestSuite theSuite = {
+        "heartbeat-liveness",
+        &sTests[0],
+        NULL,
+        NULL
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    InitSystemLayer();
+
+    nlTestRunner(&theSuite, &sContext);
+
+    ShutdownSystemLayer();
+
+    return nlTestRunnerStats(&theSuite);
+}
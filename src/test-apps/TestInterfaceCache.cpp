@@ -0,0 +1,527 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the interface cache of
+ *      the InetLayer, checking that the interface iterators and the
+ *      interface name lookups answer from it exactly as they do from the
+ *      system, and that changes are reported when the table overflows and
+ *      when notifications are lost.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include <InetLayer/InetLayer.h>
+#include <Weave/Core/WeaveEncoding.h>
+#include "ToolCommon.h"
+
+#include <nltest.h>
+
+using namespace nl::Inet;
+
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+namespace nl {
+namespace Inet {
+
+// Feeds the cache notifications about interfaces and addresses that don't exist on the system.
+class InterfaceCacheTestObject
+{
+public:
+    static void InjectLink(InterfaceCache &cache, uint16_t msgType, InterfaceId intfId, const char *name, unsigned int flags);
+    static void InjectAddress(InterfaceCache &cache, uint16_t msgType, InterfaceId intfId, const IPAddress &addr);
+    static void FinishNotifications(InterfaceCache &cache, bool lostChanges);
+};
+
+void InterfaceCacheTestObject::InjectLink(InterfaceCache &cache, uint16_t msgType, InterfaceId intfId, const char *name,
+    unsigned int flags)
+{
+    uint32_t buf[64];
+    struct nlmsghdr *msg = reinterpret_cast<struct nlmsghdr *>(buf);
+    struct ifinfomsg *ifi = reinterpret_cast<struct ifinfomsg *>(NLMSG_DATA(msg));
+    struct rtattr *attr = reinterpret_cast<struct rtattr *>(reinterpret_cast<uint8_t *>(ifi) + NLMSG_ALIGN(sizeof(*ifi)));
+    size_t nameLen = strlen(name) + 1;
+
+    memset(buf, 0, sizeof(buf));
+    ifi->ifi_family = AF_UNSPEC;
+    ifi->ifi_index = static_cast<int>(intfId);
+    ifi->ifi_flags = flags;
+    attr->rta_type = IFLA_IFNAME;
+    attr->rta_len = RTA_LENGTH(nameLen);
+    memcpy(RTA_DATA(attr), name, nameLen);
+    msg->nlmsg_type = msgType;
+    msg->nlmsg_len = NLMSG_LENGTH(NLMSG_ALIGN(sizeof(*ifi)) + RTA_ALIGN(attr->rta_len));
+
+    cache.ProcessMessage(msg, true);
+}
+
+void InterfaceCacheTestObject::InjectAddress(InterfaceCache &cache, uint16_t msgType, InterfaceId intfId, const IPAddress &addr)
+{
+    uint32_t buf[64];
+    struct nlmsghdr *msg = reinterpret_cast<struct nlmsghdr *>(buf);
+    struct ifaddrmsg *ifa = reinterpret_cast<struct ifaddrmsg *>(NLMSG_DATA(msg));
+    struct rtattr *attr = reinterpret_cast<struct rtattr *>(reinterpret_cast<uint8_t *>(ifa) + NLMSG_ALIGN(sizeof(*ifa)));
+    struct in6_addr ipv6Addr = addr.ToIPv6();
+
+    memset(buf, 0, sizeof(buf));
+    ifa->ifa_family = AF_INET6;
+    ifa->ifa_prefixlen = 64;
+    ifa->ifa_index = intfId;
+    attr->rta_type = IFA_ADDRESS;
+    attr->rta_len = RTA_LENGTH(sizeof(ipv6Addr));
+    memcpy(RTA_DATA(attr), &ipv6Addr, sizeof(ipv6Addr));
+    msg->nlmsg_type = msgType;
+    msg->nlmsg_len = NLMSG_LENGTH(NLMSG_ALIGN(sizeof(*ifa)) + RTA_ALIGN(attr->rta_len));
+
+    cache.ProcessMessage(msg, true);
+}
+
+void InterfaceCacheTestObject::FinishNotifications(InterfaceCache &cache, bool lostChanges)
+{
+    cache.FinishNotifications(lostChanges);
+}
+
+} // namespace Inet
+} // namespace nl
+
+struct AddressRecord
+{
+    IPAddress mAddr;
+    InterfaceId mIntfId;
+    uint8_t mPrefixLength;
+    bool mSupportsMulticast;
+};
+
+struct InterfaceRecord
+{
+    InterfaceId mIntfId;
+    bool mSupportsMulticast;
+};
+
+struct ChangeRecord
+{
+    InterfaceChangeType mChangeType;
+    InterfaceId mIntfId;
+    IPAddress mAddr;
+};
+
+enum
+{
+    kMaxRecords = 256,
+
+    // Interface indexes well out of the range the system hands out.
+    kFakeIntfIdBase = 0x7FFF0000
+};
+
+static InterfaceCache sCache;
+static bool sCacheAvailable = false;
+
+static AddressRecord sSystemAddrs[kMaxRecords];
+static size_t sNumSystemAddrs = 0;
+static InterfaceRecord sSystemIntfs[kMaxRecords];
+static size_t sNumSystemIntfs = 0;
+
+static ChangeRecord sChanges[kMaxRecords];
+static size_t sNumChanges = 0;
+
+static size_t ListAddresses(AddressRecord *records)
+{
+    size_t count = 0;
+
+    for (InterfaceAddressIterator addrIter; addrIter.HasCurrent() && count < kMaxRecords; addrIter.Next(), count++)
+    {
+        records[count].mAddr = addrIter.GetAddress();
+        records[count].mIntfId = addrIter.GetInterface();
+        records[count].mPrefixLength = addrIter.GetIPv6PrefixLength();
+        records[count].mSupportsMulticast = addrIter.SupportsMulticast();
+    }
+
+    return count;
+}
+
+static bool ContainsInterface(const InterfaceRecord *records, size_t count, const InterfaceRecord &record)
+{
+    for (size_t i = 0; i < count; i++)
+        if (records[i].mIntfId == record.mIntfId && records[i].mSupportsMulticast == record.mSupportsMulticast)
+            return true;
+
+    return false;
+}
+
+// The getifaddrs-based iterator may visit an interface once per address
+// family, so only distinct interfaces are recorded.
+static size_t ListInterfaces(InterfaceRecord *records)
+{
+    size_t count = 0;
+
+    for (InterfaceIterator intfIter; intfIter.HasCurrent() && count < kMaxRecords; intfIter.Next())
+    {
+        InterfaceRecord record;
+
+        record.mIntfId = intfIter.GetInterface();
+        record.mSupportsMulticast = intfIter.SupportsMulticast();
+
+        if (!ContainsInterface(records, count, record))
+            records[count++] = record;
+    }
+
+    return count;
+}
+
+static bool ContainsAddress(const AddressRecord *records, size_t count, const AddressRecord &record)
+{
+    for (size_t i = 0; i < count; i++)
+        if (records[i].mAddr == record.mAddr && records[i].mIntfId == record.mIntfId &&
+            records[i].mPrefixLength == record.mPrefixLength && records[i].mSupportsMulticast == record.mSupportsMulticast)
+            return true;
+
+    return false;
+}
+
+static void CheckAddresses(nlTestSuite *inSuite, void *inContext)
+{
+    AddressRecord cachedAddrs[kMaxRecords];
+    size_t numCachedAddrs;
+
+    if (!sCacheAvailable)
+        return;
+
+    NL_TEST_ASSERT(inSuite, InterfaceCache::GetActive() == &sCache);
+
+    numCachedAddrs = ListAddresses(cachedAddrs);
+
+    NL_TEST_ASSERT(inSuite, numCachedAddrs == sNumSystemAddrs);
+
+    for (size_t i = 0; i < sNumSystemAddrs; i++)
+        NL_TEST_ASSERT(inSuite, ContainsAddress(cachedAddrs, numCachedAddrs, sSystemAddrs[i]));
+}
+
+static void CheckInterfaces(nlTestSuite *inSuite, void *inContext)
+{
+    InterfaceRecord cachedIntfs[kMaxRecords];
+    size_t numCachedIntfs;
+
+    if (!sCacheAvailable)
+        return;
+
+    numCachedIntfs = ListInterfaces(cachedIntfs);
+
+    NL_TEST_ASSERT(inSuite, numCachedIntfs == sNumSystemIntfs);
+
+    for (size_t i = 0; i < sNumSystemIntfs; i++)
+        NL_TEST_ASSERT(inSuite, ContainsInterface(cachedIntfs, numCachedIntfs, sSystemIntfs[i]));
+}
+
+static void CheckNameLookups(nlTestSuite *inSuite, void *inContext)
+{
+    if (!sCacheAvailable)
+        return;
+
+    for (size_t i = 0; i < sCache.NumInterfaces(); i++)
+    {
+        const InterfaceCache::Interface &intf = sCache.GetInterface(i);
+        char sysName[IF_NAMESIZE];
+        char name[IF_NAMESIZE];
+        InterfaceId intfId = INET_NULL_INTERFACEID;
+
+        NL_TEST_ASSERT(inSuite, if_indextoname(intf.mId, sysName) != NULL);
+
+        NL_TEST_ASSERT(inSuite, GetInterfaceName(intf.mId, name, sizeof(name)) == INET_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, strcmp(name, sysName) == 0);
+
+        NL_TEST_ASSERT(inSuite, GetInterfaceName(intf.mId, name, strlen(sysName)) == INET_ERROR_NO_MEMORY);
+
+        NL_TEST_ASSERT(inSuite, InterfaceNameToId(sysName, intfId) == INET_NO_ERROR);
+        NL_TEST_ASSERT(inSuite, intfId == if_nametoindex(sysName));
+    }
+}
+
+static void HandleInterfaceChange(void *appState, InterfaceChangeType changeType, InterfaceId intfId, const IPAddress &addr)
+{
+}
+
+static void RecordInterfaceChange(void *appState, InterfaceChangeType changeType, InterfaceId intfId, const IPAddress &addr)
+{
+    if (sNumChanges < kMaxRecords)
+    {
+        sChanges[sNumChanges].mChangeType = changeType;
+        sChanges[sNumChanges].mIntfId = intfId;
+        sChanges[sNumChanges].mAddr = addr;
+        sNumChanges++;
+    }
+}
+
+static size_t CountChanges(InterfaceChangeType changeType, InterfaceId intfId, const IPAddress &addr)
+{
+    size_t count = 0;
+
+    for (size_t i = 0; i < sNumChanges; i++)
+        if (sChanges[i].mChangeType == changeType && sChanges[i].mIntfId == intfId && sChanges[i].mAddr == addr)
+            count++;
+
+    return count;
+}
+
+static IPAddress MakeTestAddress(uint16_t index)
+{
+    IPAddress addr;
+
+    IPAddress::FromString("fd00:0:1:1::", addr);
+    addr.Addr[3] = nl::Weave::Encoding::BigEndian::HostSwap32(index + 1);
+
+    return addr;
+}
+
+static void CheckChangeHandlers(nlTestSuite *inSuite, void *inContext)
+{
+    if (!sCacheAvailable)
+        return;
+
+    NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(NULL, NULL) == INET_ERROR_BAD_ARGS);
+
+    for (size_t i = 0; i < INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS; i++)
+        NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(HandleInterfaceChange, reinterpret_cast<void *>(i + 1)) == INET_NO_ERROR);
+
+    // Registering a handler twice takes no extra slot.
+    NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(HandleInterfaceChange, reinterpret_cast<void *>(1)) == INET_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(HandleInterfaceChange, NULL) == INET_ERROR_NO_MEMORY);
+
+    sCache.RemoveChangeHandler(HandleInterfaceChange, reinterpret_cast<void *>(1));
+    NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(HandleInterfaceChange, NULL) == INET_NO_ERROR);
+
+    sCache.RemoveChangeHandler(HandleInterfaceChange, NULL);
+    for (size_t i = 1; i < INET_CONFIG_INTERFACE_CACHE_MAX_CHANGE_HANDLERS; i++)
+        sCache.RemoveChangeHandler(HandleInterfaceChange, reinterpret_cast<void *>(i + 1));
+}
+
+static void CheckInterfaceOverflow(nlTestSuite *inSuite, void *inContext)
+{
+    const InterfaceId lastFakeIntfId = kFakeIntfIdBase + INET_CONFIG_INTERFACE_CACHE_MAX_INTERFACES - sCache.NumInterfaces();
+    char name[IF_NAMESIZE];
+
+    if (!sCacheAvailable)
+        return;
+
+    sNumChanges = 0;
+    NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(RecordInterfaceChange, NULL) == INET_NO_ERROR);
+
+    // One interface more than the table holds.
+    for (InterfaceId intfId = kFakeIntfIdBase; intfId <= lastFakeIntfId; intfId++)
+    {
+        snprintf(name, sizeof(name), "wvtest%u", intfId - kFakeIntfIdBase);
+        InterfaceCacheTestObject::InjectLink(sCache, RTM_NEWLINK, intfId, name, IFF_UP | IFF_MULTICAST);
+    }
+
+    NL_TEST_ASSERT(inSuite, !sCache.IsValid());
+    NL_TEST_ASSERT(inSuite, InterfaceCache::GetActive() == NULL);
+    NL_TEST_ASSERT(inSuite, sCache.FindInterface(lastFakeIntfId) == NULL);
+
+    // Every change is still reported, including those to the interface left out of the table.
+    for (InterfaceId intfId = kFakeIntfIdBase; intfId <= lastFakeIntfId; intfId++)
+        NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_InterfaceAdded, intfId, IPAddress::Any) == 1);
+
+    InterfaceCacheTestObject::InjectLink(sCache, RTM_NEWLINK, lastFakeIntfId, name, IFF_UP);
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_InterfaceChanged, lastFakeIntfId, IPAddress::Any) == 1);
+
+    InterfaceCacheTestObject::InjectAddress(sCache, RTM_NEWADDR, lastFakeIntfId, MakeTestAddress(0));
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_AddressAdded, lastFakeIntfId, MakeTestAddress(0)) == 1);
+
+    // An incomplete table can't tell whether it missed an address, so its removal is reported.
+    InterfaceCacheTestObject::InjectAddress(sCache, RTM_DELADDR, lastFakeIntfId, MakeTestAddress(1));
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_AddressRemoved, lastFakeIntfId, MakeTestAddress(1)) == 1);
+
+    for (InterfaceId intfId = kFakeIntfIdBase; intfId <= lastFakeIntfId; intfId++)
+    {
+        InterfaceCacheTestObject::InjectLink(sCache, RTM_DELLINK, intfId, "", 0);
+        NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_InterfaceRemoved, intfId, IPAddress::Any) == 1);
+    }
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_AddressRemoved, lastFakeIntfId, MakeTestAddress(0)) == 1);
+
+    // With room made, the table is reloaded without the handlers having to resynchronize.
+    InterfaceCacheTestObject::FinishNotifications(sCache, false);
+
+    NL_TEST_ASSERT(inSuite, sCache.IsValid());
+    NL_TEST_ASSERT(inSuite, InterfaceCache::GetActive() == &sCache);
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_Resynchronized, INET_NULL_INTERFACEID, IPAddress::Any) == 0);
+
+    sCache.RemoveChangeHandler(RecordInterfaceChange, NULL);
+}
+
+static void CheckAddressOverflow(nlTestSuite *inSuite, void *inContext)
+{
+    const uint16_t numFakeAddrs = INET_CONFIG_INTERFACE_CACHE_MAX_ADDRESSES - sCache.NumAddresses() + 1;
+
+    if (!sCacheAvailable)
+        return;
+
+    sNumChanges = 0;
+    NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(RecordInterfaceChange, NULL) == INET_NO_ERROR);
+
+    InterfaceCacheTestObject::InjectLink(sCache, RTM_NEWLINK, kFakeIntfIdBase, "wvtest0", IFF_UP | IFF_MULTICAST);
+
+    // One address more than the table holds.
+    for (uint16_t i = 0; i < numFakeAddrs; i++)
+        InterfaceCacheTestObject::InjectAddress(sCache, RTM_NEWADDR, kFakeIntfIdBase, MakeTestAddress(i));
+
+    NL_TEST_ASSERT(inSuite, !sCache.IsValid());
+    for (uint16_t i = 0; i < numFakeAddrs; i++)
+        NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_AddressAdded, kFakeIntfIdBase, MakeTestAddress(i)) == 1);
+
+    // Nothing was removed, so the table stays as it is.
+    InterfaceCacheTestObject::FinishNotifications(sCache, false);
+    NL_TEST_ASSERT(inSuite, !sCache.IsValid());
+
+    InterfaceCacheTestObject::InjectAddress(sCache, RTM_DELADDR, kFakeIntfIdBase, MakeTestAddress(0));
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_AddressRemoved, kFakeIntfIdBase, MakeTestAddress(0)) == 1);
+
+    // The reload drops the fake interface and the addresses the table held, and reports them as removed.
+    InterfaceCacheTestObject::FinishNotifications(sCache, false);
+
+    NL_TEST_ASSERT(inSuite, sCache.IsValid());
+    NL_TEST_ASSERT(inSuite, sCache.FindInterface(kFakeIntfIdBase) == NULL);
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_InterfaceRemoved, kFakeIntfIdBase, IPAddress::Any) == 1);
+    for (uint16_t i = 1; i < numFakeAddrs - 1; i++)
+        NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_AddressRemoved, kFakeIntfIdBase, MakeTestAddress(i)) == 1);
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_Resynchronized, INET_NULL_INTERFACEID, IPAddress::Any) == 0);
+
+    sCache.RemoveChangeHandler(RecordInterfaceChange, NULL);
+}
+
+static void CheckResynchronize(nlTestSuite *inSuite, void *inContext)
+{
+    if (!sCacheAvailable)
+        return;
+
+    sNumChanges = 0;
+    NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(RecordInterfaceChange, NULL) == INET_NO_ERROR);
+
+    InterfaceCacheTestObject::InjectLink(sCache, RTM_NEWLINK, kFakeIntfIdBase, "wvtest0", IFF_UP | IFF_MULTICAST);
+    NL_TEST_ASSERT(inSuite, sCache.IsValid());
+    NL_TEST_ASSERT(inSuite, sCache.FindInterface(kFakeIntfIdBase) != NULL);
+    NL_TEST_ASSERT(inSuite, sCache.FindInterface("wvtest0") != NULL);
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_InterfaceAdded, kFakeIntfIdBase, IPAddress::Any) == 1);
+
+    // Repeated link notifications that change nothing are not reported.
+    InterfaceCacheTestObject::InjectLink(sCache, RTM_NEWLINK, kFakeIntfIdBase, "wvtest0", IFF_UP | IFF_MULTICAST);
+    NL_TEST_ASSERT(inSuite, sNumChanges == 1);
+
+    // Lost notifications make the handlers resynchronize with the reloaded table.
+    InterfaceCacheTestObject::FinishNotifications(sCache, true);
+
+    NL_TEST_ASSERT(inSuite, sCache.IsValid());
+    NL_TEST_ASSERT(inSuite, sCache.FindInterface(kFakeIntfIdBase) == NULL);
+    NL_TEST_ASSERT(inSuite, CountChanges(kInterfaceChange_Resynchronized, INET_NULL_INTERFACEID, IPAddress::Any) == 1);
+
+    // A complete table knows what it doesn't hold, so removing it is not reported.
+    sNumChanges = 0;
+    InterfaceCacheTestObject::InjectAddress(sCache, RTM_DELADDR, kFakeIntfIdBase, MakeTestAddress(0));
+    InterfaceCacheTestObject::InjectLink(sCache, RTM_DELLINK, kFakeIntfIdBase, "", 0);
+    NL_TEST_ASSERT(inSuite, sNumChanges == 0);
+
+    sCache.RemoveChangeHandler(RecordInterfaceChange, NULL);
+}
+
+static void CheckShutdown(nlTestSuite *inSuite, void *inContext)
+{
+    AddressRecord addrs[kMaxRecords];
+
+    if (!sCacheAvailable)
+        return;
+
+    sCache.Shutdown();
+    sCacheAvailable = false;
+
+    // Without the cache, the iterators query the system again.
+    NL_TEST_ASSERT(inSuite, InterfaceCache::GetActive() == NULL);
+    NL_TEST_ASSERT(inSuite, ListAddresses(addrs) == sNumSystemAddrs);
+    NL_TEST_ASSERT(inSuite, sCache.AddChangeHandler(HandleInterfaceChange, NULL) == INET_ERROR_NOT_IMPLEMENTED);
+}
+
+static int TestSetup(void *inContext)
+{
+    INET_ERROR err;
+
+    // Record what the system reports before the cache takes over.
+    sNumSystemAddrs = ListAddresses(sSystemAddrs);
+    sNumSystemIntfs = ListInterfaces(sSystemIntfs);
+
+    err = sCache.Init();
+    if (err != INET_NO_ERROR)
+    {
+        printf("Interface cache unavailable (%ld), skipping\n", static_cast<long>(err));
+        return SUCCESS;
+    }
+
+    sCacheAvailable = true;
+
+    return SUCCESS;
+}
+
+static int TestTeardown(void *inContext)
+{
+    if (sCacheAvailable)
+        sCache.Shutdown();
+
+    return SUCCESS;
+}
+
+#endif // INET_CONFIG_ENABLE_INTERFACE_CACHE
+
+int main(int argc, char *argv[])
+{
+#if INET_CONFIG_ENABLE_INTERFACE_CACHE
+    static const nlTest tests[] = {
+        NL_TEST_DEF("Addresses",                        CheckAddresses),
+        NL_TEST_DEF("Interfaces",                       CheckInterfaces),
+        NL_TEST_DEF("NameLookups",                      CheckNameLookups),
+        NL_TEST_DEF("ChangeHandlers",                   CheckChangeHandlers),
+        NL_TEST_DEF("InterfaceOverflow",                CheckInterfaceOverflow),
+        NL_TEST_DEF("AddressOverflow",                  CheckAddressOverflow),
+        NL_TEST_DEF("Resynchronize",                    CheckResynchronize),
+        NL_TEST_DEF("Shutdown",                         CheckShutdown),
+        NL_TEST_SENTINEL()
+    };
+
+    static nlTestSuite testSuite = {
+        "interface-cache",
+        &tests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    nlTestRunner(&testSuite, NULL);
+
+    return nlTestRunnerStats(&testSuite);
+#else // !INET_CONFIG_ENABLE_INTERFACE_CACHE
+    return 0;
+#endif // !INET_CONFIG_ENABLE_INTERFACE_CACHE
+}
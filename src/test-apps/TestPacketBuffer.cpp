@@ -636,6 +636,109 @@ static void CheckCompactHead(nlTestSuite *inSuite, void *inContext)
     }
 }
 
+/**
+ *  Test PacketBuffer::PullUpHead() function.
+ *
+ *  Description: Take two initial configurations of PacketBuffer from
+ *               inContext and create two PacketBuffer instances based on those
+ *               configurations. Next, set both buffers' data length to any
+ *               combination of values from sLengths[] and link those buffers
+ *               into a chain. Then, call PullUpHead() on the first buffer in
+ *               the chain with every value from sLengths[]. After calling the
+ *               method, verify that it succeeded only when the chain and the
+ *               first buffer could hold the requested length, that no more
+ *               data than requested was moved, and that the data was not
+ *               reordered.
+ */
+static void CheckPullUpHead(nlTestSuite *inSuite, void *inContext)
+{
+    struct TestContext *theFirstContext = static_cast<struct TestContext *>(inContext);
+
+    for (size_t ith = 0; ith < kTestElements; ith++)
+    {
+        struct TestContext *theSecondContext = static_cast<struct TestContext *>(inContext);
+
+        for (size_t jth = 0; jth < kTestElements; jth++)
+        {
+            if (theFirstContext == theSecondContext)
+            {
+                theSecondContext++;
+                continue;
+            }
+
+            for (size_t k = 0; k < kTestLengths; k++)
+            {
+                for (size_t l = 0; l < kTestLengths; l++)
+                {
+                    for (size_t m = 0; m < kTestLengths; m++)
+                    {
+                        PacketBuffer *buffer_1 = PrepareTestBuffer(theFirstContext);
+                        PacketBuffer *buffer_2 = PrepareTestBuffer(theSecondContext);
+                        uint16_t len1, len2, capacity;
+                        bool result;
+
+                        buffer_1->SetDataLength(sLengths[k], buffer_1);
+                        theFirstContext->buf->next = theSecondContext->buf;
+                        buffer_2->SetDataLength(sLengths[l], buffer_1);
+
+                        len1 = buffer_1->DataLength();
+                        len2 = buffer_2->DataLength();
+                        capacity = buffer_1->MaxDataLength() + buffer_1->ReservedSize();
+
+                        for (uint16_t i = 0; i < len1; i++)
+                            buffer_1->Start()[i] = static_cast<uint8_t>(i);
+                        for (uint16_t i = 0; i < len2; i++)
+                            buffer_2->Start()[i] = static_cast<uint8_t>(len1 + i);
+
+                        result = buffer_1->PullUpHead(sLengths[m]);
+
+                        if (sLengths[m] <= len1)
+                        {
+                            NL_TEST_ASSERT(inSuite, result);
+                            NL_TEST_ASSERT(inSuite, theFirstContext->buf->len == len1);
+                            NL_TEST_ASSERT(inSuite, theFirstContext->buf->next == theSecondContext->buf);
+                        }
+                        else if (sLengths[m] > len1 + len2 || sLengths[m] > capacity)
+                        {
+                            NL_TEST_ASSERT(inSuite, !result);
+                            NL_TEST_ASSERT(inSuite, theFirstContext->buf->len == len1);
+                            NL_TEST_ASSERT(inSuite, theSecondContext->buf->len == len2);
+                        }
+                        else
+                        {
+                            NL_TEST_ASSERT(inSuite, result);
+                            NL_TEST_ASSERT(inSuite, theFirstContext->buf->len == sLengths[m]);
+                            NL_TEST_ASSERT(inSuite, theFirstContext->buf->tot_len == len1 + len2);
+
+                            for (uint16_t i = 0; i < sLengths[m]; i++)
+                                NL_TEST_ASSERT(inSuite, buffer_1->Start()[i] == static_cast<uint8_t>(i));
+
+                            if (sLengths[m] == len1 + len2)
+                            {
+                                /* make sure the second buffer is freed */
+                                NL_TEST_ASSERT(inSuite, theFirstContext->buf->next == NULL);
+                                theSecondContext->buf = NULL;
+                            }
+                            else
+                            {
+                                NL_TEST_ASSERT(inSuite, theSecondContext->buf->len == len1 + len2 - sLengths[m]);
+                                NL_TEST_ASSERT(inSuite, buffer_2->Start()[0] == static_cast<uint8_t>(sLengths[m]));
+                            }
+                        }
+
+                        if (theSecondContext->buf != NULL)
+                            theSecondContext->buf->next = NULL;
+                        theFirstContext->buf->next = NULL;
+                    }
+                }
+            }
+            theSecondContext++;
+        }
+
+        theFirstContext++;
+    }
+}
+
 /**
  *  Test PacketBuffer::ConsumeHead() function.
  *
@@ -1124,6 +1227,7 @@ static const nlTest sTests[] = {
     NL_TEST_DEF("PacketBuffer::AddToEnd",                       CheckAddToEnd),
     NL_TEST_DEF("PacketBuffer::DetachTail",                     CheckDetachTail),
     NL_TEST_DEF("PacketBuffer::CompactHead",                    CheckCompactHead),
+    NL_TEST_DEF("PacketBuffer::PullUpHead",                     CheckPullUpHead),
     NL_TEST_DEF("PacketBuffer::ConsumeHead",                    CheckConsumeHead),
     NL_TEST_DEF("PacketBuffer::Consume",                        CheckConsume),
     NL_TEST_DEF("PacketBuffer::EnsureReservedSize",             CheckEnsureReservedSize),
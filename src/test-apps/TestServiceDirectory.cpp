@@ -0,0 +1,386 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file tests the directory index and the connect racing of
+ *      the service manager against frontends on the loopback
+ *      interface: one that accepts connections, one that refuses
+ *      them, and one whose accept queue is full so that connections
+ *      to it never complete.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+
+#include "ToolCommon.h"
+#include <nltest.h>
+#include <Weave/Core/WeaveEncoding.h>
+#include <Weave/Profiles/service-directory/ServiceDirectory.h>
+
+using namespace nl::Weave::Encoding;
+using namespace nl::Weave::Profiles::ServiceDirectory;
+
+#define TOOL_NAME "TestServiceDirectory"
+
+#if WEAVE_CONFIG_ENABLE_SERVICE_DIRECTORY
+
+#define CONNECT_TIMEOUT_MILLISECS           3000
+#define NUM_FILLER_SOCKETS                  2
+
+#define kServiceEndpoint_Test               (0x18B43002000000F0ull)
+
+enum
+{
+    kFrontend_Live                          = 0,
+    kFrontend_Refused                       = 1,
+    kFrontend_Blackhole                     = 2,
+};
+
+static int sLiveFd = -1;
+static int sBlackholeFd = -1;
+static int sFillerFds[NUM_FILLER_SOCKETS] = { -1, -1 };
+static uint16_t sFrontendPorts[3];
+static uint8_t sRootFrontends[2];
+
+static uint8_t sCache[256];
+static WeaveServiceManager sServiceMgr;
+
+static bool sQueryBegun;
+static bool sStatusReceived;
+static WEAVE_ERROR sStatusError;
+
+static void WriteHostPortItem(uint8_t *&p, uint16_t port)
+{
+    static const char kHost[] = "::1";
+
+    Write8(p, kMask_PortIdPresent | kHostIdType_FullyQualified);
+    Write8(p, sizeof(kHost) - 1);
+    memcpy(p, kHost, sizeof(kHost) - 1);
+    p += sizeof(kHost) - 1;
+    LittleEndian::Write16(p, port);
+}
+
+/**
+ *  Provide a root directory listing the two frontends in sRootFrontends.
+ */
+static WEAVE_ERROR RootDirectoryAccessor(uint8_t *aDirectory, uint16_t aLength)
+{
+    uint8_t *p = aDirectory;
+
+    Write8(p, kDirectoryEntryType_HostPortList | 2);
+    LittleEndian::Write64(p, kServiceEndpoint_Directory);
+    WriteHostPortItem(p, sFrontendPorts[sRootFrontends[0]]);
+    WriteHostPortItem(p, sFrontendPorts[sRootFrontends[1]]);
+
+    return WEAVE_NO_ERROR;
+}
+
+static void HandleQueryBegin(void)
+{
+    sQueryBegun = true;
+}
+
+static void HandleStatus(void *anAppState, WEAVE_ERROR anError, StatusReport *aStatusReport)
+{
+    sStatusReceived = true;
+    sStatusError = anError;
+}
+
+static void HandleConnectionComplete(WeaveConnection *aConnection, WEAVE_ERROR aError)
+{
+    aConnection->Close();
+}
+
+static int OpenListener(int backlog, uint16_t &port)
+{
+    struct sockaddr_in6 addr;
+    socklen_t addrLen = sizeof(addr);
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_loopback;
+
+    if (fd < 0 ||
+        bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        getsockname(fd, (struct sockaddr *)&addr, &addrLen) != 0 ||
+        (backlog >= 0 && listen(fd, backlog) != 0))
+    {
+        if (fd >= 0)
+            close(fd);
+        return -1;
+    }
+
+    port = ntohs(addr.sin6_port);
+
+    return fd;
+}
+
+static int OpenFiller(uint16_t port)
+{
+    struct sockaddr_in6 addr;
+    int fd = socket(AF_INET6, SOCK_STREAM, 0);
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sin6_family = AF_INET6;
+    addr.sin6_addr = in6addr_loopback;
+    addr.sin6_port = htons(port);
+
+    if (fd >= 0)
+    {
+        fcntl(fd, F_SETFL, O_NONBLOCK);
+        connect(fd, (struct sockaddr *)&addr, sizeof(addr));
+    }
+
+    return fd;
+}
+
+static void StartConnect(uint8_t aFirst, uint8_t aSecond)
+{
+    WEAVE_ERROR err;
+
+    sRootFrontends[0] = aFirst;
+    sRootFrontends[1] = aSecond;
+    sQueryBegun = false;
+    sStatusReceived = false;
+    sStatusError = WEAVE_NO_ERROR;
+
+    err = sServiceMgr.init(&ExchangeMgr, sCache, sizeof(sCache), RootDirectoryAccessor,
+                           kWeaveAuthMode_Unauthenticated, HandleQueryBegin, NULL);
+    VerifyOrDie(err == WEAVE_NO_ERROR);
+
+    err = sServiceMgr.connect(kServiceEndpoint_Test, kWeaveAuthMode_Unauthenticated, &sServiceMgr,
+                              HandleStatus, HandleConnectionComplete);
+    VerifyOrDie(err == WEAVE_NO_ERROR);
+}
+
+static bool WaitFor(const bool &aFlag, uint32_t aTimeoutMs)
+{
+    const uint64_t deadline = NowMs() + aTimeoutMs;
+
+    while (!aFlag && NowMs() < deadline)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 10000;
+        ServiceNetwork(sleepTime);
+    }
+
+    return aFlag;
+}
+
+static int32_t NumConnections(void)
+{
+    nl::Weave::System::Stats::count_t inUse = 0;
+
+    MessageLayer.GetConnectionPoolStats(inUse);
+
+    return inUse;
+}
+
+static void CheckLookupIndex(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err;
+    uint8_t ctrlByte;
+    uint8_t *entry;
+    uint16_t port;
+
+    StartConnect(kFrontend_Blackhole, kFrontend_Live);
+
+    err = sServiceMgr.lookup(kServiceEndpoint_Directory, &ctrlByte, &entry);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctrlByte == (kDirectoryEntryType_HostPortList | 2));
+    NL_TEST_ASSERT(inSuite, entry == sCache + 9);
+
+    // Repeated lookups are answered from the index.
+    err = sServiceMgr.lookup(kServiceEndpoint_Directory, &ctrlByte, &entry);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, entry == sCache + 9);
+
+    err = sServiceMgr.lookup(kServiceEndpoint_Test, &ctrlByte, &entry);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_SERVICE_EP);
+    NL_TEST_ASSERT(inSuite, entry == NULL);
+
+    // An entry added to the directory is found once the index is rebuilt.
+    err = sServiceMgr.replaceOrAddCacheEntry(11095, "::1", 3, kServiceEndpoint_Test);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = sServiceMgr.lookup(kServiceEndpoint_Test, &ctrlByte, &entry);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, ctrlByte == (kDirectoryEntryType_HostPortList | 1));
+    NL_TEST_ASSERT(inSuite, entry == sCache + 9);
+
+    port = LittleEndian::Get16(entry + 2 + 3);
+    NL_TEST_ASSERT(inSuite, port == 11095);
+
+    sServiceMgr.reset();
+}
+
+static void CheckSequentialConnect(nlTestSuite *inSuite, void *inContext)
+{
+    sServiceMgr.disableConnectRacing();
+
+    // Without racing, the live frontend isn't tried while the first one hangs.
+    StartConnect(kFrontend_Blackhole, kFrontend_Live);
+
+    NL_TEST_ASSERT(inSuite, !WaitFor(sQueryBegun, 1000));
+    NL_TEST_ASSERT(inSuite, NumConnections() == 2);
+
+    sServiceMgr.reset();
+
+    NL_TEST_ASSERT(inSuite, NumConnections() == 0);
+}
+
+static void CheckRacingConnect(nlTestSuite *inSuite, void *inContext)
+{
+    sServiceMgr.enableConnectRacing(2, 100);
+
+    StartConnect(kFrontend_Blackhole, kFrontend_Live);
+
+    NL_TEST_ASSERT(inSuite, WaitFor(sQueryBegun, CONNECT_TIMEOUT_MILLISECS));
+
+    // The connection to the hanging frontend has been aborted, leaving the
+    // directory connection and the pending request's connection.
+    NL_TEST_ASSERT(inSuite, NumConnections() == 2);
+
+    sServiceMgr.reset();
+
+    NL_TEST_ASSERT(inSuite, NumConnections() == 0);
+}
+
+static void CheckRacingFailover(nlTestSuite *inSuite, void *inContext)
+{
+    // A failed connection is replaced without waiting for the stagger interval.
+    sServiceMgr.enableConnectRacing(2, 10 * CONNECT_TIMEOUT_MILLISECS);
+
+    StartConnect(kFrontend_Refused, kFrontend_Live);
+
+    NL_TEST_ASSERT(inSuite, WaitFor(sQueryBegun, CONNECT_TIMEOUT_MILLISECS));
+    NL_TEST_ASSERT(inSuite, NumConnections() == 2);
+
+    sServiceMgr.reset();
+
+    NL_TEST_ASSERT(inSuite, NumConnections() == 0);
+}
+
+static void CheckRacingAllFail(nlTestSuite *inSuite, void *inContext)
+{
+    sServiceMgr.enableConnectRacing(2, 100);
+
+    StartConnect(kFrontend_Refused, kFrontend_Refused);
+
+    NL_TEST_ASSERT(inSuite, WaitFor(sStatusReceived, CONNECT_TIMEOUT_MILLISECS));
+    NL_TEST_ASSERT(inSuite, sStatusError != WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, !sQueryBegun);
+    NL_TEST_ASSERT(inSuite, NumConnections() == 0);
+
+    sServiceMgr.reset();
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Lookup Index",                 CheckLookupIndex),
+    NL_TEST_DEF("Sequential Connect",           CheckSequentialConnect),
+    NL_TEST_DEF("Racing Connect",               CheckRacingConnect),
+    NL_TEST_DEF("Racing Failover",              CheckRacingFailover),
+    NL_TEST_DEF("Racing All Fail",              CheckRacingAllFail),
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite: start the Weave stack and open the frontends.
+ */
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(false, true);
+
+    sLiveFd = OpenListener(16, sFrontendPorts[kFrontend_Live]);
+    VerifyOrExit(sLiveFd >= 0, );
+
+    // The blackhole frontend's accept queue is filled and never drained, so
+    // further connection attempts go unanswered.
+    sBlackholeFd = OpenListener(0, sFrontendPorts[kFrontend_Blackhole]);
+    VerifyOrExit(sBlackholeFd >= 0, );
+
+    for (int i = 0; i < NUM_FILLER_SOCKETS; i++)
+        sFillerFds[i] = OpenFiller(sFrontendPorts[kFrontend_Blackhole]);
+
+    // Nothing listens on the refused frontend's port.
+    close(OpenListener(-1, sFrontendPorts[kFrontend_Refused]));
+
+exit:
+    return (sLiveFd >= 0 && sBlackholeFd >= 0) ? SUCCESS : FAILURE;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    for (int i = 0; i < NUM_FILLER_SOCKETS; i++)
+        if (sFillerFds[i] >= 0)
+            close(sFillerFds[i]);
+
+    if (sBlackholeFd >= 0)
+        close(sBlackholeFd);
+
+    if (sLiveFd >= 0)
+        close(sLiveFd);
+
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+#endif // WEAVE_CONFIG_ENABLE_SERVICE_DIRECTORY
+
+int main(void)
+{
+#if WEAVE_CONFIG_ENABLE_SERVICE_DIRECTORY
+    nlTestSuite theSuite = {
+        "Service-Directory",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+#else
+    return 0;
+#endif // WEAVE_CONFIG_ENABLE_SERVICE_DIRECTORY
+}
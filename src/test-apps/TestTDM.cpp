@@ -160,6 +160,9 @@ static void TestTdmDictionary_DeleteEntryTwice(nlTestSuite *inSuite, void *inCon
 
 static void TestTdmStatic_MultiInstance(nlTestSuite *inSuite, void *inContext);
 
+static void TestTdmUpdate_RoundTrip(nlTestSuite *inSuite, void *inContext);
+static void TestTdmUpdate_VersionMismatch(nlTestSuite *inSuite, void *inContext);
+
 // Test Suite
 
 /**
@@ -216,6 +219,9 @@ static const nlTest sTests[] = {
 
     NL_TEST_DEF("Test Tdm (Multi Instance): Multi Instance", TestTdmStatic_MultiInstance),
 
+    NL_TEST_DEF("Test Tdm (Update): Coalesced update round trip", TestTdmUpdate_RoundTrip),
+    NL_TEST_DEF("Test Tdm (Update): Conditional update with stale version", TestTdmUpdate_VersionMismatch),
+
     NL_TEST_SENTINEL()
 };
 
@@ -398,6 +404,7 @@ public:
 
 private:
     WEAVE_ERROR GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, TLVWriter &aWriter);
+    WEAVE_ERROR SetLeafData(PropertyPathHandle aLeafHandle, TLVReader &aReader);
     WEAVE_ERROR GetNextDictionaryItemKey(PropertyPathHandle aDictionaryHandle, uintptr_t &aContext, PropertyDictionaryKey &aKey);
 
 public:
@@ -548,6 +555,22 @@ exit:
     return err;
 }
 
+// Stores the values received through update requests, static part of the schema only
+WEAVE_ERROR TestTdmSource::SetLeafData(PropertyPathHandle aLeafHandle, TLVReader &aReader)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    uint32_t val;
+
+    err = aReader.Get(val);
+    SuccessOrExit(err);
+
+    WeaveLogDetail(DataManagement, "[TestTdmSource::SetLeafData] << handle:%u = %u", aLeafHandle, val);
+    mValues[aLeafHandle] = val;
+
+exit:
+    return err;
+}
+
 //
 // This is a very special sink that tracks all the replaces, deletions and modifications that are sent to it through the
 // OnEvent and SetLeafData calls. This then allows for programmatic validation of the specific set of data that is expected for a set of modifications
@@ -561,9 +584,13 @@ public:
 
     bool ValidateChangeSets(std::map <PropertyPathHandle, uint32_t> aTargetModifiedSet, std::set <PropertyPathHandle> aTargetDeletedSet, std::set <PropertyPathHandle> aTargetReplacedSet);
 
+    // Values mutated locally, to be sent out by an update client
+    std::map <PropertyPathHandle, uint32_t> mLocalValues;
+
 private:
     WEAVE_ERROR OnEvent(uint16_t aType, void *aInParam);
     WEAVE_ERROR SetLeafData(PropertyPathHandle aLeafHandle, nl::Weave::TLV::TLVReader &aReader);
+    WEAVE_ERROR GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, nl::Weave::TLV::TLVWriter &aWriter);
 
     std::map <PropertyPathHandle, uint32_t> mModifiedHandles;
     std::set <PropertyPathHandle> mDeletedHandles;
@@ -580,6 +607,7 @@ void TestTdmSink::Reset()
     mModifiedHandles.clear();
     mDeletedHandles.clear();
     mReplacedDictionaries.clear();
+    mLocalValues.clear();
     ClearVersion();
 }
 
@@ -665,6 +693,16 @@ exit:
     return err;
 }
 
+WEAVE_ERROR TestTdmSink::GetLeafData(PropertyPathHandle aLeafHandle, uint64_t aTagToWrite, TLVWriter &aWriter)
+{
+    if (mLocalValues.find(aLeafHandle) == mLocalValues.end()) {
+        return WEAVE_ERROR_INVALID_ARGUMENT;
+    }
+
+    WeaveLogDetail(DataManagement, "[TestTdmSink::GetLeafData] >> handle:%u = %u", aLeafHandle, mLocalValues[aLeafHandle]);
+    return aWriter.Put(aTagToWrite, mLocalValues[aLeafHandle]);
+}
+
 class TestTdm {
 public:
     TestTdm();
@@ -673,6 +711,7 @@ public:
     int Teardown();
     int Reset();
     int BuildAndProcessNotify();
+    int BuildAndProcessUpdate(UpdateClient &aUpdateClient);
 
     void TestTdmStatic_SingleLeafHandle(nlTestSuite *inSuite);
     void TestTdmStatic_SingleLevelMerge(nlTestSuite *inSuite);
@@ -716,6 +755,9 @@ public:
 
     void TestTdmStatic_MultiInstance(nlTestSuite *inSuite);
 
+    void TestTdmUpdate_RoundTrip(nlTestSuite *inSuite);
+    void TestTdmUpdate_VersionMismatch(nlTestSuite *inSuite);
+
 
 private:
     SubscriptionHandler *mSubHandler;
@@ -968,6 +1010,179 @@ exit:
     NL_TEST_ASSERT(inSuite, testPass);
 }
 
+// Records the events of an update client
+struct UpdateEventLog
+{
+    std::map <PropertyPathHandle, uint16_t> mPathStatus;
+    bool mIsVersionValid;
+    uint64_t mVersion;
+    size_t mNumPathsCompleted;
+};
+
+static void UpdateClientEventCallback(void * const aAppState, UpdateClient::EventID aEvent, WEAVE_ERROR aErrorCode, UpdateClient::EventParam & aEventParam)
+{
+    UpdateEventLog * const log = static_cast<UpdateEventLog *>(aAppState);
+
+    switch (aEvent)
+    {
+        case UpdateClient::kEvent_PathStatus:
+            log->mPathStatus[aEventParam.mPathStatusEventParam.mPropertyPathHandle] = aEventParam.mPathStatusEventParam.mStatusCode;
+            if (aEventParam.mPathStatusEventParam.mIsVersionValid)
+            {
+                log->mIsVersionValid = true;
+                log->mVersion = aEventParam.mPathStatusEventParam.mVersion;
+            }
+            break;
+
+        case UpdateClient::kEvent_UpdateComplete:
+            log->mNumPathsCompleted += aEventParam.mUpdateCompleteEventParam.mNumPaths;
+            break;
+    }
+}
+
+// Take the pending paths of the update client through an update request, the publisher, and back through
+// the update response, without any exchange in between
+int TestTdm::BuildAndProcessUpdate(UpdateClient &aUpdateClient)
+{
+    UpdateClient::InFlightRequest &request = aUpdateClient.mRequests[0];
+    PacketBuffer *reqBuf = NULL;
+    PacketBuffer *respBuf = NULL;
+    TLVWriter writer;
+    TLVReader reader;
+    WEAVE_ERROR err;
+
+    reqBuf = PacketBuffer::New();
+    respBuf = PacketBuffer::New();
+    VerifyOrExit(reqBuf != NULL && respBuf != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    aUpdateClient.MovePendingPaths(request);
+
+    writer.Init(reqBuf);
+
+    err = aUpdateClient.BuildUpdateRequest(request, writer);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    {
+        uint8_t *p = respBuf->Start();
+
+        nl::Weave::Encoding::LittleEndian::Write32(p, nl::Weave::Profiles::kWeaveProfile_Common);
+        nl::Weave::Encoding::LittleEndian::Write16(p, nl::Weave::Profiles::Common::kStatus_Success);
+        respBuf->SetDataLength(p - respBuf->Start());
+    }
+
+    reader.Init(reqBuf);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    writer.Init(respBuf);
+
+    err = mSubscriptionEngine.ProcessUpdateRequest(reader, writer);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    err = aUpdateClient.ProcessUpdateResponse(request, respBuf);
+    aUpdateClient.CompleteRequest(request, err);
+
+exit:
+    if (reqBuf) {
+        PacketBuffer::Free(reqBuf);
+    }
+
+    if (respBuf) {
+        PacketBuffer::Free(respBuf);
+    }
+
+    return err;
+}
+
+void TestTdm::TestTdmUpdate_RoundTrip(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    UpdateClient updateClient;
+    UpdateEventLog log = { };
+    uint64_t startVersion;
+
+    Reset();
+    startVersion = mTestTdmSource.GetVersion();
+
+    err = updateClient.Init(mClientBinding, &log, UpdateClientEventCallback, &mSinkCatalog);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    mTestTdmSink.mLocalValues[TestHTrait::kPropertyHandle_A] = 5;
+    mTestTdmSink.mLocalValues[TestHTrait::kPropertyHandle_B] = 6;
+
+    // Repeated mutations of the same property share a pending path
+    updateClient.SetUpdated(0, TestHTrait::kPropertyHandle_A, false);
+    updateClient.SetUpdated(0, TestHTrait::kPropertyHandle_B, false);
+    updateClient.SetUpdated(0, TestHTrait::kPropertyHandle_A, false);
+    NL_TEST_ASSERT(inSuite, updateClient.GetNumPendingPaths() == 2);
+
+    err = BuildAndProcessUpdate(updateClient);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // Both paths land in a single change, so the version moves once
+    NL_TEST_ASSERT(inSuite, mTestTdmSource.mValues[TestHTrait::kPropertyHandle_A] == 5);
+    NL_TEST_ASSERT(inSuite, mTestTdmSource.mValues[TestHTrait::kPropertyHandle_B] == 6);
+    NL_TEST_ASSERT(inSuite, mTestTdmSource.GetVersion() == startVersion + 1);
+
+    NL_TEST_ASSERT(inSuite, log.mPathStatus.size() == 2);
+    NL_TEST_ASSERT(inSuite, log.mPathStatus[TestHTrait::kPropertyHandle_A] == nl::Weave::Profiles::Common::kStatus_Success);
+    NL_TEST_ASSERT(inSuite, log.mPathStatus[TestHTrait::kPropertyHandle_B] == nl::Weave::Profiles::Common::kStatus_Success);
+    NL_TEST_ASSERT(inSuite, log.mIsVersionValid && log.mVersion == startVersion + 1);
+    NL_TEST_ASSERT(inSuite, log.mNumPathsCompleted == 2);
+    NL_TEST_ASSERT(inSuite, updateClient.GetNumRequestsInFlight() == 0);
+
+    updateClient.Cancel();
+}
+
+void TestTdm::TestTdmUpdate_VersionMismatch(nlTestSuite *inSuite)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    UpdateClient updateClient;
+    UpdateEventLog log = { };
+    uint64_t staleVersion;
+
+    Reset();
+
+    // Get the sink in sync with the source, then move the source ahead of it
+    mTestTdmSource.SetValue(TestHTrait::kPropertyHandle_A, 2);
+    err = BuildAndProcessNotify();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    staleVersion = mTestTdmSource.GetVersion();
+
+    mTestTdmSource.Lock();
+    mTestTdmSource.SetValue(TestHTrait::kPropertyHandle_A, 3);
+    mTestTdmSource.Unlock();
+    NL_TEST_ASSERT(inSuite, mTestTdmSource.GetVersion() == staleVersion + 1);
+
+    err = updateClient.Init(mClientBinding, &log, UpdateClientEventCallback, &mSinkCatalog);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    mTestTdmSink.mLocalValues[TestHTrait::kPropertyHandle_A] = 7;
+
+    err = updateClient.SetUpdated(0, TestHTrait::kPropertyHandle_A, true);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = BuildAndProcessUpdate(updateClient);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    // The publisher refuses the change and keeps its value
+    NL_TEST_ASSERT(inSuite, mTestTdmSource.mValues[TestHTrait::kPropertyHandle_A] == 3);
+    NL_TEST_ASSERT(inSuite, mTestTdmSource.GetVersion() == staleVersion + 1);
+    NL_TEST_ASSERT(inSuite, log.mPathStatus[TestHTrait::kPropertyHandle_A] == kStatus_VersionMismatch);
+    NL_TEST_ASSERT(inSuite, !log.mIsVersionValid);
+    NL_TEST_ASSERT(inSuite, log.mNumPathsCompleted == 1);
+
+    updateClient.Cancel();
+}
+
 void TestTdm::TestTdmStatic_SingleLeafHandle(nlTestSuite *inSuite)
 {
     WEAVE_ERROR err = WEAVE_NO_ERROR;
@@ -2064,6 +2279,16 @@ static void TestTdmStatic_MultiInstance(nlTestSuite *inSuite, void *inContext)
     gTestTdm->TestTdmStatic_MultiInstance(inSuite);
 }
 
+static void TestTdmUpdate_RoundTrip(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmUpdate_RoundTrip(inSuite);
+}
+
+static void TestTdmUpdate_VersionMismatch(nlTestSuite *inSuite, void *inContext)
+{
+    gTestTdm->TestTdmUpdate_VersionMismatch(inSuite);
+}
+
 /**
  *  Main
  */
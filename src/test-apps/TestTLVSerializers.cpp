@@ -0,0 +1,469 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a unit test suite for the specialized TLV
+ *      serializers produced by gen-tlv-serializers.py, checking that
+ *      they encode and decode exactly like the schema-driven
+ *      interpreter in SerializationUtils.
+ *
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <nltest.h>
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Core/WeaveTLV.h>
+#include <Weave/Support/CodeUtils.h>
+#include <Weave/Support/SerializationUtils.h>
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+
+#include "TestEventLoggingSchemaSerializers.h"
+#include "TestETraitSerializers.h"
+
+using namespace nl::Weave::TLV;
+using namespace nl::Weave::Profiles::DataManagement;
+using namespace Schema::Nest::Test::Trait;
+
+namespace nl {
+namespace Weave {
+namespace Profiles {
+namespace WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current) {
+namespace Platform {
+    // for unit tests, the dummy critical section is sufficient.
+    void CriticalSectionEnter()
+    {
+        return;
+    }
+
+    void CriticalSectionExit()
+    {
+        return;
+    }
+} // Platform
+} // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
+} // Profiles
+} // Weave
+} // nl
+
+#define TEST_DATA_TAG       1
+#define TEST_BUFFER_SIZE    1024
+
+// Allocations outstanding through the counting memory management below.
+static int sOutstandingAllocations;
+
+static void *CountingMalloc(size_t size)
+{
+    sOutstandingAllocations++;
+    return malloc(size);
+}
+
+static void CountingFree(void *ptr)
+{
+    if (ptr != NULL)
+        sOutstandingAllocations--;
+    free(ptr);
+}
+
+static void *CountingRealloc(void *ptr, size_t size)
+{
+    if (ptr == NULL)
+        sOutstandingAllocations++;
+    return realloc(ptr, size);
+}
+
+static nl::MemoryManagement sCountingMemoryManagement = { CountingMalloc, CountingFree, CountingRealloc };
+static nl::SerializationContext sContext;
+
+typedef WEAVE_ERROR (*WriteFunct)(TLVWriter &writer, uint8_t dataTag, void *appData);
+typedef WEAVE_ERROR (*ReadFunct)(TLVReader &reader, uint8_t dataTag, void *appData, nl::SerializationContext *context);
+
+// Context tags are not allowed at the top level, so the data element is wrapped in an anonymous structure.
+static WEAVE_ERROR Encode(WriteFunct funct, void *appData, uint8_t *buf, uint32_t &len)
+{
+    WEAVE_ERROR err;
+    TLVWriter writer;
+    TLVType outerType;
+
+    writer.Init(buf, TEST_BUFFER_SIZE);
+
+    err = writer.StartContainer(AnonymousTag, kTLVType_Structure, outerType);
+    SuccessOrExit(err);
+
+    err = funct(writer, TEST_DATA_TAG, appData);
+    SuccessOrExit(err);
+
+    err = writer.EndContainer(outerType);
+    SuccessOrExit(err);
+
+    err = writer.Finalize();
+    SuccessOrExit(err);
+
+    len = writer.GetLengthWritten();
+
+exit:
+    return err;
+}
+
+static WEAVE_ERROR Decode(ReadFunct funct, void *appData, const uint8_t *buf, uint32_t len)
+{
+    WEAVE_ERROR err;
+    TLVReader reader;
+    TLVType outerType;
+
+    reader.Init(buf, len);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    err = reader.EnterContainer(outerType);
+    SuccessOrExit(err);
+
+    err = reader.Next();
+    SuccessOrExit(err);
+
+    err = funct(reader, TEST_DATA_TAG, appData, &sContext);
+
+exit:
+    return err;
+}
+
+// Encodes aStructureData with both the interpreter and the generated serializer and compares the encodings.
+static void CheckEncodingsMatch(nlTestSuite *inSuite, void *aStructureData, const nl::SchemaFieldDescriptor *aSchema,
+                                WriteFunct aGenerated)
+{
+    nl::StructureSchemaPointerPair pair = { aStructureData, aSchema };
+    uint8_t interpreted[TEST_BUFFER_SIZE];
+    uint8_t generated[TEST_BUFFER_SIZE];
+    uint32_t interpretedLen = 0;
+    uint32_t generatedLen = 0;
+
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, interpreted, interpretedLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Encode(aGenerated, aStructureData, generated, generatedLen) == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, interpretedLen > 0);
+    NL_TEST_ASSERT(inSuite, interpretedLen == generatedLen);
+    NL_TEST_ASSERT(inSuite, memcmp(interpreted, generated, interpretedLen) == 0);
+}
+
+// Decodes an encoding with the generated deserializer and checks that the interpreter re-encodes the result as expected.
+static void CheckDecoding(nlTestSuite *inSuite, const uint8_t *aEncoding, uint32_t aEncodingLen, const uint8_t *aExpected,
+                          uint32_t aExpectedLen, void *aStructureData, const nl::SchemaFieldDescriptor *aSchema, ReadFunct aGenerated,
+                          WEAVE_ERROR (*aDeallocate)(void *, nl::SerializationContext *))
+{
+    nl::StructureSchemaPointerPair pair = { aStructureData, aSchema };
+    uint8_t encoding[TEST_BUFFER_SIZE];
+    uint32_t encodingLen = 0;
+
+    memset(aStructureData, 0, aSchema->mSize);
+    sOutstandingAllocations = 0;
+
+    NL_TEST_ASSERT(inSuite, Decode(aGenerated, aStructureData, aEncoding, aEncodingLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, encoding, encodingLen) == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, encodingLen == aExpectedLen);
+    NL_TEST_ASSERT(inSuite, memcmp(encoding, aExpected, aExpectedLen) == 0);
+
+    NL_TEST_ASSERT(inSuite, aDeallocate(aStructureData, &sContext) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sOutstandingAllocations == 0);
+}
+
+static void InitSampleEvent(SampleTrait::Event &ev, uint32_t *samples, uint32_t numSamples)
+{
+    memset(&ev, 0, sizeof(ev));
+
+    ev.state = 5;
+    ev.timestamp = 0x12345678;
+    ev.structure.a = true;
+    ev.structure.b.str = "sample event";
+    ev.samples.num_samples = numSamples;
+    ev.samples.samples_buf = samples;
+}
+
+static void InitTestEEvent(TestETrait::TestEEvent &ev, uint32_t *numbers, TestCommonTrait::CommonStructE *structs, uint8_t *bytes)
+{
+    memset(&ev, 0, sizeof(ev));
+
+    for (uint32_t i = 0; i < 5; i++)
+        numbers[i] = i * 1000 + 1;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        structs[i].seA = 1111111 * (i + 1);
+        structs[i].seB = (i % 2) == 0;
+    }
+    for (uint32_t i = 0; i < 8; i++)
+        bytes[i] = static_cast<uint8_t>(0xA0 + i);
+
+    ev.teA = 444444;
+    ev.teB = -555555;
+    ev.teC = true;
+    ev.teD = -666666;
+    ev.teE.seA = 777777;
+    ev.teE.seB = false;
+    ev.teE.seC = -888888;
+    ev.teF = 999999;
+    ev.teG.seA = 101010;
+    ev.teG.seB = true;
+    ev.teH.num = 5;
+    ev.teH.buf = numbers;
+    ev.teI.num = 3;
+    ev.teI.buf = structs;
+    ev.teJ = 12121;
+    ev.teK.mBuf = bytes;
+    ev.teK.mLen = 8;
+    ev.teL = 131313;
+    ev.SetTeMNull();
+    ev.teN.mBuf = bytes;
+    ev.teN.mLen = 4;
+    ev.teO = 151515;
+    ev.teP = -0x123456789LL;
+    ev.teQ = 0x7EDCBA9876543210LL;
+    ev.teR = 171717;
+    ev.SetTeSNull();
+}
+
+static void InitTestENullableEvent(TestETrait::TestENullableEvent &ev)
+{
+    memset(&ev, 0, sizeof(ev));
+
+    ev.neA = 1;
+    ev.SetNeBNull();
+    ev.neC = true;
+    ev.neD = "nullable";
+    ev.SetNeENull();
+    ev.neF = 6;
+    ev.neG = -7;
+    ev.SetNeHNull();
+    ev.SetNeINull();
+    ev.neJ.neA = 10;
+    ev.neJ.SetNeBNull();
+}
+
+static void CheckSampleEvent(nlTestSuite *inSuite, void *inContext)
+{
+    SampleTrait::Event ev;
+    SampleTrait::Event ev2;
+    uint32_t samples[] = { 2, 3, 5, 7, 11, 13, 17 };
+    nl::StructureSchemaPointerPair pair = { &ev, &sampleEventSchema };
+    uint8_t encoding[TEST_BUFFER_SIZE];
+    uint32_t encodingLen = 0;
+
+    InitSampleEvent(ev, samples, sizeof(samples) / sizeof(samples[0]));
+    CheckEncodingsMatch(inSuite, &ev, &sampleEventSchema, SerializeSampleEventSchemaHelper);
+
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, encoding, encodingLen) == WEAVE_NO_ERROR);
+    CheckDecoding(inSuite, encoding, encodingLen, encoding, encodingLen, &ev2, &sampleEventSchema, DeserializeSampleEventSchemaHelper,
+                            DeallocateSampleEventSchema);
+
+    // An empty array.
+    InitSampleEvent(ev, NULL, 0);
+    CheckEncodingsMatch(inSuite, &ev, &sampleEventSchema, SerializeSampleEventSchemaHelper);
+
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, encoding, encodingLen) == WEAVE_NO_ERROR);
+    CheckDecoding(inSuite, encoding, encodingLen, encoding, encodingLen, &ev2, &sampleEventSchema, DeserializeSampleEventSchemaHelper,
+                            DeallocateSampleEventSchema);
+}
+
+static void CheckTestEEvent(nlTestSuite *inSuite, void *inContext)
+{
+    TestETrait::TestEEvent ev;
+    TestETrait::TestEEvent ev2;
+    uint32_t numbers[5];
+    TestCommonTrait::CommonStructE structs[3];
+    uint8_t bytes[8];
+    nl::StructureSchemaPointerPair pair = { &ev, &TestETrait::TestEEvent::FieldSchema };
+    uint8_t encoding[TEST_BUFFER_SIZE];
+    uint32_t encodingLen = 0;
+
+    InitTestEEvent(ev, numbers, structs, bytes);
+    CheckEncodingsMatch(inSuite, &ev, &TestETrait::TestEEvent::FieldSchema, TestETrait::SerializeTestEEvent_FieldSchemaHelper);
+
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, encoding, encodingLen) == WEAVE_NO_ERROR);
+    CheckDecoding(inSuite, encoding, encodingLen, encoding, encodingLen, &ev2, &TestETrait::TestEEvent::FieldSchema,
+                            TestETrait::DeserializeTestEEvent_FieldSchemaHelper, TestETrait::DeallocateTestEEvent_FieldSchema);
+}
+
+static void CheckTestENullableEvent(nlTestSuite *inSuite, void *inContext)
+{
+    TestETrait::TestENullableEvent ev;
+    TestETrait::TestENullableEvent ev2;
+    nl::StructureSchemaPointerPair pair = { &ev, &TestETrait::TestENullableEvent::FieldSchema };
+    uint8_t encoding[TEST_BUFFER_SIZE];
+    uint32_t encodingLen = 0;
+
+    InitTestENullableEvent(ev);
+    CheckEncodingsMatch(inSuite, &ev, &TestETrait::TestENullableEvent::FieldSchema,
+                        TestETrait::SerializeTestENullableEvent_FieldSchemaHelper);
+
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, encoding, encodingLen) == WEAVE_NO_ERROR);
+    CheckDecoding(inSuite, encoding, encodingLen, encoding, encodingLen, &ev2, &TestETrait::TestENullableEvent::FieldSchema,
+                            TestETrait::DeserializeTestENullableEvent_FieldSchemaHelper,
+                            TestETrait::DeallocateTestENullableEvent_FieldSchema);
+
+    NL_TEST_ASSERT(inSuite, !ev2.IsNeBPresent());
+    NL_TEST_ASSERT(inSuite, ev2.IsNeJPresent());
+}
+
+static void CheckByteStringArrayEvent(nlTestSuite *inSuite, void *inContext)
+{
+    ByteStringArrayTestTrait::Event ev;
+    ByteStringArrayTestTrait::Event ev2;
+    uint8_t bytes[] = { 1, 2, 3, 4, 5, 6 };
+    nl::SerializedByteString strings[3];
+    nl::StructureSchemaPointerPair pair = { &ev, &ByteStringArrayTestEventSchema };
+    uint8_t encoding[TEST_BUFFER_SIZE];
+    uint32_t encodingLen = 0;
+
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        strings[i].mBuf = bytes + i;
+        strings[i].mLen = 3 - i;
+    }
+
+    memset(&ev, 0, sizeof(ev));
+    ev.testArray.num = 3;
+    ev.testArray.buf = strings;
+
+    CheckEncodingsMatch(inSuite, &ev, &ByteStringArrayTestEventSchema, SerializeByteStringArrayTestEventSchemaHelper);
+
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, encoding, encodingLen) == WEAVE_NO_ERROR);
+    CheckDecoding(inSuite, encoding, encodingLen, encoding, encodingLen, &ev2, &ByteStringArrayTestEventSchema,
+                            DeserializeByteStringArrayTestEventSchemaHelper, DeallocateByteStringArrayTestEventSchema);
+}
+
+// Unknown, out-of-order and missing fields must be handled the same way the interpreter handles them.
+static void CheckTolerance(nlTestSuite *inSuite, void *inContext)
+{
+    TestETrait::TestENullableEvent interpreted;
+    TestETrait::TestENullableEvent generated;
+    nl::StructureSchemaPointerPair pair = { &interpreted, &TestETrait::TestENullableEvent::FieldSchema };
+    uint8_t encoding[TEST_BUFFER_SIZE];
+    uint8_t reencoding[TEST_BUFFER_SIZE];
+    uint32_t encodingLen;
+    uint32_t reencodingLen = 0;
+    TLVWriter writer;
+    TLVType outerType;
+    TLVType containerType;
+    TLVType innerType;
+
+    writer.Init(encoding, sizeof(encoding));
+    NL_TEST_ASSERT(inSuite, writer.StartContainer(AnonymousTag, kTLVType_Structure, outerType) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.StartContainer(ContextTag(TEST_DATA_TAG), kTLVType_Structure, containerType) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Put(ContextTag(1), static_cast<uint32_t>(41)) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.StartContainer(ContextTag(50), kTLVType_Structure, innerType) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.PutString(ContextTag(1), "unknown") == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.EndContainer(innerType) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.PutString(ContextTag(4), "present") == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Put(ContextTag(2), static_cast<int32_t>(-2)) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.PutNull(ContextTag(6)) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Put(ContextTag(7), static_cast<int32_t>(-7)) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.EndContainer(containerType) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.EndContainer(outerType) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, writer.Finalize() == WEAVE_NO_ERROR);
+    encodingLen = writer.GetLengthWritten();
+
+    memset(&interpreted, 0, sizeof(interpreted));
+    NL_TEST_ASSERT(inSuite, Decode(nl::TLVReaderToDeserializedDataHelper, &pair, encoding, encodingLen) == WEAVE_NO_ERROR);
+
+    NL_TEST_ASSERT(inSuite, interpreted.neA == 41);
+    NL_TEST_ASSERT(inSuite, interpreted.IsNeDPresent());
+    NL_TEST_ASSERT(inSuite, !interpreted.IsNeBPresent());
+    NL_TEST_ASSERT(inSuite, !interpreted.IsNeFPresent());
+    NL_TEST_ASSERT(inSuite, interpreted.IsNeGPresent());
+    NL_TEST_ASSERT(inSuite, !interpreted.IsNeJPresent());
+
+    // The generated deserializer must produce a structure that re-encodes identically.
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, reencoding, reencodingLen) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, nl::DeallocateDeserializedStructure(&interpreted, &TestETrait::TestENullableEvent::FieldSchema, &sContext) == WEAVE_NO_ERROR);
+
+    CheckDecoding(inSuite, encoding, encodingLen, reencoding, reencodingLen, &generated, &TestETrait::TestENullableEvent::FieldSchema,
+                            TestETrait::DeserializeTestENullableEvent_FieldSchemaHelper,
+                            TestETrait::DeallocateTestENullableEvent_FieldSchema);
+}
+
+// Decoding with an arena takes nothing from the memory management functions.
+static void CheckArena(nlTestSuite *inSuite, void *inContext)
+{
+    TestETrait::TestEEvent ev;
+    TestETrait::TestEEvent ev2;
+    uint32_t numbers[5];
+    TestCommonTrait::CommonStructE structs[3];
+    uint8_t bytes[8];
+    nl::StructureSchemaPointerPair pair = { &ev, &TestETrait::TestEEvent::FieldSchema };
+    uint8_t encoding[TEST_BUFFER_SIZE];
+    uint32_t encodingLen = 0;
+    uint64_t arenaBuffer[32];
+    nl::SerializationArena arena;
+
+    InitTestEEvent(ev, numbers, structs, bytes);
+    NL_TEST_ASSERT(inSuite, Encode(nl::SerializedDataToTLVWriterHelper, &pair, encoding, encodingLen) == WEAVE_NO_ERROR);
+
+    arena.Init(arenaBuffer, sizeof(arenaBuffer));
+    sContext.mArena = &arena;
+
+    CheckDecoding(inSuite, encoding, encodingLen, encoding, encodingLen, &ev2, &TestETrait::TestEEvent::FieldSchema,
+                  TestETrait::DeserializeTestEEvent_FieldSchemaHelper, TestETrait::DeallocateTestEEvent_FieldSchema);
+    NL_TEST_ASSERT(inSuite, arena.GetBytesUsed() > 0);
+
+    arena.Reset();
+    NL_TEST_ASSERT(inSuite, arena.GetBytesUsed() == 0);
+
+    // An arena too small for the event makes decoding fail cleanly.
+    arena.Init(arenaBuffer, 64);
+    memset(&ev2, 0, sizeof(ev2));
+    NL_TEST_ASSERT(inSuite, Decode(TestETrait::DeserializeTestEEvent_FieldSchemaHelper, &ev2, encoding, encodingLen) ==
+                   WEAVE_ERROR_NO_MEMORY);
+
+    sContext.mArena = NULL;
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF("TLVSerializers::SampleEvent",          CheckSampleEvent),
+    NL_TEST_DEF("TLVSerializers::TestEEvent",           CheckTestEEvent),
+    NL_TEST_DEF("TLVSerializers::TestENullableEvent",   CheckTestENullableEvent),
+    NL_TEST_DEF("TLVSerializers::ByteStringArrayEvent", CheckByteStringArrayEvent),
+    NL_TEST_DEF("TLVSerializers::Tolerance",            CheckTolerance),
+    NL_TEST_DEF("TLVSerializers::Arena",                CheckArena),
+    NL_TEST_SENTINEL()
+};
+
+int main(int argc, char *argv[])
+{
+    nlTestSuite theSuite = {
+        "tlv-serializers",
+        &sTests[0],
+        NULL,
+        NULL
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    sContext.memMgmt = sCountingMemoryManagement;
+
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
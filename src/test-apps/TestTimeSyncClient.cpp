@@ -0,0 +1,283 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file tests the concurrent sync mode of the Weave Time Sync
+ *      client against contacts reached over the loopback interface: one
+ *      that answers every request and others that never do, so that the
+ *      length of a sync shows whether the contacts were waited for one
+ *      after another or all at once.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ToolCommon.h"
+#include <Weave/Profiles/time/WeaveTime.h>
+#include <nltest.h>
+
+#if WEAVE_CONFIG_TIME_ENABLE_CLIENT && WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
+using namespace nl::Weave;
+using namespace nl::Weave::Profiles::Time;
+
+#define TEST_WAIT_LIMIT_MS          (5 * WEAVE_CONFIG_TIME_CLIENT_TIMER_UNICAST_MSEC)
+
+enum
+{
+    kNumTestContacts = 3,
+    kSilentNodeId    = 0x18B4300000000F00ULL,   // requests to this node are dropped by the local message layer
+};
+
+struct SyncEvents
+{
+    uint32_t Count;
+    WEAVE_ERROR Error;
+    uint8_t NumContributor;
+    uint8_t CountCommError[kNumTestContacts];
+};
+
+static TimeSyncNode sClient;
+static ServingNode sContacts[kNumTestContacts];
+static SyncEvents sEvents;
+
+// The time sync server ignores requests from its own node, so the test answers the requests addressed to the
+// local node itself, like a server that has just synced with the service.
+static void HandleSyncRequest(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo,
+                              uint32_t profileId, uint8_t msgType, PacketBuffer *payload)
+{
+    PacketBuffer *msgBuf = PacketBuffer::New();
+    TimeSyncResponse response;
+    timesync_t now_usec;
+
+    PacketBuffer::Free(payload);
+
+    if (msgBuf != NULL && nl::Weave::Platform::Time::GetSystemTime(&now_usec) == WEAVE_NO_ERROR)
+    {
+        response.Init(kTimeSyncRole_Server, now_usec, now_usec, 0, 0);
+
+        if (response.Encode(msgBuf) == WEAVE_NO_ERROR)
+        {
+            ec->SendMessage(kWeaveProfile_Time, kTimeMessageType_TimeSyncResponse, msgBuf);
+            msgBuf = NULL;
+        }
+    }
+
+    if (msgBuf != NULL)
+        PacketBuffer::Free(msgBuf);
+
+    ec->Close();
+}
+
+static void HandleContributors(void * const aApp, Contact aContact[], const int aSize)
+{
+    SyncEvents *events = static_cast<SyncEvents *>(aApp);
+
+    // The contacts are stored in the order they were given to SyncWithNodes().
+    for (int i = 0; i < kNumTestContacts && i < aSize; i++)
+        events->CountCommError[i] = aContact[i].mCountCommError;
+}
+
+static bool HandleSyncSucceeded(void * const aApp, const timesync_t aOffsetUsec, const bool aIsReliable,
+                                const bool aIsServer, const uint8_t aNumContributor)
+{
+    SyncEvents *events = static_cast<SyncEvents *>(aApp);
+
+    events->Count++;
+    events->Error = WEAVE_NO_ERROR;
+    events->NumContributor = aNumContributor;
+
+    // Leave the system clock alone.
+    return false;
+}
+
+static void HandleSyncFailed(void * const aApp, const WEAVE_ERROR aErrorCode)
+{
+    SyncEvents *events = static_cast<SyncEvents *>(aApp);
+
+    events->Count++;
+    events->Error = aErrorCode;
+}
+
+// Service events until the sync completes or the wait limit expires, and return how long that took.
+static uint64_t WaitForSync(void)
+{
+    const uint64_t startTime = NowMs();
+    const uint64_t deadline = startTime + TEST_WAIT_LIMIT_MS;
+
+    while (sEvents.Count == 0 && NowMs() < deadline)
+    {
+        struct timeval sleepTime;
+
+        sleepTime.tv_sec = 0;
+        sleepTime.tv_usec = 1000;
+        ServiceNetwork(sleepTime);
+    }
+
+    return NowMs() - startTime;
+}
+
+static void CheckArguments(nlTestSuite *inSuite, void *inContext)
+{
+    NL_TEST_ASSERT(inSuite, sClient.EnableConcurrentSync(WEAVE_CONFIG_TIME_CLIENT_MAX_NUM_CONTACTS + 1) ==
+                            WEAVE_ERROR_INVALID_ARGUMENT);
+    NL_TEST_ASSERT(inSuite, sClient.EnableConcurrentSync(0) == WEAVE_NO_ERROR);
+
+    // The mode can only be changed while the client is idle.
+    NL_TEST_ASSERT(inSuite, sClient.SyncWithNodes(kNumTestContacts, sContacts) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sClient.GetClientState() == TimeSyncNode::kClientState_Sync_1);
+    NL_TEST_ASSERT(inSuite, sClient.EnableConcurrentSync(1) == WEAVE_ERROR_INCORRECT_STATE);
+
+    // Aborting drops the outstanding requests without reporting the sync.
+    NL_TEST_ASSERT(inSuite, sClient.Abort() == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sClient.GetClientState() == TimeSyncNode::kClientState_Idle);
+
+    sClient.DisableConcurrentSync();
+}
+
+static void CheckConcurrentSync(nlTestSuite *inSuite, void *inContext)
+{
+    uint64_t elapsed;
+
+    memset(&sEvents, 0, sizeof(sEvents));
+
+    NL_TEST_ASSERT(inSuite, sClient.EnableConcurrentSync(0) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sClient.SyncWithNodes(kNumTestContacts, sContacts) == WEAVE_NO_ERROR);
+
+    elapsed = WaitForSync();
+
+    // Each of the two rounds waits for the silent contacts once, rather than once per contact as the sequential
+    // mode would, which takes four response timeouts.
+    NL_TEST_ASSERT(inSuite, sEvents.Count == 1);
+    NL_TEST_ASSERT(inSuite, sEvents.Error == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sEvents.NumContributor == 1);
+    NL_TEST_ASSERT(inSuite, elapsed < 3 * WEAVE_CONFIG_TIME_CLIENT_TIMER_UNICAST_MSEC);
+    NL_TEST_ASSERT(inSuite, sEvents.CountCommError[0] == 2);
+    NL_TEST_ASSERT(inSuite, sEvents.CountCommError[1] == 2);
+    NL_TEST_ASSERT(inSuite, sEvents.CountCommError[2] == 0);
+    NL_TEST_ASSERT(inSuite, sClient.GetClientState() == TimeSyncNode::kClientState_Idle);
+
+    sClient.DisableConcurrentSync();
+}
+
+static void CheckQuorum(nlTestSuite *inSuite, void *inContext)
+{
+    uint64_t elapsed;
+
+    memset(&sEvents, 0, sizeof(sEvents));
+
+    NL_TEST_ASSERT(inSuite, sClient.EnableConcurrentSync(1) == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sClient.SyncWithNodes(kNumTestContacts, sContacts) == WEAVE_NO_ERROR);
+
+    elapsed = WaitForSync();
+
+    // Both rounds end with the first response; the requests still outstanding are not held against the silent
+    // contacts.
+    NL_TEST_ASSERT(inSuite, sEvents.Count == 1);
+    NL_TEST_ASSERT(inSuite, sEvents.Error == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, sEvents.NumContributor == 1);
+    NL_TEST_ASSERT(inSuite, elapsed < WEAVE_CONFIG_TIME_CLIENT_TIMER_UNICAST_MSEC);
+    NL_TEST_ASSERT(inSuite, sEvents.CountCommError[0] == 0);
+    NL_TEST_ASSERT(inSuite, sEvents.CountCommError[1] == 0);
+    NL_TEST_ASSERT(inSuite, sEvents.CountCommError[2] == 0);
+    NL_TEST_ASSERT(inSuite, sClient.GetClientState() == TimeSyncNode::kClientState_Idle);
+
+    sClient.DisableConcurrentSync();
+}
+
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Arguments",                    CheckArguments),
+    NL_TEST_DEF("Concurrent Sync",              CheckConcurrentSync),
+    NL_TEST_DEF("Quorum",                       CheckQuorum),
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite: start the Weave stack, answer the time sync requests addressed to the local node, and
+ *  initialize the client with two silent contacts ahead of the answering one.
+ */
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+    InitNetwork();
+    InitWeaveStack(true, true);
+
+    if (ExchangeMgr.RegisterUnsolicitedMessageHandler(kWeaveProfile_Time, kTimeMessageType_TimeSyncRequest,
+                                                      HandleSyncRequest, NULL) != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    if (sClient.InitClient(&sEvents, &ExchangeMgr) != WEAVE_NO_ERROR)
+        return FAILURE;
+
+    sClient.FilterTimeCorrectionContributor = HandleContributors;
+    sClient.OnSyncSucceeded = HandleSyncSucceeded;
+    sClient.OnSyncFailed = HandleSyncFailed;
+
+    for (int i = 0; i < kNumTestContacts; i++)
+    {
+        sContacts[i].mNodeId = (i < kNumTestContacts - 1) ? kSilentNodeId + i : FabricState.LocalNodeId;
+        IPAddress::FromString("::1", sContacts[i].mNodeAddr);
+    }
+
+    return SUCCESS;
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    sClient.Shutdown();
+    ExchangeMgr.UnregisterUnsolicitedMessageHandler(kWeaveProfile_Time, kTimeMessageType_TimeSyncRequest);
+
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+#endif // WEAVE_CONFIG_TIME_ENABLE_CLIENT && WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+
+int main(void)
+{
+#if WEAVE_CONFIG_TIME_ENABLE_CLIENT && WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+    nlTestSuite theSuite = {
+        "Time-Sync-Client",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+#else
+    return 0;
+#endif // WEAVE_CONFIG_TIME_ENABLE_CLIENT && WEAVE_CONFIG_TIME_CLIENT_CONCURRENT_SYNC
+}
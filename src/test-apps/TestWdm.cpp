@@ -98,6 +98,7 @@ SubscriptionEngine * SubscriptionEngine::GetInstance()
 }
 
 static void TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite, void *inContext);
+static void TestDataList_StreamingSchemaCheck(nlTestSuite *inSuite, void *inContext);
 
 // Test Suite
 
@@ -106,6 +107,7 @@ static void TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite, voi
  */
 static const nlTest sTests[] = {
     NL_TEST_DEF("Test Counter Subscription -- Buffer Allocation Failure", TestCounterSubscription_BufferAllocFailure),
+    NL_TEST_DEF("Test Data List -- Streaming Schema Check", TestDataList_StreamingSchemaCheck),
 
     NL_TEST_SENTINEL()
 };
@@ -125,6 +127,7 @@ public:
     int BuildAndProcessNotify();
 
     void TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite);
+    void TestDataList_StreamingSchemaCheck(nlTestSuite *inSuite);
     void SpoofPublisherSubscription();
 
     static void ClientSubscriptionEventCallback(void * const aAppState,
@@ -433,6 +436,54 @@ void TestWdm::TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite)
     NL_TEST_ASSERT(inSuite, mPublisherSubscriptionPresent == false);
 }
 
+void TestWdm::TestDataList_StreamingSchemaCheck(nlTestSuite *inSuite)
+{
+    uint8_t buf[64];
+    TLVWriter writer;
+    TLVReader reader;
+    TLVType dummyType;
+    WEAVE_ERROR err;
+
+    // A data list whose only element is not a structure
+    writer.Init(buf, sizeof(buf));
+    writer.StartContainer(AnonymousTag, kTLVType_Array, dummyType);
+    writer.Put(AnonymousTag, static_cast<uint32_t>(1));
+    writer.EndContainer(dummyType);
+    writer.Finalize();
+
+    reader.Init(buf, writer.GetLengthWritten());
+    reader.Next();
+    reader.EnterContainer(dummyType);
+    reader.Next();
+
+    err = DataList::Parser::CheckElementSchemaValidity(reader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_WRONG_TLV_TYPE);
+
+#if WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+    // The malformed element is rejected while the data list is being consumed
+    reader.Init(buf, writer.GetLengthWritten());
+    reader.Next();
+    reader.EnterContainer(dummyType);
+
+    err = mSubClient->ProcessDataList(reader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_WRONG_TLV_TYPE);
+    NL_TEST_ASSERT(inSuite, mSubClient->mPrevIsPartialChange == false);
+
+    // An empty data list is rejected as well
+    writer.Init(buf, sizeof(buf));
+    writer.StartContainer(AnonymousTag, kTLVType_Array, dummyType);
+    writer.EndContainer(dummyType);
+    writer.Finalize();
+
+    reader.Init(buf, writer.GetLengthWritten());
+    reader.Next();
+    reader.EnterContainer(dummyType);
+
+    err = mSubClient->ProcessDataList(reader);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_ERROR_INVALID_DATA_LIST);
+#endif // WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_SCHEMA_CHECK && WEAVE_CONFIG_DATA_MANAGEMENT_ENABLE_STREAMING_SCHEMA_CHECK
+}
+
 } // WeaveMakeManagedNamespaceIdentifier(DataManagement, kWeaveManagedNamespaceDesignation_Current)
 }
 }
@@ -462,6 +513,11 @@ static void TestCounterSubscription_BufferAllocFailure(nlTestSuite *inSuite, voi
     gTestWdm->TestCounterSubscription_BufferAllocFailure(inSuite);
 }
 
+static void TestDataList_StreamingSchemaCheck(nlTestSuite *inSuite, void *inContext)
+{
+    gTestWdm->TestDataList_StreamingSchemaCheck(inSuite);
+}
+
 /**
  *  Main
  */
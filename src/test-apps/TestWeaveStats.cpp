@@ -0,0 +1,315 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a process to effect a functional test for
+ *      the Weave latency histograms and message counters.
+ *
+ */
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include <Weave/Core/WeaveCore.h>
+#include <Weave/Core/WeaveTLV.h>
+#include <Weave/Core/WeaveStats.h>
+#include <Weave/Support/CodeUtils.h>
+#include <SystemLayer/SystemStats.h>
+
+#include <nltest.h>
+
+#include "ToolCommon.h"
+
+#define TOOL_NAME "TestWeaveStats"
+
+using namespace nl::Weave::TLV;
+using nl::Weave::System::Stats::Histogram;
+
+static void CheckHistogramBuckets(nlTestSuite *inSuite, void *inContext)
+{
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucket(0) == 0);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucket(1) == 0);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucket(2) == 1);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucket(3) == 1);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucket(4) == 2);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucket(1023) == 9);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucket(1024) == 10);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucket(UINT32_MAX) == Histogram::kNumBuckets - 1);
+
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucketUpperBound(0) == 2);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucketUpperBound(9) == 1024);
+    NL_TEST_ASSERT(inSuite, Histogram::GetBucketUpperBound(Histogram::kNumBuckets - 1) == UINT32_MAX);
+}
+
+static void CheckHistogramRecord(nlTestSuite *inSuite, void *inContext)
+{
+    Histogram histogram;
+
+    histogram.Reset();
+
+    NL_TEST_ASSERT(inSuite, histogram.GetPercentile(50) == 0);
+
+    // 90 samples around 100us, 10 around 5000us
+    for (int i = 0; i < 90; i++)
+    {
+        histogram.Record(100);
+    }
+
+    for (int i = 0; i < 10; i++)
+    {
+        histogram.Record(5000);
+    }
+
+    histogram.Record(7);
+
+    NL_TEST_ASSERT(inSuite, histogram.mCount == 101);
+    NL_TEST_ASSERT(inSuite, histogram.mMin == 7);
+    NL_TEST_ASSERT(inSuite, histogram.mMax == 5000);
+    NL_TEST_ASSERT(inSuite, histogram.mSum == 90 * 100 + 10 * 5000 + 7);
+    NL_TEST_ASSERT(inSuite, histogram.mBuckets[Histogram::GetBucket(100)] == 90);
+    NL_TEST_ASSERT(inSuite, histogram.mBuckets[Histogram::GetBucket(5000)] == 10);
+
+    NL_TEST_ASSERT(inSuite, histogram.GetPercentile(50) == 128);
+    NL_TEST_ASSERT(inSuite, histogram.GetPercentile(95) == 5000);
+    NL_TEST_ASSERT(inSuite, histogram.GetPercentile(100) == 5000);
+    NL_TEST_ASSERT(inSuite, histogram.GetPercentile(0) == 8);
+}
+
+static void CheckSnapshotDifference(nlTestSuite *inSuite, void *inContext)
+{
+    nl::Weave::System::Stats::Snapshot before;
+    nl::Weave::System::Stats::Snapshot after;
+    nl::Weave::System::Stats::Snapshot delta;
+    Histogram *histograms = nl::Weave::System::Stats::GetHistograms();
+
+    nl::Weave::Stats::ResetCounters();
+
+    histograms[nl::Weave::System::Stats::kHistogram_ExchangeDispatchTime].Record(10);
+    nl::Weave::System::Stats::UpdateSnapshot(before);
+
+    histograms[nl::Weave::System::Stats::kHistogram_ExchangeDispatchTime].Record(3000);
+    histograms[nl::Weave::System::Stats::kHistogram_ExchangeDispatchTime].Record(3000);
+    nl::Weave::System::Stats::UpdateSnapshot(after);
+
+    nl::Weave::System::Stats::Difference(delta, after, before);
+
+    const Histogram &histogram = delta.mHistograms[nl::Weave::System::Stats::kHistogram_ExchangeDispatchTime];
+
+    NL_TEST_ASSERT(inSuite, histogram.mCount == 2);
+    NL_TEST_ASSERT(inSuite, histogram.mSum == 6000);
+    NL_TEST_ASSERT(inSuite, histogram.mBuckets[Histogram::GetBucket(10)] == 0);
+    NL_TEST_ASSERT(inSuite, histogram.mBuckets[Histogram::GetBucket(3000)] == 2);
+
+    PrintStatsHistograms(delta.mHistograms, NULL);
+}
+
+static void CheckMessageCounters(nlTestSuite *inSuite, void *inContext)
+{
+    nl::Weave::Stats::MessageCounter counters[WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS];
+    size_t numCounters;
+    bool found = false;
+
+    nl::Weave::Stats::ResetCounters();
+
+    nl::Weave::Stats::CountMessageSent(nl::Weave::Profiles::kWeaveProfile_Echo, 1);
+    nl::Weave::Stats::CountMessageSent(nl::Weave::Profiles::kWeaveProfile_Echo, 1);
+    nl::Weave::Stats::CountMessageReceived(nl::Weave::Profiles::kWeaveProfile_Echo, 1, 30);
+    nl::Weave::Stats::CountMessageReceived(nl::Weave::Profiles::kWeaveProfile_Echo, 2, 40);
+    nl::Weave::Stats::CountMessageReceived(nl::Weave::Profiles::kWeaveProfile_Echo, 2, 50);
+
+    numCounters = nl::Weave::Stats::GetMessageCounters(counters, WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS);
+    NL_TEST_ASSERT(inSuite, numCounters == 2);
+
+    for (size_t i = 0; i < numCounters; i++)
+    {
+        NL_TEST_ASSERT(inSuite, counters[i].mProfileId == nl::Weave::Profiles::kWeaveProfile_Echo);
+
+        if (counters[i].mMsgType == 2)
+        {
+            NL_TEST_ASSERT(inSuite, counters[i].mNumSent == 0);
+            NL_TEST_ASSERT(inSuite, counters[i].mNumReceived == 2);
+            NL_TEST_ASSERT(inSuite, counters[i].mDispatchTimeUsec == 90);
+            found = true;
+        }
+        else
+        {
+            NL_TEST_ASSERT(inSuite, counters[i].mNumSent == 2);
+            NL_TEST_ASSERT(inSuite, counters[i].mNumReceived == 1);
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, found);
+
+    // Further pairs are counted together once the table is full
+    for (uint32_t i = 0; i < WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS; i++)
+    {
+        nl::Weave::Stats::CountMessageSent(0x00001000 + i, 0);
+    }
+
+    numCounters = nl::Weave::Stats::GetMessageCounters(counters, WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS);
+    NL_TEST_ASSERT(inSuite, numCounters == WEAVE_CONFIG_STATS_MAX_MESSAGE_COUNTERS);
+    NL_TEST_ASSERT(inSuite, nl::Weave::Stats::GetCounters()[nl::Weave::Stats::kCounter_MessageCountersOverflow] == 2);
+
+    // Existing pairs are still found
+    nl::Weave::Stats::CountMessageSent(nl::Weave::Profiles::kWeaveProfile_Echo, 2);
+    NL_TEST_ASSERT(inSuite, nl::Weave::Stats::GetCounters()[nl::Weave::Stats::kCounter_MessageCountersOverflow] == 2);
+}
+
+static void CheckEncodeStats(nlTestSuite *inSuite, void *inContext)
+{
+    uint8_t buf[2048];
+    TLVWriter writer;
+    TLVReader reader;
+    TLVType outerType;
+    TLVType arrayType;
+    WEAVE_ERROR err;
+    size_t numHistograms = 0;
+    size_t numMessageCounters = 0;
+
+    nl::Weave::Stats::ResetCounters();
+
+    nl::Weave::System::Stats::GetHistograms()[nl::Weave::System::Stats::kHistogram_MessageEncodeTime].Record(12);
+    nl::Weave::Stats::CountMessageSent(nl::Weave::Profiles::kWeaveProfile_Echo, 1);
+
+    writer.Init(buf, sizeof(buf));
+
+    err = nl::Weave::Stats::EncodeStats(writer, AnonymousTag);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = writer.Finalize();
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    reader.Init(buf, writer.GetLengthWritten());
+
+    err = reader.Next(kTLVType_Structure, AnonymousTag);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    err = reader.EnterContainer(outerType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+    while ((err = reader.Next()) == WEAVE_NO_ERROR)
+    {
+        if (reader.GetTag() == ContextTag(nl::Weave::Stats::kTag_Histograms))
+        {
+            err = reader.EnterContainer(arrayType);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            while (reader.Next() == WEAVE_NO_ERROR)
+            {
+                TLVType structureType;
+                uint32_t count = 0;
+
+                err = reader.EnterContainer(structureType);
+                NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+                err = reader.Next(kTLVType_UnsignedInteger, ContextTag(nl::Weave::Stats::kTag_Histogram_Count));
+                NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+                err = reader.Get(count);
+                NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+                NL_TEST_ASSERT(inSuite, count == ((numHistograms == nl::Weave::System::Stats::kHistogram_MessageEncodeTime) ? 1 : 0));
+
+                err = reader.ExitContainer(structureType);
+                NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+                numHistograms++;
+            }
+
+            err = reader.ExitContainer(arrayType);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        }
+        else if (reader.GetTag() == ContextTag(nl::Weave::Stats::kTag_MessageCounters))
+        {
+            err = reader.EnterContainer(arrayType);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+
+            while (reader.Next() == WEAVE_NO_ERROR)
+            {
+                numMessageCounters++;
+            }
+
+            err = reader.ExitContainer(arrayType);
+            NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+        }
+    }
+
+    NL_TEST_ASSERT(inSuite, err == WEAVE_END_OF_TLV);
+    NL_TEST_ASSERT(inSuite, numHistograms == nl::Weave::System::Stats::kNumHistograms);
+    NL_TEST_ASSERT(inSuite, numMessageCounters == 1);
+
+    err = reader.ExitContainer(outerType);
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Histogram Buckets",              CheckHistogramBuckets),
+    NL_TEST_DEF("Histogram Record",               CheckHistogramRecord),
+    NL_TEST_DEF("Snapshot Difference",            CheckSnapshotDifference),
+    NL_TEST_DEF("Message Counters",               CheckMessageCounters),
+    NL_TEST_DEF("Encode Stats",                   CheckEncodeStats),
+
+    NL_TEST_SENTINEL()
+};
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options...>]\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT,
+    "Unit tests for Weave latency histograms and message counters.\n"
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gHelpOptions,
+    NULL
+};
+
+int main(int argc, char *argv[])
+{
+    nlTestSuite theSuite = {
+        "Weave-Stats",
+        &sTests[0],
+        NULL,
+        NULL
+    };
+
+    if (!ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
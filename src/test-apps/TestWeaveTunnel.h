@@ -72,6 +72,7 @@ enum
     kTestNum_TestTCPUserTimeoutOnAddrRemoval                    = 20,
     kTestNum_TestTunnelLivenessSendAndRecvResponse              = 21,
     kTestNum_TestTunnelLivenessDisconnectOnNoResponse           = 22,
+    kTestNum_TestDrainOfFullSizeTunneledPackets                 = 23,
 };
 
 #endif // WEAVE_CONFIG_ENABLE_TUNNELING
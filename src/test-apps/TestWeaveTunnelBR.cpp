@@ -58,10 +58,11 @@ using namespace ::nl::Weave::Profiles::WeaveTunnel;
 
 static bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *name, const char *arg);
 static bool HandleNonOptionArgs(const char *progName, int argc, char *argv[]);
-static void
+void
 WeaveTunnelOnStatusNotifyHandlerCB(WeaveTunnelConnectionMgr::TunnelConnNotifyReasons reason,
                                    WEAVE_ERROR aErr, void *appCtxt);
 static WEAVE_ERROR SendWeavePingMessage(void);
+static WEAVE_ERROR SendFullSizeWeavePingMessages(void);
 static void WeaveTunnelOnReconnectNotifyCB(TunnelType tunType,
                                            const char *reconnectHost,
                                            const uint16_t reconnectPort,
@@ -91,6 +92,7 @@ bool gTestSucceeded = false;
 uint8_t  gEncryptionType = kWeaveEncryptionType_None;
 uint16_t gKeyId = WeaveKeyId::kNone;
 uint8_t gTunUpCount = 0;
+uint8_t gFullSizePingResponseCount = 0;
 
 #if WEAVE_CONFIG_ENABLE_SERVICE_DIRECTORY
 bool gUseServiceDir = false;
@@ -105,6 +107,11 @@ const char *gDirectoryServerURL = "frontdoor.integration.nestlabs.com";
 
 #define TEST_TUNNEL_LIVENESS_INTERVAL_SECS  (10)
 
+// Number of full-size pings sent back to back for the drain test; twice the
+// coalescing limit so that the pending send cap is hit with unpushed data.
+#define TEST_NUM_FULL_SIZE_PINGS            (2 * WEAVE_CONFIG_TUNNELING_MAX_NUM_COALESCED_PACKETS)
+#define TEST_FULL_SIZE_PING_PAYLOAD_LEN     (1152)
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
 // Used for storing the IP address upon removal to restore it at the end of the
 // test case.
@@ -1813,6 +1820,81 @@ exit:
     gTunAgent.Shutdown();
 }
 
+/**
+ * Test that a burst of full-size data packets is drained completely onto the
+ * tunnel connection even though it exceeds the pending send limit before the
+ * coalescing limit is reached.
+ */
+static void TestDrainOfFullSizeTunneledPackets(nlTestSuite *inSuite, void *inContext)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    Done = false;
+    gTestSucceeded = false;
+    gFullSizePingResponseCount = 0;
+    gMaxTestDurationMillisecs = DEFAULT_TEST_DURATION_MILLISECS;
+    gCurrTestNum = kTestNum_TestDrainOfFullSizeTunneledPackets;
+    gTestStartTime = Now();
+
+#if WEAVE_CONFIG_ENABLE_SERVICE_DIRECTORY
+    if (gUseServiceDir)
+    {
+        err = gTunAgent.Init(&Inet, &ExchangeMgr, gDestNodeId,
+                            gAuthMode, &gServiceMgr);
+    }
+    else
+#endif
+    {
+        err = gTunAgent.Init(&Inet, &ExchangeMgr, gDestNodeId, gDestAddr,
+                            gAuthMode);
+    }
+
+    gTunAgent.OnServiceTunStatusNotify = WeaveTunnelOnStatusNotifyHandlerCB;
+
+    SuccessOrExit(err);
+
+    err = gTunAgent.StartServiceTunnel();
+    SuccessOrExit(err);
+
+    while (!Done)
+    {
+        struct timeval sleepTime;
+        sleepTime.tv_sec = TEST_SLEEP_TIME_WITHIN_LOOP_SECS;
+        sleepTime.tv_usec = TEST_SLEEP_TIME_WITHIN_LOOP_MICROSECS;
+
+        ServiceNetwork(sleepTime);
+
+        if (Now() < gTestStartTime + gMaxTestDurationMillisecs * System::kTimerFactor_micro_per_milli)
+        {
+            if (gTestSucceeded)
+            {
+                Done = true;
+            }
+            else
+            {
+                continue;
+            }
+        }
+        else // Time's up
+        {
+            gTestSucceeded = false;
+            Done = true;
+        }
+
+        if (Done)
+        {
+            gTunAgent.StopServiceTunnel(WEAVE_NO_ERROR);
+        }
+    }
+
+exit:
+    NL_TEST_ASSERT(inSuite, err == WEAVE_NO_ERROR);
+    NL_TEST_ASSERT(inSuite, gTestSucceeded == true);
+    NL_TEST_ASSERT(inSuite, gFullSizePingResponseCount == TEST_NUM_FULL_SIZE_PINGS);
+
+    gTunAgent.Shutdown();
+}
+
 #if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
 /**
  * Test gathering of tunnel statistics after performing a few tunnel operations.
@@ -1907,6 +1989,12 @@ static void TestTunnelStatistics(nlTestSuite *inSuite, void *inContext)
     WeaveLogDetail(WeaveTunnel, "LastTunnelFailoverWeaveError = %u\n", tunnelStats.mLastTunnelFailoverError);
 #endif // WEAVE_CONFIG_TUNNEL_FAILOVER_SUPPORTED
     WeaveLogDetail(WeaveTunnel, "DroppedMessageCount = %u\n", tunnelStats.mDroppedMessagesCount);
+    for (int i = 0; i < kTrafficClass_Max; i++)
+    {
+        WeaveLogDetail(WeaveTunnel, "TrafficClass[%d] Queued = %u, Sent = %u, Dropped = %u, QueuedBytesHighWatermark = %u\n", i,
+                       tunnelStats.mTrafficClassStats[i].mQueuedMessages, tunnelStats.mTrafficClassStats[i].mSentMessages,
+                       tunnelStats.mTrafficClassStats[i].mDroppedMessages, tunnelStats.mTrafficClassStats[i].mQueuedBytesHighWatermark);
+    }
 
     NL_TEST_ASSERT(inSuite, tunnelStats.mPrimaryStats.mTunnelDownCount == 1);
     NL_TEST_ASSERT(inSuite, tunnelStats.mPrimaryStats.mTunnelConnAttemptCount == 1);
@@ -2190,6 +2278,17 @@ void HandleTunnelTestResponse(ExchangeContext *ec, const IPPacketInfo *pktInfo,
 
         break;
 
+      case kTestNum_TestDrainOfFullSizeTunneledPackets:
+        if (profileId == kWeaveProfile_Echo && msgType == kEchoMessageType_EchoResponse)
+        {
+            if (++gFullSizePingResponseCount == TEST_NUM_FULL_SIZE_PINGS)
+            {
+                gTestSucceeded = true;
+            }
+        }
+
+        break;
+
       case  kTestNum_TestTunnelStatistics:
         if (profileId == kWeaveProfile_Echo && msgType == kEchoMessageType_EchoResponse)
         {
@@ -2246,6 +2345,50 @@ exit:
     return err;
 }
 
+WEAVE_ERROR SendFullSizeWeavePingMessages(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    ExchangeContext *exchangeCtxt = NULL;
+    PacketBuffer *msg = NULL;
+
+    // Send the pings back to back so that they reach the tunnel in a single burst.
+    for (int i = 0; i < TEST_NUM_FULL_SIZE_PINGS; i++)
+    {
+        exchangeCtxt = ExchangeMgr.NewContext(gDestNodeId, gRemoteDataAddr, &gTunAgent);
+        VerifyOrExit(exchangeCtxt, err = WEAVE_ERROR_NO_MEMORY);
+
+        msg = PacketBuffer::New();
+        VerifyOrExit(msg, err = WEAVE_ERROR_NO_MEMORY);
+        VerifyOrExit(msg->AvailableDataLength() >= TEST_FULL_SIZE_PING_PAYLOAD_LEN, err = WEAVE_ERROR_BUFFER_TOO_SMALL);
+
+        memset(msg->Start(), i, TEST_FULL_SIZE_PING_PAYLOAD_LEN);
+        msg->SetDataLength(TEST_FULL_SIZE_PING_PAYLOAD_LEN);
+
+        exchangeCtxt->EncryptionType = gEncryptionType;
+        exchangeCtxt->KeyId = gKeyId;
+        exchangeCtxt->OnMessageReceived = HandleTunnelTestResponse;
+
+        err = exchangeCtxt->SendMessage(kWeaveProfile_Echo, kEchoMessageType_EchoRequest, msg, 0);
+        msg = NULL;
+        SuccessOrExit(err);
+
+        exchangeCtxt = NULL;
+    }
+
+exit:
+    if (msg != NULL)
+    {
+        PacketBuffer::Free(msg);
+    }
+
+    if (err != WEAVE_NO_ERROR && exchangeCtxt != NULL)
+    {
+        exchangeCtxt->Close();
+    }
+
+    return err;
+}
+
 void
 WeaveTunnelOnStatusNotifyHandlerCB(WeaveTunnelConnectionMgr::TunnelConnNotifyReasons reason,
                                    WEAVE_ERROR aErr, void *appCtxt)
@@ -2358,6 +2501,19 @@ WeaveTunnelOnStatusNotifyHandlerCB(WeaveTunnelConnectionMgr::TunnelConnNotifyRea
 
         break;
 
+      case kTestNum_TestDrainOfFullSizeTunneledPackets:
+        if (reason == WeaveTunnelConnectionMgr::kStatus_TunPrimaryUp)
+        {
+            err = SendFullSizeWeavePingMessages();
+            SuccessOrExit(err);
+        }
+        else
+        {
+            gTestSucceeded = false;
+        }
+
+        break;
+
 #if WEAVE_SYSTEM_CONFIG_USE_SOCKETS && WEAVE_CONFIG_TUNNEL_TCP_USER_TIMEOUT_SUPPORTED && INET_CONFIG_OVERRIDE_SYSTEM_TCP_USER_TIMEOUT
       case kTestNum_TestTCPUserTimeoutOnAddrRemoval:
         if (reason == WeaveTunnelConnectionMgr::kStatus_TunPrimaryUp)
@@ -2571,6 +2727,7 @@ static const nlTest tunnelTests[] = {
     NL_TEST_DEF("TestWARMRouteDeleteWhenTunnelStopped", TestWARMRouteDeleteWhenTunnelStopped),
     NL_TEST_DEF("TestWeavePingOverTunnel", TestWeavePingOverTunnel),
     NL_TEST_DEF("TestQueueingOfTunneledPackets", TestQueueingOfTunneledPackets),
+    NL_TEST_DEF("TestDrainOfFullSizeTunneledPackets", TestDrainOfFullSizeTunneledPackets),
 #if WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
     NL_TEST_DEF("TestTunnelStatistics", TestTunnelStatistics),
 #endif // WEAVE_CONFIG_TUNNEL_ENABLE_STATISTICS
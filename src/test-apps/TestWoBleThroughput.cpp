@@ -0,0 +1,328 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file benchmarks the throughput of Weave over BLE (WoBLE)
+ *      across a range of negotiated ATT MTUs and receive windows, by
+ *      transferring messages between two BleLayer objects connected in
+ *      loopback through MockBlePlatformDelegate.
+ *
+ *      Time is simulated in BLE connection events, in each of which
+ *      either side of the link may complete one GATT operation.
+ *
+ */
+
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+
+#include <stdint.h>
+#include <string.h>
+
+#include "ToolCommon.h"
+#include <nltest.h>
+
+#include <BleLayer/BleApplicationDelegate.h>
+#include <BleLayer/BleLayer.h>
+#include <BleLayer/BLEEndPoint.h>
+#include "MockBlePlatformDelegate.h"
+
+using namespace nl::Ble;
+using nl::Weave::System::PacketBuffer;
+
+#define TOOL_NAME "TestWoBleThroughput"
+
+#define MESSAGE_LENGTH                      1024
+#define NUM_MESSAGES                        8
+#define MAX_CONNECTION_EVENTS               10000
+#define CONNECTION_INTERVAL_MSECS           30
+
+struct LinkConfig
+{
+    const char *mName;
+    uint16_t mMTU;
+    uint8_t mReceiveWindowSize;
+};
+
+struct LinkResult
+{
+    bool mIsComplete;
+    uint32_t mConnectionEvents;
+    uint32_t mWrites;
+    uint32_t mStandAloneAcks;
+};
+
+enum
+{
+    kLink_MinimumMTU = 0,
+    kLink_MTU131,
+    kLink_MTU247,
+    kLink_MTU247Window8,
+    kLink_MTU512,
+    kLink_MTU512Window16,
+
+    kNumLinks
+};
+
+static const LinkConfig sLinkConfigs[kNumLinks] = {
+    { "MTU 23, window 3",       23,     3   },
+    { "MTU 131, window 3",      131,    3   },
+    { "MTU 247, window 3",      247,    3   },
+    { "MTU 247, window 8",      247,    8   },
+    { "MTU 512, window 3",      512,    3   },
+    { "MTU 512, window 16",     512,    16  },
+};
+
+static LinkResult sLinkResults[kNumLinks];
+
+class LoopbackApplicationDelegate :
+    public BleApplicationDelegate
+{
+    void NotifyWeaveConnectionClosed(BLE_CONNECTION_OBJECT connObj) { }
+};
+
+static BleLayer sCentralLayer;
+static BleLayer sPeripheralLayer;
+static MockBlePlatformDelegate sCentralDelegate;
+static MockBlePlatformDelegate sPeripheralDelegate;
+static LoopbackApplicationDelegate sApplicationDelegate;
+
+static uint32_t sConnectionEvent;
+static uint32_t sConnectEvent;
+static bool sIsConnected;
+static bool sIsDataIntact;
+static uint32_t sNumMessagesReceived;
+
+static uint8_t MessageByte(uint32_t msgIndex, uint32_t offset)
+{
+    return static_cast<uint8_t>(msgIndex * 31 + offset * 7);
+}
+
+static void HandleMessageReceived(BLEEndPoint *endPoint, PacketBuffer *msg)
+{
+    const uint8_t *p = msg->Start();
+
+    if (msg->DataLength() != MESSAGE_LENGTH)
+        sIsDataIntact = false;
+
+    for (uint32_t i = 0; sIsDataIntact && i < MESSAGE_LENGTH; i++)
+    {
+        if (p[i] != MessageByte(sNumMessagesReceived, i))
+            sIsDataIntact = false;
+    }
+
+    sNumMessagesReceived++;
+
+    PacketBuffer::Free(msg);
+}
+
+static void HandlePeripheralConnectReceived(BLEEndPoint *endPoint)
+{
+    endPoint->OnMessageReceived = HandleMessageReceived;
+}
+
+static void HandleCentralConnectComplete(BLEEndPoint *endPoint, BLE_ERROR err)
+{
+    VerifyOrExit(err == BLE_NO_ERROR, );
+
+    sIsConnected = true;
+    sConnectEvent = sConnectionEvent;
+
+    // Count only the GATT operations that carry the transfer.
+    sCentralDelegate.ResetStats();
+    sPeripheralDelegate.ResetStats();
+
+    for (uint32_t msgIndex = 0; msgIndex < NUM_MESSAGES; msgIndex++)
+    {
+        PacketBuffer *msg = PacketBuffer::New();
+
+        VerifyOrExit(msg != NULL, sIsDataIntact = false);
+
+        for (uint32_t i = 0; i < MESSAGE_LENGTH; i++)
+            msg->Start()[i] = MessageByte(msgIndex, i);
+        msg->SetDataLength(MESSAGE_LENGTH);
+
+        err = endPoint->Send(msg);
+        VerifyOrExit(err == BLE_NO_ERROR, sIsDataIntact = false);
+    }
+
+exit:
+    return;
+}
+
+/**
+ *  Connect a central and a peripheral over a loopback link with the given configuration and
+ *  transfer NUM_MESSAGES messages from the central to the peripheral, the direction in which
+ *  provisioning data flows during device pairing.
+ */
+static void RunTransfer(const LinkConfig &config, LinkResult &result)
+{
+    BLEEndPoint *endPoint = NULL;
+    BLE_ERROR err;
+
+    memset(&result, 0, sizeof(result));
+    sConnectionEvent = 0;
+    sConnectEvent = 0;
+    sIsConnected = false;
+    sIsDataIntact = true;
+    sNumMessagesReceived = 0;
+
+    err = sCentralLayer.Init(&sCentralDelegate, &sApplicationDelegate, &SystemLayer);
+    SuccessOrExit(err);
+
+    err = sPeripheralLayer.Init(&sPeripheralDelegate, &sApplicationDelegate, &SystemLayer);
+    SuccessOrExit(err);
+
+    sPeripheralLayer.OnWeaveBleConnectReceived = HandlePeripheralConnectReceived;
+
+    sCentralDelegate.Connect(&sCentralLayer, &sPeripheralDelegate, config.mMTU, config.mReceiveWindowSize);
+    sPeripheralDelegate.Connect(&sPeripheralLayer, &sCentralDelegate, config.mMTU, config.mReceiveWindowSize);
+
+    err = sCentralLayer.NewBleEndPoint(&endPoint, sCentralDelegate.GetConnectionObject(), kBleRole_Central, true);
+    SuccessOrExit(err);
+
+    endPoint->OnConnectComplete = HandleCentralConnectComplete;
+
+    err = endPoint->StartConnect();
+    SuccessOrExit(err);
+
+    while (sNumMessagesReceived < NUM_MESSAGES && sConnectionEvent < MAX_CONNECTION_EVENTS)
+    {
+        sConnectionEvent++;
+
+        // With no GATT operation pending, the transfer has stalled.
+        if (MockBlePlatformDelegate::RunConnectionEvent(sCentralDelegate, sPeripheralDelegate) == 0)
+            break;
+    }
+
+    result.mIsComplete = (sIsConnected && sIsDataIntact && sNumMessagesReceived == NUM_MESSAGES);
+    result.mConnectionEvents = sConnectionEvent - sConnectEvent;
+    result.mWrites = sCentralDelegate.GetStats().mWrites;
+    result.mStandAloneAcks = sPeripheralDelegate.GetStats().mStandAloneAcks;
+
+exit:
+    sCentralLayer.Shutdown();
+    sPeripheralLayer.Shutdown();
+
+    sCentralDelegate.Disconnect();
+    sPeripheralDelegate.Disconnect();
+}
+
+static void CheckThroughput(nlTestSuite *inSuite, void *inContext)
+{
+    printf("\n%-22s %8s %8s %8s %12s\n", "Link", "Events", "Writes", "Acks", "Bytes/sec");
+
+    for (size_t i = 0; i < kNumLinks; i++)
+    {
+        LinkResult &result = sLinkResults[i];
+
+        RunTransfer(sLinkConfigs[i], result);
+
+        NL_TEST_ASSERT(inSuite, result.mIsComplete);
+        NL_TEST_ASSERT(inSuite, result.mConnectionEvents > 0);
+
+        if (result.mConnectionEvents > 0)
+        {
+            printf("%-22s %8u %8u %8u %12u\n", sLinkConfigs[i].mName, result.mConnectionEvents, result.mWrites,
+                   result.mStandAloneAcks,
+                   (NUM_MESSAGES * MESSAGE_LENGTH * 1000) / (result.mConnectionEvents * CONNECTION_INTERVAL_MSECS));
+        }
+    }
+
+    printf("(BLE_CONFIG_MAX_FRAGMENT_SIZE %u, BLE_MAX_RECEIVE_WINDOW_SIZE %u, %u ms connection interval)\n",
+           BLE_CONFIG_MAX_FRAGMENT_SIZE, BLE_MAX_RECEIVE_WINDOW_SIZE, CONNECTION_INTERVAL_MSECS);
+}
+
+static void CheckNegotiatedMTU(nlTestSuite *inSuite, void *inContext)
+{
+    // Fragments sized to a larger ATT MTU cut the GATT operations needed for the same transfer.
+    NL_TEST_ASSERT(inSuite, sLinkResults[kLink_MTU131].mWrites < sLinkResults[kLink_MinimumMTU].mWrites);
+    NL_TEST_ASSERT(inSuite, sLinkResults[kLink_MTU131].mConnectionEvents < sLinkResults[kLink_MinimumMTU].mConnectionEvents);
+
+#if BLE_CONFIG_MAX_FRAGMENT_SIZE >= 244
+    NL_TEST_ASSERT(inSuite, sLinkResults[kLink_MTU247].mConnectionEvents < sLinkResults[kLink_MTU131].mConnectionEvents);
+#endif
+#if BLE_CONFIG_MAX_FRAGMENT_SIZE >= 509
+    NL_TEST_ASSERT(inSuite, sLinkResults[kLink_MTU512].mConnectionEvents < sLinkResults[kLink_MTU247].mConnectionEvents);
+#endif
+}
+
+static void CheckAckBatching(nlTestSuite *inSuite, void *inContext)
+{
+    // A larger receive window is acknowledged cumulatively, with fewer stand-alone acks, and never at the cost of
+    // connection events.
+    NL_TEST_ASSERT(inSuite, sLinkResults[kLink_MTU247Window8].mConnectionEvents <= sLinkResults[kLink_MTU247].mConnectionEvents);
+    NL_TEST_ASSERT(inSuite, sLinkResults[kLink_MTU512Window16].mConnectionEvents <= sLinkResults[kLink_MTU512].mConnectionEvents);
+
+#if BLE_MAX_RECEIVE_WINDOW_SIZE >= 8
+    NL_TEST_ASSERT(inSuite, sLinkResults[kLink_MTU247Window8].mStandAloneAcks < sLinkResults[kLink_MTU247].mStandAloneAcks);
+#endif
+#if BLE_MAX_RECEIVE_WINDOW_SIZE >= 16
+    NL_TEST_ASSERT(inSuite, sLinkResults[kLink_MTU512Window16].mStandAloneAcks < sLinkResults[kLink_MTU512].mStandAloneAcks);
+#endif
+}
+
+/**
+ *   Test Suite. It lists all the test functions.
+ */
+static const nlTest sTests[] = {
+    NL_TEST_DEF("Throughput",                     CheckThroughput),
+    NL_TEST_DEF("Negotiated MTU",                 CheckNegotiatedMTU),
+    NL_TEST_DEF("Ack Batching",                   CheckAckBatching),
+
+    NL_TEST_SENTINEL()
+};
+
+/**
+ *  Set up the test suite.
+ */
+static int TestSetup(void *inContext)
+{
+    InitSystemLayer();
+
+    return (SUCCESS);
+}
+
+/**
+ *  Tear down the test suite.
+ */
+static int TestTeardown(void *inContext)
+{
+    ShutdownSystemLayer();
+
+    return (SUCCESS);
+}
+
+int main(void)
+{
+    nlTestSuite theSuite = {
+        "WoBLE-Throughput",
+        &sTests[0],
+        TestSetup,
+        TestTeardown
+    };
+
+    // Generate machine-readable, comma-separated value (CSV) output.
+    nl_test_set_output_style(OUTPUT_CSV);
+
+    // Run test suit againt one context.
+    nlTestRunner(&theSuite, NULL);
+
+    return nlTestRunnerStats(&theSuite);
+}
@@ -1394,6 +1394,22 @@ void PrintStatsCounters(nl::Weave::System::Stats::count_t *counters, const char
     }
 }
 
+void PrintStatsHistograms(const nl::Weave::System::Stats::Histogram *histograms, const char *aPrefix)
+{
+    size_t i;
+    const char **strings = nl::Weave::System::Stats::GetHistogramStrings();
+    const char *prefix = aPrefix ? aPrefix : "";
+
+    for (i = 0; i < nl::Weave::System::Stats::kNumHistograms; i++)
+    {
+        const nl::Weave::System::Stats::Histogram &histogram = histograms[i];
+
+        printf("%s%s:\t\tcount %" PRIu32 " min %" PRIu32 " p50 %" PRIu32 " p99 %" PRIu32 " max %" PRIu32 " usec\n",
+               prefix, strings[i], histogram.mCount, (histogram.mCount ? histogram.mMin : 0),
+               histogram.GetPercentile(50), histogram.GetPercentile(99), histogram.mMax);
+    }
+}
+
 bool ProcessStats(nl::Weave::System::Stats::Snapshot &aBefore, nl::Weave::System::Stats::Snapshot &aAfter, bool aPrint, const char *aPrefix)
 {
     bool leak = false;
@@ -1462,6 +1478,9 @@ bool ProcessStats(nl::Weave::System::Stats::Snapshot &aBefore, nl::Weave::System
         {
             printf("\nHigh watermarks:\n");
             PrintStatsCounters(aAfter.mHighWatermarks, prefix);
+
+            printf("\nLatency histograms:\n");
+            PrintStatsHistograms(aAfter.mHistograms, prefix);
         }
     }
 
@@ -1668,3 +1687,27 @@ void ServiceNetworkUntil(const bool *aDone, const uint32_t *aIntervalMs)
         elapsedMs = NowMs() - startTimeMs;
     }
 }
+
+/**
+ * Process network events until a given count reaches the expected
+ * value or a given amount of time has elapsed.
+ *
+ * @param[in] aCount        the count, typically updated by event callbacks.
+ *
+ * @param[in] aExpected     the value at which to stop.
+ *
+ * @param[in] aLimitMs      the number of milliseconds after which to give up.
+ */
+void ServiceNetworkUntilCount(const uint32_t &aCount, uint32_t aExpected, uint32_t aLimitMs)
+{
+    const uint64_t deadline = NowMs() + aLimitMs;
+    struct timeval sleepTime;
+
+    sleepTime.tv_sec = 0;
+    sleepTime.tv_usec = 1000;
+
+    while (aCount < aExpected && NowMs() < deadline)
+    {
+        ServiceNetwork(sleepTime);
+    }
+}
@@ -169,8 +169,10 @@ inline static void ServiceNetwork(struct ::timeval aSleepTime)
 }
 
 extern void ServiceNetworkUntil(const bool *aDone, const uint32_t *aIntervalMs = NULL);
+extern void ServiceNetworkUntilCount(const uint32_t &aCount, uint32_t aExpected, uint32_t aLimitMs);
 
 extern void PrintStatsCounters(nl::Weave::System::Stats::count_t *counters, const char *aPrefix);
+extern void PrintStatsHistograms(const nl::Weave::System::Stats::Histogram *histograms, const char *aPrefix);
 extern bool ProcessStats(nl::Weave::System::Stats::Snapshot &aBefore, nl::Weave::System::Stats::Snapshot &aAfter, bool aPrint, const char *aPrefix);
 extern void PrintFaultInjectionCounters(void);
 extern void SetupFaultInjectionContext(int argc, char *argv[]);
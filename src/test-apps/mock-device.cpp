@@ -248,6 +248,7 @@ enum
     kToolOpt_EnableDictionaryTest,
     kToolOpt_WdmEnableRetry,
     kToolOpt_SuppressAccessControl,
+    kToolOpt_TimeSyncConcurrent,
 
 // only for weave over bluez peripheral
 #if CONFIG_BLE_PLATFORM_BLUEZ
@@ -291,6 +292,7 @@ static OptionDef gToolOptionDefs[] =
     { "time-sync-mode-service",     kNoArgument,        kToolOpt_TimeSyncModeService },
     { "time-sync-mode-service-over-tunnel",     kNoArgument,        kToolOpt_TimeSyncModeServiceOverTunnel },
     { "time-sync-mode-auto",        kNoArgument,        kToolOpt_TimeSyncModeAuto },
+    { "time-sync-concurrent",       kNoArgument,        kToolOpt_TimeSyncConcurrent },
 
     { "ts-simple-client",           kNoArgument,        kToolOpt_TimeSyncSimpleClient },
     { "ts-server-node-id",          kArgumentRequired,  kToolOpt_TimeSyncServerNodeId },
@@ -378,6 +380,9 @@ static const char *const gToolOptionHelp =
     "  --time-sync-mode-auto\n"
     "       specify that the Time Client Sync mode is Auto (time sync with via Multicast)\n"
     "\n"
+    "  --time-sync-concurrent\n"
+    "       specify that the Time Sync Client sends its requests to all local nodes at once\n"
+    "\n"
     "  --ts-simple-client\n"
     "       Initiate the single source time sync client\n"
     "\n"
@@ -1003,6 +1008,9 @@ bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *n
     case kToolOpt_TimeSyncModeAuto:
         MockTimeNode.SetMode(kOperatingMode_Auto);
         break;
+    case kToolOpt_TimeSyncConcurrent:
+        MockTimeNode.SetConcurrentSync(true);
+        break;
     case kToolOpt_TimeSyncSimpleClient:
         ShouldEnableSimpleTimeSyncClient = true;
         break;
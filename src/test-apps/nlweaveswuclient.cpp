@@ -25,8 +25,11 @@
  *
  */
 
+#include <errno.h>
+
 #include "ToolCommon.h"
 #include "nlweaveswuclient.h"
+#include <Weave/Support/crypto/HashAlgos.h>
 
 namespace nl {
 namespace Weave {
@@ -38,6 +41,37 @@ SoftwareUpdateClient::SoftwareUpdateClient()
 {
     FabricState = NULL;
     ExchangeMgr = NULL;
+    InstalledImagePath = NULL;
+}
+
+static WEAVE_ERROR ComputeInstalledImageHash(const char *imagePath, IntegritySpec &integritySpec)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    nl::Weave::Platform::Security::SHA256 sha256;
+    uint8_t digest[nl::Weave::Platform::Security::SHA256::kHashLength];
+    uint8_t block[512];
+    size_t bytesRead;
+    FILE *file;
+
+    file = fopen(imagePath, "r");
+    if (file == NULL)
+    {
+        printf("Unable to open %s: %s\n", imagePath, strerror(errno));
+        ExitNow(err = WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+
+    sha256.Begin();
+    while ((bytesRead = fread(block, 1, sizeof(block), file)) > 0)
+        sha256.AddData(block, (uint16_t) bytesRead);
+    sha256.Finish(digest);
+
+    err = integritySpec.init(kIntegrityType_SHA256, digest);
+
+exit:
+    if (file != NULL)
+        fclose(file);
+
+    return err;
 }
 
 SoftwareUpdateClient::~SoftwareUpdateClient()
@@ -137,11 +171,23 @@ WEAVE_ERROR SoftwareUpdateClient::SendImageQueryRequest()
 
     UpdateSchemeList aSchemeList;
     uint8_t updateSchemeList[] = { kUpdateScheme_BDX };
-    aSchemeList.init(sizeof(updateSchemeList), updateSchemeList);
+    uint8_t deltaUpdateSchemeList[] = { kUpdateScheme_BDXDelta, kUpdateScheme_BDX };
+    IntegritySpec installedImageHash;
+    bool offerDelta = false;
+
+    // Prefer a delta image when we know which image is installed.
+    if (InstalledImagePath != NULL)
+        offerDelta = (ComputeInstalledImageHash(InstalledImagePath, installedImageHash) == WEAVE_NO_ERROR);
+
+    if (offerDelta)
+        aSchemeList.init(sizeof(deltaUpdateSchemeList), deltaUpdateSchemeList);
+    else
+        aSchemeList.init(sizeof(updateSchemeList), updateSchemeList);
 
     ImageQuery imageQuery;
     imageQuery.init(aProductSpec, aVersion, aTypeList, aSchemeList,
-                    NULL /*package*/, NULL /*locale*/, 0 /*target node id*/, NULL /*metadata*/);
+                    NULL /*package*/, NULL /*locale*/, 0 /*target node id*/, NULL /*metadata*/,
+                    offerDelta ? &installedImageHash : NULL);
     PacketBuffer* imageQueryPayload = PacketBuffer::New();
     imageQuery.pack(imageQueryPayload);
 
@@ -212,6 +258,12 @@ void SoftwareUpdateClient::HandleImageQueryResponse(ExchangeContext *ec, const I
     printf("updatePriority: %d\n", imageQueryResponse.updatePriority);
     printf("updateCondition: %d\n", imageQueryResponse.updateCondition);
     printf("reportStatus: %d\n", imageQueryResponse.reportStatus);
+    if (imageQueryResponse.updateScheme == kUpdateScheme_BDXDelta)
+    {
+        printf("patchSpec.format: %d\n", imageQueryResponse.patchSpec.format);
+        printf("patchSpec.baseIntegritySpec.type: %d\n", imageQueryResponse.patchSpec.baseIntegritySpec.type);
+        printf("patchSpec.patchSize: %u\n", imageQueryResponse.patchSpec.patchSize);
+    }
     printf("====\n");
 
     // Free the payload buffer.
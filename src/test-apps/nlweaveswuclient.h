@@ -56,6 +56,7 @@ public:
 	const WeaveFabricState *FabricState;	// [READ ONLY] Fabric state object
 	uint8_t EncryptionType;                         // Encryption type to use during SWU
 	uint16_t KeyId;                                 // Encryption key to use during SWU
+	const char *InstalledImagePath;                 // If set, request delta images against this installed image
 
 	WEAVE_ERROR Init(WeaveExchangeManager *exchangeMgr);
 	WEAVE_ERROR Shutdown();
@@ -35,9 +35,12 @@
 
 #define WEAVE_CONFIG_BDX_NAMESPACE kWeaveManagedNamespace_Development
 
+#include <ctype.h>
+#include <errno.h>
 #include <inttypes.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 #include <Weave/Core/WeaveSecurityMgr.h>
 #include <Weave/Profiles/security/WeaveSecurity.h>
@@ -91,6 +94,16 @@ const char *RequestedFileName = NULL;
 const char *ReceivedFileLocation = NULL;
 bool ClientConEstablished = false;
 bool Pretest = false;
+bool UseAsync = false;
+uint64_t TransferStartTime = 0;
+const char *DeltaBaseImagePath = NULL;
+const char *DeltaBaseHashStr = NULL;
+const char *DeltaTargetHashStr = NULL;
+nl::Weave::Profiles::SoftwareUpdate::DeltaImageApplier DeltaApplier;
+BdxDeltaImageFiles DeltaImageFiles;
+nl::Weave::Profiles::SoftwareUpdate::PatchSpec DeltaPatchSpec;
+nl::Weave::Profiles::SoftwareUpdate::IntegritySpec DeltaTargetIntegritySpec;
+bool DeltaImageFailed = false;
 
 //Globals used by BDX-client
 bool WaitingForBDXResp = false;
@@ -100,6 +113,13 @@ WeaveConnection *Con = NULL;
 nl::Weave::Binding *TheBinding = NULL;
 
 
+enum
+{
+    kToolOpt_DeltaBase = 1000,
+    kToolOpt_DeltaBaseHash,
+    kToolOpt_DeltaTargetHash,
+};
+
 static OptionDef gToolOptionDefs[] =
 {
     { "requested-file", kArgumentRequired, 'r' },
@@ -113,6 +133,10 @@ static OptionDef gToolOptionDefs[] =
     { "tcp",            kNoArgument,       't' },
     { "udp",            kNoArgument,       'u' },
     { "pretest",        kNoArgument,       'T' },
+    { "async",          kNoArgument,       'A' },
+    { "delta-base",     kArgumentRequired, kToolOpt_DeltaBase },
+    { "delta-base-hash", kArgumentRequired, kToolOpt_DeltaBaseHash },
+    { "delta-target-hash", kArgumentRequired, kToolOpt_DeltaTargetHash },
     { NULL }
 };
 
@@ -150,6 +174,22 @@ static const char *gToolOptionHelp =
     "  -T, --pretest\n"
     "       Perform initial unit tests.\n"
     "\n"
+    "  -A, --async\n"
+    "       Offer the asynchronous (windowed) transfer mode, and report the\n"
+    "       throughput of each transfer.\n"
+    "\n"
+    "  --delta-base <path>\n"
+    "       Treat the downloaded file as a delta image patch against the installed\n"
+    "       image at <path>, and apply each block as it arrives. The reconstructed\n"
+    "       image is saved in place of the patch. Requires --delta-base-hash and\n"
+    "       --delta-target-hash.\n"
+    "\n"
+    "  --delta-base-hash <hex>\n"
+    "       SHA-256 digest the installed image must have for the patch to apply.\n"
+    "\n"
+    "  --delta-target-hash <hex>\n"
+    "       SHA-256 digest of the image the patch reconstructs.\n"
+    "\n"
     "  -d, --debug\n"
     "       Enable debug messages.\n"
     "\n";
@@ -184,6 +224,45 @@ static void ResetTestContext(void)
     appState->mDone = false;
 }
 
+static bool ParseSHA256Digest(const char *hexStr, nl::Weave::Profiles::SoftwareUpdate::IntegritySpec &integritySpec)
+{
+    uint8_t digest[nl::Weave::Profiles::SoftwareUpdate::kLength_SHA256];
+    unsigned int byte;
+
+    if (strlen(hexStr) != 2 * sizeof(digest))
+        return false;
+
+    for (size_t i = 0; i < sizeof(digest); i++)
+    {
+        if (!isxdigit(hexStr[2 * i]) || !isxdigit(hexStr[2 * i + 1]) || sscanf(hexStr + 2 * i, "%2x", &byte) != 1)
+            return false;
+        digest[i] = (uint8_t) byte;
+    }
+
+    return integritySpec.init(nl::Weave::Profiles::SoftwareUpdate::kIntegrityType_SHA256, digest) == WEAVE_NO_ERROR;
+}
+
+static WEAVE_ERROR PrepareDeltaImage(void)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+
+    appState->mDeltaApplier = NULL;
+    appState->mDeltaError = WEAVE_NO_ERROR;
+
+    if (DeltaBaseImagePath == NULL)
+        ExitNow();
+
+    // Restart from the top of the patch on every iteration.
+    err = DeltaApplier.Init(&DeltaImageFiles, DeltaPatchSpec, DeltaTargetIntegritySpec);
+    SuccessOrExit(err);
+
+    DeltaImageFiles.mAppState = appState;
+    appState->mDeltaApplier = &DeltaApplier;
+
+exit:
+    return err;
+}
+
 static bool sTransferTimerIsRunning = false;
 
 static int32_t GetNumAsyncEventsAvailable(void)
@@ -212,6 +291,7 @@ int main(int argc, char *argv[])
     nl::Weave::System::Stats::Snapshot after;
     const bool printStats = true;
     uint32_t iter;
+    uint64_t elapsedMs;
 
     InitToolCommon();
 
@@ -237,6 +317,34 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
+    if (DeltaBaseImagePath != NULL)
+    {
+        nl::Weave::Profiles::SoftwareUpdate::IntegritySpec baseIntegritySpec;
+
+        if (Upload)
+        {
+            printf("--delta-base only applies to downloads\n");
+            exit(EXIT_FAILURE);
+        }
+
+        if (DeltaBaseHashStr == NULL || !ParseSHA256Digest(DeltaBaseHashStr, baseIntegritySpec) ||
+            DeltaTargetHashStr == NULL || !ParseSHA256Digest(DeltaTargetHashStr, DeltaTargetIntegritySpec))
+        {
+            printf("--delta-base requires SHA-256 digests in --delta-base-hash and --delta-target-hash\n");
+            exit(EXIT_FAILURE);
+        }
+
+        // The patch size is not known to this tool, so it is not checked.
+        DeltaPatchSpec.init(nl::Weave::Profiles::SoftwareUpdate::kPatchFormat_WeaveDelta, baseIntegritySpec, 0);
+
+        DeltaImageFiles.mBaseFile = fopen(DeltaBaseImagePath, "r");
+        if (DeltaImageFiles.mBaseFile == NULL)
+        {
+            printf("Unable to open %s: %s\n", DeltaBaseImagePath, strerror(errno));
+            exit(EXIT_FAILURE);
+        }
+    }
+
     if (gNetworkOptions.LocalIPv6Addr != IPAddress::Any)
     {
         if (!gNetworkOptions.LocalIPv6Addr.IsIPv6ULA())
@@ -302,6 +410,16 @@ int main(int argc, char *argv[])
     {
         printf("Iteration %u\n", iter);
 
+        appState->mBytesTransferred = 0;
+        TransferStartTime = NowMs();
+
+        err = PrepareDeltaImage();
+        if (err != WEAVE_NO_ERROR)
+        {
+            printf("DeltaImageApplier::Init failed: %s\n", ErrorStr(err));
+            exit(EXIT_FAILURE);
+        }
+
         // Init the client again in case the previous iteration failed with a timeout
         (void)BDXClient.Init(&ExchangeMgr);
 
@@ -332,12 +450,37 @@ int main(int argc, char *argv[])
             ServiceNetwork(sleepTime);
         }
 
+        elapsedMs = NowMs() - TransferStartTime;
+        printf("Transferred %" PRIu64 " bytes in %" PRIu64 " ms (%" PRIu64 " bytes/s, %s mode)\n",
+               appState->mBytesTransferred, elapsedMs,
+               (elapsedMs != 0) ? (appState->mBytesTransferred * 1000) / elapsedMs : 0,
+               UseAsync ? "async" : "synchronous");
+
+        if (appState->mDeltaApplier != NULL)
+        {
+            if (appState->mDeltaError == WEAVE_NO_ERROR && appState->mDeltaApplier->IsComplete())
+            {
+                printf("Delta image applied: %" PRIu32 " bytes\n", appState->mDeltaApplier->GetTargetBytesWritten());
+            }
+            else
+            {
+                printf("Delta image NOT applied: %s\n",
+                       ErrorStr(appState->mDeltaError != WEAVE_NO_ERROR ? appState->mDeltaError : WEAVE_ERROR_INCORRECT_STATE));
+                DeltaImageFailed = true;
+            }
+
+            appState->mDeltaApplier = NULL;
+        }
+
         if (appState->mFile)
         {
             fclose(appState->mFile);
             appState->mFile = NULL;
         }
 
+        UnmapFile(appState->mMappedFile);
+        appState->mMappedFile = NULL;
+
         if (Con)
         {
             Con->Close();
@@ -358,12 +501,18 @@ int main(int argc, char *argv[])
 
     BDXClient.Shutdown();
 
+    if (DeltaImageFiles.mBaseFile != NULL)
+    {
+        fclose(DeltaImageFiles.mBaseFile);
+        DeltaImageFiles.mBaseFile = NULL;
+    }
+
     ProcessStats(before, after, printStats, NULL);
     PrintFaultInjectionCounters();
 
     ShutdownWeaveStack();
 
-    return EXIT_SUCCESS;
+    return DeltaImageFailed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
 static void HandleTransferTimeout(System::Layer* aSystemLayer, void* aAppState, System::Error aError)
@@ -478,7 +627,8 @@ void StartUDPUpload()
             xfer->mFileDesignator = refFileName;
         }
 
-        err = BDXClient.InitBdxSend(*xfer, true, false, false, NULL);
+        TransferStartTime = NowMs();
+        err = BDXClient.InitBdxSend(*xfer, true, false, UseAsync, NULL);
 
         // Set it back to what it was before so we can grab it when we're sending
         xfer->mFileDesignator = refRequestedFileName;
@@ -532,7 +682,8 @@ void StartUDPDownload()
     xfer->mStartOffset = StartOffset;
     xfer->mLength = FileLength;
 
-    err = BDXClient.InitBdxReceive(*xfer, true, false, false, NULL);
+    TransferStartTime = NowMs();
+    err = BDXClient.InitBdxReceive(*xfer, true, false, UseAsync, NULL);
 
     if (err == WEAVE_NO_ERROR)
     {
@@ -587,6 +738,9 @@ bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *n
     case 'T':
         Pretest = true;
         break;
+    case 'A':
+        UseAsync = true;
+        break;
     case 't':
         UseTCP = true;
         break;
@@ -596,6 +750,15 @@ bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *n
     case 'D':
         DestIPAddrStr = arg;
         break;
+    case kToolOpt_DeltaBase:
+        DeltaBaseImagePath = arg;
+        break;
+    case kToolOpt_DeltaBaseHash:
+        DeltaBaseHashStr = arg;
+        break;
+    case kToolOpt_DeltaTargetHash:
+        DeltaTargetHashStr = arg;
+        break;
     default:
         PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", progName, name);
         return false;
@@ -734,7 +897,8 @@ void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
                     xfer->mFileDesignator = refFileName;
                 }
 
-                err = BDXClient.InitBdxSend(*xfer, true, false, false, NULL);
+                TransferStartTime = NowMs();
+                err = BDXClient.InitBdxSend(*xfer, true, false, UseAsync, NULL);
 
                 // Set it back to what it was before so we can grab it when we're sending
                 xfer->mFileDesignator = refRequestedFileName;
@@ -761,7 +925,8 @@ void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
 
             if (err == WEAVE_NO_ERROR)
             {
-                err = BDXClient.InitBdxReceive(*xfer, true, false, false, NULL);
+                TransferStartTime = NowMs();
+                err = BDXClient.InitBdxReceive(*xfer, true, false, UseAsync, NULL);
             }
 #endif // WEAVE_CONFIG_BDX_CLIENT_RECEIVE_SUPPORT
         }
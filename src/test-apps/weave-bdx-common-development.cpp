@@ -31,6 +31,8 @@
 #include <fcntl.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 // This code uses DEVELOPMENT BDX namespace
 
@@ -65,6 +67,8 @@ namespace Profiles {
 namespace WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesignation_Development) {
 
 static BdxAppState mAppStatePool[WEAVE_CONFIG_BDX_MAX_NUM_TRANSFERS];
+// At most one mapping per concurrent transfer, fewer when transfers share a file
+static BdxMappedFile mMappedFilePool[WEAVE_CONFIG_BDX_MAX_NUM_TRANSFERS];
 
 // curled files go here
 char TempFileLocation[FILENAME_MAX] = "/tmp/";
@@ -77,11 +81,16 @@ BdxAppState *NewAppState()
     for (int i = 0; i < WEAVE_CONFIG_BDX_MAX_NUM_TRANSFERS; i++)
     {
         appState = &mAppStatePool[i];
-        if (appState->mFile != NULL || !appState->mDone || appState->mBuffer != NULL)
+        if (appState->mFile != NULL || !appState->mDone || appState->mBuffer != NULL || appState->mMappedFile != NULL)
         {
             continue;
         }
 
+        appState->mBytesTransferred = 0;
+        appState->mMappedFile = NULL;
+        appState->mMappedOffset = 0;
+        appState->mDeltaApplier = NULL;
+        appState->mDeltaError = WEAVE_NO_ERROR;
         return appState;
     }
 
@@ -96,9 +105,131 @@ void ResetAppStates()
         mAppStatePool[i].mFile = NULL;
         mAppStatePool[i].mDone = true;
         mAppStatePool[i].mBuffer = NULL;
+        mAppStatePool[i].mBytesTransferred = 0;
+        mAppStatePool[i].mMappedFile = NULL;
+        mAppStatePool[i].mMappedOffset = 0;
+        mAppStatePool[i].mDeltaApplier = NULL;
+        mAppStatePool[i].mDeltaError = WEAVE_NO_ERROR;
     }
 }
 
+BdxMappedFile *MapFile(FILE *aFile)
+{
+    BdxMappedFile *mappedFile = NULL;
+    BdxMappedFile *freeEntry = NULL;
+    struct stat fileStat;
+    void *data;
+
+    if (fstat(fileno(aFile), &fileStat) != 0 || !S_ISREG(fileStat.st_mode) || fileStat.st_size <= 0)
+    {
+        return NULL;
+    }
+
+    for (int i = 0; i < WEAVE_CONFIG_BDX_MAX_NUM_TRANSFERS; i++)
+    {
+        mappedFile = &mMappedFilePool[i];
+        if (mappedFile->mRefCount == 0)
+        {
+            if (freeEntry == NULL)
+            {
+                freeEntry = mappedFile;
+            }
+            continue;
+        }
+
+        // Only share a mapping if the file has not been replaced or modified since.
+        if (mappedFile->mDevice == fileStat.st_dev && mappedFile->mInode == fileStat.st_ino &&
+            mappedFile->mModTime == fileStat.st_mtime && mappedFile->mSize == static_cast<size_t>(fileStat.st_size))
+        {
+            mappedFile->mRefCount++;
+            return mappedFile;
+        }
+    }
+
+    if (freeEntry == NULL)
+    {
+        WeaveLogError(BDX, "BDX: Ran out of file mappings, maximum %d", WEAVE_CONFIG_BDX_MAX_NUM_TRANSFERS);
+        return NULL;
+    }
+
+    data = mmap(NULL, fileStat.st_size, PROT_READ, MAP_SHARED, fileno(aFile), 0);
+    if (data == MAP_FAILED)
+    {
+        WeaveLogError(BDX, "BDX: Unable to map file: %s", strerror(errno));
+        return NULL;
+    }
+
+    // Blocks are read front to back, so ask for aggressive read-ahead.
+    (void)madvise(data, fileStat.st_size, MADV_SEQUENTIAL);
+
+    freeEntry->mDevice = fileStat.st_dev;
+    freeEntry->mInode = fileStat.st_ino;
+    freeEntry->mModTime = fileStat.st_mtime;
+    freeEntry->mData = static_cast<const uint8_t *>(data);
+    freeEntry->mSize = fileStat.st_size;
+    freeEntry->mRefCount = 1;
+
+    return freeEntry;
+}
+
+void UnmapFile(BdxMappedFile *aMappedFile)
+{
+    if (aMappedFile == NULL || aMappedFile->mRefCount == 0)
+    {
+        return;
+    }
+
+    if (--aMappedFile->mRefCount == 0)
+    {
+        munmap(const_cast<uint8_t *>(aMappedFile->mData), aMappedFile->mSize);
+        aMappedFile->mData = NULL;
+        aMappedFile->mSize = 0;
+    }
+}
+
+/** Releases the file, mapping and block buffer held by a finished transfer. */
+static void ReleaseAppStateResources(BdxAppState *aAppState)
+{
+    if (aAppState->mFile)
+    {
+        if (fclose(aAppState->mFile))
+        {
+            printf("Error closing file! Permissions?\n");
+        }
+        aAppState->mFile = NULL;
+    }
+
+    UnmapFile(aAppState->mMappedFile);
+    aAppState->mMappedFile = NULL;
+
+    if (aAppState->mBuffer != NULL)
+    {
+        free(aAppState->mBuffer);
+    }
+
+    aAppState->mBuffer = NULL;
+}
+
+WEAVE_ERROR BdxDeltaImageFiles::ReadBaseImage(uint32_t offset, uint8_t *buf, uint16_t len)
+{
+    if (fseek(mBaseFile, offset, SEEK_SET) != 0 || fread(buf, 1, len, mBaseFile) != len)
+    {
+        return WEAVE_ERROR_INVALID_ARGUMENT;
+    }
+
+    return WEAVE_NO_ERROR;
+}
+
+WEAVE_ERROR BdxDeltaImageFiles::WriteTargetImage(const uint8_t *data, uint16_t len)
+{
+    if (mAppState->mFile == NULL || fwrite(data, 1, len, mAppState->mFile) != len)
+    {
+        return WEAVE_ERROR_INCORRECT_STATE;
+    }
+
+    return WEAVE_NO_ERROR;
+}
+
 void SetReceivedFileLocation(const char *path)
 {
     strncpy(ReceivedFileLocation, path, sizeof(ReceivedFileLocation));
@@ -292,7 +423,14 @@ uint16_t BdxSendInitHandler(BDXTransfer *aXfer, SendInit *aSendInitMsg)
 
     // All seems good, so accept the transfer and set the handlers
     aXfer->mIsAccepted = true;
-    aXfer->mTransferMode = aSendInitMsg->mSenderDriveSupported ? kMode_SenderDrive : kMode_ReceiverDrive;
+    if (aSendInitMsg->mAsynchronousModeSupported && aXfer->mVersion == 1)
+    {
+        aXfer->mTransferMode = kMode_Asynchronous;
+    }
+    else
+    {
+        aXfer->mTransferMode = aSendInitMsg->mSenderDriveSupported ? kMode_SenderDrive : kMode_ReceiverDrive;
+    }
 
     aXfer->SetHandlers(handlers);
 
@@ -397,13 +535,32 @@ uint16_t BdxReceiveInitHandler(BDXTransfer *aXfer, ReceiveInit *aReceiveInit)
         aXfer->mLength = (aReceiveInit->mLength + aReceiveInit->mStartOffset > static_cast<uint64_t>(fileSize)) ? (fileSize - aReceiveInit->mStartOffset) : (aReceiveInit->mLength);
     }
 
-    //TODO: shouldn't be using dynamic memory allocation, but how to do that with dynamically negotiated maxBlockSize???
-    //perhaps just go ahead and allocate our maximum size since we know the transfer won't go above that?
-    mAppState->mBuffer = (uint8_t *)malloc(aReceiveInit->mMaxBlockSize);
+    // Serve blocks straight from a (shared) mapping of the file when possible,
+    // and only fall back to reading it into a block buffer otherwise.
+    mAppState->mMappedFile = MapFile(mAppState->mFile);
+    if (mAppState->mMappedFile != NULL)
+    {
+        mAppState->mMappedOffset = aReceiveInit->mStartOffset;
+        fclose(mAppState->mFile);
+        mAppState->mFile = NULL;
+    }
+    else
+    {
+        //TODO: shouldn't be using dynamic memory allocation, but how to do that with dynamically negotiated maxBlockSize???
+        //perhaps just go ahead and allocate our maximum size since we know the transfer won't go above that?
+        mAppState->mBuffer = (uint8_t *)malloc(aReceiveInit->mMaxBlockSize);
+    }
 
     // All seems good, so accept the transfer and set the handlers
     aXfer->mIsAccepted = true;
-    aXfer->mTransferMode = aReceiveInit->mReceiverDriveSupported ? kMode_ReceiverDrive : kMode_SenderDrive;
+    if (aReceiveInit->mAsynchronousModeSupported && aXfer->mVersion == 1)
+    {
+        aXfer->mTransferMode = kMode_Asynchronous;
+    }
+    else
+    {
+        aXfer->mTransferMode = aReceiveInit->mReceiverDriveSupported ? kMode_ReceiverDrive : kMode_SenderDrive;
+    }
     aXfer->SetHandlers(handlers);
 
 exit:
@@ -441,9 +598,19 @@ WEAVE_ERROR BdxSendAcceptHandler(BDXTransfer *aXfer, SendAccept *aSendAcceptMsg)
         exit(-1);
     }
 
-    //TODO: shouldn't be using dynamic memory allocation, but how to do that with dynamically negotiated maxBlockSize???
-    //perhaps just go ahead and allocate our maximum size since we know the transfer won't go above that?
-    bdxState->mBuffer = (uint8_t*)malloc(aSendAcceptMsg->mMaxBlockSize);
+    bdxState->mMappedFile = MapFile(bdxState->mFile);
+    if (bdxState->mMappedFile != NULL)
+    {
+        bdxState->mMappedOffset = 0;
+        fclose(bdxState->mFile);
+        bdxState->mFile = NULL;
+    }
+    else
+    {
+        //TODO: shouldn't be using dynamic memory allocation, but how to do that with dynamically negotiated maxBlockSize???
+        //perhaps just go ahead and allocate our maximum size since we know the transfer won't go above that?
+        bdxState->mBuffer = (uint8_t*)malloc(aSendAcceptMsg->mMaxBlockSize);
+    }
 
     return error;
 }
@@ -527,15 +694,33 @@ void BdxGetBlockHandler(BDXTransfer *aXfer,
         blockSize = aXfer->mMaxBlockSize;
     }
 
-    *aLength = fread(bdxState->mBuffer, 1, blockSize, bdxState->mFile);
-    *aDataBlock = bdxState->mBuffer;
+    if (bdxState->mMappedFile != NULL)
+    {
+        // Hand out a pointer into the mapping; the protocol copies it
+        // directly into the outgoing message.
+        const BdxMappedFile *mappedFile = bdxState->mMappedFile;
+        uint64_t remaining = (bdxState->mMappedOffset < mappedFile->mSize) ? mappedFile->mSize - bdxState->mMappedOffset : 0;
+
+        *aLength = (blockSize < remaining) ? blockSize : remaining;
+        *aDataBlock = const_cast<uint8_t *>(mappedFile->mData) + bdxState->mMappedOffset;
+        bdxState->mMappedOffset += *aLength;
+    }
+    else
+    {
+        *aLength = fread(bdxState->mBuffer, 1, blockSize, bdxState->mFile);
+        *aDataBlock = bdxState->mBuffer;
+    }
+
     aXfer->mBytesSent += blockSize;
+    bdxState->mBytesTransferred += *aLength;
 
     *aIsLastBlock = (*aLength < aXfer->mMaxBlockSize) ? true : false;
 }
 
 /** Example implementation of a PutBlockHandler that dumps the block to stdout for
  * debugging and then writes it to the file handle associated with the transfer.
+ * If the transfer is a delta image, the block is instead applied to the installed
+ * image as it arrives and the reconstructed image is written to the file.
  */
 void BdxPutBlockHandler(BDXTransfer *aXfer, uint64_t aLength, uint8_t *aDataBlock, bool aIsLastBlock)
 {
@@ -543,7 +728,33 @@ void BdxPutBlockHandler(BDXTransfer *aXfer, uint64_t aLength, uint8_t *aDataBloc
 
     DumpMemory(aDataBlock, aLength, "--> ", 16);
 
-    if (bdxState->mFile)
+    bdxState->mBytesTransferred += aLength;
+
+    if (bdxState->mDeltaApplier != NULL)
+    {
+        if (bdxState->mDeltaError != WEAVE_NO_ERROR)
+        {
+            return;
+        }
+
+        bdxState->mDeltaError = bdxState->mDeltaApplier->ProcessPatchData(aDataBlock, static_cast<uint16_t>(aLength));
+
+        if (bdxState->mDeltaError == WEAVE_NO_ERROR && aIsLastBlock)
+        {
+            bdxState->mDeltaError = bdxState->mDeltaApplier->Finish();
+        }
+
+        if (bdxState->mDeltaError != WEAVE_NO_ERROR)
+        {
+            WeaveLogError(BDX, "PutBlockHandler failed to apply delta image: %s", ErrorStr(bdxState->mDeltaError));
+        }
+        else if (aIsLastBlock)
+        {
+            WeaveLogProgress(BDX, "PutBlockHandler applied delta image, %" PRIu32 " bytes written",
+                             bdxState->mDeltaApplier->GetTargetBytesWritten());
+        }
+    }
+    else if (bdxState->mFile)
     {
         // Write bulk data to disk.
         int wtd = fwrite(aDataBlock, 1, aLength, bdxState->mFile);
@@ -563,24 +774,10 @@ void BdxXferErrorHandler(BDXTransfer *aXfer, StatusReport *aXferError)
 
     WeaveLogProgress(BDX, "Transfer error: %d", aXferError->mStatusCode);
 
-    if (appState->mFile)
-    {
-        if (fclose(appState->mFile))
-        {
-            printf("Error closing file! Permissions?\n");
-        }
-        appState->mFile = NULL;
-    }
-
-    appState->mDone = true;
+    ReleaseAppStateResources(appState);
 
     // app-defined state to tell main() to terminate client program
-    if (appState->mBuffer != NULL)
-    {
-        free(appState->mBuffer);
-    }
-
-    appState->mBuffer = NULL;
+    appState->mDone = true;
 
     aXfer->Shutdown();
 }
@@ -593,24 +790,11 @@ void BdxXferDoneHandler(BDXTransfer *aXfer)
 {
     WeaveLogDetail(BDX, "Transfer complete!");
     BdxAppState *appState = (BdxAppState *)(aXfer->mAppState);
-    if (appState->mFile)
-    {
-        if (fclose(appState->mFile))
-        {
-            printf("Error closing file! Permissions?\n");
-        }
-        appState->mFile = NULL;
-    }
 
-    appState->mDone = true;
+    ReleaseAppStateResources(appState);
 
     // app-defined state to tell main() to terminate client program
-    if (appState->mBuffer != NULL)
-    {
-        free(appState->mBuffer);
-    }
-
-    appState->mBuffer = NULL;
+    appState->mDone = true;
 
     aXfer->Shutdown();
 }
@@ -627,17 +811,7 @@ void BdxErrorHandler(BDXTransfer *aXfer, WEAVE_ERROR aErrorCode)
     // app-defined state to tell main() to terminate client program
     appState->mDone = true;
 
-    if (appState->mFile)
-    {
-        fclose(appState->mFile);
-        appState->mFile = NULL;
-    }
-
-    if (appState->mBuffer != NULL)
-    {
-        free(appState->mBuffer);
-        appState->mBuffer = NULL;
-    }
+    ReleaseAppStateResources(appState);
 
 
     aXfer->Shutdown();
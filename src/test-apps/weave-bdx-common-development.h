@@ -29,8 +29,10 @@
 #define _WEAVE_BDX_COMMON_H_
 
 #include <stdio.h>
+#include <sys/types.h>
 
 #include <Weave/Profiles/bulk-data-transfer/Development/BulkDataTransfer.h>
+#include <Weave/Profiles/software-update/DeltaImageApplier.h>
 
 using namespace nl::Weave::Profiles;
 using namespace nl::Weave::Profiles::BulkDataTransfer;
@@ -40,6 +42,19 @@ namespace Weave {
 namespace Profiles {
 namespace WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesignation_Development) {
 
+// A read-only mapping of a file being sent, shared by all concurrent transfers
+// of the same file so that blocks are served from the page cache without a
+// read() and an intermediate copy per block.
+struct BdxMappedFile
+{
+    dev_t mDevice;
+    ino_t mInode;
+    time_t mModTime;
+    const uint8_t *mData;
+    size_t mSize;
+    uint32_t mRefCount;
+};
+
 // AppState object for holding application-specific info that is passed around to handlers
 // This object is attached to a BDXTransfer via its mAppState member.
 struct BdxAppState
@@ -47,6 +62,23 @@ struct BdxAppState
     FILE *mFile;
     bool mDone;
     uint8_t *mBuffer; // buffer to store read blocks
+    uint64_t mBytesTransferred; // block bytes handed to or received from the protocol
+    BdxMappedFile *mMappedFile; // if not NULL, blocks are served from this mapping instead of mFile
+    uint64_t mMappedOffset; // offset of the next block within mMappedFile
+    SoftwareUpdate::DeltaImageApplier *mDeltaApplier; // if not NULL, received blocks are a patch applied by it into mFile
+    WEAVE_ERROR mDeltaError; // first error from mDeltaApplier; later blocks are dropped
+};
+
+// Delta image storage for a download: the installed image is read from a file and
+// the reconstructed image is written to the file of the receiving transfer.
+class BdxDeltaImageFiles : public SoftwareUpdate::DeltaImageApplier::Delegate
+{
+public:
+    FILE *mBaseFile;
+    BdxAppState *mAppState;
+
+    WEAVE_ERROR ReadBaseImage(uint32_t offset, uint8_t *buf, uint16_t len);
+    WEAVE_ERROR WriteTargetImage(const uint8_t *data, uint16_t len);
 };
 
 // Returns a reference to a static BdxAppState so that handlers can grab one
@@ -55,6 +87,12 @@ struct BdxAppState
 BdxAppState * NewAppState();
 void ResetAppStates();
 
+// Map an open file for sending, sharing an existing mapping of the same file
+// if there is one.  Returns NULL if the file cannot be mapped, in which case
+// the caller should fall back to reading it.
+BdxMappedFile *MapFile(FILE *aFile);
+void UnmapFile(BdxMappedFile *aMappedFile);
+
 void SetReceivedFileLocation(const char *path);
 void SetTempLocation(const char *path);
 
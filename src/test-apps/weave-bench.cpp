@@ -0,0 +1,1508 @@
+/*
+ *
+ *    Copyright (c) 2017 Nest Labs, Inc.
+ *    All rights reserved.
+ *
+ *    Licensed under the Apache License, Version 2.0 (the "License");
+ *    you may not use this file except in compliance with the License.
+ *    You may obtain a copy of the License at
+ *
+ *        http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *    Unless required by applicable law or agreed to in writing, software
+ *    distributed under the License is distributed on an "AS IS" BASIS,
+ *    WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *    See the License for the specific language governing permissions and
+ *    limitations under the License.
+ */
+
+/**
+ *    @file
+ *      This file implements a command line tool, weave-bench, for
+ *      measuring the throughput and latency of the Weave stack.
+ *
+ *      weave-bench drives many concurrent Echo exchanges against one or
+ *      more peers over UDP, WRMP or TCP, using either a closed-loop model
+ *      (a fixed number of exchanges kept in flight) or an open-loop model
+ *      (requests issued at a fixed or Poisson-distributed rate regardless
+ *      of how fast responses arrive). At the end of the run it reports
+ *      throughput, a latency histogram with its percentiles, and the CPU
+ *      time spent per exchange.
+ *
+ *      Instead of Echo exchanges, weave-bench can drive Bulk Data Transfer
+ *      downloads (--bdx) or Weave Data Management subscriptions (--wdm),
+ *      each download or subscription counting as one exchange.
+ *
+ *      When run with --listen, weave-bench acts as a quiet Echo responder,
+ *      BDX server and WDM publisher, so that a pair of local processes can
+ *      be used to regression-test the performance of the stack.
+ *
+ */
+
+#define __STDC_FORMAT_MACROS
+#define __STDC_LIMIT_MACROS
+
+#include <inttypes.h>
+#include <limits.h>
+#include <math.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+
+// Select the managed namespaces before any header can pick up the defaults.
+#include <Weave/Profiles/bulk-data-transfer/Development/BDXManagedNamespace.hpp>
+#include <Weave/Profiles/data-management/Current/WdmManagedNamespace.h>
+
+#include "ToolCommon.h"
+#include <Weave/WeaveVersion.h>
+#include <Weave/Support/TimeUtils.h>
+#include "weave-bdx-common-development.h"
+#include "MockLoggingManager.h"
+#include "MockWdmSubscriptionInitiator.h"
+#include "MockWdmSubscriptionResponder.h"
+
+#define TOOL_NAME "weave-bench"
+
+using namespace nl::Weave::Profiles::WeaveMakeManagedNamespaceIdentifier(BDX, kWeaveManagedNamespaceDesignation_Development);
+
+static bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *name, const char *arg);
+static bool HandleNonOptionArgs(const char *progName, int argc, char *argv[]);
+static bool ParsePeerAddress(const char *progName, struct BenchPeer &peer);
+static void StartConnections(void);
+static void DriveSending(void);
+static bool SendRequest(uint64_t startTime);
+static WEAVE_ERROR SendEchoRequest(struct BenchRequest *req, WeaveConnection *con);
+static WEAVE_ERROR StartBdxTransfer(struct BenchRequest *req, WeaveConnection *con);
+static WEAVE_ERROR StartWdmSubscription(struct BenchRequest *req);
+static void CompleteRequest(struct BenchRequest *req, WEAVE_ERROR err);
+static void HandleEchoResponse(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, uint32_t profileId,
+        uint8_t msgType, PacketBuffer *payload);
+static void HandleResponseTimeout(ExchangeContext *ec);
+static void HandleExchangeConnectionClosed(ExchangeContext *ec, WeaveConnection *con, WEAVE_ERROR conErr);
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+static void HandleSendError(ExchangeContext *ec, WEAVE_ERROR err, void *msgCtxt);
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+static void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr);
+static void HandleConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr);
+static void HandleConnectionReceived(WeaveMessageLayer *msgLayer, WeaveConnection *con);
+static void HandleEchoRequestReceived(uint64_t nodeId, IPAddress nodeAddr, PacketBuffer *payload);
+static WEAVE_ERROR HandleBdxReceiveAccept(BDXTransfer *xfer, ReceiveAccept *receiveAcceptMsg);
+static void HandleBdxReject(BDXTransfer *xfer, StatusReport *report);
+static void HandleBdxPutBlock(BDXTransfer *xfer, uint64_t length, uint8_t *dataBlock, bool isLastBlock);
+static void HandleBdxXferError(BDXTransfer *xfer, StatusReport *xferError);
+static void HandleBdxXferDone(BDXTransfer *xfer);
+static void HandleBdxError(BDXTransfer *xfer, WEAVE_ERROR err);
+static uint16_t HandleBdxReceiveInit(BDXTransfer *xfer, ReceiveInit *receiveInitMsg);
+static void HandleWdmSubscriptionComplete(void);
+static void HandleWdmSubscriptionError(void);
+static void HandleWdmSubscriptionServed(void);
+static void PrintReport(void);
+
+enum
+{
+    kMaxPeers                   = 16,
+    kMaxConnectionsPerPeer      = 8,
+    kMaxOutstanding             = WEAVE_CONFIG_MAX_EXCHANGE_CONTEXTS,
+};
+
+enum TransportType
+{
+    kTransport_TCP,
+    kTransport_UDP,
+    kTransport_WRMP
+};
+
+enum WorkloadType
+{
+    kWorkload_Echo,
+    kWorkload_BDX,
+    kWorkload_WDM
+};
+
+/**
+ *  Latency histogram with log-linear buckets.
+ *
+ *  Values below kSubBuckets microseconds get a bucket each; above that,
+ *  every power-of-two range is split into kSubBuckets linear buckets,
+ *  giving a resolution of about 3% over the whole range.
+ */
+class LatencyHistogram
+{
+public:
+    enum
+    {
+        kSubBucketBits  = 5,
+        kSubBuckets     = 1 << kSubBucketBits,
+        kMaxExponent    = 31,
+        kNumBuckets     = (kMaxExponent + 2) * kSubBuckets
+    };
+
+    void Reset(void);
+    void Record(uint64_t value);
+    uint64_t Percentile(double percent) const;
+
+    uint64_t Count(void) const { return mCount; }
+    uint64_t Min(void) const { return mMin; }
+    uint64_t Max(void) const { return mMax; }
+    uint64_t Mean(void) const { return (mCount != 0) ? mSum / mCount : 0; }
+
+    void Print(void) const;
+
+private:
+    uint64_t mBuckets[kNumBuckets];
+    uint64_t mCount;
+    uint64_t mSum;
+    uint64_t mMin;
+    uint64_t mMax;
+
+    static size_t BucketIndex(uint64_t value);
+    static uint64_t BucketUpperBound(size_t index);
+};
+
+struct BenchPeer
+{
+    uint64_t NodeId;
+    const char *Addr;
+    IPAddress IPAddr;                           // only used for UDP
+    uint16_t Port;                              // only used for UDP
+    InterfaceId Intf;                           // only used for UDP
+    WeaveConnection *Cons[kMaxConnectionsPerPeer];
+    bool ConEstablished[kMaxConnectionsPerPeer];
+    uint8_t NextCon;
+};
+
+struct BenchRequest
+{
+    bool InUse;
+    ExchangeContext *EC;                        // only used for Echo
+    BDXTransfer *Xfer;                          // only used for BDX
+    BenchPeer *Peer;
+    uint64_t StartTime;
+    uint64_t BytesReceived;                     // only used for BDX
+};
+
+bool Listening = false;
+TransportType Transport = kTransport_UDP;
+WorkloadType Workload = kWorkload_Echo;
+const char *BdxFileDesignator = NULL;
+uint16_t BdxBlockSize = 1024;
+bool BdxAsync = false;
+int32_t WdmNumChanges = 1;                      // data changes the publisher notifies per subscription
+const char *WdmNumChangesStr = "1";
+uint32_t WdmChangeInterval = 0;                 // milliseconds between data changes
+const char *WdmChangeIntervalStr = "0";
+uint32_t Concurrency = 1;
+uint32_t ConnectionsPerPeer = 1;
+uint32_t Rate = 0;                              // requests per second; 0 selects the closed-loop model
+bool PoissonArrivals = false;
+int32_t MaxRequests = -1;
+uint32_t Duration = 0;                          // seconds; 0 selects 10 seconds, or no limit with --count
+uint32_t Warmup = 0;                            // seconds
+uint32_t ResponseTimeout = 5000;                // milliseconds
+int32_t EchoLength = 32;
+bool PrintHistogram = false;
+
+BenchPeer Peers[kMaxPeers];
+uint32_t NumPeers = 0;
+uint32_t NextPeer = 0;
+
+BenchRequest Requests[kMaxOutstanding];
+uint32_t NumOutstanding = 0;
+BenchRequest *WdmRequest = NULL;                // the request of the subscription in flight, if any
+
+uint64_t RunStartTime = 0;
+uint64_t MeasureStartTime = 0;
+uint64_t SendEndTime = 0;
+uint64_t MeasureEndTime = 0;
+uint64_t NextArrivalTime = 0;
+bool MeasureStarted = false;
+struct rusage MeasureStartUsage;
+struct rusage MeasureEndUsage;
+
+uint64_t RequestsSent = 0;
+uint64_t RequestsCompleted = 0;
+uint64_t RequestsMeasured = 0;
+uint64_t RequestsTimedOut = 0;
+uint64_t RequestsFailed = 0;
+uint64_t ArrivalOverruns = 0;
+uint64_t BytesMeasured = 0;
+uint64_t BdxAsyncTransfers = 0;                 // downloads the peer accepted in the asynchronous mode
+uint64_t EchoRequestsServed = 0;
+uint64_t BdxTransfersServed = 0;
+uint64_t WdmSubscriptionsServed = 0;
+
+LatencyHistogram Latency;
+
+WeaveEchoServer EchoServer;
+BdxNode BDXNode;
+
+enum
+{
+    kToolOpt_Connections                    = 1000,
+    kToolOpt_Poisson,
+    kToolOpt_Warmup,
+    kToolOpt_Timeout,
+    kToolOpt_Histogram,
+    kToolOpt_BDX,
+    kToolOpt_BDXBlockSize,
+    kToolOpt_BDXAsync,
+    kToolOpt_WDM,
+    kToolOpt_WDMChanges,
+    kToolOpt_WDMInterval,
+};
+
+static OptionDef gToolOptionDefs[] =
+{
+    { "listen",       kNoArgument,       'L' },
+    { "tcp",          kNoArgument,       't' },
+    { "udp",          kNoArgument,       'u' },
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    { "wrmp",         kNoArgument,       'w' },
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    { "concurrency",  kArgumentRequired, 'C' },
+    { "connections",  kArgumentRequired, kToolOpt_Connections },
+    { "rate",         kArgumentRequired, 'r' },
+    { "poisson",      kNoArgument,       kToolOpt_Poisson },
+    { "count",        kArgumentRequired, 'c' },
+    { "duration",     kArgumentRequired, 'd' },
+    { "warmup",       kArgumentRequired, kToolOpt_Warmup },
+    { "timeout",      kArgumentRequired, kToolOpt_Timeout },
+    { "length",       kArgumentRequired, 'l' },
+    { "histogram",    kNoArgument,       kToolOpt_Histogram },
+    { "bdx",          kArgumentRequired, kToolOpt_BDX },
+    { "bdx-block-size", kArgumentRequired, kToolOpt_BDXBlockSize },
+    { "bdx-async",    kNoArgument,       kToolOpt_BDXAsync },
+    { "wdm",          kNoArgument,       kToolOpt_WDM },
+    { "wdm-changes",  kArgumentRequired, kToolOpt_WDMChanges },
+    { "wdm-interval", kArgumentRequired, kToolOpt_WDMInterval },
+    { NULL }
+};
+
+static const char *const gToolOptionHelp =
+    "  -L, --listen\n"
+    "       Respond to Echo Requests, BDX downloads and WDM subscriptions from\n"
+    "       other nodes without logging each one.\n"
+    "\n"
+    "  -u, --udp\n"
+    "       Send Echo Requests over UDP. This is the default.\n"
+    "\n"
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    "  -w, --wrmp\n"
+    "       Send Echo Requests over UDP with Weave reliable messaging.\n"
+    "\n"
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    "  -t, --tcp\n"
+    "       Send Echo Requests over TCP.\n"
+    "\n"
+    "  -C, --concurrency <num>\n"
+    "       Maximum number of Echo exchanges in flight at any time. In the\n"
+    "       closed-loop model this many exchanges are kept in flight. Defaults\n"
+    "       to 1.\n"
+    "\n"
+    "  --connections <num>\n"
+    "       Number of TCP connections to open to each peer. Exchanges are spread\n"
+    "       across them. Defaults to 1.\n"
+    "\n"
+    "  -r, --rate <num>\n"
+    "       Use the open-loop model: start an exchange <num> times per second\n"
+    "       regardless of outstanding responses. Latency is measured from the\n"
+    "       scheduled start time, so queuing delay is included. Arrivals that\n"
+    "       find --concurrency exchanges already in flight are counted as\n"
+    "       overruns. The event loop wakes for every arrival, which is included\n"
+    "       in the reported CPU time.\n"
+    "\n"
+    "  --poisson\n"
+    "       With --rate, space arrivals with exponentially distributed gaps\n"
+    "       rather than evenly.\n"
+    "\n"
+    "  -c, --count <num>\n"
+    "       Stop after starting the specified number of exchanges.\n"
+    "\n"
+    "  -d, --duration <sec>\n"
+    "       Stop starting exchanges after the specified number of seconds.\n"
+    "       Defaults to 10, or to no limit when --count is given.\n"
+    "\n"
+    "  --warmup <sec>\n"
+    "       Exclude exchanges started in the first <sec> seconds from the\n"
+    "       results.\n"
+    "\n"
+    "  --timeout <ms>\n"
+    "       Time to wait for each Echo Response. Defaults to 5000.\n"
+    "\n"
+    "  -l, --length <num>\n"
+    "       Send Echo Requests with the specified number of payload bytes.\n"
+    "       Defaults to 32.\n"
+    "\n"
+    "  --histogram\n"
+    "       Print the non-empty latency histogram buckets.\n"
+    "\n"
+    "  --bdx <file-designator>\n"
+    "       Download the specified file from the peers with Bulk Data Transfer\n"
+    "       instead of sending Echo Requests, one transfer per exchange. The\n"
+    "       designator is resolved by the peer, e.g. file:///tmp/bench.bin.\n"
+    "       Requires --tcp.\n"
+    "\n"
+    "  --bdx-block-size <num>\n"
+    "       Maximum BDX block size to negotiate. Defaults to 1024.\n"
+    "\n"
+    "  --bdx-async\n"
+    "       Propose the asynchronous BDX mode, in which the peer sends blocks\n"
+    "       without waiting for each one to be acknowledged (up to\n"
+    "       WEAVE_CONFIG_BDX_ASYNC_WINDOW_SIZE blocks in flight), instead of\n"
+    "       the synchronous mode, in which every block is queried. Peers that\n"
+    "       do not support it fall back to the synchronous mode.\n"
+    "\n"
+    "  --wdm\n"
+    "       Subscribe to the mock WDM publisher of a single peer instead of\n"
+    "       sending Echo Requests. Each exchange is one subscription: the\n"
+    "       subscribe request, the notifications of the publisher's data\n"
+    "       changes, and the publisher's cancellation, which the mock publisher\n"
+    "       sends once it has seen the last notification acknowledged (it polls\n"
+    "       for this every 120 ms). Subscriptions are carried over WRMP to the\n"
+    "       peer's fabric address, so --tcp and peer addresses do not apply, and\n"
+    "       only one can be in flight.\n"
+    "\n"
+    "  --wdm-changes <num>\n"
+    "       With --listen, the number of data changes to notify to each\n"
+    "       subscriber before cancelling its subscription. Defaults to 1.\n"
+    "\n"
+    "  --wdm-interval <ms>\n"
+    "       With --listen, the time between data changes. Defaults to 0.\n"
+    "\n"
+    ;
+
+static OptionSet gToolOptions =
+{
+    HandleOption,
+    gToolOptionDefs,
+    "GENERAL OPTIONS",
+    gToolOptionHelp
+};
+
+static HelpOptions gHelpOptions(
+    TOOL_NAME,
+    "Usage: " TOOL_NAME " [<options...>] <dest-node-id>[@<dest-host>[:<dest-port>][%<interface>]]...\n"
+    "       " TOOL_NAME " [<options...>] --listen\n",
+    WEAVE_VERSION_STRING "\n" WEAVE_TOOL_COPYRIGHT,
+    "Measure Weave message throughput and latency with concurrent Echo, BDX or WDM exchanges.\n"
+);
+
+static OptionSet *gToolOptionSets[] =
+{
+    &gToolOptions,
+    &gNetworkOptions,
+    &gWeaveNodeOptions,
+    &gWRMPOptions,
+    &gFaultInjectionOptions,
+    &gHelpOptions,
+    NULL
+};
+
+int main(int argc, char *argv[])
+{
+    WEAVE_ERROR err;
+
+    InitToolCommon();
+
+    // SIGUSR1 ends the run early, still printing the results.
+    SetSignalHandler(DoneOnHandleSIGUSR1);
+
+    if (argc == 1)
+    {
+        gHelpOptions.PrintBriefUsage(stderr);
+        exit(EXIT_FAILURE);
+    }
+
+    if (!ParseArgsFromEnvVar(TOOL_NAME, TOOL_OPTIONS_ENV_VAR_NAME, gToolOptionSets, NULL, true) ||
+        !ParseArgs(TOOL_NAME, argc, argv, gToolOptionSets, HandleNonOptionArgs))
+    {
+        exit(EXIT_FAILURE);
+    }
+
+    if (gNetworkOptions.LocalIPv6Addr != IPAddress::Any)
+    {
+        if (!gNetworkOptions.LocalIPv6Addr.IsIPv6ULA())
+        {
+            printf("ERROR: Local address must be an IPv6 ULA\n");
+            exit(EXIT_FAILURE);
+        }
+
+        gWeaveNodeOptions.FabricId = gNetworkOptions.LocalIPv6Addr.GlobalId();
+        gWeaveNodeOptions.LocalNodeId = IPv6InterfaceIdToWeaveNodeId(gNetworkOptions.LocalIPv6Addr.InterfaceId());
+        gWeaveNodeOptions.SubnetId = gNetworkOptions.LocalIPv6Addr.Subnet();
+    }
+
+    InitSystemLayer();
+
+    InitNetwork();
+
+    InitWeaveStack(Listening || Transport != kTransport_TCP || Workload == kWorkload_WDM, true);
+
+    MessageLayer.OnConnectionReceived = HandleConnectionReceived;
+    MessageLayer.OnReceiveError = HandleMessageReceiveError;
+    MessageLayer.OnAcceptError = HandleAcceptConnectionError;
+
+    PrintNodeConfig();
+
+    if (Listening)
+    {
+        err = EchoServer.Init(&ExchangeMgr);
+        if (err != WEAVE_NO_ERROR)
+        {
+            printf("WeaveEchoServer.Init failed: %s\n", ErrorStr(err));
+            exit(EXIT_FAILURE);
+        }
+
+        EchoServer.OnEchoRequestReceived = HandleEchoRequestReceived;
+
+        err = BDXNode.Init(&ExchangeMgr);
+        if (err != WEAVE_NO_ERROR)
+        {
+            printf("BdxNode.Init failed: %s\n", ErrorStr(err));
+            exit(EXIT_FAILURE);
+        }
+
+        ResetAppStates();
+        BDXNode.AwaitBdxReceiveInit(HandleBdxReceiveInit);
+
+        InitializeEventLogging(&ExchangeMgr);
+
+        // Publish the test traits: notify the requested number of data changes to each subscriber, then cancel.
+        err = MockWdmSubscriptionResponder::GetInstance()->Init(&ExchangeMgr, false, "1", WdmNumChangesStr, "1",
+                                                                WdmChangeIntervalStr, true, NULL);
+        if (err != WEAVE_NO_ERROR)
+        {
+            printf("MockWdmSubscriptionResponder.Init failed: %s\n", ErrorStr(err));
+            exit(EXIT_FAILURE);
+        }
+
+        MockWdmSubscriptionResponder::GetInstance()->onCompleteTest = HandleWdmSubscriptionServed;
+        MockWdmSubscriptionResponder::GetInstance()->onError = HandleWdmSubscriptionServed;
+
+        printf("Listening for Echo requests, BDX downloads and WDM subscriptions...\n");
+
+        ServiceNetworkUntil(&Done);
+
+        printf("Served %" PRIu64 " Echo requests, %" PRIu64 " BDX downloads and %" PRIu64 " WDM subscriptions\n",
+               EchoRequestsServed, BdxTransfersServed, WdmSubscriptionsServed);
+
+        BDXNode.Shutdown();
+        EchoServer.Shutdown();
+    }
+    else
+    {
+        if (Workload == kWorkload_BDX)
+        {
+            err = BDXNode.Init(&ExchangeMgr);
+            if (err != WEAVE_NO_ERROR)
+            {
+                printf("BdxNode.Init failed: %s\n", ErrorStr(err));
+                exit(EXIT_FAILURE);
+            }
+        }
+        else if (Workload == kWorkload_WDM)
+        {
+            InitializeEventLogging(&ExchangeMgr);
+
+            // Subscribe one way to the test traits and stay idle until the publisher cancels.
+            err = MockWdmSubscriptionInitiator::GetInstance()->Init(&ExchangeMgr, false, "1", "0", "4", NULL, false, NULL,
+                                                                    false, WeaveSecurityMode::kNone, WeaveKeyId::kNone,
+                                                                    false);
+            if (err != WEAVE_NO_ERROR)
+            {
+                printf("MockWdmSubscriptionInitiator.Init failed: %s\n", ErrorStr(err));
+                exit(EXIT_FAILURE);
+            }
+
+            MockWdmSubscriptionInitiator::GetInstance()->onCompleteTest = HandleWdmSubscriptionComplete;
+            MockWdmSubscriptionInitiator::GetInstance()->onError = HandleWdmSubscriptionError;
+        }
+
+        printf("Benchmarking %s with %u peer(s) over %s, %s model, %u exchange(s) in flight\n",
+               (Workload == kWorkload_BDX) ? "BDX downloads" : (Workload == kWorkload_WDM) ? "WDM subscriptions" : "Echo",
+               NumPeers,
+               (Transport == kTransport_TCP) ? "TCP" : (Transport == kTransport_WRMP || Workload == kWorkload_WDM) ? "WRMP" : "UDP",
+               (Rate != 0) ? "open-loop" : "closed-loop", Concurrency);
+
+        Latency.Reset();
+
+        if (Transport == kTransport_TCP)
+            StartConnections();
+
+        RunStartTime = Now();
+        MeasureStartTime = RunStartTime + (uint64_t) Warmup * nl::kMicrosecondsPerSecond;
+        if (Duration != 0)
+            SendEndTime = MeasureStartTime + (uint64_t) Duration * nl::kMicrosecondsPerSecond;
+        else if (MaxRequests == -1)
+            SendEndTime = MeasureStartTime + 10 * nl::kMicrosecondsPerSecond;
+        else
+            SendEndTime = UINT64_MAX;
+        NextArrivalTime = RunStartTime;
+
+        while (!Done)
+        {
+            struct timeval sleepTime;
+            uint64_t sleepUs = 100000;
+            uint64_t now;
+
+            DriveSending();
+
+            now = Now();
+            if (Rate != 0 && now < SendEndTime)
+            {
+                if (NextArrivalTime <= now)
+                    sleepUs = 0;
+                else if (NextArrivalTime - now < sleepUs)
+                    sleepUs = NextArrivalTime - now;
+            }
+
+            sleepTime.tv_sec = 0;
+            sleepTime.tv_usec = sleepUs;
+
+            ServiceNetwork(sleepTime);
+        }
+
+        if (MeasureEndTime == 0)
+        {
+            MeasureEndTime = Now();
+            getrusage(RUSAGE_SELF, &MeasureEndUsage);
+        }
+
+        for (size_t i = 0; i < kMaxOutstanding; i++)
+        {
+            if (Requests[i].EC != NULL)
+            {
+                Requests[i].EC->Abort();
+                Requests[i].EC = NULL;
+            }
+            if (Requests[i].Xfer != NULL)
+            {
+                Requests[i].Xfer->Shutdown();
+                Requests[i].Xfer = NULL;
+            }
+        }
+
+        for (size_t i = 0; i < NumPeers; i++)
+            for (size_t j = 0; j < kMaxConnectionsPerPeer; j++)
+                if (Peers[i].Cons[j] != NULL)
+                {
+                    Peers[i].Cons[j]->Close();
+                    Peers[i].Cons[j] = NULL;
+                }
+
+        PrintReport();
+    }
+
+    ShutdownWeaveStack();
+    ShutdownNetwork();
+    ShutdownSystemLayer();
+
+    return (Listening || RequestsMeasured != 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *name, const char *arg)
+{
+    switch (id)
+    {
+    case 'L':
+        Listening = true;
+        break;
+    case 't':
+        Transport = kTransport_TCP;
+        break;
+    case 'u':
+        Transport = kTransport_UDP;
+        break;
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    case 'w':
+        Transport = kTransport_WRMP;
+        break;
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    case 'C':
+        if (!ParseInt(arg, Concurrency) || Concurrency == 0 || Concurrency > kMaxOutstanding)
+        {
+            PrintArgError("%s: Invalid value specified for concurrency (1-%u): %s\n", progName, (unsigned) kMaxOutstanding, arg);
+            return false;
+        }
+        break;
+    case kToolOpt_Connections:
+        if (!ParseInt(arg, ConnectionsPerPeer) || ConnectionsPerPeer == 0 || ConnectionsPerPeer > kMaxConnectionsPerPeer)
+        {
+            PrintArgError("%s: Invalid value specified for connections (1-%u): %s\n", progName, (unsigned) kMaxConnectionsPerPeer, arg);
+            return false;
+        }
+        break;
+    case 'r':
+        if (!ParseInt(arg, Rate) || Rate == 0 || Rate > nl::kMicrosecondsPerSecond)
+        {
+            PrintArgError("%s: Invalid value specified for rate: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case kToolOpt_Poisson:
+        PoissonArrivals = true;
+        break;
+    case 'c':
+        if (!ParseInt(arg, MaxRequests) || MaxRequests <= 0)
+        {
+            PrintArgError("%s: Invalid value specified for count: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case 'd':
+        if (!ParseInt(arg, Duration) || Duration == 0 || Duration > 86400)
+        {
+            PrintArgError("%s: Invalid value specified for duration: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case kToolOpt_Warmup:
+        if (!ParseInt(arg, Warmup) || Warmup > 86400)
+        {
+            PrintArgError("%s: Invalid value specified for warmup: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case kToolOpt_Timeout:
+        if (!ParseInt(arg, ResponseTimeout) || ResponseTimeout == 0)
+        {
+            PrintArgError("%s: Invalid value specified for timeout: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case 'l':
+        if (!ParseInt(arg, EchoLength) || EchoLength < 0 || EchoLength > UINT16_MAX)
+        {
+            PrintArgError("%s: Invalid value specified for data length: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case kToolOpt_Histogram:
+        PrintHistogram = true;
+        break;
+    case kToolOpt_BDX:
+        if (Workload == kWorkload_WDM)
+        {
+            PrintArgError("%s: Please specify only one of --bdx and --wdm\n", progName);
+            return false;
+        }
+        Workload = kWorkload_BDX;
+        BdxFileDesignator = arg;
+        break;
+    case kToolOpt_BDXBlockSize:
+        if (!ParseInt(arg, BdxBlockSize) || BdxBlockSize == 0)
+        {
+            PrintArgError("%s: Invalid value specified for BDX block size: %s\n", progName, arg);
+            return false;
+        }
+        break;
+    case kToolOpt_BDXAsync:
+        BdxAsync = true;
+        break;
+    case kToolOpt_WDM:
+        if (Workload == kWorkload_BDX)
+        {
+            PrintArgError("%s: Please specify only one of --bdx and --wdm\n", progName);
+            return false;
+        }
+        Workload = kWorkload_WDM;
+        break;
+    case kToolOpt_WDMChanges:
+        if (!ParseInt(arg, WdmNumChanges) || WdmNumChanges < 0)
+        {
+            PrintArgError("%s: Invalid value specified for WDM data changes: %s\n", progName, arg);
+            return false;
+        }
+        WdmNumChangesStr = arg;
+        break;
+    case kToolOpt_WDMInterval:
+        if (!ParseInt(arg, WdmChangeInterval))
+        {
+            PrintArgError("%s: Invalid value specified for WDM data change interval: %s\n", progName, arg);
+            return false;
+        }
+        WdmChangeIntervalStr = arg;
+        break;
+    default:
+        PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", progName, name);
+        return false;
+    }
+
+    return true;
+}
+
+bool HandleNonOptionArgs(const char *progName, int argc, char *argv[])
+{
+    if (Listening)
+    {
+        if (argc > 0)
+        {
+            PrintArgError("%s: Unexpected argument: %s\n", progName, argv[0]);
+            return false;
+        }
+        return true;
+    }
+
+    if (argc == 0)
+    {
+        PrintArgError("%s: Please specify one or more node ids or --listen\n", progName);
+        return false;
+    }
+
+    if (argc > kMaxPeers)
+    {
+        PrintArgError("%s: Too many peers specified (max %u)\n", progName, (unsigned) kMaxPeers);
+        return false;
+    }
+
+    if (Workload == kWorkload_BDX)
+    {
+        if (Transport != kTransport_TCP)
+        {
+            PrintArgError("%s: --bdx requires --tcp\n", progName);
+            return false;
+        }
+
+        if (Concurrency > WEAVE_CONFIG_BDX_MAX_NUM_TRANSFERS)
+        {
+            PrintArgError("%s: Too many BDX downloads in flight (max %u)\n", progName, (unsigned) WEAVE_CONFIG_BDX_MAX_NUM_TRANSFERS);
+            return false;
+        }
+    }
+
+    if (BdxAsync && Workload != kWorkload_BDX)
+    {
+        PrintArgError("%s: --bdx-async requires --bdx\n", progName);
+        return false;
+    }
+
+    if (Workload == kWorkload_WDM)
+    {
+        if (Transport == kTransport_TCP)
+        {
+            PrintArgError("%s: --wdm cannot be used with --tcp\n", progName);
+            return false;
+        }
+
+        if (argc != 1 || Concurrency != 1)
+        {
+            PrintArgError("%s: --wdm requires a single peer and a concurrency of 1\n", progName);
+            return false;
+        }
+    }
+
+    for (int i = 0; i < argc; i++)
+    {
+        BenchPeer &peer = Peers[NumPeers];
+        const char *nodeId = argv[i];
+        char *p = strchr(argv[i], '@');
+
+        memset(peer.Cons, 0, sizeof(peer.Cons));
+        memset(peer.ConEstablished, 0, sizeof(peer.ConEstablished));
+        peer.NextCon = 0;
+        peer.Addr = NULL;
+        peer.IPAddr = IPAddress::Any;
+        peer.Port = WEAVE_PORT;
+        peer.Intf = INET_NULL_INTERFACEID;
+
+        if (p != NULL)
+        {
+            *p = 0;
+            peer.Addr = p + 1;
+        }
+
+        if (!ParseNodeId(nodeId, peer.NodeId))
+        {
+            PrintArgError("%s: Invalid value specified for destination node-id: %s\n", progName, nodeId);
+            return false;
+        }
+
+        if (Transport != kTransport_TCP && peer.Addr != NULL && !ParsePeerAddress(progName, peer))
+            return false;
+
+        NumPeers++;
+    }
+
+    return true;
+}
+
+bool ParsePeerAddress(const char *progName, BenchPeer &peer)
+{
+    // NOTE: This function is only used when communicating over UDP. Code in the WeaveConnection object handles
+    // parsing the destination node address for TCP connections.
+
+    INET_ERROR err;
+    const char *addr;
+    uint16_t addrLen;
+    const char *intfName;
+    uint16_t intfNameLen;
+    char addrStr[INET6_ADDRSTRLEN];
+    char intfStr[IF_NAMESIZE];
+
+    err = ParseHostPortAndInterface(peer.Addr, strlen(peer.Addr), addr, addrLen, peer.Port, intfName, intfNameLen);
+    if (err != INET_NO_ERROR || addrLen >= sizeof(addrStr))
+        goto fail;
+
+    memcpy(addrStr, addr, addrLen);
+    addrStr[addrLen] = 0;
+
+    if (!IPAddress::FromString(addrStr, peer.IPAddr))
+        goto fail;
+
+    if (peer.Port == 0)
+        peer.Port = WEAVE_PORT;
+
+    if (intfName != NULL)
+    {
+        if (intfNameLen >= sizeof(intfStr))
+            goto fail;
+
+        memcpy(intfStr, intfName, intfNameLen);
+        intfStr[intfNameLen] = 0;
+
+        if (InterfaceNameToId(intfStr, peer.Intf) != INET_NO_ERROR)
+        {
+            PrintArgError("%s: Invalid interface name: %s\n", progName, intfStr);
+            return false;
+        }
+    }
+
+    return true;
+
+fail:
+    PrintArgError("%s: Invalid destination address: %s\n", progName, peer.Addr);
+    return false;
+}
+
+void StartConnections(void)
+{
+    WEAVE_ERROR err;
+
+    for (size_t i = 0; i < NumPeers; i++)
+    {
+        BenchPeer &peer = Peers[i];
+
+        for (size_t j = 0; j < ConnectionsPerPeer; j++)
+        {
+            WeaveConnection *con = MessageLayer.NewConnection();
+            if (con == NULL)
+            {
+                printf("WeaveConnection.Connect failed: %s\n", ErrorStr(WEAVE_ERROR_NO_MEMORY));
+                Done = true;
+                return;
+            }
+
+            con->AppState = &peer;
+            con->OnConnectionComplete = HandleConnectionComplete;
+            con->OnConnectionClosed = HandleConnectionClosed;
+
+            err = con->Connect(peer.NodeId, kWeaveAuthMode_Unauthenticated, peer.Addr);
+            if (err != WEAVE_NO_ERROR)
+            {
+                printf("WeaveConnection.Connect failed: %s\n", ErrorStr(err));
+                con->Close();
+                Done = true;
+                return;
+            }
+
+            peer.Cons[j] = con;
+        }
+    }
+}
+
+static uint64_t NextArrivalGap(void)
+{
+    double gap = ((double) nl::kMicrosecondsPerSecond) / Rate;
+
+    if (PoissonArrivals)
+    {
+        // Exponentially distributed gap with the same mean, by inverse transform sampling.
+        double u = (random() + 1.0) / ((double) RAND_MAX + 2.0);
+        gap = -log(u) * gap;
+    }
+
+    return (uint64_t) gap;
+}
+
+void DriveSending(void)
+{
+    uint64_t now = Now();
+
+    if (!MeasureStarted && now >= MeasureStartTime)
+    {
+        getrusage(RUSAGE_SELF, &MeasureStartUsage);
+        MeasureStarted = true;
+    }
+
+    // Stop starting exchanges once the run is over, then wait for the outstanding ones to finish.
+    if (now >= SendEndTime || (MaxRequests != -1 && RequestsSent >= (uint64_t) MaxRequests))
+    {
+        if (MeasureEndTime == 0)
+        {
+            MeasureEndTime = now;
+            getrusage(RUSAGE_SELF, &MeasureEndUsage);
+        }
+
+        if (NumOutstanding == 0)
+            Done = true;
+
+        return;
+    }
+
+    if (Rate == 0)
+    {
+        while (NumOutstanding < Concurrency && (MaxRequests == -1 || RequestsSent < (uint64_t) MaxRequests))
+            if (!SendRequest(now))
+                break;
+    }
+    else
+    {
+        while (NextArrivalTime <= now)
+        {
+            if (NumOutstanding >= Concurrency)
+                ArrivalOverruns++;
+            else
+                SendRequest(NextArrivalTime);
+
+            NextArrivalTime += NextArrivalGap();
+
+            if (MaxRequests != -1 && RequestsSent >= (uint64_t) MaxRequests)
+                break;
+        }
+    }
+}
+
+static WeaveConnection *SelectConnection(BenchPeer &peer)
+{
+    for (size_t i = 0; i < ConnectionsPerPeer; i++)
+    {
+        size_t index = (peer.NextCon + i) % ConnectionsPerPeer;
+
+        if (peer.Cons[index] != NULL && peer.ConEstablished[index])
+        {
+            peer.NextCon = (index + 1) % ConnectionsPerPeer;
+            return peer.Cons[index];
+        }
+    }
+
+    return NULL;
+}
+
+bool SendRequest(uint64_t startTime)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    BenchRequest *req = NULL;
+    BenchPeer *peer = NULL;
+    WeaveConnection *con = NULL;
+
+    for (size_t i = 0; i < kMaxOutstanding && req == NULL; i++)
+        if (!Requests[i].InUse)
+            req = &Requests[i];
+    VerifyOrExit(req != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    // Pick the next peer, round robin, that can take a request.
+    for (size_t i = 0; i < NumPeers && peer == NULL; i++)
+    {
+        BenchPeer &candidate = Peers[(NextPeer + i) % NumPeers];
+
+        if (Transport == kTransport_TCP)
+        {
+            con = SelectConnection(candidate);
+            if (con == NULL)
+                continue;
+        }
+
+        peer = &candidate;
+        NextPeer = (NextPeer + i + 1) % NumPeers;
+    }
+
+    // No connection is up yet.
+    VerifyOrExit(peer != NULL, err = WEAVE_ERROR_INCORRECT_STATE);
+
+    req->Peer = peer;
+    req->StartTime = startTime;
+
+    switch (Workload)
+    {
+    case kWorkload_BDX:
+        err = StartBdxTransfer(req, con);
+        break;
+    case kWorkload_WDM:
+        err = StartWdmSubscription(req);
+        break;
+    default:
+        err = SendEchoRequest(req, con);
+        break;
+    }
+
+exit:
+    return (err == WEAVE_NO_ERROR);
+}
+
+// Account for a request whose exchange has been set up and is about to be started.
+static void BeginRequest(BenchRequest *req)
+{
+    req->InUse = true;
+    req->BytesReceived = 0;
+    NumOutstanding++;
+    RequestsSent++;
+}
+
+WEAVE_ERROR SendEchoRequest(BenchRequest *req, WeaveConnection *con)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    BenchPeer *peer = req->Peer;
+    ExchangeContext *ec = NULL;
+    PacketBuffer *payload = NULL;
+    uint16_t sendFlags = ExchangeContext::kSendFlag_ExpectResponse;
+
+    if (con != NULL)
+        ec = ExchangeMgr.NewContext(con, req);
+    else
+    {
+        IPAddress addr = (peer->IPAddr != IPAddress::Any) ? peer->IPAddr : FabricState.SelectNodeAddress(peer->NodeId);
+        ec = ExchangeMgr.NewContext(peer->NodeId, addr, peer->Port, peer->Intf, req);
+    }
+    VerifyOrExit(ec != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    payload = PacketBuffer::New();
+    VerifyOrExit(payload != NULL, err = WEAVE_ERROR_NO_MEMORY);
+
+    if (EchoLength > payload->MaxDataLength())
+        EchoLength = payload->MaxDataLength();
+    memset(payload->Start(), 'B', EchoLength);
+    payload->SetDataLength((uint16_t) EchoLength);
+
+    ec->ResponseTimeout = ResponseTimeout;
+    ec->OnMessageReceived = HandleEchoResponse;
+    ec->OnResponseTimeout = HandleResponseTimeout;
+    ec->OnConnectionClosed = HandleExchangeConnectionClosed;
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+    if (Transport == kTransport_WRMP)
+    {
+        ec->OnSendError = HandleSendError;
+        ec->mWRMPConfig = gWRMPOptions.GetWRMPConfig();
+        sendFlags |= ExchangeContext::kSendFlag_RequestAck;
+    }
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+    req->EC = ec;
+    BeginRequest(req);
+
+    err = ec->SendMessage(kWeaveProfile_Echo, kEchoMessageType_EchoRequest, payload, sendFlags);
+    payload = NULL;
+    ec = NULL;
+
+    // The request may already have been completed by a send error callback.
+    if (err != WEAVE_NO_ERROR && req->InUse)
+        CompleteRequest(req, err);
+
+exit:
+    if (payload != NULL)
+        PacketBuffer::Free(payload);
+    if (err != WEAVE_NO_ERROR && ec != NULL)
+        ec->Abort();
+    return err;
+}
+
+WEAVE_ERROR StartBdxTransfer(BenchRequest *req, WeaveConnection *con)
+{
+    WEAVE_ERROR err = WEAVE_NO_ERROR;
+    BDXTransfer *xfer = NULL;
+    ReferencedString fileDesignator;
+    BDXHandlers handlers =
+    {
+        NULL,                       // SendAcceptHandler
+        HandleBdxReceiveAccept,     // ReceiveAcceptHandler
+        HandleBdxReject,            // RejectHandler
+        NULL,                       // GetBlockHandler
+        HandleBdxPutBlock,          // PutBlockHandler
+        HandleBdxXferError,         // XferErrorHandler
+        HandleBdxXferDone,          // XferDoneHandler
+        HandleBdxError              // ErrorHandler
+    };
+
+    fileDesignator.init((uint16_t) strlen(BdxFileDesignator), (char *) BdxFileDesignator);
+
+    err = BDXNode.NewTransfer(con, handlers, fileDesignator, req, xfer);
+    SuccessOrExit(err);
+
+    xfer->mMaxBlockSize = BdxBlockSize;
+
+    req->Xfer = xfer;
+    BeginRequest(req);
+
+    err = BDXNode.InitBdxReceive(*xfer, true, false, BdxAsync, NULL);
+
+    // The request may already have been completed by an error handler.
+    if (err != WEAVE_NO_ERROR && req->InUse)
+        CompleteRequest(req, err);
+
+exit:
+    return err;
+}
+
+WEAVE_ERROR StartWdmSubscription(BenchRequest *req)
+{
+    WEAVE_ERROR err;
+
+    // The mock initiator reports on its one subscription without any context, so remember whose it is.
+    WdmRequest = req;
+    BeginRequest(req);
+
+    err = MockWdmSubscriptionInitiator::GetInstance()->StartTesting(req->Peer->NodeId, kWeaveSubnetId_NotSpecified);
+
+    if (err != WEAVE_NO_ERROR && req->InUse)
+        CompleteRequest(req, err);
+
+    return err;
+}
+
+void CompleteRequest(BenchRequest *req, WEAVE_ERROR err)
+{
+    uint64_t now = Now();
+
+    if (err == WEAVE_NO_ERROR)
+    {
+        RequestsCompleted++;
+
+        // Only exchanges started inside the measurement window count towards the results.
+        if (req->StartTime >= MeasureStartTime && req->StartTime < SendEndTime)
+        {
+            RequestsMeasured++;
+            BytesMeasured += req->BytesReceived;
+            Latency.Record(now - req->StartTime);
+        }
+
+        if (req->EC != NULL)
+            req->EC->Close();
+    }
+    else
+    {
+        if (err == WEAVE_ERROR_TIMEOUT)
+            RequestsTimedOut++;
+        else
+            RequestsFailed++;
+
+        if (req->EC != NULL)
+            req->EC->Abort();
+    }
+
+    // The transfer closes its exchange if it completed and aborts it otherwise.
+    if (req->Xfer != NULL)
+        req->Xfer->Shutdown();
+
+    if (WdmRequest == req)
+        WdmRequest = NULL;
+
+    req->InUse = false;
+    req->EC = NULL;
+    req->Xfer = NULL;
+    req->Peer = NULL;
+    NumOutstanding--;
+}
+
+void HandleEchoResponse(ExchangeContext *ec, const IPPacketInfo *pktInfo, const WeaveMessageInfo *msgInfo, uint32_t profileId,
+        uint8_t msgType, PacketBuffer *payload)
+{
+    BenchRequest *req = (BenchRequest *) ec->AppState;
+
+    PacketBuffer::Free(payload);
+
+    if (req == NULL || req->EC != ec)
+        return;
+
+    if (profileId == kWeaveProfile_Echo && msgType == kEchoMessageType_EchoResponse)
+        CompleteRequest(req, WEAVE_NO_ERROR);
+    else
+        CompleteRequest(req, WEAVE_ERROR_INVALID_MESSAGE_TYPE);
+}
+
+void HandleResponseTimeout(ExchangeContext *ec)
+{
+    BenchRequest *req = (BenchRequest *) ec->AppState;
+
+    if (req != NULL && req->EC == ec)
+        CompleteRequest(req, WEAVE_ERROR_TIMEOUT);
+}
+
+void HandleExchangeConnectionClosed(ExchangeContext *ec, WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    BenchRequest *req = (BenchRequest *) ec->AppState;
+
+    if (req != NULL && req->EC == ec)
+        CompleteRequest(req, (conErr != WEAVE_NO_ERROR) ? conErr : WEAVE_ERROR_CONNECTION_CLOSED_UNEXPECTEDLY);
+}
+
+#if WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+void HandleSendError(ExchangeContext *ec, WEAVE_ERROR err, void *msgCtxt)
+{
+    BenchRequest *req = (BenchRequest *) ec->AppState;
+
+    if (req != NULL && req->EC == ec)
+        CompleteRequest(req, err);
+}
+#endif // WEAVE_CONFIG_ENABLE_RELIABLE_MESSAGING
+
+void HandleConnectionComplete(WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    BenchPeer *peer = (BenchPeer *) con->AppState;
+    char ipAddrStr[64];
+
+    con->PeerAddr.ToString(ipAddrStr, sizeof(ipAddrStr));
+
+    for (size_t i = 0; i < ConnectionsPerPeer; i++)
+    {
+        if (peer->Cons[i] != con)
+            continue;
+
+        if (conErr != WEAVE_NO_ERROR)
+        {
+            printf("Connection FAILED to node %" PRIX64 " (%s): %s\n", con->PeerNodeId, ipAddrStr, ErrorStr(conErr));
+            con->Close();
+            peer->Cons[i] = NULL;
+            Done = true;
+        }
+        else
+            peer->ConEstablished[i] = true;
+    }
+}
+
+void HandleConnectionClosed(WeaveConnection *con, WEAVE_ERROR conErr)
+{
+    BenchPeer *peer = (BenchPeer *) con->AppState;
+    char ipAddrStr[64];
+
+    con->PeerAddr.ToString(ipAddrStr, sizeof(ipAddrStr));
+
+    if (conErr == WEAVE_NO_ERROR)
+        printf("Connection closed to node %" PRIX64 " (%s)\n", con->PeerNodeId, ipAddrStr);
+    else
+        printf("Connection ABORTED to node %" PRIX64 " (%s): %s\n", con->PeerNodeId, ipAddrStr, ErrorStr(conErr));
+
+    if (!Listening && peer != NULL)
+    {
+        for (size_t i = 0; i < ConnectionsPerPeer; i++)
+            if (peer->Cons[i] == con)
+            {
+                peer->Cons[i] = NULL;
+                peer->ConEstablished[i] = false;
+            }
+    }
+
+    con->Close();
+}
+
+void HandleConnectionReceived(WeaveMessageLayer *msgLayer, WeaveConnection *con)
+{
+    con->AppState = NULL;
+    con->OnConnectionClosed = HandleConnectionClosed;
+}
+
+void HandleEchoRequestReceived(uint64_t nodeId, IPAddress nodeAddr, PacketBuffer *payload)
+{
+    EchoRequestsServed++;
+}
+
+WEAVE_ERROR HandleBdxReceiveAccept(BDXTransfer *xfer, ReceiveAccept *receiveAcceptMsg)
+{
+    // The received blocks are only counted, so there is nothing to set up.
+    if (xfer->mTransferMode == kMode_Asynchronous)
+        BdxAsyncTransfers++;
+
+    return WEAVE_NO_ERROR;
+}
+
+void HandleBdxReject(BDXTransfer *xfer, StatusReport *report)
+{
+    BenchRequest *req = (BenchRequest *) xfer->mAppState;
+
+    if (req != NULL && req->Xfer == xfer)
+        CompleteRequest(req, WEAVE_ERROR_STATUS_REPORT_RECEIVED);
+}
+
+void HandleBdxPutBlock(BDXTransfer *xfer, uint64_t length, uint8_t *dataBlock, bool isLastBlock)
+{
+    BenchRequest *req = (BenchRequest *) xfer->mAppState;
+
+    if (req != NULL && req->Xfer == xfer)
+        req->BytesReceived += length;
+}
+
+void HandleBdxXferError(BDXTransfer *xfer, StatusReport *xferError)
+{
+    BenchRequest *req = (BenchRequest *) xfer->mAppState;
+
+    if (req != NULL && req->Xfer == xfer)
+        CompleteRequest(req, WEAVE_ERROR_STATUS_REPORT_RECEIVED);
+}
+
+void HandleBdxXferDone(BDXTransfer *xfer)
+{
+    BenchRequest *req = (BenchRequest *) xfer->mAppState;
+
+    if (req != NULL && req->Xfer == xfer)
+        CompleteRequest(req, WEAVE_NO_ERROR);
+}
+
+void HandleBdxError(BDXTransfer *xfer, WEAVE_ERROR err)
+{
+    BenchRequest *req = (BenchRequest *) xfer->mAppState;
+
+    if (req != NULL && req->Xfer == xfer)
+        CompleteRequest(req, err);
+}
+
+uint16_t HandleBdxReceiveInit(BDXTransfer *xfer, ReceiveInit *receiveInitMsg)
+{
+    uint16_t status = BdxReceiveInitHandler(xfer, receiveInitMsg);
+
+    if (status == kStatus_NoError)
+        BdxTransfersServed++;
+
+    return status;
+}
+
+void HandleWdmSubscriptionComplete(void)
+{
+    if (WdmRequest != NULL)
+        CompleteRequest(WdmRequest, WEAVE_NO_ERROR);
+}
+
+void HandleWdmSubscriptionError(void)
+{
+    if (WdmRequest != NULL)
+        CompleteRequest(WdmRequest, WEAVE_ERROR_INCORRECT_STATE);
+}
+
+void HandleWdmSubscriptionServed(void)
+{
+    WdmSubscriptionsServed++;
+}
+
+static uint64_t CPUTimeDelta(const struct timeval &start, const struct timeval &end)
+{
+    return ((uint64_t) end.tv_sec * nl::kMicrosecondsPerSecond + end.tv_usec) -
+           ((uint64_t) start.tv_sec * nl::kMicrosecondsPerSecond + start.tv_usec);
+}
+
+void PrintReport(void)
+{
+    uint64_t elapsed = (MeasureEndTime > MeasureStartTime) ? MeasureEndTime - MeasureStartTime : 0;
+    uint64_t userTime = CPUTimeDelta(MeasureStartUsage.ru_utime, MeasureEndUsage.ru_utime);
+    uint64_t systemTime = CPUTimeDelta(MeasureStartUsage.ru_stime, MeasureEndUsage.ru_stime);
+
+    printf("Exchanges: started %" PRIu64 ", completed %" PRIu64 ", measured %" PRIu64 ", timed out %" PRIu64
+           ", failed %" PRIu64 ", overruns %" PRIu64 "\n",
+           RequestsSent, RequestsCompleted, RequestsMeasured, RequestsTimedOut, RequestsFailed, ArrivalOverruns);
+
+    if (elapsed != 0)
+        printf("Throughput: %.1f exchanges/s over %.3f s\n",
+               ((double) RequestsMeasured) * nl::kMicrosecondsPerSecond / elapsed, ((double) elapsed) / nl::kMicrosecondsPerSecond);
+
+    if (elapsed != 0 && Workload == kWorkload_BDX)
+        printf("Downloaded: %" PRIu64 " bytes, %.1f bytes/s\n", BytesMeasured,
+               ((double) BytesMeasured) * nl::kMicrosecondsPerSecond / elapsed);
+
+    if (BdxAsync)
+        printf("Asynchronous: %" PRIu64 " of %" PRIu64 " downloads\n", BdxAsyncTransfers, RequestsSent);
+
+    if (Latency.Count() != 0)
+    {
+        printf("Latency (ms): min %.3f, mean %.3f, p50 %.3f, p99 %.3f, p999 %.3f, max %.3f\n",
+               Latency.Min() / 1000.0, Latency.Mean() / 1000.0, Latency.Percentile(50.0) / 1000.0,
+               Latency.Percentile(99.0) / 1000.0, Latency.Percentile(99.9) / 1000.0, Latency.Max() / 1000.0);
+
+        printf("CPU: user %.3f s, system %.3f s, %.1f us/exchange\n", userTime / 1000000.0, systemTime / 1000000.0,
+               ((double) (userTime + systemTime)) / RequestsMeasured);
+
+        if (PrintHistogram)
+            Latency.Print();
+    }
+}
+
+void LatencyHistogram::Reset(void)
+{
+    memset(mBuckets, 0, sizeof(mBuckets));
+    mCount = 0;
+    mSum = 0;
+    mMin = UINT64_MAX;
+    mMax = 0;
+}
+
+size_t LatencyHistogram::BucketIndex(uint64_t value)
+{
+    size_t exponent = 0;
+
+    if (value < kSubBuckets)
+        return (size_t) value;
+
+    while ((value >> exponent) >= 2 * kSubBuckets)
+        exponent++;
+
+    if (exponent > kMaxExponent)
+        return kNumBuckets - 1;
+
+    return exponent * kSubBuckets + (size_t) (value >> exponent);
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(size_t index)
+{
+    size_t exponent;
+
+    if (index < kSubBuckets)
+        return index;
+
+    exponent = index / kSubBuckets - 1;
+
+    return (((uint64_t) (index % kSubBuckets + kSubBuckets) + 1) << exponent) - 1;
+}
+
+void LatencyHistogram::Record(uint64_t value)
+{
+    mBuckets[BucketIndex(value)]++;
+    mCount++;
+    mSum += value;
+    if (value < mMin)
+        mMin = value;
+    if (value > mMax)
+        mMax = value;
+}
+
+uint64_t LatencyHistogram::Percentile(double percent) const
+{
+    uint64_t target = (uint64_t) ceil(mCount * percent / 100.0);
+    uint64_t seen = 0;
+
+    if (target == 0)
+        target = 1;
+
+    for (size_t i = 0; i < kNumBuckets; i++)
+    {
+        seen += mBuckets[i];
+        if (seen >= target)
+        {
+            uint64_t bound = BucketUpperBound(i);
+            return (bound < mMax) ? bound : mMax;
+        }
+    }
+
+    return mMax;
+}
+
+void LatencyHistogram::Print(void) const
+{
+    uint64_t seen = 0;
+
+    printf("Latency histogram (us):\n");
+
+    for (size_t i = 0; i < kNumBuckets; i++)
+    {
+        if (mBuckets[i] == 0)
+            continue;
+
+        seen += mBuckets[i];
+        printf("  <= %10" PRIu64 ": %10" PRIu64 " (%6.2f%%)\n", BucketUpperBound(i), mBuckets[i], ((double) seen) * 100 / mCount);
+    }
+}
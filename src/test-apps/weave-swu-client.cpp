@@ -68,6 +68,7 @@ static OptionDef gToolOptionDefs[] =
     { "debug",      kArgumentRequired, 'd' },
     { "tcp",        kNoArgument,       't' },
     { "udp",        kNoArgument,       'u' },
+    { "installed-image", kArgumentRequired, 'I' },
     { NULL }
 };
 
@@ -90,6 +91,10 @@ static const char *gToolOptionHelp =
     "  -L, --listen\n"
     "       Listen and respond to ImageAnnounce notifications sent from another node.\n"
     "\n"
+    "  -I, --installed-image <file>\n"
+    "       Report the SHA-256 hash of <file> as the installed image and prefer\n"
+    "       a delta image (update scheme 4) over the full image.\n"
+    "\n"
     "  -d, --debug\n"
     "       Enable debug messages.\n"
     "\n";
@@ -329,6 +334,9 @@ bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *n
     case 'D':
         DestIPAddrStr = arg;
         break;
+    case 'I':
+        SWUClient.InstalledImagePath = arg;
+        break;
     default:
         PrintArgError("%s: INTERNAL ERROR: Unhandled option: %s\n", progName, name);
         return false;
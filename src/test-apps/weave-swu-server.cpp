@@ -58,6 +58,7 @@ const char *gSoftwareVersion            = "1";
 const char *gUpdateSchemeList   = "3";
 const char *gIntegrityTypeList  = "0";
 const char *gFileDesignator     = NULL;
+const char *gBaseImage          = NULL;
 bool gListening                 = false;
 const char *gDestAddrStr        = NULL;
 const char *gDestNodeIdStr      = NULL;
@@ -75,6 +76,7 @@ enum
     kToolOpt_IntegrityType,
     kToolOpt_UpdateScheme,
     kToolOpt_FileDesignator,
+    kToolOpt_BaseImage,
     kToolOpt_Listen,
     kToolOpt_DestAddr,
     kToolOpt_DestNodeId,
@@ -91,6 +93,7 @@ static OptionDef gToolOptionDefs[] =
     { "integrity-type",  kArgumentRequired, kToolOpt_IntegrityType    },
     { "update-scheme",   kArgumentRequired, kToolOpt_UpdateScheme     },
     { "file-designator", kArgumentRequired, kToolOpt_FileDesignator   },
+    { "base-image",      kArgumentRequired, kToolOpt_BaseImage        },
     { "listen",          kNoArgument,       kToolOpt_Listen           },
     { "dest-addr",       kArgumentRequired, kToolOpt_DestAddr         },
     { "dest-node-id",    kArgumentRequired, kToolOpt_DestNodeId       },
@@ -132,11 +135,18 @@ static const char *gToolOptionHelp =
     "       1 -> HTTPS\n"
     "       2 -> SFTP\n"
     "       3 -> BDX Nest Weave download protocol\n"
+    "       4 -> BDX Nest Weave download protocol, delta image\n"
      "\n"
     " --file-designator <string>\n"
     "       Path to the image file that is returned to the query\n"
     "       when an update is available. The path must be valid.\n"
     "\n"
+    " --base-image <string>\n"
+    "       Path to an earlier image from which delta images are generated.\n"
+    "       When a client requests update scheme 4 and reports this image\n"
+    "       as installed, a patch to the --file-designator image is written\n"
+    "       to <file-designator>.delta and returned instead of the full image.\n"
+    "\n"
     "  --tcp\n"
     "       Use TCP to send SWU Image Announce messages. This is the default.\n"
     "\n"
@@ -218,6 +228,9 @@ bool HandleOption(const char *progName, OptionSet *optSet, int id, const char *n
     case kToolOpt_FileDesignator:
         gFileDesignator = arg;
         break;
+    case kToolOpt_BaseImage:
+        gBaseImage = arg;
+        break;
     case kToolOpt_UseTCP:
         gUseTCP = true;
         break;
@@ -403,6 +416,16 @@ int main(int argc, char *argv[])
         exit(EXIT_FAILURE);
     }
 
+    if (gBaseImage != NULL)
+    {
+        err = MockSWUServer.SetBaseImage(gBaseImage);
+        if (err != WEAVE_NO_ERROR)
+        {
+            printf("Unable to open base image: %s\n", gBaseImage);
+            exit(EXIT_FAILURE);
+        }
+    }
+
     if (gListening)
     {
         printf("Listening for Software Update requests...\n");
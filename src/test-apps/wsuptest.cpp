@@ -25,12 +25,17 @@
 
 // library includes
 #include <iostream>
+#include <vector>
 #include <assert.h>
+#include <string.h>
 using namespace std;
 #include <Weave/Core/WeaveCore.h>
 #include <Weave/Core/WeaveMessageLayer.h>
 #include <Weave/Profiles/ProfileCommon.h>
 #include <Weave/Profiles/software-update/SoftwareUpdateProfile.h>
+#include <Weave/Profiles/software-update/DeltaImageApplier.h>
+#include <Weave/Support/crypto/HashAlgos.h>
+#include "DeltaImageGenerator.h"
 #if WEAVE_SYSTEM_CONFIG_USE_LWIP
 #include <lwip/init.h>
 #endif
@@ -86,6 +91,38 @@ ReferencedString testLocale;
 uint8_t fakeTLVDataBytes[10]= { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10 };
 ReferencedTLVData fakeTLVData;
 uint64_t fakeNodeId=0x12345678;
+uint8_t fakeDigest[32]= { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16,
+                          17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32 };
+
+// image storage for the delta image applier tests
+class TestImageStore : public DeltaImageApplier::Delegate
+{
+public:
+  TestImageStore(const vector<uint8_t> &aBase) : base(aBase) { }
+  WEAVE_ERROR ReadBaseImage(uint32_t offset, uint8_t *buf, uint16_t len)
+  {
+    if (offset+len>base.size()) return WEAVE_ERROR_INVALID_ARGUMENT;
+    memcpy(buf, &base[offset], len);
+    return WEAVE_NO_ERROR;
+  }
+  WEAVE_ERROR WriteTargetImage(const uint8_t *data, uint16_t len)
+  {
+    target.insert(target.end(), data, data+len);
+    return WEAVE_NO_ERROR;
+  }
+  const vector<uint8_t> &base;
+  vector<uint8_t> target;
+};
+// feed a patch to an applier in blocks of the given size, as BDX would
+WEAVE_ERROR applyPatch(DeltaImageApplier &applier, const vector<uint8_t> &patch, uint16_t blockSize)
+{
+  for (size_t offset=0; offset<patch.size(); offset+=blockSize) {
+    uint16_t len=(patch.size()-offset<blockSize) ? (uint16_t)(patch.size()-offset) : blockSize;
+    WEAVE_ERROR err=applier.ProcessPatchData(&patch[offset], len);
+    if (err!=WEAVE_NO_ERROR) return err;
+  }
+  return applier.Finish();
+}
 
 // and away we go
 int main()
@@ -174,6 +211,38 @@ int main()
     assert(testQuery==otherQuery);
     PacketBuffer::Free(buffer);
   }
+  // try the installed image hash
+  {
+    IntegritySpec installedSpec;
+    assert(installedSpec.init(kIntegrityType_SHA256, fakeDigest)==WEAVE_NO_ERROR);
+    ImageQuery testQuery;
+    assert(testQuery.init(testSpec, testVersion, iTList, uSList, NULL, NULL, fakeNodeId, &fakeTLVData, &installedSpec)==WEAVE_NO_ERROR);
+    PacketBuffer *buffer=PacketBuffer::New();
+    ImageQuery otherQuery;
+    assert(testQuery.pack(buffer)==WEAVE_NO_ERROR);
+    assert(ImageQuery::parse(buffer, otherQuery)==WEAVE_NO_ERROR);
+    assert(otherQuery.installedImageHashPresent);
+    assert(testQuery==otherQuery);
+    PacketBuffer::Free(buffer);
+  }
+  // the installed image hash alone travels as TLV metadata and is not
+  // mistaken for vendor metadata on the way back in
+  {
+    IntegritySpec installedSpec;
+    assert(installedSpec.init(kIntegrityType_SHA160, fakeDigest)==WEAVE_NO_ERROR);
+    ImageQuery testQuery;
+    assert(testQuery.init(testSpec, testVersion, iTList, uSList, NULL, NULL, 0, NULL, &installedSpec)==WEAVE_NO_ERROR);
+    PacketBuffer *buffer=PacketBuffer::New();
+    ImageQuery otherQuery;
+    assert(testQuery.pack(buffer)==WEAVE_NO_ERROR);
+    assert((buffer->Start()[0] & ~(kFlag_PackageSpecPresent|kFlag_LocaleSpecPresent|kFlag_TargetNodeIdPresent))==0);
+    assert(ImageQuery::parse(buffer, otherQuery)==WEAVE_NO_ERROR);
+    assert(otherQuery.installedImageHashPresent);
+    assert(otherQuery.installedImageHash==installedSpec);
+    assert(otherQuery.theMetaData.theLength==0);
+    assert(testQuery==otherQuery);
+    PacketBuffer::Free(buffer);
+  }
   cout<<"ImageQuery parse and pack work"<<endl;
   // make an ImageQueryResponse and put it through its paces
   {
@@ -193,5 +262,125 @@ int main()
     cout<<"ImageQueryResponse parse and pack work"<<endl;
     PacketBuffer::Free(buffer);
   }
+  // and a delta image query response
+  {
+    PacketBuffer *buffer=PacketBuffer::New();
+    char uriString[20]="bdx://image.delta";
+    ReferencedString testUri;
+    assert(testUri.init((uint16_t)19, uriString)==WEAVE_NO_ERROR);
+    IntegritySpec targetSpec;
+    assert(targetSpec.init(kIntegrityType_SHA256, fakeDigest)==WEAVE_NO_ERROR);
+    IntegritySpec baseSpec;
+    assert(baseSpec.init(kIntegrityType_SHA160, fakeDigest)==WEAVE_NO_ERROR);
+    PatchSpec testPatchSpec;
+    assert(testPatchSpec.init(kPatchFormat_WeaveDelta, baseSpec, 1234)==WEAVE_NO_ERROR);
+    ImageQueryResponse testResponse;
+    assert(testResponse.init(testUri, testVersion, targetSpec, kUpdateScheme_BDXDelta, Normal, IfUnmatched, false)==WEAVE_ERROR_INVALID_ARGUMENT);
+    assert(testResponse.init(testUri, testVersion, targetSpec, kUpdateScheme_BDX, Normal, IfUnmatched, false, &testPatchSpec)==WEAVE_ERROR_INVALID_ARGUMENT);
+    assert(testResponse.init(testUri, testVersion, targetSpec, kUpdateScheme_BDXDelta, Normal, IfUnmatched, false, &testPatchSpec)==WEAVE_NO_ERROR);
+    ImageQueryResponse otherResponse;
+    assert(testResponse.pack(buffer)==WEAVE_NO_ERROR);
+    assert(ImageQueryResponse::parse(buffer, otherResponse)==WEAVE_NO_ERROR);
+    assert(otherResponse.patchSpec.patchSize==1234);
+    assert(testResponse==otherResponse);
+    cout<<"delta ImageQueryResponse parse and pack work"<<endl;
+    PacketBuffer::Free(buffer);
+  }
+  // now generate a patch between two images and apply it
+  {
+    vector<uint8_t> base(8192);
+    uint32_t seed=12345;
+    for (size_t i=0; i<base.size(); i++) {
+      seed=seed*1103515245+12345;
+      base[i]=(uint8_t)(seed>>16);
+    }
+    // the target changes a few bytes, inserts a new section, drops another and moves a block
+    vector<uint8_t> target(base);
+    target[100]^=0xFF;
+    target[5000]^=0x55;
+    target.insert(target.begin()+2000, fakeDigest, fakeDigest+sizeof(fakeDigest));
+    target.erase(target.begin()+6000, target.begin()+6500);
+    target.insert(target.end(), base.begin()+64, base.begin()+1064);
+    vector<uint8_t> patch;
+    assert(GenerateDeltaImage(&base[0], base.size(), &target[0], target.size(), patch)==WEAVE_NO_ERROR);
+    assert(patch.size()<target.size()/4);
+    uint8_t targetDigest[kLength_SHA256];
+    nl::Weave::Platform::Security::SHA256 sha256;
+    sha256.Begin();
+    sha256.AddData(&target[0], target.size());
+    sha256.Finish(targetDigest);
+    IntegritySpec targetSpec;
+    assert(targetSpec.init(kIntegrityType_SHA256, targetDigest)==WEAVE_NO_ERROR);
+    uint8_t baseDigest[kLength_SHA256];
+    sha256.Begin();
+    sha256.AddData(&base[0], base.size());
+    sha256.Finish(baseDigest);
+    IntegritySpec baseSpec;
+    assert(baseSpec.init(kIntegrityType_SHA256, baseDigest)==WEAVE_NO_ERROR);
+    PatchSpec testPatchSpec;
+    assert(testPatchSpec.init(kPatchFormat_WeaveDelta, baseSpec, patch.size())==WEAVE_NO_ERROR);
+    // apply it in BDX-sized blocks, and a byte at a time
+    uint16_t blockSizes[]= { 1024, 7, 1 };
+    for (size_t i=0; i<sizeof(blockSizes)/sizeof(blockSizes[0]); i++) {
+      TestImageStore store(base);
+      DeltaImageApplier applier;
+      assert(applier.Init(&store, testPatchSpec, targetSpec)==WEAVE_NO_ERROR);
+      assert(applyPatch(applier, patch, blockSizes[i])==WEAVE_NO_ERROR);
+      assert(applier.IsComplete());
+      assert(applier.GetTargetBytesWritten()==target.size());
+      assert(store.target==target);
+    }
+    // a wrong target digest is detected
+    {
+      TestImageStore store(base);
+      DeltaImageApplier applier;
+      IntegritySpec wrongSpec;
+      assert(wrongSpec.init(kIntegrityType_SHA256, fakeDigest)==WEAVE_NO_ERROR);
+      assert(applier.Init(&store, testPatchSpec, wrongSpec)==WEAVE_NO_ERROR);
+      assert(applyPatch(applier, patch, 1024)==WEAVE_ERROR_INTEGRITY_CHECK_FAILED);
+    }
+    // a patch is never applied to an installed image other than its base
+    {
+      vector<uint8_t> otherBase(base);
+      otherBase[3000]^=0x01;
+      TestImageStore store(otherBase);
+      DeltaImageApplier applier;
+      assert(applier.Init(&store, testPatchSpec, targetSpec)==WEAVE_NO_ERROR);
+      assert(applyPatch(applier, patch, 1024)==WEAVE_ERROR_INTEGRITY_CHECK_FAILED);
+      assert(store.target.empty());
+      // and a base integrity spec for a different image is caught the same way
+      TestImageStore sameStore(base);
+      PatchSpec wrongBasePatchSpec;
+      IntegritySpec wrongBaseSpec;
+      assert(wrongBaseSpec.init(kIntegrityType_SHA256, fakeDigest)==WEAVE_NO_ERROR);
+      assert(wrongBasePatchSpec.init(kPatchFormat_WeaveDelta, wrongBaseSpec, patch.size())==WEAVE_NO_ERROR);
+      assert(applier.Init(&sameStore, wrongBasePatchSpec, targetSpec)==WEAVE_NO_ERROR);
+      assert(applyPatch(applier, patch, 1024)==WEAVE_ERROR_INTEGRITY_CHECK_FAILED);
+      assert(sameStore.target.empty());
+    }
+    // a truncated patch never completes
+    {
+      TestImageStore store(base);
+      DeltaImageApplier applier;
+      assert(applier.Init(&store, testPatchSpec, targetSpec)==WEAVE_NO_ERROR);
+      assert(applier.ProcessPatchData(&patch[0], patch.size()-1)==WEAVE_NO_ERROR);
+      assert(applier.Finish()==WEAVE_ERROR_INCORRECT_STATE);
+    }
+    // as do a corrupt header and data following the end of the patch
+    {
+      TestImageStore store(base);
+      DeltaImageApplier applier;
+      vector<uint8_t> badPatch(patch);
+      badPatch[0]^=0xFF;
+      assert(applier.Init(&store, testPatchSpec, targetSpec)==WEAVE_NO_ERROR);
+      assert(applyPatch(applier, badPatch, 1024)==WEAVE_ERROR_INVALID_ARGUMENT);
+      badPatch=patch;
+      badPatch.push_back(kDeltaOp_End);
+      assert(testPatchSpec.init(kPatchFormat_WeaveDelta, baseSpec, 0)==WEAVE_NO_ERROR);
+      assert(applier.Init(&store, testPatchSpec, targetSpec)==WEAVE_NO_ERROR);
+      assert(applyPatch(applier, badPatch, 1024)==WEAVE_ERROR_INVALID_ARGUMENT);
+    }
+    cout<<"delta image generation and application work"<<endl;
+  }
   return 0;
 }